@@ -88,6 +88,11 @@ if (CTX.compilerName() != 'gcc') or (CTX.compilerMajorVersion() == 4 and CTX.com
 if CTX.PROFILE:
     CTX.CPPFLAGS += " -fvisibility=default -DPROFILE_ENABLED"
 
+# Compile in the USDT tracepoints (src/ee/common/Tracepoints.h) when the
+# system provides <sys/sdt.h>; they are nops unless a tracer attaches.
+if os.path.exists("/usr/include/sys/sdt.h"):
+    CTX.CPPFLAGS += " -DVOLT_USDT"
+
 # Set the compiler version and C++ standard flag.
 # GCC before 4.3 is too old.
 # GCC 4.4 up to but not including 4.7 use -std=c++0x
@@ -207,6 +212,8 @@ if CTX.PLATFORM == "Darwin":
 if CTX.PLATFORM == "Linux":
     CTX.CPPFLAGS += " -Wno-attributes -Wcast-align -DLINUX -fpic"
     CTX.NMFLAGS += " --demangle"
+    # timer_create() for the native stack sampler, in libc itself since glibc 2.17
+    CTX.LASTLDFLAGS += " -lrt"
 
 ###############################################################################
 # SPECIFY SOURCE FILE INPUT
@@ -253,6 +260,7 @@ CTX.INPUT['common'] = """
  SerializableEEException.cpp
  SQLException.cpp
  InterruptException.cpp
+ StringDictionary.cpp
  StringRef.cpp
  tabletuple.cpp
  TupleSchema.cpp
@@ -279,6 +287,7 @@ CTX.INPUT['execution'] = """
 """
 
 CTX.INPUT['executors'] = """
+ ExecutorStats.cpp
  OptimizedProjector.cpp
  abstractexecutor.cpp
  abstractjoinexecutor.cpp
@@ -309,6 +318,7 @@ CTX.INPUT['executors'] = """
 
 CTX.INPUT['expressions'] = """
  abstractexpression.cpp
+ commonsubexpression.cpp
  expressionutil.cpp
  functionexpression.cpp
  geofunctions.cpp
@@ -355,6 +365,7 @@ CTX.INPUT['plannodes'] = """
 CTX.INPUT['indexes'] = """
  CoveringCellIndex.cpp
  IndexStats.cpp
+ IndexUsageStats.cpp
  tableindex.cpp
  tableindexfactory.cpp
 """
@@ -363,6 +374,7 @@ CTX.INPUT['storage'] = """
  AbstractDRTupleStream.cpp
  BinaryLogSink.cpp
  BinaryLogSinkWrapper.cpp
+ ColdStorage.cpp
  CompatibleBinaryLogSink.cpp
  CompatibleDRTupleStream.cpp
  ConstraintFailureException.cpp
@@ -391,13 +403,17 @@ CTX.INPUT['storage'] = """
  TableStreamerContext.cpp
  tableutil.cpp
  tabletuplefilter.cpp
+ TempBlockCache.cpp
  temptable.cpp
  TempTableLimits.cpp
+ TempTableSpill.cpp
  TupleBlock.cpp
  TupleStreamBase.cpp
 """
 
 CTX.INPUT['stats'] = """
+ LatencyStats.cpp
+ StackSampler.cpp
  StatsAgent.cpp
  StatsSource.cpp
 """
@@ -474,9 +490,12 @@ if whichtests in ("${eetestsuite}", "common"):
     CTX.TESTS['common'] = """
      debuglog_test
      elastic_hashinator_test
+     FastHashTest
+     JsonDocumentCacheTest
      nvalue_test
      pool_test
      serializeio_test
+     StringDictionaryTest
      tabletuple_test
      ThreadLocalPoolTest
      tupleschema_test
@@ -493,8 +512,11 @@ if whichtests in ("${eetestsuite}", "execution"):
     """
 if whichtests in ("${eetestsuite}", "executors"):
     CTX.TESTS['executors'] = """
+    AggregateHashTableTest
     OptimizedProjectorTest
     MergeReceiveExecutorTest
+    NestLoopHashJoinTest
+    OrderByTopNTest
     TestGeneratedPlans
     TestRank
     """
@@ -525,6 +547,7 @@ if whichtests in ("${eetestsuite}", "storage"):
      PersistentTableMemStatsTest
      StreamedTable_test
      TempTableLimitsTest
+     ViewMinMaxTrackerTest
      constraint_test
      filter_test
      persistent_table_log_test
@@ -540,11 +563,23 @@ if whichtests in ("${eetestsuite}", "structures"):
     CTX.TESTS['structures'] = """
      CompactingMapTest
      CompactingMapIndexCountTest
+     CompactingBTreeTest
      CompactingHashTest
+     BlockedBloomFilterTest
+     TDigestTest
      CompactingPoolTest
      CompactingMapBenchmark
     """
 
+# Microbenchmarks are not part of the default suite; build and run them with
+# EETESTSUITE=benchmarks, optionally setting BENCHMARK_OUTPUT to collect the
+# JSON results (see tests/ee/benchmark.h).
+if whichtests == "benchmarks":
+    CTX.TESTS['benchmarks'] = """
+     NValueBenchmark
+     TableIndexBenchmark
+    """
+
 if whichtests in ("${eetestsuite}", "plannodes"):
     CTX.TESTS['plannodes'] = """
      WindowFunctionPlanNodeTest
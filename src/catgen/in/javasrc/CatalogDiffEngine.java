@@ -923,7 +923,11 @@ public class CatalogDiffEngine {
             return null;
         if (suspect instanceof Table) {
             if (field.equals("signature") ||
-                field.equals("tuplelimit"))
+                field.equals("tuplelimit") ||
+                field.equals("ttlColumn") ||
+                field.equals("ttlSeconds") ||
+                field.equals("ttlBatchSize") ||
+                field.equals("isClustered"))
                 return null;
 
             // Always allow disabling DR on table
@@ -1137,6 +1141,13 @@ public class CatalogDiffEngine {
                                         objectName));
                 return Collections.singletonList(entry);
             }
+            if (field.equalsIgnoreCase("isAppendOnly")) {
+                // error message
+                entry.setErrorMessage(String.format(
+                                        "Unable to change whether table %s is append only because it is not empty.",
+                                        objectName));
+                return Collections.singletonList(entry);
+            }
         }
 
         // handle narrowing columns and some modifications on empty tables
@@ -33,6 +33,7 @@
 #include <stx/btree_map>
 #include <murmur3/MurmurHash3.h>
 #include <limits>
+#include <vector>
 
 /*
  * Forward declaration for test friendship
@@ -106,8 +107,12 @@ protected:
     }
 
     int32_t partitionForToken(int32_t hashCode) const {
-        int32_t min = 0;
-        int32_t max = tokenCount - 1;
+        // The bucket of the hash's high bits bounds the search to the few
+        // tokens in the same range. The partition is that of the last of
+        // them <= the hash, or of the last token of an earlier bucket.
+        const uint32_t bucket = (static_cast<uint32_t>(hashCode) ^ 0x80000000u) >> bucketShift;
+        int32_t min = bucketStarts[bucket];
+        int32_t max = bucketStarts[bucket + 1] - 1;
 
         while (min <= max) {
             assert(min >= 0);
@@ -141,11 +146,35 @@ protected:
 
 private:
 
-    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) : tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ) {}
+    ElasticHashinator(int32_t *tokens, uint32_t tokenCount, bool owned) : tokens(tokens), tokenCount(tokenCount), tokensOwner( owned ? tokens : NULL ) {
+        // About one token per bucket, in up to 2^16 buckets
+        uint32_t bucketBits = 1;
+        while (bucketBits < MAX_BUCKET_BITS && (1u << bucketBits) < tokenCount) {
+            bucketBits++;
+        }
+        bucketShift = 32 - bucketBits;
+        const uint32_t bucketCount = 1u << bucketBits;
+        bucketStarts.resize(bucketCount + 1);
+        uint32_t ii = 0;
+        for (uint32_t bucket = 0; bucket < bucketCount; bucket++) {
+            const uint64_t bucketLow = static_cast<uint64_t>(bucket) << bucketShift;
+            while (ii < tokenCount && (static_cast<uint32_t>(tokens[ii * 2]) ^ 0x80000000u) < bucketLow) {
+                ii++;
+            }
+            bucketStarts[bucket] = ii;
+        }
+        bucketStarts[bucketCount] = tokenCount;
+    }
+
+    static const uint32_t MAX_BUCKET_BITS = 16;
 
     const int32_t *tokens;
     const uint32_t tokenCount;
     boost::scoped_array<int32_t> tokensOwner;
+    // Index of the first token of each range of the ring sharing the high
+    // bucket bits of their offset from INT32_MIN, then tokenCount
+    std::vector<int32_t> bucketStarts;
+    uint32_t bucketShift;
 
 };
 }
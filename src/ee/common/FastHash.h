@@ -0,0 +1,80 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FASTHASH_H_
+#define FASTHASH_H_
+
+#include <cstring>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Hashes keys a machine word at a time, for the in-memory hash tables:
+ * one multiply per eight bytes, then MurmurHash3's finalizer so that
+ * every input bit reaches the low bits tables pick buckets with.
+ *
+ * The values are not stable across releases and must never be persisted
+ * or sent to other nodes; partitioning hashes live in TheHashinator.
+ */
+class FastHash {
+public:
+    static uint64_t mix(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    static uint64_t hashBytes(const char* bytes, size_t length, uint64_t seed = 0) {
+        uint64_t hash = seed ^ (length * MULTIPLIER);
+        size_t offset = 0;
+        for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+            uint64_t word;
+            ::memcpy(&word, bytes + offset, sizeof(word));
+            hash = step(hash, word);
+        }
+        if (offset < length) {
+            uint64_t word = 0;
+            ::memcpy(&word, bytes + offset, length - offset);
+            hash = step(hash, word);
+        }
+        return mix(hash);
+    }
+
+    static uint64_t hashWords(const uint64_t* words, size_t count, uint64_t seed = 0) {
+        uint64_t hash = seed ^ (count * MULTIPLIER);
+        for (size_t ii = 0; ii < count; ii++) {
+            hash = step(hash, words[ii]);
+        }
+        return mix(hash);
+    }
+
+private:
+    static const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+    static uint64_t step(uint64_t hash, uint64_t word) {
+        hash = (hash ^ word) * MULTIPLIER;
+        return hash ^ (hash >> 29);
+    }
+};
+
+} // namespace voltdb
+
+#endif // FASTHASH_H_
@@ -0,0 +1,93 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONDOCUMENTCACHE_H_
+#define JSONDOCUMENTCACHE_H_
+
+#include "common/SQLException.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <stdint.h>
+
+#include <jsoncpp/jsoncpp.h>
+
+namespace voltdb {
+
+/**
+ * The last few JSON documents that a site's JSON functions parsed, by
+ * their text. Several FIELD, ARRAY_ELEMENT or ARRAY_LENGTH calls on one
+ * row's document, or on a parameter across rows, then parse it once.
+ * Entries are matched on the document's bytes rather than on where they
+ * are stored, so storage that is reused for another value never matches
+ * a stale entry.
+ */
+class JsonDocumentCache {
+public:
+    JsonDocumentCache() : m_next(0) { }
+
+    /**
+     * The parsed document, good until the next call. Text that is not
+     * JSON is not kept, and throws a SQLException.
+     */
+    const Json::Value& parse(const char* docChars, int32_t lenDoc) {
+        for (int ii = 0; ii < CAPACITY; ii++) {
+            const Entry& entry = m_entries[ii];
+            if (entry.m_valid && entry.m_text.size() == static_cast<size_t>(lenDoc) &&
+                ::memcmp(entry.m_text.data(), docChars, lenDoc) == 0) {
+                return entry.m_root;
+            }
+        }
+        Entry& entry = m_entries[m_next];
+        m_next = (m_next + 1) % CAPACITY;
+        entry.m_valid = false;
+        Json::Reader reader;
+        if ( ! reader.parse(docChars, docChars + lenDoc, entry.m_root)) {
+            char msg[1024];
+            // getFormatedErrorMessages returns concise message about location
+            // of the error rather than the malformed document itself
+            snprintf(msg, sizeof(msg), "Invalid JSON %s", reader.getFormatedErrorMessages().c_str());
+            throw SQLException(SQLException::
+                               data_exception_invalid_parameter,
+                               msg);
+        }
+        entry.m_text.assign(docChars, lenDoc);
+        entry.m_valid = true;
+        return entry.m_root;
+    }
+
+private:
+    // Enough for the JSON columns of a join row; replaced round robin.
+    static const int CAPACITY = 4;
+
+    struct Entry {
+        Entry() : m_valid(false) { }
+
+        bool m_valid;
+        std::string m_text;
+        Json::Value m_root;
+    };
+
+    Entry m_entries[CAPACITY];
+    int m_next;
+};
+
+} // namespace voltdb
+
+#endif // JSONDOCUMENTCACHE_H_
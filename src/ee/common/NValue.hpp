@@ -36,6 +36,7 @@
 
 #include "catalog/catalog.h"
 #include "common/ExportSerializeIo.h"
+#include "common/FastHash.h"
 #include "common/FatalException.hpp"
 #include "common/MiscUtil.h"
 #include "common/Pool.hpp"
@@ -64,6 +65,9 @@ namespace voltdb {
 
 #define FULL_STRING_IN_MESSAGE_THRESHOLD 100
 
+class PolygonCache;
+class CompiledRegexp;
+
 //The int used for storage and return values
 typedef ttmath::Int<2> TTInt;
 //Long integer with space for multiplication and division without carry/overflow
@@ -311,6 +315,12 @@ class NValue {
     void deserializeFromAllocateForStorage(SerializeInputBE& input, Pool* tempPool);
     void deserializeFromAllocateForStorage(ValueType vt, SerializeInputBE& input, Pool* tempPool);
 
+    /* Deserialize a parameter as deserializeFromAllocateForStorage does,
+       except that VARCHAR and VARBINARY values refer to their bytes in
+       the input's buffer rather than copying them to the temp pool. The
+       buffer must be writable, read only once, and outlive the value. */
+    void deserializeParameterReferencingInput(SerializeInputBE& input, Pool* tempPool);
+
     /* Serialize this NValue to a SerializeOutput */
     void serializeTo(SerializeOutput &output) const;
 
@@ -452,6 +462,22 @@ class NValue {
     template <int F> // template for SQL functions of multiple NValues
     static NValue call(const std::vector<NValue>& arguments);
 
+    /**
+     * REGEXP_POSITION, compiling the pattern into regexp only if it does
+     * not already hold it with the same flags. This lets an expression
+     * keep the compiled pattern of a constant or parameter across calls.
+     */
+    static NValue regexpPosition(const std::vector<NValue>& arguments, CompiledRegexp& regexp);
+
+    /**
+     * CONTAINS, DISTANCE and DWITHIN of a polygon and a point, decoding the
+     * polygon only if polygons does not already hold it. This lets an
+     * expression check a constant or parameter polygon, or the few polygons
+     * of a joined table, against many points without decoding them for each.
+     */
+    template <int F>
+    static NValue callWithPolygon(const std::vector<NValue>& arguments, PolygonCache& polygons);
+
     /// Iterates over UTF8 strings one character "code point" at a time, being careful not to walk off the end.
     class UTF8Iterator {
     public:
@@ -1968,6 +1994,12 @@ private:
 
         assert(m_valueType == VALUE_TYPE_VARCHAR);
 
+        // Rows sharing a value through a StringDictionary share its StringRef.
+        if ( ! m_sourceInlined && ! rhs.m_sourceInlined &&
+             getObjectPointer() == rhs.getObjectPointer()) {
+            return VALUE_COMPARE_EQUAL;
+        }
+
         int32_t leftLength;
         const char* left = getObject_withoutNull(&leftLength);
         int32_t rightLength;
@@ -2216,12 +2248,46 @@ private:
         return getDoubleValue(result);
     }
 
+    /*
+     * Most decimals in practice are small enough that their scaled
+     * representation fits in an int64_t, and then the arithmetic below can
+     * be done natively instead of through ttmath. No result of the native
+     * paths can leave the decimal range, so they need no range check; a
+     * sum that overflows int64_t just takes the ttmath path.
+     */
+    static bool decimalFitsInt64(const TTInt& value, int64_t& result) {
+        const uint64_t low = value.table[0];
+        const uint64_t high = value.table[1];
+        if (high != ((low >> 63) ? ~uint64_t(0) : uint64_t(0))) {
+            return false;
+        }
+        result = static_cast<int64_t>(low);
+        return true;
+    }
+
+#ifdef __SIZEOF_INT128__
+    static NValue getDecimalValueFromInt128(__int128 value) {
+        TTInt retval;
+        retval.table[0] = static_cast<uint64_t>(value);
+        retval.table[1] = static_cast<uint64_t>(static_cast<unsigned __int128>(value) >> 64);
+        return getDecimalValue(retval);
+    }
+#endif
+
     static NValue opAddDecimals(const NValue& lhs, const NValue& rhs) {
         assert(lhs.isNull() == false);
         assert(rhs.isNull() == false);
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+        int64_t lhsValue, rhsValue;
+        if (decimalFitsInt64(lhs.getDecimal(), lhsValue) && decimalFitsInt64(rhs.getDecimal(), rhsValue)) {
+            const int64_t sum = static_cast<int64_t>(static_cast<uint64_t>(lhsValue) + static_cast<uint64_t>(rhsValue));
+            if (((lhsValue ^ sum) & (rhsValue ^ sum)) >= 0) {
+                return getDecimalValue(TTInt(sum));
+            }
+        }
+
         TTInt retval(lhs.getDecimal());
         if (retval.Add(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2240,6 +2306,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+        int64_t lhsValue, rhsValue;
+        if (decimalFitsInt64(lhs.getDecimal(), lhsValue) && decimalFitsInt64(rhs.getDecimal(), rhsValue)) {
+            const int64_t difference = static_cast<int64_t>(static_cast<uint64_t>(lhsValue) - static_cast<uint64_t>(rhsValue));
+            if (((lhsValue ^ rhsValue) & (lhsValue ^ difference)) >= 0) {
+                return getDecimalValue(TTInt(difference));
+            }
+        }
+
         TTInt retval(lhs.getDecimal());
         if (retval.Sub(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
             char message[4096];
@@ -2264,6 +2338,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef __SIZEOF_INT128__
+        int64_t lhsValue, rhsValue;
+        if (decimalFitsInt64(lhs.getDecimal(), lhsValue) && decimalFitsInt64(rhs.getDecimal(), rhsValue)) {
+            // Truncates toward zero, as the TTLInt division does.
+            return getDecimalValueFromInt128(static_cast<__int128>(lhsValue) * rhsValue / kMaxScaleFactor);
+        }
+#endif
+
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= rhs.getDecimal();
@@ -2299,6 +2381,14 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+#ifdef __SIZEOF_INT128__
+        int64_t lhsValue, rhsValue;
+        if (decimalFitsInt64(lhs.getDecimal(), lhsValue) && decimalFitsInt64(rhs.getDecimal(), rhsValue)
+                && rhsValue != 0) {
+            return getDecimalValueFromInt128(static_cast<__int128>(lhsValue) * kMaxScaleFactor / rhsValue);
+        }
+#endif
+
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= kMaxScaleFactor;
@@ -3087,6 +3177,27 @@ inline void NValue::deserializeFromAllocateForStorage(ValueType type, SerializeI
                              getTypeName(type).c_str());
 }
 
+inline void NValue::deserializeParameterReferencingInput(SerializeInputBE& input, Pool* tempPool)
+{
+    const ValueType type = static_cast<ValueType>(input.readByte());
+    if (type != VALUE_TYPE_VARCHAR && type != VALUE_TYPE_VARBINARY) {
+        deserializeFromAllocateForStorage(type, input, tempPool);
+        return;
+    }
+    setValueType(type);
+    tagAsNotNull();
+    // The length, which becomes the StringRef's size in place.
+    char* lengthAndBytes = const_cast<char*>(input.getRawPointer());
+    const int32_t length = input.readInt();
+    // the NULL SQL string is a NULL C pointer
+    if (length == OBJECTLENGTH_NULL) {
+        setNull();
+        return;
+    }
+    input.getRawPointer(length);
+    setObjectPointer(StringRef::createReferencing(lengthAndBytes, length, tempPool));
+}
+
 /**
  * Serialize this NValue to the provided SerializeOutput
  */
@@ -3402,25 +3513,23 @@ inline void NValue::hashCombine(std::size_t &seed) const {
     case VALUE_TYPE_VARCHAR:
     {
         if (isNull()) {
-            boost::hash_combine( seed, std::string(""));
+            boost::hash_combine(seed, FastHash::hashBytes(NULL, 0));
             return;
         }
         int32_t length;
         const char* buf = getObject_withoutNull(&length);
-        boost::hash_combine(seed, std::string(buf, length));
+        boost::hash_combine(seed, FastHash::hashBytes(buf, length));
         return;
     }
     case VALUE_TYPE_VARBINARY:
     {
         if (isNull()) {
-            boost::hash_combine( seed, std::string(""));
+            boost::hash_combine(seed, FastHash::hashBytes(NULL, 0));
             return;
         }
         int32_t length;
         const char* buf = getObject_withoutNull(&length);
-        for (int32_t i = 0; i < length; i++) {
-            boost::hash_combine(seed, buf[i]);
-        }
+        boost::hash_combine(seed, FastHash::hashBytes(buf, length));
         return;
     }
     case VALUE_TYPE_DECIMAL:
@@ -3865,7 +3974,10 @@ inline NValue NValue::like(const NValue& rhs) const {
                             }
                         }
                     }
-                    return false;
+                    // The % may also match the rest of the value, leaving
+                    // only more %s to match the empty remainder.
+                    Liker recursionContext( *this, m_value.getCursor(), postPercentPatternIterator);
+                    return recursionContext.like();
                 }
                 case '_': {
                     if (m_value.atEnd()) {
@@ -21,11 +21,14 @@
 #include "common/SerializableEEException.h"
 
 #include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <climits>
 #include <inttypes.h>
+#include <string>
 
 namespace voltdb {
 
@@ -155,6 +158,14 @@ namespace voltdb {
             return m_value[index];
         }
 
+        /** The value written back out as compact JSON. */
+        std::string toJSONString() const {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            m_value.Accept(writer);
+            return std::string(buffer.GetString(), buffer.Size());
+        }
+
     private:
         PlannerDomValue(rapidjson::Value &value) : m_value(value) {}
 
@@ -48,6 +48,7 @@ namespace voltdb
               m_rowCountForDR(0),
               m_startDRSequenceNumber(std::numeric_limits<int64_t>::max()),
               m_lastDRSequenceNumber(std::numeric_limits<int64_t>::max()),
+              m_startDRTimestamp(std::numeric_limits<int64_t>::max()),
               m_lastSpUniqueId(0),
               m_lastMpUniqueId(0),
               m_type(NORMAL_STREAM_BLOCK),
@@ -67,6 +68,7 @@ namespace voltdb
               m_rowCountForDR(other->m_rowCountForDR),
               m_startDRSequenceNumber(other->m_startDRSequenceNumber),
               m_lastDRSequenceNumber(other->m_lastDRSequenceNumber),
+              m_startDRTimestamp(other->m_startDRTimestamp),
               m_lastSpUniqueId(other->m_lastSpUniqueId),
               m_lastMpUniqueId(other->m_lastMpUniqueId),
               m_type(other->m_type),
@@ -137,6 +139,18 @@ namespace voltdb
             m_startDRSequenceNumber = std::min(startDRSequenceNumber, m_startDRSequenceNumber);
         }
 
+        /**
+         * Milliseconds since the Unix epoch of the oldest DR transaction in
+         * the block, or max int64 when the block has no timed transaction.
+         */
+        int64_t startDRTimestamp() const {
+            return m_startDRTimestamp;
+        }
+
+        void startDRTimestamp(int64_t startDRTimestamp) {
+            m_startDRTimestamp = std::min(startDRTimestamp, m_startDRTimestamp);
+        }
+
         int64_t lastDRSequenceNumber() const {
             return m_lastDRSequenceNumber;
         }
@@ -235,6 +249,7 @@ namespace voltdb
         size_t m_rowCountForDR;
         int64_t m_startDRSequenceNumber;
         int64_t m_lastDRSequenceNumber;
+        int64_t m_startDRTimestamp;
         int64_t m_lastSpUniqueId;
         int64_t m_lastMpUniqueId;
         StreamBlockType m_type;
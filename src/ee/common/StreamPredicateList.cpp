@@ -34,7 +34,8 @@ namespace voltdb
 bool StreamPredicateList::parseStrings(
         const std::vector<std::string> &predicateStrings,
         std::ostringstream& errmsg,
-        std::vector<bool> &predicateDeletes)
+        std::vector<bool> &predicateDeletes,
+        std::vector<TupleOutputStream::RowFormat> &predicateRowFormats)
 {
     bool failed = false;
     for (std::vector<std::string>::const_iterator iter = predicateStrings.begin();
@@ -49,6 +50,16 @@ bool StreamPredicateList::parseStrings(
 
                     predicateDeletes.push_back(predicateObject.valueForKey("triggersDelete").asBool());
 
+                    TupleOutputStream::RowFormat rowFormat = TupleOutputStream::ROW_FORMAT_NATIVE;
+                    if (predicateObject.hasKey("rowFormat")) {
+                        std::string rowFormatName = predicateObject.valueForKey("rowFormat").asStr();
+                        if (!TupleOutputStream::parseRowFormat(rowFormatName, rowFormat)) {
+                            errmsg << "Unknown stream predicate row format " << rowFormatName;
+                            predFailed = true;
+                        }
+                    }
+                    predicateRowFormats.push_back(rowFormat);
+
                     AbstractExpression *expr = NULL;
                     if (predicateObject.hasKey("predicateExpression")) {
                         expr = AbstractExpression::buildExpressionTree(
@@ -84,6 +95,7 @@ bool StreamPredicateList::parseStrings(
         else {
             // NULL predicates are okay.
             push_back(NULL);
+            predicateRowFormats.push_back(TupleOutputStream::ROW_FORMAT_NATIVE);
         }
     }
     return !failed;
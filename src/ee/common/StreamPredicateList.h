@@ -21,6 +21,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "SerializableEEException.h"
+#include "TupleOutputStream.h"
 #include "expressions/abstractexpression.h"
 
 namespace voltdb
@@ -45,10 +46,15 @@ public:
     virtual ~StreamPredicateList()
     {}
 
-    /** Parse expression strings and add generated predicate objects to list. */
+    /**
+     * Parse expression strings and add generated predicate objects to list.
+     * Each predicate's optional "rowFormat" goes to predicateRowFormats,
+     * NATIVE when it has none.
+     */
     bool parseStrings(const std::vector<std::string> &predicateStrings,
                       std::ostringstream& errmsg,
-                      std::vector<bool> &predicateDeleteFlags);
+                      std::vector<bool> &predicateDeleteFlags,
+                      std::vector<TupleOutputStream::RowFormat> &predicateRowFormats);
 };
 
 } // namespace voltdb
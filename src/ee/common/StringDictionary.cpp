@@ -0,0 +1,119 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StringDictionary.h"
+
+#include "StringRef.h"
+#include "ThreadLocalPool.h"
+
+#include "boost/functional/hash.hpp"
+
+#include <cstring>
+
+using namespace voltdb;
+
+// A few thousand distinct values of up to a few hundred bytes keeps the
+// worst case cost of a dictionary that never pays off to about 1MB.
+const std::size_t StringDictionary::MAX_ENTRIES = 4096;
+const int32_t StringDictionary::MAX_VALUE_LENGTH = 256;
+
+// Entries are small, so use small pool chunks rather than the temp pool
+// default -- every non-inlined VARCHAR column of every table has one.
+static const uint64_t DICTIONARY_POOL_CHUNK_SIZE = 16384;
+
+std::size_t StringDictionary::KeyHasher::operator()(const Key& key) const
+{ return boost::hash_range(key.m_bytes, key.m_bytes + key.m_length); }
+
+bool StringDictionary::KeyEqualityChecker::operator()(const Key& lhs, const Key& rhs) const
+{
+    return lhs.m_length == rhs.m_length &&
+        ::memcmp(lhs.m_bytes, rhs.m_bytes, lhs.m_length) == 0;
+}
+
+StringDictionary::StringDictionary()
+  : m_pool(DICTIONARY_POOL_CHUNK_SIZE, 1)
+  , m_entries()
+  , m_lookupsOnceFull(0)
+  , m_hitsOnceFull(0)
+  , m_retired(false)
+{ }
+
+bool StringDictionary::owns(const StringRef* sref) const
+{ return sref->getDictionary() == this; }
+
+const StringRef* StringDictionary::intern(const StringRef* sref)
+{
+    // Copying a value between rows of the same table is the common case
+    // for updates and needs no lookup.
+    if (owns(sref)) {
+        return sref;
+    }
+    if (m_retired) {
+        return NULL;
+    }
+    int32_t length;
+    const char* bytes = sref->getObject(&length);
+    if (length > MAX_VALUE_LENGTH) {
+        return NULL;
+    }
+
+    EntryMap::const_iterator found = m_entries.find(Key(bytes, length));
+    bool full = m_entries.size() >= MAX_ENTRIES;
+    if (full) {
+        noteLookupOnceFull(found != m_entries.end());
+    }
+    if (found != m_entries.end()) {
+        return found->second;
+    }
+    if (full) {
+        return NULL;
+    }
+
+    std::size_t entrySize = sizeof(StringRef) + sizeof(StringDictionary*) +
+        sizeof(ThreadLocalPool::Sized) + length;
+    StringRef* entry = new (m_pool.allocate(entrySize)) StringRef(this, length);
+    char* entryBytes = entry->getObjectValue();
+    ::memcpy(entryBytes, bytes, length);
+    // Key the entry by its own copy of the bytes.
+    m_entries.insert(EntryMap::value_type(Key(entryBytes, length), entry));
+    return entry;
+}
+
+void StringDictionary::noteLookupOnceFull(bool hit)
+{
+    ++m_lookupsOnceFull;
+    if (hit) {
+        ++m_hitsOnceFull;
+    }
+    if (m_lookupsOnceFull < MAX_ENTRIES) {
+        return;
+    }
+    // Over the last window of lookups, the shared values have to be
+    // matching at least a quarter of the time to be worth the probes.
+    if (m_hitsOnceFull < m_lookupsOnceFull / 4) {
+        m_retired = true;
+    }
+    m_lookupsOnceFull = 0;
+    m_hitsOnceFull = 0;
+}
+
+int64_t StringDictionary::getAllocatedMemory()
+{
+    return m_pool.getAllocatedMemory() +
+        static_cast<int64_t>(m_entries.bucket_count() * sizeof(void*) +
+                             m_entries.size() * (sizeof(EntryMap::value_type) + sizeof(void*)));
+}
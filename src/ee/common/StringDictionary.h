@@ -0,0 +1,107 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGDICTIONARY_H
+#define STRINGDICTIONARY_H
+
+#include "common/Pool.hpp"
+
+#include "boost/unordered_map.hpp"
+
+#include <stdint.h>
+
+namespace voltdb
+{
+class StringRef;
+
+/// A dictionary of shared, immutable persistent strings for one
+/// non-inlined VARCHAR column of a persistent table.
+/// Low-cardinality columns (status codes, country names, ...) repeat the
+/// same few values across millions of rows. Rather than giving every row
+/// its own relocatable copy of the value, tuples of the owning table store
+/// a pointer to the single StringRef the dictionary holds for that value.
+/// Rows with equal values then share a StringRef, so equality comparisons
+/// between them reduce to a pointer comparison (see
+/// NValue::compareStringValue).
+///
+/// Entries are never freed individually -- StringRef::destroy is a no-op
+/// for them -- they live until the dictionary is destroyed along with its
+/// table. To bound that, only values up to MAX_VALUE_LENGTH bytes are
+/// shared and the dictionary stops taking new values once it holds
+/// MAX_ENTRIES of them. Past that point it keeps serving the values it has
+/// as long as they account for a reasonable fraction of lookups, and
+/// otherwise retires itself so that high-cardinality columns do not pay
+/// for a hash probe on every insert.
+class StringDictionary
+{
+public:
+    StringDictionary();
+
+    /// Return the dictionary's StringRef for the given string's value,
+    /// adding a new entry for a value that has not been seen before.
+    /// Return NULL if the value can not be shared because it is too long or
+    /// because the dictionary is full and has no entry for it. The caller
+    /// is then expected to fall back to an unshared persistent copy.
+    const StringRef* intern(const StringRef* sref);
+
+    /// Is this StringRef one of this dictionary's entries?
+    bool owns(const StringRef* sref) const;
+
+    /// The number of distinct values held.
+    std::size_t size() const { return m_entries.size(); }
+
+    /// Has the dictionary stopped sharing values?
+    bool isRetired() const { return m_retired; }
+
+    /// Memory held by the entries and their lookup table.
+    int64_t getAllocatedMemory();
+
+    static const std::size_t MAX_ENTRIES;
+    static const int32_t MAX_VALUE_LENGTH;
+
+private:
+    struct Key {
+        Key(const char* bytes, int32_t length) : m_bytes(bytes), m_length(length) { }
+        const char* m_bytes;
+        int32_t m_length;
+    };
+
+    struct KeyHasher {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct KeyEqualityChecker {
+        bool operator()(const Key& lhs, const Key& rhs) const;
+    };
+
+    typedef boost::unordered_map<Key, const StringRef*, KeyHasher, KeyEqualityChecker> EntryMap;
+
+    void noteLookupOnceFull(bool hit);
+
+    // Backing storage for the entries, each a StringRef followed by a
+    // pointer back to this dictionary and the sized string data.
+    Pool m_pool;
+    EntryMap m_entries;
+    // Lookups and hits since the dictionary filled up, per sampling window.
+    std::size_t m_lookupsOnceFull;
+    std::size_t m_hitsOnceFull;
+    bool m_retired;
+};
+
+} // namespace voltdb
+
+#endif // STRINGDICTIONARY_H
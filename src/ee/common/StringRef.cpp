@@ -22,6 +22,8 @@
 
 using namespace voltdb;
 
+int32_t StringRef::s_packedMaxLength = 0;
+
 inline ThreadLocalPool::Sized* asSizedObject(char* stringPtr)
 { return reinterpret_cast<ThreadLocalPool::Sized*>(stringPtr); }
 
@@ -48,6 +50,14 @@ const char* StringRef::getObject(int32_t* lengthOut) const
 
 int32_t StringRef::getAllocatedSize() const
 {
+    // A shared string's memory is accounted for once, by its dictionary,
+    // rather than by each of the tuples referencing it.
+    if (getDictionary() != NULL) {
+        return 0;
+    }
+    if (isPacked()) {
+        return static_cast<int32_t>(packedAllocationSize(getObjectLength()));
+    }
     // The CompactingPool allocated a chunk of this size for storage.
     int32_t alloc_size = ThreadLocalPool::getAllocationSizeForRelocatable(asSizedObject(m_stringPtr));
     //cout << "Pool allocation size: " << alloc_size << endl;
@@ -85,6 +95,64 @@ inline StringRef::StringRef(Pool* unused, int32_t sz)
   : m_stringPtr(reinterpret_cast<char*>(this+1))
 { asSizedObject(m_stringPtr)->m_size = sz; }
 
+// Temporary strings referenced in place have only their StringRef in the
+// pool, pointing at the length that precedes the string in its buffer.
+inline StringRef::StringRef(Pool* unused, char* sizedStorage)
+  : m_stringPtr(sizedStorage)
+{ }
+
+// Shared strings are also allocated in one piece with their referring
+// StringRefs, but the string data is preceded by a pointer to the owning
+// dictionary. This keeps them distinguishable from temporary strings.
+StringRef::StringRef(StringDictionary* dictionary, int32_t sz)
+  : m_stringPtr(reinterpret_cast<char*>(this+1) + sizeof(StringDictionary*))
+{
+    *reinterpret_cast<StringDictionary**>(this+1) = dictionary;
+    asSizedObject(m_stringPtr)->m_size = sz;
+}
+
+// Packed persistent strings share the layout of shared strings, with a NULL
+// in place of the dictionary pointer.
+bool StringRef::isPacked() const
+{
+    return m_stringPtr == reinterpret_cast<const char*>(this+1) + sizeof(StringDictionary*) &&
+           *reinterpret_cast<StringDictionary* const*>(this+1) == NULL;
+}
+
+// Rounded up so that all the packed strings share a few exact sized pools.
+std::size_t StringRef::packedAllocationSize(int32_t sz)
+{
+    std::size_t unrounded = sizeof(StringRef) + sizeof(StringDictionary*) +
+                            sizeof(ThreadLocalPool::Sized) + sz;
+    return (unrounded + 15) & ~static_cast<std::size_t>(15);
+}
+
+void StringRef::setPackedMaxLength(int32_t maxLength)
+{
+#ifndef MEMCHECK
+    if (maxLength < 0) {
+        maxLength = 0;
+    }
+    else if (maxLength > PACKED_MAX_LENGTH_LIMIT) {
+        maxLength = PACKED_MAX_LENGTH_LIMIT;
+    }
+    s_packedMaxLength = maxLength;
+#endif
+}
+
+inline bool StringRef::isContiguous() const
+{ return m_stringPtr == reinterpret_cast<const char*>(this+1); }
+
+StringDictionary* StringRef::getDictionary() const
+{
+    // Persistent strings can never pass this test for the same reason
+    // that they can never pass the isContiguous test -- see destroy.
+    if (m_stringPtr != reinterpret_cast<const char*>(this+1) + sizeof(StringDictionary*)) {
+        return NULL;
+    }
+    return *reinterpret_cast<StringDictionary* const*>(this+1);
+}
+
 // The destroy method keeps this from getting run on temporary strings.
 inline StringRef::~StringRef()
 {
@@ -105,6 +173,10 @@ StringRef* StringRef::create(int32_t sz, const char* source, Pool* tempPool)
     if (tempPool) {
         result = new (tempPool->allocate(sizeof(StringRef)+sizeof(ThreadLocalPool::Sized) + sz)) StringRef(tempPool, sz);
     }
+    else if (sz <= s_packedMaxLength) {
+        result = new (ThreadLocalPool::allocateExactSizedObject(packedAllocationSize(sz)))
+                StringRef(static_cast<StringDictionary*>(NULL), sz);
+    }
     else {
 #ifdef MEMCHECK
         result = new StringRef(sz);
@@ -118,6 +190,13 @@ StringRef* StringRef::create(int32_t sz, const char* source, Pool* tempPool)
     return result;
 }
 
+StringRef* StringRef::createReferencing(char* lengthAndBytes, int32_t sz, Pool* tempPool)
+{
+    StringRef* result = new (tempPool->allocate(sizeof(StringRef))) StringRef(tempPool, lengthAndBytes);
+    asSizedObject(lengthAndBytes)->m_size = sz;
+    return result;
+}
+
 // The destroy method keeps this from getting run on temporary strings.
 void StringRef::operator delete(void* sref)
 {
@@ -142,7 +221,16 @@ StringRef::destroy(StringRef* sref)
     // unlikely event that the two allocations were very close to each other,
     // they would still be separated by that offset and would fail this
     // test.
-    if (sref->m_stringPtr == reinterpret_cast<char*>(sref+1)) {
+    if (sref->isContiguous()) {
+        return;
+    }
+    // Shared strings belong to their dictionary and are freed with it.
+    if (sref->getDictionary() != NULL) {
+        return;
+    }
+    // Packed strings have no relocatable storage to free.
+    if (sref->isPacked()) {
+        ThreadLocalPool::freeExactSizedObject(packedAllocationSize(sref->getObjectLength()), sref);
         return;
     }
     delete sref;
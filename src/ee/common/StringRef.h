@@ -18,11 +18,13 @@
 #ifndef STRINGREF_H
 #define STRINGREF_H
 
+#include <cstddef>
 #include <stdint.h>
 
 namespace voltdb
 {
 class Pool;
+class StringDictionary;
 
 /// An object to use in lieu of raw char* pointers for strings
 /// which are not inlined into tuple storage.  This provides a
@@ -48,6 +50,14 @@ public:
     /// allocated out of the ThreadLocalPool's persistent storage.
     static StringRef* create(int32_t size, const char* bytes, Pool* tempPool);
 
+    /// Create a temporary StringRef for a string that is already in a
+    /// writable buffer as a 4-byte length followed by its bytes, as
+    /// serialized parameters are, without copying the bytes. The length
+    /// is rewritten in place in native byte order. Only the StringRef
+    /// is allocated in the Pool, and the buffer must outlive it. Like
+    /// other temporary strings, it must not be destroyed.
+    static StringRef* createReferencing(char* lengthAndBytes, int32_t size, Pool* tempPool);
+
     /// Destroy the given StringRef object and free any memory
     /// allocated from persistent pools to store the object.
     /// sref must have been allocated and returned by a call to
@@ -55,6 +65,8 @@ public:
     /// This is a no-op for strings created in a temporary Pool
     /// -- temporary pools pool their allocations
     /// until the pool itself is purged or destroyed.
+    /// It is also a no-op for strings shared through a StringDictionary,
+    /// which owns them for the lifetime of the dictionary.
     /// Currently, the StringRefs for persistent strings are permanently
     /// allocated into a memory pool which is reserved for future reuse
     /// specifically as persistent StringRef memory.
@@ -67,17 +79,50 @@ public:
 
     const char* getObject(int32_t* lengthOut) const;
 
+    /// Persistent strings of up to this many bytes are allocated in one
+    /// piece with their StringRef, saving the separate relocatable
+    /// allocation, its back-pointer and a cache miss on every read.
+    /// Such strings are never moved by compaction; their freed slots are
+    /// reused by strings of the same size class instead. 0, the default,
+    /// puts every persistent string in the relocatable pools.
+    static void setPackedMaxLength(int32_t maxLength);
+    static int32_t packedMaxLength() { return s_packedMaxLength; }
+    static const int32_t PACKED_MAX_LENGTH_LIMIT = 256;
+
+    /// The start of the string's storage, without dereferencing it,
+    /// for scans that prefetch the string ahead of reading it.
+    const char* storageAddress() const { return m_stringPtr; }
+
 private:
+    friend class StringDictionary;
+
     // Signature used internally for persistent strings
     StringRef(int32_t size);
     // Signature used internally for temporary strings
     StringRef(Pool* tempPool, int32_t size);
+    // Signature used internally for temporary strings referenced in place
+    StringRef(Pool* tempPool, char* sizedStorage);
+    // Signature used internally for strings shared through a dictionary
+    // and, with a NULL dictionary, for packed persistent strings
+    StringRef(StringDictionary* dictionary, int32_t size);
     // Only called from destroy and only for persistent strings.
     ~StringRef();
 
     // Only called from destroy and only for persistent strings.
     void operator delete(void* object);
 
+    // Is the string data allocated in one piece with this StringRef,
+    // as for temporary strings?
+    bool isContiguous() const;
+    // Return the owning dictionary of a shared string, NULL otherwise.
+    StringDictionary* getDictionary() const;
+    // Is this a persistent string allocated in one piece with this StringRef?
+    bool isPacked() const;
+    // The exact sized allocation holding a packed string of this length.
+    static std::size_t packedAllocationSize(int32_t size);
+
+    static int32_t s_packedMaxLength;
+
     char* m_stringPtr;
 };
 
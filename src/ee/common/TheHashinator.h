@@ -74,6 +74,17 @@ class TheHashinator {
         }
     }
 
+    /*
+     * Pick the partitions of count values at once, into partitions, for
+     * callers hashing many values, such as a scan over a table.
+     */
+    void hashinate(const NValue *values, int32_t count, int32_t *partitions) const
+    {
+        for (int32_t ii = 0; ii < count; ii++) {
+            partitions[ii] = hashinate(values[ii]);
+        }
+    }
+
     /*
      * Given a previously calculated hash value pick the partition to store the data in
      */
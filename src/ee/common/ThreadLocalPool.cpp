@@ -26,6 +26,15 @@
 
 #include <iostream>
 #include <pthread.h>
+#include <stdint.h>
+
+#ifdef LINUX
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace voltdb {
 
@@ -52,6 +61,10 @@ static pthread_key_t m_stringKey;
  * Thread local key for storing integer value of amount of memory allocated
  */
 static pthread_key_t m_keyAllocated;
+/**
+ * Thread local key for the accounting of memory handed out by allocateLargeBlock
+ */
+static pthread_key_t m_largeBlockKey;
 static pthread_once_t m_keyOnce = PTHREAD_ONCE_INIT;
 
 typedef boost::pool<voltdb_pool_allocator_new_delete> PoolForObjectSize;
@@ -63,10 +76,27 @@ typedef PairType* PairTypePtr;
 
 typedef boost::unordered_map<int32_t, boost::shared_ptr<CompactingPool> > CompactingStringStorage;
 
+/**
+ * Per-thread accounting for allocateLargeBlock. Whether a block got huge
+ * pages or was bound to the local node is only known at allocation time,
+ * so the attribution of each live block is kept around for its release.
+ */
+struct LargeBlockAccounting {
+    struct Attribution {
+        std::size_t m_hugePageBytes;
+        std::size_t m_localNodeBytes;
+    };
+    LargeBlockAccounting() : m_hugePageBytes(0), m_localNodeBytes(0) { }
+    std::size_t m_hugePageBytes;
+    std::size_t m_localNodeBytes;
+    boost::unordered_map<char*, Attribution> m_blocks;
+};
+
 static void createThreadLocalKey() {
     (void)pthread_key_create( &m_key, NULL);
     (void)pthread_key_create( &m_stringKey, NULL);
     (void)pthread_key_create( &m_keyAllocated, NULL);
+    (void)pthread_key_create( &m_largeBlockKey, NULL);
 }
 
 ThreadLocalPool::ThreadLocalPool() {
@@ -77,6 +107,7 @@ ThreadLocalPool::ThreadLocalPool() {
                 new PairType(
                         1, new PoolsByObjectSize())));
         pthread_setspecific(m_stringKey, static_cast<const void*>(new CompactingStringStorage()));
+        pthread_setspecific(m_largeBlockKey, static_cast<const void*>(new LargeBlockAccounting()));
     } else {
         PairTypePtr p =
                 static_cast<PairTypePtr>(pthread_getspecific(m_key));
@@ -97,6 +128,8 @@ ThreadLocalPool::~ThreadLocalPool() {
             pthread_setspecific(m_stringKey, NULL);
             delete static_cast<std::size_t*>(pthread_getspecific(m_keyAllocated));
             pthread_setspecific( m_keyAllocated, NULL);
+            delete static_cast<LargeBlockAccounting*>(pthread_getspecific(m_largeBlockKey));
+            pthread_setspecific(m_largeBlockKey, NULL);
         } else {
             pthread_setspecific( m_key, new PairType( p->first - 1, p->second));
         }
@@ -167,6 +200,9 @@ int32_t ThreadLocalPool::getAllocationSizeForRelocatable(Sized* data)
 void ThreadLocalPool::freeRelocatable(Sized* data)
 { delete [] reinterpret_cast<char*>(data); }
 
+std::vector<ThreadLocalPool::RelocatableSizeClassStats> ThreadLocalPool::getRelocatableStats()
+{ return std::vector<RelocatableSizeClassStats>(); }
+
 #else // not MEMCHECK
 
 static CompactingStringStorage& getStringPoolMap()
@@ -196,9 +232,12 @@ ThreadLocalPool::Sized* ThreadLocalPool::allocateRelocatable(char** referrer, in
     if (iter == poolMap.end()) {
         // There is no pool yet for objects of this size, so create one.
         // Compute num_elements to be the largest multiple of alloc_size
-        // to fit in a 2MB buffer.
+        // to fit in a 2MB buffer. The first buffer is only about 64KB,
+        // and the buffers double from there, so that the many sizes of
+        // wide-ranging VARCHAR data do not each hold on to 2MB.
         int32_t num_elements = ((2 * 1024 * 1024 - 1) / alloc_size) + 1;
-        boost::shared_ptr<CompactingPool> pool(new CompactingPool(alloc_size, num_elements));
+        int32_t first_elements = ((64 * 1024 - 1) / alloc_size) + 1;
+        boost::shared_ptr<CompactingPool> pool(new CompactingPool(alloc_size, num_elements, first_elements));
         poolMap.insert(std::pair<int32_t, boost::shared_ptr<CompactingPool> >(alloc_size, pool));
         allocation = pool->malloc(referrer);
     }
@@ -236,6 +275,20 @@ void ThreadLocalPool::freeRelocatable(Sized* sized)
     iter->second->free(sized);
 }
 
+std::vector<ThreadLocalPool::RelocatableSizeClassStats> ThreadLocalPool::getRelocatableStats()
+{
+    std::vector<RelocatableSizeClassStats> result;
+    CompactingStringStorage& poolMap = getStringPoolMap();
+    for (CompactingStringStorage::iterator iter = poolMap.begin(); iter != poolMap.end(); ++iter) {
+        RelocatableSizeClassStats stats;
+        stats.m_allocationSize = iter->first;
+        stats.m_objectCount = iter->second->getCount();
+        stats.m_bytesAllocated = iter->second->getBytesAllocated();
+        result.push_back(stats);
+    }
+    return result;
+}
+
 #endif
 
 void* ThreadLocalPool::allocateExactSizedObject(std::size_t sz)
@@ -315,10 +368,255 @@ std::size_t ThreadLocalPool::getPoolAllocationSize() {
     return bytes_allocated;
 }
 
+const std::size_t ThreadLocalPool::LARGE_BLOCK_SIZE = 2 * 1024 * 1024;
+
+static LargeBlockAccounting* getLargeBlockAccounting()
+{
+    // Large blocks can be requested before any ThreadLocalPool exists.
+    (void)pthread_once(&m_keyOnce, createThreadLocalKey);
+    return static_cast<LargeBlockAccounting*>(pthread_getspecific(m_largeBlockKey));
+}
+
+#if defined(LINUX) && !defined(MEMCHECK)
+
+static const std::size_t GIGANTIC_PAGE_SIZE = 1024 * 1024 * 1024;
+
+// Set once a MAP_HUGETLB mapping has failed, so that a host with no huge
+// pages reserved doesn't make a failing mmap for every block. Sites may
+// race to set it, which is harmless.
+static volatile bool s_hugeTlbUnavailable = false;
+
+/**
+ * Map size bytes of anonymous memory. hugePageBytes is set to the number of
+ * bytes that are backed by explicit huge pages or advised for transparent
+ * huge pages.
+ */
+static char* mapLargeBlock(std::size_t size, std::size_t& hugePageBytes)
+{
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (size % ThreadLocalPool::LARGE_BLOCK_SIZE == 0 && !s_hugeTlbUnavailable) {
+        void* mapped = MAP_FAILED;
+#ifdef MAP_HUGE_SHIFT
+        if (size % GIGANTIC_PAGE_SIZE == 0) {
+            mapped = ::mmap(NULL, size, protection, flags | MAP_HUGETLB | (30 << MAP_HUGE_SHIFT), -1, 0);
+        }
+#endif
+        if (mapped == MAP_FAILED) {
+            mapped = ::mmap(NULL, size, protection, flags | MAP_HUGETLB, -1, 0);
+        }
+        if (mapped != MAP_FAILED) {
+            hugePageBytes = size;
+            return static_cast<char*>(mapped);
+        }
+        // No huge pages reserved (or not enough left): fall through.
+        s_hugeTlbUnavailable = true;
+    }
+#endif
+    // Over-map by one huge page so that the block can start on a huge page
+    // boundary, then give back the unaligned head and the unused tail.
+    const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t mappedSize = (size + pageSize - 1) / pageSize * pageSize;
+    const std::size_t paddedSize = mappedSize + ThreadLocalPool::LARGE_BLOCK_SIZE;
+    void* padded = ::mmap(NULL, paddedSize, protection, flags, -1, 0);
+    if (padded == MAP_FAILED) {
+        throwFatalException("Failed to map a block of %lu bytes: %s",
+                            static_cast<unsigned long>(size), strerror(errno));
+    }
+    char* raw = static_cast<char*>(padded);
+    const uintptr_t mask = ThreadLocalPool::LARGE_BLOCK_SIZE - 1;
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + mask) & ~mask);
+    const std::size_t head = aligned - raw;
+    if (head != 0) {
+        ::munmap(raw, head);
+    }
+    const std::size_t tail = paddedSize - head - mappedSize;
+    if (tail != 0) {
+        ::munmap(aligned + mappedSize, tail);
+    }
+    hugePageBytes = 0;
+#ifdef MADV_HUGEPAGE
+    if (::madvise(aligned, mappedSize, MADV_HUGEPAGE) == 0) {
+        // Only whole huge pages can be collapsed by the kernel.
+        hugePageBytes = size / ThreadLocalPool::LARGE_BLOCK_SIZE * ThreadLocalPool::LARGE_BLOCK_SIZE;
+    }
+#endif
+    return aligned;
+}
+
+/**
+ * Prefer the NUMA node of the CPU the calling thread is running on for
+ * the (not yet faulted) pages of a new mapping. MPOL_PREFERRED lets the
+ * kernel fall back to another node rather than fail when the local node
+ * is full. Returns false if the policy could not be set.
+ */
+static bool bindToLocalNode(char* block, std::size_t size)
+{
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+    static const int MPOL_PREFERRED_POLICY = 1;
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, NULL) != 0) {
+        return false;
+    }
+    unsigned long nodeMask[1] = { 0 };
+    const unsigned long maxNode = sizeof(nodeMask) * 8;
+    if (node >= maxNode) {
+        return false;
+    }
+    nodeMask[0] = 1UL << node;
+    return ::syscall(SYS_mbind, block, size, MPOL_PREFERRED_POLICY, nodeMask, maxNode, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+char* ThreadLocalPool::allocateLargeBlock(std::size_t size)
+{
+    if (size < LARGE_BLOCK_SIZE) {
+        return new char[size];
+    }
+    LargeBlockAccounting::Attribution attribution;
+    char* block = mapLargeBlock(size, attribution.m_hugePageBytes);
+    attribution.m_localNodeBytes = bindToLocalNode(block, size) ? size : 0;
+    LargeBlockAccounting* accounting = getLargeBlockAccounting();
+    // Threads without a ThreadLocalPool (some unit tests) go unaccounted.
+    if (accounting != NULL) {
+        accounting->m_hugePageBytes += attribution.m_hugePageBytes;
+        accounting->m_localNodeBytes += attribution.m_localNodeBytes;
+        accounting->m_blocks[block] = attribution;
+    }
+    return block;
+}
+
+void ThreadLocalPool::freeLargeBlock(char* block, std::size_t size)
+{
+    if (size < LARGE_BLOCK_SIZE) {
+        delete [] block;
+        return;
+    }
+    LargeBlockAccounting* accounting = getLargeBlockAccounting();
+    if (accounting != NULL) {
+        boost::unordered_map<char*, LargeBlockAccounting::Attribution>::iterator iter =
+            accounting->m_blocks.find(block);
+        if (iter != accounting->m_blocks.end()) {
+            accounting->m_hugePageBytes -= iter->second.m_hugePageBytes;
+            accounting->m_localNodeBytes -= iter->second.m_localNodeBytes;
+            accounting->m_blocks.erase(iter);
+        }
+    }
+    if (::munmap(block, size) != 0) {
+        throwFatalException("Failed to unmap a block of %lu bytes: %s",
+                            static_cast<unsigned long>(size), strerror(errno));
+    }
+}
+
+bool ThreadLocalPool::moveLargeBlockToFile(char* block, std::size_t size, int fd, off_t offset)
+{
+    if (size < LARGE_BLOCK_SIZE) {
+        return false;
+    }
+    std::size_t written = 0;
+    while (written < size) {
+        ssize_t count = ::pwrite(fd, block + written, size - written, offset + written);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += count;
+    }
+    // A failed MAP_FIXED may already have unmapped the old pages, so there
+    // is nothing to fall back to.
+    void* mapped = ::mmap(block, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset);
+    if (mapped == MAP_FAILED) {
+        throwFatalException("Failed to map a block of %lu bytes from a file: %s",
+                            static_cast<unsigned long>(size), strerror(errno));
+    }
+    // The block is no longer backed by huge pages or bound to a node.
+    LargeBlockAccounting* accounting = getLargeBlockAccounting();
+    if (accounting != NULL) {
+        boost::unordered_map<char*, LargeBlockAccounting::Attribution>::iterator iter =
+            accounting->m_blocks.find(block);
+        if (iter != accounting->m_blocks.end()) {
+            accounting->m_hugePageBytes -= iter->second.m_hugePageBytes;
+            accounting->m_localNodeBytes -= iter->second.m_localNodeBytes;
+            accounting->m_blocks.erase(iter);
+        }
+    }
+    return true;
+}
+
+void ThreadLocalPool::moveLargeBlockToMemory(char* block, std::size_t size)
+{
+    void* copy = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (copy == MAP_FAILED) {
+        throwFatalException("Failed to map a block of %lu bytes: %s",
+                            static_cast<unsigned long>(size), strerror(errno));
+    }
+    ::memcpy(copy, block, size);
+    // Moving the copy's pages over the file mapping swaps them atomically.
+    if (::mremap(copy, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, block) == MAP_FAILED) {
+        throwFatalException("Failed to move a block of %lu bytes back into memory: %s",
+                            static_cast<unsigned long>(size), strerror(errno));
+    }
+}
+
+#ifndef MADV_PAGEOUT
+// Linux 5.4; older kernels reject it, and the block stays resident.
+#define MADV_PAGEOUT 21
+#endif
+
+bool ThreadLocalPool::pageOutLargeBlock(char* block, std::size_t size)
+{
+    if (size < LARGE_BLOCK_SIZE) {
+        return false;
+    }
+    // Explicit huge pages cannot be paged out.
+    return ::madvise(block, size, MADV_PAGEOUT) == 0;
+}
+
+#else // MEMCHECK or not LINUX
+
+char* ThreadLocalPool::allocateLargeBlock(std::size_t size)
+{ return new char[size]; }
+
+void ThreadLocalPool::freeLargeBlock(char* block, std::size_t)
+{ delete [] block; }
+
+bool ThreadLocalPool::moveLargeBlockToFile(char*, std::size_t, int, off_t)
+{ return false; }
+
+void ThreadLocalPool::moveLargeBlockToMemory(char*, std::size_t)
+{ }
+
+bool ThreadLocalPool::pageOutLargeBlock(char*, std::size_t)
+{ return false; }
+
+#endif
+
+std::size_t ThreadLocalPool::getHugePageAllocationSize()
+{
+    LargeBlockAccounting* accounting = getLargeBlockAccounting();
+    return accounting == NULL ? 0 : accounting->m_hugePageBytes;
+}
+
+std::size_t ThreadLocalPool::getLocalNodeAllocationSize()
+{
+    LargeBlockAccounting* accounting = getLargeBlockAccounting();
+    return accounting == NULL ? 0 : accounting->m_localNodeBytes;
+}
+
 char * voltdb_pool_allocator_new_delete::malloc(const size_type bytes) {
-    (*static_cast< std::size_t* >(pthread_getspecific(m_keyAllocated))) += bytes + sizeof(std::size_t);
-    //std::cout << "Pooled memory is " << ((*static_cast< std::size_t* >(pthread_getspecific(m_keyAllocated))) / (1024 * 1024)) << " after requested allocation " << (bytes / (1024 * 1024)) <<  std::endl;
+    // boost::pool expects NULL rather than an exception when out of memory,
+    // and its chunks are too small and too many to be worth huge pages.
     char *retval = new (std::nothrow) char[bytes + sizeof(std::size_t)];
+    if (retval == NULL) {
+        return NULL;
+    }
+    (*static_cast< std::size_t* >(pthread_getspecific(m_keyAllocated))) += bytes + sizeof(std::size_t);
     *reinterpret_cast<std::size_t*>(retval) = bytes + sizeof(std::size_t);
     return &retval[sizeof(std::size_t)];
 }
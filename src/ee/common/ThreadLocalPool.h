@@ -21,6 +21,9 @@
 #include "boost/pool/pool.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include <sys/types.h>
+#include <vector>
+
 namespace voltdb {
 
 /**
@@ -75,6 +78,69 @@ public:
 
     static std::size_t getPoolAllocationSize();
 
+    /// Allocations of at least this many bytes are mapped directly from
+    /// the OS by allocateLargeBlock. It is also the huge page size.
+    static const std::size_t LARGE_BLOCK_SIZE;
+
+    /**
+     * Allocate a large buffer such as the tuple storage of a TupleBlock
+     * or a ContiguousAllocator block.
+     * Requests of at least LARGE_BLOCK_SIZE bytes are mapped from the OS
+     * rather than the heap so that they can be backed by huge pages and
+     * bound to the NUMA node the calling site thread is running on.
+     * Explicit (hugetlbfs) huge pages are tried first when the size is a
+     * multiple of the huge page size; when none are reserved the mapping
+     * falls back to normal pages, aligned and advised for transparent huge
+     * pages, and explicit huge pages are not tried again. Smaller
+     * requests (and all requests in memcheck builds or on platforms other
+     * than Linux) are plain heap allocations.
+     * The block must be freed with freeLargeBlock, passing the same size.
+     */
+    static char* allocateLargeBlock(std::size_t size);
+
+    /**
+     * Deallocate a block returned by allocateLargeBlock.
+     */
+    static void freeLargeBlock(char* block, std::size_t size);
+
+    /**
+     * Move the contents of a block returned by allocateLargeBlock to the
+     * given offset of the file fd, and map the file over the block at the
+     * same address. Its pages are then read back from the file as they are
+     * touched, and once written back can be dropped from memory by the
+     * kernel. Returns false, leaving the block as it was, when it is not a
+     * mapping of its own (small blocks, memcheck and non-Linux builds) or
+     * could not be written out.
+     */
+    static bool moveLargeBlockToFile(char* block, std::size_t size, int fd, off_t offset);
+
+    /**
+     * Bring a block moved by moveLargeBlockToFile back into anonymous
+     * memory at the same address.
+     */
+    static void moveLargeBlockToMemory(char* block, std::size_t size);
+
+    /**
+     * Ask the kernel to page out a block returned by allocateLargeBlock
+     * now rather than when memory runs short. Its pages go to swap --
+     * compressed, where zswap or zram is configured -- and are brought back
+     * as they are touched. Returns false if the block was left alone.
+     */
+    static bool pageOutLargeBlock(char* block, std::size_t size);
+
+    /**
+     * Return the number of bytes of this thread's live large blocks that
+     * are backed by (or advised for) huge pages.
+     */
+    static std::size_t getHugePageAllocationSize();
+
+    /**
+     * Return the number of bytes of this thread's live large blocks that
+     * are bound to the NUMA node the thread was running on when it
+     * allocated them.
+     */
+    static std::size_t getLocalNodeAllocationSize();
+
     /**
      * Allocate space from a page of objects of approximately the requested
      * size. There will be relatively small gaps of unused space between the
@@ -114,6 +180,19 @@ public:
      * relocating some other allocation.
      */
     static void freeRelocatable(Sized* string);
+
+    /// The use of the pool of one size class of relocatable objects.
+    struct RelocatableSizeClassStats {
+        int32_t m_allocationSize;
+        int64_t m_objectCount;
+        std::size_t m_bytesAllocated;
+    };
+
+    /**
+     * The use of each size class of relocatable objects on this thread,
+     * in no particular order. Empty in memcheck builds.
+     */
+    static std::vector<RelocatableSizeClassStats> getRelocatableStats();
 };
 }
 
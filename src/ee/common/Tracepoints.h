@@ -0,0 +1,52 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACEPOINTS_H_
+#define TRACEPOINTS_H_
+
+/*
+ * Static (USDT) tracepoints in the "voltdb" provider. When the build finds
+ * <sys/sdt.h> it defines VOLT_USDT, and each probe compiles to a single nop
+ * plus an ELF note that perf, bpftrace or SystemTap can attach to at run
+ * time, e.g.
+ *
+ *   bpftrace -e 'usdt:libvoltdb*.so:voltdb:executor__done { @[arg0] = count(); }'
+ *
+ * Without VOLT_USDT the probes compile away entirely. Probe arguments must
+ * be cheap to compute, since they are evaluated whether or not anything is
+ * attached.
+ *
+ * Probes:
+ *   latency__start(point), latency__done(point)
+ *       around every ScopedLatencySample: fragments, index lookups,
+ *       compaction, COW streaming and DR buffer pushes (see LatencyPoint)
+ *   executor__start(planNodeType, planNodeId), executor__done(planNodeType, planNodeId, tuplesOut)
+ *   undo__release(undoToken)
+ *   stream__push(uso, bytes) when an export or DR block is handed to the topend
+ */
+#ifdef VOLT_USDT
+#include <sys/sdt.h>
+#define VOLT_PROBE1(name, a1) DTRACE_PROBE1(voltdb, name, a1)
+#define VOLT_PROBE2(name, a1, a2) DTRACE_PROBE2(voltdb, name, a1, a2)
+#define VOLT_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(voltdb, name, a1, a2, a3)
+#else
+#define VOLT_PROBE1(name, a1) do {} while (0)
+#define VOLT_PROBE2(name, a1, a2) do {} while (0)
+#define VOLT_PROBE3(name, a1, a2, a3) do {} while (0)
+#endif
+
+#endif /* TRACEPOINTS_H_ */
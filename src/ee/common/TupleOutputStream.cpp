@@ -17,12 +17,185 @@
 
 #include "TupleOutputStream.h"
 #include "tabletuple.h"
+#include "TupleSchema.h"
+#include "ValuePeeker.hpp"
+#include "FatalException.hpp"
+#include "boost/date_time/gregorian/gregorian.hpp"
+#include "boost/date_time/posix_time/posix_time.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <limits>
 
 namespace voltdb {
 
+// What the Java CSV writers put in place of a NULL.
+static const char TEXT_NULL[] = "\\N";
+
+static const boost::posix_time::ptime TEXT_EPOCH(boost::gregorian::date(1970, 1, 1));
+
+// Text lengths of the fixed width types, sign included. A DECIMAL is 26
+// whole digits, a point and 12 fractional digits.
+static const std::size_t MAX_BIGINT_TEXT_LENGTH = 20;
+static const std::size_t MAX_DOUBLE_TEXT_LENGTH = 24;
+static const std::size_t MAX_DECIMAL_TEXT_LENGTH = 40;
+static const std::size_t MAX_TIMESTAMP_TEXT_LENGTH = 26;
+static const std::size_t MAX_POINT_TEXT_LENGTH = 64;
+
+/**
+ * Format a double as Java's Double.toString() does: the fewest digits that
+ * read back as the same value, plainly from 10^-3 up to 10^7 and in E
+ * notation outside that. Return the length written to text, which must
+ * hold 32 bytes.
+ */
+static int formatDouble(double value, char *text)
+{
+    if (value != value) {
+        return snprintf(text, 32, "NaN");
+    }
+    if (value == std::numeric_limits<double>::infinity()) {
+        return snprintf(text, 32, "Infinity");
+    }
+    if (value == -std::numeric_limits<double>::infinity()) {
+        return snprintf(text, 32, "-Infinity");
+    }
+    if (value == 0) {
+        return snprintf(text, 32, std::signbit(value) ? "-0.0" : "0.0");
+    }
+
+    // [-]d[.ddd]e[+-]dd with the fewest digits that round trip.
+    char scientific[32];
+    for (int precision = 0; precision < 17; precision++) {
+        snprintf(scientific, sizeof(scientific), "%.*e", precision, value);
+        if (strtod(scientific, NULL) == value) {
+            break;
+        }
+    }
+    char digits[20];
+    int digitCount = 0;
+    const char *cursor = scientific;
+    int length = 0;
+    if (*cursor == '-') {
+        text[length++] = '-';
+        cursor++;
+    }
+    for (; *cursor != 'e'; cursor++) {
+        if (*cursor != '.') {
+            digits[digitCount++] = *cursor;
+        }
+    }
+    const int exponent = atoi(cursor + 1);
+
+    if (exponent >= -3 && exponent < 7) {
+        if (exponent < 0) {
+            text[length++] = '0';
+            text[length++] = '.';
+            for (int ii = -1; ii > exponent; ii--) {
+                text[length++] = '0';
+            }
+            for (int ii = 0; ii < digitCount; ii++) {
+                text[length++] = digits[ii];
+            }
+        }
+        else {
+            for (int ii = 0; ii <= exponent; ii++) {
+                text[length++] = ii < digitCount ? digits[ii] : '0';
+            }
+            text[length++] = '.';
+            if (digitCount > exponent + 1) {
+                for (int ii = exponent + 1; ii < digitCount; ii++) {
+                    text[length++] = digits[ii];
+                }
+            }
+            else {
+                text[length++] = '0';
+            }
+        }
+        text[length] = '\0';
+        return length;
+    }
+
+    text[length++] = digits[0];
+    text[length++] = '.';
+    if (digitCount > 1) {
+        for (int ii = 1; ii < digitCount; ii++) {
+            text[length++] = digits[ii];
+        }
+    }
+    else {
+        text[length++] = '0';
+    }
+    return length + snprintf(text + length, 32 - length, "E%d", exponent);
+}
+
+bool TupleOutputStream::parseRowFormat(const std::string &name, RowFormat &format)
+{
+    if (name == "NATIVE") {
+        format = ROW_FORMAT_NATIVE;
+    }
+    else if (name == "CSV") {
+        format = ROW_FORMAT_CSV;
+    }
+    else if (name == "TSV") {
+        format = ROW_FORMAT_TSV;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+std::size_t TupleOutputStream::getMaxTextRowLength(const TupleSchema &schema)
+{
+    std::size_t bytes = 0;
+    for (int ii = 0; ii < schema.columnCount(); ii++) {
+        const TupleSchema::ColumnInfo *columnInfo = schema.getColumnInfo(ii);
+        // Two quotes and the separator or line end after the value.
+        bytes += 3;
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+            bytes += MAX_BIGINT_TEXT_LENGTH;
+            break;
+        case VALUE_TYPE_DOUBLE:
+            bytes += MAX_DOUBLE_TEXT_LENGTH;
+            break;
+        case VALUE_TYPE_DECIMAL:
+            bytes += MAX_DECIMAL_TEXT_LENGTH;
+            break;
+        case VALUE_TYPE_TIMESTAMP:
+            bytes += MAX_TIMESTAMP_TEXT_LENGTH;
+            break;
+        case VALUE_TYPE_VARCHAR: {
+            // Every byte may need an escape.
+            const std::size_t factor = columnInfo->inBytes ? 1 : MAX_BYTES_PER_UTF8_CHARACTER;
+            bytes += 2 * factor * columnInfo->length;
+            break;
+        }
+        case VALUE_TYPE_VARBINARY:
+            bytes += 2 * columnInfo->length;
+            break;
+        case VALUE_TYPE_POINT:
+            bytes += MAX_POINT_TEXT_LENGTH;
+            break;
+        case VALUE_TYPE_GEOGRAPHY:
+            // A vertex is 24 bytes serialized and fewer than 48 as text.
+            bytes += 2 * columnInfo->length + MAX_POINT_TEXT_LENGTH;
+            break;
+        default:
+            throwFatalException("No text row format for a column of type %s",
+                                getTypeName(columnInfo->getVoltType()).c_str());
+        }
+    }
+    return bytes;
+}
+
 TupleOutputStream::TupleOutputStream(void *data, std::size_t length) :
     ReferenceSerializeOutput(data, length),
+    m_rowFormat(ROW_FORMAT_NATIVE),
+    m_maxRowLength(0),
     m_rowCount(0),
     m_rowCountPosition(0),
     m_totalBytesSerialized(0)
@@ -45,7 +218,12 @@ std::size_t TupleOutputStream::startRows(int32_t partitionId)
 std::size_t TupleOutputStream::writeRow(const TableTuple &tuple)
 {
     const std::size_t startPos = position();
-    tuple.serializeTo(*this, true);
+    if (m_rowFormat == ROW_FORMAT_NATIVE) {
+        tuple.serializeTo(*this, true);
+    }
+    else {
+        writeTextRow(tuple);
+    }
     const std::size_t endPos = position();
     m_rowCount++;
     std::size_t bytesSerialized = endPos - startPos;
@@ -53,6 +231,157 @@ std::size_t TupleOutputStream::writeRow(const TableTuple &tuple)
     return bytesSerialized;
 }
 
+void TupleOutputStream::writeTextRow(const TableTuple &tuple)
+{
+    const bool quoted = m_rowFormat == ROW_FORMAT_CSV;
+    const char separator = quoted ? ',' : '\t';
+    const int columnCount = tuple.getSchema()->columnCount();
+    for (int ii = 0; ii < columnCount; ii++) {
+        if (ii != 0) {
+            writeChar(separator);
+        }
+        if (quoted) {
+            writeChar('"');
+        }
+        writeTextValue(tuple.getNValue(ii));
+        if (quoted) {
+            writeChar('"');
+        }
+    }
+    writeChar('\n');
+}
+
+void TupleOutputStream::writeTextValue(const NValue &value)
+{
+    if (value.isNull()) {
+        writeBytes(TEXT_NULL, sizeof(TEXT_NULL) - 1);
+        return;
+    }
+
+    char text[64];
+    int length = 0;
+    const ValueType type = ValuePeeker::peekValueType(value);
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+        length = snprintf(text, sizeof(text), "%d", static_cast<int>(ValuePeeker::peekTinyInt(value)));
+        break;
+    case VALUE_TYPE_SMALLINT:
+        length = snprintf(text, sizeof(text), "%d", static_cast<int>(ValuePeeker::peekSmallInt(value)));
+        break;
+    case VALUE_TYPE_INTEGER:
+        length = snprintf(text, sizeof(text), "%d", ValuePeeker::peekInteger(value));
+        break;
+    case VALUE_TYPE_BIGINT:
+        length = snprintf(text, sizeof(text), "%lld",
+                          static_cast<long long>(ValuePeeker::peekBigInt(value)));
+        break;
+    case VALUE_TYPE_DOUBLE:
+        length = formatDouble(ValuePeeker::peekDouble(value), text);
+        break;
+    case VALUE_TYPE_DECIMAL: {
+        // As BigDecimal.toString() writes a scale 12 value: with a point,
+        // unless the value has fewer than 7 digits, i.e. is below 10^-6.
+        const std::string plain = ValuePeeker::peekDecimalString(value);
+        const std::size_t point = plain.find('.');
+        const std::size_t signLength = plain[0] == '-' ? 1 : 0;
+        if (point != signLength + 1 || plain[signLength] != '0' ||
+                plain.compare(point + 1, 6, "000000") != 0) {
+            writeBytes(plain.data(), plain.size());
+            return;
+        }
+        const std::size_t first = plain.find_first_not_of('0', point + 7);
+        if (first == std::string::npos) {
+            writeBytes("0E-12", 5);
+            return;
+        }
+        if (signLength != 0) {
+            text[length++] = '-';
+        }
+        text[length++] = plain[first];
+        if (first + 1 < plain.size()) {
+            text[length++] = '.';
+            for (std::size_t ii = first + 1; ii < plain.size(); ii++) {
+                text[length++] = plain[ii];
+            }
+        }
+        const int exponent = static_cast<int>(plain.size() - first) - 1 - NValue::kMaxDecScale;
+        length += snprintf(text + length, sizeof(text) - length, "E%d", exponent);
+        break;
+    }
+    case VALUE_TYPE_TIMESTAMP: {
+        const int64_t epochMicros = ValuePeeker::peekTimestamp(value);
+        const boost::posix_time::ptime asPtime =
+            TEXT_EPOCH + boost::posix_time::microseconds(epochMicros);
+        const boost::gregorian::date asDate = asPtime.date();
+        const boost::posix_time::time_duration asTime = asPtime.time_of_day();
+        int micros = static_cast<int>(epochMicros % 1000000);
+        if (micros < 0) {
+            micros += 1000000;
+        }
+        length = snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d.%06d",
+                          static_cast<int>(asDate.year()), static_cast<int>(asDate.month()),
+                          static_cast<int>(asDate.day()), static_cast<int>(asTime.hours()),
+                          static_cast<int>(asTime.minutes()), static_cast<int>(asTime.seconds()),
+                          micros);
+        break;
+    }
+    case VALUE_TYPE_VARCHAR: {
+        int32_t objectLength;
+        const char *object = ValuePeeker::peekObject_withoutNull(value, &objectLength);
+        writeEscapedText(object, objectLength);
+        return;
+    }
+    case VALUE_TYPE_VARBINARY: {
+        static const char hexDigits[] = "0123456789ABCDEF";
+        int32_t objectLength;
+        const char *object = ValuePeeker::peekObject_withoutNull(value, &objectLength);
+        for (int32_t ii = 0; ii < objectLength; ii++) {
+            const unsigned char byte = static_cast<unsigned char>(object[ii]);
+            writeChar(hexDigits[byte >> 4]);
+            writeChar(hexDigits[byte & 0xF]);
+        }
+        return;
+    }
+    case VALUE_TYPE_POINT: {
+        const std::string wkt = ValuePeeker::peekGeographyPointValue(value).toWKT();
+        writeBytes(wkt.data(), wkt.size());
+        return;
+    }
+    case VALUE_TYPE_GEOGRAPHY: {
+        const std::string wkt = ValuePeeker::peekGeographyValue(value).toWKT();
+        writeBytes(wkt.data(), wkt.size());
+        return;
+    }
+    default:
+        throwFatalException("No text row format for a value of type %s", getTypeName(type).c_str());
+    }
+    writeBytes(text, length);
+}
+
+void TupleOutputStream::writeEscapedText(const char *text, std::size_t length)
+{
+    const bool quoted = m_rowFormat == ROW_FORMAT_CSV;
+    // Write the runs between the characters that need an escape in one go.
+    std::size_t runStart = 0;
+    for (std::size_t ii = 0; ii < length; ii++) {
+        const char ch = text[ii];
+        const bool escaped = quoted ? ch == '"' : (ch == '\\' || ch == '\r' || ch == '\n');
+        if (escaped) {
+            writeBytes(text + runStart, ii - runStart);
+            writeChar(quoted ? '"' : '\\');
+            runStart = ii;
+        }
+    }
+    writeBytes(text + runStart, length - runStart);
+}
+
+void TupleOutputStream::writeSerializedRow(const char *row, std::size_t length)
+{
+    writeBytes(row, length);
+    m_rowCount++;
+    m_totalBytesSerialized += length;
+}
+
 bool TupleOutputStream::canFit(std::size_t nbytes) const
 {
     return (remaining() >= nbytes + sizeof(int32_t));
@@ -19,11 +19,14 @@
 #define TUPLEOUTPUTSTREAM_H_
 
 #include <cstddef>
+#include <string>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "serializeio.h"
 
 namespace voltdb {
+class NValue;
 class TableTuple;
+class TupleSchema;
 class PersistentTable;
 
 /**
@@ -34,6 +37,31 @@ class TupleOutputStream : public ReferenceSerializeOutput {
 
 public:
 
+    /**
+     * How the rows of a stream are written. The text formats write one
+     * line per row of the visible columns, as CSV snapshots do, so the
+     * rows need no conversion after they leave the EE.
+     */
+    enum RowFormat {
+        // The tuple's native serialization, hidden columns included.
+        ROW_FORMAT_NATIVE,
+        // Comma separated values, each quoted, with quotes doubled.
+        ROW_FORMAT_CSV,
+        // Tab separated values, with backslashes, CRs and LFs escaped by a backslash.
+        ROW_FORMAT_TSV
+    };
+
+    /**
+     * Parse the name a stream predicate gives its row format: "NATIVE",
+     * "CSV" or "TSV". Return false if the name is unknown.
+     */
+    static bool parseRowFormat(const std::string &name, RowFormat &format);
+
+    /**
+     * The most bytes a text format can take for a row of the schema.
+     */
+    static std::size_t getMaxTextRowLength(const TupleSchema &schema);
+
     /**
      * Constructor.
      */
@@ -54,6 +82,11 @@ public:
      */
     std::size_t writeRow(const TableTuple &tuple);
 
+    /**
+     * Write a row that was already serialized by another stream.
+     */
+    void writeSerializedRow(const char *row, std::size_t length);
+
     /**
      * Return true if nbytes can fit in the buffer's remaining space.
      */
@@ -64,6 +97,22 @@ public:
      */
     void endRows();
 
+    /**
+     * Set how writeRow() writes rows and the most bytes one can take.
+     */
+    void setRowFormat(RowFormat format, std::size_t maxRowLength) {
+        m_rowFormat = format;
+        m_maxRowLength = maxRowLength;
+    }
+
+    RowFormat getRowFormat() const {
+        return m_rowFormat;
+    }
+
+    std::size_t getMaxRowLength() const {
+        return m_maxRowLength;
+    }
+
     /**
      * Access the total bytes serialized counter.
      */
@@ -80,6 +129,15 @@ public:
 
 private:
 
+    void writeTextRow(const TableTuple &tuple);
+
+    void writeTextValue(const NValue &value);
+
+    /** Write text, escaped as the row format requires. */
+    void writeEscapedText(const char *text, std::size_t length);
+
+    RowFormat   m_rowFormat;
+    std::size_t m_maxRowLength;
     int32_t     m_rowCount;
     std::size_t m_rowCountPosition;
     /** Keep track of bytes written for throttling to yield control. */
@@ -18,6 +18,7 @@
 #include "TupleOutputStream.h"
 #include "TupleOutputStreamProcessor.h"
 #include "tabletuple.h"
+#include "storage/persistenttable.h"
 #include <limits>
 
 namespace voltdb {
@@ -65,7 +66,8 @@ void TupleOutputStreamProcessor::open(PersistentTable &table,
                                       std::size_t maxTupleLength,
                                       int32_t partitionId,
                                       StreamPredicateList &predicates,
-                                      std::vector<bool> &predicateDeletes)
+                                      std::vector<bool> &predicateDeletes,
+                                      const std::vector<TupleOutputStream::RowFormat> &rowFormats)
 {
     m_table = &table;
     m_maxTupleLength = maxTupleLength;
@@ -74,10 +76,24 @@ void TupleOutputStreamProcessor::open(PersistentTable &table,
     if (havePredicates && predicates.size() != size()) {
         throwFatalException("serializeMore() expects either no predicates or one per output stream.");
     }
+    if (!rowFormats.empty() && rowFormats.size() != size()) {
+        throwFatalException("serializeMore() expects either no row formats or one per output stream.");
+    }
     m_predicates = &predicates;
     m_predicateDeletes = &predicateDeletes;
-    for (TupleOutputStreamProcessor::iterator iter = begin(); iter != end(); ++iter) {
-        iter->startRows(partitionId);
+    std::size_t maxTextRowLength = 0;
+    for (std::size_t ii = 0; ii < size(); ii++) {
+        TupleOutputStream &stream = at(ii);
+        if (rowFormats.empty() || rowFormats[ii] == TupleOutputStream::ROW_FORMAT_NATIVE) {
+            stream.setRowFormat(TupleOutputStream::ROW_FORMAT_NATIVE, maxTupleLength);
+        }
+        else {
+            if (maxTextRowLength == 0) {
+                maxTextRowLength = TupleOutputStream::getMaxTextRowLength(*table.schema());
+            }
+            stream.setRowFormat(rowFormats[ii], maxTextRowLength);
+        }
+        stream.startRows(partitionId);
     }
 }
 
@@ -112,6 +128,11 @@ bool TupleOutputStreamProcessor::writeRow(TableTuple &tuple, bool *deleteRow)
     }
 
     bool yield = false;
+    // The row as written by the first stream of each format that accepted
+    // it; the other streams of that format copy those bytes rather than
+    // write the tuple again.
+    const char *serializedRows[TupleOutputStream::ROW_FORMAT_TSV + 1] = { NULL, NULL, NULL };
+    std::size_t serializedLengths[TupleOutputStream::ROW_FORMAT_TSV + 1] = { 0, 0, 0 };
     for (TupleOutputStreamProcessor::iterator iter = begin(); iter != end(); ++iter) {
         // Get approval from corresponding output stream predicate, if provided.
         bool accepted = true;
@@ -131,17 +152,25 @@ bool TupleOutputStreamProcessor::writeRow(TableTuple &tuple, bool *deleteRow)
         }
 
         if (accepted) {
-            if (!iter->canFit(m_maxTupleLength)) {
+            if (!iter->canFit(iter->getMaxRowLength())) {
                 throwFatalException(
                     "TupleOutputStreamProcessor::writeRow() failed because buffer has no space.");
             }
-            iter->writeRow(tuple);
+            const TupleOutputStream::RowFormat rowFormat = iter->getRowFormat();
+            if (serializedRows[rowFormat] == NULL) {
+                const std::size_t startPos = iter->position();
+                serializedLengths[rowFormat] = iter->writeRow(tuple);
+                serializedRows[rowFormat] = iter->data() + startPos;
+            }
+            else {
+                iter->writeSerializedRow(serializedRows[rowFormat], serializedLengths[rowFormat]);
+            }
 
             // Check if we'll need to yield after handling this row.
             if (!yield) {
                 // Yield when the buffer is not capable of handling another tuple
                 // or when the total bytes serialized threshold is exceeded.
-                yield = (   !iter->canFit(m_maxTupleLength)
+                yield = (   !iter->canFit(iter->getMaxRowLength())
                          || iter->getTotalBytesSerialized() > m_bytesSerializedThreshold);
             }
         }
@@ -21,6 +21,7 @@
 #include <cstddef>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "StreamPredicateList.h"
+#include "TupleOutputStream.h"
 
 namespace voltdb {
 class TableTuple;
@@ -45,12 +46,16 @@ public:
     /** Convenience method to create and add a new TupleOutputStream. */
     TupleOutputStream &add(void *data, std::size_t length);
 
-    /** Start serializing. */
+    /**
+     * Start serializing. The row formats, if any, are one per output
+     * stream, as the predicates are.
+     */
     void open(PersistentTable &table,
               std::size_t maxTupleLength,
               int32_t partitionId,
               StreamPredicateList &predicates,
-              std::vector<bool> &predicateDeletes);
+              std::vector<bool> &predicateDeletes,
+              const std::vector<TupleOutputStream::RowFormat> &rowFormats);
 
     /** Stop serializing. */
     void close();
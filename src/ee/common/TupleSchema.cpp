@@ -19,6 +19,7 @@
 #include <cstdio>
 #include "common/TupleSchema.h"
 #include "common/NValue.hpp"
+#include "common/MiscUtil.h"
 
 namespace voltdb {
 
@@ -40,6 +41,22 @@ static inline int memSizeForTupleSchema(uint16_t columnCount,
                                                                 columnCount + 1)));
 }
 
+template <typename T>
+static void hashCombineStored(const TupleSchema::ColumnInfo *columnInfo, const char *storage,
+                              std::size_t &seed) {
+    boost::hash_combine(seed, *reinterpret_cast<const T*>(storage));
+}
+
+static void hashCombineStoredDouble(const TupleSchema::ColumnInfo *columnInfo, const char *storage,
+                                    std::size_t &seed) {
+    MiscUtil::hashCombineFloatingPoint(seed, *reinterpret_cast<const double*>(storage));
+}
+
+static void hashCombineStoredValue(const TupleSchema::ColumnInfo *columnInfo, const char *storage,
+                                   std::size_t &seed) {
+    NValue::initFromTupleStorage(storage, columnInfo->getVoltType(), columnInfo->inlined).hashCombine(seed);
+}
+
 static inline bool isInlineable(ValueType vt, int32_t length, bool inBytes) {
     switch (vt) {
     case VALUE_TYPE_VARCHAR:
@@ -142,6 +159,22 @@ TupleSchema* TupleSchema::createTupleSchema(const std::vector<ValueType> columnT
                                   inBytes);
     }
 
+    retval->m_fixedWidthSerialization = columnCount > 0;
+    for (uint16_t ii = 0; ii < columnCount; ii++) {
+        switch (columnTypes[ii]) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+        case VALUE_TYPE_DOUBLE:
+        case VALUE_TYPE_DECIMAL:
+            break;
+        default:
+            retval->m_fixedWidthSerialization = false;
+        }
+    }
+
     return retval;
 }
 
@@ -246,6 +279,27 @@ void TupleSchema::setColumnMetaData(uint16_t index, ValueType type, const int32_
     columnInfo->length = length;
     columnInfo->inBytes = inBytes;
 
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+        columnInfo->hashCombine = hashCombineStored<int8_t>;
+        break;
+    case VALUE_TYPE_SMALLINT:
+        columnInfo->hashCombine = hashCombineStored<int16_t>;
+        break;
+    case VALUE_TYPE_INTEGER:
+        columnInfo->hashCombine = hashCombineStored<int32_t>;
+        break;
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+        columnInfo->hashCombine = hashCombineStored<int64_t>;
+        break;
+    case VALUE_TYPE_DOUBLE:
+        columnInfo->hashCombine = hashCombineStoredDouble;
+        break;
+    default:
+        columnInfo->hashCombine = hashCombineStoredValue;
+    }
+
     if (isVariableLengthType(type)) {
         if (length == 0) {
             throwFatalLogicErrorStreamed("Zero length for object type " << valueToString((ValueType)type));
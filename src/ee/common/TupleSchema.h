@@ -54,6 +54,11 @@ public:
 
         bool inBytes;
 
+        // Combines the stored value into a hash seed as NValue::hashCombine
+        // would. Set with the type, so fixed-width numbers are read straight
+        // from the tuple instead of through an NValue.
+        void (*hashCombine)(const ColumnInfo *columnInfo, const char *storage, std::size_t &seed);
+
         const ValueType getVoltType() const {
             return static_cast<ValueType>(type);
         }
@@ -197,6 +202,17 @@ public:
      * In debug builds, asserts if there are no hidden columns. */
     size_t lengthOfAllHiddenColumns() const;
 
+    /** Returns the length of all the visible columns in the tuple. */
+    size_t lengthOfAllVisibleColumns() const;
+
+    /** Returns true if every visible column is an inlined fixed-width
+     *  number, whose serialized form is just its storage in network
+     *  byte order. Tuples of such a schema are serialized without going
+     *  through NValues. */
+    bool hasFixedWidthSerialization() const {
+        return m_fixedWidthSerialization;
+    }
+
 private:
 
     uint16_t totalColumnCount() const;
@@ -244,6 +260,9 @@ private:
     uint16_t m_hiddenColumnCount;
     static const uint16_t m_uninlinedObjectHiddenColumnCount = 0;
 
+    // set once all the columns are, see hasFixedWidthSerialization()
+    bool m_fixedWidthSerialization;
+
     /*
      * Data storage for:
      *   - An array of int16_t, containing the 0-based ordinal position
@@ -298,6 +317,11 @@ inline size_t TupleSchema::lengthOfAllHiddenColumns() const {
     return tupleLength() - offsetOfHiddenColumns();
 }
 
+inline size_t TupleSchema::lengthOfAllVisibleColumns() const {
+    // the first hidden column, or the terminating ColumnInfo
+    return getColumnInfoPrivate(columnCount())->offset;
+}
+
 
 inline const TupleSchema::ColumnInfo* TupleSchema::getColumnInfoPrivate(int columnIndex) const {
     return &reinterpret_cast<const ColumnInfo*>(m_data + (sizeof(uint16_t) * m_uninlinedObjectColumnCount))[columnIndex];
@@ -25,6 +25,7 @@
 #include <cassert>
 
 #include "common/Pool.hpp"
+#include "common/Tracepoints.h"
 #include "common/UndoQuantum.h"
 
 namespace voltdb
@@ -107,6 +108,7 @@ namespace voltdb
                 m_undoQuantums.pop_back();
                 // Destroy the quantum, but retain its pool for reuse.
                 Pool *pool = undoQuantum->undo();
+                notePeakQuantumSize(pool);
                 pool->purge();
                 m_undoDataPools.push_back(pool);
 
@@ -126,6 +128,7 @@ namespace voltdb
             //          << " lastUndo: " << m_lastUndoToken
             //          << " lastRelease: " << m_lastReleaseToken << std::endl;
             assert(m_lastReleaseToken < undoToken);
+            VOLT_PROBE1(undo__release, undoToken);
             m_lastReleaseToken = undoToken;
             while (m_undoQuantums.size() > 0) {
                 UndoQuantum *undoQuantum = m_undoQuantums.front();
@@ -137,6 +140,7 @@ namespace voltdb
                 m_undoQuantums.pop_front();
                 // Destroy the quantum, but retain its pool for reuse.
                 Pool *pool = undoQuantum->release();
+                notePeakQuantumSize(pool);
                 pool->purge();
                 m_undoDataPools.push_back(pool);
                 if(undoQuantumToken == undoToken) {
@@ -145,6 +149,12 @@ namespace voltdb
             }
         }
 
+        /** True when every undo quantum has been released or undone */
+        bool isEmpty() const
+        {
+            return m_undoQuantums.empty();
+        }
+
         int64_t getSize() const
         {
             int64_t total = 0;
@@ -159,7 +169,22 @@ namespace voltdb
             return total;
         }
 
+        /**
+         * The most memory the data pool of any one undo quantum grew to,
+         * since the log was made or the peak was last reset.
+         */
+        int64_t getPeakQuantumSize() const { return m_peakQuantumSize; }
+
+        void resetPeakQuantumSize() { m_peakQuantumSize = 0; }
+
     private:
+        inline void notePeakQuantumSize(Pool *pool) {
+            int64_t size = pool->getAllocatedMemory();
+            if (size > m_peakQuantumSize) {
+                m_peakQuantumSize = size;
+            }
+        }
+
         // These two values serve no real purpose except to provide
         // the capability to assert various properties about the undo tokens
         // handed to the UndoLog.  Currently, this makes the following
@@ -185,6 +210,8 @@ namespace voltdb
         // any larger value might exist (gaps are possible)
         int64_t m_lastReleaseToken;
 
+        int64_t m_peakQuantumSize;
+
         std::vector<Pool*> m_undoDataPools;
         std::deque<UndoQuantum*> m_undoQuantums;
     };
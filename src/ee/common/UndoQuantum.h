@@ -47,13 +47,26 @@ protected:
     void operator delete(void*) { /* every-day deallocator does nothing -- lets the pool cope */ }
 
     inline UndoQuantum(int64_t undoToken, Pool *dataPool)
-        : m_undoToken(undoToken), m_numInterests(0), m_interestsCapacity(0), m_interests(NULL), m_dataPool(dataPool) {}
+        : m_undoToken(undoToken), m_firstActions(NULL), m_lastActions(NULL), m_lastActionCount(0),
+          m_numInterests(0), m_interestsCapacity(0), m_interests(NULL), m_dataPool(dataPool) {}
     inline virtual ~UndoQuantum() {}
 
 public:
     virtual inline void registerUndoAction(UndoAction *undoAction, UndoQuantumReleaseInterest *interest = NULL) {
         assert(undoAction);
-        m_undoActions.push_back(undoAction);
+        if (m_lastActions == NULL || m_lastActionCount == ActionBlock::CAPACITY) {
+            ActionBlock *block = reinterpret_cast<ActionBlock*>(m_dataPool->allocate(sizeof(ActionBlock)));
+            block->m_prev = m_lastActions;
+            block->m_next = NULL;
+            if (m_lastActions == NULL) {
+                m_firstActions = block;
+            } else {
+                m_lastActions->m_next = block;
+            }
+            m_lastActions = block;
+            m_lastActionCount = 0;
+        }
+        m_lastActions->m_actions[m_lastActionCount++] = undoAction;
 
         if (interest != NULL) {
             if (m_interests == NULL) {
@@ -87,11 +100,13 @@ protected:
      * but their no-op delete operator leaves them to be purged in one go with the data pool.
      */
     inline Pool* undo() {
-        for (std::vector<UndoAction*>::reverse_iterator i = m_undoActions.rbegin();
-             i != m_undoActions.rend(); ++i) {
-            UndoAction* goner = *i;
-            goner->undo();
-            delete goner;
+        for (ActionBlock *block = m_lastActions; block != NULL; block = block->m_prev) {
+            uint32_t count = (block == m_lastActions) ? m_lastActionCount : ActionBlock::CAPACITY;
+            while (count > 0) {
+                UndoAction* goner = block->m_actions[--count];
+                goner->undo();
+                delete goner;
+            }
         }
         Pool * result = m_dataPool;
         delete this;
@@ -104,7 +119,7 @@ protected:
      * UndoQuantum so they will release any resources they still hold.
      * "delete" here only really calls their virtual destructors (important!)
      * but their no-op delete operator leaves them to be purged in one go with the data pool.
-     * Also call own destructor to ensure that the vector is released.
+     * Also call own destructor, for the sake of any subclass.
      *
      * The order of releasing should be FIFO order, which is the reverse of what
      * undo does. Think about the case where you insert and delete a bunch of
@@ -112,11 +127,13 @@ protected:
      * table before all the inserts and deletes are released.
      */
     inline Pool* release() {
-        for (std::vector<UndoAction*>::iterator i = m_undoActions.begin();
-             i != m_undoActions.end(); ++i) {
-            UndoAction* goner = *i;
-            goner->release();
-            delete goner;
+        for (ActionBlock *block = m_firstActions; block != NULL; block = block->m_next) {
+            uint32_t count = (block == m_lastActions) ? m_lastActionCount : ActionBlock::CAPACITY;
+            for (uint32_t ii = 0; ii < count; ii++) {
+                UndoAction* goner = block->m_actions[ii];
+                goner->release();
+                delete goner;
+            }
         }
         if (m_interests != NULL) {
             for (int ii = 0; ii < m_numInterests; ii++) {
@@ -149,8 +166,25 @@ public:
     void* allocateAction(size_t sz) { return m_dataPool->allocate(sz); }
 
 private:
+    /*
+     * The undo actions are listed in blocks allocated in the data pool, so
+     * the list goes away with the rest of the quantum's data when the pool
+     * is purged, and registering an action never copies the list.
+     */
+    struct ActionBlock {
+        // Two links and the actions fill 512 bytes.
+        static const uint32_t CAPACITY = 62;
+
+        ActionBlock *m_prev;
+        ActionBlock *m_next;
+        UndoAction *m_actions[CAPACITY];
+    };
+
     const int64_t m_undoToken;
-    std::vector<UndoAction*> m_undoActions;
+    ActionBlock *m_firstActions;
+    ActionBlock *m_lastActions;
+    // The actions in the last block; the others are full.
+    uint32_t m_lastActionCount;
     uint32_t m_numInterests;
     uint32_t m_interestsCapacity;
     UndoQuantumReleaseInterest **m_interests;
@@ -119,6 +119,13 @@ public:
         return NValue::getNullBinaryValue();
     }
 
+    /// Returns an NValue of type Varbinary that points to an uninitialized temp buffer of the given size
+    static inline NValue getUninitializedTempBinaryValue(int32_t length) {
+        NValue retval(VALUE_TYPE_VARBINARY);
+        retval.allocateValueStorage(length, NValue::getTempStringPool());
+        return retval;
+    }
+
     /// Returns an NValue of type Geography that points to an uninitialized temp buffer of the given size
     static inline NValue getUninitializedTempGeographyValue(int32_t length) {
         NValue retval(VALUE_TYPE_GEOGRAPHY);
@@ -17,6 +17,7 @@
 #include "common/executorcontext.hpp"
 
 #include "common/debuglog.h"
+#include "common/JsonDocumentCache.h"
 #include "executors/abstractexecutor.h"
 #include "storage/AbstractDRTupleStream.h"
 #include "storage/DRTupleStream.h"
@@ -92,6 +93,7 @@ ExecutorContext::ExecutorContext(int64_t siteId,
     m_drStream(drStream),
     m_drReplicatedStream(drReplicatedStream),
     m_engine(engine),
+    m_executionGeneration(0),
     m_txnId(0),
     m_spHandle(0),
     m_lastCommittedSpHandle(0),
@@ -126,6 +128,15 @@ ExecutorContext* ExecutorContext::getExecutorContext() {
     return static_cast<ExecutorContext*>(pthread_getspecific(static_key));
 }
 
+JsonDocumentCache& ExecutorContext::getJsonDocumentCache() {
+    ExecutorContext* singleton = getExecutorContext();
+    assert(singleton != NULL);
+    if (singleton->m_jsonDocumentCache.get() == NULL) {
+        singleton->m_jsonDocumentCache.reset(new JsonDocumentCache());
+    }
+    return *singleton->m_jsonDocumentCache;
+}
+
 UniqueTempTableResult ExecutorContext::executeExecutors(int subqueryId)
 {
     const std::vector<AbstractExecutor*>& executorList = getExecutors(subqueryId);
@@ -142,6 +153,9 @@ UniqueTempTableResult ExecutorContext::executeExecutors(const std::vector<Abstra
     size_t ttl = executorList.size();
     int ctr = 0;
 
+    // The parameters may have been set just now for this run.
+    ++m_executionGeneration;
+
     try {
         BOOST_FOREACH (AbstractExecutor *executor, executorList) {
             assert(executor);
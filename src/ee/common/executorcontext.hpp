@@ -24,6 +24,9 @@
 #include "common/subquerycontext.h"
 #include "common/ValuePeeker.hpp"
 #include "common/UniqueId.hpp"
+#include "stats/LatencyStats.h"
+
+#include "boost/scoped_ptr.hpp"
 
 #include <vector>
 #include <map>
@@ -36,6 +39,7 @@ extern const int64_t VOLT_EPOCH_IN_MILLIS;
 
 class AbstractExecutor;
 class AbstractDRTupleStream;
+class JsonDocumentCache;
 class VoltDBEngine;
 
 class TempTable;
@@ -96,6 +100,7 @@ class ExecutorContext {
         m_uniqueId = uniqueId;
         m_currentTxnTimestamp = (m_uniqueId >> 23) + VOLT_EPOCH_IN_MILLIS;
         m_currentDRTimestamp = createDRTimestampHiddenValue(static_cast<int64_t>(m_drClusterId), m_uniqueId);
+        ++m_executionGeneration;
     }
 
     // data available via tick()
@@ -148,6 +153,17 @@ class ExecutorContext {
         return m_staticParams;
     }
 
+    /**
+     * Changes whenever the parameters or the transaction may have: with
+     * each new transaction and each run of a fragment or subquery. A value
+     * computed from nothing else holds while this stays the same. Returns
+     * -1, which never matches, when no context is installed.
+     */
+    static int64_t currentExecutionGeneration() {
+        ExecutorContext* singleton = getExecutorContext();
+        return singleton == NULL ? -1 : singleton->m_executionGeneration;
+    }
+
     static VoltDBEngine* getEngine() {
         return getExecutorContext()->m_engine;
     }
@@ -290,6 +306,14 @@ class ExecutorContext {
         return singleton->m_tempStringPool;
     }
 
+    /** The site's recently parsed JSON documents, for the JSON functions. */
+    static JsonDocumentCache& getJsonDocumentCache();
+
+    /** The site's sampled latencies, for the latency statistics. */
+    LatencyStats& latencyStats() {
+        return m_latencyStats;
+    }
+
     bool allOutputTempTablesAreEmpty() const;
 
     void checkTransactionForDR();
@@ -309,6 +333,10 @@ class ExecutorContext {
     AbstractDRTupleStream *m_drStream;
     AbstractDRTupleStream *m_drReplicatedStream;
     VoltDBEngine *m_engine;
+    // Made on first use.
+    boost::scoped_ptr<JsonDocumentCache> m_jsonDocumentCache;
+    LatencyStats m_latencyStats;
+    int64_t m_executionGeneration;
     int64_t m_txnId;
     int64_t m_spHandle;
     int64_t m_uniqueId;
@@ -17,6 +17,8 @@
 #include "common/serializeio.h"
 #include "common/executorcontext.hpp"
 
+#include <algorithm>
+
 using namespace voltdb;
 
 void FallbackSerializeOutput::expand(size_t minimum_desired) {
@@ -24,7 +26,7 @@ void FallbackSerializeOutput::expand(size_t minimum_desired) {
      * Leave some space for message headers and such, almost 50 megabytes
      */
     size_t maxAllocationSize = ((1024 * 1024 *50) - (1024 * 32));
-    if (fallbackBuffer_ != NULL || minimum_desired > maxAllocationSize) {
+    if (minimum_desired > maxAllocationSize) {
         if (fallbackBuffer_ != NULL) {
             char *temp = fallbackBuffer_;
             fallbackBuffer_ = NULL;
@@ -34,11 +36,21 @@ void FallbackSerializeOutput::expand(size_t minimum_desired) {
             "Output from SQL stmt overflowed output/network buffer of 50mb (-32k for message headers). "
             "Try a \"limit\" clause or a stronger predicate.");
     }
-    fallbackBuffer_ = new char[maxAllocationSize];
-    ::memcpy(fallbackBuffer_, data(), position_);
+    /*
+     * Grow by doubling rather than going straight to the limit, so a
+     * result a little larger than the regular buffer costs about twice
+     * its size and not 50 megabytes. The topend is told of each new
+     * buffer, as the results it reads are in the last one.
+     */
+    size_t capacity = std::max(capacity_ * 2, minimum_desired);
+    capacity = std::min(capacity, maxAllocationSize);
+    char *buffer = new char[capacity];
+    ::memcpy(buffer, data(), position_);
+    delete []fallbackBuffer_;
+    fallbackBuffer_ = buffer;
     setPosition(position_);
-    initialize(fallbackBuffer_, maxAllocationSize);
-    ExecutorContext::getExecutorContext()->getTopend()->fallbackToEEAllocatedBuffer(fallbackBuffer_, maxAllocationSize);
+    initialize(fallbackBuffer_, capacity);
+    ExecutorContext::getExecutorContext()->getTopend()->fallbackToEEAllocatedBuffer(fallbackBuffer_, capacity);
 }
 
 template<voltdb::Endianess E>
@@ -392,6 +392,15 @@ public:
         return offset;
     }
 
+    /** Reserves length bytes of space for writing. Returns a pointer to
+    the bytes, which must be filled in before anything else is written. */
+    char* reserveRawBytes(size_t length) {
+        assureExpand(length);
+        char* result = buffer_ + position_;
+        position_ += length;
+        return result;
+    }
+
     /** Copies length bytes from value to this buffer, starting at
     offset. Offset should have been obtained from reserveBytes. This
     does not affect the current write position.  * @return offset +
@@ -527,8 +536,9 @@ protected:
 };
 
 /*
- * A serialize output class that falls back to allocating a 50 meg buffer
- * if the regular allocation runs out of space. The topend is notified when this occurs.
+ * A serialize output class that falls back to allocating its own buffer
+ * if the regular allocation runs out of space, doubling it as needed up
+ * to 50 megs. The topend is notified of each buffer it moves to.
  */
 class FallbackSerializeOutput : public ReferenceSerializeOutput {
 public:
@@ -552,7 +562,7 @@ public:
         delete []fallbackBuffer_;
     }
 
-    /** Expand once to a fallback size, and if that doesn't work abort */
+    /** Expand to a larger fallback buffer, and abort past the 50 meg limit */
     void expand(size_t minimum_desired);
 private:
     char *fallbackBuffer_;
@@ -20,6 +20,8 @@
 
 #include <vector>
 
+#include <boost/unordered_map.hpp>
+
 #include "common/NValue.hpp"
 
 namespace voltdb {
@@ -36,6 +38,12 @@ namespace voltdb {
 *    could get executed once per unique value.
 * The subquery context is registered with the global executor context as candidates for
 * post-fragment cleanup, allowing results to be retained between invocations.
+*
+* An EXISTS (or an IN rewritten as one) over a correlated subquery only needs to know
+* whether the subquery produced a row, so that outcome is also remembered for every
+* set of correlation values seen, not just the last one. Outer rows that repeat a
+* prior set of values then skip the subquery, which makes the filter behave like a
+* hash semi-join (or, under NOT, anti-join) on the correlated columns.
 */
 struct SubqueryContext {
     SubqueryContext(std::vector<NValue> lastParams)
@@ -46,6 +54,7 @@ struct SubqueryContext {
     SubqueryContext(const SubqueryContext& other)
       : m_hasValidResult(other.m_hasValidResult)
       , m_lastParams(other.m_lastParams)
+      , m_existsByParams(other.m_existsByParams)
     {
         if (m_hasValidResult) {
             m_lastResult = other.m_lastResult;
@@ -65,12 +74,65 @@ struct SubqueryContext {
 
     std::vector<NValue>& accessLastParams() { return m_lastParams; }
 
+    /** The remembered EXISTS outcome for these correlation values, or NULL. */
+    const bool* findExists(const std::vector<NValue>& params) const
+    {
+        ExistsByParams::const_iterator it = m_existsByParams.find(params);
+        return it == m_existsByParams.end() ? NULL : &it->second;
+    }
+
+    /**
+     * Remember an EXISTS outcome. The values must be copies that outlive
+     * the outer tuple. Past MAX_REMEMBERED_EXISTS sets of values, later
+     * ones are simply not remembered.
+     */
+    void rememberExists(const std::vector<NValue>& params, bool exists)
+    {
+        if (m_existsByParams.size() < MAX_REMEMBERED_EXISTS) {
+            m_existsByParams[params] = exists;
+        }
+    }
+
+    /** The outcomes no longer hold once the non-correlated parameters change. */
+    void forgetExists() { m_existsByParams.clear(); }
+
 private:
+    static const size_t MAX_REMEMBERED_EXISTS = 65536;
+
+    struct ParamsHasher : std::unary_function<std::vector<NValue>, std::size_t>
+    {
+        std::size_t operator()(const std::vector<NValue>& params) const
+        {
+            std::size_t seed = 0;
+            for (size_t i = 0; i < params.size(); ++i) {
+                params[i].hashCombine(seed);
+            }
+            return seed;
+        }
+    };
+
+    struct ParamsEqualityChecker
+    {
+        bool operator()(const std::vector<NValue>& lhs, const std::vector<NValue>& rhs) const
+        {
+            for (size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i].compare(rhs[i]) != VALUE_COMPARE_EQUAL) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    typedef boost::unordered_map<std::vector<NValue>, bool,
+                                 ParamsHasher, ParamsEqualityChecker> ExistsByParams;
+
     bool m_hasValidResult;
     NValue m_lastResult;
     // The parameter values that were used to obtain the last result in the ascending
     // order of the parameter indexes
     std::vector<NValue> m_lastParams;
+    ExistsByParams m_existsByParams;
 };
 
 }
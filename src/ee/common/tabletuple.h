@@ -53,6 +53,8 @@
 #include "common/ValuePeeker.hpp"
 #include "common/FatalException.hpp"
 #include "common/ExportSerializeIo.h"
+#include "common/StringDictionary.h"
+#include "common/StringRef.h"
 
 #include <cassert>
 #include <ostream>
@@ -165,6 +167,14 @@ public:
         return bytes;
     }
 
+    size_t maxExportSerializationSize(const std::vector<int> &columns) const {
+        size_t bytes = 0;
+        for (size_t i = 0; i < columns.size(); i++) {
+            bytes += maxExportSerializedColumnSize(columns[i]);
+        }
+        return bytes;
+    }
+
     size_t maxDRSerializationSize() const {
         size_t bytes = maxExportSerializationSize();
 
@@ -397,11 +407,19 @@ public:
     }
 
     /** Copy values from one tuple into another (uses memcpy) */
-    void copyForPersistentInsert(const TableTuple &source, Pool *pool = NULL) const;
+    // The optional dictionaries, indexed by uninlined object column,
+    // supply shared copies of uninlined values in place of new allocations.
+    // A NULL entry leaves that column's values unshared.
+    void copyForPersistentInsert(const TableTuple &source, Pool *pool = NULL,
+                                 StringDictionary* const* dictionaries = NULL) const;
     // The vector "output" arguments detail the non-inline object memory management
     // required of the upcoming release or undo.
     void copyForPersistentUpdate(const TableTuple &source,
-                                 std::vector<char*> &oldObjects, std::vector<char*> &newObjects);
+                                 std::vector<char*> &oldObjects, std::vector<char*> &newObjects,
+                                 StringDictionary* const* dictionaries = NULL);
+    // Replace this tuple's own persistent copies of uninlined values with
+    // the dictionaries' shared copies where possible, freeing the former.
+    void shareObjectColumns(StringDictionary* const* dictionaries) const;
     void copy(const TableTuple &source);
 
     /** this does set NULL in addition to clear string count.*/
@@ -413,12 +431,28 @@ public:
     int compare(const TableTuple &other) const;
 
     void deserializeFrom(voltdb::SerializeInputBE &tupleIn, Pool *stringPool);
+    // The visible columns of a schema with fixed width serialization, from
+    // just past the row's length prefix. Uses no pools, so any thread may
+    // decode into tuple storage it alone is writing.
+    void deserializeFixedWidthFrom(const char* src);
     void deserializeFromDR(voltdb::SerializeInputLE &tupleIn, Pool *stringPool);
     void serializeTo(voltdb::SerializeOutput& output, bool includeHiddenColumns = false) const;
     void serializeToExport(voltdb::ExportSerializeOutput &io,
                           int colOffset, uint8_t *nullArray);
+    // Only the given columns, in the order given, with their null bits from
+    // colOffset on in the order given.
+    void serializeColumnsToExport(voltdb::ExportSerializeOutput &io, int colOffset,
+                                  const std::vector<int> &columns, uint8_t *nullArray) const;
     void serializeToDR(voltdb::ExportSerializeOutput &io,
                        int colOffset, uint8_t *nullArray);
+    // A DR row of only the given columns, in the order given, with the null
+    // array over their positions in that list, optionally followed by the
+    // hidden columns.
+    void serializeColumnsToDR(voltdb::ExportSerializeOutput &io, const std::vector<int> &columns,
+                              bool includeHiddenColumns, uint8_t *nullArray) const;
+    void deserializeColumnsFromDR(voltdb::SerializeInputLE &tupleIn, Pool *dataPool,
+                                  const std::vector<int> &columns, bool includeHiddenColumns);
+    size_t maxDRSerializationSize(const std::vector<int> &columns, bool includeHiddenColumns) const;
 
     void freeObjectColumns() const;
     size_t hashCode(size_t seed) const;
@@ -483,6 +517,8 @@ private:
         return &m_data[TUPLE_HEADER_SIZE + colInfo->offset];
     }
 
+    bool setSharedObject(const int idx, const TableTuple &source, StringDictionary* dictionary) const;
+
     inline void serializeColumnToExport(ExportSerializeOutput &io, int offset, const NValue &value, uint8_t *nullArray) const {
         // NULL doesn't produce any bytes for the NValue
         // Handle it here to consolidate manipulation of
@@ -729,7 +765,8 @@ inline void TableTuple::setNValues(int beginIdx, TableTuple lhs, int begin, int
 /*
  * With a persistent insert the copy should do an allocation for all uninlinable strings
  */
-inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source, Pool *pool) const
+inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source, Pool *pool,
+                                                StringDictionary* const* dictionaries) const
 {
     assert(m_schema);
     assert(source.m_schema);
@@ -757,6 +794,10 @@ inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source
         for (uint16_t ii = 0; ii < uninlineableObjectColumnCount; ii++) {
             const uint16_t uinlineableObjectColumnIndex =
                     m_schema->getUninlinedObjectColumnInfoIndex(ii);
+            if (dictionaries && dictionaries[ii] &&
+                setSharedObject(uinlineableObjectColumnIndex, source, dictionaries[ii])) {
+                continue;
+            }
             setNValueAllocateForObjectCopies(uinlineableObjectColumnIndex,
                     source.getNValue(uinlineableObjectColumnIndex),
                     pool);
@@ -770,7 +811,8 @@ inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source
  * a string if the source and destination pointers are different.
  */
 inline void TableTuple::copyForPersistentUpdate(const TableTuple &source,
-                                                std::vector<char*> &oldObjects, std::vector<char*> &newObjects)
+                                                std::vector<char*> &oldObjects, std::vector<char*> &newObjects,
+                                                StringDictionary* const* dictionaries)
 {
     assert(m_schema);
     assert(m_schema->equals(source.m_schema));
@@ -796,7 +838,22 @@ inline void TableTuple::copyForPersistentUpdate(const TableTuple &source,
                 char *       *mPtr = reinterpret_cast<char**>(getWritableDataPtr(columnInfo));
                 const TupleSchema::ColumnInfo *sourceColumnInfo = source.getSchema()->getColumnInfo(ii);
                 char * const *oPtr = reinterpret_cast<char* const*>(source.getDataPtr(sourceColumnInfo));
-                if (*mPtr != *oPtr) {
+                StringDictionary* dictionary =
+                    dictionaries ? dictionaries[uninlineableObjectColumnIndex] : NULL;
+                const StringRef* shared = NULL;
+                if (*mPtr != *oPtr && dictionary && *oPtr) {
+                    shared = dictionary->intern(reinterpret_cast<const StringRef*>(*oPtr));
+                }
+                if (shared) {
+                    // The dictionary's copy needs no allocation -- and no undo or
+                    // release handling -- unless it replaces some other string.
+                    if (*mPtr != reinterpret_cast<const char*>(shared)) {
+                        oldObjects.push_back(*mPtr);
+                        *mPtr = reinterpret_cast<char*>(const_cast<StringRef*>(shared));
+                        newObjects.push_back(*mPtr);
+                    }
+                }
+                else if (*mPtr != *oPtr) {
                     // Make a copy of the input string. Don't want to delete the old string
                     // because it's either from the temp pool or persistently referenced elsewhere.
                     oldObjects.push_back(*mPtr);
@@ -868,6 +925,56 @@ inline void TableTuple::copy(const TableTuple &source) {
     ::memcpy(m_data, source.m_data, m_schema->tupleLength() + TUPLE_HEADER_SIZE);
 }
 
+inline void TableTuple::deserializeFixedWidthFrom(const char* src) {
+    assert(m_schema->hasFixedWidthSerialization());
+    const int32_t columnCount  = m_schema->columnCount();
+    for (int j = 0; j < columnCount; ++j) {
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(j);
+        char* dest = m_data + TUPLE_HEADER_SIZE + columnInfo->offset;
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+            *dest = *src;
+            src += 1;
+            break;
+        case VALUE_TYPE_SMALLINT: {
+            uint16_t field;
+            memcpy(&field, src, sizeof(field));
+            field = ntohs(field);
+            memcpy(dest, &field, sizeof(field));
+            src += sizeof(field);
+            break;
+        }
+        case VALUE_TYPE_INTEGER: {
+            uint32_t field;
+            memcpy(&field, src, sizeof(field));
+            field = ntohl(field);
+            memcpy(dest, &field, sizeof(field));
+            src += sizeof(field);
+            break;
+        }
+        case VALUE_TYPE_DECIMAL: {
+            // the high word comes first
+            uint64_t words[2];
+            memcpy(&words[1], src, sizeof(words[1]));
+            memcpy(&words[0], src + sizeof(words[1]), sizeof(words[0]));
+            words[1] = ntohll(words[1]);
+            words[0] = ntohll(words[0]);
+            memcpy(dest, words, sizeof(words));
+            src += sizeof(words);
+            break;
+        }
+        default: {
+            // BIGINT, TIMESTAMP and DOUBLE
+            uint64_t field;
+            memcpy(&field, src, sizeof(field));
+            field = ntohll(field);
+            memcpy(dest, &field, sizeof(field));
+            src += sizeof(field);
+        }
+        }
+    }
+}
+
 inline void TableTuple::deserializeFrom(voltdb::SerializeInputBE &tupleIn, Pool *dataPool) {
     assert(m_schema);
     assert(m_data);
@@ -875,24 +982,31 @@ inline void TableTuple::deserializeFrom(voltdb::SerializeInputBE &tupleIn, Pool
     const int32_t columnCount  = m_schema->columnCount();
     const int32_t hiddenColumnCount  = m_schema->hiddenColumnCount();
     tupleIn.readInt();
-    for (int j = 0; j < columnCount; ++j) {
-        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(j);
-
-        /**
-         * Hack hack. deserializeFrom is only called when we serialize
-         * and deserialize tables. The serialization format for
-         * Strings/Objects in a serialized table happens to have the
-         * same in memory representation as the Strings/Objects in a
-         * tabletuple. The goal here is to wrap the serialized
-         * representation of the value in an NValue and then serialize
-         * that into the tuple from the NValue. This makes it possible
-         * to push more value specific functionality out of
-         * TableTuple. The memory allocation will be performed when
-         * serializing to tuple storage.
-         */
-        char *dataPtr = getWritableDataPtr(columnInfo);
-        NValue::deserializeFrom(tupleIn, dataPool, dataPtr, columnInfo->getVoltType(),
-                columnInfo->inlined, static_cast<int32_t>(columnInfo->length), columnInfo->inBytes);
+    if (m_schema->hasFixedWidthSerialization()) {
+        // Swap the fields straight out of the buffer, the reverse of
+        // serializeTo. Snapshot restores load rows this way.
+        deserializeFixedWidthFrom(tupleIn.getRawPointer(m_schema->lengthOfAllVisibleColumns()));
+    }
+    else {
+        for (int j = 0; j < columnCount; ++j) {
+            const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(j);
+
+            /**
+             * Hack hack. deserializeFrom is only called when we serialize
+             * and deserialize tables. The serialization format for
+             * Strings/Objects in a serialized table happens to have the
+             * same in memory representation as the Strings/Objects in a
+             * tabletuple. The goal here is to wrap the serialized
+             * representation of the value in an NValue and then serialize
+             * that into the tuple from the NValue. This makes it possible
+             * to push more value specific functionality out of
+             * TableTuple. The memory allocation will be performed when
+             * serializing to tuple storage.
+             */
+            char *dataPtr = getWritableDataPtr(columnInfo);
+            NValue::deserializeFrom(tupleIn, dataPool, dataPtr, columnInfo->getVoltType(),
+                    columnInfo->inlined, static_cast<int32_t>(columnInfo->length), columnInfo->inBytes);
+        }
     }
 
         for (int j = 0; j < hiddenColumnCount; ++j) {
@@ -954,10 +1068,61 @@ inline void TableTuple::deserializeFromDR(voltdb::SerializeInputLE &tupleIn,  Po
 inline void TableTuple::serializeTo(voltdb::SerializeOutput &output, bool includeHiddenColumns) const {
     size_t start = output.reserveBytes(4);
 
-    for (int j = 0; j < m_schema->columnCount(); ++j) {
-        //int fieldStart = output.position();
-        NValue value = getNValue(j);
-        value.serializeTo(output);
+    if (m_schema->hasFixedWidthSerialization()) {
+        // Swap the stored fields straight into the buffer, as the NValue
+        // loop below would write them.
+        char* dest = output.reserveRawBytes(m_schema->lengthOfAllVisibleColumns());
+        for (int j = 0; j < m_schema->columnCount(); ++j) {
+            const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(j);
+            const char* src = m_data + TUPLE_HEADER_SIZE + columnInfo->offset;
+            switch (columnInfo->getVoltType()) {
+            case VALUE_TYPE_TINYINT:
+                *dest = *src;
+                dest += 1;
+                break;
+            case VALUE_TYPE_SMALLINT: {
+                uint16_t field;
+                memcpy(&field, src, sizeof(field));
+                field = htons(field);
+                memcpy(dest, &field, sizeof(field));
+                dest += sizeof(field);
+                break;
+            }
+            case VALUE_TYPE_INTEGER: {
+                uint32_t field;
+                memcpy(&field, src, sizeof(field));
+                field = htonl(field);
+                memcpy(dest, &field, sizeof(field));
+                dest += sizeof(field);
+                break;
+            }
+            case VALUE_TYPE_DECIMAL: {
+                // the high word goes first
+                uint64_t words[2];
+                memcpy(words, src, sizeof(words));
+                words[1] = htonll(words[1]);
+                words[0] = htonll(words[0]);
+                memcpy(dest, &words[1], sizeof(words[1]));
+                memcpy(dest + sizeof(words[1]), &words[0], sizeof(words[0]));
+                dest += sizeof(words);
+                break;
+            }
+            default: {
+                // BIGINT, TIMESTAMP and DOUBLE
+                uint64_t field;
+                memcpy(&field, src, sizeof(field));
+                field = htonll(field);
+                memcpy(dest, &field, sizeof(field));
+                dest += sizeof(field);
+            }
+            }
+        }
+    }
+    else {
+        for (int j = 0; j < m_schema->columnCount(); ++j) {
+            NValue value = getNValue(j);
+            value.serializeTo(output);
+        }
     }
 
     if (includeHiddenColumns) {
@@ -980,12 +1145,70 @@ inline void TableTuple::serializeToExport(ExportSerializeOutput &io,
     }
 }
 
+inline void TableTuple::serializeColumnsToExport(ExportSerializeOutput &io, int colOffset,
+                                                 const std::vector<int> &columns, uint8_t *nullArray) const {
+    for (size_t i = 0; i < columns.size(); i++) {
+        serializeColumnToExport(io, colOffset + static_cast<int>(i), getNValue(columns[i]), nullArray);
+    }
+}
+
 inline void TableTuple::serializeToDR(ExportSerializeOutput &io,
                               int colOffset, uint8_t *nullArray) {
     serializeToExport(io, colOffset, nullArray);
     serializeHiddenColumnsToDR(io);
 }
 
+inline void TableTuple::serializeColumnsToDR(ExportSerializeOutput &io, const std::vector<int> &columns,
+                                             bool includeHiddenColumns, uint8_t *nullArray) const {
+    serializeColumnsToExport(io, 0, columns, nullArray);
+    if (includeHiddenColumns) {
+        serializeHiddenColumnsToDR(io);
+    }
+}
+
+inline void TableTuple::deserializeColumnsFromDR(voltdb::SerializeInputLE &tupleIn, Pool *dataPool,
+                                                 const std::vector<int> &columns, bool includeHiddenColumns) {
+    assert(m_schema);
+    assert(m_data);
+    const int32_t columnCount = static_cast<int32_t>(columns.size());
+    int nullMaskLength = ((columnCount + 7) & -8) >> 3;
+    const uint8_t *nullArray = reinterpret_cast<const uint8_t*>(tupleIn.getRawPointer(nullMaskLength));
+
+    for (int j = 0; j < columnCount; j++) {
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(columns[j]);
+        const uint8_t mask = (uint8_t) (0x80u >> (j % 8));
+        if (nullArray[j >> 3] & mask) {
+            setNValue(columns[j], NValue::getNullValue(columnInfo->getVoltType()));
+        } else {
+            NValue::deserializeFrom<TUPLE_SERIALIZATION_DR, BYTE_ORDER_LITTLE_ENDIAN>(
+                    tupleIn, dataPool, getWritableDataPtr(columnInfo),
+                    columnInfo->getVoltType(), columnInfo->inlined,
+                    static_cast<int32_t>(columnInfo->length), columnInfo->inBytes);
+        }
+    }
+
+    if (!includeHiddenColumns) {
+        return;
+    }
+    for (int i = 0; i < m_schema->hiddenColumnCount(); i++) {
+        const TupleSchema::ColumnInfo *hiddenColumnInfo = m_schema->getHiddenColumnInfo(i);
+        NValue::deserializeFrom<TUPLE_SERIALIZATION_DR, BYTE_ORDER_LITTLE_ENDIAN>(
+                tupleIn, dataPool, getWritableDataPtr(hiddenColumnInfo),
+                hiddenColumnInfo->getVoltType(), hiddenColumnInfo->inlined,
+                static_cast<int32_t>(hiddenColumnInfo->length), hiddenColumnInfo->inBytes);
+    }
+}
+
+inline size_t TableTuple::maxDRSerializationSize(const std::vector<int> &columns, bool includeHiddenColumns) const {
+    size_t bytes = maxExportSerializationSize(columns);
+    if (includeHiddenColumns) {
+        for (int i = 0; i < m_schema->hiddenColumnCount(); i++) {
+            bytes += maxExportSerializedHiddenColumnSize(i);
+        }
+    }
+    return bytes;
+}
+
 inline bool TableTuple::equals(const TableTuple &other) const {
     if (!m_schema->equals(other.m_schema)) {
         return false;
@@ -994,6 +1217,18 @@ inline bool TableTuple::equals(const TableTuple &other) const {
 }
 
 inline bool TableTuple::equalsNoSchemaCheck(const TableTuple &other, bool includeHiddenColumns /*= false*/) const {
+    // The hidden columns go first: the DR timestamp differs between rows
+    // written by different transactions, so it settles most mismatches
+    // before any string is compared.
+    if (includeHiddenColumns) {
+        for (int ii = 0; ii < m_schema->hiddenColumnCount(); ii++) {
+            const NValue lhs = getHiddenNValue(ii);
+            const NValue rhs = other.getHiddenNValue(ii);
+            if (lhs.op_notEquals(rhs).isTrue()) {
+                return false;
+            }
+        }
+    }
     for (int ii = 0; ii < m_schema->columnCount(); ii++) {
         const NValue lhs = getNValue(ii);
         const NValue rhs = other.getNValue(ii);
@@ -1001,16 +1236,6 @@ inline bool TableTuple::equalsNoSchemaCheck(const TableTuple &other, bool includ
             return false;
         }
     }
-    if (!includeHiddenColumns) {
-        return true;
-    }
-    for (int ii = 0; ii < m_schema->hiddenColumnCount(); ii++) {
-        const NValue lhs = getHiddenNValue(ii);
-        const NValue rhs = other.getHiddenNValue(ii);
-        if (lhs.op_notEquals(rhs).isTrue()) {
-            return false;
-        }
-    }
     return true;
 }
 
@@ -1048,8 +1273,8 @@ inline int TableTuple::compare(const TableTuple &other) const {
 inline size_t TableTuple::hashCode(size_t seed) const {
     const int columnCount = m_schema->columnCount();
     for (int i = 0; i < columnCount; i++) {
-        const NValue value = getNValue(i);
-        value.hashCombine(seed);
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(i);
+        columnInfo->hashCombine(columnInfo, getDataPtr(columnInfo), seed);
     }
     return seed;
 }
@@ -1059,6 +1284,50 @@ inline size_t TableTuple::hashCode() const {
     return hashCode(seed);
 }
 
+/*
+ * If the dictionary has or can take a shared copy of the source tuple's
+ * value for an uninlined column, store it and return true.
+ * The source tuple must have the same schema, so its value for the column
+ * has already been checked against the column's width.
+ */
+inline bool TableTuple::setSharedObject(const int idx, const TableTuple &source,
+                                        StringDictionary* dictionary) const
+{
+    const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(idx);
+    const StringRef* sref =
+        *reinterpret_cast<const StringRef* const*>(source.getDataPtr(columnInfo));
+    if (sref == NULL) {
+        return false;
+    }
+    const StringRef* shared = dictionary->intern(sref);
+    if (shared == NULL) {
+        return false;
+    }
+    *reinterpret_cast<const StringRef**>(getWritableDataPtr(columnInfo)) = shared;
+    return true;
+}
+
+inline void TableTuple::shareObjectColumns(StringDictionary* const* dictionaries) const
+{
+    const uint16_t uninlinedColumnCount = m_schema->getUninlinedObjectColumnCount();
+    for (uint16_t ii = 0; ii < uninlinedColumnCount; ii++) {
+        if (dictionaries[ii] == NULL) {
+            continue;
+        }
+        int idx = m_schema->getUninlinedObjectColumnInfoIndex(ii);
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(idx);
+        StringRef** dataPtr = reinterpret_cast<StringRef**>(getWritableDataPtr(columnInfo));
+        if (*dataPtr == NULL) {
+            continue;
+        }
+        const StringRef* shared = dictionaries[ii]->intern(*dataPtr);
+        if (shared != NULL && shared != *dataPtr) {
+            StringRef::destroy(*dataPtr);
+            *dataPtr = const_cast<StringRef*>(shared);
+        }
+    }
+}
+
 /**
  * Release to the heap any memory allocated for any uninlined columns.
  */
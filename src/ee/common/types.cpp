@@ -617,6 +617,15 @@ string expressionToString(ExpressionType type)
     case EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD: {
         return "AGGREGATE_HYPERLOGLOGS_TO_CARD";
     }
+    case EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE: {
+        return "AGGREGATE_APPROX_PERCENTILE";
+    }
+    case EXPRESSION_TYPE_AGGREGATE_VALS_TO_TDIGEST: {
+        return "AGGREGATE_VALS_TO_TDIGEST";
+    }
+    case EXPRESSION_TYPE_AGGREGATE_TDIGESTS_TO_PERCENTILE: {
+        return "AGGREGATE_TDIGESTS_TO_PERCENTILE";
+    }
     case EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK: {
         return "EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK";
     }
@@ -728,6 +737,12 @@ ExpressionType stringToExpression(string str )
         return EXPRESSION_TYPE_AGGREGATE_VALS_TO_HYPERLOGLOG;
     } else if (str == "AGGREGATE_HYPERLOGLOGS_TO_CARD") {
         return EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD;
+    } else if (str == "AGGREGATE_APPROX_PERCENTILE") {
+        return EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE;
+    } else if (str == "AGGREGATE_VALS_TO_TDIGEST") {
+        return EXPRESSION_TYPE_AGGREGATE_VALS_TO_TDIGEST;
+    } else if (str == "AGGREGATE_TDIGESTS_TO_PERCENTILE") {
+        return EXPRESSION_TYPE_AGGREGATE_TDIGESTS_TO_PERCENTILE;
     } else if (str == "AGGREGATE_WINDOWED_RANK") {
         return EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK;
     } else if (str == "AGGREGATE_WINDOWED_DENSE_RANK") {
@@ -312,6 +312,9 @@ enum ExpressionType {
     EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT = 46,
     EXPRESSION_TYPE_AGGREGATE_VALS_TO_HYPERLOGLOG   = 47,
     EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD  = 48,
+    EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE     = 49,
+    EXPRESSION_TYPE_AGGREGATE_VALS_TO_TDIGEST       = 50,
+    EXPRESSION_TYPE_AGGREGATE_TDIGESTS_TO_PERCENTILE = 51,
 
     // -----------------------------
     // Windowed Expression Aggregates.
@@ -450,7 +453,38 @@ inline bool tableStreamTypeAppliesToPreTruncateTable(TableStreamType streamType)
 // ------------------------------------------------------------------
 enum StatisticsSelectorType {
     STATISTICS_SELECTOR_TYPE_TABLE,
-    STATISTICS_SELECTOR_TYPE_INDEX
+    STATISTICS_SELECTOR_TYPE_INDEX,
+    // Per plan node counters of the cached plan fragments
+    STATISTICS_SELECTOR_TYPE_PLANNODE,
+    // Sampled latency histograms of the site
+    STATISTICS_SELECTOR_TYPE_LATENCY,
+    // Reads and maintenance of the indexes, and sequential scans, of tables
+    STATISTICS_SELECTOR_TYPE_INDEXUSAGE
+};
+
+// ------------------------------------------------------------------
+// Memory Detail Types
+// ------------------------------------------------------------------
+// The order must match the EE indexes of SiteMemoryStats.Subsystem and
+// MEMORY_DETAIL_COUNT in ExecutionEngine.java.
+enum MemoryDetailType {
+    // Exact-sized object pools of the thread
+    MEMORY_DETAIL_POOL_EXACT_SIZED,
+    // Relocatable (string) object pools of the thread, free space included
+    MEMORY_DETAIL_POOL_RELOCATABLE,
+    // Temp table data of the cached plans, now and at the most recent peak
+    MEMORY_DETAIL_TEMP_TABLE,
+    MEMORY_DETAIL_TEMP_TABLE_PEAK,
+    // Undo quanta and the pools kept for reuse by the undo log
+    MEMORY_DETAIL_UNDO,
+    // Stream blocks not yet handed to the top end
+    MEMORY_DETAIL_EXPORT_PENDING,
+    MEMORY_DETAIL_DR_PENDING,
+    // Estimated memory of the cached plans
+    MEMORY_DETAIL_PLAN_CACHE,
+    // Block copies held by running snapshots
+    MEMORY_DETAIL_SNAPSHOT_COPIES,
+    MEMORY_DETAIL_COUNT
 };
 
 // ------------------------------------------------------------------
@@ -516,7 +550,9 @@ enum DRRecordType {
     DR_RECORD_TRUNCATE_TABLE = 5,
     DR_RECORD_DELETE_BY_INDEX = 6,
     DR_RECORD_UPDATE_BY_INDEX = 7,
-    DR_RECORD_HASH_DELIMITER = 8
+    DR_RECORD_HASH_DELIMITER = 8,
+    // Unique key of the old row plus the new values of the changed columns
+    DR_RECORD_UPDATE_CHANGED_COLUMNS = 9
 };
 
 // ------------------------------------------------------------------
@@ -540,6 +576,7 @@ inline size_t rowCostForDRRecord(DRRecordType type) {
         return 1;
     case DR_RECORD_UPDATE:
     case DR_RECORD_UPDATE_BY_INDEX:
+    case DR_RECORD_UPDATE_CHANGED_COLUMNS:
         return 2;
     case DR_RECORD_TRUNCATE_TABLE:
         return 100;
@@ -54,6 +54,8 @@
 
 #include "boost/foreach.hpp"
 
+#include <sstream>
+
 namespace voltdb {
 
 boost::shared_ptr<ExecutorVector> ExecutorVector::fromCatalogStatement(VoltDBEngine* engine,
@@ -107,7 +109,10 @@ boost::shared_ptr<ExecutorVector> ExecutorVector::fromJsonPlan(VoltDBEngine* eng
                                                             tempTableLogLimit,
                                                             tempTableMemoryLimit,
                                                             pnf));
+    ev->m_limits.setSpill(engine->tempTableSpill());
+    ev->m_limits.setBlockCache(engine->tempBlockCache());
     ev->init(engine);
+    ev->m_memoryEstimate += static_cast<int64_t>(jsonPlan.size());
     return ev;
 }
 
@@ -121,6 +126,10 @@ void ExecutorVector::init(VoltDBEngine* engine) {
         BOOST_FOREACH (AbstractPlanNode* planNode, planNodeList) {
             initPlanNode(engine, planNode);
             executorList->push_back(planNode->getExecutor());
+            const TempTable* output = planNode->getExecutor()->getTempOutputTable();
+            if (output) {
+                m_memoryEstimate += output->getTableAllocationSize();
+            }
         }
         m_subplanExecListMap.insert(make_pair(it->first, executorList.get()));
         executorList.release();
@@ -186,6 +195,35 @@ void ExecutorVector::setupContext(ExecutorContext* executorContext)
 
 void ExecutorVector::resetLimitStats() { m_limits.resetPeakMemory(); }
 
+void ExecutorVector::addExecutorStats(TempTable* statsTable, TableTuple& tuple, bool interval) {
+    typedef std::map<int, std::vector<AbstractExecutor*>* >::value_type MapEntry;
+    BOOST_FOREACH (MapEntry& entry, m_subplanExecListMap) {
+        BOOST_FOREACH (AbstractExecutor* executor, *entry.second) {
+            executor->getExecutorStats().updateStatsTuple(&tuple, m_fragId,
+                                                          executor->getPlanNode(), interval);
+            statsTable->insertTempTuple(tuple);
+        }
+    }
+}
+
+std::string ExecutorVector::latestExecutionDebug() const {
+    std::ostringstream buffer;
+    typedef std::map<int, std::vector<AbstractExecutor*>* >::value_type MapEntry;
+    BOOST_FOREACH (const MapEntry& entry, m_subplanExecListMap) {
+        BOOST_FOREACH (AbstractExecutor* executor, *entry.second) {
+            const ExecutorStats& stats = executor->getExecutorStats();
+            const AbstractPlanNode* node = executor->getPlanNode();
+            buffer << "\n  subplan " << entry.first
+                   << " node " << node->getPlanNodeId()
+                   << " " << planNodeToString(node->getPlanNodeType())
+                   << ": " << (stats.latestNanos() / 1000) << " us, "
+                   << stats.latestTuplesIn() << " rows in, "
+                   << stats.latestTuplesOut() << " rows out";
+        }
+    }
+    return buffer.str();
+}
+
 const std::vector<AbstractExecutor*>& ExecutorVector::getExecutorList(int planId) {
     assert(m_subplanExecListMap.find(planId) != m_subplanExecListMap.end());
     return *(m_subplanExecListMap.find(planId)->second);
@@ -63,6 +63,8 @@ class VoltDBEngine;
 class AbstractPlanNode;
 class AbstractExecutor;
 class ExecutorContext;
+class TableTuple;
+class TempTable;
 
 /**
  * A list of executors for runtime.
@@ -87,6 +89,13 @@ public:
 
     const TempTableLimits& limits() const { return m_limits; }
 
+    /**
+     * About how much memory the cached plan holds on to: its plan, for
+     * the plan nodes built from it, and a block for each output temp
+     * table, which is kept once the table has been used.
+     */
+    int64_t memoryEstimate() const { return m_memoryEstimate; }
+
     /** Return a std::string with helpful info about this object. */
     std::string debug() const;
 
@@ -94,6 +103,19 @@ public:
 
     void resetLimitStats();
 
+    /**
+     * Add a row of executor stats to the table for each plan node of
+     * the fragment and its subqueries. The tuple holds the base stats
+     * columns already.
+     */
+    void addExecutorStats(TempTable* statsTable, TableTuple& tuple, bool interval);
+
+    /**
+     * Describe the most recent execution of each plan node of the fragment
+     * and its subqueries, one line per node, for the slow fragment log.
+     */
+    std::string latestExecutionDebug() const;
+
     // Get the executors list for a given subplan. The default plan id = 0
     // represents the top level parent plan
     const std::vector<AbstractExecutor*>& getExecutorList(int planId = 0);
@@ -125,6 +147,7 @@ private:
         : m_fragId(fragmentId)
         , m_limits(memoryLimit, logThreshold)
         , m_fragment(fragment)
+        , m_memoryEstimate(0)
     { }
 
     void initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node);
@@ -133,6 +156,7 @@ private:
     std::map<int, std::vector<AbstractExecutor*>* > m_subplanExecListMap;
     TempTableLimits m_limits;
     boost::scoped_ptr<PlanNodeFragment> m_fragment;
+    int64_t m_memoryEstimate;
 };
 
 } // namespace voltdb
@@ -16,16 +16,38 @@
  */
 #include "JNITopend.h"
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 #include "common/debuglog.h"
 #include "common/StreamBlock.h"
+#include "executors/ExecutorStats.h"
 #include "storage/table.h"
 
 using namespace std;
 
 namespace voltdb{
 
+// Create an instance of this class on the stack to count an upcall and
+// charge the time until it returns (or throws) to it.
+class UpcallTimer {
+  public:
+    UpcallTimer(JNITopend* topend, JNITopend::UpcallType type)
+        : m_topend(topend), m_type(type), m_start(ExecutorStats::nowNanos())
+    {
+        ++m_topend->m_upcallCounts[m_type];
+    }
+
+    ~UpcallTimer() {
+        m_topend->m_upcallNanos[m_type] += ExecutorStats::nowNanos() - m_start;
+    }
+
+  private:
+    JNITopend* const m_topend;
+    const JNITopend::UpcallType m_type;
+    const int64_t m_start;
+};
+
 // Create an instance of this class on the stack to release all local
 // references created during its lifetime.
 class JNILocalFrameBarrier {
@@ -70,6 +92,9 @@ class JNILocalFrameBarrier {
 };
 
 JNITopend::JNITopend(JNIEnv *env, jobject caller) : m_jniEnv(env), m_javaExecutionEngine(caller) {
+    ::memset(m_upcallCounts, 0, sizeof(m_upcallCounts));
+    ::memset(m_upcallNanos, 0, sizeof(m_upcallNanos));
+
     // Cache the method id for better performance. It is valid until the JVM unloads the class:
     // http://java.sun.com/javase/6/docs/technotes/guides/jni/spec/design.html#wp17074
     jclass jniClass = m_jniEnv->GetObjectClass(m_javaExecutionEngine);
@@ -218,6 +243,7 @@ JNITopend::JNITopend(JNIEnv *env, jobject caller) : m_jniEnv(env), m_javaExecuti
 
 
 void JNITopend::fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
+    UpcallTimer timer(this, UPCALL_FALLBACK_TO_EE_ALLOCATED_BUFFER);
     JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 1);
     if (jni_frame.checkResult() < 0) {
         VOLT_ERROR("Unable to load dependency: jni frame error.");
@@ -238,6 +264,7 @@ void JNITopend::fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
 }
 
 int JNITopend::loadNextDependency(int32_t dependencyId, voltdb::Pool *stringPool, Table* destination) {
+    UpcallTimer timer(this, UPCALL_LOAD_NEXT_DEPENDENCY);
     VOLT_DEBUG("iterating java dependency for id %d", dependencyId);
 
     JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 10);
@@ -276,6 +303,7 @@ int64_t JNITopend::fragmentProgressUpdate(
                 int64_t tuplesProcessed,
                 int64_t currMemoryInBytes,
                 int64_t peakMemoryInBytes) {
+    UpcallTimer timer(this, UPCALL_FRAGMENT_PROGRESS_UPDATE);
     jlong nextStep = m_jniEnv->CallLongMethod(m_javaExecutionEngine,
                                               m_fragmentProgressUpdateMID,
                                               batchIndex,
@@ -308,6 +336,7 @@ static std::string jbyteArrayToStdString(JNIEnv* jniEnv,
  }
 
 std::string JNITopend::planForFragmentId(int64_t fragmentId) {
+    UpcallTimer timer(this, UPCALL_PLAN_FOR_FRAGMENT_ID);
     VOLT_DEBUG("fetching plan for id %d", (int) fragmentId);
 
     JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 10);
@@ -326,6 +355,7 @@ std::string JNITopend::planForFragmentId(int64_t fragmentId) {
 }
 
 std::string JNITopend::decodeBase64AndDecompress(const std::string& base64Str) {
+    UpcallTimer timer(this, UPCALL_DECODE_BASE64_AND_DECOMPRESS);
     JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 2);
     if (jni_frame.checkResult() < 0) {
         VOLT_ERROR("Unable to load dependency: jni frame error.");
@@ -387,6 +417,11 @@ void JNITopend::crashVoltDB(FatalException e) {
     throw std::exception();
 }
 
+void JNITopend::getUpcallStats(int64_t* counts) const {
+    ::memcpy(counts, m_upcallCounts, sizeof(m_upcallCounts));
+    ::memcpy(counts + UPCALL_COUNT, m_upcallNanos, sizeof(m_upcallNanos));
+}
+
 JNITopend::~JNITopend() {
     m_jniEnv->DeleteGlobalRef(m_javaExecutionEngine);
     m_jniEnv->DeleteGlobalRef(m_exportManagerClass);
@@ -395,6 +430,7 @@ JNITopend::~JNITopend() {
 }
 
 int64_t JNITopend::getQueuedExportBytes(int32_t partitionId, string signature) {
+    UpcallTimer timer(this, UPCALL_GET_QUEUED_EXPORT_BYTES);
     jstring signatureString = m_jniEnv->NewStringUTF(signature.c_str());
     int64_t retval = m_jniEnv->CallStaticLongMethod(
             m_exportManagerClass,
@@ -412,6 +448,7 @@ void JNITopend::pushExportBuffer(
         StreamBlock *block,
         bool sync,
         bool endOfStream) {
+    UpcallTimer timer(this, UPCALL_PUSH_EXPORT_BUFFER);
     jstring signatureString = m_jniEnv->NewStringUTF(signature.c_str());
     if (block != NULL) {
         jobject buffer = m_jniEnv->NewDirectByteBuffer( block->rawPtr(), block->rawLength());
@@ -454,6 +491,7 @@ void JNITopend::pushExportBuffer(
 }
 
 int64_t JNITopend::pushDRBuffer(int32_t partitionId, StreamBlock *block) {
+    UpcallTimer timer(this, UPCALL_PUSH_DR_BUFFER);
     int64_t retval = -1;
     if (block != NULL) {
         jobject buffer = m_jniEnv->NewDirectByteBuffer( block->rawPtr(), block->rawLength());
@@ -499,6 +537,7 @@ int JNITopend::reportDRConflict(int32_t partitionId, int32_t remoteClusterId, in
         Table *expectedMetaTableForDelete, Table *expectedTupleTableForDelete,
         DRConflictType insertConflict, Table *existingMetaTableForInsert, Table *existingTupleTableForInsert,
         Table *newMetaTableForInsert, Table *newTupleTableForInsert) {
+    UpcallTimer timer(this, UPCALL_REPORT_DR_CONFLICT);
     // prepare tablename
     jstring tableNameString = m_jniEnv->NewStringUTF(tableName.c_str());
 
@@ -27,6 +27,24 @@ namespace voltdb {
 
 class JNITopend : public Topend {
 public:
+    /**
+     * The upcalls that are counted and timed, in the order of
+     * JNICallStats.Upcall in Java. crashVoltDB is left out, it doesn't return.
+     */
+    enum UpcallType {
+        UPCALL_LOAD_NEXT_DEPENDENCY,
+        UPCALL_FRAGMENT_PROGRESS_UPDATE,
+        UPCALL_PLAN_FOR_FRAGMENT_ID,
+        UPCALL_GET_QUEUED_EXPORT_BYTES,
+        UPCALL_PUSH_EXPORT_BUFFER,
+        UPCALL_PUSH_DR_BUFFER,
+        UPCALL_REPORT_DR_CONFLICT,
+        UPCALL_FALLBACK_TO_EE_ALLOCATED_BUFFER,
+        UPCALL_DECODE_BASE64_AND_DECOMPRESS,
+        UPCALL_COUNT
+    };
+
+
     JNITopend(JNIEnv *env, jobject caller);
     ~JNITopend();
 
@@ -61,9 +79,22 @@ public:
 
     std::string decodeBase64AndDecompress(const std::string& buffer);
 
+    /**
+     * Copy the invocation count of each upcall type into counts[0, UPCALL_COUNT)
+     * and the nanoseconds spent in it, Java time included, into
+     * counts[UPCALL_COUNT, 2 * UPCALL_COUNT).
+     */
+    void getUpcallStats(int64_t* counts) const;
+
 private:
+    friend class UpcallTimer;
+
     JNIEnv *m_jniEnv;
 
+    // Only the site thread makes upcalls, so these are not synchronized
+    int64_t m_upcallCounts[UPCALL_COUNT];
+    int64_t m_upcallNanos[UPCALL_COUNT];
+
     /**
      * JNI object corresponding to this engine. for callback functions.
      * if this is NULL, VoltDBEngine will fail to call sendDependency().
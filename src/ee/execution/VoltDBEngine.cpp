@@ -67,6 +67,8 @@
 #include "common/InterruptException.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/SerializableEEException.h"
+#include "common/StringRef.h"
+#include "common/ThreadLocalPool.h"
 #include "common/TupleOutputStream.h"
 #include "common/TupleOutputStreamProcessor.h"
 #include "executors/abstractexecutor.h"
@@ -74,6 +76,7 @@
 #include "indexes/tableindexfactory.h"
 #include "plannodes/abstractplannode.h"
 #include "plannodes/plannodefragment.h"
+#include "stats/LatencySample.h"
 #include "storage/tablefactory.h"
 #include "storage/persistenttable.h"
 #include "storage/streamedtable.h"
@@ -82,8 +85,12 @@
 #include "storage/TableCatalogDelegate.hpp"
 #include "storage/CompatibleDRTupleStream.h"
 #include "storage/DRTupleStream.h"
+#include "storage/ColdStorage.h"
+#include "storage/TempBlockCache.h"
+#include "storage/TempTableSpill.h"
 #include "org_voltdb_jni_ExecutionEngine.h" // to use static values
 
+#include "boost/date_time/posix_time/posix_time.hpp"
 #include "boost/foreach.hpp"
 #include "boost/scoped_ptr.hpp"
 #include "boost/shared_ptr.hpp"
@@ -105,7 +112,8 @@ ENABLE_BOOST_FOREACH_ON_CONST_MAP(Index);
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(MaterializedViewInfo);
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Table);
 
-static const size_t PLAN_CACHE_SIZE = 1000;
+// the memory the cached plans may hold on to, by their estimates
+static const int64_t PLAN_CACHE_MEMORY = 256 * 1024 * 1024;
 // how many initial tuples to scan before calling into java
 const int64_t LONG_OP_THRESHOLD = 10000;
 // table name prefix of DR conflict table
@@ -145,6 +153,7 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy)
       m_tuplesProcessedSinceReport(0),
       m_tupleReportThreshold(LONG_OP_THRESHOLD),
       m_lastAccessedPlanNodeType(PLAN_NODE_TYPE_INVALID),
+      m_plansMemoryEstimate(0),
       m_currentUndoQuantum(NULL),
       m_partitionId(-1),
       m_hashinator(NULL),
@@ -157,6 +166,12 @@ VoltDBEngine::VoltDBEngine(Topend *topend, LogProxy *logProxy)
       m_templateSingleLongTable(NULL),
       m_topend(topend),
       m_executorContext(NULL),
+      m_coldStorage(NULL),
+      m_tempTableSpill(NULL),
+      m_tempBlockCache(new TempBlockCache()),
+      m_slowFragmentNanos(0),
+      m_redactSlowFragmentParameters(false),
+      m_validatedHashinatorEpoch(0),
       m_drPartitionedConflictStreamedTable(NULL),
       m_drReplicatedConflictStreamedTable(NULL),
       m_drStream(NULL),
@@ -178,13 +193,35 @@ VoltDBEngine::initialize(int32_t clusterIndex,
                          int32_t defaultDrBufferSize,
                          int64_t tempTableMemoryLimit,
                          bool createDrReplicatedStream,
-                         int32_t compactionThreshold)
+                         int32_t compactionThreshold,
+                         std::string coldStorageDirectory,
+                         int64_t maxResidentTupleBlockMemory,
+                         std::string tempTableSpillDirectory,
+                         int32_t slowFragmentMillis,
+                         bool redactSlowFragmentParameters,
+                         int32_t stackSampleHz,
+                         int32_t packedStringMaxLength,
+                         int32_t loadHelperThreads)
 {
     m_clusterIndex = clusterIndex;
     m_siteId = siteId;
     m_partitionId = partitionId;
     m_tempTableMemoryLimit = tempTableMemoryLimit;
     m_compactionThreshold = compactionThreshold;
+    if (!coldStorageDirectory.empty() || maxResidentTupleBlockMemory > 0) {
+        m_coldStorage = new ColdStorage(coldStorageDirectory, maxResidentTupleBlockMemory);
+    }
+    if (!tempTableSpillDirectory.empty()) {
+        m_tempTableSpill = new TempTableSpill(tempTableSpillDirectory);
+        if (!m_tempTableSpill->isUsable()) {
+            delete m_tempTableSpill;
+            m_tempTableSpill = NULL;
+        }
+    }
+    setSlowFragmentThreshold(static_cast<int64_t>(slowFragmentMillis) * 1000000, redactSlowFragmentParameters);
+    m_stackSampler.start(stackSampleHz);
+    StringRef::setPackedMaxLength(packedStringMaxLength);
+    Table::setLoadHelperThreads(loadHelperThreads);
 
     // Instantiate our catalog - it will be populated later on by load()
     m_catalog.reset(new catalog::Catalog());
@@ -277,12 +314,25 @@ VoltDBEngine::~VoltDBEngine() {
         tid.second->decrementRefcount();
     }
 
+    BOOST_FOREACH (PersistentTable *table, m_tablesToReclaim) {
+        table->decrementRefcount();
+    }
+
     delete m_executorContext;
 
     delete m_drReplicatedStream;
     delete m_drStream;
     delete m_compatibleDRStream;
     delete m_compatibleDRReplicatedStream;
+
+    // Cold tuple blocks give back their file space as the tables go.
+    delete m_coldStorage;
+
+    // Spilled temp table blocks went with the plans.
+    delete m_tempTableSpill;
+
+    // So did the blocks temp tables held; what is left is only cached.
+    delete m_tempBlockCache;
 }
 
 // ------------------------------------------------------------------
@@ -398,8 +448,10 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
         }
         assert (m_usedParamcnt < MAX_PARAM_COUNT);
 
+        // Strings are left in the parameter buffer, which is not reused
+        // until the batch is done, rather than copied for each fragment.
         for (int j = 0; j < m_usedParamcnt; ++j) {
-            m_staticParams[j].deserializeFromAllocateForStorage(serialize_in, &m_stringPool);
+            m_staticParams[j].deserializeParameterReferencingInput(serialize_in, &m_stringPool);
         }
 
         // success is 0 and error is 1.
@@ -428,6 +480,32 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
     return failures;
 }
 
+int VoltDBEngine::executeTransactionBatch(int32_t numTransactions,
+                                          const int64_t transactionInfo[],
+                                          int64_t planfragmentIds[],
+                                          ReferenceSerializeInputBE &serialize_in)
+{
+    int32_t firstFragment = 0;
+    for (int32_t ii = 0; ii < numTransactions; ++ii) {
+        const int64_t* info = &transactionInfo[ii * TXN_BATCH_INFO_FIELDS];
+        const int32_t numFragments = static_cast<int32_t>(info[0]);
+        assert(numFragments > 0);
+        if (executePlanFragments(numFragments,
+                                 &planfragmentIds[firstFragment],
+                                 NULL,
+                                 serialize_in,
+                                 info[1],
+                                 info[2],
+                                 info[3],
+                                 info[4],
+                                 info[5]) > 0) {
+            return ii;
+        }
+        firstFragment += numFragments;
+    }
+    return numTransactions;
+}
+
 int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
                                       int64_t inputDependencyId,
                                       int64_t txnId,
@@ -438,6 +516,7 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
                                       bool last)
 {
     assert(planfragmentId != 0);
+    ScopedLatencySample latencySample(LATENCY_FRAGMENT);
 
     m_currentInputDepId = static_cast<int32_t>(inputDependencyId);
 
@@ -468,12 +547,22 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
     assert(m_tuplesModifiedStack.size() == 0);
 
     int64_t tuplesModified = 0;
+    // One clock read before and after is all the slow fragment log costs
+    // when fragments are fast; the per-node numbers are kept anyway.
+    const int64_t startNanos = m_slowFragmentNanos > 0 ? ExecutorStats::nowNanos() : 0;
     try {
         // execution lists for planfragments are cached by planfragment id
         setExecutorVectorForFragmentId(planfragmentId);
         assert(m_currExecutorVec);
 
         executePlanFragment(m_currExecutorVec, &tuplesModified);
+
+        if (m_slowFragmentNanos > 0) {
+            const int64_t nanos = ExecutorStats::nowNanos() - startNanos;
+            if (nanos >= m_slowFragmentNanos) {
+                logSlowFragment(planfragmentId, nanos, tuplesModified);
+            }
+        }
     }
     catch (const SerializableEEException &e) {
         serializeException(e);
@@ -560,6 +649,28 @@ void VoltDBEngine::resetExecutionMetadata(ExecutorVector* executorVector) {
     executorVector->resetLimitStats();
 }
 
+void VoltDBEngine::logSlowFragment(int64_t fragmentId, int64_t nanos, int64_t tuplesModified) {
+    const Logger* logger = LogManager::getThreadLogger(LOGGERID_HOST);
+    if ( ! logger->isLoggable(LOGLEVEL_INFO)) {
+        return;
+    }
+    std::ostringstream message;
+    message << "Slow fragment " << fragmentId << " on partition " << m_partitionId
+            << " took " << (nanos / 1000) << " us, " << tuplesModified << " tuples modified, parameters: ";
+    if (m_redactSlowFragmentParameters) {
+        message << m_usedParamcnt << " redacted";
+    }
+    else {
+        message << "(";
+        for (int i = 0; i < m_usedParamcnt; ++i) {
+            message << (i == 0 ? "" : ", ") << m_staticParams[i].debug();
+        }
+        message << ")";
+    }
+    message << m_currExecutorVec->latestExecutionDebug();
+    logger->log(LOGLEVEL_INFO, message.str().c_str());
+}
+
 void VoltDBEngine::serializeException(const SerializableEEException& e) {
     resetReusedResultOutputBuffer();
     e.serialize(getExceptionOutputSerializer());
@@ -936,11 +1047,15 @@ VoltDBEngine::processCatalogAdditions(int64_t timestamp)
             }
 
             //
-            // Same schema, but TUPLE_LIMIT may change.
+            // Same schema, but TUPLE_LIMIT, the TTL and CLUSTER may change,
+            // and so may APPEND ONLY while the table is empty.
             // Because there is no table rebuilt work next, no special need to take care of
             // the new tuple limit.
             //
             persistentTable->setTupleLimit(catalogTable->tuplelimit());
+            persistentTable->setAppendOnly(catalogTable->isAppendOnly());
+            persistentTable->setClustered(catalogTable->isClustered());
+            TableCatalogDelegate::configureTimeToLive(*catalogTable, persistentTable);
 
             //////////////////////////////////////////
             // find all of the indexes to add
@@ -998,6 +1113,8 @@ VoltDBEngine::processCatalogAdditions(int64_t timestamp)
                     // add the index to the stats source
                     index->getIndexStats()->configure(index->getName() + " stats",
                                                       persistentTable->name());
+                    index->getIndexUsageStats()->configure(index->getName() + " usage stats",
+                                                           persistentTable->name());
                 }
             }
 
@@ -1104,6 +1221,7 @@ VoltDBEngine::updateCatalog(const int64_t timestamp, const std::string &catalogP
     // clean up execution plans when the tables underneath might change
     if (m_plans) {
         m_plans->clear();
+        m_plansMemoryEstimate = 0;
     }
 
     assert(m_catalog != NULL); // the engine must be initialized
@@ -1202,6 +1320,7 @@ void VoltDBEngine::rebuildTableCollections()
     // need to re-map all the table ids / indexes
     getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_TABLE);
     getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_INDEX);
+    getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_INDEXUSAGE);
 
     // walk the table delegates and update local table collections
     BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
@@ -1210,45 +1329,74 @@ void VoltDBEngine::rebuildTableCollections()
         if (!tcd) {
             continue;
         }
-        Table* localTable = tcd->getTable();
-        assert(localTable);
-        if (!localTable) {
+        if (!tcd->getTable()) {
             VOLT_ERROR("DEBUG-NULL");//:%s", cd.first.c_str());
             std::cout << "DEBUG-NULL:" << cd.first << std::endl;
             continue;
         }
-        assert(m_database);
-        catalog::Table *catTable = m_database->tables().get(localTable->name());
-        int32_t relativeIndexOfTable = catTable->relativeIndex();
-        m_tables[relativeIndexOfTable] = localTable;
-        m_tablesByName[tcd->getTable()->name()] = localTable;
-
-        TableStats* stats;
-        PersistentTable* persistentTable = tcd->getPersistentTable();
-        if (persistentTable) {
-            stats = persistentTable->getTableStats();
-            if (!tcd->materialized()) {
-                int64_t hash = *reinterpret_cast<const int64_t*>(tcd->signatureHash());
-                m_tablesBySignatureHash[hash] = persistentTable;
-            }
+        addTableToCollections(tcd);
+    }
+    resetDRConflictStreamedTables();
+}
 
-            // add all of the indexes to the stats source
-            const std::vector<TableIndex*>& tindexes = persistentTable->allIndexes();
-            BOOST_FOREACH (TableIndex *index, tindexes) {
-                getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_INDEX,
-                                                      relativeIndexOfTable,
-                                                      index->getIndexStats());
-            }
+void VoltDBEngine::rebuildTableCollections(TableCatalogDelegate *tcd)
+{
+    assert(tcd && tcd->getTable());
+    assert(m_database);
+    catalog::Table *catTable = m_database->tables().get(tcd->getTable()->name());
+    int32_t relativeIndexOfTable = catTable->relativeIndex();
+
+    // The table maps are overwritten in place, but the stats agent would
+    // keep the old table's sources alongside the new ones.
+    getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_TABLE, relativeIndexOfTable);
+    getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_INDEX, relativeIndexOfTable);
+    getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_INDEXUSAGE, relativeIndexOfTable);
+
+    addTableToCollections(tcd);
+    resetDRConflictStreamedTables();
+}
+
+void VoltDBEngine::addTableToCollections(TableCatalogDelegate *tcd)
+{
+    Table* localTable = tcd->getTable();
+    assert(localTable);
+    assert(m_database);
+    catalog::Table *catTable = m_database->tables().get(localTable->name());
+    int32_t relativeIndexOfTable = catTable->relativeIndex();
+    m_tables[relativeIndexOfTable] = localTable;
+    m_tablesByName[localTable->name()] = localTable;
+
+    TableStats* stats;
+    PersistentTable* persistentTable = tcd->getPersistentTable();
+    if (persistentTable) {
+        stats = persistentTable->getTableStats();
+        if (!tcd->materialized()) {
+            int64_t hash = *reinterpret_cast<const int64_t*>(tcd->signatureHash());
+            m_tablesBySignatureHash[hash] = persistentTable;
         }
-        else {
-            stats = tcd->getStreamedTable()->getTableStats();
+
+        // add all of the indexes to the stats source
+        const std::vector<TableIndex*>& tindexes = persistentTable->allIndexes();
+        BOOST_FOREACH (TableIndex *index, tindexes) {
+            getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_INDEX,
+                                                  relativeIndexOfTable,
+                                                  index->getIndexStats());
         }
-        getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_TABLE,
+        getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_INDEXUSAGE,
                                               relativeIndexOfTable,
-                                              stats);
-
+                                              persistentTable->getScanUsageStats());
+        BOOST_FOREACH (TableIndex *index, tindexes) {
+            getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_INDEXUSAGE,
+                                                  relativeIndexOfTable,
+                                                  index->getIndexUsageStats());
+        }
     }
-    resetDRConflictStreamedTables();
+    else {
+        stats = tcd->getStreamedTable()->getTableStats();
+    }
+    getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_TABLE,
+                                          relativeIndexOfTable,
+                                          stats);
 }
 
 void VoltDBEngine::resetDRConflictStreamedTables()
@@ -1277,6 +1425,15 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId)
 {
     if (m_plans) {
         PlanSet& existing_plans = *m_plans;
+
+        // A batch that repeats one statement (e.g. many queued INSERTs) asks
+        // for the plan at the front of the list over and over; skip the lookup.
+        if ( ! existing_plans.empty() && (*existing_plans.begin())->getFragId() == fragId) {
+            m_currExecutorVec = existing_plans.begin()->get();
+            m_currExecutorVec->setupContext(m_executorContext);
+            return;
+        }
+
         PlanSet::nth_index<1>::type::iterator iter = existing_plans.get<1>().find(fragId);
 
         // found it, move it to the front
@@ -1311,10 +1468,14 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId)
     // (Why to the back?  Shouldn't it be at the front with the
     // most recently used items?  See ENG-7244)
     plans.get<0>().push_back(ev_guard);
+    m_plansMemoryEstimate += ev_guard->memoryEstimate();
 
-    // remove a plan from the front if the cache is full
-    if (plans.size() > PLAN_CACHE_SIZE) {
+    // Remove plans from the front while the cache holds too much memory.
+    // Plans differ widely in size, from a single scan to many joined
+    // subqueries, so a count of plans bounds the memory poorly.
+    while (m_plansMemoryEstimate > PLAN_CACHE_MEMORY && plans.size() > 1) {
         PlanSet::iterator iter = plans.get<0>().begin();
+        m_plansMemoryEstimate -= (*iter)->memoryEstimate();
         plans.erase(iter);
     }
 
@@ -1416,17 +1577,13 @@ void VoltDBEngine::initMaterializedViewsAndLimitDeletePlans() {
             initMaterializedViews(catalogTable, persistentTable);
             if (catalogTable->tuplelimitDeleteStmt().size() > 0) {
                 catalog::Statement* stmt = catalogTable->tuplelimitDeleteStmt().begin()->second;
-                const std::string b64String = stmt->fragments().begin()->second->plannodetree();
-                std::string jsonPlan = getTopend()->decodeBase64AndDecompress(b64String);
-                persistentTable->swapPurgeExecutorVector(ExecutorVector::fromJsonPlan(this,
-                                                                                jsonPlan,
-                                                                                -1));
+                // Parsed by executePurgeFragment when the row limit is first hit
+                persistentTable->setPurgePlan(stmt->fragments().begin()->second->plannodetree());
             }
             else {
                 // get rid of the purge fragment from the persistent
                 // table if it has been removed from the catalog
-                boost::shared_ptr<ExecutorVector> nullPtr;
-                persistentTable->swapPurgeExecutorVector(nullPtr);
+                persistentTable->setPurgePlan(std::string());
             }
         }
         else {
@@ -1490,6 +1647,142 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
     if (m_executorContext->drReplicatedStream()) {
         m_executorContext->drReplicatedStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
     }
+    expireRows(timeInMillis);
+    compactTablesIncrementally();
+    clusterTablesIncrementally();
+    summarizeZonesIncrementally();
+    evictIdleTupleBlocks();
+    reclaimTables();
+    m_stackSampler.drain();
+}
+
+/**
+ * Delete a batch of the expired rows of each table with a TTL. The deletes
+ * have no undo, so they wait while any transaction could still roll back,
+ * as between the fragments of a multi-partition transaction.
+ */
+void VoltDBEngine::expireRows(int64_t timeInMillis) {
+    if ( ! m_undoLog.isEmpty()) {
+        return;
+    }
+    BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
+        PersistentTable* table = cd.second->getPersistentTable();
+        if (table != NULL && table->hasTimeToLive()) {
+            table->expireRows(timeInMillis * 1000);
+        }
+    }
+}
+
+/**
+ * Spend a bounded amount of the tick on compacting the tables that are
+ * fragmented, so that tables that are rarely written, and so rarely see
+ * compaction at undo quantum release, still give back their memory.
+ * The budget is shared by all the tables rather than given to each.
+ * Moving tuples would strand the undo actions that point at them, so it
+ * waits while a transaction could still roll back.
+ */
+void VoltDBEngine::compactTablesIncrementally() {
+    if ( ! m_undoLog.isEmpty()) {
+        return;
+    }
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+    int64_t tuplesLeft = PersistentTable::TICK_COMPACTION_MAX_TUPLES;
+    int64_t microsLeft = PersistentTable::TICK_COMPACTION_MAX_MICROS;
+    BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
+        PersistentTable* table = cd.second->getPersistentTable();
+        if (table == NULL) {
+            continue;
+        }
+        int64_t compactedTupleCountBefore = table->compactedTupleCount();
+        table->doIncrementalCompaction(tuplesLeft, microsLeft);
+        int64_t tuplesMoved = table->compactedTupleCount() - compactedTupleCountBefore;
+        if (tuplesMoved == 0) {
+            continue;
+        }
+        tuplesLeft -= tuplesMoved;
+        microsLeft = PersistentTable::TICK_COMPACTION_MAX_MICROS -
+            (boost::posix_time::microsec_clock::universal_time() - startTime).total_microseconds();
+        if (tuplesLeft <= 0 || microsLeft <= 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * Move up to TICK_CLUSTER_MAX_TUPLES rows of the clustered tables into
+ * primary key order. Like compaction, it waits while a transaction could
+ * still roll back.
+ */
+void VoltDBEngine::clusterTablesIncrementally() {
+    if ( ! m_undoLog.isEmpty()) {
+        return;
+    }
+    int64_t tuplesLeft = PersistentTable::TICK_CLUSTER_MAX_TUPLES;
+    BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
+        PersistentTable* table = cd.second->getPersistentTable();
+        if (table == NULL || ! table->isClustered()) {
+            continue;
+        }
+        tuplesLeft -= table->clusterIncrementally(tuplesLeft);
+        if (tuplesLeft <= 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * Bring the zone maps of blocks that took new rows up to date, reading up
+ * to TICK_ZONE_MAX_TUPLES slots over all the tables. A summary taken while
+ * an update could still be undone might not cover the values it restores,
+ * so it waits like compaction.
+ */
+void VoltDBEngine::summarizeZonesIncrementally() {
+    if ( ! m_undoLog.isEmpty()) {
+        return;
+    }
+    int64_t tuplesLeft = PersistentTable::TICK_ZONE_MAX_TUPLES;
+    BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
+        PersistentTable* table = cd.second->getPersistentTable();
+        if (table == NULL) {
+            continue;
+        }
+        tuplesLeft -= table->summarizeZonesIncrementally(tuplesLeft);
+        if (tuplesLeft <= 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * Give back up to TICK_RECLAIM_MAX_BYTES of the blocks of truncated tables,
+ * deleting each table once its blocks are gone. Its indexes go with it.
+ */
+void VoltDBEngine::reclaimTables() {
+    int64_t bytesLeft = PersistentTable::TICK_RECLAIM_MAX_BYTES;
+    while (!m_tablesToReclaim.empty() && bytesLeft > 0) {
+        PersistentTable *table = m_tablesToReclaim.front();
+        const int64_t bytesBefore = table->allocatedTupleMemory();
+        if (!table->freeBlocksIncrementally(bytesLeft)) {
+            break;
+        }
+        bytesLeft -= bytesBefore;
+        m_tablesToReclaim.pop_front();
+        table->decrementRefcount();
+    }
+}
+
+void VoltDBEngine::evictIdleTupleBlocks() {
+    if (m_coldStorage == NULL) {
+        return;
+    }
+    std::vector<PersistentTable*> tables;
+    BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
+        PersistentTable* table = cd.second->getPersistentTable();
+        if (table != NULL) {
+            tables.push_back(table);
+        }
+    }
+    m_coldStorage->evictIdleBlocks(tables, ColdStorage::TICK_MAX_EVICTIONS);
 }
 
 /** Bring the Export and DR system to a steady state with no pending committed data */
@@ -1567,6 +1860,7 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 locatorIds, interval, now);
             break;
         case STATISTICS_SELECTOR_TYPE_INDEX:
+        case STATISTICS_SELECTOR_TYPE_INDEXUSAGE:
             for (int ii = 0; ii < numLocators; ii++) {
                 CatalogId locator = static_cast<CatalogId>(locators[ii]);
                 if ( ! getTable(locator)) {
@@ -1583,6 +1877,13 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 (StatisticsSelectorType) selector,
                 locatorIds, interval, now);
             break;
+        case STATISTICS_SELECTOR_TYPE_PLANNODE:
+            // Plan fragments are not catalog items; the locators are ignored.
+            resultTable = getExecutorStats(interval, now);
+            break;
+        case STATISTICS_SELECTOR_TYPE_LATENCY:
+            resultTable = getLatencyStats(interval, now);
+            break;
         default:
             char message[256];
             snprintf(message, 256, "getStats() called with an unrecognized selector"
@@ -1607,6 +1908,101 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
 }
 
 
+Table* VoltDBEngine::getExecutorStats(bool interval, int64_t now)
+{
+    if ( ! m_executorStatsTable) {
+        m_executorStatsTable.reset(ExecutorStats::generateEmptyExecutorStatsTable());
+    }
+    m_executorStatsTable->deleteAllTempTuples();
+    if ( ! m_plans) {
+        return m_executorStatsTable.get();
+    }
+
+    // The base stats columns, as StatsSource fills them in.
+    TableTuple tuple = m_executorStatsTable->tempTuple();
+    tuple.setNValue(0, ValueFactory::getBigIntValue(now));
+    tuple.setNValue(1, ValueFactory::getIntegerValue(static_cast<int32_t>(m_executorContext->m_hostId)));
+    tuple.setNValue(2, ValueFactory::getTempStringValue(m_executorContext->m_hostname));
+    tuple.setNValue(3, ValueFactory::getIntegerValue(static_cast<int32_t>(m_siteId >> 32)));
+    tuple.setNValue(4, ValueFactory::getBigIntValue(m_partitionId));
+
+    BOOST_FOREACH (boost::shared_ptr<ExecutorVector> ev_guard, *m_plans) {
+        ev_guard->addExecutorStats(m_executorStatsTable.get(), tuple, interval);
+    }
+    return m_executorStatsTable.get();
+}
+
+Table* VoltDBEngine::getLatencyStats(bool interval, int64_t now)
+{
+    if ( ! m_latencyStatsTable) {
+        m_latencyStatsTable.reset(LatencyStats::generateEmptyLatencyStatsTable());
+    }
+    m_latencyStatsTable->deleteAllTempTuples();
+
+    TableTuple tuple = m_latencyStatsTable->tempTuple();
+    tuple.setNValue(0, ValueFactory::getBigIntValue(now));
+    tuple.setNValue(1, ValueFactory::getIntegerValue(static_cast<int32_t>(m_executorContext->m_hostId)));
+    tuple.setNValue(2, ValueFactory::getTempStringValue(m_executorContext->m_hostname));
+    tuple.setNValue(3, ValueFactory::getIntegerValue(static_cast<int32_t>(m_siteId >> 32)));
+    tuple.setNValue(4, ValueFactory::getBigIntValue(m_partitionId));
+
+    m_executorContext->latencyStats().addStatsRows(m_latencyStatsTable.get(), &tuple, interval);
+    return m_latencyStatsTable.get();
+}
+
+void VoltDBEngine::getMemoryDetail(int64_t counters[MEMORY_DETAIL_COUNT]) const
+{
+    int64_t relocatable = 0;
+    std::vector<ThreadLocalPool::RelocatableSizeClassStats> sizeClasses = ThreadLocalPool::getRelocatableStats();
+    BOOST_FOREACH (const ThreadLocalPool::RelocatableSizeClassStats& sizeClass, sizeClasses) {
+        relocatable += sizeClass.m_bytesAllocated;
+    }
+    counters[MEMORY_DETAIL_POOL_EXACT_SIZED] = ThreadLocalPool::getPoolAllocationSize() - relocatable;
+    counters[MEMORY_DETAIL_POOL_RELOCATABLE] = relocatable;
+
+    int64_t tempTable = 0;
+    int64_t tempTablePeak = 0;
+    if (m_plans) {
+        BOOST_FOREACH (const boost::shared_ptr<ExecutorVector>& plan, m_plans->get<0>()) {
+            tempTable += plan->limits().getAllocated();
+            tempTablePeak = std::max(tempTablePeak, plan->limits().getPeakMemoryInBytes());
+        }
+    }
+    counters[MEMORY_DETAIL_TEMP_TABLE] = tempTable;
+    counters[MEMORY_DETAIL_TEMP_TABLE_PEAK] = tempTablePeak;
+
+    counters[MEMORY_DETAIL_UNDO] = m_undoLog.getSize();
+
+    int64_t exportPending = 0;
+    BOOST_FOREACH (const LabeledStream& table, m_exportingTables) {
+        exportPending += table.second->pendingExportBytes();
+    }
+    counters[MEMORY_DETAIL_EXPORT_PENDING] = exportPending;
+
+    int64_t drPending = 0;
+    if (m_executorContext->drStream()) {
+        drPending += m_executorContext->drStream()->pendingByteCount();
+    }
+    if (m_executorContext->drReplicatedStream()) {
+        drPending += m_executorContext->drReplicatedStream()->pendingByteCount();
+    }
+    counters[MEMORY_DETAIL_DR_PENDING] = drPending;
+
+    counters[MEMORY_DETAIL_PLAN_CACHE] = m_plansMemoryEstimate;
+
+    int64_t snapshotCopies = 0;
+    typedef std::pair<int32_t, PersistentTable*> TIDTablePair;
+    BOOST_FOREACH (const TIDTablePair& table, m_snapshottingTables) {
+        snapshotCopies += table.second->snapshotCopyMemory();
+    }
+    counters[MEMORY_DETAIL_SNAPSHOT_COPIES] = snapshotCopies;
+}
+
+void VoltDBEngine::setLatencySampleInterval(int32_t sampleInterval)
+{
+    m_executorContext->latencyStats().setSampleInterval(sampleInterval);
+}
+
 void VoltDBEngine::setCurrentUndoQuantum(voltdb::UndoQuantum* undoQuantum)
 {
     m_currentUndoQuantum = undoQuantum;
@@ -1903,12 +2299,14 @@ void VoltDBEngine::dispatchValidatePartitioningTask(ReferenceSerializeInputBE &t
     HashinatorType type = static_cast<HashinatorType>(taskInfo.readInt());
     const char *config = taskInfo.getRawPointer();
     TheHashinator* hashinator;
+    size_t configLength = sizeof(int32_t);
     switch(type) {
         case HASHINATOR_LEGACY:
             hashinator = LegacyHashinator::newInstance(config);
             break;
         case HASHINATOR_ELASTIC:
             hashinator = ElasticHashinator::newInstance(config, NULL, 0);
+            configLength += ReferenceSerializeInputBE(config, sizeof(int32_t)).readInt() * 2 * sizeof(int32_t);
             break;
         default:
             throwFatalException("Unknown hashinator type %d", type);
@@ -1917,6 +2315,13 @@ void VoltDBEngine::dispatchValidatePartitioningTask(ReferenceSerializeInputBE &t
     // Delete at earliest convenience
     boost::scoped_ptr<TheHashinator> hashinator_guard(hashinator);
 
+    std::string typeAndConfig(reinterpret_cast<const char*>(&type), sizeof(type));
+    typeAndConfig.append(config, configLength);
+    if (typeAndConfig != m_validatedHashinatorConfig) {
+        m_validatedHashinatorConfig.swap(typeAndConfig);
+        m_validatedHashinatorEpoch++;
+    }
+
     std::vector<int64_t> mispartitionedRowCounts;
 
     BOOST_FOREACH (CatalogId tableId, tableIds) {
@@ -1925,7 +2330,8 @@ void VoltDBEngine::dispatchValidatePartitioningTask(ReferenceSerializeInputBE &t
             throwFatalException("Unknown table id %d", tableId);
         }
         Table* found = table->second;
-        mispartitionedRowCounts.push_back(found->validatePartitioning(hashinator, m_partitionId));
+        mispartitionedRowCounts.push_back(found->validatePartitioning(hashinator, m_partitionId,
+                                                                      m_validatedHashinatorEpoch));
     }
 
     m_resultOutput.writeInt(static_cast<int32_t>(sizeof(int64_t) * numTables));
@@ -1999,15 +2405,19 @@ void VoltDBEngine::executeTask(TaskType taskType, ReferenceSerializeInputBE &tas
     }
     case TASK_TYPE_SET_DR_PROTOCOL_VERSION: {
         uint32_t drVersion = taskInfo.readInt();
-        if (drVersion != DRTupleStream::PROTOCOL_VERSION) {
+        if (drVersion < DRTupleStream::COORDINATED_MP_PROTOCOL_VERSION ||
+            drVersion > DRTupleStream::PROTOCOL_VERSION) {
             m_executorContext->setDrStream(m_compatibleDRStream);
             if (m_compatibleDRReplicatedStream) {
                 m_executorContext->setDrReplicatedStream(m_compatibleDRReplicatedStream);
             }
         }
         else {
+            // Versions before CHANGED_COLUMNS_PROTOCOL_VERSION only lack a record type
+            m_drStream->setProtocolVersion(static_cast<uint8_t>(drVersion));
             m_executorContext->setDrStream(m_drStream);
             if (m_drReplicatedStream) {
+                m_drReplicatedStream->setProtocolVersion(static_cast<uint8_t>(drVersion));
                 m_executorContext->setDrReplicatedStream(m_drReplicatedStream);
             }
         }
@@ -2040,6 +2450,11 @@ void VoltDBEngine::executeTask(TaskType taskType, ReferenceSerializeInputBE &tas
 
 void VoltDBEngine::executePurgeFragment(PersistentTable* table) {
     boost::shared_ptr<ExecutorVector> pev = table->getPurgeExecutorVector();
+    if (pev.get() == NULL) {
+        std::string jsonPlan = getTopend()->decodeBase64AndDecompress(table->getPurgePlan());
+        pev = ExecutorVector::fromJsonPlan(this, jsonPlan, -1);
+        table->swapPurgeExecutorVector(pev);
+    }
 
     // Push a new frame onto the stack for this executor vector
     // to report its tuples modified.  We don't want to actually
@@ -54,14 +54,17 @@
 #include "logging/LogManager.h"
 #include "logging/LogProxy.h"
 #include "logging/StdoutLogProxy.h"
+#include "stats/StackSampler.h"
 #include "stats/StatsAgent.h"
 #include "storage/AbstractDRTupleStream.h"
+#include "storage/DRTupleStream.h"
 #include "storage/BinaryLogSinkWrapper.h"
 
 #include "boost/scoped_ptr.hpp"
 #include "boost/unordered_map.hpp"
 
 #include <cassert>
+#include <deque>
 #include <map>
 #include <stack>
 #include <string>
@@ -72,6 +75,7 @@
 #define ENGINE_ERRORCODE_ERROR 1
 
 #define MAX_BATCH_COUNT 1000
+#define TXN_BATCH_INFO_FIELDS 6 // keep in synch with value in ExecutionEngineJNI.java
 #define MAX_PARAM_COUNT 1025 // keep in synch with value in CompiledPlan.java
 
 namespace catalog {
@@ -84,6 +88,9 @@ namespace voltdb {
 
 class AbstractExecutor;
 class AbstractPlanNode;
+class ColdStorage;
+class TempBlockCache;
+class TempTableSpill;
 class EnginePlanSet;  // Locally defined in VoltDBEngine.cpp
 class ExecutorContext;
 class ExecutorVector;
@@ -92,6 +99,7 @@ class RecoveryProtoMsg;
 class StreamedTable;
 class Table;
 class TableCatalogDelegate;
+class TempTable;
 class TempTableLimits;
 class Topend;
 class TheHashinator;
@@ -117,7 +125,15 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                         int32_t defaultDrBufferSize,
                         int64_t tempTableMemoryLimit,
                         bool createDrReplicatedStream,
-                        int32_t compactionThreshold = 95);
+                        int32_t compactionThreshold = 95,
+                        std::string coldStorageDirectory = "",
+                        int64_t maxResidentTupleBlockMemory = 0,
+                        std::string tempTableSpillDirectory = "",
+                        int32_t slowFragmentMillis = 0,
+                        bool redactSlowFragmentParameters = false,
+                        int32_t stackSampleHz = 0,
+                        int32_t packedStringMaxLength = 0,
+                        int32_t loadHelperThreads = 0);
         virtual ~VoltDBEngine();
 
         // ------------------------------------------------------------------
@@ -160,6 +176,24 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                                  int64_t uniqueId,
                                  int64_t undoToken);
 
+        /**
+         * Execute the fragment batches of several single-partition
+         * transactions in turn, each as executePlanFragments would.
+         * transactionInfo holds TXN_BATCH_INFO_FIELDS values per
+         * transaction: its fragment count, txnId, spHandle,
+         * lastCommittedSpHandle, uniqueId and undoToken. The transactions'
+         * fragment ids are back to back in planfragmentIds, and their
+         * parameters follow one another in serialize_in. Each completed
+         * transaction leaves its own result section in the result buffer.
+         * Execution stops at the first transaction to fail, whose
+         * exception is serialized as usual. Returns the number of
+         * transactions that completed.
+         */
+        int executeTransactionBatch(int32_t numTransactions,
+                                    const int64_t transactionInfo[],
+                                    int64_t planfragmentIds[],
+                                    ReferenceSerializeInputBE &serialize_in);
+
         /**
          * Execute a single, top-level plan fragment.  This method is
          * used both internally to execute fragments in a batch, and
@@ -305,6 +339,14 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         /** Perform once per second, non-transactional work. */
         void tick(int64_t timeInMillis, int64_t lastCommittedSpHandle);
 
+        /**
+         * Take the last reference to a table dropped by a truncate, and free
+         * it a bounded amount per tick rather than all at once.
+         */
+        void reclaimTableIncrementally(PersistentTable *table) {
+            m_tablesToReclaim.push_back(table);
+        }
+
         /** flush active work (like EL buffers) */
         void quiesce(int64_t lastCommittedSpHandle);
 
@@ -339,10 +381,44 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                 bool interval,
                 int64_t now);
 
+        /**
+         * Fill counters, indexed by MemoryDetailType, with the bytes held
+         * by the parts of this engine that the table and index stats do
+         * not cover. The pool counters are those of the calling thread.
+         */
+        void getMemoryDetail(int64_t counters[MEMORY_DETAIL_COUNT]) const;
+
+        /**
+         * Time one in every sampleInterval events at each latency point,
+         * or none with 0.
+         */
+        void setLatencySampleInterval(int32_t sampleInterval);
+
+        /**
+         * Log the fragments that run for at least thresholdNanos, or none
+         * with 0, leaving their parameter values out if asked to.
+         */
+        void setSlowFragmentThreshold(int64_t thresholdNanos, bool redactParameters) {
+            m_slowFragmentNanos = thresholdNanos;
+            m_redactSlowFragmentParameters = redactParameters;
+        }
+
+        /**
+         * The native stacks sampled on this engine's thread since the last
+         * call, as "outer;...;inner count" lines. See StackSampler.
+         */
+        std::string getNativeStacks() { return m_stackSampler.takeFoldedStacks(); }
+
         Pool* getStringPool() { return &m_stringPool; }
 
         LogManager* getLogManager() { return &m_logManager; }
 
+        /**
+         * Start a new undo quantum for the token, unless it is the current
+         * one. INT64_MAX starts none: between transactions, when there is
+         * no current quantum, the fragments then write without undo, and
+         * nothing they do can be rolled back.
+         */
         void setUndoToken(int64_t nextUndoToken)
         {
             if (nextUndoToken == INT64_MAX) {
@@ -455,6 +531,13 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         void rebuildTableCollections();
 
+        /*
+         * Re-register the table of one delegate, after it has been given a
+         * new table object, without rebuilding the collections of every
+         * other table.  Truncation swaps tables this way.
+         */
+        void rebuildTableCollections(TableCatalogDelegate *tcd);
+
         int64_t tempTableMemoryLimit() const {
             return m_tempTableMemoryLimit;
         }
@@ -463,6 +546,16 @@ class __attribute__((visibility("default"))) VoltDBEngine {
             return (m_tempTableMemoryLimit * 3) / 4;
         }
 
+        /** The site's temp table spill file, or NULL if there is none. */
+        TempTableSpill* tempTableSpill() const {
+            return m_tempTableSpill;
+        }
+
+        /** The site's free temp table block storage. */
+        TempBlockCache* tempBlockCache() const {
+            return m_tempBlockCache;
+        }
+
         int32_t getPartitionId() const {
             return m_partitionId;
         }
@@ -478,8 +571,32 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         void collectDRTupleStreamStateInfo();
 
+        /** Delete a batch of each TTL table's rows that have expired by the tick's time. */
+        void expireRows(int64_t timeInMillis);
+
+        /** Compact fragmented tables within the per-tick budget. */
+        void compactTablesIncrementally();
+
+        /** Move clustered tables' rows into primary key order within the per-tick budget. */
+        void clusterTablesIncrementally();
+
+        /** Summarize the blocks whose zone maps are stale within the per-tick budget. */
+        void summarizeZonesIncrementally();
+
+        /** Move the idlest tuple blocks to cold storage, if it is configured. */
+        void evictIdleTupleBlocks();
+
+        /** Free the blocks of truncated tables within the per-tick budget. */
+        void reclaimTables();
+
         void setCurrentUndoQuantum(voltdb::UndoQuantum* undoQuantum);
 
+        /** A row of executor stats for each plan node of the cached plans. */
+        Table* getExecutorStats(bool interval, int64_t now);
+
+        /** A row of the site's sampled latencies for each latency point. */
+        Table* getLatencyStats(bool interval, int64_t now);
+
         // -------------------------------------------------
         // Initialization Functions
         // -------------------------------------------------
@@ -489,6 +606,9 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                                                                   TABLE *table);
         bool updateCatalogDatabaseReference();
         void resetDRConflictStreamedTables();
+
+        // Add one delegate's table to the table maps and stats sources.
+        void addTableToCollections(TableCatalogDelegate *tcd);
         /**
          * Call into the topend with information about how executing a plan fragment is going.
          */
@@ -517,6 +637,13 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         bool checkTempTableCleanup(ExecutorVector * execsForFrag);
         void resetExecutionMetadata(ExecutorVector* executorVector);
 
+        /**
+         * Log a fragment that ran for at least the slow fragment threshold,
+         * with the time and row counts of each of its plan nodes and its
+         * parameters, unless they are to be redacted.
+         */
+        void logSlowFragment(int64_t fragmentId, int64_t nanos, int64_t tuplesModified);
+
         // -------------------------------------------------
         // Data Members
         // -------------------------------------------------
@@ -530,6 +657,10 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         PlanNodeType m_lastAccessedPlanNodeType;
 
         boost::scoped_ptr<EnginePlanSet> m_plans;
+        // The memory the cached plans hold on to, by their estimates.
+        int64_t m_plansMemoryEstimate;
+        boost::scoped_ptr<TempTable> m_executorStatsTable;
+        boost::scoped_ptr<TempTable> m_latencyStatsTable;
         voltdb::UndoLog m_undoLog;
         voltdb::UndoQuantum *m_currentUndoQuantum;
 
@@ -564,6 +695,12 @@ class __attribute__((visibility("default"))) VoltDBEngine {
          */
         std::map<int32_t, PersistentTable*> m_snapshottingTables;
 
+        /*
+         * Tables dropped by truncates whose memory is given back on the
+         * tick, oldest first. The engine holds their last reference.
+         */
+        std::deque<PersistentTable*> m_tablesToReclaim;
+
         /*
          * Map of table signatures to exporting tables.
          */
@@ -653,6 +790,28 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         int32_t m_compactionThreshold;
 
+        // Where tuple blocks go when they no longer fit in memory, or NULL.
+        ColdStorage *m_coldStorage;
+
+        // Where temp table blocks over the temp table memory limit go, or NULL.
+        TempTableSpill *m_tempTableSpill;
+
+        // Temp table block storage kept between fragment executions.
+        TempBlockCache *m_tempBlockCache;
+
+        // Fragments that run at least this long are logged, unless it is 0.
+        int64_t m_slowFragmentNanos;
+        bool m_redactSlowFragmentParameters;
+
+        // Samples the native stack of the thread that initialized the engine
+        StackSampler m_stackSampler;
+
+        // The last hashinator configuration @ValidatePartitioning checked
+        // against, and a number that changes with it, so that tables can
+        // skip the blocks found correct under it since their last change.
+        std::string m_validatedHashinatorConfig;
+        int64_t m_validatedHashinatorEpoch;
+
         /*
          * DR conflict streamed tables
          */
@@ -662,8 +821,8 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         //Stream of DR data generated by this engine, don't use them directly unless you know which mode
         //are we running now, use m_executorContext->drStream() and m_executorContext->drReplicatedStream()
         //instead.
-        AbstractDRTupleStream *m_drStream;
-        AbstractDRTupleStream *m_drReplicatedStream;
+        DRTupleStream *m_drStream;
+        DRTupleStream *m_drReplicatedStream;
         AbstractDRTupleStream *m_compatibleDRStream;
         AbstractDRTupleStream *m_compatibleDRReplicatedStream;
 
@@ -0,0 +1,143 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "executors/ExecutorStats.h"
+#include "common/tabletuple.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "plannodes/abstractplannode.h"
+#include "stats/StatsSource.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+namespace {
+    // The executor stats columns follow the base stats columns.
+    const int EXECUTOR_STATS_COLUMN_COUNT = 8;
+}
+
+vector<string> ExecutorStats::generateExecutorStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("FRAGMENT_ID");
+    columnNames.push_back("PLAN_NODE_ID");
+    columnNames.push_back("PLAN_NODE_TYPE");
+    columnNames.push_back("INVOCATIONS");
+    columnNames.push_back("EXECUTION_NANOS");
+    columnNames.push_back("TUPLES_IN");
+    columnNames.push_back("TUPLES_OUT");
+    columnNames.push_back("MAX_TEMP_TABLE_BYTES");
+
+    return columnNames;
+}
+
+void ExecutorStats::populateExecutorStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+
+    // fragment id
+    types.push_back(VALUE_TYPE_BIGINT);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node id
+    types.push_back(VALUE_TYPE_INTEGER);
+    columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // plan node type; sized in bytes, so it is short enough to be stored
+    // inline in the row and the row does not keep the value's storage
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(32);
+    allowNull.push_back(false);
+    inBytes.push_back(true);
+
+    // invocations, execution time, tuples in and out, and temp table bytes
+    for (int ii = 0; ii < EXECUTOR_STATS_COLUMN_COUNT - 3; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        allowNull.push_back(false);
+        inBytes.push_back(false);
+    }
+}
+
+TempTable* ExecutorStats::generateEmptyExecutorStatsTable() {
+    string name = "Plan fragment executor stats temp table";
+    vector<string> columnNames = ExecutorStats::generateExecutorStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    ExecutorStats::populateExecutorStatsSchema(columnTypes, columnLengths,
+                                               columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+ExecutorStats::ExecutorStats()
+    : m_invocations(0), m_nanos(0), m_tuplesIn(0), m_tuplesOut(0), m_maxTempTableBytes(0),
+      m_lastInvocations(0), m_lastNanos(0), m_lastTuplesIn(0), m_lastTuplesOut(0),
+      m_intervalMaxTempTableBytes(0),
+      m_latestNanos(0), m_latestTuplesIn(0), m_latestTuplesOut(0)
+{
+}
+
+void ExecutorStats::updateStatsTuple(TableTuple *tuple, int64_t fragmentId,
+                                     const AbstractPlanNode* node, bool interval) {
+    int64_t invocations = m_invocations;
+    int64_t nanos = m_nanos;
+    int64_t tuplesIn = m_tuplesIn;
+    int64_t tuplesOut = m_tuplesOut;
+    int64_t maxTempTableBytes = m_maxTempTableBytes;
+
+    if (interval) {
+        invocations -= m_lastInvocations;
+        nanos -= m_lastNanos;
+        tuplesIn -= m_lastTuplesIn;
+        tuplesOut -= m_lastTuplesOut;
+        maxTempTableBytes = m_intervalMaxTempTableBytes;
+        m_lastInvocations = m_invocations;
+        m_lastNanos = m_nanos;
+        m_lastTuplesIn = m_tuplesIn;
+        m_lastTuplesOut = m_tuplesOut;
+        m_intervalMaxTempTableBytes = 0;
+    }
+
+    int column = tuple->sizeInValues() - EXECUTOR_STATS_COLUMN_COUNT;
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(fragmentId));
+    tuple->setNValue(column++, ValueFactory::getIntegerValue(node->getPlanNodeId()));
+    NValue nodeType = ValueFactory::getStringValue(planNodeToString(node->getPlanNodeType()));
+    tuple->setNValue(column++, nodeType);
+    nodeType.free();
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(invocations));
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(nanos));
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(tuplesIn));
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(tuplesOut));
+    tuple->setNValue(column++, ValueFactory::getBigIntValue(maxTempTableBytes));
+}
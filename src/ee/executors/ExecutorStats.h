@@ -0,0 +1,123 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EXECUTORSTATS_H_
+#define EXECUTORSTATS_H_
+
+#include "common/types.h"
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <time.h>
+
+namespace voltdb {
+class AbstractPlanNode;
+class TableTuple;
+class TempTable;
+
+/**
+ * Counters for the executions of one plan node in a cached fragment:
+ * how often it ran, for how long, the rows it was handed by its children
+ * and produced, and the largest its output temp table grew. Rows of
+ * persistent tables read by scans are not counted as handed in.
+ *
+ * Unlike the table and index stats this is not a StatsSource; the
+ * engine adds a row per plan node of each cached plan to a single table.
+ */
+class ExecutorStats {
+public:
+    /**
+     * Static method to generate the column names for the tables which
+     * contain executor stats.
+     */
+    static std::vector<std::string> generateExecutorStatsColumnNames();
+
+    /**
+     * Static method to generate the remaining schema information for
+     * the tables which contain executor stats.
+     */
+    static void populateExecutorStatsSchema(std::vector<voltdb::ValueType>& types,
+                                            std::vector<int32_t>& columnLengths,
+                                            std::vector<bool>& allowNull,
+                                            std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyExecutorStatsTable();
+
+    /** A monotonic clock reading, in nanoseconds, for timing executions. */
+    static int64_t nowNanos() {
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    ExecutorStats();
+
+    void record(int64_t nanos, int64_t tuplesIn, int64_t tuplesOut, int64_t tempTableBytes) {
+        m_latestNanos = nanos;
+        m_latestTuplesIn = tuplesIn;
+        m_latestTuplesOut = tuplesOut;
+        ++m_invocations;
+        m_nanos += nanos;
+        m_tuplesIn += tuplesIn;
+        m_tuplesOut += tuplesOut;
+        if (tempTableBytes > m_maxTempTableBytes) {
+            m_maxTempTableBytes = tempTableBytes;
+        }
+        if (tempTableBytes > m_intervalMaxTempTableBytes) {
+            m_intervalMaxTempTableBytes = tempTableBytes;
+        }
+    }
+
+    /**
+     * Fill in the executor stats columns of a row for the plan node. With
+     * interval, the counters are those since the last interval request.
+     * The caller fills in the base stats columns.
+     */
+    void updateStatsTuple(TableTuple* tuple, int64_t fragmentId,
+                          const AbstractPlanNode* node, bool interval);
+
+    /** The time and row counts of the most recent execution, for the slow fragment log. */
+    int64_t latestNanos() const { return m_latestNanos; }
+    int64_t latestTuplesIn() const { return m_latestTuplesIn; }
+    int64_t latestTuplesOut() const { return m_latestTuplesOut; }
+
+private:
+    int64_t m_invocations;
+    int64_t m_nanos;
+    int64_t m_tuplesIn;
+    int64_t m_tuplesOut;
+    int64_t m_maxTempTableBytes;
+
+    // The counters at the last interval request, and the largest output
+    // temp table since then.
+    int64_t m_lastInvocations;
+    int64_t m_lastNanos;
+    int64_t m_lastTuplesIn;
+    int64_t m_lastTuplesOut;
+    int64_t m_intervalMaxTempTableBytes;
+
+    int64_t m_latestNanos;
+    int64_t m_latestTuplesIn;
+    int64_t m_latestTuplesOut;
+};
+
+}
+
+#endif /* EXECUTORSTATS_H_ */
@@ -51,6 +51,7 @@
 #include "common/tabletuple.h"
 #include "executors/OptimizedProjector.hpp"
 #include "expressions/abstractexpression.h"
+#include "expressions/commonsubexpression.h"
 #include "expressions/tuplevalueexpression.h"
 
 namespace voltdb {
@@ -407,8 +408,10 @@ static ProjectStepSet coalesceMemcpys(const TupleSchema* dstSchema,
     return outputSteps;
 }
 
-OptimizedProjector::OptimizedProjector(const std::vector<AbstractExpression*>& exprs)
+OptimizedProjector::OptimizedProjector(const std::vector<AbstractExpression*>& exprs,
+                                       CommonSubexpressions* commonSubexpressions)
     : m_steps(new ProjectStepSet())
+    , m_commonSubexpressions(commonSubexpressions)
 {
     int i = 0;
     BOOST_FOREACH(AbstractExpression *e, exprs) {
@@ -419,11 +422,13 @@ OptimizedProjector::OptimizedProjector(const std::vector<AbstractExpression*>& e
 
 OptimizedProjector::OptimizedProjector()
     : m_steps(new ProjectStepSet())
+    , m_commonSubexpressions(NULL)
 {
 }
 
 OptimizedProjector::OptimizedProjector(const OptimizedProjector& that)
     : m_steps(new ProjectStepSet(*that.m_steps))
+    , m_commonSubexpressions(that.m_commonSubexpressions)
 {
 }
 
@@ -431,6 +436,7 @@ OptimizedProjector& OptimizedProjector::operator= (const OptimizedProjector& rhs
     OptimizedProjector rhsCopy(rhs);
 
     m_steps.swap(rhsCopy.m_steps);
+    m_commonSubexpressions = rhsCopy.m_commonSubexpressions;
 
     return *this;
 }
@@ -452,6 +458,7 @@ void OptimizedProjector::optimize(const TupleSchema* dstSchema,
 }
 
 void OptimizedProjector::exec(TableTuple& dstTuple, const TableTuple& srcTuple) const {
+    CommonSubexpressions::RowScope row(m_commonSubexpressions);
     BOOST_FOREACH(const ProjectStep& step, *m_steps) {
         step.exec(dstTuple, srcTuple);
     }
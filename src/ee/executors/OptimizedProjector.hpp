@@ -56,6 +56,7 @@
 namespace voltdb {
 
 // Forward declarations
+class CommonSubexpressions;
 class TableTuple;
 class TupleSchema;
 class ProjectStep;
@@ -78,8 +79,12 @@ public:
      *
      * To get the optimized projection, call the optimize method before
      * calling exec.
+     *
+     * If the expressions share subexpressions, each exec evaluates
+     * those once.
      */
-    OptimizedProjector(const std::vector<AbstractExpression*>& exprs);
+    OptimizedProjector(const std::vector<AbstractExpression*>& exprs,
+                       CommonSubexpressions* commonSubexpressions = NULL);
 
     /** Default constructor.  Produces an empty Projector that does nothing. */
     OptimizedProjector();
@@ -119,6 +124,9 @@ private:
 
     boost::scoped_ptr<ProjectStepSet> m_steps;
 
+    // Not owned; NULL when the expressions have nothing in common.
+    CommonSubexpressions* m_commonSubexpressions;
+
 };
 
 } // end namespace voltdb
@@ -178,6 +178,17 @@ void AbstractExecutor::setDMLCountOutputTable(TempTableLimits* limits) {
     m_abstractNode->setOutputTable(m_tmpOutputTable);
 }
 
+int64_t AbstractExecutor::inputTempTupleCount() const {
+    int64_t count = 0;
+    for (int ii = 0; ii < m_abstractNode->getInputTableCount(); ++ii) {
+        TempTable* input = dynamic_cast<TempTable*>(m_abstractNode->getInputTable(ii));
+        if (input) {
+            count += input->activeTupleCount();
+        }
+    }
+    return count;
+}
+
 AbstractExecutor::~AbstractExecutor() {}
 
 AbstractExecutor::TupleComparer::TupleComparer(const std::vector<AbstractExpression*>& keys,
@@ -48,8 +48,10 @@
 
 #include "common/InterruptException.h"
 #include "common/tabletuple.h"
+#include "common/Tracepoints.h"
 #include "common/types.h"
 #include "execution/VoltDBEngine.h"
+#include "executors/ExecutorStats.h"
 #include "plannodes/abstractplannode.h"
 #include "storage/temptable.h"
 
@@ -86,6 +88,9 @@ class AbstractExecutor {
      */
     inline AbstractPlanNode* getPlanNode() { return m_abstractNode; }
 
+    /** Counters for the executions of this executor's plan node. */
+    ExecutorStats& getExecutorStats() { return m_executorStats; }
+
     inline void cleanupTempOutputTable()
     {
         if (m_tmpOutputTable) {
@@ -154,6 +159,9 @@ class AbstractExecutor {
      */
     void setDMLCountOutputTable(TempTableLimits* limits);
 
+    /** The tuples handed in by child nodes, in the temp tables they produced. */
+    int64_t inputTempTupleCount() const;
+
     // execution engine owns the plannode allocation.
     AbstractPlanNode* m_abstractNode;
     TempTable* m_tmpOutputTable;
@@ -161,6 +169,8 @@ class AbstractExecutor {
     /** reference to the engine to call up to the top end */
     VoltDBEngine* m_engine;
 
+  private:
+    ExecutorStats m_executorStats;
 };
 
 
@@ -169,8 +179,25 @@ inline bool AbstractExecutor::execute(const NValueArray& params)
     assert(m_abstractNode);
     VOLT_TRACE("Starting execution of plannode(id=%d)...",  m_abstractNode->getPlanNodeId());
 
+    VOLT_PROBE2(executor__start, static_cast<int>(m_abstractNode->getPlanNodeType()),
+                m_abstractNode->getPlanNodeId());
+    int64_t tuplesIn = inputTempTupleCount();
+    int64_t startNanos = ExecutorStats::nowNanos();
+
     // run the executor
-    return p_execute(params);
+    bool result = p_execute(params);
+
+    int64_t tuplesOut = 0;
+    int64_t tempTableBytes = 0;
+    if (m_tmpOutputTable) {
+        tuplesOut = m_tmpOutputTable->activeTupleCount();
+        tempTableBytes = m_tmpOutputTable->allocatedTupleMemory();
+    }
+    m_executorStats.record(ExecutorStats::nowNanos() - startNanos,
+                           tuplesIn, tuplesOut, tempTableBytes);
+    VOLT_PROBE3(executor__done, static_cast<int>(m_abstractNode->getPlanNodeType()),
+                m_abstractNode->getPlanNodeId(), tuplesOut);
+    return result;
 }
 
 }
@@ -49,15 +49,19 @@
 #include "common/common.h"
 #include "common/debuglog.h"
 #include "common/SerializableEEException.h"
+#include "common/serializeio.h"
 #include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/limitnode.h"
+#include "storage/tablefactory.h"
 #include "storage/temptable.h"
 #include "storage/tableiterator.h"
 
 #include "boost/foreach.hpp"
 #include "boost/unordered_map.hpp"
 #include "hyperloglog/hyperloglog.hpp" // for APPROX_COUNT_DISTINCT
+#include "structures/TDigest.h" // for APPROX_PERCENTILE
 
 #include <algorithm>
 #include <cmath>
@@ -385,6 +389,205 @@ private:
     Pool* m_memoryPool;
 };
 
+/**
+ * SUM, COUNT, MIN or MAX of a fixed-width numeric column, or COUNT(*),
+ * advanced from the input tuple's storage rather than through the input
+ * expression and NValue arithmetic. The answers, and the overflow errors
+ * of SUM, are those of the general aggs.
+ */
+class FixedWidthAgg : public Agg
+{
+public:
+    FixedWidthAgg(ExpressionType aggType, ValueType columnType, uint32_t offset)
+        : m_aggType(aggType)
+        , m_columnType(columnType)
+        , m_offset(offset + TUPLE_HEADER_SIZE)
+        , m_count(0)
+        , m_integer(0)
+        , m_double(0)
+    {
+    }
+
+    /** Whether a column of the type can be aggregated from its storage. */
+    static bool supports(ExpressionType aggType, ValueType columnType)
+    {
+        switch (columnType) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_DOUBLE:
+            return true;
+        case VALUE_TYPE_TIMESTAMP:
+            return aggType != EXPRESSION_TYPE_AGGREGATE_SUM;
+        default:
+            return false;
+        }
+    }
+
+    virtual void advance(const NValue& val)
+    {
+        // Only ever advanced from tuple storage.
+        assert(false);
+    }
+
+    void advanceFromTuple(const char* tupleAddress)
+    {
+        if (m_aggType == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+            ++m_count;
+            return;
+        }
+        const char* data = tupleAddress + m_offset;
+        if (m_columnType == VALUE_TYPE_DOUBLE) {
+            advanceDouble(*reinterpret_cast<const double*>(data));
+            return;
+        }
+        int64_t value;
+        if (readInteger(data, value)) {
+            advanceInteger(value);
+        }
+    }
+
+    virtual NValue finalize(ValueType type)
+    {
+        if (m_aggType == EXPRESSION_TYPE_AGGREGATE_COUNT ||
+            m_aggType == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+            return ValueFactory::getBigIntValue(m_count).castAs(type);
+        }
+        if (m_count == 0) {
+            return ValueFactory::getNullValue().castAs(type);
+        }
+        return columnValue().castAs(type);
+    }
+
+    virtual void resetAgg()
+    {
+        m_haveAdvanced = false;
+        m_count = 0;
+    }
+
+private:
+    // Read a non-NULL integer, returning false for NULL.
+    bool readInteger(const char* data, int64_t& value) const
+    {
+        switch (m_columnType) {
+        case VALUE_TYPE_TINYINT:
+            value = *reinterpret_cast<const int8_t*>(data);
+            return value != INT8_NULL;
+        case VALUE_TYPE_SMALLINT:
+            value = *reinterpret_cast<const int16_t*>(data);
+            return value != INT16_NULL;
+        case VALUE_TYPE_INTEGER:
+            value = *reinterpret_cast<const int32_t*>(data);
+            return value != INT32_NULL;
+        default:
+            value = *reinterpret_cast<const int64_t*>(data);
+            return value != INT64_NULL;
+        }
+    }
+
+    void advanceInteger(int64_t value)
+    {
+        ++m_count;
+        if (m_count == 1) {
+            m_integer = value;
+            return;
+        }
+        switch (m_aggType) {
+        case EXPRESSION_TYPE_AGGREGATE_SUM:
+            if ((value > 0 && m_integer > INT64_MAX - value) ||
+                (value < 0 && m_integer < INT64_MIN - value)) {
+                // Let the NValue addition raise its overflow error.
+                ValueFactory::getBigIntValue(m_integer).op_add(ValueFactory::getBigIntValue(value));
+            }
+            m_integer += value;
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_MIN:
+            m_integer = std::min(m_integer, value);
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_MAX:
+            m_integer = std::max(m_integer, value);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // NValue comparisons put NaN before every other double.
+    static bool doubleLess(double lhs, double rhs)
+    {
+        if (std::isnan(lhs)) {
+            return !std::isnan(rhs);
+        }
+        return !std::isnan(rhs) && lhs < rhs;
+    }
+
+    void advanceDouble(double value)
+    {
+        if (value <= DOUBLE_NULL) {
+            return;
+        }
+        ++m_count;
+        if (m_count == 1) {
+            m_double = value;
+            return;
+        }
+        switch (m_aggType) {
+        case EXPRESSION_TYPE_AGGREGATE_SUM:
+            {
+                double sum = m_double + value;
+                if (!std::isfinite(sum)) {
+                    ValueFactory::getDoubleValue(m_double).op_add(ValueFactory::getDoubleValue(value));
+                }
+                m_double = sum;
+            }
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_MIN:
+            if (doubleLess(value, m_double)) {
+                m_double = value;
+            }
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_MAX:
+            if (doubleLess(m_double, value)) {
+                m_double = value;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // The SUM, MIN or MAX, as the general aggs would hold it.
+    NValue columnValue() const
+    {
+        if (m_columnType == VALUE_TYPE_DOUBLE) {
+            return ValueFactory::getDoubleValue(m_double);
+        }
+        if (m_aggType == EXPRESSION_TYPE_AGGREGATE_SUM || m_columnType == VALUE_TYPE_BIGINT) {
+            return ValueFactory::getBigIntValue(m_integer);
+        }
+        switch (m_columnType) {
+        case VALUE_TYPE_TINYINT:
+            return ValueFactory::getTinyIntValue(static_cast<int8_t>(m_integer));
+        case VALUE_TYPE_SMALLINT:
+            return ValueFactory::getSmallIntValue(static_cast<int16_t>(m_integer));
+        case VALUE_TYPE_INTEGER:
+            return ValueFactory::getIntegerValue(static_cast<int32_t>(m_integer));
+        default:
+            return ValueFactory::getTimestampValue(m_integer);
+        }
+    }
+
+    const ExpressionType m_aggType;
+    const ValueType m_columnType;
+    // Of the column from the start of the tuple, header included.
+    const uint32_t m_offset;
+    // Non-NULL values seen, or rows for COUNT(*).
+    int64_t m_count;
+    int64_t m_integer;
+    double m_double;
+};
+
 class ApproxCountDistinctAgg : public Agg {
 public:
     ApproxCountDistinctAgg()
@@ -505,11 +708,93 @@ public:
     }
 };
 
+class ApproxPercentileAgg : public Agg {
+public:
+    explicit ApproxPercentileAgg(double percentile)
+        : m_percentile(percentile)
+    {
+    }
+
+    virtual void advance(const NValue& val)
+    {
+        if (val.isNull()) {
+            return;
+        }
+        m_digest.add(ValuePeeker::peekDouble(val.castAs(VALUE_TYPE_DOUBLE)));
+    }
+
+    virtual NValue finalize(ValueType type)
+    {
+        if (m_digest.empty()) {
+            return NValue::getNullValue(VALUE_TYPE_DOUBLE);
+        }
+        m_value = ValueFactory::getDoubleValue(m_digest.quantile(m_percentile));
+        return m_value;
+    }
+
+    virtual void resetAgg()
+    {
+        m_digest.clear();
+        Agg::resetAgg();
+    }
+
+protected:
+    TDigest& digest() {
+        return m_digest;
+    }
+
+private:
+    const double m_percentile;
+    TDigest m_digest;
+};
+
+/// When APPROX_PERCENTILE is split across two fragments of a plan,
+/// this agg represents the bottom half of the agg.  Its finalize
+/// method produces a serialized t-digest to be accepted by a
+/// TDIGESTS_TO_PERCENTILE agg on the coordinator.
+class ValsToTDigestAgg : public ApproxPercentileAgg {
+public:
+    ValsToTDigestAgg()
+        : ApproxPercentileAgg(0.5)
+    {
+    }
+
+    virtual NValue finalize(ValueType type)
+    {
+        assert (type == VALUE_TYPE_VARBINARY);
+        CopySerializeOutput out;
+        digest().serializeTo(out);
+        return ValueFactory::getTempBinaryValue(out.data(), static_cast<int32_t>(out.size()));
+    }
+};
+
+/// When APPROX_PERCENTILE is split across two fragments of a plan,
+/// this agg represents the top half of the agg.  Its advance method
+/// merges the serialized t-digests from each partition.
+class TDigestsToPercentileAgg : public ApproxPercentileAgg {
+public:
+    explicit TDigestsToPercentileAgg(double percentile)
+        : ApproxPercentileAgg(percentile)
+    {
+    }
+
+    virtual void advance(const NValue& val)
+    {
+        assert (ValuePeeker::peekValueType(val) == VALUE_TYPE_VARBINARY);
+        assert (!val.isNull());
+
+        int32_t length;
+        const char* buf = ValuePeeker::peekObject_withoutNull(val, &length);
+        ReferenceSerializeInputBE in(buf, length);
+        digest().mergeFrom(in);
+    }
+};
+
 /*
  * Create an instance of an aggregator for the specified aggregate type and "distinct" flag.
  * The object is allocated from the provided memory pool.
  */
-inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDistinct)
+inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDistinct, double percentile)
 {
     switch (agg_type) {
     case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
@@ -539,6 +824,12 @@ inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDis
         return new (memoryPool) ValsToHyperLogLogAgg();
     case EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD:
         return new (memoryPool) HyperLogLogsToCardAgg();
+    case EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE:
+        return new (memoryPool) ApproxPercentileAgg(percentile);
+    case EXPRESSION_TYPE_AGGREGATE_VALS_TO_TDIGEST:
+        return new (memoryPool) ValsToTDigestAgg();
+    case EXPRESSION_TYPE_AGGREGATE_TDIGESTS_TO_PERCENTILE:
+        return new (memoryPool) TDigestsToPercentileAgg(percentile);
     default:
         {
             char message[128];
@@ -585,6 +876,7 @@ bool AggregateExecutorBase::p_init(AbstractPlanNode*, TempTableLimits* limits)
 
     m_aggTypes = node->getAggregates();
     m_distinctAggs = node->getDistinctAggregates();
+    m_aggPercentiles = node->getAggregatePercentiles();
     m_groupByExpressions = node->getGroupByExpressions();
     node->collectOutputExpressions(m_outputColumnExpressions);
 
@@ -659,7 +951,8 @@ inline void AggregateExecutorBase::initCountingPredicate(const NValueArray& para
 /// Helper method responsible for inserting the results of the
 /// aggregation into a new tuple in the output table as well as passing
 /// through any additional columns from the input table.
-inline bool AggregateExecutorBase::insertOutputTuple(AggregateRow* aggregateRow)
+inline bool AggregateExecutorBase::insertOutputTuple(AggregateRow* aggregateRow,
+                                                     const std::vector<int>* nullColumns)
 {
     if (!m_postfilter.isUnderLimit()) {
         return false;
@@ -680,6 +973,12 @@ inline bool AggregateExecutorBase::insertOutputTuple(AggregateRow* aggregateRow)
         tempTuple.setNValue(output_col_index,
                             m_outputColumnExpressions[output_col_index]->eval(&(aggregateRow->m_passThroughTuple)));
     }
+    if (nullColumns != NULL) {
+        BOOST_FOREACH(int output_col_index, *nullColumns) {
+            tempTuple.setNValue(output_col_index,
+                                NValue::getNullValue(tempTuple.getSchema()->columnType(output_col_index)));
+        }
+    }
 
     bool needInsert = m_postfilter.eval(&tempTuple, NULL);
     if (needInsert) {
@@ -708,7 +1007,7 @@ inline void AggregateExecutorBase::initAggInstances(AggregateRow* aggregateRow)
 {
     Agg** aggs = aggregateRow->m_aggregates;
     for (int ii = 0; ii < m_aggTypes.size(); ii++) {
-        aggs[ii] = getAggInstance(m_memoryPool, m_aggTypes[ii], m_distinctAggs[ii]);
+        aggs[ii] = getAggInstance(m_memoryPool, m_aggTypes[ii], m_distinctAggs[ii], m_aggPercentiles[ii]);
     }
 }
 
@@ -774,6 +1073,48 @@ void AggregateExecutorBase::p_execute_finish()
 
 AggregateHashExecutor::~AggregateHashExecutor() {}
 
+bool AggregateHashExecutor::p_init(AbstractPlanNode* abstract_node, TempTableLimits* limits)
+{
+    m_limits = limits;
+    bool result = AggregateExecutorBase::p_init(abstract_node, limits);
+
+    AggregatePlanNode* node = dynamic_cast<AggregatePlanNode*>(m_abstractNode);
+    const std::vector<std::vector<int> >& groupingSets = node->getGroupingSets();
+    if (!groupingSets.empty()) {
+        BOOST_FOREACH (const std::vector<int>& groupingSet, groupingSets) {
+            std::vector<bool> grouped(m_groupByExpressions.size(), false);
+            BOOST_FOREACH (int gbIdx, groupingSet) {
+                grouped[gbIdx] = true;
+            }
+            m_groupingSets.push_back(grouped);
+        }
+        m_groupingSetNullColumns = node->getGroupingSetNullColumns();
+        m_groupByValues.resize(m_groupByExpressions.size());
+
+        // The keys carry the index of their set after the group-by values.
+        std::vector<ValueType> columnTypes;
+        std::vector<int32_t> columnSizes;
+        std::vector<bool> columnAllowNull;
+        std::vector<bool> columnInBytes;
+        for (int ii = 0; ii < m_groupByKeySchema->columnCount(); ii++) {
+            const TupleSchema::ColumnInfo* info = m_groupByKeySchema->getColumnInfo(ii);
+            columnTypes.push_back(info->getVoltType());
+            columnSizes.push_back(info->length);
+            columnAllowNull.push_back(true);
+            columnInBytes.push_back(info->inBytes);
+        }
+        columnTypes.push_back(VALUE_TYPE_SMALLINT);
+        columnSizes.push_back(NValue::getTupleStorageSize(VALUE_TYPE_SMALLINT));
+        columnAllowNull.push_back(false);
+        columnInBytes.push_back(false);
+        TupleSchema::freeTupleSchema(m_groupByKeySchema);
+        m_groupByKeySchema = TupleSchema::createTupleSchema(columnTypes, columnSizes,
+                                                            columnAllowNull, columnInBytes);
+    }
+    m_hash.init(m_groupByKeySchema);
+    return result;
+}
+
 TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
                                                  ProgressMonitorProxy* pmp,
                                                  const TupleSchema * schema,
@@ -782,6 +1123,15 @@ TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
 {
     VOLT_TRACE("hash aggregate executor init..");
     m_hash.clear();
+    // Partitions left over from a failed execution.
+    m_spillPartitions.clear();
+    m_spillLevel = 0;
+    // A plan tends to make as many groups as it did the last time it ran,
+    // so start out with room for those rather than growing to them again.
+    if (m_peakGroups > 0) {
+        m_hash.reserve(m_peakGroups < MAX_RESERVED_GROUPS ? m_peakGroups : MAX_RESERVED_GROUPS);
+        m_peakGroups = 0;
+    }
 
     return AggregateExecutorBase::p_execute_init(params, pmp, schema, newTempTable, parentPostfilter);
 }
@@ -800,6 +1150,15 @@ bool AggregateHashExecutor::p_execute(const NValueArray& params)
 
     TableTuple nextTuple = AggregateHashExecutor::p_execute_init(params, &pmp, inputSchema, NULL);
 
+    // On the coordinator the input is the partitions' partial groups, so
+    // there are about as many groups as input rows when the groups are
+    // many. Size the table for them rather than growing it over and over.
+    const std::vector<AbstractPlanNode*>& children = m_abstractNode->getChildren();
+    if (children.size() == 1 && children[0]->getPlanNodeType() == PLAN_NODE_TYPE_RECEIVE) {
+        size_t groups = static_cast<size_t>(input_table->activeTupleCount());
+        m_hash.reserve(groups < MAX_RESERVED_GROUPS ? groups : MAX_RESERVED_GROUPS);
+    }
+
     VOLT_TRACE("looping..");
     while (it.next(nextTuple)) {
         assert(m_postfilter.isUnderLimit()); // hash aggregation can not early return for limit
@@ -813,17 +1172,59 @@ bool AggregateHashExecutor::p_execute(const NValueArray& params)
 
 void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
     m_pmp->countdownProgress();
+    if (!m_groupingSets.empty()) {
+        advanceGroupingSets(nextTuple);
+        return;
+    }
     initGroupByKeyTuple(nextTuple);
+    advanceGroup(nextTuple, 0);
+}
+
+void AggregateHashExecutor::advanceGroupingSets(const TableTuple& nextTuple) {
+    for (int ii = 0; ii < m_groupByExpressions.size(); ii++) {
+        m_groupByValues[ii] = m_groupByExpressions[ii]->eval(&nextTuple);
+    }
+    const int setColumn = static_cast<int>(m_groupByExpressions.size());
+    for (int groupingSet = 0; groupingSet < m_groupingSets.size(); groupingSet++) {
+        TableTuple& nextGroupByKeyTuple = m_nextGroupByKeyStorage;
+        if (nextGroupByKeyTuple.isNullTuple()) {
+            m_nextGroupByKeyStorage.allocateActiveTuple();
+        }
+        const std::vector<bool>& grouped = m_groupingSets[groupingSet];
+        for (int ii = 0; ii < setColumn; ii++) {
+            if (grouped[ii]) {
+                nextGroupByKeyTuple.setNValue(ii, m_groupByValues[ii]);
+            }
+            else {
+                nextGroupByKeyTuple.setNValue(ii, NValue::getNullValue(m_groupByKeySchema->columnType(ii)));
+            }
+        }
+        nextGroupByKeyTuple.setNValue(setColumn,
+                                      ValueFactory::getSmallIntValue(static_cast<int16_t>(groupingSet)));
+        advanceGroup(nextTuple, groupingSet);
+    }
+}
+
+void AggregateHashExecutor::advanceGroup(const TableTuple& nextTuple, int groupingSet) {
     AggregateRow* aggregateRow;
     TableTuple& nextGroupByKeyTuple = m_nextGroupByKeyStorage;
     // Search for the matching group.
-    HashAggregateMapType::const_iterator keyIter = m_hash.find(nextGroupByKeyTuple);
-
-    // Group not found. Make a new entry in the hash for this new group.
-    if (keyIter == m_hash.end()) {
+    size_t hash;
+    aggregateRow = m_hash.find(nextGroupByKeyTuple, hash);
+
+    // Group not found. Make a new entry in the hash for this new group,
+    // unless the groups have outgrown their share of the temp table memory.
+    // A tuple may not be spilled for just some of its grouping sets.
+    if (aggregateRow == NULL) {
+        if (m_groupingSets.empty() && m_limits != NULL && m_limits->canSpill() && !m_hash.empty() &&
+                m_memoryPool.getAllocatedMemory() > m_limits->getMemoryLimit() / 2) {
+            spillTuple(nextTuple, nextGroupByKeyTuple);
+            return;
+        }
         VOLT_TRACE("hash aggregate: new group..");
         aggregateRow = new (m_memoryPool, m_aggTypes.size()) AggregateRow();
-        m_hash.insert(HashAggregateMapType::value_type(nextGroupByKeyTuple, aggregateRow));
+        aggregateRow->m_groupingSet = groupingSet;
+        m_hash.insert(nextGroupByKeyTuple, hash, aggregateRow);
 
         initAggInstances(aggregateRow);
 
@@ -831,38 +1232,90 @@ void AggregateHashExecutor::p_execute_tuple(const TableTuple& nextTuple) {
         TableTuple passThroughTupleSource = TableTuple(storage, m_inputSchema);
 
         aggregateRow->recordPassThroughTuple(passThroughTupleSource, nextTuple);
-        // The map is referencing the current key tuple for use by the new group,
-        // so force a new tuple allocation to hold the next candidate key.
-        nextGroupByKeyTuple.move(NULL);
+        // If the table is referencing the current key tuple for use by the new group,
+        // force a new tuple allocation to hold the next candidate key.
+        // Raw keys were copied, so the key tuple can be reused.
+        if (m_hash.keepsKeyTuples()) {
+            nextGroupByKeyTuple.move(NULL);
+        }
 
         if (m_aggTypes.size() == 0) {
-            insertOutputTuple(aggregateRow);
+            insertOutputTuple(aggregateRow, groupingSetNullColumns(aggregateRow));
             return;
         }
-    } else {
-        // otherwise, the agg row is the second item of the pair...
-        aggregateRow = keyIter->second;
     }
     // update the aggregation calculation.
     advanceAggs(aggregateRow, nextTuple);
 }
 
-void AggregateHashExecutor::p_execute_finish() {
-    VOLT_TRACE("finalizing..");
+void AggregateHashExecutor::spillTuple(const TableTuple& nextTuple, const TableTuple& groupByKeyTuple) {
+    if (m_spillPartitions.empty()) {
+        std::vector<std::string> columnNames;
+        for (int ii = 0; ii < m_inputSchema->columnCount(); ii++) {
+            std::ostringstream name;
+            name << "C" << ii;
+            columnNames.push_back(name.str());
+        }
+        for (int ii = 0; ii < SPILL_PARTITIONS; ii++) {
+            m_spillPartitions.push_back(boost::shared_ptr<TempTable>(
+                TableFactory::buildTempTable("HASH_AGGREGATE_SPILL",
+                                             TupleSchema::createTupleSchema(m_inputSchema),
+                                             columnNames, m_limits)));
+        }
+    }
+    // Seeding with the level sends a partition's groups to different
+    // partitions the next time around.
+    size_t partition = groupByKeyTuple.hashCode(m_spillLevel + 1) % SPILL_PARTITIONS;
+    TableTuple spilled = nextTuple;
+    m_spillPartitions[partition]->insertTempTuple(spilled);
+}
 
+void AggregateHashExecutor::outputGroups() {
+    if (m_hash.size() > m_peakGroups) {
+        m_peakGroups = m_hash.size();
+    }
     // If there is no aggregation, results are already inserted already
     if (m_aggTypes.size() != 0) {
-        for (HashAggregateMapType::const_iterator iter = m_hash.begin(); iter != m_hash.end(); iter++) {
-            AggregateRow *aggregateRow = iter->second;
-            if (insertOutputTuple(aggregateRow)) {
+        for (size_t ii = 0; ii < m_hash.size(); ii++) {
+            AggregateRow *aggregateRow = m_hash.rowAt(ii);
+            if (insertOutputTuple(aggregateRow, groupingSetNullColumns(aggregateRow))) {
                 m_pmp->countdownProgress();
             }
             delete aggregateRow;
         }
     }
+    m_hash.clear();
+}
+
+void AggregateHashExecutor::p_execute_finish() {
+    VOLT_TRACE("finalizing..");
+    outputGroups();
+
+    // Aggregate the spilled tuples one partition at a time, from a clean
+    // pool. Every pass finishes at least the groups that fit, so the
+    // partitions run out.
+    while (!m_spillPartitions.empty()) {
+        std::vector<boost::shared_ptr<TempTable> > partitions;
+        partitions.swap(m_spillPartitions);
+        ++m_spillLevel;
+        BOOST_FOREACH (boost::shared_ptr<TempTable> partition, partitions) {
+            m_memoryPool.purge();
+            m_nextGroupByKeyStorage.init(m_groupByKeySchema, &m_memoryPool);
+            TableTuple& nextGroupByKeyTuple = m_nextGroupByKeyStorage;
+            nextGroupByKeyTuple.move(NULL);
+
+            TableIterator it = partition->iteratorDeletingAsWeGo();
+            TableTuple spilled(partition->schema());
+            while (it.next(spilled)) {
+                AggregateHashExecutor::p_execute_tuple(spilled);
+            }
+            outputGroups();
+            partition->deleteAllTempTuples();
+        }
+    }
+    m_spillLevel = 0;
 
     // Clean up
-    m_hash.clear();
     AggregateExecutorBase::p_execute_finish();
 }
 
@@ -884,11 +1337,61 @@ TableTuple AggregateSerialExecutor::p_execute_init(const NValueArray& params,
 
     char* storage = reinterpret_cast<char*>(m_memoryPool.allocateZeroes(schema->tupleLength() + TUPLE_HEADER_SIZE));
     m_passThroughTupleSource = TableTuple(storage, schema);
+    initFixedWidthAggs(schema);
 
     // for next input tuple
     return nextInputTuple;
 }
 
+bool AggregateSerialExecutor::initFixedWidthAggs(const TupleSchema* schema)
+{
+    m_fixedWidthAggs.clear();
+    if (!m_groupByExpressions.empty() || m_prePredicate != NULL) {
+        return false;
+    }
+    std::vector<const TupleSchema::ColumnInfo*> columns(m_aggTypes.size(), NULL);
+    for (int ii = 0; ii < m_aggTypes.size(); ii++) {
+        if (m_aggTypes[ii] == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR) {
+            continue;
+        }
+        if (m_distinctAggs[ii]) {
+            return false;
+        }
+        switch (m_aggTypes[ii]) {
+        case EXPRESSION_TYPE_AGGREGATE_SUM:
+        case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        case EXPRESSION_TYPE_AGGREGATE_MIN:
+        case EXPRESSION_TYPE_AGGREGATE_MAX:
+            break;
+        default:
+            return false;
+        }
+        TupleValueExpression* tve = dynamic_cast<TupleValueExpression*>(m_inputExpressions[ii]);
+        if (tve == NULL || tve->getTupleId() != 0) {
+            return false;
+        }
+        columns[ii] = schema->getColumnInfo(tve->getColumnId());
+        if (!FixedWidthAgg::supports(m_aggTypes[ii], columns[ii]->getVoltType())) {
+            return false;
+        }
+    }
+
+    Agg** aggs = m_aggregateRow->m_aggregates;
+    for (int ii = 0; ii < m_aggTypes.size(); ii++) {
+        FixedWidthAgg* agg;
+        if (columns[ii] == NULL) {
+            agg = new (m_memoryPool) FixedWidthAgg(m_aggTypes[ii], VALUE_TYPE_BIGINT, 0);
+        }
+        else {
+            agg = new (m_memoryPool) FixedWidthAgg(m_aggTypes[ii], columns[ii]->getVoltType(),
+                                                   columns[ii]->offset);
+        }
+        aggs[ii] = agg;
+        m_fixedWidthAggs.push_back(agg);
+    }
+    return true;
+}
+
 bool AggregateSerialExecutor::p_execute(const NValueArray& params)
 {
     // Input table
@@ -913,6 +1416,18 @@ bool AggregateSerialExecutor::p_execute(const NValueArray& params)
 }
 
 void AggregateSerialExecutor::p_execute_tuple(const TableTuple& nextTuple) {
+    if (!m_fixedWidthAggs.empty()) {
+        if (m_noInputRows) {
+            m_aggregateRow->recordPassThroughTuple(m_passThroughTupleSource, nextTuple);
+            m_noInputRows = false;
+        }
+        const char* address = nextTuple.address();
+        for (size_t ii = 0; ii < m_fixedWidthAggs.size(); ii++) {
+            m_fixedWidthAggs[ii]->advanceFromTuple(address);
+        }
+        return;
+    }
+
     // Use the first input tuple to "prime" the system.
     if (m_noInputRows) {
         // ENG-1565: for this special case, can have only one input row, apply the predicate here
@@ -978,6 +1493,7 @@ void AggregateSerialExecutor::p_execute_finish()
 
     // clean up the member variables
     delete m_aggregateRow;
+    m_fixedWidthAggs.clear();
     AggregateExecutorBase::p_execute_finish();
 }
 
@@ -54,10 +54,17 @@
 #include "common/tabletuple.h"
 #include "expressions/abstractexpression.h"
 #include "execution/ProgressMonitorProxy.h"
+#include "executors/aggregatehashtable.h"
 #include "executors/executorutil.h"
 
+#include "boost/shared_ptr.hpp"
+
+#include <vector>
+
 namespace voltdb {
 
+class FixedWidthAgg;
+
 /*
  * Base class for an individual aggregate that aggregates a specific
  * column for a group
@@ -147,6 +154,9 @@ struct AggregateRow
     // A tuple from the group of tuples being aggregated. Source of pass through columns.
     TableTuple m_passThroughTuple;
 
+    // For a hash aggregate over grouping sets, the set of the group.
+    int m_groupingSet;
+
     // The aggregates for each column for this group
     Agg* m_aggregates[0];
 };
@@ -203,7 +213,8 @@ protected:
     /// Helper method responsible for inserting the results of the
     /// aggregation into a new tuple in the output table as well as passing
     /// through any additional columns from the input table.
-    bool insertOutputTuple(AggregateRow* aggregateRow);
+    /// Any nullColumns are set to NULL rather than passed through.
+    bool insertOutputTuple(AggregateRow* aggregateRow, const std::vector<int>* nullColumns = NULL);
 
     void advanceAggs(AggregateRow* aggregateRow, const TableTuple& tuple);
 
@@ -234,6 +245,7 @@ protected:
     TupleSchema* m_groupByKeySchema;
     std::vector<ExpressionType> m_aggTypes;
     std::vector<bool> m_distinctAggs;
+    std::vector<double> m_aggPercentiles;
     std::vector<AbstractExpression*> m_groupByExpressions;
     std::vector<AbstractExpression*> m_inputExpressions;
     std::vector<AbstractExpression*> m_outputColumnExpressions;
@@ -272,7 +284,8 @@ class AggregateHashExecutor : public AggregateExecutorBase
 {
 public:
     AggregateHashExecutor(VoltDBEngine* engine, AbstractPlanNode* abstract_node) :
-        AggregateExecutorBase(engine, abstract_node) { }
+        AggregateExecutorBase(engine, abstract_node), m_limits(NULL), m_spillLevel(0),
+        m_peakGroups(0) { }
 
     // empty destructor defined in .cpp file because of it is called virtually (not inline)
     // same reason for serial and partial
@@ -285,8 +298,57 @@ public:
     void p_execute_finish();
 
 private:
+    // Tuples of new groups are spread over this many partitions once the
+    // groups take more than half the temp table memory limit.
+    static const int SPILL_PARTITIONS = 16;
+    // The most groups the table is sized for ahead of a coordinator's
+    // input or a repeat execution; past that it grows as usual, and
+    // spills if need be.
+    static const size_t MAX_RESERVED_GROUPS = 1 << 20;
+
+    virtual bool p_init(AbstractPlanNode*, TempTableLimits*);
     virtual bool p_execute(const NValueArray& params);
-    HashAggregateMapType m_hash;
+
+    /** Put a tuple whose group there is no room for in its partition. */
+    void spillTuple(const TableTuple& nextTuple, const TableTuple& groupByKeyTuple);
+
+    /** Insert the finished groups into the output and forget them. */
+    void outputGroups();
+
+    /**
+     * Advance the aggs of the group of the key in m_nextGroupByKeyStorage,
+     * making the group if need be. Without grouping sets the tuple may be
+     * spilled instead.
+     */
+    void advanceGroup(const TableTuple& nextTuple, int groupingSet);
+
+    /** Advance a group of each grouping set with the tuple. */
+    void advanceGroupingSets(const TableTuple& nextTuple);
+
+    const std::vector<int>* groupingSetNullColumns(const AggregateRow* aggregateRow) const {
+        return m_groupingSets.empty() ? NULL : &m_groupingSetNullColumns[aggregateRow->m_groupingSet];
+    }
+
+    AggregateHashTable m_hash;
+
+    // GROUPING SETS, ROLLUP and CUBE: whether each set groups by each
+    // group-by expression, and the output columns NULL in its rows. The
+    // groups of all the sets share the hash table, as their keys end with
+    // the set's index, so the input is scanned once.
+    std::vector<std::vector<bool> > m_groupingSets;
+    std::vector<std::vector<int> > m_groupingSetNullColumns;
+    // Each input tuple's group-by values, for building each set's key.
+    std::vector<NValue> m_groupByValues;
+
+    TempTableLimits* m_limits;
+    // The tuples set aside for a later pass, each partition holding
+    // whole groups. Spilled tuples are partitioned again if their
+    // groups still do not fit, with a different hash at each level.
+    std::vector<boost::shared_ptr<TempTable> > m_spillPartitions;
+    int m_spillLevel;
+    // The most groups the table held at once in this execution. The next
+    // execution of the cached plan sizes the table for as many up front.
+    size_t m_peakGroups;
 };
 
 /**
@@ -319,6 +381,16 @@ protected:
 
 private:
     virtual bool p_execute(const NValueArray& params);
+
+    /**
+     * Without a GROUP BY, when every agg is a SUM, COUNT, MIN or MAX of a
+     * fixed-width numeric column of the input, or COUNT(*), set up aggs that
+     * read the columns' storage directly; returns false otherwise.
+     */
+    bool initFixedWidthAggs(const TupleSchema* schema);
+
+    // The aggregate row's aggs when initFixedWidthAggs set them up.
+    std::vector<FixedWidthAgg*> m_fixedWidthAggs;
 };
 
 
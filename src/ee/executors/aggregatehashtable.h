@@ -0,0 +1,204 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AGGREGATEHASHTABLE_H
+#define AGGREGATEHASHTABLE_H
+
+#include "common/FastHash.h"
+#include "common/tabletuple.h"
+#include "common/TupleSchema.h"
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+struct AggregateRow;
+
+/**
+ * The groups of a hash aggregation, by group-by key. It is an open
+ * addressing table of indexes into a dense array of entries, so probes
+ * walk a small array of slots, and the groups are visited in the order
+ * they were made. Each entry keeps the key's hash, so growing the table
+ * never rehashes a key, and most mismatches are settled without looking
+ * at the key.
+ *
+ * When every group-by column is a fixed-width integer, the key's bytes
+ * are copied into the table and compared and hashed as raw memory, NULLs
+ * included, as they are stored as reserved values. The key tuple is then
+ * not needed after the insert. Other keys are hashed and compared as
+ * values and the table refers to the key tuple.
+ */
+class AggregateHashTable {
+public:
+    AggregateHashTable() : m_rawKeyLength(0), m_mask(0) { }
+
+    /** Set up for keys of the given schema, emptying the table. */
+    void init(const TupleSchema* keySchema) {
+        clear();
+        m_rawKeyLength = 0;
+        bool allIntegers = true;
+        for (int ii = 0; ii < keySchema->columnCount(); ii++) {
+            switch (keySchema->columnType(ii)) {
+            case VALUE_TYPE_TINYINT:
+            case VALUE_TYPE_SMALLINT:
+            case VALUE_TYPE_INTEGER:
+            case VALUE_TYPE_BIGINT:
+            case VALUE_TYPE_TIMESTAMP:
+                break;
+            default:
+                allIntegers = false;
+            }
+        }
+        if (allIntegers && keySchema->columnCount() > 0) {
+            m_rawKeyLength = keySchema->tupleLength();
+        }
+    }
+
+    /** Whether the table still refers to the key tuples it was given. */
+    bool keepsKeyTuples() const { return m_rawKeyLength == 0; }
+
+    /**
+     * Find the group of the key, or NULL. The key's hash is left in hash
+     * for a following insert of the same key.
+     */
+    AggregateRow* find(const TableTuple& key, size_t& hash) const {
+        hash = hashKey(key);
+        if (m_entries.empty()) {
+            return NULL;
+        }
+        for (size_t slot = hash & m_mask; m_slots[slot] != EMPTY_SLOT; slot = (slot + 1) & m_mask) {
+            const Entry& entry = m_entries[m_slots[slot]];
+            if (entry.m_hash == hash && keyEquals(entry, m_slots[slot], key)) {
+                return entry.m_row;
+            }
+        }
+        return NULL;
+    }
+
+    /** Add a group for a key that find just did not find. */
+    void insert(const TableTuple& key, size_t hash, AggregateRow* row) {
+        if ((m_entries.size() + 1) * 4 > m_slots.size() * 3) {
+            grow();
+        }
+        uint32_t index = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(Entry(hash, key.address(), row));
+        if (m_rawKeyLength != 0) {
+            m_rawKeys.insert(m_rawKeys.end(), rawKey(key), rawKey(key) + m_rawKeyLength);
+        }
+        size_t slot = hash & m_mask;
+        while (m_slots[slot] != EMPTY_SLOT) {
+            slot = (slot + 1) & m_mask;
+        }
+        m_slots[slot] = index;
+    }
+
+    /**
+     * Make room for the given number of groups up front, so a table
+     * expected to hold many does not grow its way there. Only call
+     * while the table is empty.
+     */
+    void reserve(size_t groups) {
+        assert(m_entries.empty());
+        size_t slotCount = INITIAL_SLOTS;
+        while (groups * 4 > slotCount * 3) {
+            slotCount *= 2;
+        }
+        if (slotCount > m_slots.size()) {
+            const uint32_t emptySlot = EMPTY_SLOT;
+            m_slots.assign(slotCount, emptySlot);
+            m_mask = slotCount - 1;
+        }
+        m_entries.reserve(groups);
+        m_rawKeys.reserve(groups * m_rawKeyLength);
+    }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    /** The groups in the order they were inserted. */
+    AggregateRow* rowAt(size_t index) const { return m_entries[index].m_row; }
+
+    void clear() {
+        m_entries.clear();
+        m_rawKeys.clear();
+        m_slots.clear();
+        m_mask = 0;
+    }
+
+private:
+    static const uint32_t EMPTY_SLOT = 0xffffffff;
+    static const size_t INITIAL_SLOTS = 64;
+
+    struct Entry {
+        Entry(size_t hash, void* key, AggregateRow* row) : m_hash(hash), m_key(key), m_row(row) { }
+
+        size_t m_hash;
+        void* m_key;
+        AggregateRow* m_row;
+    };
+
+    static const char* rawKey(const TableTuple& key) {
+        return key.address() + TUPLE_HEADER_SIZE;
+    }
+
+    size_t hashKey(const TableTuple& key) const {
+        if (m_rawKeyLength == 0) {
+            return key.hashCode();
+        }
+        return static_cast<size_t>(FastHash::hashBytes(rawKey(key), m_rawKeyLength));
+    }
+
+    bool keyEquals(const Entry& entry, uint32_t index, const TableTuple& key) const {
+        if (m_rawKeyLength == 0) {
+            TableTuple stored(static_cast<char*>(entry.m_key), key.getSchema());
+            return stored.equalsNoSchemaCheck(key);
+        }
+        return ::memcmp(&m_rawKeys[index * m_rawKeyLength], rawKey(key), m_rawKeyLength) == 0;
+    }
+
+    void grow() {
+        size_t slotCount = m_slots.empty() ? INITIAL_SLOTS : m_slots.size() * 2;
+        // A copy, as assign() takes a reference and would odr-use the constant.
+        const uint32_t emptySlot = EMPTY_SLOT;
+        m_slots.assign(slotCount, emptySlot);
+        m_mask = slotCount - 1;
+        for (uint32_t index = 0; index < m_entries.size(); index++) {
+            size_t slot = m_entries[index].m_hash & m_mask;
+            while (m_slots[slot] != EMPTY_SLOT) {
+                slot = (slot + 1) & m_mask;
+            }
+            m_slots[slot] = index;
+        }
+    }
+
+    // Bytes of each raw key, or 0 when keys are compared as values.
+    size_t m_rawKeyLength;
+    std::vector<Entry> m_entries;
+    // The entries' raw keys back to back, in entry order.
+    std::vector<char> m_rawKeys;
+    // Entry indexes, or EMPTY_SLOT; a power of two long.
+    std::vector<uint32_t> m_slots;
+    size_t m_mask;
+};
+
+}
+
+#endif // AGGREGATEHASHTABLE_H
@@ -113,6 +113,13 @@ bool DeleteExecutor::p_execute(const NValueArray &params) {
         assert(m_inputTable);
         assert(m_inputTuple.sizeInValues() == m_inputTable->columnCount());
         assert(targetTuple.sizeInValues() == targetTable->columnCount());
+        // The target tuples are deleted a batch at a time, so that each index
+        // drops a batch in key order, the table lets go whole of the blocks a
+        // batch empties, and a batch needs one undo action instead of one per
+        // tuple. Tables with views or DR take the batch a tuple at a time.
+        std::vector<TableTuple> batch;
+        const int64_t inputCount = m_inputTable->tempTableTupleCount();
+        batch.reserve(inputCount < DELETE_BATCH_SIZE ? inputCount : DELETE_BATCH_SIZE);
         TableIterator inputIterator = m_inputTable->iterator();
         while (inputIterator.next(m_inputTuple)) {
             //
@@ -124,10 +131,14 @@ bool DeleteExecutor::p_execute(const NValueArray &params) {
             //
             void *targetAddress = m_inputTuple.getNValue(0).castAsAddress();
             targetTuple.move(targetAddress);
-
-            // Delete from target table
-            targetTable->deleteTuple(targetTuple, true);
+            batch.push_back(targetTuple);
+            if (batch.size() == DELETE_BATCH_SIZE) {
+                targetTable->deleteTupleBatch(batch);
+                batch.clear();
+            }
         }
+        // Delete the rest from target table
+        targetTable->deleteTupleBatch(batch);
         modified_tuples = m_inputTable->tempTableTupleCount();
         VOLT_TRACE("Deleted %d rows from table : %s with %d active, %d visible, %d allocated",
                    (int)modified_tuples,
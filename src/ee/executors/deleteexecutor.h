@@ -71,6 +71,9 @@ public:
         m_engine = engine;
     }
 
+    /** Most target tuples deleted with one undo action */
+    static const int64_t DELETE_BATCH_SIZE = 64 * 1024;
+
 protected:
     bool p_init(AbstractPlanNode*,
                 TempTableLimits* limits);
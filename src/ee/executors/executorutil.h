@@ -77,6 +77,16 @@ struct CountingPostfilter {
     // Returns true if predicate evaluates to true and LIMIT/OFFSET conditions are satisfied.
     bool eval(const TableTuple* outer_tuple, const TableTuple* inner_tuple);
 
+    // Returns the number of qualifying tuples OFFSET still has to skip
+    int remainingOffset() const {
+        return m_tuple_skipped < m_offset ? m_offset - m_tuple_skipped : 0;
+    }
+
+    // Counts tuples the caller skipped without evaluating them against OFFSET
+    void skipOffset(int count) {
+        m_tuple_skipped += count;
+    }
+
     private:
 
     // Indicate that an inline (child) AggCountingPostfilter associated with this postfilter
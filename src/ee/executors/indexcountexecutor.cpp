@@ -390,6 +390,8 @@ bool IndexCountExecutor::p_execute(const NValueArray &params)
             (long)rkRes, (long)rkEnd, (long)rkStart, leftIncluded, rightIncluded);
     tmptup.setNValue(0, ValueFactory::getBigIntValue( rkRes ));
     m_outputTable->insertTuple(tmptup);
+    // The count is read from the index's ranks, not its rows.
+    tableIndex->getIndexUsageStats()->recordRangeScan(0);
 
     VOLT_DEBUG ("Index Count :\n %s", m_outputTable->debug().c_str());
     return true;
@@ -56,6 +56,7 @@
 #include "expressions/abstractexpression.h"
 #include "expressions/expressionutil.h"
 #include "indexes/tableindex.h"
+#include "stats/LatencySample.h"
 
 // Inline PlanNodes
 #include "plannodes/indexscannode.h"
@@ -93,7 +94,8 @@ bool IndexScanExecutor::p_init(AbstractPlanNode *abstractNode,
         m_projectionNode = static_cast<ProjectionPlanNode*>
             (m_node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
 
-        m_projector = OptimizedProjector(m_projectionNode->getOutputColumnExpressions());
+        m_projector = OptimizedProjector(m_projectionNode->getOutputColumnExpressions(),
+                                         m_projectionNode->getCommonSubexpressions());
         m_projector.optimize(m_projectionNode->getOutputTable()->schema(),
                              m_node->getTargetTable()->schema());
     }
@@ -375,6 +377,8 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
     if (activeNumOfSearchKeys > 0) {
         VOLT_TRACE("INDEX_LOOKUP_TYPE(%d) m_numSearchkeys(%d) key:%s",
                 localLookupType, activeNumOfSearchKeys, searchKey.debugNoHeader().c_str());
+        // Times positioning the cursor, not the scan that follows.
+        ScopedLatencySample latencySample(LATENCY_INDEX_LOOKUP);
 
         if (localLookupType == INDEX_LOOKUP_TYPE_EQ) {
             tableIndex->moveToKey(&searchKey, indexCursor);
@@ -422,9 +426,22 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         tableIndex->moveToEnd(toStartActually, indexCursor);
     }
 
+    //
+    // With no predicate to apply, every row the OFFSET discards is the next
+    // one in the index, so an index that counts its entries can jump over
+    // them all at once instead of fetching them one by one.
+    //
+    if (post_expression == NULL && skipNullExpr == NULL && m_aggExec == NULL) {
+        int skip = postfilter.remainingOffset();
+        if (skip > 0 && tableIndex->skipEntries(indexCursor, skip)) {
+            postfilter.skipOffset(skip);
+        }
+    }
+
     //
     // We have to different nextValue() methods for different lookup types
     //
+    int64_t rowsReturned = 0;
     while (postfilter.isUnderLimit() &&
            getNextTuple(localLookupType,
                         &tuple,
@@ -434,6 +451,7 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         if (tuple.isPendingDelete()) {
             continue;
         }
+        ++rowsReturned;
         VOLT_TRACE("LOOPING in indexscan: tuple: '%s'\n", tuple.debug("tablename").c_str());
 
         pmp.countdownProgress();
@@ -460,7 +478,12 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         //
         if (postfilter.eval(&tuple, NULL)) {
 
-            if (m_projector.numSteps() > 0) {
+            if (m_projector.numSteps() > 0 && m_aggExec == NULL) {
+                // Only the survivors are projected, straight into the output.
+                m_outputTable->insertEmptyTempTuple(temp_tuple);
+                m_projector.exec(temp_tuple, tuple);
+            }
+            else if (m_projector.numSteps() > 0) {
                 m_projector.exec(temp_tuple, tuple);
                 outputTuple(postfilter, temp_tuple);
             }
@@ -471,6 +494,14 @@ bool IndexScanExecutor::p_execute(const NValueArray &params)
         }
     }
 
+    // Equality probes are lookups; anything else walks a range of keys.
+    if (activeNumOfSearchKeys > 0 && localLookupType == INDEX_LOOKUP_TYPE_EQ) {
+        tableIndex->getIndexUsageStats()->recordLookup(rowsReturned);
+    }
+    else {
+        tableIndex->getIndexUsageStats()->recordRangeScan(rowsReturned);
+    }
+
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_finish();
     }
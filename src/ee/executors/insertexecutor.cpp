@@ -51,6 +51,7 @@
 #include "common/types.h"
 #include "execution/VoltDBEngine.h"
 #include "expressions/functionexpression.h"
+#include "indexes/tableindex.h"
 #include "insertexecutor.h"
 #include "plannodes/insertnode.h"
 #include "storage/ConstraintFailureException.h"
@@ -64,6 +65,8 @@
 #include <vector>
 #include <set>
 
+#include "boost/foreach.hpp"
+
 using namespace std;
 using namespace voltdb;
 
@@ -225,6 +228,26 @@ bool InsertExecutor::p_execute(const NValueArray &params) {
     Pool* tempPool = ExecutorContext::getTempStringPool();
     const std::vector<int>& fieldMap = m_node->getFieldMap();
     std::size_t mapSize = fieldMap.size();
+
+    // An upsert that finds its row changes only the mapped columns, and the
+    // primary key among them to an equal value, so only the other indexes
+    // on mapped columns can need updating. Like the update executor, this
+    // is worked out per execution in case the table's indexes have changed.
+    std::vector<TableIndex*> upsertIndexes;
+    if (m_isUpsert) {
+        std::set<int> mappedColumns(fieldMap.begin(), fieldMap.end());
+        BOOST_FOREACH (TableIndex *index, persistentTable->allIndexes()) {
+            if (index == persistentTable->primaryKeyIndex()) {
+                continue;
+            }
+            BOOST_FOREACH (int colIndex, index->getAllColumnIndices()) {
+                if (mappedColumns.find(colIndex) != mappedColumns.end()) {
+                    upsertIndexes.push_back(index);
+                    break;
+                }
+            }
+        }
+    }
     while (iterator.next(inputTuple)) {
 
         for (int i = 0; i < mapSize; ++i) {
@@ -285,8 +308,17 @@ bool InsertExecutor::p_execute(const NValueArray &params) {
             }
         }
 
+        if (m_isUpsert && !m_hasPurgeFragment) {
+            // One primary key search finds the row or places the new one.
+            assert(persistentTable->primaryKeyIndex() != NULL);
+            persistentTable->upsertTuple(templateTuple, fieldMap, upsertIndexes);
+            ++modifiedTuples;
+            continue;
+        }
+
         if (m_isUpsert) {
-            // upsert execution logic
+            // A table that may need purging before an insert looks first,
+            // so it is only purged for rows that are really inserted.
             assert(persistentTable->primaryKeyIndex() != NULL);
             TableTuple existsTuple = persistentTable->lookupTupleByValues(templateTuple);
 
@@ -72,23 +72,72 @@ namespace {
 
 typedef std::vector<TableTuple>::const_iterator tuple_iterator;
 typedef std::pair<tuple_iterator, tuple_iterator> tuple_range;
-typedef std::vector<tuple_range>::iterator range_iterator;
 
-// Functor to compare two non-empty tuple ranges by comparing their first tuples using provided TupleComparer
-struct TupleRangeComparer : std::binary_function<tuple_range, tuple_range, bool>
-{
-    TupleRangeComparer(AbstractExecutor::TupleComparer comp) :
-        m_comp(comp)
-    {}
+/**
+ * A tournament tree over the partitions' ranges that remembers the loser
+ * of each match. After the winner's range advances, only the matches on
+ * its path to the root are replayed, so each output tuple costs one
+ * comparison per level, instead of the two per level of a heap's pop and
+ * push. An exhausted range loses every match.
+ */
+class LoserTree {
+public:
+    LoserTree(const std::vector<tuple_range>& ranges, AbstractExecutor::TupleComparer comp) :
+        m_ranges(ranges), m_comp(comp), m_nodes(ranges.size())
+    {
+        // Node n plays the winners under nodes 2n and 2n + 1; leaves are
+        // numbered from size() on, so any count of ranges fits.
+        const int count = static_cast<int>(m_ranges.size());
+        std::vector<int> winners(2 * count);
+        for (int ii = 0; ii < count; ++ii) {
+            winners[count + ii] = ii;
+        }
+        for (int node = count - 1; node >= 1; --node) {
+            int left = winners[2 * node];
+            int right = winners[2 * node + 1];
+            if (beats(left, right)) {
+                winners[node] = left;
+                m_nodes[node] = right;
+            }
+            else {
+                winners[node] = right;
+                m_nodes[node] = left;
+            }
+        }
+        m_nodes[0] = count > 1 ? winners[1] : 0;
+    }
+
+    // The range with the least next tuple; empty once every range is.
+    int winner() const { return m_nodes[0]; }
 
-    bool operator()(const tuple_range& ta, const tuple_range& tb) const
+    // Replay the matches of the winner after its range moved on.
+    void replay()
     {
-        // Assert both ranges are not empty
-        assert(ta.first != ta.second);
-        assert(tb.first != tb.second);
-        return m_comp(*ta.first, *tb.first);
+        int winner = m_nodes[0];
+        const int count = static_cast<int>(m_ranges.size());
+        for (int node = (count + winner) / 2; node >= 1; node /= 2) {
+            if (beats(m_nodes[node], winner)) {
+                std::swap(m_nodes[node], winner);
+            }
+        }
+        m_nodes[0] = winner;
     }
+
+private:
+    bool beats(int lhs, int rhs) const
+    {
+        const tuple_range& left = m_ranges[lhs];
+        const tuple_range& right = m_ranges[rhs];
+        if (left.first == left.second) {
+            return false;
+        }
+        return right.first == right.second || !m_comp(*right.first, *left.first);
+    }
+
+    const std::vector<tuple_range>& m_ranges;
     AbstractExecutor::TupleComparer m_comp;
+    // Node 0 holds the overall winner, the others the loser of their match.
+    std::vector<int> m_nodes;
 };
 
 }
@@ -121,34 +170,18 @@ void MergeReceiveExecutor::merge_sort(const std::vector<TableTuple>& tuples,
         assert( i != nonEmptyPartitions -1 || end == tuples.end());
     }
 
-    // Make a heap out of partitions where the partition with a tuple with a minimal value is on top
-    TupleRangeComparer tupleRangeComp(comp);
-    std::binary_negate<TupleRangeComparer> reversedTupleRangeComp = std::not2(TupleRangeComparer(comp));
-    std::make_heap(partitions.begin(), partitions.end(), reversedTupleRangeComp);
-
-    while (postfilter.isUnderLimit() && !partitions.empty()) {
-        // Get the first partition from the heap that has the next tuple to be inserted
-        range_iterator rangeIt = partitions.begin();
-        assert(rangeIt->first != rangeIt->second);
-        TableTuple tuple = *rangeIt->first;
-        ++rangeIt->first;
-
-        if (partitions.size() == 1 && rangeIt->first == rangeIt->second) {
-            // The last partition is empty. Done.
-            partitions.pop_back();
-        } else if (partitions.size() > 1) {
-            // There are more than one partition left. Remove the current top partition from the heap
-            // Dereferencing the iterator must be done prior to the std::pop_heap which would
-            // change the tuple_range this iterator points to.
-            tuple_range nextPartition = *rangeIt;
-            std::pop_heap(partitions.begin(), partitions.end(), reversedTupleRangeComp);
-            partitions.pop_back();
-            if (nextPartition.first != nextPartition.second) {
-                // The partition is not empty yet. Reinsert it back to the heap.
-                partitions.push_back(nextPartition);
-                std::push_heap(partitions.begin(), partitions.end(), reversedTupleRangeComp);
-            }
+    LoserTree tree(partitions, comp);
+
+    while (postfilter.isUnderLimit()) {
+        // Take the next tuple from the partition that won the tournament
+        tuple_range& range = partitions[tree.winner()];
+        if (range.first == range.second) {
+            // Every partition is empty. Done.
+            break;
         }
+        TableTuple tuple = *range.first;
+        ++range.first;
+        tree.replay();
 
         // Run the postfilter to evaluate the LIMIT/OFFSET
         if (postfilter.eval(&tuple, NULL)) {
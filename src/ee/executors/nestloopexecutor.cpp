@@ -57,6 +57,7 @@
 #include "storage/temptable.h"
 #include "storage/tableiterator.h"
 #include "storage/tabletuplefilter.h"
+#include "storage/TempTableLimits.h"
 #include "plannodes/nestloopnode.h"
 #include "plannodes/limitnode.h"
 #include "plannodes/aggregatenode.h"
@@ -65,6 +66,8 @@
 #include <string>
 #include <stack>
 
+#include <boost/unordered_map.hpp>
+
 #ifdef VOLT_DEBUG_ENABLED
 #include <ctime>
 #include <sys/times.h>
@@ -77,6 +80,92 @@ using namespace voltdb;
 const static int8_t UNMATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE);
 const static int8_t MATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE + 1);
 
+namespace {
+
+// Hash join keys are the values of the key columns. Both sides of each
+// equality have the same type, so equal values hash alike.
+struct JoinKeyHasher : std::unary_function<std::vector<NValue>, std::size_t>
+{
+    std::size_t operator()(const std::vector<NValue> &key) const
+    {
+        std::size_t seed = 0;
+        for (int ii = 0; ii < key.size(); ii++) {
+            key[ii].hashCombine(seed);
+        }
+        return seed;
+    }
+};
+
+struct JoinKeyEqualityChecker
+{
+    bool operator()(const std::vector<NValue> &lhs, const std::vector<NValue> &rhs) const
+    {
+        for (int ii = 0; ii < lhs.size(); ii++) {
+            if (lhs[ii].compare(rhs[ii]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// The inner tuples with each key, in inner table order, so that a hash
+// join emits its matches in the order a scan of the inner table would.
+typedef boost::unordered_map<std::vector<NValue>, std::vector<const void*>,
+                             JoinKeyHasher, JoinKeyEqualityChecker> InnerTuplesByKey;
+
+// Charges the hash table to the fragment's temp table memory, and gives
+// it back however the join ends.
+class HashJoinMemory {
+public:
+    HashJoinMemory(TempTableLimits *limits) : m_limits(limits), m_charged(0) {}
+    ~HashJoinMemory() {
+        if (m_limits != NULL && m_charged != 0) {
+            m_limits->reduceAllocated(m_charged);
+        }
+    }
+    void charge(int bytes) {
+        if (m_limits != NULL) {
+            m_charged += bytes;
+            m_limits->increaseAllocated(bytes);
+        }
+    }
+private:
+    TempTableLimits *m_limits;
+    int m_charged;
+};
+
+// Key types whose equal values always have equal hashes. Floats are left
+// out because of NaN.
+bool isHashJoinKeyType(ValueType type)
+{
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DECIMAL:
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Steps through the inner tuples that share the outer tuple's key.
+inline bool nextCandidate(const std::vector<const void*> *candidates, size_t &next, TableTuple &tuple)
+{
+    if (candidates == NULL || next == candidates->size()) {
+        return false;
+    }
+    tuple.move(const_cast<void*>((*candidates)[next++]));
+    return true;
+}
+
+}
+
 bool NestLoopExecutor::p_init(AbstractPlanNode* abstractNode,
                                    TempTableLimits* limits)
 {
@@ -94,9 +183,45 @@ bool NestLoopExecutor::p_init(AbstractPlanNode* abstractNode,
     // NULL tuples for left and full joins
     p_init_null_tuples(node->getInputTable(), node->getInputTable(1));
 
+    m_limits = limits;
+    m_outerHashKeys.clear();
+    m_innerHashKeys.clear();
+    collectHashJoinKeys(node->getJoinPredicate(),
+                        node->getInputTable(0)->schema(), node->getInputTable(1)->schema());
+
     return true;
 }
 
+void NestLoopExecutor::collectHashJoinKeys(const AbstractExpression *joinPredicate,
+                                           const TupleSchema *outerSchema, const TupleSchema *innerSchema)
+{
+    if (joinPredicate == NULL) {
+        return;
+    }
+    if (joinPredicate->getExpressionType() == EXPRESSION_TYPE_CONJUNCTION_AND) {
+        collectHashJoinKeys(joinPredicate->getLeft(), outerSchema, innerSchema);
+        collectHashJoinKeys(joinPredicate->getRight(), outerSchema, innerSchema);
+        return;
+    }
+    if (joinPredicate->getExpressionType() != EXPRESSION_TYPE_COMPARE_EQUAL) {
+        return;
+    }
+    const TupleValueExpression *left = dynamic_cast<const TupleValueExpression*>(joinPredicate->getLeft());
+    const TupleValueExpression *right = dynamic_cast<const TupleValueExpression*>(joinPredicate->getRight());
+    if (left == NULL || right == NULL || left->getTupleId() == right->getTupleId()) {
+        return;
+    }
+    const TupleValueExpression *outer = left->getTupleId() == 0 ? left : right;
+    const TupleValueExpression *inner = left->getTupleId() == 0 ? right : left;
+    const ValueType outerType = outerSchema->getColumnInfo(outer->getColumnId())->getVoltType();
+    const ValueType innerType = innerSchema->getColumnInfo(inner->getColumnId())->getVoltType();
+    if (outerType != innerType || ! isHashJoinKeyType(outerType)) {
+        return;
+    }
+    m_outerHashKeys.push_back(outer);
+    m_innerHashKeys.push_back(inner);
+}
+
 bool NestLoopExecutor::p_execute(const NValueArray &params) {
     VOLT_DEBUG("executing NestLoop...");
 
@@ -163,6 +288,32 @@ bool NestLoopExecutor::p_execute(const NValueArray &params) {
 
     TableIterator iterator0 = outer_table->iteratorDeletingAsWeGo();
     ProgressMonitorProxy pmp(m_engine, this);
+
+    // Hash the inner table on the equi-join columns, leaving out the tuples
+    // with a NULL key, which no outer tuple can equal. The whole join
+    // predicate is still evaluated for each tuple found by key.
+    const int keyCount = static_cast<int>(m_innerHashKeys.size());
+    const bool hashJoin = keyCount != 0 && inner_table->activeTupleCount() >= HASH_JOIN_MIN_INNER_TUPLES;
+    InnerTuplesByKey innerTuplesByKey;
+    HashJoinMemory hashJoinMemory(m_limits);
+    std::vector<NValue> probeKey(keyCount);
+    if (hashJoin) {
+        const int bytesPerTuple = static_cast<int>(keyCount * sizeof(NValue) + sizeof(void*) + 32);
+        TableIterator innerIterator = inner_table->iterator();
+        while (innerIterator.next(inner_tuple)) {
+            pmp.countdownProgress();
+            bool hasNull = false;
+            for (int ii = 0; ii < keyCount; ii++) {
+                probeKey[ii] = m_innerHashKeys[ii]->eval(&inner_tuple, &inner_tuple);
+                hasNull |= probeKey[ii].isNull();
+            }
+            if (hasNull) {
+                continue;
+            }
+            hashJoinMemory.charge(bytesPerTuple);
+            innerTuplesByKey[probeKey].push_back(inner_tuple.address());
+        }
+    }
     // Init the postfilter
     CountingPostfilter postfilter(m_tmpOutputTable, wherePredicate, limit, offset);
 
@@ -192,7 +343,22 @@ bool NestLoopExecutor::p_execute(const NValueArray &params) {
 
             // By default, the delete as we go flag is false.
             TableIterator iterator1 = inner_table->iterator();
-            while (postfilter.isUnderLimit() && iterator1.next(inner_tuple)) {
+            const std::vector<const void*> *candidates = NULL;
+            size_t nextCandidateIndex = 0;
+            if (hashJoin) {
+                bool hasNull = false;
+                for (int ii = 0; ii < keyCount; ii++) {
+                    probeKey[ii] = m_outerHashKeys[ii]->eval(&outer_tuple, NULL);
+                    hasNull |= probeKey[ii].isNull();
+                }
+                InnerTuplesByKey::const_iterator found = innerTuplesByKey.find(probeKey);
+                if ( ! hasNull && found != innerTuplesByKey.end()) {
+                    candidates = &found->second;
+                }
+            }
+            while (postfilter.isUnderLimit() &&
+                   (hashJoin ? nextCandidate(candidates, nextCandidateIndex, inner_tuple) :
+                               iterator1.next(inner_tuple))) {
                 pmp.countdownProgress();
                 // Apply join filter to produce matches for each outer that has them,
                 // then pad unmatched outers, then filter them all
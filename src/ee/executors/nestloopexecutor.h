@@ -50,20 +50,39 @@
 #include "common/valuevector.h"
 #include "executors/abstractjoinexecutor.h"
 
+#include <vector>
+
 namespace voltdb {
 
+class AbstractExpression;
+class TupleValueExpression;
+
 /**
  *
  */
 class NestLoopExecutor : public AbstractJoinExecutor {
     public:
         NestLoopExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) :
-            AbstractJoinExecutor(engine, abstract_node) { }
+            AbstractJoinExecutor(engine, abstract_node), m_limits(NULL) { }
     private:
+        // Inner tables smaller than this are cheaper to scan than to hash.
+        static const int HASH_JOIN_MIN_INNER_TUPLES = 16;
 
         bool p_init(AbstractPlanNode*, TempTableLimits* limits);
         bool p_execute(const NValueArray &params);
 
+        void collectHashJoinKeys(const AbstractExpression *joinPredicate,
+                                 const TupleSchema *outerSchema, const TupleSchema *innerSchema);
+
+        // The columns of the equalities between the outer and inner tables
+        // among the join predicate's top-level conjuncts. When there are
+        // any, the inner table is hashed on them instead of being scanned
+        // for every outer tuple.
+        std::vector<const TupleValueExpression*> m_outerHashKeys;
+        std::vector<const TupleValueExpression*> m_innerHashKeys;
+
+        TempTableLimits* m_limits;
+
 };
 
 }
@@ -147,6 +147,20 @@ bool NestLoopIndexExecutor::p_init(AbstractPlanNode* abstractNode,
     p_init_null_tuples(node->getInputTable(), m_indexNode->getTargetTable());
 
     m_indexValues.init(index->getKeySchema());
+
+    // Only keys read straight off the outer tuple are cheap and side-effect
+    // free enough to evaluate a second time ahead of the join loop.
+    m_batchProbes = (m_lookupType == INDEX_LOOKUP_TYPE_EQ) && (num_of_searchkeys > 0);
+    for (int ctr = 0; ctr < num_of_searchkeys; ctr++) {
+        if (m_indexNode->getSearchKeyExpressions()[ctr]->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE) {
+            m_batchProbes = false;
+        }
+    }
+    if (m_batchProbes) {
+        for (int ii = 0; ii < PROBE_BATCH; ii++) {
+            m_probeKeys[ii].init(index->getKeySchema());
+        }
+    }
     return true;
 }
 
@@ -234,6 +248,14 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     TableTuple outer_tuple(outer_table->schema());
     TableTuple inner_tuple(inner_table->schema());
     TableIterator outer_iterator = outer_table->iteratorDeletingAsWeGo();
+    // A second, non-deleting iterator that only ever runs ahead of outer_iterator
+    // supplies the batched index probes.
+    TableIterator lookahead = outer_iterator;
+    lookahead.setTempTableDeleteAsGo(false);
+    TableTuple lookahead_tuple(outer_table->schema());
+    std::vector<IndexCursor> probeCursors(m_batchProbes ? PROBE_BATCH : 0, indexCursor);
+    int probeCount = 0;
+    int probeNext = 0;
     int num_of_outer_cols = outer_table->columnCount();
     assert (outer_tuple.sizeInValues() == outer_table->columnCount());
     assert (inner_tuple.sizeInValues() == inner_table->columnCount());
@@ -285,6 +307,16 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                    outer_tuple.debug(outer_table->name()).c_str());
         pmp.countdownProgress();
 
+        int probeSlot = -1;
+        if (m_batchProbes) {
+            if (probeNext == probeCount) {
+                probeCount = probeAhead(lookahead, lookahead_tuple, index, probeCursors);
+                probeNext = 0;
+            }
+            assert(probeNext < probeCount);
+            probeSlot = m_probeSlots[probeNext++];
+        }
+
         // Set the join tuple columns that originate solely from the outer tuple.
         // Must be outside the inner loop in case of the empty inner table.
         join_tuple.setNValues(0, outer_tuple, 0, num_of_outer_cols);
@@ -424,7 +456,12 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                 // index scan executor
                 if (num_of_searchkeys > 0) {
                     if (localLookupType == INDEX_LOOKUP_TYPE_EQ) {
-                        index->moveToKey(&index_values, indexCursor);
+                        if (probeSlot >= 0) {
+                            indexCursor = probeCursors[probeSlot];
+                        }
+                        else {
+                            index->moveToKey(&index_values, indexCursor);
+                        }
                     }
                     else if (localLookupType == INDEX_LOOKUP_TYPE_GT) {
                         index->moveToGreaterThanKey(&index_values, indexCursor);
@@ -471,6 +508,7 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
 
                 AbstractExpression* skipNullExprIteration = skipNullExpr;
 
+                int64_t innerRows = 0;
                 while (postfilter.isUnderLimit() &&
                        IndexScanExecutor::getNextTuple(localLookupType,
                                                        &inner_tuple,
@@ -480,6 +518,7 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                     if (inner_tuple.isPendingDelete()) {
                         continue;
                     }
+                    ++innerRows;
                     VOLT_TRACE("inner_tuple:%s",
                                inner_tuple.debug(inner_table->name()).c_str());
                     pmp.countdownProgress();
@@ -534,6 +573,14 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                         }
                     }
                 } // END INNER WHILE LOOP
+
+                // Each probe counts as an index scan would.
+                if (num_of_searchkeys > 0 && localLookupType == INDEX_LOOKUP_TYPE_EQ) {
+                    index->getIndexUsageStats()->recordLookup(innerRows);
+                }
+                else {
+                    index->getIndexUsageStats()->recordRangeScan(innerRows);
+                }
             } // END IF INDEX KEY EXCEPTION CONDITION
         } // END IF PRE JOIN CONDITION
 
@@ -598,4 +645,51 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     return (true);
 }
 
+/**
+ * Read up to PROBE_BATCH tuples from the lookahead iterator, build the search
+ * key for each exactly as the join loop will, and position cursors for all of
+ * the well-formed keys with one batched index lookup.  Keys that are NULL or
+ * do not fit the index key get slot -1 and are left to the join loop.
+ * Returns the number of outer tuples read.
+ */
+int NestLoopIndexExecutor::probeAhead(TableIterator &lookahead, TableTuple &lookaheadTuple,
+                                      const TableIndex *index, std::vector<IndexCursor> &cursors)
+{
+    const std::vector<AbstractExpression*> &searchKeyExprs = m_indexNode->getSearchKeyExpressions();
+    int num_of_searchkeys = static_cast<int>(searchKeyExprs.size());
+    std::vector<const TableTuple*> searchKeys;
+    searchKeys.reserve(PROBE_BATCH);
+    int count = 0;
+    while (count < PROBE_BATCH && lookahead.next(lookaheadTuple)) {
+        const TableTuple &key = m_probeKeys[count].tuple();
+        key.setAllNulls();
+        bool usable = true;
+        for (int ctr = 0; ctr < num_of_searchkeys; ctr++) {
+            NValue candidateValue = searchKeyExprs[ctr]->eval(&lookaheadTuple, NULL);
+            if (candidateValue.isNull()) {
+                usable = false;
+                break;
+            }
+            try {
+                key.setNValue(ctr, candidateValue);
+            }
+            catch (const SQLException &) {
+                // The join loop reports or skips this key itself.
+                usable = false;
+                break;
+            }
+        }
+        if (usable) {
+            m_probeSlots[count] = static_cast<int>(searchKeys.size());
+            searchKeys.push_back(&key);
+        }
+        else {
+            m_probeSlots[count] = -1;
+        }
+        ++count;
+    }
+    index->moveToKeys(searchKeys, cursors);
+    return count;
+}
+
 NestLoopIndexExecutor::~NestLoopIndexExecutor() { }
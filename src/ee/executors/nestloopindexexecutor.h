@@ -60,6 +60,9 @@ class IndexScanPlanNode;
 class AggregateExecutorBase;
 class ProgressMonitorProxy;
 class TableTuple;
+class TableIndex;
+class TableIterator;
+class IndexCursor;
 
 /**
  * Nested loop for IndexScan.
@@ -76,6 +79,7 @@ public:
         : AbstractJoinExecutor(engine, abstract_node)
         , m_indexNode(NULL)
         , m_lookupType(INDEX_LOOKUP_TYPE_INVALID)
+        , m_batchProbes(false)
     { }
 
     ~NestLoopIndexExecutor();
@@ -86,11 +90,26 @@ protected:
                 TempTableLimits* limits);
     bool p_execute(const NValueArray &params);
 
+    int probeAhead(TableIterator &lookahead, TableTuple &lookaheadTuple,
+                   const TableIndex *index, std::vector<IndexCursor> &cursors);
+
     IndexScanPlanNode* m_indexNode;
     IndexLookupType m_lookupType;
     std::vector<AbstractExpression*> m_outputExpressions;
     SortDirectionType m_sortDirection;
     StandAloneTupleStorage m_indexValues;
+
+    /**
+     * Equality joins on plain outer columns look the index up for the next
+     * PROBE_BATCH outer tuples at once; m_probeSlots maps each of those tuples
+     * to its entry in the batch's cursors, or -1 if it has no usable key.
+     * When the outer input is ordered on the join key, the B+tree indexes
+     * find a batch's keys in one forward walk, as a merge join would.
+     */
+    static const int PROBE_BATCH = 16;
+    bool m_batchProbes;
+    StandAloneTupleStorage m_probeKeys[PROBE_BATCH];
+    int m_probeSlots[PROBE_BATCH];
 };
 
 }
@@ -49,6 +49,8 @@
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
 #include "execution/ProgressMonitorProxy.h"
+#include "executors/executorutil.h"
+#include "executors/mergereceiveexecutor.h"
 #include "plannodes/orderbynode.h"
 #include "plannodes/limitnode.h"
 #include "storage/table.h"
@@ -86,6 +88,14 @@ OrderByExecutor::p_init(AbstractPlanNode* abstract_node,
         limit_node =
             dynamic_cast<LimitPlanNode*>(node->
                                      getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
+
+        // Sorted runs are only ever written when temp tables can spill.
+        m_limits = limits;
+        if (limits != NULL && limits->canSpill()) {
+            m_sortedRuns.reset(TableFactory::buildCopiedTempTable(node->getInputTable()->name(),
+                                                                  node->getInputTable(),
+                                                                  limits));
+        }
     } else {
         assert(node->getChildren().empty());
         assert(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT) == NULL);
@@ -136,48 +146,66 @@ OrderByExecutor::p_execute(const NValueArray &params)
     if (limit != 0) {
         vector<TableTuple> xs;
         ProgressMonitorProxy pmp(m_engine, this);
+        AbstractExecutor::TupleComparer comp(node->getSortExpressions(), node->getSortDirections());
+        // With a limit, only the first limit + offset tuples in sort order
+        // can reach the output. They are kept in a heap with the last of
+        // them on top, which each later tuple only has to be compared to.
+        const size_t topCount = limit < 0 ? 0 : static_cast<size_t>(limit) + std::max(offset, 0);
         while (iterator.next(tuple))
         {
             pmp.countdownProgress();
             assert(tuple.isActive());
-            xs.push_back(tuple);
+            if (limit < 0) {
+                xs.push_back(tuple);
+            } else if (xs.size() < topCount) {
+                xs.push_back(tuple);
+                push_heap(xs.begin(), xs.end(), comp);
+            } else if (comp(tuple, xs.front())) {
+                pop_heap(xs.begin(), xs.end(), comp);
+                xs.back() = tuple;
+                push_heap(xs.begin(), xs.end(), comp);
+            }
         }
         VOLT_TRACE("\n***** Input Table PreSort:\n '%s'",
                    input_table->debug().c_str());
 
-
-        if (limit >= 0 && xs.begin() + limit + offset < xs.end()) {
-            // partial sort
-            partial_sort(xs.begin(), xs.begin() + limit + offset, xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
+        TempTable* tmp_input_table = dynamic_cast<TempTable*>(input_table);
+        if (limit < 0 && m_sortedRuns && tmp_input_table != NULL && tmp_input_table->hasSpilledBlocks()) {
+            // Sorting the whole input at once would touch its spilled
+            // blocks in random order.
+            sortInRuns(xs, comp, output_table, pmp);
         } else {
-            // full sort
-            sort(xs.begin(), xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
-        }
-
-        int tuple_ctr = 0;
-        int tuple_skipped = 0;
-        // If (limit < 0), so we don't have a limit at all, then just compare
-        // the iterator with the end.  Otherwise check that the tuple_counter is
-        // not over the limit.
-        for (vector<TableTuple>::iterator it = xs.begin();
-             ((limit < 0) || (tuple_ctr < limit)) && it != xs.end();
-             it++)
-        {
-            //
-            // Check if has gone past the offset
-            //
-            if (tuple_skipped < offset) {
-                tuple_skipped++;
-                continue;
+            if (limit >= 0) {
+                // the top limit + offset tuples, in order
+                sort_heap(xs.begin(), xs.end(), comp);
+            } else {
+                // full sort
+                sort(xs.begin(), xs.end(), comp);
             }
 
-            VOLT_TRACE("\n***** Input Table PostSort:\n '%s'",
-                       input_table->debug().c_str());
-            output_table->insertTempTuple(*it);
-            pmp.countdownProgress();
-            tuple_ctr += 1;
+            int tuple_ctr = 0;
+            int tuple_skipped = 0;
+            // If (limit < 0), so we don't have a limit at all, then just compare
+            // the iterator with the end.  Otherwise check that the tuple_counter is
+            // not over the limit.
+            for (vector<TableTuple>::iterator it = xs.begin();
+                 ((limit < 0) || (tuple_ctr < limit)) && it != xs.end();
+                 it++)
+            {
+                //
+                // Check if has gone past the offset
+                //
+                if (tuple_skipped < offset) {
+                    tuple_skipped++;
+                    continue;
+                }
+
+                VOLT_TRACE("\n***** Input Table PostSort:\n '%s'",
+                           input_table->debug().c_str());
+                output_table->insertTempTuple(*it);
+                pmp.countdownProgress();
+                tuple_ctr += 1;
+            }
         }
     }
     VOLT_TRACE("Result of OrderBy:\n '%s'", output_table->debug().c_str());
@@ -187,5 +215,42 @@ OrderByExecutor::p_execute(const NValueArray &params)
     return true;
 }
 
+void
+OrderByExecutor::sortInRuns(vector<TableTuple>& xs, const TupleComparer& comp,
+                            TempTable* output_table, ProgressMonitorProxy& pmp)
+{
+    const TupleSchema* schema = m_sortedRuns->schema();
+    const int64_t tupleSize = schema->tupleLength() + TUPLE_HEADER_SIZE;
+    int64_t runTuples = m_limits->getMemoryLimit() / 4 / tupleSize;
+    if (runTuples < MIN_SORTED_RUN_TUPLES) {
+        runTuples = MIN_SORTED_RUN_TUPLES;
+    }
+
+    // Each run is a stretch of the input, so sorting it only touches
+    // that stretch's blocks, and the run is written out back to back.
+    vector<int64_t> runTupleCounts;
+    for (vector<TableTuple>::iterator begin = xs.begin(); begin != xs.end(); ) {
+        vector<TableTuple>::iterator end = begin + std::min(runTuples, static_cast<int64_t>(xs.end() - begin));
+        sort(begin, end, comp);
+        for (vector<TableTuple>::iterator it = begin; it != end; ++it) {
+            m_sortedRuns->insertTempTuple(*it);
+            pmp.countdownProgress();
+        }
+        runTupleCounts.push_back(end - begin);
+        begin = end;
+    }
+
+    // The merge reads each run front to back.
+    xs.clear();
+    TableIterator iterator = m_sortedRuns->iterator();
+    TableTuple tuple(schema);
+    while (iterator.next(tuple)) {
+        xs.push_back(tuple);
+    }
+    CountingPostfilter postfilter(output_table, NULL, CountingPostfilter::NO_LIMIT, CountingPostfilter::NO_OFFSET);
+    MergeReceiveExecutor::merge_sort(xs, runTupleCounts, comp, postfilter, NULL, output_table, &pmp);
+    m_sortedRuns->deleteAllTempTuples();
+}
+
 OrderByExecutor::~OrderByExecutor() {
 }
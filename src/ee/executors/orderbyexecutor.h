@@ -50,11 +50,17 @@
 #include "common/valuevector.h"
 #include "executors/abstractexecutor.h"
 
+#include "boost/scoped_ptr.hpp"
+
+#include <vector>
+
 namespace voltdb {
 
     class UndoLog;
     class ReadWriteSet;
     class LimitPlanNode;
+    class ProgressMonitorProxy;
+    class TempTable;
 
     /**
      *
@@ -62,7 +68,7 @@ namespace voltdb {
     class OrderByExecutor : public AbstractExecutor {
     public:
         OrderByExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
-            : AbstractExecutor(engine, abstract_node), limit_node(NULL)
+            : AbstractExecutor(engine, abstract_node), limit_node(NULL), m_limits(NULL)
             { }
         ~OrderByExecutor();
 
@@ -72,7 +78,20 @@ namespace voltdb {
         bool p_execute(const NValueArray &params);
 
     private:
+        // Runs are never made smaller than this many tuples.
+        static const int64_t MIN_SORTED_RUN_TUPLES = 1024;
+
+        /**
+         * External merge sort of an input that has spilled: sorts it in runs
+         * that fit in a quarter of the temp table memory limit, writes
+         * the runs out in order, and merges them into the output.
+         */
+        void sortInRuns(std::vector<TableTuple>& xs, const TupleComparer& comp,
+                        TempTable* output_table, ProgressMonitorProxy& pmp);
+
         LimitPlanNode *limit_node;
+        TempTableLimits* m_limits;
+        boost::scoped_ptr<TempTable> m_sortedRuns;
     };
 
 }
@@ -48,6 +48,7 @@
 #include "common/common.h"
 #include "common/tabletuple.h"
 #include "expressions/abstractexpression.h"
+#include "expressions/commonsubexpression.h"
 #include "expressions/expressionutil.h"
 #include "plannodes/projectionnode.h"
 #include "storage/table.h"
@@ -91,6 +92,7 @@ bool ProjectionExecutor::p_init(AbstractPlanNode *abstractNode,
         expression_array_ptr[ctr] = node->getOutputColumnExpressions()[ctr];
         needs_substitute_ptr[ctr] = node->getOutputColumnExpressions()[ctr]->hasParameter();
     }
+    m_commonSubexpressions = node->getCommonSubexpressions();
 
 
     output_table = dynamic_cast<TempTable*>(node->getOutputTable()); //output table should be temptable
@@ -148,6 +150,7 @@ bool ProjectionExecutor::p_execute(const NValueArray &params) {
                 temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
             }
         } else {
+            CommonSubexpressions::RowScope row(m_commonSubexpressions);
             for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
                 temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
             }
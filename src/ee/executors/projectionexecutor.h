@@ -56,6 +56,7 @@
 namespace voltdb {
 
 class AbstractExpression;
+class CommonSubexpressions;
 class TempTable;
 class Table;
 
@@ -66,6 +67,7 @@ class ProjectionExecutor : public AbstractExecutor {
     public:
         ProjectionExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) : AbstractExecutor(engine, abstract_node) {
             output_table = NULL;
+            m_commonSubexpressions = NULL;
         }
         ~ProjectionExecutor();
     protected:
@@ -86,6 +88,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
         boost::shared_array<AbstractExpression*> expression_array_ptr;
         AbstractExpression** expression_array;
+        // Evaluated once per row, if the columns have any in common.
+        CommonSubexpressions* m_commonSubexpressions;
 };
 
 }
@@ -48,21 +48,226 @@
 #include "common/common.h"
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
+#include "common/ValuePeeker.hpp"
 #include "executors/aggregateexecutor.h"
 #include "executors/executorutil.h"
 #include "execution/ProgressMonitorProxy.h"
 #include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
+#include "indexes/tableindex.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/seqscannode.h"
 #include "plannodes/projectionnode.h"
 #include "plannodes/limitnode.h"
+#include "storage/persistenttable.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
 #include "storage/tablefactory.h"
 #include "storage/tableiterator.h"
 
+#include <algorithm>
+
+#include "boost/foreach.hpp"
+#include "boost/scoped_array.hpp"
+
 using namespace voltdb;
 
+// Collect the ranges that the predicate's conjuncts comparing a zone map
+// column of the table with a constant or parameter put on the column.
+static void collectZoneBounds(const AbstractExpression *expr, const PersistentTable *table,
+                              std::vector<ZoneBound> &bounds) {
+    ExpressionType type = expr->getExpressionType();
+    if (type == EXPRESSION_TYPE_CONJUNCTION_AND) {
+        collectZoneBounds(expr->getLeft(), table, bounds);
+        collectZoneBounds(expr->getRight(), table, bounds);
+        return;
+    }
+    if (type != EXPRESSION_TYPE_COMPARE_EQUAL &&
+        type != EXPRESSION_TYPE_COMPARE_LESSTHAN &&
+        type != EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO &&
+        type != EXPRESSION_TYPE_COMPARE_GREATERTHAN &&
+        type != EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO) {
+        return;
+    }
+    const AbstractExpression *column = expr->getLeft();
+    const AbstractExpression *operand = expr->getRight();
+    if (column->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE) {
+        // "operand < column" is "column > operand"
+        std::swap(column, operand);
+        switch (type) {
+        case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+            type = EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+            break;
+        case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+            type = EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+            break;
+        case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+            type = EXPRESSION_TYPE_COMPARE_LESSTHAN;
+            break;
+        case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+            type = EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+            break;
+        default:
+            break;
+        }
+    }
+    if (column->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE ||
+        (operand->getExpressionType() != EXPRESSION_TYPE_VALUE_CONSTANT &&
+         operand->getExpressionType() != EXPRESSION_TYPE_VALUE_PARAMETER)) {
+        return;
+    }
+    const TupleValueExpression *tve = static_cast<const TupleValueExpression*>(column);
+    if (tve->getTupleId() != 0) {
+        return;
+    }
+    const int zone = table->zoneOfColumn(tve->getColumnId());
+    if (zone < 0) {
+        return;
+    }
+    NValue value = operand->eval(NULL, NULL);
+    const ValueType valueType = ValuePeeker::peekValueType(value);
+    if (value.isNull() || !(isIntegralType(valueType) || valueType == VALUE_TYPE_TIMESTAMP)) {
+        return;
+    }
+    const int64_t bound = ValuePeeker::peekAsRawInt64(value);
+    ZoneBound range = { zone, INT64_MIN, INT64_MAX };
+    switch (type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+        range.low = range.high = bound;
+        break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        if (bound == INT64_MIN) {
+            return;
+        }
+        range.high = bound - 1;
+        break;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+        range.high = bound;
+        break;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        if (bound == INT64_MAX) {
+            return;
+        }
+        range.low = bound + 1;
+        break;
+    default:
+        range.low = bound;
+        break;
+    }
+    bounds.push_back(range);
+}
+
+// Collect the disjuncts of an OR tree.
+static void collectDisjuncts(const AbstractExpression *expr,
+                             std::vector<const AbstractExpression*> &disjuncts) {
+    if (expr->getExpressionType() == EXPRESSION_TYPE_CONJUNCTION_OR) {
+        collectDisjuncts(expr->getLeft(), disjuncts);
+        collectDisjuncts(expr->getRight(), disjuncts);
+        return;
+    }
+    disjuncts.push_back(expr);
+}
+
+// If the predicate is a disjunction of equalities that each compare a column
+// with a single column index on it to a constant or parameter, collect the
+// addresses of the rows the indexes find for them, once each and in the order
+// a scan of the table would reach them, and return true. Return false, having
+// looked nothing up or given up, if the table has to be scanned instead.
+static bool collectIndexUnion(const AbstractExpression *predicate, PersistentTable *table,
+                              std::vector<char*> &addresses) {
+    if (predicate->getExpressionType() != EXPRESSION_TYPE_CONJUNCTION_OR) {
+        return false;
+    }
+    std::vector<const AbstractExpression*> disjuncts;
+    collectDisjuncts(predicate, disjuncts);
+
+    std::vector<TableIndex*> indexes;
+    std::vector<const AbstractExpression*> operands;
+    BOOST_FOREACH (const AbstractExpression *disjunct, disjuncts) {
+        if (disjunct->getExpressionType() != EXPRESSION_TYPE_COMPARE_EQUAL) {
+            return false;
+        }
+        const AbstractExpression *column = disjunct->getLeft();
+        const AbstractExpression *operand = disjunct->getRight();
+        if (column->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE) {
+            std::swap(column, operand);
+        }
+        if (column->getExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE ||
+            (operand->getExpressionType() != EXPRESSION_TYPE_VALUE_CONSTANT &&
+             operand->getExpressionType() != EXPRESSION_TYPE_VALUE_PARAMETER)) {
+            return false;
+        }
+        const TupleValueExpression *tve = static_cast<const TupleValueExpression*>(column);
+        if (tve->getTupleId() != 0) {
+            return false;
+        }
+        const ValueType columnType = table->schema()->columnType(tve->getColumnId());
+        TableIndex *found = NULL;
+        BOOST_FOREACH (TableIndex *index, table->allIndexes()) {
+            if (index->getColumnIndices().size() == 1 &&
+                index->getColumnIndices()[0] == tve->getColumnId() &&
+                index->getIndexedExpressions().empty() &&
+                ! index->isPartialIndex() &&
+                index->getKeySchema()->columnType(0) == columnType) {
+                found = index;
+                break;
+            }
+        }
+        if (found == NULL) {
+            return false;
+        }
+        indexes.push_back(found);
+        operands.push_back(operand);
+    }
+
+    // Looking up more than a fraction of the table costs more than the scan.
+    const std::size_t maxRows = static_cast<std::size_t>(table->activeTupleCount() / 4);
+    std::vector<int64_t> rowsReturned(indexes.size(), 0);
+    for (std::size_t ii = 0; ii < indexes.size(); ii++) {
+        TableIndex *index = indexes[ii];
+        NValue value = operands[ii]->eval(NULL, NULL);
+        if (value.isNull()) {
+            // Equal to nothing
+            continue;
+        }
+        boost::scoped_array<char> keyStorage(new char[index->getKeySchema()->tupleLength()]);
+        TableTuple searchKey(index->getKeySchema());
+        searchKey.moveNoHeader(keyStorage.get());
+        try {
+            searchKey.setNValue(0, value);
+        }
+        catch (const SQLException &e) {
+            // A value the column can't hold is equal to none of its values.
+            if ((e.getInternalFlags() & (SQLException::TYPE_OVERFLOW | SQLException::TYPE_UNDERFLOW |
+                                         SQLException::TYPE_VAR_LENGTH_MISMATCH)) == 0) {
+                throw;
+            }
+            continue;
+        }
+        IndexCursor cursor(index->getTupleSchema());
+        if ( ! index->moveToKey(&searchKey, cursor)) {
+            continue;
+        }
+        TableTuple tuple;
+        while ( ! (tuple = index->nextValueAtKey(cursor)).isNullTuple()) {
+            addresses.push_back(tuple.address());
+            rowsReturned[ii]++;
+            if (addresses.size() > maxRows) {
+                addresses.clear();
+                return false;
+            }
+        }
+    }
+    for (std::size_t ii = 0; ii < indexes.size(); ii++) {
+        indexes[ii]->getIndexUsageStats()->recordLookup(rowsReturned[ii]);
+    }
+
+    // Blocks are scanned in address order, and so are rows within a block.
+    std::sort(addresses.begin(), addresses.end());
+    addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+    return true;
+}
+
 bool SeqScanExecutor::p_init(AbstractPlanNode* abstract_node,
                              TempTableLimits* limits)
 {
@@ -140,17 +345,17 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     // change any nodes in our expression tree to be ready for the
     // projection operations in execute
     //
-    int num_of_columns = -1;
     ProjectionPlanNode* projection_node = dynamic_cast<ProjectionPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
-    if (projection_node != NULL) {
-        num_of_columns = static_cast<int> (projection_node->getOutputColumnExpressions().size());
-    }
     //
     // OPTIMIZATION: NESTED LIMIT
     // How nice! We can also cut off our scanning with a nested limit!
     //
     LimitPlanNode* limit_node = dynamic_cast<LimitPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT));
 
+    // Without any of the optimizations below, the whole table is read.
+    int64_t rowsScanned = input_table->activeTupleCount();
+    bool indexUnion = false;
+
     //
     // OPTIMIZATION:
     //
@@ -169,8 +374,24 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
         //
         TableTuple tuple(input_table->schema());
         TableIterator iterator = input_table->iteratorDeletingAsWeGo();
+        iterator.setPrefetchDistance(SCAN_PREFETCH_DISTANCE);
         AbstractExpression *predicate = node->getPredicate();
 
+        // Look up an OR of indexed equalities instead of scanning, or else
+        // pass over the blocks that the predicate's ranges rule out.
+        std::vector<char*> unionAddresses;
+        std::vector<ZoneBound> zoneBounds;
+        PersistentTable *persistentTable = dynamic_cast<PersistentTable*>(input_table);
+        if (predicate != NULL && persistentTable != NULL && ! node->isSubQuery()) {
+            indexUnion = collectIndexUnion(predicate, persistentTable, unionAddresses);
+        }
+        if (predicate != NULL && persistentTable != NULL && ! indexUnion) {
+            collectZoneBounds(predicate, persistentTable, zoneBounds);
+            if ( ! zoneBounds.empty()) {
+                iterator.setZoneBounds(&zoneBounds);
+            }
+        }
+
         if (predicate)
         {
             VOLT_TRACE("SCAN PREDICATE :\n%s\n", predicate->debug(true).c_str());
@@ -198,40 +419,38 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             temp_tuple = m_tmpOutputTable->tempTuple();
         }
 
-        while (postfilter.isUnderLimit() && iterator.next(tuple))
-        {
+        // Without a limit every row is evaluated, so doing it a batch at a
+        // time evaluates the same rows. Serial and partial aggregation may
+        // end the scan early, and a subquery's temp table frees its blocks
+        // as the scan leaves them, so those are scanned a row at a time.
+        if (indexUnion) {
+            rowsScanned = 0;
+            for (std::size_t ii = 0; ii < unionAddresses.size() && postfilter.isUnderLimit(); ii++) {
+                ++rowsScanned;
+                tuple.move(unionAddresses[ii]);
+                pmp.countdownProgress();
+                scanTuple(tuple, postfilter, projection_node, temp_tuple, pmp);
+            }
+        }
+        else if (limit_node == NULL && ! node->isSubQuery() &&
+            (m_aggExec == NULL || dynamic_cast<AggregateHashExecutor*>(m_aggExec) != NULL)) {
+            rowsScanned = scanInBatches(iterator, input_table->schema(), predicate, projection_node,
+                                        temp_tuple, postfilter, pmp);
+        }
+        else {
+            rowsScanned = 0;
+            while (postfilter.isUnderLimit() && iterator.next(tuple))
+            {
+                ++rowsScanned;
 #if   defined(VOLT_TRACE_ENABLED)
-            int tuple_ctr = 0;
+                int tuple_ctr = 0;
 #endif
-            VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
-                       tuple.debug(input_table->name()).c_str(),
-                       ++tuple_ctr,
-                       (int)input_table->activeTupleCount());
-            pmp.countdownProgress();
-
-            //
-            // For each tuple we need to evaluate it against our predicate and limit/offset
-            //
-            if (postfilter.eval(&tuple, NULL))
-            {
-                //
-                // Nested Projection
-                // Project (or replace) values from input tuple
-                //
-                if (projection_node != NULL)
-                {
-                    VOLT_TRACE("inline projection...");
-                    for (int ctr = 0; ctr < num_of_columns; ctr++) {
-                        NValue value = projection_node->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
-                        temp_tuple.setNValue(ctr, value);
-                    }
-                    outputTuple(postfilter, temp_tuple);
-                }
-                else
-                {
-                    outputTuple(postfilter, tuple);
-                }
+                VOLT_TRACE("INPUT TUPLE: %s, %d/%d\n",
+                           tuple.debug(input_table->name()).c_str(),
+                           ++tuple_ctr,
+                           (int)input_table->activeTupleCount());
                 pmp.countdownProgress();
+                scanTuple(tuple, postfilter, projection_node, temp_tuple, pmp);
             }
         }
 
@@ -239,6 +458,13 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             m_aggExec->p_execute_finish();
         }
     }
+
+    if ( ! node->isSubQuery() && ! indexUnion) {
+        PersistentTable* persistentTable = dynamic_cast<PersistentTable*>(input_table);
+        if (persistentTable != NULL) {
+            persistentTable->getScanUsageStats()->recordSeqScan(rowsScanned);
+        }
+    }
     //* for debug */std::cout << "SeqScanExecutor: node id " << node->getPlanNodeId() <<
     //* for debug */    " output table " << (void*)output_table <<
     //* for debug */    " put " << output_table->activeTupleCount() << " tuples " << std::endl;
@@ -248,6 +474,95 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     return true;
 }
 
+// Rows are fetched a batch at a time, the predicate narrows the batch down
+// with one filterBatch call and each projected column is evaluated for all
+// the survivors with one evalBatch call, instead of a virtual call per node
+// per row.
+int64_t SeqScanExecutor::scanInBatches(TableIterator& iterator, const TupleSchema* schema,
+                                       AbstractExpression* predicate, ProjectionPlanNode* projectionNode,
+                                       TableTuple& tempTuple, CountingPostfilter& postfilter,
+                                       ProgressMonitorProxy& pmp) {
+    std::vector<TableTuple> batch(SCAN_BATCH_SIZE, TableTuple(schema));
+    std::vector<int> selection(SCAN_BATCH_SIZE);
+    const int columnCount = projectionNode == NULL ? 0 :
+        static_cast<int>(projectionNode->getOutputColumnExpressions().size());
+    std::vector<std::vector<NValue> > columns(columnCount, std::vector<NValue>(SCAN_BATCH_SIZE));
+
+    int64_t rowsScanned = 0;
+    while (true) {
+        int count = 0;
+        while (count < SCAN_BATCH_SIZE && iterator.next(batch[count])) {
+            pmp.countdownProgress();
+            selection[count] = count;
+            count++;
+        }
+        if (count == 0) {
+            break;
+        }
+        rowsScanned += count;
+        if (predicate != NULL) {
+            count = predicate->filterBatch(&batch[0], &selection[0], count);
+        }
+        for (int ctr = 0; ctr < columnCount && count != 0; ctr++) {
+            projectionNode->getOutputColumnExpressions()[ctr]->evalBatch(&batch[0], &selection[0], count,
+                                                                         &columns[ctr][0]);
+        }
+        for (int ii = 0; ii < count; ii++) {
+            if (projectionNode != NULL) {
+                // Without an aggregate the columns go straight into the output.
+                if (m_aggExec == NULL) {
+                    m_tmpOutputTable->insertEmptyTempTuple(tempTuple);
+                }
+                for (int ctr = 0; ctr < columnCount; ctr++) {
+                    tempTuple.setNValue(ctr, columns[ctr][ii]);
+                }
+                if (m_aggExec != NULL) {
+                    outputTuple(postfilter, tempTuple);
+                }
+            }
+            else {
+                outputTuple(postfilter, batch[selection[ii]]);
+            }
+            pmp.countdownProgress();
+        }
+    }
+    return rowsScanned;
+}
+
+void SeqScanExecutor::scanTuple(TableTuple& tuple, CountingPostfilter& postfilter,
+                                ProjectionPlanNode* projectionNode, TableTuple& tempTuple,
+                                ProgressMonitorProxy& pmp) {
+    //
+    // For each tuple we need to evaluate it against our predicate and limit/offset
+    //
+    if ( ! postfilter.eval(&tuple, NULL)) {
+        return;
+    }
+    //
+    // Nested Projection
+    // Project (or replace) values from input tuple
+    //
+    if (projectionNode != NULL) {
+        VOLT_TRACE("inline projection...");
+        if (m_aggExec == NULL) {
+            m_tmpOutputTable->insertEmptyTempTuple(tempTuple);
+        }
+        CommonSubexpressions::RowScope row(projectionNode->getCommonSubexpressions());
+        const int columnCount = static_cast<int>(projectionNode->getOutputColumnExpressions().size());
+        for (int ctr = 0; ctr < columnCount; ctr++) {
+            NValue value = projectionNode->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
+            tempTuple.setNValue(ctr, value);
+        }
+        if (m_aggExec != NULL) {
+            outputTuple(postfilter, tempTuple);
+        }
+    }
+    else {
+        outputTuple(postfilter, tuple);
+    }
+    pmp.countdownProgress();
+}
+
 void SeqScanExecutor::outputTuple(CountingPostfilter& postfilter, TableTuple& tuple) {
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_tuple(tuple);
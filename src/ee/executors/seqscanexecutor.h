@@ -53,8 +53,12 @@
 
 namespace voltdb
 {
+    class AbstractExpression;
     class AggregateExecutorBase;
     struct CountingPostfilter;
+    class ProgressMonitorProxy;
+    class ProjectionPlanNode;
+    class TableIterator;
 
     class SeqScanExecutor : public AbstractExecutor {
     public:
@@ -68,9 +72,24 @@ namespace voltdb
         bool p_execute(const NValueArray& params);
 
     private:
+        // How many rows a scan without a limit fetches and filters at once.
+        static const int SCAN_BATCH_SIZE = 1024;
+        // How many tuples ahead of the scan to prefetch a persistent table.
+        static const uint32_t SCAN_PREFETCH_DISTANCE = 8;
 
         void outputTuple(CountingPostfilter& postfilter, TableTuple& tuple);
 
+        // Filter, project and output one row read a row at a time.
+        void scanTuple(TableTuple& tuple, CountingPostfilter& postfilter,
+                       ProjectionPlanNode* projectionNode, TableTuple& tempTuple,
+                       ProgressMonitorProxy& pmp);
+
+        // Returns the number of rows read.
+        int64_t scanInBatches(TableIterator& iterator, const TupleSchema* schema,
+                              AbstractExpression* predicate, ProjectionPlanNode* projectionNode,
+                              TableTuple& tempTuple, CountingPostfilter& postfilter,
+                              ProgressMonitorProxy& pmp);
+
         AggregateExecutorBase* m_aggExec;
     };
 }
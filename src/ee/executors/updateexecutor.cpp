@@ -166,6 +166,14 @@ bool UpdateExecutor::p_execute(const NValueArray &params) {
         }
     }
 
+    // Updates of only fixed-width columns that nothing else depends on,
+    // such as counters, are written straight into the tuple.
+    std::vector<int> targetColumns;
+    for (int map_ctr = 0; map_ctr < m_inputTargetMapSize; map_ctr++) {
+        targetColumns.push_back(m_inputTargetMap[map_ctr].second);
+    }
+    const bool inPlace = targetTable->canUpdateInPlace(targetColumns);
+
     assert(m_inputTuple.sizeInValues() == m_inputTable->columnCount());
     assert(targetTuple.sizeInValues() == targetTable->columnCount());
     TableIterator input_iterator = m_inputTable->iterator();
@@ -175,6 +183,17 @@ bool UpdateExecutor::p_execute(const NValueArray &params) {
         void *target_address = m_inputTuple.getNValue(0).castAsAddress();
         targetTuple.move(target_address);
 
+        if (inPlace) {
+            // Only the updated columns of the temp tuple are set and read.
+            TableTuple &newValues = targetTable->tempTuple();
+            for (int map_ctr = 0; map_ctr < m_inputTargetMapSize; map_ctr++) {
+                newValues.setNValue(m_inputTargetMap[map_ctr].second,
+                                    m_inputTuple.getNValue(m_inputTargetMap[map_ctr].first));
+            }
+            targetTable->updateTupleInPlace(targetTuple, newValues, targetColumns);
+            continue;
+        }
+
         // Loop through INPUT_COL_IDX->TARGET_COL_IDX mapping and only update
         // the values that we need to. The key thing to note here is that we
         // grab a temp tuple that is a copy of the target tuple (i.e., the tuple
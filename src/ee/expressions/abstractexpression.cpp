@@ -46,8 +46,12 @@
 #include "abstractexpression.h"
 
 #include "common/debuglog.h"
+#include "common/NValue.hpp"
 #include "common/serializeio.h"
+#include "common/tabletuple.h"
 #include "common/types.h"
+#include "expressions/commonsubexpression.h"
+#include "expressions/executionconstantexpression.h"
 #include "expressions/expressionutil.h"
 
 #include <sstream>
@@ -96,6 +100,36 @@ AbstractExpression::hasParameter() const
     return (m_right && m_right->hasParameter());
 }
 
+bool
+AbstractExpression::isExecutionConstant() const
+{
+    if (m_left == NULL && m_right == NULL)
+        return false;
+    if (m_left && ! m_left->isExecutionConstant())
+        return false;
+    return (m_right == NULL || m_right->isExecutionConstant());
+}
+
+void
+AbstractExpression::evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const
+{
+    for (int ii = 0; ii < count; ii++) {
+        results[ii] = eval(&tuples[selection[ii]], NULL);
+    }
+}
+
+int
+AbstractExpression::filterBatch(const TableTuple *tuples, int *selection, int count) const
+{
+    int kept = 0;
+    for (int ii = 0; ii < count; ii++) {
+        if (eval(&tuples[selection[ii]], NULL).isTrue()) {
+            selection[kept++] = selection[ii];
+        }
+    }
+    return kept;
+}
+
 bool
 AbstractExpression::initParamShortCircuits()
 {
@@ -141,9 +175,15 @@ AbstractExpression::debug(const std::string &spacer) const
 // ------------------------------------------------------------------
 AbstractExpression*
 AbstractExpression::buildExpressionTree(PlannerDomValue obj)
+{
+    return buildExpressionTree(obj, NULL);
+}
+
+AbstractExpression*
+AbstractExpression::buildExpressionTree(PlannerDomValue obj, CommonSubexpressions* shared)
 {
     AbstractExpression * exp =
-      AbstractExpression::buildExpressionTree_recurse(obj);
+      foldExecutionConstant(AbstractExpression::buildExpressionTree_recurse(obj, shared));
 
     if (exp)
         exp->initParamShortCircuits();
@@ -151,7 +191,23 @@ AbstractExpression::buildExpressionTree(PlannerDomValue obj)
 }
 
 AbstractExpression*
-AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
+AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj, CommonSubexpressions* shared)
+{
+    if (shared != NULL) {
+        int slot = shared->slotFor(obj);
+        if (slot >= 0) {
+            // The first occurrence builds the copy all of them share.
+            if ( ! shared->isBuilt(slot)) {
+                shared->setExpression(slot, buildExpressionNode(obj, shared));
+            }
+            return new CommonSubexpression(shared, slot);
+        }
+    }
+    return buildExpressionNode(obj, shared);
+}
+
+AbstractExpression*
+AbstractExpression::buildExpressionNode(PlannerDomValue obj, CommonSubexpressions* shared)
 {
     // build a tree recursively from the bottom upwards.
     // when the expression node is instantiated, its type,
@@ -191,11 +247,11 @@ AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
     try {
         if (obj.hasNonNullKey("LEFT")) {
             PlannerDomValue leftValue = obj.valueForKey("LEFT");
-            left_child = AbstractExpression::buildExpressionTree_recurse(leftValue);
+            left_child = AbstractExpression::buildExpressionTree_recurse(leftValue, shared);
         }
         if (obj.hasNonNullKey("RIGHT")) {
             PlannerDomValue rightValue = obj.valueForKey("RIGHT");
-            right_child = AbstractExpression::buildExpressionTree_recurse(rightValue);
+            right_child = AbstractExpression::buildExpressionTree_recurse(rightValue, shared);
         }
 
         // NULL argsVector corresponds to a missing ARGS value
@@ -206,11 +262,29 @@ AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
             argsVector = new std::vector<AbstractExpression*>();
             for (int i = 0; i < argsArray.arrayLen(); i++) {
                 PlannerDomValue argValue = argsArray.valueAtIndex(i);
-                AbstractExpression* argExpr = AbstractExpression::buildExpressionTree_recurse(argValue);
+                AbstractExpression* argExpr = AbstractExpression::buildExpressionTree_recurse(argValue, shared);
                 argsVector->push_back(argExpr);
             }
         }
 
+        // Children that are the same for a whole execution are evaluated
+        // once per execution, unless this node is too, and its parent or
+        // the root takes care of the whole subtree.
+        bool foldable = (left_child != NULL || right_child != NULL ||
+                         (argsVector != NULL && ! argsVector->empty()));
+        foldable = foldable && (left_child == NULL || left_child->isExecutionConstant());
+        foldable = foldable && (right_child == NULL || right_child->isExecutionConstant());
+        for (size_t i = 0; foldable && argsVector != NULL && i < argsVector->size(); i++) {
+            foldable = (*argsVector)[i]->isExecutionConstant();
+        }
+        if ( ! foldable) {
+            left_child = foldExecutionConstant(left_child);
+            right_child = foldExecutionConstant(right_child);
+            for (size_t i = 0; argsVector != NULL && i < argsVector->size(); i++) {
+                (*argsVector)[i] = foldExecutionConstant((*argsVector)[i]);
+            }
+        }
+
         // invoke the factory. obviously it has to handle null children.
         // pass it the serialization stream in case a subclass has more
         // to read. yes, the per-class data really does follow the
@@ -230,4 +304,18 @@ AbstractExpression::buildExpressionTree_recurse(PlannerDomValue obj)
     }
 }
 
+AbstractExpression*
+AbstractExpression::foldExecutionConstant(AbstractExpression* expr)
+{
+    // Leaves cost no more to evaluate than the cached value.
+    if (expr == NULL ||
+        expr->getExpressionType() == EXPRESSION_TYPE_VALUE_CONSTANT ||
+        expr->getExpressionType() == EXPRESSION_TYPE_VALUE_PARAMETER ||
+        dynamic_cast<ExecutionConstantExpression*>(expr) != NULL ||
+        ! expr->isExecutionConstant()) {
+        return expr;
+    }
+    return new ExecutionConstantExpression(expr);
+}
+
 }
@@ -55,6 +55,7 @@
 
 namespace voltdb {
 
+class CommonSubexpressions;
 class NValue;
 class TableTuple;
 
@@ -73,9 +74,34 @@ class AbstractExpression {
 
     virtual NValue eval(const TableTuple *tuple1 = NULL, const TableTuple *tuple2 = NULL) const = 0;
 
+    /**
+     * Evaluates the expression for the selected tuples of a batch, given by
+     * their positions in tuples, storing one result per selected tuple.
+     * Single-table only: each tuple is passed as tuple1. Unless overridden,
+     * the tuples are evaluated one at a time.
+     */
+    virtual void evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const;
+
+    /**
+     * Narrows the selected tuples of a batch, whose positions are in
+     * ascending order, to those for which this boolean expression is true.
+     * The survivors stay in order at the front of selection; returns how
+     * many there are. Unless overridden, this evaluates the tuples one at a
+     * time.
+     */
+    virtual int filterBatch(const TableTuple *tuples, int *selection, int count) const;
+
     /** return true if self or descendent should be substitute()'d */
     virtual bool hasParameter() const;
 
+    /**
+     * return true if the value depends on nothing but constants, parameters
+     * and the transaction, so it is the same for every tuple of an
+     * execution. Unless overridden, that holds for a node with children
+     * when it holds for all of them.
+     */
+    virtual bool isExecutionConstant() const;
+
     /* debugging methods - some various ways to create a sring
        describing the expression tree */
     std::string debug() const;
@@ -90,6 +116,10 @@ class AbstractExpression {
         stream positioned at the root expression node */
     static AbstractExpression* buildExpressionTree(PlannerDomValue obj);
 
+    /** create an expression tree whose subtrees that recur, as counted
+        in shared, refer to the one copy that shared owns */
+    static AbstractExpression* buildExpressionTree(PlannerDomValue obj, CommonSubexpressions* shared);
+
     /** accessors */
     ExpressionType getExpressionType() const {
         return m_type;
@@ -144,7 +174,9 @@ class AbstractExpression {
                        AbstractExpression *right);
 
   private:
-    static AbstractExpression* buildExpressionTree_recurse(PlannerDomValue obj);
+    static AbstractExpression* buildExpressionTree_recurse(PlannerDomValue obj, CommonSubexpressions* shared);
+    static AbstractExpression* buildExpressionNode(PlannerDomValue obj, CommonSubexpressions* shared);
+    static AbstractExpression* foldExecutionConstant(AbstractExpression* expr);
     bool initParamShortCircuits();
 
   protected:
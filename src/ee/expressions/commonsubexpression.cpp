@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/commonsubexpression.h"
+
+#include <sstream>
+
+namespace voltdb {
+
+CommonSubexpressions::~CommonSubexpressions()
+{
+    for (size_t ii = 0; ii < m_slots.size(); ii++) {
+        delete m_slots[ii].m_expression;
+    }
+}
+
+bool
+CommonSubexpressions::isComposite(PlannerDomValue obj)
+{
+    return obj.hasNonNullKey("LEFT") || obj.hasNonNullKey("RIGHT") || obj.hasNonNullKey("ARGS");
+}
+
+void
+CommonSubexpressions::count(PlannerDomValue obj)
+{
+    if ( ! isComposite(obj)) {
+        return;
+    }
+    // A repeat's own subtrees were counted with its first occurrence; they
+    // will be built once, inside it.
+    if (m_counts[obj.toJSONString()]++ > 0) {
+        return;
+    }
+    if (obj.hasNonNullKey("LEFT")) {
+        count(obj.valueForKey("LEFT"));
+    }
+    if (obj.hasNonNullKey("RIGHT")) {
+        count(obj.valueForKey("RIGHT"));
+    }
+    if (obj.hasNonNullKey("ARGS")) {
+        PlannerDomValue argsArray = obj.valueForKey("ARGS");
+        for (int ii = 0; ii < argsArray.arrayLen(); ii++) {
+            count(argsArray.valueAtIndex(ii));
+        }
+    }
+}
+
+bool
+CommonSubexpressions::hasRepeats() const
+{
+    for (boost::unordered_map<std::string, int>::const_iterator it = m_counts.begin();
+         it != m_counts.end(); ++it) {
+        if (it->second > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int
+CommonSubexpressions::slotFor(PlannerDomValue obj)
+{
+    if ( ! isComposite(obj)) {
+        return -1;
+    }
+    const std::string key = obj.toJSONString();
+    boost::unordered_map<std::string, int>::const_iterator counted = m_counts.find(key);
+    if (counted == m_counts.end() || counted->second < 2) {
+        return -1;
+    }
+    boost::unordered_map<std::string, int>::const_iterator slot = m_slotsByKey.find(key);
+    if (slot != m_slotsByKey.end()) {
+        return slot->second;
+    }
+    int index = static_cast<int>(m_slots.size());
+    m_slots.push_back(Slot());
+    m_slotsByKey[key] = index;
+    return index;
+}
+
+void
+CommonSubexpressions::setExpression(int slot, AbstractExpression *expression)
+{
+    assert( ! isBuilt(slot));
+    m_slots[slot].m_expression = expression;
+}
+
+CommonSubexpression::CommonSubexpression(const CommonSubexpressions *shared, int slot)
+    : AbstractExpression(shared->expression(slot)->getExpressionType())
+    , m_shared(shared)
+    , m_slot(slot)
+{
+    const AbstractExpression *expression = shared->expression(slot);
+    setValueType(expression->getValueType());
+    setValueSize(expression->getValueSize());
+    setInBytes(expression->getInBytes());
+}
+
+std::string
+CommonSubexpression::debugInfo(const std::string &spacer) const
+{
+    std::ostringstream buffer;
+    buffer << spacer << "CommonSubexpression[" << m_slot << "]\n"
+           << m_shared->expression(m_slot)->debug(spacer);
+    return buffer.str();
+}
+
+}
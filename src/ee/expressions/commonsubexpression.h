@@ -0,0 +1,163 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMONSUBEXPRESSION_H
+#define COMMONSUBEXPRESSION_H
+
+#include "common/NValue.hpp"
+#include "common/PlannerDomValue.h"
+#include "expressions/abstractexpression.h"
+
+#include "boost/unordered_map.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+class TableTuple;
+
+/**
+ * The subtrees that recur among a set of expressions, like the output
+ * columns of a projection, each built once and shared. Within a RowScope
+ * each is evaluated at most once, and every CommonSubexpression that
+ * refers to it reuses the value. Outside a RowScope they are evaluated on
+ * every call, so an evaluator that goes column by column over a batch, or
+ * that never opens a scope, gets the plain results.
+ *
+ * Subtrees are matched by their plan JSON, so only a subtree the planner
+ * serialized identically counts as a repeat. Leaves are never shared;
+ * they cost no more to evaluate than to look up.
+ */
+class CommonSubexpressions {
+public:
+    CommonSubexpressions() : m_generation(0), m_inRow(false) { }
+    ~CommonSubexpressions();
+
+    /**
+     * Note the composite subtrees of an expression's JSON. Every expression
+     * is counted before any is built with AbstractExpression::buildExpressionTree.
+     */
+    void count(PlannerDomValue obj);
+
+    /** Whether any subtree counted so far recurs. */
+    bool hasRepeats() const;
+
+    /** The slot of the subtree at obj if it recurs, or -1. */
+    int slotFor(PlannerDomValue obj);
+
+    bool isBuilt(int slot) const { return m_slots[slot].m_expression != NULL; }
+
+    void setExpression(int slot, AbstractExpression *expression);
+
+    const AbstractExpression *expression(int slot) const { return m_slots[slot].m_expression; }
+
+    /** The slot's value, evaluated once per row within a RowScope. */
+    NValue eval(int slot, const TableTuple *tuple1, const TableTuple *tuple2) const {
+        const Slot &entry = m_slots[slot];
+        if ( ! m_inRow) {
+            return entry.m_expression->eval(tuple1, tuple2);
+        }
+        if (entry.m_generation != m_generation) {
+            entry.m_value = entry.m_expression->eval(tuple1, tuple2);
+            entry.m_generation = m_generation;
+        }
+        return entry.m_value;
+    }
+
+    /**
+     * Brackets the evaluation of one row's expressions. A NULL owner, for
+     * expressions with nothing in common, makes it a no-op.
+     */
+    class RowScope {
+    public:
+        explicit RowScope(CommonSubexpressions *shared) : m_shared(shared) {
+            if (m_shared != NULL) {
+                m_shared->m_inRow = true;
+                ++m_shared->m_generation;
+            }
+        }
+
+        ~RowScope() {
+            if (m_shared != NULL) {
+                m_shared->m_inRow = false;
+            }
+        }
+
+    private:
+        CommonSubexpressions *m_shared;
+    };
+
+private:
+    struct Slot {
+        Slot() : m_expression(NULL), m_generation(0) { }
+
+        AbstractExpression *m_expression;
+        // The row m_value was evaluated for.
+        mutable uint64_t m_generation;
+        mutable NValue m_value;
+    };
+
+    static bool isComposite(PlannerDomValue obj);
+
+    // Occurrences of each composite subtree, by JSON.
+    boost::unordered_map<std::string, int> m_counts;
+    boost::unordered_map<std::string, int> m_slotsByKey;
+    std::vector<Slot> m_slots;
+    // Starts at 0 so no slot's value is current before the first row.
+    uint64_t m_generation;
+    bool m_inRow;
+
+    CommonSubexpressions(const CommonSubexpressions&);
+    CommonSubexpressions& operator=(const CommonSubexpressions&);
+};
+
+/**
+ * Stands in for an occurrence of a shared subtree.
+ */
+class CommonSubexpression : public AbstractExpression {
+public:
+    CommonSubexpression(const CommonSubexpressions *shared, int slot);
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        return m_shared->eval(m_slot, tuple1, tuple2);
+    }
+
+    void evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const {
+        m_shared->expression(m_slot)->evalBatch(tuples, selection, count, results);
+    }
+
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const {
+        return m_shared->expression(m_slot)->filterBatch(tuples, selection, count);
+    }
+
+    bool hasParameter() const {
+        return m_shared->expression(m_slot)->hasParameter();
+    }
+
+    std::string debugInfo(const std::string &spacer) const;
+
+private:
+    const CommonSubexpressions *m_shared;
+    const int m_slot;
+};
+
+}
+
+#endif // COMMONSUBEXPRESSION_H
@@ -47,16 +47,23 @@
 #define HSTORECOMPARISONEXPRESSION_H
 
 #include "common/common.h"
+#include "common/executorcontext.hpp"
 #include "common/serializeio.h"
+#include "common/StlFriendlyNValue.h"
 #include "common/valuevector.h"
+#include "common/ValuePeeker.hpp"
 
 #include "expressions/abstractexpression.h"
 #include "expressions/parametervalueexpression.h"
 #include "expressions/constantvalueexpression.h"
 #include "expressions/tuplevalueexpression.h"
 
+#include <algorithm>
 #include <string>
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
 namespace voltdb {
 
@@ -72,6 +79,7 @@ namespace voltdb {
 // applied to a row's prefix column implies a false result for the row comparison.
 // This may require a recheck for strict inequality.
 // "includes_equality" returns true if the comparison is true for (rows of) equal values.
+// "from_compare" gives the result of the comparison from a three-way VALUE_COMPARE_* result.
 // isNullRejecting() returns true if the comparison does not consider NULL values as valid ones
 // during comparison. All comparison except "is distinct from" are null rejecting, therefore
 // returning true.
@@ -79,6 +87,7 @@ namespace voltdb {
 class CmpEq {
 public:
     inline static const char* op_name() { return "CmpEq"; }
+    inline static bool from_compare(int cmp) { return cmp == VALUE_COMPARE_EQUAL; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -103,6 +112,7 @@ public:
 class CmpNe {
 public:
     inline static const char* op_name() { return "CmpNe"; }
+    inline static bool from_compare(int cmp) { return cmp != VALUE_COMPARE_EQUAL; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -119,6 +129,7 @@ public:
 class CmpLt {
 public:
     inline static const char* op_name() { return "CmpLt"; }
+    inline static bool from_compare(int cmp) { return cmp == VALUE_COMPARE_LESSTHAN; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -136,6 +147,7 @@ public:
 class CmpGt {
 public:
     inline static const char* op_name() { return "CmpGt"; }
+    inline static bool from_compare(int cmp) { return cmp == VALUE_COMPARE_GREATERTHAN; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -153,6 +165,7 @@ public:
 class CmpLte {
 public:
     inline static const char* op_name() { return "CmpLte"; }
+    inline static bool from_compare(int cmp) { return cmp != VALUE_COMPARE_GREATERTHAN; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -170,6 +183,7 @@ public:
 class CmpGte {
 public:
     inline static const char* op_name() { return "CmpGte"; }
+    inline static bool from_compare(int cmp) { return cmp != VALUE_COMPARE_LESSTHAN; }
     inline static NValue compare(const NValue& l, const NValue& r)
     {
         assert(!l.isNull());
@@ -255,6 +269,47 @@ public:
         return OP::compare(lnv, rnv);
     }
 
+    /**
+     * Each side is evaluated for the whole batch with one call, and the
+     * right side only for the tuples whose left side eval would have got
+     * past.
+     */
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const
+    {
+        assert(m_left != NULL);
+        assert(m_right != NULL);
+        if (count == 0) {
+            return 0;
+        }
+        std::vector<NValue> lnvs(count);
+        m_left->evalBatch(tuples, selection, count, &lnvs[0]);
+        int remaining = count;
+        if (OP::isNullRejecting()) {
+            remaining = 0;
+            for (int ii = 0; ii < count; ii++) {
+                if ( ! lnvs[ii].isNull()) {
+                    lnvs[remaining] = lnvs[ii];
+                    selection[remaining++] = selection[ii];
+                }
+            }
+        }
+        if (remaining == 0) {
+            return 0;
+        }
+        std::vector<NValue> rnvs(remaining);
+        m_right->evalBatch(tuples, selection, remaining, &rnvs[0]);
+        int kept = 0;
+        for (int ii = 0; ii < remaining; ii++) {
+            if (OP::isNullRejecting() && rnvs[ii].isNull()) {
+                continue;
+            }
+            if (OP::compare(lnvs[ii], rnvs[ii]).isTrue()) {
+                selection[kept++] = selection[ii];
+            }
+        }
+        return kept;
+    }
+
     inline const char* traceEval(const TableTuple *tuple1, const TableTuple *tuple2) const
     {
         NValue lnv;
@@ -276,6 +331,474 @@ private:
     AbstractExpression *m_right;
 };
 
+/**
+ * Compares a fixed-width numeric column with a constant or a parameter,
+ * reading the column's bytes in place. Neither side is boxed in an NValue
+ * and the result does not go through NValue::compare's dispatch on both
+ * types. The value side is decoded once, at load time for a constant or
+ * once per call (or batch) for a parameter.
+ *
+ * Integer columns are only compared this way with integer values, and
+ * DOUBLE columns with DOUBLE values. The results then match NValue's, NaN
+ * and NULL handling included. Any other pairing, as with DECIMAL, falls
+ * back to ComparisonExpression.
+ */
+template <typename OP>
+class ColumnValueComparisonExpression : public ComparisonExpression<OP> {
+public:
+    ColumnValueComparisonExpression(ExpressionType type,
+                                    TupleValueExpression *left,
+                                    AbstractExpression *right)
+        : ComparisonExpression<OP>(type, left, right)
+        , m_tupleIdx(left->getTupleId())
+        , m_columnIdx(left->getColumnId())
+        , m_constant(dynamic_cast<ConstantValueExpression*>(right) != NULL)
+    {
+        assert(OP::isNullRejecting());
+        if (m_constant) {
+            m_value = RawValue(right->eval(NULL, NULL));
+        }
+    }
+
+    inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        const TableTuple *tuple = (m_tupleIdx == 0) ? tuple1 : tuple2;
+        if (tuple != NULL) {
+            int cmp = compareColumn(*tuple, currentValue(tuple1, tuple2));
+            if (cmp == RAW_NULL) {
+                return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+            }
+            if (cmp != RAW_UNSUPPORTED) {
+                return OP::from_compare(cmp) ? NValue::getTrue() : NValue::getFalse();
+            }
+        }
+        return ComparisonExpression<OP>::eval(tuple1, tuple2);
+    }
+
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+        RawValue value = currentValue(NULL, NULL);
+        // All the tuples of a batch share the schema, so one tells for all.
+        if (m_tupleIdx != 0 || compareColumn(tuples[selection[0]], value) == RAW_UNSUPPORTED) {
+            return ComparisonExpression<OP>::filterBatch(tuples, selection, count);
+        }
+        int kept = 0;
+        for (int ii = 0; ii < count; ii++) {
+            int cmp = compareColumn(tuples[selection[ii]], value);
+            if (cmp != RAW_NULL && OP::from_compare(cmp)) {
+                selection[kept++] = selection[ii];
+            }
+        }
+        return kept;
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        return (spacer + "ColumnValueComparisonExpression\n");
+    }
+
+private:
+    // Beyond the three VALUE_COMPARE_* results.
+    static const int RAW_NULL = 2;
+    static const int RAW_UNSUPPORTED = 3;
+
+    struct RawValue {
+        enum Kind { INTEGER, FLOATING, NULL_VALUE, OTHER };
+
+        RawValue() : kind(OTHER), integer(0), floating(0) { }
+
+        explicit RawValue(const NValue &value) : kind(OTHER), integer(0), floating(0)
+        {
+            if (value.isNull()) {
+                kind = NULL_VALUE;
+                return;
+            }
+            switch (ValuePeeker::peekValueType(value)) {
+            case VALUE_TYPE_TINYINT:
+            case VALUE_TYPE_SMALLINT:
+            case VALUE_TYPE_INTEGER:
+            case VALUE_TYPE_BIGINT:
+            case VALUE_TYPE_TIMESTAMP:
+                kind = INTEGER;
+                integer = ValuePeeker::peekAsRawInt64(value);
+                break;
+            case VALUE_TYPE_DOUBLE:
+                kind = FLOATING;
+                floating = ValuePeeker::peekDouble(value);
+                break;
+            default:
+                break;
+            }
+        }
+
+        Kind kind;
+        int64_t integer;
+        double floating;
+    };
+
+    inline RawValue currentValue(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        if (m_constant) {
+            return m_value;
+        }
+        return RawValue(this->getRight()->eval(tuple1, tuple2));
+    }
+
+    inline int compareColumn(const TableTuple &tuple, const RawValue &value) const
+    {
+        const TupleSchema::ColumnInfo *columnInfo = tuple.getSchema()->getColumnInfo(m_columnIdx);
+        const char *data = tuple.address() + TUPLE_HEADER_SIZE + columnInfo->offset;
+        const ValueType columnType = columnInfo->getVoltType();
+        // Decided by the types alone, so that it holds for a whole batch.
+        if (value.kind == RawValue::OTHER ||
+            (value.kind == RawValue::INTEGER && columnType == VALUE_TYPE_DOUBLE) ||
+            (value.kind == RawValue::FLOATING && columnType != VALUE_TYPE_DOUBLE)) {
+            return RAW_UNSUPPORTED;
+        }
+        int64_t lhs;
+        switch (columnType) {
+        case VALUE_TYPE_TINYINT: {
+            int8_t column = *reinterpret_cast<const int8_t*>(data);
+            if (column == INT8_NULL) {
+                return RAW_NULL;
+            }
+            lhs = column;
+            break;
+        }
+        case VALUE_TYPE_SMALLINT: {
+            int16_t column = *reinterpret_cast<const int16_t*>(data);
+            if (column == INT16_NULL) {
+                return RAW_NULL;
+            }
+            lhs = column;
+            break;
+        }
+        case VALUE_TYPE_INTEGER: {
+            int32_t column = *reinterpret_cast<const int32_t*>(data);
+            if (column == INT32_NULL) {
+                return RAW_NULL;
+            }
+            lhs = column;
+            break;
+        }
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            lhs = *reinterpret_cast<const int64_t*>(data);
+            if (lhs == INT64_NULL) {
+                return RAW_NULL;
+            }
+            break;
+        case VALUE_TYPE_DOUBLE: {
+            double column = *reinterpret_cast<const double*>(data);
+            if (column <= DOUBLE_NULL) {
+                return RAW_NULL;
+            }
+            if (value.kind == RawValue::NULL_VALUE) {
+                return RAW_NULL;
+            }
+            // As NValue::compareDoubleValue: NaNs are equal and below everything.
+            if (std::isnan(column)) {
+                return std::isnan(value.floating) ? VALUE_COMPARE_EQUAL : VALUE_COMPARE_LESSTHAN;
+            }
+            if (std::isnan(value.floating)) {
+                return VALUE_COMPARE_GREATERTHAN;
+            }
+            return column > value.floating ? VALUE_COMPARE_GREATERTHAN :
+                (column < value.floating ? VALUE_COMPARE_LESSTHAN : VALUE_COMPARE_EQUAL);
+        }
+        default:
+            return RAW_UNSUPPORTED;
+        }
+        if (value.kind == RawValue::NULL_VALUE) {
+            return RAW_NULL;
+        }
+        return lhs > value.integer ? VALUE_COMPARE_GREATERTHAN :
+            (lhs < value.integer ? VALUE_COMPARE_LESSTHAN : VALUE_COMPARE_EQUAL);
+    }
+
+    const int m_tupleIdx;
+    const int m_columnIdx;
+    const bool m_constant;
+    RawValue m_value;
+};
+
+/**
+ * A LIKE pattern sorted into the shapes that need no general matching.
+ * A pattern with no '_' and with '%' only at its ends is a literal that
+ * the value must equal, start with, end with, or contain, which comes
+ * down to memcmp or memmem on the UTF-8 bytes: for valid UTF-8, bytes
+ * match just where code points do. Any other pattern is GENERAL and is
+ * left to NValue::like.
+ */
+class LikePattern {
+public:
+    enum Kind { EXACT, PREFIX, SUFFIX, CONTAINS, ANY, GENERAL };
+
+    LikePattern() : m_kind(GENERAL), m_compiled(false) { }
+
+    /** Whether this was last compiled from the given pattern. */
+    bool isCompiledFrom(const char *pattern, int32_t length) const
+    {
+        return m_compiled && m_text.size() == static_cast<size_t>(length) &&
+            ::memcmp(m_text.data(), pattern, length) == 0;
+    }
+
+    void compile(const char *pattern, int32_t length)
+    {
+        m_text.assign(pattern, length);
+        m_compiled = true;
+        int32_t begin = 0;
+        int32_t end = length;
+        while (begin < end && pattern[begin] == '%') {
+            ++begin;
+        }
+        while (end > begin && pattern[end - 1] == '%') {
+            --end;
+        }
+        const bool leading = begin > 0;
+        const bool trailing = end < length;
+        m_literal.assign(pattern + begin, end - begin);
+        if (m_literal.find_first_of("%_") != std::string::npos) {
+            m_kind = GENERAL;
+        } else if (m_literal.empty() && (leading || trailing)) {
+            m_kind = ANY;
+        } else if (leading && trailing) {
+            m_kind = CONTAINS;
+        } else if (leading) {
+            m_kind = SUFFIX;
+        } else if (trailing) {
+            m_kind = PREFIX;
+        } else {
+            m_kind = EXACT;
+        }
+    }
+
+    Kind kind() const { return m_kind; }
+
+    /** Whether the value matches; not for GENERAL patterns. */
+    bool matches(const char *value, int32_t length) const
+    {
+        const size_t valueLength = static_cast<size_t>(length);
+        const size_t literalLength = m_literal.size();
+        switch (m_kind) {
+        case EXACT:
+            return valueLength == literalLength &&
+                ::memcmp(value, m_literal.data(), literalLength) == 0;
+        case PREFIX:
+            return valueLength >= literalLength &&
+                ::memcmp(value, m_literal.data(), literalLength) == 0;
+        case SUFFIX:
+            return valueLength >= literalLength &&
+                ::memcmp(value + valueLength - literalLength, m_literal.data(), literalLength) == 0;
+        case CONTAINS:
+            return ::memmem(value, valueLength, m_literal.data(), literalLength) != NULL;
+        case ANY:
+            return true;
+        default:
+            assert(false);
+            return false;
+        }
+    }
+
+private:
+    Kind m_kind;
+    bool m_compiled;
+    // The whole pattern, to tell when a parameter's pattern changes.
+    std::string m_text;
+    // The pattern less its leading and trailing '%'s.
+    std::string m_literal;
+};
+
+/**
+ * LIKE against a constant or a parameter. The pattern is looked at once
+ * for as long as it stays the same -- for a whole fragment when it is a
+ * parameter -- instead of on every row, and literal shapes are matched
+ * without walking the value a code point at a time.
+ */
+class LikeComparisonExpression : public ComparisonExpression<CmpLike> {
+public:
+    LikeComparisonExpression(ExpressionType type,
+                             AbstractExpression *left,
+                             AbstractExpression *right)
+        : ComparisonExpression<CmpLike>(type, left, right)
+    {}
+
+    inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        NValue lnv = getLeft()->eval(tuple1, tuple2);
+        if (lnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        NValue rnv = getRight()->eval(tuple1, tuple2);
+        if (rnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        return matches(lnv, rnv) ? NValue::getTrue() : NValue::getFalse();
+    }
+
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+        NValue rnv = getRight()->eval(NULL, NULL);
+        if (rnv.isNull()) {
+            return 0;
+        }
+        std::vector<NValue> lnvs(count);
+        getLeft()->evalBatch(tuples, selection, count, &lnvs[0]);
+        int kept = 0;
+        for (int ii = 0; ii < count; ii++) {
+            if ( ! lnvs[ii].isNull() && matches(lnvs[ii], rnv)) {
+                selection[kept++] = selection[ii];
+            }
+        }
+        return kept;
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        return (spacer + "LikeComparisonExpression\n");
+    }
+
+private:
+    bool matches(const NValue &lnv, const NValue &rnv) const
+    {
+        if (ValuePeeker::peekValueType(lnv) != VALUE_TYPE_VARCHAR ||
+            ValuePeeker::peekValueType(rnv) != VALUE_TYPE_VARCHAR) {
+            // Let NValue::like report the type mismatch.
+            return CmpLike::compare(lnv, rnv).isTrue();
+        }
+        int32_t patternLength;
+        const char *patternChars = ValuePeeker::peekObject_withoutNull(rnv, &patternLength);
+        if ( ! m_pattern.isCompiledFrom(patternChars, patternLength)) {
+            m_pattern.compile(patternChars, patternLength);
+        }
+        if (m_pattern.kind() == LikePattern::GENERAL) {
+            return CmpLike::compare(lnv, rnv).isTrue();
+        }
+        int32_t valueLength;
+        const char *valueChars = ValuePeeker::peekObject_withoutNull(lnv, &valueLength);
+        return m_pattern.matches(valueChars, valueLength);
+    }
+
+    mutable LikePattern m_pattern;
+};
+
+/**
+ * IN against a list that is the same for every row of an execution: a
+ * constant, a list parameter, or a list of constants and parameters. The
+ * list is evaluated and sorted once per execution, and each row's value
+ * is looked up in it by binary search instead of compared with every
+ * element. The list's NULL elements can never match and are left out.
+ */
+class InListComparisonExpression : public ComparisonExpression<CmpIn> {
+public:
+    InListComparisonExpression(ExpressionType type,
+                               AbstractExpression *left,
+                               AbstractExpression *right)
+        : ComparisonExpression<CmpIn>(type, left, right)
+        , m_generation(-1)
+        , m_listIsNull(false)
+    {}
+
+    inline NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const
+    {
+        NValue lnv = getLeft()->eval(tuple1, tuple2);
+        if (lnv.isNull()) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        if ( ! prepareList()) {
+            NValue rnv = getRight()->eval(tuple1, tuple2);
+            if (rnv.isNull()) {
+                return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+            }
+            return CmpIn::compare(lnv, rnv);
+        }
+        if (m_listIsNull) {
+            return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+        }
+        return contains(lnv) ? NValue::getTrue() : NValue::getFalse();
+    }
+
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+        if ( ! prepareList()) {
+            return ComparisonExpression<CmpIn>::filterBatch(tuples, selection, count);
+        }
+        if (m_listIsNull) {
+            return 0;
+        }
+        std::vector<NValue> lnvs(count);
+        getLeft()->evalBatch(tuples, selection, count, &lnvs[0]);
+        int kept = 0;
+        for (int ii = 0; ii < count; ii++) {
+            if ( ! lnvs[ii].isNull() && contains(lnvs[ii])) {
+                selection[kept++] = selection[ii];
+            }
+        }
+        return kept;
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        return (spacer + "InListComparisonExpression\n");
+    }
+
+private:
+    /**
+     * Sort the list for this execution if that has not been done yet.
+     * Returns false, leaving the rows to be compared with the list one
+     * element at a time, when there is no execution to tie the list to.
+     */
+    bool prepareList() const
+    {
+        const int64_t generation = ExecutorContext::currentExecutionGeneration();
+        if (generation < 0) {
+            return false;
+        }
+        if (generation == m_generation) {
+            return true;
+        }
+        m_sorted.clear();
+        NValue rnv = getRight()->eval(NULL, NULL);
+        m_listIsNull = rnv.isNull();
+        if ( ! m_listIsNull) {
+            if (ValuePeeker::peekValueType(rnv) != VALUE_TYPE_ARRAY) {
+                // Let NValue::inList report the type mismatch.
+                return false;
+            }
+            const int length = rnv.arrayLength();
+            m_sorted.reserve(length);
+            for (int ii = 0; ii < length; ii++) {
+                const NValue& item = rnv.itemAtIndex(ii);
+                if ( ! item.isNull()) {
+                    StlFriendlyNValue element;
+                    element = item;
+                    m_sorted.push_back(element);
+                }
+            }
+            std::sort(m_sorted.begin(), m_sorted.end());
+        }
+        m_generation = generation;
+        return true;
+    }
+
+    bool contains(const NValue &lnv) const
+    {
+        return std::binary_search(m_sorted.begin(), m_sorted.end(),
+                                  *static_cast<const StlFriendlyNValue*>(&lnv));
+    }
+
+    mutable int64_t m_generation;
+    mutable bool m_listIsNull;
+    // The list's elements for the current execution, in order.
+    mutable std::vector<StlFriendlyNValue> m_sorted;
+};
+
 template <typename C, typename L, typename R>
 class InlinedComparisonExpression : public ComparisonExpression<C> {
 public:
@@ -52,7 +52,9 @@
 
 #include "expressions/abstractexpression.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 namespace voltdb {
 
@@ -74,6 +76,8 @@ class ConjunctionExpression : public AbstractExpression
 
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
 
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const;
+
     std::string debugInfo(const std::string &spacer) const {
         return (spacer + "ConjunctionExpression\n");
     }
@@ -130,5 +134,42 @@ ConjunctionExpression<ConjunctionOr>::eval(const TableTuple *tuple1,
     return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
 }
 
+// Only tuples the left side lets through reach the right side. A NULL left
+// side can never make the conjunction true, so unlike eval this does not
+// go on to evaluate the right side for it.
+template<> inline int
+ConjunctionExpression<ConjunctionAnd>::filterBatch(const TableTuple *tuples, int *selection, int count) const
+{
+    count = m_left->filterBatch(tuples, selection, count);
+    return m_right->filterBatch(tuples, selection, count);
+}
+
+// The right side is evaluated for the tuples the left side did not let
+// through, as eval does, and the two sets are merged back into order.
+template<> inline int
+ConjunctionExpression<ConjunctionOr>::filterBatch(const TableTuple *tuples, int *selection, int count) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    std::vector<int> leftTrue(selection, selection + count);
+    const int leftCount = m_left->filterBatch(tuples, &leftTrue[0], count);
+    std::vector<int> rightTrue;
+    rightTrue.reserve(count - leftCount);
+    for (int ii = 0, jj = 0; ii < count; ii++) {
+        if (jj < leftCount && leftTrue[jj] == selection[ii]) {
+            jj++;
+        }
+        else {
+            rightTrue.push_back(selection[ii]);
+        }
+    }
+    const int rightCount = rightTrue.empty() ? 0 :
+        m_right->filterBatch(tuples, &rightTrue[0], static_cast<int>(rightTrue.size()));
+    std::merge(leftTrue.begin(), leftTrue.begin() + leftCount,
+               rightTrue.begin(), rightTrue.begin() + rightCount, selection);
+    return leftCount + rightCount;
+}
+
 }
 #endif
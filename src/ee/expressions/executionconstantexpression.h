@@ -0,0 +1,103 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXECUTIONCONSTANTEXPRESSION_H
+#define EXECUTIONCONSTANTEXPRESSION_H
+
+#include "common/NValue.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/executorcontext.hpp"
+#include "common/types.h"
+#include "expressions/abstractexpression.h"
+
+#include <sstream>
+#include <string>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Stands in for a subtree of constants, parameters and per-transaction
+ * functions like NOW, such as the "? + 1" of "col > ? + 1", which has the
+ * same value for every tuple of an execution. The value is evaluated on
+ * the first call of each execution and returned from then on.
+ *
+ * Values that refer to pooled storage (strings, binaries, geographies and
+ * arrays) are evaluated on every call instead, as they may not outlive the
+ * temp string pool they were made in.
+ */
+class ExecutionConstantExpression : public AbstractExpression {
+public:
+    ExecutionConstantExpression(AbstractExpression *child)
+        : AbstractExpression(child->getExpressionType(), child, NULL)
+        , m_generation(-1)
+    {
+        setValueType(child->getValueType());
+        setValueSize(child->getValueSize());
+        setInBytes(child->getInBytes());
+    }
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        const int64_t generation = ExecutorContext::currentExecutionGeneration();
+        if (generation >= 0 && generation == m_generation) {
+            return m_value;
+        }
+        NValue value = m_left->eval(tuple1, tuple2);
+        const ValueType type = ValuePeeker::peekValueType(value);
+        if ( ! isVariableLengthType(type) && type != VALUE_TYPE_ARRAY) {
+            m_value = value;
+            m_generation = generation;
+        }
+        return value;
+    }
+
+    void evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const {
+        if (count == 0) {
+            return;
+        }
+        const NValue value = eval(NULL, NULL);
+        for (int ii = 0; ii < count; ii++) {
+            results[ii] = value;
+        }
+    }
+
+    int filterBatch(const TableTuple *tuples, int *selection, int count) const {
+        if (count == 0 || eval(NULL, NULL).isTrue()) {
+            return count;
+        }
+        return 0;
+    }
+
+    bool isExecutionConstant() const {
+        return true;
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        std::ostringstream buffer;
+        buffer << spacer << "ExecutionConstant\n";
+        return buffer.str();
+    }
+
+private:
+    mutable NValue m_value;
+    mutable int64_t m_generation;
+};
+
+}
+
+#endif // EXECUTIONCONSTANTEXPRESSION_H
@@ -52,8 +52,10 @@
 
 #include "expressions/operatorexpression.h"
 #include "expressions/comparisonexpression.h"
+#include "expressions/commonsubexpression.h"
 #include "expressions/conjunctionexpression.h"
 #include "expressions/constantvalueexpression.h"
+#include "expressions/executionconstantexpression.h"
 #include "expressions/functionexpression.h"
 #include "expressions/parametervalueexpression.h"
 #include "expressions/tupleaddressexpression.h"
@@ -270,6 +270,29 @@ getMoreSpecialized(ExpressionType c, L* l, R* r)
     }
 }
 
+/** A column compared with a constant or parameter, read raw where the
+ * types allow; NULL for the operators that are not specialized. */
+static AbstractExpression*
+getColumnValueComparison(ExpressionType c, TupleValueExpression *l, AbstractExpression *r)
+{
+    switch (c) {
+    case (EXPRESSION_TYPE_COMPARE_EQUAL):
+        return new ColumnValueComparisonExpression<CmpEq>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_NOTEQUAL):
+        return new ColumnValueComparisonExpression<CmpNe>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_LESSTHAN):
+        return new ColumnValueComparisonExpression<CmpLt>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_GREATERTHAN):
+        return new ColumnValueComparisonExpression<CmpGt>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO):
+        return new ColumnValueComparisonExpression<CmpLte>(c, l, r);
+    case (EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO):
+        return new ColumnValueComparisonExpression<CmpGte>(c, l, r);
+    default:
+        return NULL;
+    }
+}
+
 /** convert the enumerated value type into a concrete c type for the
  * comparison helper templates. */
 AbstractExpression *
@@ -290,6 +313,27 @@ ExpressionUtil::comparisonFactory(PlannerDomValue obj, ExpressionType et, Abstra
     TupleValueExpression *r_tuple =
       dynamic_cast<TupleValueExpression*>(rc);
 
+    ParameterValueExpression *r_param =
+      dynamic_cast<ParameterValueExpression*>(rc);
+
+    ExecutionConstantExpression *r_folded =
+      dynamic_cast<ExecutionConstantExpression*>(rc);
+
+    if (et == EXPRESSION_TYPE_COMPARE_LIKE && (r_const != NULL || r_param != NULL || r_folded != NULL)) {
+        return new LikeComparisonExpression(et, lc, rc);
+    }
+
+    if (et == EXPRESSION_TYPE_COMPARE_IN && rc->isExecutionConstant()) {
+        return new InListComparisonExpression(et, lc, rc);
+    }
+
+    if (l_tuple != NULL && (r_const != NULL || r_param != NULL || r_folded != NULL)) { // TUPLE-CONST or TUPLE-PARAM
+        AbstractExpression *specialized = getColumnValueComparison(et, l_tuple, rc);
+        if (specialized != NULL) {
+            return specialized;
+        }
+    }
+
     // this will inline getValue(), hooray!
     if (l_const != NULL && r_const != NULL) { // CONST-CONST can it happen?
         return getMoreSpecialized<ConstantValueExpression, ConstantValueExpression>(et, l_const, r_const);
@@ -97,6 +97,10 @@ public:
         : AbstractExpression(EXPRESSION_TYPE_FUNCTION) {
     };
 
+    bool isExecutionConstant() const {
+        return true;
+    }
+
     NValue eval(const TableTuple *, const TableTuple *) const {
         return NValue::callConstant<F>();
     }
@@ -129,6 +133,10 @@ public:
         return m_child->hasParameter();
     }
 
+    virtual bool isExecutionConstant() const {
+        return m_child->isExecutionConstant();
+    }
+
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
         assert (m_child);
         return (m_child->eval(tuple1, tuple2)).callUnary<F>();
@@ -168,6 +176,16 @@ public:
         return false;
     }
 
+    virtual bool isExecutionConstant() const {
+        for (size_t i = 0; i < m_args.size(); i++) {
+            assert(m_args[i]);
+            if ( ! m_args[i]->isExecutionConstant()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
         //TODO: Could make this vector a member, if the memory management implications
         // (of the NValue internal state) were clear -- is there a penalty for longer-lived
@@ -185,10 +203,55 @@ public:
         return (buffer.str());
     }
 
-private:
+protected:
     const std::vector<AbstractExpression *>& m_args;
 };
 
+/*
+ * REGEXP_POSITION, keeping the compiled pattern for as long as the pattern
+ * and flags stay the same, as they do when they are constants or
+ * parameters.
+ */
+class RegexpPositionFunctionExpression : public GeneralFunctionExpression<FUNC_VOLT_REGEXP_POSITION> {
+public:
+    RegexpPositionFunctionExpression(const std::vector<AbstractExpression *>& args)
+        : GeneralFunctionExpression<FUNC_VOLT_REGEXP_POSITION>(args) {}
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        std::vector<NValue> nValue(m_args.size());
+        for (int i = 0; i < m_args.size(); ++i) {
+            nValue[i] = m_args[i]->eval(tuple1, tuple2);
+        }
+        return NValue::regexpPosition(nValue, m_regexp);
+    }
+
+private:
+    mutable CompiledRegexp m_regexp;
+};
+
+/*
+ * CONTAINS, DISTANCE and DWITHIN of a polygon and a point, keeping the
+ * decoded polygons it is given, whether one constant or parameter polygon
+ * or the rows of a joined table of polygons.
+ */
+template <int F>
+class PolygonPointFunctionExpression : public GeneralFunctionExpression<F> {
+public:
+    PolygonPointFunctionExpression(const std::vector<AbstractExpression *>& args)
+        : GeneralFunctionExpression<F>(args) {}
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        std::vector<NValue> nValue(this->m_args.size());
+        for (int i = 0; i < this->m_args.size(); ++i) {
+            nValue[i] = this->m_args[i]->eval(tuple1, tuple2);
+        }
+        return NValue::callWithPolygon<F>(nValue, m_polygons);
+    }
+
+private:
+    mutable PolygonCache m_polygons;
+};
+
 }
 
 using namespace functionexpression;
@@ -525,7 +588,7 @@ ExpressionUtil::functionFactory(int functionId, const std::vector<AbstractExpres
             ret = new GeneralFunctionExpression<FUNC_VOLT_ROUND>(*arguments);
             break;
         case FUNC_VOLT_REGEXP_POSITION:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_REGEXP_POSITION>(*arguments);
+            ret = new RegexpPositionFunctionExpression(*arguments);
             break;
         case FUNC_VOLT_SET_FIELD:
             ret = new GeneralFunctionExpression<FUNC_VOLT_SET_FIELD>(*arguments);
@@ -537,19 +600,19 @@ ExpressionUtil::functionFactory(int functionId, const std::vector<AbstractExpres
             ret = new GeneralFunctionExpression<FUNC_VOLT_SUBSTRING_CHAR_FROM>(*arguments);
             break;
         case FUNC_VOLT_CONTAINS:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_CONTAINS>(*arguments);
+            ret = new PolygonPointFunctionExpression<FUNC_VOLT_CONTAINS>(*arguments);
             break;
         case FUNC_VOLT_DISTANCE_POINT_POINT:
             ret = new GeneralFunctionExpression<FUNC_VOLT_DISTANCE_POINT_POINT>(*arguments);
             break;
         case FUNC_VOLT_DISTANCE_POLYGON_POINT:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_DISTANCE_POLYGON_POINT>(*arguments);
+            ret = new PolygonPointFunctionExpression<FUNC_VOLT_DISTANCE_POLYGON_POINT>(*arguments);
             break;
         case FUNC_VOLT_DWITHIN_POINT_POINT:
             ret = new GeneralFunctionExpression<FUNC_VOLT_DWITHIN_POINT_POINT>(*arguments);
             break;
         case FUNC_VOLT_DWITHIN_POLYGON_POINT:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_DWITHIN_POLYGON_POINT>(*arguments);
+            ret = new PolygonPointFunctionExpression<FUNC_VOLT_DWITHIN_POLYGON_POINT>(*arguments);
             break;
         default:
             return NULL;
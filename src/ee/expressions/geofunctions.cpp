@@ -15,6 +15,7 @@
  * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include <memory>
 #include <sstream>
 
@@ -23,10 +24,12 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/tokenizer.hpp>
 
+#include "common/FastHash.h"
 #include "common/ValueFactory.hpp"
 #include "expressions/geofunctions.h"
 
 #include "s2geo/s2latlng.h"
+#include "s2geo/s2regioncoverer.h"
 
 namespace voltdb {
 
@@ -378,14 +381,93 @@ template<> NValue NValue::callUnary<FUNC_VOLT_VALIDPOLYGONFROMTEXT>() const
     return polygonFromText(wkt, true);
 }
 
-template<> NValue NValue::call<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& arguments) {
+void CachedPolygon::set(const GeographyValue& geog) {
+    if (holds(geog)) {
+        return;
+    }
+    m_polygon.initFromGeography(geog);
+    m_encoded.assign(geog.data(), geog.length());
+    m_probes = 0;
+    m_hasCoverings = false;
+}
+
+void CachedPolygon::countProbe() {
+    if (m_hasCoverings || ++m_probes < PROBES_BEFORE_COVERING) {
+        return;
+    }
+    S2RegionCoverer coverer;
+    coverer.set_max_cells(COVERING_MAX_CELLS);
+    coverer.GetCellUnion(m_polygon, &m_covering);
+    coverer.GetInteriorCellUnion(m_polygon, &m_interior);
+    m_hasCoverings = true;
+}
+
+bool CachedPolygon::contains(const S2Point& point) {
+    countProbe();
+    if (m_hasCoverings) {
+        const S2CellId cell = S2CellId::FromPoint(point);
+        if (! m_covering.Contains(cell)) {
+            return false;
+        }
+        if (m_interior.Contains(cell)) {
+            return true;
+        }
+    }
+    return m_polygon.Contains(point);
+}
+
+double CachedPolygon::getDistance(const GeographyPointValue& point) {
+    countProbe();
+    if (m_hasCoverings && m_interior.Contains(S2CellId::FromPoint(point.toS2Point()))) {
+        return 0.0;
+    }
+    return m_polygon.getDistance(point);
+}
+
+PolygonCache::~PolygonCache() {
+    for (boost::unordered_multimap<uint64_t, CachedPolygon*>::iterator it = m_polygons.begin();
+         it != m_polygons.end(); ++it) {
+        delete it->second;
+    }
+}
+
+CachedPolygon& PolygonCache::get(const GeographyValue& geog) {
+    if (m_overflow.holds(geog)) {
+        return m_overflow;
+    }
+    const uint64_t hash = FastHash::hashBytes(geog.data(), geog.length());
+    typedef boost::unordered_multimap<uint64_t, CachedPolygon*>::iterator Iterator;
+    std::pair<Iterator, Iterator> range = m_polygons.equal_range(hash);
+    for (Iterator it = range.first; it != range.second; ++it) {
+        if (it->second->holds(geog)) {
+            return *it->second;
+        }
+    }
+    if (m_polygons.size() >= MAX_POLYGONS ||
+        m_heldBytes + geog.length() > MAX_HELD_BYTES) {
+        m_overflow.set(geog);
+        return m_overflow;
+    }
+    std::unique_ptr<CachedPolygon> polygon(new CachedPolygon());
+    polygon->set(geog);
+    m_heldBytes += polygon->encodedLength();
+    m_polygons.insert(std::make_pair(hash, polygon.get()));
+    return *polygon.release();
+}
+
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& arguments,
+                                                              PolygonCache& polygons) {
     if (arguments[0].isNull() || arguments[1].isNull())
         return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
 
-    Polygon poly;
-    poly.initFromGeography(arguments[0].getGeographyValue());
+    CachedPolygon& polygon = polygons.get(arguments[0].getGeographyValue());
     S2Point pt = arguments[1].getGeographyPointValue().toS2Point();
-    return ValueFactory::getBooleanValue(poly.Contains(pt));
+    return ValueFactory::getBooleanValue(polygon.contains(pt));
+}
+
+template<> NValue NValue::call<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& arguments) {
+    PolygonCache polygons;
+    return callWithPolygon<FUNC_VOLT_CONTAINS>(arguments, polygons);
 }
 
 template<> NValue NValue::callUnary<FUNC_VOLT_POLYGON_NUM_INTERIOR_RINGS>() const {
@@ -468,7 +550,8 @@ template<> NValue NValue::callUnary<FUNC_VOLT_POLYGON_AREA>() const {
     return retVal;
 }
 
-template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vector<NValue>& arguments) {
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vector<NValue>& arguments,
+                                                                            PolygonCache& polygons) {
     assert(arguments[0].getValueType() == VALUE_TYPE_GEOGRAPHY);
     assert(arguments[1].getValueType() == VALUE_TYPE_POINT);
 
@@ -476,8 +559,7 @@ template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vect
         return NValue::getNullValue(VALUE_TYPE_DOUBLE);
     }
 
-    Polygon polygon;
-    polygon.initFromGeography(arguments[0].getGeographyValue());
+    CachedPolygon& polygon = polygons.get(arguments[0].getGeographyValue());
     GeographyPointValue point = arguments[1].getGeographyPointValue();
     NValue retVal(VALUE_TYPE_DOUBLE);
     // distance is in radians, so convert it to meters
@@ -485,6 +567,11 @@ template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vect
     return retVal;
 }
 
+template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vector<NValue>& arguments) {
+    PolygonCache polygons;
+    return callWithPolygon<FUNC_VOLT_DISTANCE_POLYGON_POINT>(arguments, polygons);
+}
+
 template<> NValue NValue::call<FUNC_VOLT_DISTANCE_POINT_POINT>(const std::vector<NValue>& arguments) {
     assert(arguments[0].getValueType() == VALUE_TYPE_POINT);
     assert(arguments[1].getValueType() == VALUE_TYPE_POINT);
@@ -584,7 +671,8 @@ template<> NValue NValue::callUnary<FUNC_VOLT_POLYGON_INVALID_REASON>() const {
     return getTempStringValue(res.c_str(),res.length());
 }
 
-template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vector<NValue>& arguments) {
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vector<NValue>& arguments,
+                                                                           PolygonCache& polygons) {
     assert(arguments[0].getValueType() == VALUE_TYPE_GEOGRAPHY);
     assert(arguments[1].getValueType() == VALUE_TYPE_POINT);
     assert(isNumeric(arguments[2].getValueType()));
@@ -593,8 +681,7 @@ template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vecto
         return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
     }
 
-    Polygon polygon;
-    polygon.initFromGeography(arguments[0].getGeographyValue());
+    CachedPolygon& polygon = polygons.get(arguments[0].getGeographyValue());
     GeographyPointValue point = arguments[1].getGeographyPointValue();
     double withinDistanceOf = arguments[2].castAsDoubleAndGetValue();
     if (withinDistanceOf < 0) {
@@ -605,6 +692,11 @@ template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vecto
     return ValueFactory::getBooleanValue(polygonToPointDistance <= withinDistanceOf);
 }
 
+template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vector<NValue>& arguments) {
+    PolygonCache polygons;
+    return callWithPolygon<FUNC_VOLT_DWITHIN_POLYGON_POINT>(arguments, polygons);
+}
+
 template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POINT_POINT>(const std::vector<NValue>& arguments) {
     assert(arguments[0].getValueType() == VALUE_TYPE_POINT);
     assert(arguments[1].getValueType() == VALUE_TYPE_POINT);
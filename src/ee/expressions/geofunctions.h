@@ -21,7 +21,93 @@
 #include "common/NValue.hpp"
 #include "expressions/functionexpression.h"
 
+#include "s2geo/s2cellunion.h"
+
+#include "boost/unordered_map.hpp"
+
+#include <cstring>
+#include <string>
+
+#include <stdint.h>
+
 namespace voltdb {
+
+/**
+ * A polygon decoded once for the many points it is checked against, as
+ * when CONTAINS or DISTANCE is given a constant or parameter polygon and
+ * a column of points. Once the same polygon has been probed a few times,
+ * it also keeps a union of cells that covers the polygon and one of cells
+ * inside it. Points in neither are settled by a binary search of cell ids,
+ * so only points near the boundary walk the polygon's edges.
+ */
+class CachedPolygon {
+public:
+    CachedPolygon() : m_probes(0), m_hasCoverings(false) { }
+
+    /** Hold the polygon of geog, decoding it only if it is not held already. */
+    void set(const GeographyValue& geog);
+
+    /** Whether the polygon held is that of geog. */
+    bool holds(const GeographyValue& geog) const {
+        return ! m_encoded.empty() &&
+            m_encoded.size() == static_cast<size_t>(geog.length()) &&
+            ::memcmp(m_encoded.data(), geog.data(), geog.length()) == 0;
+    }
+
+    /** The bytes of the encoded polygon held. */
+    size_t encodedLength() const { return m_encoded.size(); }
+
+    bool contains(const S2Point& point);
+
+    /** The distance from the polygon to point, in radians. */
+    double getDistance(const GeographyPointValue& point);
+
+private:
+    // Probes of one polygon before building its cell unions pays off.
+    static const int PROBES_BEFORE_COVERING = 16;
+    // Bounds the cost of building each cell union.
+    static const int COVERING_MAX_CELLS = 64;
+
+    void countProbe();
+
+    // The encoded bytes of the polygon held.
+    std::string m_encoded;
+    Polygon m_polygon;
+    int m_probes;
+    bool m_hasCoverings;
+    S2CellUnion m_covering;
+    S2CellUnion m_interior;
+};
+
+/**
+ * The polygons an expression has been given, each decoded once, for when
+ * the polygon changes from row to row but repeats within the query, as
+ * when a join checks each point against every row of a table of zones.
+ * Once it holds as many polygons or bytes as it may, polygons it does
+ * not hold share one more entry that keeps only the latest of them, so
+ * a cycle over more polygons than fit still hits on those held.
+ */
+class PolygonCache {
+public:
+    PolygonCache() : m_heldBytes(0) { }
+    ~PolygonCache();
+
+    /** The decoded polygon of geog. */
+    CachedPolygon& get(const GeographyValue& geog);
+
+    /** The number of polygons held, not counting the shared entry. */
+    size_t size() const { return m_polygons.size(); }
+
+private:
+    static const size_t MAX_POLYGONS = 256;
+    static const size_t MAX_HELD_BYTES = 16 * 1024 * 1024;
+
+    // By the hash of their encoded bytes.
+    boost::unordered_multimap<uint64_t, CachedPolygon*> m_polygons;
+    size_t m_heldBytes;
+    CachedPolygon m_overflow;
+};
+
 template<> NValue NValue::callUnary<FUNC_VOLT_POINTFROMTEXT>() const;
 template<> NValue NValue::callUnary<FUNC_VOLT_POLYGONFROMTEXT>() const;
 template<> NValue NValue::call<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& arguments);
@@ -37,6 +123,12 @@ template<> NValue NValue::callUnary<FUNC_VOLT_ASTEXT_GEOGRAPHY_POINT>() const;
 template<> NValue NValue::callUnary<FUNC_VOLT_ASTEXT_GEOGRAPHY>() const;
 template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vector<NValue>& arguments);
 template<> NValue NValue::call<FUNC_VOLT_DWITHIN_POINT_POINT>(const std::vector<NValue>& arguments);
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(const std::vector<NValue>& arguments,
+                                                              PolygonCache& polygons);
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_DISTANCE_POLYGON_POINT>(const std::vector<NValue>& arguments,
+                                                                            PolygonCache& polygons);
+template<> NValue NValue::callWithPolygon<FUNC_VOLT_DWITHIN_POLYGON_POINT>(const std::vector<NValue>& arguments,
+                                                                           PolygonCache& polygons);
 }
 
 #endif
@@ -27,6 +27,9 @@
 #include <jsoncpp/jsoncpp.h>
 #include <jsoncpp/jsoncpp-forwards.h>
 
+#include "common/executorcontext.hpp"
+#include "common/JsonDocumentCache.h"
+
 namespace voltdb {
 
 /** a path node is either a field name or an array index */
@@ -42,7 +45,7 @@ struct JsonPathNode {
     our path syntax */
 class JsonDocument {
 public:
-    JsonDocument(const char* docChars, int32_t lenDoc) : m_head(NULL), m_tail(NULL) {
+    JsonDocument(const char* docChars, int32_t lenDoc) : m_root(&m_doc), m_head(NULL), m_tail(NULL) {
         if (docChars == NULL) {
             // null documents have null everything, but they turn into objects/arrays
             // if we try to set their properties
@@ -53,16 +56,20 @@ public:
         }
     }
 
-    std::string value() { return m_writer.write(m_doc); }
+    /** A document parsed earlier, such as one kept by a JsonDocumentCache,
+        to get from without a copy. It must not be set. */
+    explicit JsonDocument(const Json::Value& parsed) : m_root(&parsed), m_head(NULL), m_tail(NULL) { }
+
+    std::string value() { return m_writer.write(*m_root); }
 
     bool get(const char* pathChars, int32_t lenPath, std::string& serializedValue) {
-        if (m_doc.isNull()) {
+        if (m_root->isNull()) {
             return false;
         }
 
         // get and traverse the path
         std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath);
-        const Json::Value* node = &m_doc;
+        const Json::Value* node = m_root;
         for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
             const JsonPathNode& pathNode = *cit;
             if (pathNode.m_arrayIndex != -1) {
@@ -103,6 +110,7 @@ public:
     }
 
     void set(const char* pathChars, int32_t lenPath, const char* valueChars, int32_t lenValue) {
+        assert(m_root == &m_doc);
         // translate database nulls into JSON nulls, because that's really all that makes
         // any semantic sense. otherwise, parse the value as JSON
         Json::Value value;
@@ -141,6 +149,8 @@ public:
 
 private:
     Json::Value m_doc;
+    // m_doc, or the document it was made from if that was parsed already.
+    const Json::Value* m_root;
     Json::Reader m_reader;
     Json::FastWriter m_writer;
 
@@ -329,7 +339,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>
 
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    JsonDocument doc(docChars, lenDoc);
+    JsonDocument doc(ExecutorContext::getJsonDocumentCache().parse(docChars, lenDoc));
 
     int32_t lenPath;
     const char* pathChars = pathNVal.getObject_withoutNull(&lenPath);
@@ -358,22 +368,10 @@ template<> inline NValue NValue::call<FUNC_VOLT_ARRAY_ELEMENT>(const std::vector
     }
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    const std::string doc(docChars, lenDoc);
 
     int32_t index = indexNVal.castAsIntegerAndGetValue();
 
-    Json::Value root;
-    Json::Reader reader;
-
-    if ( ! reader.parse(doc, root)) {
-        char msg[1024];
-        // getFormatedErrorMessages returns concise message about location
-        // of the error rather than the malformed document itself
-        snprintf(msg, sizeof(msg), "Invalid JSON %s", reader.getFormatedErrorMessages().c_str());
-        throw SQLException(SQLException::
-                           data_exception_invalid_parameter,
-                           msg);
-    }
+    const Json::Value& root = ExecutorContext::getJsonDocumentCache().parse(docChars, lenDoc);
 
     // only array type contains elements. objects, primitives do not
     if ( ! root.isArray()) {
@@ -389,7 +387,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_ARRAY_ELEMENT>(const std::vector
         return getNullStringValue();
     }
 
-    Json::Value fieldValue = root[index];
+    const Json::Value& fieldValue = root[index];
 
     if (fieldValue.isNull()) {
         return getNullStringValue();
@@ -418,20 +416,8 @@ template<> inline NValue NValue::callUnary<FUNC_VOLT_ARRAY_LENGTH>() const {
 
     int32_t lenDoc;
     const char* docChars = getObject_withoutNull(&lenDoc);
-    const std::string doc(docChars, lenDoc);
-
-    Json::Value root;
-    Json::Reader reader;
 
-    if ( ! reader.parse(doc, root)) {
-        char msg[1024];
-        // getFormatedErrorMessages returns concise message about location
-        // of the error rather than the malformed document itself
-        snprintf(msg, sizeof(msg), "Invalid JSON %s", reader.getFormatedErrorMessages().c_str());
-        throw SQLException(SQLException::
-                           data_exception_invalid_parameter,
-                           msg);
-    }
+    const Json::Value& root = ExecutorContext::getJsonDocumentCache().parse(docChars, lenDoc);
 
     // only array type contains indexed elements. objects, primitives do not
     if ( ! root.isArray()) {
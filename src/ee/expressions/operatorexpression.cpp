@@ -18,6 +18,7 @@
 #include <sstream>
 
 #include "operatorexpression.h"
+#include "subqueryexpression.h"
 
 #include "common/debuglog.h"
 #include "common/executorcontext.hpp"
@@ -31,8 +32,18 @@
 
 namespace voltdb {
 
+OperatorExistsExpression::OperatorExistsExpression(AbstractExpression *left)
+    : AbstractExpression(EXPRESSION_TYPE_OPERATOR_EXISTS, left, NULL)
+    , m_subquery(dynamic_cast<const SubqueryExpression*>(left))
+{
+}
+
 NValue OperatorExistsExpression::eval(const TableTuple *tuple1, const TableTuple *tuple2) const
 {
+    if (m_subquery != NULL) {
+        return m_subquery->hasRows(tuple1, tuple2) ? NValue::getTrue() : NValue::getFalse();
+    }
+
     // Execute the subquery and get its subquery id
     assert(m_left != NULL);
     NValue lnv = m_left->eval(tuple1, tuple2);
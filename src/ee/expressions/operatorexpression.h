@@ -57,6 +57,7 @@
 
 namespace voltdb {
 
+class SubqueryExpression;
 
 /*
  * Unary operators. (NOT and IS_NULL)
@@ -238,10 +239,7 @@ private:
 
 class OperatorExistsExpression : public AbstractExpression {
   public:
-    OperatorExistsExpression(AbstractExpression *left)
-        : AbstractExpression(EXPRESSION_TYPE_OPERATOR_EXISTS, left, NULL)
-    {
-    }
+    OperatorExistsExpression(AbstractExpression *left);
 
     NValue
     eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
@@ -249,6 +247,10 @@ class OperatorExistsExpression : public AbstractExpression {
     std::string debugInfo(const std::string &spacer) const {
         return (spacer + "OperatorExistsExpression");
     }
+
+  private:
+    // m_left, when it is a subquery that can answer EXISTS itself.
+    const SubqueryExpression *m_subquery;
 };
 
 
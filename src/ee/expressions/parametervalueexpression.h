@@ -75,11 +75,22 @@ public:
         return *m_paramValue;
     }
 
+    void evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const {
+        assert(m_paramValue != NULL);
+        for (int ii = 0; ii < count; ii++) {
+            results[ii] = *m_paramValue;
+        }
+    }
+
     bool hasParameter() const {
         // this class represents a parameter.
         return true;
     }
 
+    bool isExecutionConstant() const {
+        return true;
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         std::ostringstream buffer;
         buffer << spacer << "OptimizedParameter[" << this->m_valueIdx << "]\n";
@@ -36,6 +36,10 @@
 #include <locale>
 #include <iomanip>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace voltdb {
 
 /** implement the 1-argument SQL OCTET_LENGTH function */
@@ -89,6 +93,68 @@ template<> inline NValue NValue::callUnary<FUNC_SPACE>() const {
     return getTempStringValue(spacesStr.c_str(),count);
 }
 
+/**
+ * The number of leading bytes of a string that are ASCII, and so are one
+ * character each.
+ */
+static inline size_t asciiPrefixLength(const char* chars, size_t length) {
+    size_t ii = 0;
+#ifdef __SSE2__
+    for (; ii + 16 <= length; ii += 16) {
+        const int highBits = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + ii)));
+        if (highBits != 0) {
+            return ii + __builtin_ctz(highBits);
+        }
+    }
+#endif
+    while (ii < length && (chars[ii] & 0x80) == 0) {
+        ii++;
+    }
+    return ii;
+}
+
+/**
+ * The position count characters on from start, or end if there are not
+ * that many. The ASCII bytes at the front are skipped without decoding.
+ */
+static inline const char* skipCharacters(const char* start, const char* end, int64_t count) {
+    if (count <= 0) {
+        return start;
+    }
+    const size_t ascii = asciiPrefixLength(start, static_cast<size_t>(std::min<int64_t>(count, end - start)));
+    start += ascii;
+    count -= static_cast<int64_t>(ascii);
+    if (count == 0) {
+        return start;
+    }
+    NValue::UTF8Iterator iter(start, end);
+    return iter.skipCodePoints(count);
+}
+
+/**
+ * Copy length bytes to out, switching the case of the 26 letters from
+ * first, 'a' or 'A'. This is all the "C" locale the EE runs in changes,
+ * so bytes of multi-byte characters are copied as they are.
+ */
+static inline void switchAsciiCase(const char* in, size_t length, char* out, char first) {
+    size_t ii = 0;
+#ifdef __SSE2__
+    // Bytes from 0x80 up are negative here, so never in range.
+    const __m128i below = _mm_set1_epi8(static_cast<char>(first - 1));
+    const __m128i above = _mm_set1_epi8(static_cast<char>(first + 26));
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; ii + 16 <= length; ii += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + ii));
+        const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(bytes, below), _mm_cmplt_epi8(bytes, above));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + ii), _mm_xor_si128(bytes, _mm_and_si128(letters, caseBit)));
+    }
+#endif
+    for (; ii < length; ii++) {
+        const char c = in[ii];
+        out[ii] = (c >= first && c < first + 26) ? static_cast<char>(c ^ 0x20) : c;
+    }
+}
+
 template<> inline NValue NValue::callUnary<FUNC_FOLD_LOWER>() const {
     if (isNull()) {
         return getNullStringValue();
@@ -100,10 +166,9 @@ template<> inline NValue NValue::callUnary<FUNC_FOLD_LOWER>() const {
 
     int32_t length;
     const char* buf = getObject_withoutNull(&length);
-    std::string inputStr(buf, length);
-    boost::algorithm::to_lower(inputStr);
-
-    return getTempStringValue(inputStr.c_str(), length);
+    NValue retval(VALUE_TYPE_VARCHAR);
+    switchAsciiCase(buf, length, retval.allocateValueStorage(length, getTempStringPool()), 'A');
+    return retval;
 }
 
 template<> inline NValue NValue::callUnary<FUNC_FOLD_UPPER>() const {
@@ -116,10 +181,9 @@ template<> inline NValue NValue::callUnary<FUNC_FOLD_UPPER>() const {
 
     int32_t length;
     const char* buf = getObject_withoutNull(&length);
-    std::string inputStr(buf, length);
-    boost::algorithm::to_upper(inputStr);
-
-    return getTempStringValue(inputStr.c_str(), length);
+    NValue retval(VALUE_TYPE_VARCHAR);
+    switchAsciiCase(buf, length, retval.allocateValueStorage(length, getTempStringPool()), 'a');
+    return retval;
 }
 
 /** implement the 2-argument SQL REPEAT function */
@@ -224,6 +288,12 @@ template<> inline NValue NValue::call<FUNC_LEFT>(const std::vector<NValue>& argu
 
     int32_t length;
     const char* buf = strValue.getObject_withoutNull(&length);
+    // Up to and including the character after the last one kept, ASCII
+    // bytes are characters.
+    const int32_t scanned = std::min(count, length - 1) + 1;
+    if (asciiPrefixLength(buf, scanned) == static_cast<size_t>(scanned)) {
+        return getTempStringValue(buf, std::min(count, length));
+    }
 
     return getTempStringValue(buf, (int32_t)(getIthCharPosition(buf, length, count+1) - buf));
 }
@@ -258,6 +328,10 @@ template<> inline NValue NValue::call<FUNC_RIGHT>(const std::vector<NValue>& arg
     int32_t length;
     const char* buf = strValue.getObject_withoutNull(&length);
     const char *valueEnd = buf + length;
+    if (asciiPrefixLength(buf, length) == static_cast<size_t>(length)) {
+        const int32_t kept = std::min(count, length);
+        return getTempStringValue(valueEnd - kept, kept);
+    }
     int32_t charLen = getCharLength(buf, length);
     if (count >= charLen) {
         return getTempStringValue(buf, (int32_t)(valueEnd - buf));
@@ -327,31 +401,10 @@ template<> inline NValue NValue::call<FUNC_VOLT_SUBSTRING_CHAR_FROM>(const std::
 
     int64_t start = std::max(startArg.castAsBigIntAndGetValue(), static_cast<int64_t>(1L));
 
-    UTF8Iterator iter(valueChars, valueEnd);
-    const char* startChar = iter.skipCodePoints(start-1);
+    const char* startChar = skipCharacters(valueChars, valueEnd, start-1);
     return getTempStringValue(startChar, (int32_t)(valueEnd - startChar));
 }
 
-static inline std::string trim_function(std::string source, const std::string& match,
-        bool doltrim, bool dortrim) {
-    // Assuming SOURCE string and MATCH string are both valid UTF-8 strings
-    size_t mlen = match.length();
-    assert (mlen > 0);
-    if (doltrim) {
-        while (boost::starts_with(source, match)) {
-            source.erase(0, mlen);
-        }
-    }
-    if (dortrim) {
-        while (boost::ends_with(source, match)) {
-            source.erase(source.length() - mlen, mlen);
-        }
-    }
-
-    return source;
-}
-
-
 /** implement the 2-argument SQL TRIM functions */
 inline NValue NValue::trimWithOptions(const std::vector<NValue>& arguments, bool leading, bool trailing) {
     assert(arguments.size() == 2);
@@ -378,18 +431,28 @@ inline NValue NValue::trimWithOptions(const std::vector<NValue>& arguments, bool
                 "data exception -- trim error, invalid trim character length 0");
     }
 
-    std::string trimArg(buf, length);
+    const char* match = buf;
+    const int32_t matchLength = length;
 
     const NValue& strVal = arguments[1];
     if (strVal.getValueType() != VALUE_TYPE_VARCHAR) {
         throwCastSQLException (trimChar.getValueType(), VALUE_TYPE_VARCHAR);
     }
 
-    buf = strVal.getObject_withoutNull(&length);
-    std::string inputStr(buf, length);
-
-    std::string result = trim_function(inputStr, trimArg, leading, trailing);
-    return getTempStringValue(result.c_str(), result.length());
+    // Assuming both strings are valid UTF-8, a byte match is a character match.
+    const char* begin = strVal.getObject_withoutNull(&length);
+    const char* end = begin + length;
+    if (leading) {
+        while (end - begin >= matchLength && ::memcmp(begin, match, matchLength) == 0) {
+            begin += matchLength;
+        }
+    }
+    if (trailing) {
+        while (end - begin >= matchLength && ::memcmp(end - matchLength, match, matchLength) == 0) {
+            end -= matchLength;
+        }
+    }
+    return getTempStringValue(begin, end - begin);
 }
 
 template<> inline NValue NValue::call<FUNC_TRIM_BOTH_CHAR>(const std::vector<NValue>& arguments) {
@@ -484,9 +547,8 @@ template<> inline NValue NValue::call<FUNC_SUBSTRING_CHAR>(const std::vector<NVa
             length = 0;
         }
     }
-    UTF8Iterator iter(valueChars, valueEnd);
-    const char* startChar = iter.skipCodePoints(start-1);
-    const char* endChar = iter.skipCodePoints(length);
+    const char* startChar = skipCharacters(valueChars, valueEnd, start-1);
+    const char* endChar = skipCharacters(startChar, valueEnd, length);
     return getTempStringValue(startChar, endChar - startChar);
 }
 
@@ -851,8 +913,90 @@ static std::string pcre2_error_code_message(int error_code, std::string prefix)
     return std::string("Regular Expression Compilation Error: ") + reinterpret_cast<char *>(buffer);
 }
 
+/**
+ * A compiled regular expression with its match data. compile keeps what
+ * it has when asked for the same pattern and options again, so a caller
+ * that holds on to one compiles a constant or parameter pattern once.
+ *
+ * Note: We use shared_ptrs here, even though nothing is really shared.
+ *       We want to make sure the deleters, pcre2_code_free and
+ *       pcre2_match_data_free, are called.  Scoped_ptr will not allow
+ *       a custom deleter, and unique_ptr is not implementable without
+ *       C++11 move semantics.  The overhead is a reference count, which
+ *       is small compared with regular expression compilation and
+ *       matching.
+ */
+class CompiledRegexp {
+public:
+    CompiledRegexp() : m_options(0) { }
+
+    void compile(const unsigned char* pattern, int32_t length, uint32_t options) {
+        if (m_code.get() != NULL && m_options == options &&
+            m_pattern.size() == static_cast<size_t>(length) &&
+            ::memcmp(m_pattern.data(), pattern, length) == 0) {
+            return;
+        }
+        m_code.reset();
+        m_matchData.reset();
+        int error_code = 0;
+        PCRE2_SIZE error_offset = 0;
+        boost::shared_ptr<pcre2_code> code(pcre2_compile(pattern,
+                                                         length,
+                                                         options,
+                                                         &error_code,
+                                                         &error_offset,
+                                                         NULL), pcre2_code_free);
+        if (code.get() == NULL) {
+            std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Compilation Error: ");
+            throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
+        }
+        boost::shared_ptr<pcre2_match_data> matchData(pcre2_match_data_create_from_pattern(code.get(), NULL),
+                                                      pcre2_match_data_free);
+        if (matchData.get() == NULL) {
+            throw SQLException(SQLException::data_exception_invalid_parameter, "Internal error: Cannot create PCRE2 match data.");
+        }
+        m_pattern.assign(reinterpret_cast<const char*>(pattern), length);
+        m_options = options;
+        m_code = code;
+        m_matchData = matchData;
+    }
+
+    /** The byte offset of the first match in source, or -1 if none. */
+    int64_t firstMatch(const unsigned char* source, int32_t length) const {
+        assert(m_code.get() != NULL);
+        unsigned int matchFlags = 0;
+        int error_code = pcre2_match(m_code.get(),
+                                     source,
+                                     length,
+                                     0ul,
+                                     matchFlags,
+                                     m_matchData.get(),
+                                     NULL);
+        if (error_code < 0) {
+            if (error_code == PCRE2_ERROR_NOMATCH) {
+                return -1;
+            }
+            std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Matching Error: ");
+            throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
+        }
+        PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(m_matchData.get());
+        return static_cast<int64_t>(ovector[0]);
+    }
+
+private:
+    std::string m_pattern;
+    uint32_t m_options;
+    boost::shared_ptr<pcre2_code> m_code;
+    boost::shared_ptr<pcre2_match_data> m_matchData;
+};
+
 /** Implement the VoltDB SQL function regexp_position for re-based pattern matching */
 template<> inline NValue NValue::call<FUNC_VOLT_REGEXP_POSITION>(const std::vector<NValue>& arguments) {
+    CompiledRegexp regexp;
+    return regexpPosition(arguments, regexp);
+}
+
+inline NValue NValue::regexpPosition(const std::vector<NValue>& arguments, CompiledRegexp& regexp) {
     assert(arguments.size() == 2 || arguments.size() == 3);
 
     const NValue& source = arguments[0];
@@ -907,57 +1051,11 @@ template<> inline NValue NValue::call<FUNC_VOLT_REGEXP_POSITION>(const std::vect
     int32_t lenPat;
     const unsigned char* patChars = reinterpret_cast<const unsigned char*>
         (pat.getObject_withoutNull(&lenPat));
-    // Compile the pattern.
-
-    int error_code = 0;
-    PCRE2_SIZE error_offset = 0;
-    /*
-     * Note: We use a shared_ptr here, even though nothing is really shared.
-     *       We want to make sure the deleter, pcre2_code_free, is called when
-     *       this goes out of scope.  Scoped_ptr is a better choice here,
-     *       but it will not allow a custom deleter.  Unique_ptr is an even
-     *       better choice, but without C++11 move semantics this is not
-     *       really implementable, and this is a C++03 code.  So we are
-     *       stuck with shared_ptr.  The overhead is a reference count,
-     *       and an increment and decrement.  This is pretty small
-     *       compared with regular expression compilation and matching,
-     *       so it's not likely to be expensive.
-     */
-    boost::shared_ptr<pcre2_code> pattern ( pcre2_compile(patChars,
-                                                          lenPat,
-                                                          syntaxOpts,
-                                                          &error_code,
-                                                          &error_offset,
-                                                          NULL), pcre2_code_free );
-    if (pattern.get() == NULL) {
-        std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Compilation Error: ");
-        throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
-    }
-    /*
-     * We use a shared_ptr for the same reasons as above.
-     */
-    boost::shared_ptr<pcre2_match_data> match_data(pcre2_match_data_create_from_pattern(pattern.get(), NULL),
-                                                   pcre2_match_data_free);
-    if (match_data.get() == NULL) {
-        throw SQLException(SQLException::data_exception_invalid_parameter, "Internal error: Cannot create PCRE2 match data.");
-    }
-    unsigned int matchFlags = 0;
-    error_code = pcre2_match(pattern.get(),
-                      sourceChars,
-                      lenSource,
-                      0ul,
-                      matchFlags,
-                      match_data.get(),
-                      NULL);
-    if (error_code < 0) {
-        if (error_code == PCRE2_ERROR_NOMATCH) {
-            return getBigIntValue(0);
-        }
-        std::string emsg = pcre2_error_code_message(error_code, "Regular Expression Matching Error: ");
-        throw SQLException(SQLException::data_exception_invalid_parameter, emsg.c_str());
+    regexp.compile(patChars, lenPat, syntaxOpts);
+    int64_t position = regexp.firstMatch(sourceChars, lenSource);
+    if (position < 0) {
+        return getBigIntValue(0);
     }
-    PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(match_data.get());
-    unsigned long position = ovector[0];
     return getBigIntValue(getCharLength(reinterpret_cast<const char *>(sourceChars), position) + 1);
 }
 }
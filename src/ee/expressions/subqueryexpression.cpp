@@ -23,6 +23,7 @@
 #include "common/executorcontext.hpp"
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/tabletuple.h"
 #include "storage/table.h"
 #include "storage/tableiterator.h"
@@ -96,14 +97,8 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
 
     // Note the other (non-tve) parameter values and check if they've changed since the last invocation.
     if (hasPriorResult) {
-        std::vector<NValue>& lastParams = context->accessLastParams();
-        assert(lastParams.size() == m_otherParamIdxs.size());
-        for (size_t i = 0; i < lastParams.size(); ++i) {
-            NValue& prevParam = parameterContainer[m_otherParamIdxs[i]];
-            if (lastParams[i].compare(prevParam) != VALUE_COMPARE_EQUAL) {
-                lastParams[i] = prevParam.copyNValue();
-                paramsChanged = true;
-            }
+        if (refreshOtherParams(context)) {
+            paramsChanged = true;
         }
         if (paramsChanged) {
             // If parameters have changed since the last execution,
@@ -145,6 +140,60 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
     return retval;
 }
 
+bool SubqueryExpression::hasRows(const TableTuple *tuple1, const TableTuple *tuple2) const
+{
+    ExecutorContext* exeContext = ExecutorContext::getExecutorContext();
+    if (m_tveParams.get() == NULL) {
+        // Uncorrelated, so eval runs the subquery at most once anyway.
+        NValue lnv = eval(tuple1, tuple2);
+        return exeContext->getSubqueryOutputTable(ValuePeeker::peekInteger(lnv))->activeTupleCount() > 0;
+    }
+
+    size_t paramsCnt = m_tveParams->size();
+    std::vector<NValue> params;
+    params.reserve(paramsCnt);
+    for (size_t i = 0; i < paramsCnt; ++i) {
+        params.push_back((*m_tveParams)[i]->eval(tuple1, tuple2));
+    }
+    SubqueryContext* context = exeContext->getSubqueryContext(m_subqueryId);
+    if (context != NULL) {
+        refreshOtherParams(context);
+        const bool* exists = context->findExists(params);
+        if (exists != NULL) {
+            return *exists;
+        }
+    }
+
+    eval(tuple1, tuple2);
+    bool exists = exeContext->getSubqueryOutputTable(m_subqueryId)->activeTupleCount() > 0;
+    for (size_t i = 0; i < paramsCnt; ++i) {
+        params[i] = params[i].copyNValue();
+    }
+    exeContext->getSubqueryContext(m_subqueryId)->rememberExists(params, exists);
+    return exists;
+}
+
+bool SubqueryExpression::refreshOtherParams(SubqueryContext* context) const
+{
+    NValueArray& parameterContainer = *(ExecutorContext::getExecutorContext()->getParameterContainer());
+    std::vector<NValue>& lastParams = context->accessLastParams();
+    assert(lastParams.size() == m_otherParamIdxs.size());
+    bool paramsChanged = false;
+    for (size_t i = 0; i < lastParams.size(); ++i) {
+        NValue& prevParam = parameterContainer[m_otherParamIdxs[i]];
+        if (lastParams[i].compare(prevParam) != VALUE_COMPARE_EQUAL) {
+            lastParams[i] = prevParam.copyNValue();
+            paramsChanged = true;
+        }
+    }
+    if (paramsChanged) {
+        context->forgetExists();
+        // The last result was for the old values too.
+        context->invalidateResult();
+    }
+    return paramsChanged;
+}
+
 std::string SubqueryExpression::debugInfo(const std::string &spacer) const
 {
     std::ostringstream buffer;
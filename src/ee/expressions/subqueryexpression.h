@@ -26,6 +26,8 @@
 
 namespace voltdb {
 
+struct SubqueryContext;
+
 /**
  * An expression that produces a temp table from a subquery.
  * Note that this expression type's eval method is a little
@@ -45,9 +47,20 @@ class SubqueryExpression : public AbstractExpression {
 
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const;
 
+    /**
+     * Whether the subquery produces any row, as EXISTS asks. For a
+     * correlated subquery the answer is remembered by correlation values
+     * (see SubqueryContext), so the subquery runs once per distinct set.
+     */
+    bool hasRows(const TableTuple *tuple1, const TableTuple *tuple2) const;
+
     std::string debugInfo(const std::string &spacer) const;
 
   private:
+    // Note the current values of the other parameters, returning whether
+    // any of them changed since the context's last result.
+    bool refreshOtherParams(SubqueryContext* context) const;
+
     const int m_subqueryId;
 
     // The list of parameter indexes that need to be set by this subquery
@@ -83,6 +83,16 @@ class TupleValueExpression : public AbstractExpression {
         }
     }
 
+    virtual void evalBatch(const TableTuple *tuples, const int *selection, int count, NValue *results) const {
+        if (tuple_idx != 0) {
+            AbstractExpression::evalBatch(tuples, selection, count, results);
+            return;
+        }
+        for (int ii = 0; ii < count; ii++) {
+            results[ii] = tuples[selection[ii]].getNValue(value_idx);
+        }
+    }
+
     std::string debugInfo(const std::string &spacer) const {
         std::ostringstream buffer;
         buffer << spacer << "Optimized Column Reference[" << tuple_idx << ", " << value_idx << "]\n";
@@ -91,6 +101,8 @@ class TupleValueExpression : public AbstractExpression {
 
     int getColumnId() const {return this->value_idx;}
 
+    int getTupleId() const {return this->tuple_idx;}
+
   protected:
 
     const int tuple_idx;           // which tuple. defaults to tuple1
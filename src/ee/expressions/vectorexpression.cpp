@@ -69,6 +69,16 @@ public:
         return m_inList;
     }
 
+    bool isExecutionConstant() const
+    {
+        for (size_t i = 0; i < m_args.size(); ++i) {
+            if ( ! m_args[i]->isExecutionConstant()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     std::string debugInfo(const std::string &spacer) const
     {
         return spacer + "VectorExpression\n";
@@ -134,6 +134,35 @@ class CompactingHashMultiMapIndex : public TableIndex
         return true;
     }
 
+    int moveToKeys(const std::vector<const TableTuple*> &searchKeys, std::vector<IndexCursor> &cursors) const {
+        assert(cursors.size() >= searchKeys.size());
+        const int count = static_cast<int>(searchKeys.size());
+        if (count == 0) {
+            return 0;
+        }
+        std::vector<KeyType> keys;
+        keys.reserve(count);
+        for (int ii = 0; ii < count; ++ii) {
+            keys.push_back(KeyType(searchKeys[ii]));
+        }
+        std::vector<MapIterator> found(count);
+        m_entries.findBatch(&keys[0], count, &found[0]);
+
+        int matches = 0;
+        for (int ii = 0; ii < count; ++ii) {
+            IndexCursor &cursor = cursors[ii];
+            MapIterator &mapIter = castToIter(cursor);
+            mapIter = found[ii];
+            if (mapIter.isEnd()) {
+                cursor.m_match.move(NULL);
+                continue;
+            }
+            cursor.m_match.move(const_cast<void*>(mapIter.value()));
+            ++matches;
+        }
+        return matches;
+    }
+
     bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const {
         MapIterator &mapIter = castToIter(cursor);
         mapIter = findTuple(*persistentTuple);
@@ -167,6 +196,8 @@ class CompactingHashMultiMapIndex : public TableIndex
 
     size_t getSize() const { return m_entries.size(); }
 
+    void ensureCapacity(size_t entryCount) { m_entries.reserve(entryCount); }
+
     int64_t getMemoryEstimate() const
     {
         return m_entries.bytesAllocated();
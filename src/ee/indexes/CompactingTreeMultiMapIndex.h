@@ -46,8 +46,10 @@
 #ifndef COMPACTINGTREEMULTIMAPINDEX_H_
 #define COMPACTINGTREEMULTIMAPINDEX_H_
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <vector>
 #include "indexes/tableindex.h"
 #include "common/tabletuple.h"
 #include "structures/CompactingMap.h"
@@ -55,15 +57,17 @@
 namespace voltdb {
 
 /**
- * Index implemented as a Binary Tree Multimap.
+ * Index implemented as a Binary Tree Multimap, or as a B+tree Multimap when
+ * Map is CompactingBTree.
  * @see TableIndex
  */
-template<typename KeyValuePair, bool hasRank>
+template<typename KeyValuePair, bool hasRank,
+         template<typename, typename, bool> class Map = CompactingMap>
 class CompactingTreeMultiMapIndex : public TableIndex
 {
     typedef typename KeyValuePair::first_type KeyType;
     typedef typename KeyType::KeyComparator KeyComparator;
-    typedef CompactingMap<KeyValuePair, KeyComparator, hasRank> MapType;
+    typedef Map<KeyValuePair, KeyComparator, hasRank> MapType;
     typedef typename MapType::iterator MapIterator;
     typedef std::pair<MapIterator, MapIterator> MapRange;
 
@@ -73,6 +77,17 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return *reinterpret_cast<MapIterator*> (cursor.m_keyIter);
     }
 
+    // Touch the tuple a few entries further along the scan, so that its
+    // cache miss overlaps the caller's work on this one.
+    static void prefetchTupleAhead(const MapIterator &mapIter, bool forward)
+    {
+        const void * const *ahead =
+            mapIter.peekValue(forward ? TUPLE_PREFETCH_DISTANCE : -TUPLE_PREFETCH_DISTANCE);
+        if (ahead) {
+            __builtin_prefetch(*ahead);
+        }
+    }
+
     static MapIterator& castToEndIter(IndexCursor& cursor) {
         return *reinterpret_cast<MapIterator*> (cursor.m_keyEndIter);
     }
@@ -83,6 +98,49 @@ class CompactingTreeMultiMapIndex : public TableIndex
         m_entries.insert(setKeyFromTuple(tuple), tuple->address());
     }
 
+    /**
+     * Inserting in key order keeps each insert's path through the tree
+     * close to the previous one's. The sort is stable so that, as with
+     * one insert at a time, the first of several equal keys in the batch
+     * is the one that gets in.
+     */
+    void addEntriesDo(const std::vector<const TableTuple*> &tuples,
+                      const std::vector<TableTuple*> &conflictTuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::stable_sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        for (std::vector<int>::const_iterator ii = order.begin(); ii != order.end(); ++ii) {
+            ++m_inserts;
+            m_entries.insert(keys[*ii], tuples[*ii]->address());
+        }
+    }
+
+    /**
+     * Build the tree bottom-up from the sorted keys rather than inserting
+     * and rebalancing one key at a time.
+     */
+    void addEntriesToEmptyIndexDo(const std::vector<const TableTuple*> &tuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::stable_sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        m_inserts += order.size();
+        m_entries.buildFromSorted(SortedEntries(keys, order, tuples), order.size());
+    }
+
     bool deleteEntryDo(const TableTuple *tuple)
     {
         ++m_deletes;
@@ -93,6 +151,28 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return m_entries.erase(iter);
     }
 
+    /**
+     * Deleting in key order keeps each delete's path through the tree
+     * close to the previous one's.
+     */
+    bool deleteEntriesDo(const std::vector<const TableTuple*> &tuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        bool found = true;
+        for (std::vector<int>::const_iterator ii = order.begin(); ii != order.end(); ++ii) {
+            found &= deleteEntryDo(tuples[*ii]);
+        }
+        return found;
+    }
+
     /**
      * Update in place an index entry with a new tuple address
      * (e.g., due to table compaction)
@@ -140,6 +220,41 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return true;
     }
 
+    int moveToKeys(const std::vector<const TableTuple*> &searchKeys, std::vector<IndexCursor> &cursors) const
+    {
+        assert(cursors.size() >= searchKeys.size());
+        const int count = static_cast<int>(searchKeys.size());
+        if (count == 0) {
+            return 0;
+        }
+        std::vector<KeyType> keys;
+        keys.reserve(count);
+        for (int ii = 0; ii < count; ++ii) {
+            keys.push_back(KeyType(searchKeys[ii]));
+        }
+        std::vector<MapIterator> found(count);
+        m_entries.lowerBounds(&keys[0], count, &found[0]);
+
+        int matches = 0;
+        for (int ii = 0; ii < count; ++ii) {
+            IndexCursor &cursor = cursors[ii];
+            cursor.m_forward = true;
+            MapIterator &mapIter = castToIter(cursor);
+            MapIterator &mapEndIter = castToEndIter(cursor);
+            mapIter = found[ii];
+            // The lower bound brought the path to the end of the range
+            // into the cache.
+            mapEndIter = m_entries.upperBound(keys[ii]);
+            if (mapIter.equals(mapEndIter)) {
+                cursor.m_match.move(NULL);
+                continue;
+            }
+            cursor.m_match.move(const_cast<void*>(mapIter.value()));
+            ++matches;
+        }
+        return matches;
+    }
+
     bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const
     {
         cursor.m_forward = true;
@@ -240,6 +355,7 @@ class CompactingTreeMultiMapIndex : public TableIndex
 
         if (! mapIter.isEnd()) {
             retval.move(const_cast<void*>(mapIter.value()));
+            prefetchTupleAhead(mapIter, cursor.m_forward);
             if (cursor.m_forward) {
                 mapIter.moveNext();
             } else {
@@ -264,10 +380,39 @@ class CompactingTreeMultiMapIndex : public TableIndex
             cursor.m_match.move(NULL);
         } else {
             cursor.m_match.move(const_cast<void*>(mapIter.value()));
+            prefetchTupleAhead(mapIter, true);
         }
         return retval;
     }
 
+    bool skipEntries(IndexCursor& cursor, int64_t count) const
+    {
+        if (!hasRank) {
+            return false;
+        }
+        MapIterator &mapIter = castToIter(cursor);
+        if (mapIter.isEnd()) {
+            return true;
+        }
+        int64_t rank = m_entries.rankOf(mapIter);
+        rank += cursor.m_forward ? count : -count;
+        if (cursor.m_match.isNullTuple()) {
+            mapIter = m_entries.findRank(rank);
+            return true;
+        }
+        // Positioned by moveToKey(): stay within the key's entries.
+        MapIterator &mapEndIter = castToEndIter(cursor);
+        int64_t endRank = mapEndIter.isEnd() ? m_entries.size() + 1 : m_entries.rankOf(mapEndIter);
+        if (rank >= endRank) {
+            mapIter = mapEndIter;
+            cursor.m_match.move(NULL);
+        } else {
+            mapIter = m_entries.findRank(rank);
+            cursor.m_match.move(const_cast<void*>(mapIter.value()));
+        }
+        return true;
+    }
+
     bool advanceToNextKey(IndexCursor& cursor) const
     {
         MapIterator &mapEndIter = castToEndIter(cursor);
@@ -401,6 +546,29 @@ class CompactingTreeMultiMapIndex : public TableIndex
         return result;
     }
 
+    // Orders the positions of a batch of keys.
+    class KeyOrder {
+    public:
+        KeyOrder(const std::vector<KeyType> &keys, const KeyComparator &cmp) : m_keys(keys), m_cmp(cmp) { }
+        bool operator()(int lhs, int rhs) const { return m_cmp(m_keys[lhs], m_keys[rhs]) < 0; }
+    private:
+        const std::vector<KeyType> &m_keys;
+        const KeyComparator &m_cmp;
+    };
+
+    class SortedEntries {
+    public:
+        SortedEntries(const std::vector<KeyType> &keys, const std::vector<int> &order,
+                      const std::vector<const TableTuple*> &tuples)
+          : m_keys(keys), m_order(order), m_tuples(tuples) { }
+        const KeyType &key(int64_t ii) const { return m_keys[m_order[ii]]; }
+        const void *value(int64_t ii) const { return m_tuples[m_order[ii]]->address(); }
+    private:
+        const std::vector<KeyType> &m_keys;
+        const std::vector<int> &m_order;
+        const std::vector<const TableTuple*> &m_tuples;
+    };
+
     MapType m_entries;
 
     // comparison stuff
@@ -46,47 +46,183 @@
 #ifndef COMPACTINGTREEUNIQUEINDEX_H_
 #define COMPACTINGTREEUNIQUEINDEX_H_
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <vector>
 
 #include "common/debuglog.h"
 #include "common/tabletuple.h"
+#include "indexes/indexkey.h"
 #include "indexes/tableindex.h"
+#include "structures/BlockedBloomFilter.h"
 #include "structures/CompactingMap.h"
 
 namespace voltdb {
 
 /**
- * Index implemented as a Binary Tree Unique Map.
+ * Hashes the keys of a unique tree index for its key filter. Every key
+ * type with a hasher, as hash indexes need, can be filtered; TupleKey has
+ * none, so its indexes go without.
+ */
+template<typename KeyType>
+struct KeyFilterHasher : public KeyType::KeyHasher
+{
+    static const bool enabled = true;
+    KeyFilterHasher(const TupleSchema *keySchema) : KeyType::KeyHasher(keySchema) {}
+};
+
+template<>
+struct KeyFilterHasher<TupleKey>
+{
+    static const bool enabled = false;
+    KeyFilterHasher(const TupleSchema *unused_keySchema) {}
+    size_t operator()(const TupleKey &unused_key) const { return 0; }
+};
+
+/**
+ * Index implemented as a Binary Tree Unique Map, or as a B+tree Unique Map when
+ * Map is CompactingBTree.
  * @see TableIndex
  */
-template<typename KeyValuePair, bool hasRank>
+template<typename KeyValuePair, bool hasRank,
+         template<typename, typename, bool> class Map = CompactingMap>
 class CompactingTreeUniqueIndex : public TableIndex
 {
     typedef typename KeyValuePair::first_type KeyType;
     typedef typename KeyType::KeyComparator KeyComparator;
-    typedef CompactingMap<KeyValuePair, KeyComparator, hasRank> MapType;
+    typedef Map<KeyValuePair, KeyComparator, hasRank> MapType;
     typedef typename MapType::iterator MapIterator;
 
+    // Below this many entries a lookup that misses is cheap enough without
+    // a key filter.
+    static const int64_t KEY_FILTER_MIN_ENTRIES = 16 * 1024;
+
     ~CompactingTreeUniqueIndex() {};
 
     static MapIterator& castToIter(IndexCursor& cursor) {
         return *reinterpret_cast<MapIterator*> (cursor.m_keyIter);
     }
 
+    // Touch the tuple a few entries further along the scan, so that its
+    // cache miss overlaps the caller's work on this one.
+    static void prefetchTupleAhead(const MapIterator &mapIter, bool forward)
+    {
+        const void * const *ahead =
+            mapIter.peekValue(forward ? TUPLE_PREFETCH_DISTANCE : -TUPLE_PREFETCH_DISTANCE);
+        if (ahead) {
+            __builtin_prefetch(*ahead);
+        }
+    }
+
     void addEntryDo(const TableTuple *tuple, TableTuple *conflictTuple)
     {
         ++m_inserts;
-        const void* const* conflictEntry = m_entries.insert(setKeyFromTuple(tuple), tuple->address());
-        if (conflictEntry != NULL && conflictTuple != NULL) {
+        const KeyType key = setKeyFromTuple(tuple);
+        const void* const* conflictEntry = m_entries.insert(key, tuple->address());
+        if (conflictEntry == NULL) {
+            addToKeyFilter(key);
+        }
+        else if (conflictTuple != NULL) {
             conflictTuple->move(const_cast<void*>(*conflictEntry));
         }
     }
 
+    /**
+     * Inserting in key order keeps each insert's path through the tree
+     * close to the previous one's. The sort is stable so that, as with
+     * one insert at a time, the first of several equal keys in the batch
+     * is the one that gets in.
+     */
+    void addEntriesDo(const std::vector<const TableTuple*> &tuples,
+                      const std::vector<TableTuple*> &conflictTuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::stable_sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        for (std::vector<int>::const_iterator ii = order.begin(); ii != order.end(); ++ii) {
+            ++m_inserts;
+            const void* const* conflictEntry = m_entries.insert(keys[*ii], tuples[*ii]->address());
+            if (conflictEntry == NULL) {
+                addToKeyFilter(keys[*ii]);
+            }
+            else if (conflictTuples[*ii] != NULL) {
+                conflictTuples[*ii]->move(const_cast<void*>(*conflictEntry));
+            }
+        }
+    }
+
+    /**
+     * Build the tree bottom-up from the sorted keys rather than inserting
+     * and rebalancing one key at a time. As with addEntry, only the first
+     * in table order of several tuples with equal keys gets in.
+     */
+    void addEntriesToEmptyIndexDo(const std::vector<const TableTuple*> &tuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::stable_sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        std::vector<int>::iterator last = order.begin();
+        for (std::vector<int>::iterator ii = order.begin(); ii != order.end(); ++ii) {
+            if (ii == order.begin() || m_cmp(keys[*(last - 1)], keys[*ii]) != 0) {
+                *last++ = *ii;
+            }
+        }
+        order.erase(last, order.end());
+        m_inserts += order.size();
+        m_entries.buildFromSorted(SortedEntries(keys, order, tuples), order.size());
+        rebuildKeyFilter();
+    }
+
     bool deleteEntryDo(const TableTuple *tuple)
     {
         ++m_deletes;
-        return m_entries.erase(setKeyFromTuple(tuple));
+        if ( ! m_entries.erase(setKeyFromTuple(tuple))) {
+            return false;
+        }
+        // The key's bits stay set until the filter is rebuilt.
+        ++m_keyFilterRemovals;
+        return true;
+    }
+
+    /**
+     * Deleting in key order keeps each delete's path through the tree
+     * close to the previous one's.
+     */
+    bool deleteEntriesDo(const std::vector<const TableTuple*> &tuples)
+    {
+        std::vector<KeyType> keys;
+        keys.reserve(tuples.size());
+        std::vector<int> order;
+        order.reserve(tuples.size());
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            keys.push_back(setKeyFromTuple(tuples[ii]));
+            order.push_back(ii);
+        }
+        std::sort(order.begin(), order.end(), KeyOrder(keys, m_cmp));
+        bool found = true;
+        for (std::vector<int>::const_iterator ii = order.begin(); ii != order.end(); ++ii) {
+            ++m_deletes;
+            if (m_entries.erase(keys[*ii])) {
+                ++m_keyFilterRemovals;
+            }
+            else {
+                found = false;
+            }
+        }
+        return found;
     }
 
     /**
@@ -141,6 +277,38 @@ class CompactingTreeUniqueIndex : public TableIndex
         return true;
     }
 
+    int moveToKeys(const std::vector<const TableTuple*> &searchKeys, std::vector<IndexCursor> &cursors) const
+    {
+        assert(cursors.size() >= searchKeys.size());
+        const int count = static_cast<int>(searchKeys.size());
+        if (count == 0) {
+            return 0;
+        }
+        std::vector<KeyType> keys;
+        keys.reserve(count);
+        for (int ii = 0; ii < count; ++ii) {
+            keys.push_back(KeyType(searchKeys[ii]));
+        }
+        std::vector<MapIterator> found(count);
+        m_entries.lowerBounds(&keys[0], count, &found[0]);
+
+        int matches = 0;
+        for (int ii = 0; ii < count; ++ii) {
+            IndexCursor &cursor = cursors[ii];
+            cursor.m_forward = true;
+            MapIterator &mapIter = castToIter(cursor);
+            if (found[ii].isEnd() || m_cmp(found[ii].key(), keys[ii]) != 0) {
+                mapIter = MapIterator();
+                cursor.m_match.move(NULL);
+                continue;
+            }
+            mapIter = found[ii];
+            cursor.m_match.move(const_cast<void*>(mapIter.value()));
+            ++matches;
+        }
+        return matches;
+    }
+
     bool moveToKeyByTuple(const TableTuple *persistentTuple, IndexCursor &cursor) const
     {
         cursor.m_forward = true;
@@ -238,6 +406,7 @@ class CompactingTreeUniqueIndex : public TableIndex
 
         if (! mapIter.isEnd()) {
             retval.move(const_cast<void*>(mapIter.value()));
+            prefetchTupleAhead(mapIter, cursor.m_forward);
             if (cursor.m_forward) {
                 mapIter.moveNext();
             } else {
@@ -255,6 +424,27 @@ class CompactingTreeUniqueIndex : public TableIndex
         return retval;
     }
 
+    bool skipEntries(IndexCursor& cursor, int64_t count) const
+    {
+        if (!hasRank) {
+            return false;
+        }
+        if (!cursor.m_match.isNullTuple()) {
+            // Positioned by moveToKey() on the one entry with the key.
+            if (count > 0) {
+                cursor.m_match.move(NULL);
+            }
+            return true;
+        }
+        MapIterator &mapIter = castToIter(cursor);
+        if (mapIter.isEnd()) {
+            return true;
+        }
+        int64_t rank = m_entries.rankOf(mapIter);
+        mapIter = m_entries.findRank(cursor.m_forward ? rank + count : rank - count);
+        return true;
+    }
+
     bool advanceToNextKey(IndexCursor& cursor) const
     {
         MapIterator &mapIter = castToIter(cursor);
@@ -332,7 +522,24 @@ class CompactingTreeUniqueIndex : public TableIndex
 
     int64_t getMemoryEstimate() const
     {
-        return m_entries.bytesAllocated();
+        return m_entries.bytesAllocated() + m_keyFilter.bytesAllocated();
+    }
+
+    /**
+     * Sizes the key filter for the index as it is now, dropping the bits of
+     * deleted keys, or turns it off if the index has become small.
+     */
+    void rebuildKeyFilter()
+    {
+        m_keyFilterRemovals = 0;
+        if ( ! KeyFilterHasher<KeyType>::enabled || m_entries.size() < KEY_FILTER_MIN_ENTRIES) {
+            m_keyFilter.reset(0);
+            return;
+        }
+        m_keyFilter.reset(2 * m_entries.size());
+        for (MapIterator iter = m_entries.begin(); ! iter.isEnd(); iter.moveNext()) {
+            m_keyFilter.add(m_keyFilterHasher(iter.key()));
+        }
     }
 
     std::string debug() const
@@ -354,16 +561,43 @@ class CompactingTreeUniqueIndex : public TableIndex
 
     virtual TableIndex *cloneEmptyNonCountingTreeIndex() const
     {
-        return new CompactingTreeUniqueIndex<KeyValuePair, false >(TupleSchema::createTupleSchema(getKeySchema()), m_scheme);
+        return new CompactingTreeUniqueIndex<KeyValuePair, false, Map>(TupleSchema::createTupleSchema(getKeySchema()), m_scheme);
     }
 
 
     MapIterator findKey(const TableTuple *searchKey) const {
-        return m_entries.find(KeyType(searchKey));
+        return find(KeyType(searchKey));
     }
 
     MapIterator findTuple(const TableTuple &originalTuple) const {
-        return m_entries.find(setKeyFromTuple(&originalTuple));
+        return find(setKeyFromTuple(&originalTuple));
+    }
+
+    // Most inserts into a unique index are of new keys, so the probe for an
+    // existing one usually misses. The key filter answers those without
+    // walking the tree.
+    MapIterator find(const KeyType &key) const {
+        if (m_keyFilter.capacity() != 0 && ! m_keyFilter.mayContain(m_keyFilterHasher(key))) {
+            return MapIterator();
+        }
+        return m_entries.find(key);
+    }
+
+    // Once the filter has taken as many keys as it was sized for, counting
+    // the deleted ones whose bits are still set, it is rebuilt at twice the
+    // index's size. It is first built when the index grows large enough.
+    void addToKeyFilter(const KeyType &key) {
+        if (m_keyFilter.capacity() == 0) {
+            if (KeyFilterHasher<KeyType>::enabled && m_entries.size() >= KEY_FILTER_MIN_ENTRIES) {
+                rebuildKeyFilter();
+            }
+            return;
+        }
+        if (static_cast<size_t>(m_entries.size()) + m_keyFilterRemovals > m_keyFilter.capacity()) {
+            rebuildKeyFilter();
+            return;
+        }
+        m_keyFilter.add(m_keyFilterHasher(key));
     }
 
     const KeyType setKeyFromTuple(const TableTuple *tuple) const
@@ -372,16 +606,46 @@ class CompactingTreeUniqueIndex : public TableIndex
         return result;
     }
 
+    // Orders the positions of a batch of keys.
+    class KeyOrder {
+    public:
+        KeyOrder(const std::vector<KeyType> &keys, const KeyComparator &cmp) : m_keys(keys), m_cmp(cmp) { }
+        bool operator()(int lhs, int rhs) const { return m_cmp(m_keys[lhs], m_keys[rhs]) < 0; }
+    private:
+        const std::vector<KeyType> &m_keys;
+        const KeyComparator &m_cmp;
+    };
+
+    class SortedEntries {
+    public:
+        SortedEntries(const std::vector<KeyType> &keys, const std::vector<int> &order,
+                      const std::vector<const TableTuple*> &tuples)
+          : m_keys(keys), m_order(order), m_tuples(tuples) { }
+        const KeyType &key(int64_t ii) const { return m_keys[m_order[ii]]; }
+        const void *value(int64_t ii) const { return m_tuples[m_order[ii]]->address(); }
+    private:
+        const std::vector<KeyType> &m_keys;
+        const std::vector<int> &m_order;
+        const std::vector<const TableTuple*> &m_tuples;
+    };
+
     MapType m_entries;
 
     // comparison stuff
     KeyComparator m_cmp;
 
+    // Rules out most lookups of absent keys; off while the index is small.
+    KeyFilterHasher<KeyType> m_keyFilterHasher;
+    BlockedBloomFilter m_keyFilter;
+    size_t m_keyFilterRemovals;
+
 public:
     CompactingTreeUniqueIndex(const TupleSchema *keySchema, const TableIndexScheme &scheme) :
         TableIndex(keySchema, scheme),
         m_entries(true, KeyComparator(keySchema)),
-        m_cmp(keySchema)
+        m_cmp(keySchema),
+        m_keyFilterHasher(keySchema),
+        m_keyFilterRemovals(0)
     {}
 };
 
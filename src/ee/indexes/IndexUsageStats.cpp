@@ -0,0 +1,170 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexes/IndexUsageStats.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "indexes/tableindex.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+#include <vector>
+#include <string>
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> IndexUsageStats::generateIndexUsageStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("TABLE_NAME");
+    columnNames.push_back("INDEX_NAME");
+    columnNames.push_back("LOOKUPS");
+    columnNames.push_back("RANGE_SCANS");
+    columnNames.push_back("SEQ_SCANS");
+    columnNames.push_back("ROWS_RETURNED");
+    columnNames.push_back("ENTRIES_INSERTED");
+    columnNames.push_back("ENTRIES_DELETED");
+    columnNames.push_back("ENTRIES_UPDATED");
+
+    return columnNames;
+}
+
+void IndexUsageStats::populateIndexUsageStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+
+    // table name
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(4096);
+    allowNull.push_back(false);
+    inBytes.push_back(false);
+
+    // index name, NULL on the row of the table's sequential scans
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(4096);
+    allowNull.push_back(true);
+    inBytes.push_back(false);
+
+    // lookups, range scans, sequential scans, rows returned, and entries
+    // inserted, deleted and updated
+    for (int ii = 0; ii < 7; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        allowNull.push_back(false);
+        inBytes.push_back(false);
+    }
+}
+
+TempTable* IndexUsageStats::generateEmptyIndexUsageStatsTable() {
+    string name = "Persistent Table aggregated index usage stats temp table";
+    vector<string> columnNames = IndexUsageStats::generateIndexUsageStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    IndexUsageStats::populateIndexUsageStatsSchema(columnTypes, columnLengths,
+                                                   columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+IndexUsageStats::IndexUsageStats(TableIndex* index)
+    : StatsSource(), m_index(index)
+{
+}
+
+void IndexUsageStats::configure(string name, string tableName) {
+    StatsSource::configure(name);
+    m_tableName.free();
+    m_tableName = ValueFactory::getStringValue(tableName);
+    m_indexName.free();
+    if (m_index != NULL) {
+        m_indexName = ValueFactory::getStringValue(m_index->getName());
+    }
+    else {
+        m_indexName = ValueFactory::getNullStringValue();
+    }
+}
+
+void IndexUsageStats::rename(std::string name) {
+    m_indexName.free();
+    m_indexName = ValueFactory::getStringValue(name);
+}
+
+vector<string> IndexUsageStats::generateStatsColumnNames()
+{
+    return IndexUsageStats::generateIndexUsageStatsColumnNames();
+}
+
+void IndexUsageStats::updateStatsTuple(TableTuple *tuple) {
+    if (m_index != NULL) {
+        m_counters.m_entriesInserted = m_index->getInsertCount();
+        m_counters.m_entriesDeleted = m_index->getDeleteCount();
+        m_counters.m_entriesUpdated = m_index->getUpdateCount();
+    }
+    Counters counters = m_counters;
+    if (interval()) {
+        counters.m_lookups -= m_lastCounters.m_lookups;
+        counters.m_rangeScans -= m_lastCounters.m_rangeScans;
+        counters.m_seqScans -= m_lastCounters.m_seqScans;
+        counters.m_rowsReturned -= m_lastCounters.m_rowsReturned;
+        counters.m_entriesInserted -= m_lastCounters.m_entriesInserted;
+        counters.m_entriesDeleted -= m_lastCounters.m_entriesDeleted;
+        counters.m_entriesUpdated -= m_lastCounters.m_entriesUpdated;
+        m_lastCounters = m_counters;
+    }
+
+    tuple->setNValue(StatsSource::m_columnName2Index["TABLE_NAME"], m_tableName);
+    tuple->setNValue(StatsSource::m_columnName2Index["INDEX_NAME"], m_indexName);
+    tuple->setNValue(StatsSource::m_columnName2Index["LOOKUPS"],
+                     ValueFactory::getBigIntValue(counters.m_lookups));
+    tuple->setNValue(StatsSource::m_columnName2Index["RANGE_SCANS"],
+                     ValueFactory::getBigIntValue(counters.m_rangeScans));
+    tuple->setNValue(StatsSource::m_columnName2Index["SEQ_SCANS"],
+                     ValueFactory::getBigIntValue(counters.m_seqScans));
+    tuple->setNValue(StatsSource::m_columnName2Index["ROWS_RETURNED"],
+                     ValueFactory::getBigIntValue(counters.m_rowsReturned));
+    tuple->setNValue(StatsSource::m_columnName2Index["ENTRIES_INSERTED"],
+                     ValueFactory::getBigIntValue(counters.m_entriesInserted));
+    tuple->setNValue(StatsSource::m_columnName2Index["ENTRIES_DELETED"],
+                     ValueFactory::getBigIntValue(counters.m_entriesDeleted));
+    tuple->setNValue(StatsSource::m_columnName2Index["ENTRIES_UPDATED"],
+                     ValueFactory::getBigIntValue(counters.m_entriesUpdated));
+}
+
+void IndexUsageStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes)
+{
+    IndexUsageStats::populateIndexUsageStatsSchema(types, columnLengths, allowNull, inBytes);
+}
+
+IndexUsageStats::~IndexUsageStats() {
+    m_tableName.free();
+    m_indexName.free();
+}
@@ -0,0 +1,111 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEXUSAGESTATS_H_
+#define INDEXUSAGESTATS_H_
+
+#include "stats/StatsSource.h"
+
+namespace voltdb {
+class TableIndex;
+class TableTuple;
+class TempTable;
+
+/**
+ * StatsSource for how an index is used: how often it is probed for one
+ * key or scanned over a range, the rows those return, and the entries
+ * written to keep it up to date. A table has one more, with no index,
+ * for its sequential scans. Next to each other, they show the indexes a
+ * table pays to maintain but rarely reads, or reads for many rows at a
+ * time.
+ */
+class IndexUsageStats : public StatsSource {
+public:
+    static std::vector<std::string> generateIndexUsageStatsColumnNames();
+
+    static void populateIndexUsageStatsSchema(std::vector<voltdb::ValueType>& types,
+                                              std::vector<int32_t>& columnLengths,
+                                              std::vector<bool>& allowNull,
+                                              std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyIndexUsageStatsTable();
+
+    /**
+     * Usage of the index, or of the table's sequential scans when the
+     * index is NULL.
+     */
+    IndexUsageStats(voltdb::TableIndex* index);
+
+    ~IndexUsageStats();
+
+    void configure(std::string name, std::string tableName);
+
+    void rename(std::string name);
+
+    void recordLookup(int64_t rowsReturned) {
+        ++m_counters.m_lookups;
+        m_counters.m_rowsReturned += rowsReturned;
+    }
+
+    void recordRangeScan(int64_t rowsReturned) {
+        ++m_counters.m_rangeScans;
+        m_counters.m_rowsReturned += rowsReturned;
+    }
+
+    void recordSeqScan(int64_t rowsReturned) {
+        ++m_counters.m_seqScans;
+        m_counters.m_rowsReturned += rowsReturned;
+    }
+
+protected:
+    virtual void updateStatsTuple(TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    struct Counters {
+        Counters()
+            : m_lookups(0), m_rangeScans(0), m_seqScans(0), m_rowsReturned(0),
+              m_entriesInserted(0), m_entriesDeleted(0), m_entriesUpdated(0)
+        { }
+
+        int64_t m_lookups;
+        int64_t m_rangeScans;
+        int64_t m_seqScans;
+        int64_t m_rowsReturned;
+        // Read from the index when the stats are requested.
+        int64_t m_entriesInserted;
+        int64_t m_entriesDeleted;
+        int64_t m_entriesUpdated;
+    };
+
+    voltdb::TableIndex *m_index;
+
+    voltdb::NValue m_tableName;
+    voltdb::NValue m_indexName;
+
+    Counters m_counters;
+    // The counters at the last interval request.
+    Counters m_lastCounters;
+};
+
+}
+
+#endif /* INDEXUSAGESTATS_H_ */
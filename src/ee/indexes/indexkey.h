@@ -46,15 +46,26 @@
 #ifndef INDEXKEY_H
 #define INDEXKEY_H
 
+#include "common/FastHash.h"
 #include "common/ValuePeeker.hpp"
 #include "common/tabletuple.h"
 
 #include "expressions/abstractexpression.h"
 
+#include "structures/CompactingBTree.h"
+
+#include <boost/static_assert.hpp>
+
 #include <cassert>
 #include <iostream>
 #include <sstream>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
 namespace voltdb {
 
 /*
@@ -373,6 +384,103 @@ struct IntsComparator
     }
 };
 
+/**
+ * Nodes of a CompactingBTree over one-word keys are searched by counting
+ * the keys on the near side of the search key, two or four at a time with
+ * SSE4.2 or AVX2, instead of by a binary search whose branches mispredict.
+ * Those instructions only compare signed words, so the sign bits are
+ * flipped first. Leaf keys sit between their values, so pairs of loads
+ * are unpacked into vectors of keys; the count does not care about their
+ * order. Builds without SSE4.2 do the same count in scalar code, which
+ * compiles without branches.
+ */
+template <>
+struct BTreeKeySearch<IntsKey<1>, IntsComparator<1> >
+{
+    static inline int countBefore(const IntsKey<1> *first, std::size_t stride, int count, const IntsKey<1> &key,
+                                  bool upper, const IntsComparator<1> &unused_comper) {
+        BOOST_STATIC_ASSERT_MSG(sizeof(IntsKey<1>) == sizeof(uint64_t), "IntsKey<1> must be a single word");
+        const char *base = reinterpret_cast<const char*>(first);
+        const uint64_t target = key.data[0];
+        // For upper, count the keys greater than the target and take the rest.
+        int found = 0;
+        int ii = 0;
+#if defined(__AVX2__)
+        const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+        const __m256i flippedTarget = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+        if (stride == sizeof(uint64_t) || stride == 2 * sizeof(uint64_t)) {
+            for (; ii + 4 <= count; ii += 4) {
+                const char *at = base + ii * stride;
+                __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+                if (stride != sizeof(uint64_t)) {
+                    words = _mm256_unpacklo_epi64(words,
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at + 2 * stride)));
+                }
+                const __m256i flipped = _mm256_xor_si256(words, sign);
+                const __m256i mask = upper ? _mm256_cmpgt_epi64(flipped, flippedTarget) :
+                                             _mm256_cmpgt_epi64(flippedTarget, flipped);
+                found += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+            }
+        }
+#elif defined(__SSE4_2__)
+        const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+        const __m128i flippedTarget = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(target)), sign);
+        if (stride == sizeof(uint64_t) || stride == 2 * sizeof(uint64_t)) {
+            for (; ii + 2 <= count; ii += 2) {
+                const char *at = base + ii * stride;
+                __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+                if (stride != sizeof(uint64_t)) {
+                    words = _mm_unpacklo_epi64(words, _mm_loadu_si128(reinterpret_cast<const __m128i*>(at + stride)));
+                }
+                const __m128i flipped = _mm_xor_si128(words, sign);
+                const __m128i mask = upper ? _mm_cmpgt_epi64(flipped, flippedTarget) :
+                                             _mm_cmpgt_epi64(flippedTarget, flipped);
+                found += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+            }
+        }
+#endif
+        if (upper) {
+            for (; ii < count; ++ii) {
+                found += *reinterpret_cast<const uint64_t*>(base + ii * stride) > target;
+            }
+            return count - found;
+        }
+        for (; ii < count; ++ii) {
+            found += *reinterpret_cast<const uint64_t*>(base + ii * stride) < target;
+        }
+        return found;
+    }
+};
+
+/**
+ * Two-word keys (a pair of BIGINTs, say, or a UUID split across two
+ * columns) are ordered by the first word and then the second, which a
+ * branch-free count over the node handles without comparator calls.
+ */
+template<>
+struct BTreeKeySearch<IntsKey<2>, IntsComparator<2> >
+{
+    static inline int countBefore(const IntsKey<2> *first, std::size_t stride, int count, const IntsKey<2> &key,
+                                  bool upper, const IntsComparator<2> &unused_comper) {
+        const char *base = reinterpret_cast<const char*>(first);
+        const uint64_t high = key.data[0];
+        const uint64_t low = key.data[1];
+        int found = 0;
+        if (upper) {
+            for (int ii = 0; ii < count; ++ii) {
+                const uint64_t *words = reinterpret_cast<const uint64_t*>(base + ii * stride);
+                found += (words[0] < high) | ((words[0] == high) & (words[1] <= low));
+            }
+            return found;
+        }
+        for (int ii = 0; ii < count; ++ii) {
+            const uint64_t *words = reinterpret_cast<const uint64_t*>(base + ii * stride);
+            found += (words[0] < high) | ((words[0] == high) & (words[1] < low));
+        }
+        return found;
+    }
+};
+
 /**
  * Required by CompactingHashTable keyed by IntsKey<>
  */
@@ -406,11 +514,7 @@ struct IntsHasher
 
     inline size_t operator()(IntsKey<keySize> const& p) const
     {
-        size_t seed = 0;
-        for (int ii = 0; ii < keySize; ii++) {
-            boost::hash_combine(seed, p.data[ii]);
-        }
-        return seed;
+        return static_cast<size_t>(FastHash::hashWords(p.data, keySize));
     }
 };
 
@@ -644,6 +748,195 @@ private:
     const TupleSchema *m_keySchema;
 };
 
+/** Whether every column of keySchema can be stored in a NormalizedKey. */
+inline bool isNormalizableKeySchema(const TupleSchema *keySchema) {
+    const int columnCount = keySchema->columnCount();
+    for (int ii = 0; ii < columnCount; ++ii) {
+        const TupleSchema::ColumnInfo *columnInfo = keySchema->getColumnInfo(ii);
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_TINYINT:
+        case VALUE_TYPE_SMALLINT:
+        case VALUE_TYPE_INTEGER:
+        case VALUE_TYPE_BIGINT:
+        case VALUE_TYPE_TIMESTAMP:
+            break;
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY:
+            if ( ! columnInfo->inlined) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t keySize> struct NormalizedEqualityChecker;
+template <std::size_t keySize> struct NormalizedComparator;
+template <std::size_t keySize> struct NormalizedHasher;
+
+/**
+ * Key object for indexes of integers, timestamps and inlined strings,
+ * encoded so that keys compare with a single memcmp rather than column by
+ * column through NValues.
+ *
+ * Each column keeps the width it has in a key tuple, so a NormalizedKey is
+ * no larger than the GenericKey it replaces. Integers are stored big-endian
+ * biased as in IntsKey, which puts NULL (the smallest value) first. Inlined
+ * strings are zero padded to their full width and followed by their length
+ * plus one, or by zero for NULL. VARCHARs are cut at their first NUL byte,
+ * because strncmp sees no further when comparing them.
+ */
+template <std::size_t keySize>
+struct NormalizedKey
+{
+    typedef NormalizedEqualityChecker<keySize> KeyEqualityChecker;
+    typedef NormalizedComparator<keySize> KeyComparator;
+    typedef NormalizedHasher<keySize> KeyHasher;
+
+    static inline bool keyDependsOnTupleAddress() { return false; }
+    static inline bool keyUsesNonInlinedMemory() { return false; }
+
+    NormalizedKey() {
+        ::memset(data, 0, keySize);
+    }
+
+    NormalizedKey(const TableTuple *tuple) {
+        ::memset(data, 0, keySize);
+        assert(tuple);
+        const TupleSchema *keySchema = tuple->getSchema();
+        const int columnCount = keySchema->columnCount();
+        for (int ii = 0; ii < columnCount; ++ii) {
+            encodeColumn(keySchema, ii, tuple->getNValue(ii));
+        }
+    }
+
+    NormalizedKey(const TableTuple *tuple, const std::vector<int> &indices,
+                  const std::vector<AbstractExpression*> &indexed_expressions, const TupleSchema *keySchema) {
+        ::memset(data, 0, keySize);
+        assert(tuple);
+        const int columnCount = keySchema->columnCount();
+        if (indexed_expressions.size() > 0) {
+            for (int ii = 0; ii < columnCount; ++ii) {
+                encodeColumn(keySchema, ii, indexed_expressions[ii]->eval(tuple, NULL));
+            }
+            return;
+        }
+        for (int ii = 0; ii < columnCount; ++ii) {
+            encodeColumn(keySchema, ii, tuple->getNValue(indices[ii]));
+        }
+    }
+
+    char data[keySize];
+
+private:
+    template <typename unsignedType>
+    inline void encodeUnsigned(char *out, unsignedType value) {
+        for (int ii = static_cast<int>(sizeof(unsignedType)) - 1; ii >= 0; --ii) {
+            *out++ = static_cast<char>(value >> (ii * 8));
+        }
+    }
+
+    void encodeColumn(const TupleSchema *keySchema, int column, const NValue &value) {
+        const TupleSchema::ColumnInfo *columnInfo = keySchema->getColumnInfo(column);
+        char *out = data + columnInfo->offset;
+        switch (columnInfo->getVoltType()) {
+        case VALUE_TYPE_BIGINT:
+            encodeUnsigned(out, convertSignedValueToUnsignedValue<INT64_MAX, int64_t, uint64_t>(
+                    ValuePeeker::peekBigInt(value)));
+            return;
+        case VALUE_TYPE_TIMESTAMP:
+            encodeUnsigned(out, convertSignedValueToUnsignedValue<INT64_MAX, int64_t, uint64_t>(
+                    ValuePeeker::peekTimestamp(value)));
+            return;
+        case VALUE_TYPE_INTEGER:
+            encodeUnsigned(out, convertSignedValueToUnsignedValue<INT32_MAX, int32_t, uint32_t>(
+                    ValuePeeker::peekInteger(value)));
+            return;
+        case VALUE_TYPE_SMALLINT:
+            encodeUnsigned(out, convertSignedValueToUnsignedValue<INT16_MAX, int16_t, uint16_t>(
+                    ValuePeeker::peekSmallInt(value)));
+            return;
+        case VALUE_TYPE_TINYINT:
+            encodeUnsigned(out, convertSignedValueToUnsignedValue<INT8_MAX, int8_t, uint8_t>(
+                    ValuePeeker::peekTinyInt(value)));
+            return;
+        case VALUE_TYPE_VARCHAR:
+        case VALUE_TYPE_VARBINARY: {
+            // The column is its inlined bytes and the length that follows them.
+            const uint32_t endOffset = column + 1 < keySchema->columnCount() ?
+                    keySchema->getColumnInfo(column + 1)->offset : keySchema->tupleLength();
+            const int32_t width = static_cast<int32_t>(endOffset - columnInfo->offset) - 1;
+            if (value.isNull()) {
+                return;
+            }
+            int32_t length;
+            const char *bytes = ValuePeeker::peekObject_withoutNull(value, &length);
+            assert(length <= width);
+            int32_t copied = length;
+            if (columnInfo->getVoltType() == VALUE_TYPE_VARCHAR) {
+                const void *nul = ::memchr(bytes, '\0', length);
+                if (nul != NULL) {
+                    copied = static_cast<int32_t>(static_cast<const char*>(nul) - bytes);
+                }
+            }
+            ::memcpy(out, bytes, copied);
+            out[width] = static_cast<char>(length + 1);
+            return;
+        }
+        default:
+            throwFatalException("NormalizedKey does not support index column type %s",
+                                getTypeName(columnInfo->getVoltType()).c_str());
+        }
+    }
+};
+
+/**
+ * Function object returns -1/0/1 if lhs </==/> rhs.
+ * Required by CompactingMap keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedComparator
+{
+    NormalizedComparator(const TupleSchema *unused_keySchema) {}
+
+    inline int operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        const int result = ::memcmp(lhs.data, rhs.data, keySize);
+        return (result > 0) - (result < 0);
+    }
+};
+
+/**
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedEqualityChecker
+{
+    NormalizedEqualityChecker(const TupleSchema *unused_keySchema) {}
+
+    inline bool operator()(const NormalizedKey<keySize> &lhs, const NormalizedKey<keySize> &rhs) const {
+        return ::memcmp(lhs.data, rhs.data, keySize) == 0;
+    }
+};
+
+/**
+ * Required by CompactingHashTable keyed by NormalizedKey<>
+ */
+template <std::size_t keySize>
+struct NormalizedHasher
+{
+    NormalizedHasher(const TupleSchema *unused_keySchema) {}
+
+    inline size_t operator()(NormalizedKey<keySize> const &p) const
+    {
+        size_t seed = 0;
+        boost::hash_range(seed, p.data, p.data + keySize);
+        return seed;
+    }
+};
+
 struct TupleKeyComparator;
 
 /*
@@ -91,7 +91,8 @@ TableIndex::TableIndex(const TupleSchema *keySchema, const TableIndexScheme &sch
     m_deletes(0),
     m_updates(0),
 
-    m_stats(this)
+    m_stats(this),
+    m_usageStats(this)
 {}
 
 TableIndex::~TableIndex()
@@ -173,6 +174,45 @@ void TableIndex::addEntry(const TableTuple *tuple, TableTuple *conflictTuple)
     addEntryDo(tuple, conflictTuple);
 }
 
+bool TableIndex::addEntries(const std::vector<TableTuple> &tuples, std::vector<TableTuple> &conflictTuples)
+{
+    assert(tuples.size() == conflictTuples.size());
+    std::vector<const TableTuple*> added;
+    std::vector<TableTuple*> addedConflicts;
+    added.reserve(tuples.size());
+    addedConflicts.reserve(tuples.size());
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        if (isPartialIndex() && !getPredicate()->eval(&tuples[ii], NULL).isTrue()) {
+            // Tuple fails the predicate. Do not add it.
+            continue;
+        }
+        added.push_back(&tuples[ii]);
+        addedConflicts.push_back(&conflictTuples[ii]);
+    }
+    addEntriesDo(added, addedConflicts);
+    for (int ii = 0; ii < addedConflicts.size(); ii++) {
+        if (!addedConflicts[ii]->isNullTuple()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TableIndex::addEntriesToEmptyIndex(const std::vector<TableTuple> &tuples)
+{
+    assert(getSize() == 0);
+    std::vector<const TableTuple*> added;
+    added.reserve(tuples.size());
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        if (isPartialIndex() && !getPredicate()->eval(&tuples[ii], NULL).isTrue()) {
+            // Tuple fails the predicate. Do not add it.
+            continue;
+        }
+        added.push_back(&tuples[ii]);
+    }
+    addEntriesToEmptyIndexDo(added);
+}
+
 bool TableIndex::deleteEntry(const TableTuple *tuple)
 {
     if (isPartialIndex() && !getPredicate()->eval(tuple, NULL).isTrue()) {
@@ -182,27 +222,43 @@ bool TableIndex::deleteEntry(const TableTuple *tuple)
     return deleteEntryDo(tuple);
 }
 
+bool TableIndex::deleteEntries(const std::vector<TableTuple> &tuples)
+{
+    std::vector<const TableTuple*> deleted;
+    deleted.reserve(tuples.size());
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        if (isPartialIndex() && !getPredicate()->eval(&tuples[ii], NULL).isTrue()) {
+            // Tuple fails the predicate. Nothing to delete
+            continue;
+        }
+        deleted.push_back(&tuples[ii]);
+    }
+    return deleteEntriesDo(deleted);
+}
+
 bool TableIndex::replaceEntryNoKeyChange(const TableTuple &destinationTuple, const TableTuple &originalTuple)
 {
     assert(originalTuple.address() != destinationTuple.address());
 
     if (isPartialIndex()) {
+        // The predicate may be arbitrarily expensive, so evaluate it once per tuple.
         const AbstractExpression* predicate = getPredicate();
-        if (!predicate->eval(&destinationTuple, NULL).isTrue() && !predicate->eval(&originalTuple, NULL).isTrue()) {
+        bool destinationIndexed = predicate->eval(&destinationTuple, NULL).isTrue();
+        bool originalIndexed = predicate->eval(&originalTuple, NULL).isTrue();
+        if (!destinationIndexed && !originalIndexed) {
             // both tuples fail the predicate. Nothing to do. Return TRUE
             return true;
-        } else if (predicate->eval(&destinationTuple, NULL).isTrue() && !predicate->eval(&originalTuple, NULL).isTrue()) {
+        } else if (destinationIndexed && !originalIndexed) {
             // The original tuple fails the predicate meaning the tuple is not indexed.
             // Simply add the new tuple
             TableTuple conflict(destinationTuple.getSchema());
             addEntryDo(&destinationTuple, &conflict);
             return conflict.isNullTuple();
-        } else if (!predicate->eval(&destinationTuple, NULL).isTrue() && predicate->eval(&originalTuple, NULL).isTrue()) {
+        } else if (!destinationIndexed && originalIndexed) {
             // The destination tuple fails the predicate. Simply delete the original tuple
             return deleteEntryDo(&originalTuple);
         } else {
             // both tuples pass the predicate.
-            assert(predicate->eval(&destinationTuple, NULL).isTrue() && predicate->eval(&originalTuple, NULL).isTrue());
             return replaceEntryNoKeyChangeDo(destinationTuple, originalTuple);
         }
     } else {
@@ -223,17 +279,15 @@ bool TableIndex::exists(const TableTuple *persistentTuple) const
 bool TableIndex::checkForIndexChange(const TableTuple *lhs, const TableTuple *rhs) const {
     if (isPartialIndex()) {
         const AbstractExpression* predicate = getPredicate();
-        if (!predicate->eval(lhs, NULL).isTrue() && !predicate->eval(rhs, NULL).isTrue()) {
+        bool lhsIndexed = predicate->eval(lhs, NULL).isTrue();
+        bool rhsIndexed = predicate->eval(rhs, NULL).isTrue();
+        if (!lhsIndexed && !rhsIndexed) {
             // both tuples fail the predicate. Index is unaffected. Return FALSE
             return false;
-        } else if ((predicate->eval(lhs, NULL).isTrue() && !predicate->eval(rhs, NULL).isTrue()) ||
-            (!predicate->eval(lhs, NULL).isTrue() && predicate->eval(rhs, NULL).isTrue())) {
+        } else if (lhsIndexed != rhsIndexed) {
             // only one tuple passes the predicate. Index is affected -
             // either existing tuple needs to be deleted or the new one added from/to the index
             return true;
-        } else {
-            assert(predicate->eval(lhs, NULL).isTrue() && predicate->eval(rhs, NULL).isTrue());
-            return checkForIndexChangeDo(lhs, rhs);
         }
     }
     return checkForIndexChangeDo(lhs, rhs);
@@ -56,6 +56,7 @@
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
 #include "indexes/IndexStats.h"
+#include "indexes/IndexUsageStats.h"
 #include "common/ThreadLocalPool.h"
 
 namespace voltdb {
@@ -222,12 +223,38 @@ public:
      */
     void addEntry(const TableTuple *tuple, TableTuple *conflictTuple);
 
+    /**
+     * Adds index entries for a batch of tuples, with the same result as
+     * calling addEntry for each in turn. Index types whose inserts are
+     * cheaper in key order reorder the batch first.
+     * conflictTuples must hold one null tuple per tuple of the batch. It
+     * returns false if any tuple was not added because its key was already
+     * present, in which case that tuple's conflict tuple is set.
+     */
+    bool addEntries(const std::vector<TableTuple> &tuples, std::vector<TableTuple> &conflictTuples);
+
+    /**
+     * Adds index entries for all the tuples of a table to an index that
+     * has none yet, as when an index is created on a populated table.
+     * Tuples with keys already added are skipped, as addEntry would skip
+     * them, so a unique index keeps the first in the given order.
+     */
+    void addEntriesToEmptyIndex(const std::vector<TableTuple> &tuples);
+
     /**
      * removes the index entry linked to given value (and tuple
      * pointer, if it's non-unique index).
      */
     bool deleteEntry(const TableTuple *tuple);
 
+    /**
+     * Removes the index entries for a batch of tuples, with the same
+     * result as calling deleteEntry for each in turn. Index types whose
+     * deletes are cheaper in key order reorder the batch first.
+     * Returns false if any tuple's entry was not found.
+     */
+    bool deleteEntries(const std::vector<TableTuple> &tuples);
+
     /**
      * Update in place an index entry with a new tuple address
      */
@@ -276,6 +303,26 @@ public:
       */
      virtual bool moveToKeyByTuple(const TableTuple* searchTuple, IndexCursor &cursor) const = 0;
 
+    /**
+     * moveToKey for each of a batch of search keys, positioning
+     * cursors[i] at searchKeys[i]. Indexes override this to run the
+     * searches side by side, so that their cache misses overlap.
+     *
+     * @return the number of keys found.
+     */
+    virtual int moveToKeys(const std::vector<const TableTuple*> &searchKeys,
+                           std::vector<IndexCursor> &cursors) const
+    {
+        assert(cursors.size() >= searchKeys.size());
+        int found = 0;
+        for (size_t ii = 0; ii < searchKeys.size(); ++ii) {
+            if (moveToKey(searchKeys[ii], cursors[ii])) {
+                ++found;
+            }
+        }
+        return found;
+    }
+
     /**
      * This method moves to the first tuple equal or greater than
      * given key.  Use this with nextValue(). This method works for
@@ -358,6 +405,19 @@ public:
      */
     virtual TableTuple nextValueAtKey(IndexCursor& cursor) const = 0;
 
+    /**
+     * Skips the next count entries that nextValue(), or nextValueAtKey()
+     * after moveToKey(), would return, without visiting them. Only an
+     * index that counts its entries can do this in O(log n).
+     *
+     * @return false, leaving the cursor where it was, if this index
+     * cannot skip entries and the caller must step past them itself.
+     */
+    virtual bool skipEntries(IndexCursor& cursor, int64_t count) const
+    {
+        return false;
+    }
+
     /**
      * sets the tuple to point the entry next to the one found by
      * moveToKey().  calls this repeatedly to get all entries
@@ -408,6 +468,11 @@ public:
         return m_scheme.countable;
     }
 
+    TableIndexType getIndexType() const
+    {
+        return m_scheme.type;
+    }
+
     /**
      * Return TRUE if the index has a predicate.
      */
@@ -452,6 +517,13 @@ public:
 
     virtual size_t getSize() const = 0;
 
+    /**
+     * Called after the table has been compacted. Unique tree indexes
+     * rebuild the filter in front of their key lookups here, dropping the
+     * keys deleted since it was last built.
+     */
+    virtual void rebuildKeyFilter() {}
+
     // Return the amount of memory we think is allocated for this
     // index.
     virtual int64_t getMemoryEstimate() const = 0;
@@ -495,6 +567,7 @@ public:
             if (stats) {
                 stats->rename(name);
             }
+            m_usageStats.rename(name);
         }
     }
 
@@ -511,7 +584,12 @@ public:
     virtual std::string debug() const;
     virtual std::string getTypeName() const = 0;
 
-    virtual void ensureCapacity(uint32_t capacity) {}
+    /**
+     * Hint that the index is about to hold about this many entries, so
+     * that it can size itself once instead of growing step by step.
+     * Only hash indexes act on it.
+     */
+    virtual void ensureCapacity(size_t entryCount) {}
 
     // print out info about lookup usage
     virtual void printReport();
@@ -521,6 +599,16 @@ public:
 
     virtual voltdb::IndexStats* getIndexStats();
 
+    /** How often the index is read, and its entries written. */
+    IndexUsageStats* getIndexUsageStats() {
+        return &m_usageStats;
+    }
+
+    // The entries written by the index's implementation.
+    int64_t getInsertCount() const { return m_inserts; }
+    int64_t getDeleteCount() const { return m_deletes; }
+    int64_t getUpdateCount() const { return m_updates; }
+
     const TupleSchema *getTupleSchema() const
     {
         return m_scheme.tupleSchema;
@@ -528,6 +616,9 @@ public:
 
 protected:
 
+    // How many entries ahead of an ordered scan to prefetch tuples from.
+    static const int TUPLE_PREFETCH_DISTANCE = 4;
+
     TableIndex(const TupleSchema *keySchema, const TableIndexScheme &scheme);
 
     TableIndexScheme m_scheme;
@@ -535,17 +626,39 @@ protected:
     const std::string m_id;
 
     // counters
-    int m_inserts;
-    int m_deletes;
-    int m_updates;
+    int64_t m_inserts;
+    int64_t m_deletes;
+    int64_t m_updates;
 
     // stats
     IndexStats m_stats;
+    IndexUsageStats m_usageStats;
 
 protected:
     // Index specific implementations
     virtual void addEntryDo(const TableTuple *tuple, TableTuple *conflictTuple) = 0;
+    virtual void addEntriesDo(const std::vector<const TableTuple*> &tuples,
+                              const std::vector<TableTuple*> &conflictTuples)
+    {
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            addEntryDo(tuples[ii], conflictTuples[ii]);
+        }
+    }
+    virtual void addEntriesToEmptyIndexDo(const std::vector<const TableTuple*> &tuples)
+    {
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            addEntryDo(tuples[ii], NULL);
+        }
+    }
     virtual bool deleteEntryDo(const TableTuple *tuple) = 0;
+    virtual bool deleteEntriesDo(const std::vector<const TableTuple*> &tuples)
+    {
+        bool found = true;
+        for (int ii = 0; ii < tuples.size(); ii++) {
+            found &= deleteEntryDo(tuples[ii]);
+        }
+        return found;
+    }
     virtual bool replaceEntryNoKeyChangeDo(const TableTuple &destinationTuple,
                                          const TableTuple &originalTuple) = 0;
     virtual bool existsDo(const TableTuple* values) const = 0;
@@ -58,29 +58,34 @@
 #include "indexes/CompactingHashUniqueIndex.h"
 #include "indexes/CompactingHashMultiMapIndex.h"
 #include "indexes/CoveringCellIndex.h"
+#include "structures/CompactingBTree.h"
+#include "structures/CompactingMap.h"
 
 namespace voltdb {
 
 class TableIndexPicker
 {
-    template <class TKeyType>
+    // Tree indexes on keys that copy as plain bytes are B+trees. Keys that
+    // own their storage cannot be copied into inner nodes, so they stay in
+    // red-black trees.
+    template <class TKeyType, template<typename, typename, bool> class TTreeMap>
     TableIndex *getInstanceForKeyType() const
     {
         if (m_scheme.unique) {
             if (m_type != BALANCED_TREE_INDEX) {
                 return new CompactingHashUniqueIndex<TKeyType >(m_keySchema, m_scheme);
             } else if (m_scheme.countable) {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true, TTreeMap>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false, TTreeMap>(m_keySchema, m_scheme);
             }
         } else {
             if (m_type != BALANCED_TREE_INDEX) {
                 return new CompactingHashMultiMapIndex<TKeyType >(m_keySchema, m_scheme);
             } else if (m_scheme.countable) {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true>(m_keySchema, m_scheme);
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true, TTreeMap>(m_keySchema, m_scheme);
             } else {
-                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+                return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false, TTreeMap>(m_keySchema, m_scheme);
             }
         }
     }
@@ -94,7 +99,7 @@ class TableIndexPicker
         if (m_intsOnly) {
             // The IntsKey size parameter ((KeySize-1)/8 + 1) is calculated to be
             // the number of 8-byte uint64's required to store KeySize packed bytes.
-            return getInstanceForKeyType<IntsKey<(KeySize-1)/8 + 1> >();
+            return getInstanceForKeyType<IntsKey<(KeySize-1)/8 + 1>, CompactingBTree>();
         }
         // Generic Key
         if (m_type == HASH_TABLE_INDEX) {
@@ -108,10 +113,19 @@ class TableIndexPicker
         // then the GenericKey will have to reference and maintain its own persistent non-inline storage.
         // That's exactly what the GenericPersistentKey subtype of GenericKey does. This incurs extra overhead
         // for object copying and freeing, so is only enabled as needed.
+        // Keys of integers and inlined strings are compared as plain bytes.
+        if (m_normalizable) {
+            return getInstanceForKeyType<NormalizedKey<KeySize>, CompactingBTree>();
+        }
         if (m_inlinesOrColumnsOnly) {
-            return getInstanceForKeyType<GenericKey<KeySize> >();
+            // The B+tree's inner nodes keep copies of keys that can outlive their
+            // entries, so keys that point at a row's strings stay in the CompactingMap.
+            if (m_keySchema->getUninlinedObjectColumnCount() == 0) {
+                return getInstanceForKeyType<GenericKey<KeySize>, CompactingBTree>();
+            }
+            return getInstanceForKeyType<GenericKey<KeySize>, CompactingMap>();
         }
-        return getInstanceForKeyType<GenericPersistentKey<KeySize> >();
+        return getInstanceForKeyType<GenericPersistentKey<KeySize>, CompactingMap>();
     }
 
     template <int ColCount>
@@ -204,6 +218,7 @@ public:
         m_keySize(keySchema->tupleLength()),
         m_intsOnly(intsOnly),
         m_inlinesOrColumnsOnly(inlinesOrColumnsOnly),
+        m_normalizable(isNormalizableKeySchema(keySchema)),
         m_type(scheme.type)
     {}
 
@@ -213,6 +228,7 @@ private:
     const int m_keySize;
     bool m_intsOnly;
     bool m_inlinesOrColumnsOnly;
+    const bool m_normalizable;
     TableIndexType m_type;
 };
 
@@ -83,6 +83,14 @@ std::string AggregatePlanNode::debugInfo(const std::string &spacer) const
     }
     buffer << "]\n";
 
+    for (int ctr = 0, cnt = (int) m_groupingSets.size(); ctr < cnt; ctr++) {
+        buffer << spacer << "GroupingSet[";
+        for (int ii = 0; ii < (int) m_groupingSets[ctr].size(); ii++) {
+            buffer << " " << m_groupingSets[ctr][ii];
+        }
+        buffer << " ]\n";
+    }
+
     return buffer.str();
 }
 
@@ -105,6 +113,12 @@ void AggregatePlanNode::loadFromJSONObject(PlannerDomValue obj)
             bool distinct = aggregateColumnValue.valueForKey("AGGREGATE_DISTINCT").asInt() == 1;
             m_distinctAggregates.push_back(distinct);
         }
+        if (aggregateColumnValue.hasNonNullKey("AGGREGATE_PERCENTILE")) {
+            m_aggregatePercentiles.push_back(aggregateColumnValue.valueForKey("AGGREGATE_PERCENTILE").asDouble());
+        }
+        else {
+            m_aggregatePercentiles.push_back(0.5);
+        }
         if (aggregateColumnValue.hasNonNullKey("AGGREGATE_OUTPUT_COLUMN")) {
             containsOutputColumn = true;
             int column = aggregateColumnValue.valueForKey("AGGREGATE_OUTPUT_COLUMN").asInt();
@@ -131,6 +145,17 @@ void AggregatePlanNode::loadFromJSONObject(PlannerDomValue obj)
     m_postPredicate.reset(loadExpressionFromJSONObject("POST_PREDICATE", obj));
 
     loadIntArrayFromJSONObject("PARTIAL_GROUPBY_COLUMNS", obj, m_partialGroupByColumns);
+
+    if (obj.hasNonNullKey("GROUPING_SETS")) {
+        PlannerDomValue groupingSetsArray = obj.valueForKey("GROUPING_SETS");
+        for (int i = 0; i < groupingSetsArray.arrayLen(); i++) {
+            PlannerDomValue groupingSetValue = groupingSetsArray.valueAtIndex(i);
+            m_groupingSets.push_back(std::vector<int>());
+            m_groupingSetNullColumns.push_back(std::vector<int>());
+            loadIntArrayFromJSONObject("GROUPBY_COLUMNS", groupingSetValue, m_groupingSets.back());
+            loadIntArrayFromJSONObject("NULL_COLUMNS", groupingSetValue, m_groupingSetNullColumns.back());
+        }
+    }
 }
 
 void AggregatePlanNode::collectOutputExpressions(
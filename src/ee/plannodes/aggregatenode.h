@@ -62,6 +62,12 @@ public:
 
     const std::vector<bool>& getDistinctAggregates() const { return m_distinctAggregates; }
 
+    /*
+     * The fraction (0 to 1) each APPROX_PERCENTILE aggregation estimates,
+     * 0.5 (the median) when the plan gives none.
+     */
+    const std::vector<double>& getAggregatePercentiles() const { return m_aggregatePercentiles; }
+
     /*
      * Returns a list of output column indices that map from each
      * aggregation to an output column. These are serialized as
@@ -74,6 +80,21 @@ public:
     const std::vector<int>& getPartialGroupByColumns() const
     { return m_partialGroupByColumns; }
 
+    /*
+     * For a hash aggregate over GROUPING SETS, ROLLUP or CUBE, the
+     * group-by expressions (by index) each set groups by. Empty for an
+     * ordinary GROUP BY.
+     */
+    const std::vector<std::vector<int> >& getGroupingSets() const
+    { return m_groupingSets; }
+
+    /*
+     * For each grouping set, the output columns that are NULL in its
+     * rows: those of the group-by expressions the set does not group by.
+     */
+    const std::vector<std::vector<int> >& getGroupingSetNullColumns() const
+    { return m_groupingSetNullColumns; }
+
     const std::vector<AbstractExpression*>& getAggregateInputExpressions() const
     { return m_aggregateInputExpressions; }
 
@@ -93,6 +114,7 @@ protected:
 
     std::vector<ExpressionType> m_aggregates;
     std::vector<bool> m_distinctAggregates;
+    std::vector<double> m_aggregatePercentiles;
     std::vector<int> m_aggregateOutputColumns;
     OwningExpressionVector m_aggregateInputExpressions;
 
@@ -103,6 +125,9 @@ protected:
 
     std::vector<int> m_partialGroupByColumns;
 
+    std::vector<std::vector<int> > m_groupingSets;
+    std::vector<std::vector<int> > m_groupingSetNullColumns;
+
     PlanNodeType m_type; //AGGREGATE, PARTIALAGGREGATE, HASHAGGREGATE
 
     // ENG-1565: for accelerating min() / max() using index purpose only
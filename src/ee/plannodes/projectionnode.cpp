@@ -51,7 +51,12 @@ using namespace std;
 
 namespace voltdb {
 
-ProjectionPlanNode::~ProjectionPlanNode() { }
+ProjectionPlanNode::~ProjectionPlanNode()
+{
+    for (size_t ii = 0; ii < m_sharingColumnExpressions.size(); ii++) {
+        delete m_sharingColumnExpressions[ii];
+    }
+}
 
 PlanNodeType ProjectionPlanNode::getPlanNodeType() const { return PLAN_NODE_TYPE_PROJECTION; }
 
@@ -86,6 +91,35 @@ void ProjectionPlanNode::loadFromJSONObject(PlannerDomValue obj)
         m_outputColumnSizes.push_back(expr->getValueSize());
         m_outputColumnExpressions.push_back(expr);
     }
+
+    // Look for subtrees that recur across the columns, as when the same
+    // function of a column is both selected and grouped on.
+    if ( ! obj.hasNonNullKey("OUTPUT_SCHEMA")) {
+        return;
+    }
+    PlannerDomValue outputSchemaArray = obj.valueForKey("OUTPUT_SCHEMA");
+    if (outputSchemaArray.arrayLen() != outputSchema.size()) {
+        return;
+    }
+    boost::scoped_ptr<CommonSubexpressions> shared(new CommonSubexpressions());
+    for (int ii = 0; ii < outputSchemaArray.arrayLen(); ii++) {
+        PlannerDomValue columnValue = outputSchemaArray.valueAtIndex(ii);
+        if ( ! columnValue.hasNonNullKey("EXPRESSION")) {
+            return;
+        }
+        shared->count(columnValue.valueForKey("EXPRESSION"));
+    }
+    if ( ! shared->hasRepeats()) {
+        return;
+    }
+    for (int ii = 0; ii < outputSchemaArray.arrayLen(); ii++) {
+        PlannerDomValue columnValue = outputSchemaArray.valueAtIndex(ii);
+        AbstractExpression* expr =
+            AbstractExpression::buildExpressionTree(columnValue.valueForKey("EXPRESSION"), shared.get());
+        m_sharingColumnExpressions.push_back(expr);
+        m_outputColumnExpressions[ii] = expr;
+    }
+    m_commonSubexpressions.swap(shared);
 }
 
 } // namespace voltdb
@@ -49,6 +49,9 @@
 #include "plannodes/abstractplannode.h"
 
 #include "expressions/abstractexpression.h"
+#include "expressions/commonsubexpression.h"
+
+#include "boost/scoped_ptr.hpp"
 
 namespace voltdb {
 
@@ -72,6 +75,14 @@ public:
     const std::vector<AbstractExpression*>& getOutputColumnExpressions() const
     { return m_outputColumnExpressions; }
 
+    /**
+     * The subexpressions the output columns have in common, or NULL if
+     * they share none. Per-row evaluators of the columns open a
+     * CommonSubexpressions::RowScope on it to evaluate each just once.
+     */
+    CommonSubexpressions* getCommonSubexpressions() const
+    { return m_commonSubexpressions.get(); }
+
     std::string debugInfo(const std::string& spacer) const;
 
 protected:
@@ -92,6 +103,12 @@ protected:
     // or CalculatedValueExpression for projection with arithmetic calculation.
     // in ProjectionPlanNode
     std::vector<AbstractExpression*> m_outputColumnExpressions;
+
+    // When the columns have subexpressions in common, they are rebuilt to
+    // share them, and these own the rebuilt columns and the shared parts.
+    // Otherwise the columns are the output schema's expressions.
+    std::vector<AbstractExpression*> m_sharingColumnExpressions;
+    boost::scoped_ptr<CommonSubexpressions> m_commonSubexpressions;
 };
 
 } // namespace voltdb
@@ -0,0 +1,129 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <cstring>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * A histogram of latencies in nanoseconds with HDR-style log-linear
+ * buckets: each power of two is split into SUB_BUCKETS equal buckets, so
+ * a recorded value is known to within 1/SUB_BUCKETS of itself. Recording
+ * is an index computation and an increment into a fixed array.
+ *
+ * Each site records into its own histograms, so there is no locking.
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values from 2^MAX_EXPONENT nanoseconds (about 18 minutes) up all
+    // land in the top bucket.
+    static const int MAX_EXPONENT = 40;
+    static const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        ::memset(m_counts, 0, sizeof(m_counts));
+        m_count = 0;
+        m_min = 0;
+        m_max = 0;
+    }
+
+    void record(int64_t nanos) {
+        if (nanos < 0) {
+            nanos = 0;
+        }
+        ++m_counts[bucketOf(nanos)];
+        if (m_count == 0 || nanos < m_min) {
+            m_min = nanos;
+        }
+        if (nanos > m_max) {
+            m_max = nanos;
+        }
+        ++m_count;
+    }
+
+    int64_t count() const { return m_count; }
+    int64_t min() const { return m_min; }
+    int64_t max() const { return m_max; }
+
+    /**
+     * The largest value of the bucket holding the given percentile (0 to
+     * 100) of the recorded values, capped at the largest value recorded;
+     * 0 when nothing was recorded.
+     */
+    int64_t valueAtPercentile(double percentile) const {
+        if (m_count == 0) {
+            return 0;
+        }
+        int64_t rank = static_cast<int64_t>(percentile / 100 * static_cast<double>(m_count) + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+        int64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += m_counts[bucket];
+            if (seen >= rank) {
+                int64_t highest = highestValueOf(bucket);
+                return highest < m_max ? highest : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    /** The bucket of a value, exposed for tests. */
+    static int bucketOf(int64_t nanos) {
+        if (nanos < SUB_BUCKETS) {
+            return static_cast<int>(nanos);
+        }
+        int exponent = 63 - __builtin_clzll(static_cast<uint64_t>(nanos));
+        if (exponent > MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        int subBucket = static_cast<int>(nanos >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+    }
+
+    /** The largest value that falls in a bucket. */
+    static int64_t highestValueOf(int bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        int exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        int64_t subBucket = bucket % SUB_BUCKETS;
+        return ((SUB_BUCKETS + subBucket + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+    }
+
+private:
+    int64_t m_counts[BUCKET_COUNT];
+    int64_t m_count;
+    int64_t m_min;
+    int64_t m_max;
+};
+
+} // namespace voltdb
+
+#endif // LATENCYHISTOGRAM_H_
@@ -0,0 +1,63 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCYSAMPLE_H_
+#define LATENCYSAMPLE_H_
+
+#include "common/executorcontext.hpp"
+#include "common/Tracepoints.h"
+#include "executors/ExecutorStats.h"
+#include "stats/LatencyStats.h"
+
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * Times the scope it lives in into the site's latency stats for the
+ * point, if this event is sampled. Does nothing when no executor context
+ * is bound to the thread.
+ */
+class ScopedLatencySample {
+public:
+    explicit ScopedLatencySample(LatencyPoint point)
+        : m_stats(NULL), m_point(point), m_start(0)
+    {
+        VOLT_PROBE1(latency__start, static_cast<int>(point));
+        ExecutorContext* context = ExecutorContext::getExecutorContext();
+        if (context != NULL && context->latencyStats().sample(point)) {
+            m_stats = &context->latencyStats();
+            m_start = ExecutorStats::nowNanos();
+        }
+    }
+
+    ~ScopedLatencySample() {
+        if (m_stats != NULL) {
+            m_stats->record(m_point, ExecutorStats::nowNanos() - m_start);
+        }
+        VOLT_PROBE1(latency__done, static_cast<int>(m_point));
+    }
+
+private:
+    LatencyStats* m_stats;
+    LatencyPoint m_point;
+    int64_t m_start;
+};
+
+}
+
+#endif /* LATENCYSAMPLE_H_ */
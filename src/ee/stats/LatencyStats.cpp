@@ -0,0 +1,138 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stats/LatencyStats.h"
+#include "common/tabletuple.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "stats/StatsSource.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+
+using namespace voltdb;
+using namespace std;
+
+namespace {
+    // The latency stats columns follow the base stats columns.
+    const int LATENCY_STATS_COLUMN_COUNT = 8;
+}
+
+vector<string> LatencyStats::generateLatencyStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("POINT");
+    columnNames.push_back("SAMPLES");
+    columnNames.push_back("MIN_NANOS");
+    columnNames.push_back("P50_NANOS");
+    columnNames.push_back("P95_NANOS");
+    columnNames.push_back("P99_NANOS");
+    columnNames.push_back("P999_NANOS");
+    columnNames.push_back("MAX_NANOS");
+
+    return columnNames;
+}
+
+void LatencyStats::populateLatencyStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+
+    // point; sized in bytes so it is stored inline in the row
+    types.push_back(VALUE_TYPE_VARCHAR);
+    columnLengths.push_back(32);
+    allowNull.push_back(false);
+    inBytes.push_back(true);
+
+    // samples, and the min, percentiles and max
+    for (int ii = 0; ii < LATENCY_STATS_COLUMN_COUNT - 1; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT);
+        columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        allowNull.push_back(false);
+        inBytes.push_back(false);
+    }
+}
+
+TempTable* LatencyStats::generateEmptyLatencyStatsTable() {
+    string name = "Latency stats temp table";
+    vector<string> columnNames = LatencyStats::generateLatencyStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    LatencyStats::populateLatencyStatsSchema(columnTypes, columnLengths,
+                                             columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+const char* LatencyStats::latencyPointToString(LatencyPoint point) {
+    switch (point) {
+    case LATENCY_FRAGMENT:
+        return "FRAGMENT";
+    case LATENCY_INDEX_LOOKUP:
+        return "INDEX_LOOKUP";
+    case LATENCY_COMPACTION:
+        return "COMPACTION";
+    case LATENCY_COW_STREAM:
+        return "COW_STREAM";
+    case LATENCY_DR_BUFFER_PUSH:
+        return "DR_BUFFER_PUSH";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+LatencyStats::LatencyStats()
+{
+    setSampleInterval(DEFAULT_SAMPLE_INTERVAL);
+}
+
+void LatencyStats::setSampleInterval(int sampleInterval) {
+    m_sampleInterval = sampleInterval < 0 ? 0 : sampleInterval;
+    for (int point = 0; point < LATENCY_POINT_COUNT; point++) {
+        m_countdown[point] = m_sampleInterval;
+    }
+}
+
+void LatencyStats::addStatsRows(TempTable* table, TableTuple* tuple, bool interval) {
+    for (int point = 0; point < LATENCY_POINT_COUNT; point++) {
+        LatencyHistogram& histogram = interval ? m_interval[point] : m_total[point];
+
+        int column = tuple->sizeInValues() - LATENCY_STATS_COLUMN_COUNT;
+        NValue name = ValueFactory::getStringValue(latencyPointToString(static_cast<LatencyPoint>(point)));
+        tuple->setNValue(column++, name);
+        name.free();
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.count()));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.min()));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.valueAtPercentile(50)));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.valueAtPercentile(95)));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.valueAtPercentile(99)));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.valueAtPercentile(99.9)));
+        tuple->setNValue(column++, ValueFactory::getBigIntValue(histogram.max()));
+        table->insertTempTuple(*tuple);
+
+        if (interval) {
+            histogram.reset();
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCYSTATS_H_
+#define LATENCYSTATS_H_
+
+#include "common/types.h"
+#include "stats/LatencyHistogram.h"
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace voltdb {
+class TableTuple;
+class TempTable;
+
+/** The places in the EE whose latencies are sampled. */
+enum LatencyPoint {
+    LATENCY_FRAGMENT,
+    LATENCY_INDEX_LOOKUP,
+    LATENCY_COMPACTION,
+    LATENCY_COW_STREAM,
+    LATENCY_DR_BUFFER_PUSH,
+    LATENCY_POINT_COUNT
+};
+
+/**
+ * Latency histograms of a site for each LatencyPoint. Only one in every
+ * sample interval events at a point is timed, so the clock is read rarely
+ * on hot paths; an interval of 0 turns sampling off.
+ *
+ * Like ExecutorStats this is not a StatsSource; the engine adds a row per
+ * point to a single table.
+ */
+class LatencyStats {
+public:
+    static const int DEFAULT_SAMPLE_INTERVAL = 16;
+
+    static std::vector<std::string> generateLatencyStatsColumnNames();
+
+    static void populateLatencyStatsSchema(std::vector<voltdb::ValueType>& types,
+                                           std::vector<int32_t>& columnLengths,
+                                           std::vector<bool>& allowNull,
+                                           std::vector<bool>& inBytes);
+
+    static TempTable* generateEmptyLatencyStatsTable();
+
+    static const char* latencyPointToString(LatencyPoint point);
+
+    LatencyStats();
+
+    void setSampleInterval(int sampleInterval);
+
+    int sampleInterval() const { return m_sampleInterval; }
+
+    /** Whether this event at the point should be timed. */
+    bool sample(LatencyPoint point) {
+        if (m_sampleInterval == 0) {
+            return false;
+        }
+        if (--m_countdown[point] > 0) {
+            return false;
+        }
+        m_countdown[point] = m_sampleInterval;
+        return true;
+    }
+
+    void record(LatencyPoint point, int64_t nanos) {
+        m_total[point].record(nanos);
+        m_interval[point].record(nanos);
+    }
+
+    const LatencyHistogram& histogram(LatencyPoint point) const { return m_total[point]; }
+
+    /**
+     * Add a row per point to the table, using the tuple, whose base stats
+     * columns the caller has filled in. With interval, the samples are
+     * those since the last interval request.
+     */
+    void addStatsRows(TempTable* table, TableTuple* tuple, bool interval);
+
+private:
+    int m_sampleInterval;
+    int m_countdown[LATENCY_POINT_COUNT];
+    LatencyHistogram m_total[LATENCY_POINT_COUNT];
+    // Samples since the last interval request.
+    LatencyHistogram m_interval[LATENCY_POINT_COUNT];
+};
+
+}
+
+#endif /* LATENCYSTATS_H_ */
@@ -0,0 +1,403 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stats/StackSampler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <set>
+
+#ifdef __linux__
+#include <link.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+using namespace voltdb;
+using namespace std;
+
+// Older glibc only has the union member
+#if defined(__linux__) && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace {
+    // The symbol cache is dropped when it gets this big, it only saves dladdr() calls
+    const size_t MAX_CACHED_SYMBOLS = 100000;
+
+    pthread_mutex_t s_registryLock = PTHREAD_MUTEX_INITIALIZER;
+    std::set<StackSampler*> s_samplers;
+    bool s_handlerInstalled = false;
+
+    // The executable segments of the shared object the EE is in
+    uintptr_t s_textLow = 0;
+    uintptr_t s_textHigh = 0;
+
+#ifdef __linux__
+    // Find the object whose code includes the address passed as data
+    int findEEText(struct dl_phdr_info *info, size_t size, void *data) {
+        const uintptr_t eeAddress = reinterpret_cast<uintptr_t>(data);
+        uintptr_t low = 0;
+        uintptr_t high = 0;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type == PT_LOAD && (phdr.p_flags & PF_X)) {
+                const uintptr_t segmentLow = info->dlpi_addr + phdr.p_vaddr;
+                const uintptr_t segmentHigh = segmentLow + phdr.p_memsz;
+                if (low == 0 || segmentLow < low) {
+                    low = segmentLow;
+                }
+                if (segmentHigh > high) {
+                    high = segmentHigh;
+                }
+            }
+        }
+        if (eeAddress < low || eeAddress >= high) {
+            return 0;
+        }
+        s_textLow = low;
+        s_textHigh = high;
+        return 1;
+    }
+#endif
+
+    inline bool inEEText(uintptr_t pc) {
+        return pc >= s_textLow && pc < s_textHigh;
+    }
+
+    // Drop the parameter list, which makes C++ frames long and is rarely needed
+    string shortName(const char *demangled) {
+        string name(demangled);
+        size_t paren = name.find('(');
+        while (paren != string::npos) {
+            if (name.compare(paren, 21, "(anonymous namespace)") == 0) {
+                paren = name.find('(', paren + 21);
+            }
+            else if (paren >= 8 && name.compare(paren - 8, 8, "operator") == 0) {
+                paren = name.find('(', paren + 2);
+            }
+            else {
+                break;
+            }
+        }
+        if (paren != string::npos) {
+            name.resize(paren);
+        }
+        return name;
+    }
+}
+
+StackSampler::StackSampler()
+    : m_started(false),
+      m_stackLow(0),
+      m_stackHigh(0),
+      m_ring(NULL),
+      m_head(0),
+      m_tail(0),
+      m_dropped(0),
+      m_outside(0)
+{
+}
+
+#ifdef __linux__
+
+StackSampler::~StackSampler() {
+    if (m_started) {
+        pthread_mutex_lock(&s_registryLock);
+        s_samplers.erase(this);
+        pthread_mutex_unlock(&s_registryLock);
+
+        // A signal from the timer may be pending for this thread, which is
+        // normally the sampled one. Take it so it can't reach a deleted sampler.
+        sigset_t profSet;
+        sigset_t oldSet;
+        sigemptyset(&profSet);
+        sigaddset(&profSet, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &profSet, &oldSet);
+        timer_delete(m_timer);
+        struct timespec noWait = { 0, 0 };
+        while (sigtimedwait(&profSet, NULL, &noWait) > 0) {
+        }
+        pthread_sigmask(SIG_SETMASK, &oldSet, NULL);
+    }
+    delete[] m_ring;
+}
+
+void StackSampler::start(int32_t hz) {
+    if (m_started) {
+        return;
+    }
+
+    pthread_mutex_lock(&s_registryLock);
+    if ( ! s_handlerInstalled) {
+        struct sigaction current;
+        if (sigaction(SIGPROF, NULL, &current) == 0 &&
+            ((current.sa_flags & SA_SIGINFO) == 0) &&
+            (current.sa_handler == SIG_DFL || current.sa_handler == SIG_IGN)) {
+            dl_iterate_phdr(findEEText, reinterpret_cast<void*>(&StackSampler::handleSignal));
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_sigaction = handleSignal;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            s_handlerInstalled = s_textHigh > s_textLow && sigaction(SIGPROF, &action, NULL) == 0;
+        }
+    }
+    const bool canSample = s_handlerInstalled;
+    pthread_mutex_unlock(&s_registryLock);
+    if ( ! canSample) {
+        return;
+    }
+
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+        return;
+    }
+    void *stackAddr;
+    size_t stackSize;
+    const int stackError = pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+    pthread_attr_destroy(&attr);
+    if (stackError != 0) {
+        return;
+    }
+    m_stackLow = reinterpret_cast<uintptr_t>(stackAddr);
+    m_stackHigh = m_stackLow + stackSize;
+
+    m_ring = new Sample[RING_SIZE];
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_value.sival_ptr = this;
+    event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &m_timer) != 0) {
+        delete[] m_ring;
+        m_ring = NULL;
+        return;
+    }
+    m_started = true;
+
+    pthread_mutex_lock(&s_registryLock);
+    s_samplers.insert(this);
+    arm(hz);
+    pthread_mutex_unlock(&s_registryLock);
+}
+
+void StackSampler::setRate(int32_t hz) {
+    pthread_mutex_lock(&s_registryLock);
+    for (set<StackSampler*>::iterator it = s_samplers.begin(); it != s_samplers.end(); ++it) {
+        (*it)->arm(hz);
+    }
+    pthread_mutex_unlock(&s_registryLock);
+}
+
+void StackSampler::arm(int32_t hz) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (hz > 0) {
+        const int64_t periodNanos = 1000000000LL / hz;
+        spec.it_interval.tv_sec = static_cast<time_t>(periodNanos / 1000000000LL);
+        spec.it_interval.tv_nsec = static_cast<long>(periodNanos % 1000000000LL);
+        spec.it_value = spec.it_interval;
+    }
+    timer_settime(m_timer, 0, &spec, NULL);
+}
+
+void StackSampler::handleSignal(int signum, siginfo_t *info, void *context) {
+    if (info == NULL || info->si_code != SI_TIMER || info->si_value.sival_ptr == NULL) {
+        return;
+    }
+    const int savedErrno = errno;
+    static_cast<StackSampler*>(info->si_value.sival_ptr)->record(context);
+    errno = savedErrno;
+}
+
+void StackSampler::record(void *context) {
+    const uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const ucontext_t *ucontext = static_cast<const ucontext_t*>(context);
+    uintptr_t pc;
+    uintptr_t fp;
+#if defined(REG_RIP)
+    pc = static_cast<uintptr_t>(ucontext->uc_mcontext.gregs[REG_RIP]);
+    fp = static_cast<uintptr_t>(ucontext->uc_mcontext.gregs[REG_RBP]);
+#elif defined(__aarch64__)
+    pc = static_cast<uintptr_t>(ucontext->uc_mcontext.pc);
+    fp = static_cast<uintptr_t>(ucontext->uc_mcontext.regs[29]);
+#else
+    m_outside.fetch_add(1, std::memory_order_relaxed);
+    return;
+#endif
+
+    Sample &sample = m_ring[head % RING_SIZE];
+    int depth = 0;
+    int outermostEEFrame = -1;
+    sample.frames[depth++] = pc;
+    if (inEEText(pc)) {
+        outermostEEFrame = 0;
+    }
+    // Each frame starts with the caller's frame pointer and the return
+    // address. Only read frames that lie within this thread's stack, and
+    // stop when the chain stops growing towards the stack's base.
+    while (depth < MAX_FRAMES &&
+           fp >= m_stackLow && fp + 2 * sizeof(uintptr_t) <= m_stackHigh &&
+           (fp & (sizeof(uintptr_t) - 1)) == 0) {
+        const uintptr_t *frame = reinterpret_cast<const uintptr_t*>(fp);
+        const uintptr_t returnAddress = frame[1];
+        const uintptr_t callerFp = frame[0];
+        if (returnAddress == 0) {
+            break;
+        }
+        if (inEEText(returnAddress)) {
+            outermostEEFrame = depth;
+        }
+        sample.frames[depth++] = returnAddress;
+        if (callerFp <= fp) {
+            break;
+        }
+        fp = callerFp;
+    }
+
+    if (outermostEEFrame < 0) {
+        m_outside.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    sample.depth = outermostEEFrame + 1;
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+#else
+
+StackSampler::~StackSampler() {
+    delete[] m_ring;
+}
+
+void StackSampler::start(int32_t hz) {
+}
+
+void StackSampler::setRate(int32_t hz) {
+}
+
+void StackSampler::arm(int32_t hz) {
+}
+
+void StackSampler::handleSignal(int signum, siginfo_t *info, void *context) {
+}
+
+void StackSampler::record(void *context) {
+}
+
+#endif
+
+void StackSampler::drain() {
+    if (m_ring == NULL) {
+        return;
+    }
+    const uint32_t head = m_head.load(std::memory_order_acquire);
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    string key;
+    while (tail != head) {
+        const Sample &sample = m_ring[tail % RING_SIZE];
+        key.assign(reinterpret_cast<const char*>(sample.frames), sample.depth * sizeof(uintptr_t));
+        ++m_counts[key];
+        ++tail;
+        // Hand the slot back to the handler
+        m_tail.store(tail, std::memory_order_release);
+    }
+}
+
+const string& StackSampler::symbolize(uintptr_t pc) {
+    boost::unordered_map<uintptr_t, string>::iterator it = m_symbols.find(pc);
+    if (it != m_symbols.end()) {
+        return it->second;
+    }
+    string name;
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(pc), &info) != 0 && info.dli_sname != NULL) {
+        int status;
+        char *demangled = abi::__cxa_demangle(info.dli_sname, NULL, 0, &status);
+        if (status == 0 && demangled != NULL) {
+            name = shortName(demangled);
+        }
+        else {
+            name = info.dli_sname;
+        }
+        free(demangled);
+    }
+    else {
+        char hex[32];
+        snprintf(hex, sizeof(hex), "0x%lx", static_cast<unsigned long>(pc));
+        name = hex;
+    }
+    return m_symbols[pc] = name;
+}
+
+string StackSampler::takeFoldedStacks() {
+    drain();
+    if (m_symbols.size() > MAX_CACHED_SYMBOLS) {
+        m_symbols.clear();
+    }
+    // Stacks that differ only in the offsets within their functions are merged
+    boost::unordered_map<string, int64_t> symbolized;
+    string stack;
+    for (boost::unordered_map<string, int64_t>::const_iterator it = m_counts.begin();
+         it != m_counts.end(); ++it) {
+        const int depth = static_cast<int>(it->first.size() / sizeof(uintptr_t));
+        stack.clear();
+        for (int i = depth - 1; i >= 0; --i) {
+            uintptr_t pc;
+            memcpy(&pc, it->first.data() + i * sizeof(uintptr_t), sizeof(pc));
+            // Return addresses point after the call; look up the call itself
+            stack.append(symbolize(i == 0 ? pc : pc - 1));
+            if (i > 0) {
+                stack.push_back(';');
+            }
+        }
+        symbolized[stack] += it->second;
+    }
+    string folded;
+    char count[32];
+    for (boost::unordered_map<string, int64_t>::const_iterator it = symbolized.begin();
+         it != symbolized.end(); ++it) {
+        snprintf(count, sizeof(count), " %lld\n", static_cast<long long>(it->second));
+        folded.append(it->first);
+        folded.append(count);
+    }
+    m_counts.clear();
+
+    const uint32_t outside = m_outside.exchange(0);
+    if (outside > 0) {
+        snprintf(count, sizeof(count), "[outside EE] %u\n", outside);
+        folded.append(count);
+    }
+    const uint32_t dropped = m_dropped.exchange(0);
+    if (dropped > 0) {
+        snprintf(count, sizeof(count), "[dropped] %u\n", dropped);
+        folded.append(count);
+    }
+    return folded;
+}
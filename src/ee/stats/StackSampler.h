@@ -0,0 +1,103 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STACKSAMPLER_H_
+#define STACKSAMPLER_H_
+
+#include <atomic>
+#include <string>
+
+#include "boost/unordered_map.hpp"
+
+#include <signal.h>
+#include <stdint.h>
+#include <time.h>
+
+namespace voltdb {
+
+/**
+ * A sampling profiler for the native stack of one thread, meant to be left on.
+ *
+ * A timer on the thread's CPU clock sends the thread SIGPROF hz times per
+ * second of CPU it uses, so an idle site is not sampled. The handler walks
+ * the frame pointer chain (the EE is built with -fno-omit-frame-pointer)
+ * within the thread's stack and copies the return addresses into a ring,
+ * which is all it does. The owning thread drains the ring into counts per
+ * stack on the EE tick, and symbolizes the stacks only when they are taken.
+ *
+ * Stacks are cut above the outermost EE frame, so they start at the JNI entry
+ * point. Samples taken while the thread is in Java count as "[outside EE]".
+ *
+ * Only implemented on Linux; elsewhere start() does nothing. The handler is
+ * not installed if something else already handles SIGPROF, such as the
+ * gperftools profiler behind @ProfCtl GPERF_ENABLE.
+ */
+class StackSampler {
+public:
+    static const int MAX_FRAMES = 48;
+    static const int RING_SIZE = 256;
+
+    StackSampler();
+    ~StackSampler();
+
+    /** Sample the calling thread, hz times per CPU second or not at all with 0 */
+    void start(int32_t hz);
+
+    /** Change the rate of every started sampler in the process; 0 pauses them */
+    static void setRate(int32_t hz);
+
+    /** Move the samples from the ring to the counts. Call on the sampled thread. */
+    void drain();
+
+    /**
+     * Drain, then return the stacks sampled since the last call in the folded
+     * format of flame graph tools, one "outer;...;inner count" line per stack.
+     */
+    std::string takeFoldedStacks();
+
+private:
+    struct Sample {
+        int32_t depth;
+        uintptr_t frames[MAX_FRAMES];
+    };
+
+    static void handleSignal(int signum, siginfo_t *info, void *context);
+    void record(void *context);
+    void arm(int32_t hz);
+    const std::string& symbolize(uintptr_t pc);
+
+    bool m_started;
+    timer_t m_timer;
+    uintptr_t m_stackLow;
+    uintptr_t m_stackHigh;
+
+    // Written only by the signal handler and only read by drain(), which
+    // runs on the same thread, so the ring needs no locking.
+    Sample *m_ring;
+    std::atomic<uint32_t> m_head;
+    std::atomic<uint32_t> m_tail;
+    std::atomic<uint32_t> m_dropped;
+    std::atomic<uint32_t> m_outside;
+
+    // Raw frames of each stack sampled since the last take, with its count
+    boost::unordered_map<std::string, int64_t> m_counts;
+    boost::unordered_map<uintptr_t, std::string> m_symbols;
+};
+
+}
+
+#endif /* STACKSAMPLER_H_ */
@@ -21,6 +21,7 @@
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
 #include "indexes/IndexStats.h"
+#include "indexes/IndexUsageStats.h"
 #include "storage/TableStats.h"
 #include "storage/temptable.h"
 
@@ -43,6 +44,8 @@ namespace
             return TableStats::generateEmptyTableStatsTable();
         case STATISTICS_SELECTOR_TYPE_INDEX:
             return IndexStats::generateEmptyIndexStatsTable();
+        case STATISTICS_SELECTOR_TYPE_INDEXUSAGE:
+            return IndexUsageStats::generateEmptyIndexUsageStatsTable();
         default:
             throwFatalException("Attempted to get unsupported stats type");
         }
@@ -76,6 +79,17 @@ void StatsAgent::unregisterStatsSource(StatisticsSelectorType sst) {
     it1->second.clear();
 }
 
+void StatsAgent::unregisterStatsSource(StatisticsSelectorType sst, CatalogId catalogId) {
+    map<StatisticsSelectorType,
+      multimap<CatalogId, StatsSource*> >::iterator it1 =
+      m_statsCategoryByStatsSelector.find(sst);
+
+    if (it1 == m_statsCategoryByStatsSelector.end()) {
+        return;
+    }
+    it1->second.erase(catalogId);
+}
+
 /**
  * Get statistics for the specified resources
  * @param sst StatisticsSelectorType of the resources
@@ -52,6 +52,11 @@ public:
      */
     void unregisterStatsSource(voltdb::StatisticsSelectorType sst);
 
+    /**
+     * Unassociate the instances of this selector type registered under the specified CatalogId
+     */
+    void unregisterStatsSource(voltdb::StatisticsSelectorType sst, voltdb::CatalogId catalogId);
+
     /**
      * Get statistics for the specified resources
      * @param sst StatisticsSelectorType of the resources
@@ -16,7 +16,10 @@
  */
 
 #include "AbstractDRTupleStream.h"
+#include "common/UniqueId.hpp"
+#include "stats/LatencySample.h"
 #include <cassert>
+#include <limits>
 
 using namespace std;
 using namespace voltdb;
@@ -50,6 +53,7 @@ void AbstractDRTupleStream::setSecondaryCapacity(size_t capacity)
 void AbstractDRTupleStream::pushExportBuffer(StreamBlock *block, bool sync, bool endOfStream)
 {
     if (sync) return;
+    ScopedLatencySample latencySample(LATENCY_DR_BUFFER_PUSH);
     int64_t rowTarget = ExecutorContext::getExecutorContext()->getTopend()->pushDRBuffer(m_partitionId, block);
     if (rowTarget >= 0) {
         m_rowTarget = rowTarget;
@@ -87,7 +91,7 @@ AbstractDRTupleStream::periodicFlush(int64_t timeInMillis,
                                      int64_t lastCommittedSpHandle)
 {
     // negative timeInMillis instructs a mandatory flush
-    if (timeInMillis < 0 || (m_flushInterval > 0 && timeInMillis - m_lastFlush > m_flushInterval)) {
+    if (timeInMillis < 0 || flushDue(timeInMillis)) {
         int64_t currentSpHandle = std::max(m_openSpHandle, lastCommittedSpHandle);
         if (timeInMillis > 0) {
             m_lastFlush = timeInMillis;
@@ -116,6 +120,31 @@ AbstractDRTupleStream::periodicFlush(int64_t timeInMillis,
     }
 }
 
+/*
+ * The flush interval is taken as the longest committed data should wait in
+ * the stream. Data goes out when the oldest buffered transaction reaches
+ * that age rather than on a fixed schedule, so a quiet stream is sent
+ * within the interval while a busy one fills its buffers for as long as
+ * the interval allows, instead of being cut into small ones.
+ */
+bool AbstractDRTupleStream::flushDue(int64_t timeInMillis) const
+{
+    if (m_flushInterval <= 0) {
+        return false;
+    }
+    const StreamBlock *oldest = m_pendingBlocks.empty() ? m_currBlock : m_pendingBlocks.front();
+    // Nothing is waiting until the oldest block holds committed data.
+    if (oldest != NULL && m_committedUso > oldest->uso()) {
+        int64_t startTime = oldest->startDRTimestamp();
+        // Without a timestamp, or with a transaction stamped by a clock
+        // ahead of ours, fall back to the fixed schedule.
+        if (startTime != std::numeric_limits<int64_t>::max() && startTime <= timeInMillis) {
+            return timeInMillis - startTime >= m_flushInterval;
+        }
+    }
+    return timeInMillis - m_lastFlush > m_flushInterval;
+}
+
 void AbstractDRTupleStream::setLastCommittedSequenceNumber(int64_t sequenceNumber)
 {
     assert(m_committedSequenceNumber <= m_openSequenceNumber);
@@ -129,6 +158,7 @@ void AbstractDRTupleStream::handleOpenTransaction(StreamBlock *oldBlock)
     size_t partialTxnLength = oldBlock->offset() - oldBlock->lastDRBeginTxnOffset();
     ::memcpy(m_currBlock->mutableDataPtr(), oldBlock->mutableLastBeginTxnDataPtr(), partialTxnLength);
     m_currBlock->startDRSequenceNumber(m_openSequenceNumber);
+    m_currBlock->startDRTimestamp(UniqueId::timestampSinceUnixEpoch(m_openUniqueId) / 1000);
     m_currBlock->recordLastBeginTxnOffset();
     m_currBlock->consumed(partialTxnLength);
     ::memset(oldBlock->mutableLastBeginTxnDataPtr(), 0, partialTxnLength);
@@ -25,6 +25,7 @@
 #include <deque>
 
 namespace voltdb {
+class TableIndex;
 
 // Extra space to write a StoredProcedureInvocation wrapper in Java without copying
 // this magic number is tied to the serialization size of an InvocationBuffer
@@ -58,6 +59,9 @@ public:
 
     virtual void setSecondaryCapacity(size_t capacity);
 
+    /** Whether periodicFlush at this time should push the committed data. */
+    bool flushDue(int64_t timeInMillis) const;
+
     void setLastCommittedSequenceNumber(int64_t sequenceNumber);
 
     /**
@@ -84,6 +88,28 @@ public:
                        TableTuple &oldTuple,
                        TableTuple &newTuple) = 0;
 
+    /** Whether appendChangedColumnsUpdateRecord() can write anything but a full update record */
+    virtual bool writesChangedColumnsUpdates() const { return false; }
+
+    /**
+     * write an update record for a table with a unique index for DR. Where the
+     * protocol allows, this is just the old row's key in that index and the new
+     * values of the columns that changed; otherwise it is a full update record.
+     * */
+    virtual size_t appendChangedColumnsUpdateRecord(int64_t lastCommittedSpHandle,
+                       char *tableHandle,
+                       int partitionColumn,
+                       int64_t spHandle,
+                       int64_t uniqueId,
+                       const TableIndex &uniqueIndex,
+                       uint32_t uniqueIndexCrc,
+                       TableTuple &oldTuple,
+                       TableTuple &newTuple)
+    {
+        return appendUpdateRecord(lastCommittedSpHandle, tableHandle, partitionColumn,
+                                  spHandle, uniqueId, oldTuple, newTuple);
+    }
+
     virtual size_t truncateTable(int64_t lastCommittedSpHandle,
                        char *tableHandle,
                        std::string tableName,
@@ -62,6 +62,9 @@ const static int DR_TUPLE_COLUMN_INDEX = 11;
 const static int DECISION_BIT = 1;
 const static int RESOLVED_BIT = 1 << 1;
 
+// Most consecutive insert rows decoded before they are inserted together
+const static size_t MAX_INSERT_BATCH_SIZE = 1024;
+
 // a c++ style way to limit access from outside this file
 namespace {
 
@@ -93,6 +96,7 @@ inline std::string DRRecordTypeStr(DRRecordType type) {
         return "D";
     case DR_RECORD_UPDATE:
     case DR_RECORD_UPDATE_BY_INDEX:
+    case DR_RECORD_UPDATE_CHANGED_COLUMNS:
         return "U";
     case DR_RECORD_TRUNCATE_TABLE:
         return "T";
@@ -484,6 +488,22 @@ bool handleConflict(VoltDBEngine *engine, PersistentTable *drTable, Pool *pool,
     return true;
 }
 
+void insertRow(PersistentTable *table, TableTuple &tuple, Pool *pool, VoltDBEngine *engine,
+               int32_t remoteClusterId, int64_t uniqueId) {
+    try {
+        table->insertPersistentTuple(tuple, true, true);
+    } catch (ConstraintFailureException &e) {
+        if (engine->getIsActiveActiveDREnabled()) {
+            if (handleConflict(engine, table, pool, NULL, NULL, const_cast<TableTuple *>(e.getConflictTuple()),
+                               uniqueId, remoteClusterId, DR_RECORD_INSERT, NO_CONFLICT,
+                               CONFLICT_CONSTRAINT_VIOLATION)) {
+                return;
+            }
+        }
+        throw;
+    }
+}
+
 } //end of anonymous namespace
 
 BinaryLogSink::BinaryLogSink() {}
@@ -522,9 +542,14 @@ int64_t BinaryLogSink::applyTxn(ReferenceSerializeInputLE *taskInfo,
     // Read the whole txn since there is only one version number at the beginning
     type = static_cast<DRRecordType>(taskInfo->readByte());
     while (type != DR_RECORD_END_TXN) {
-        rowCount += apply(taskInfo, type, tables, pool, engine, remoteClusterId,
-                txnStart, sequenceNumber, uniqueId, skipWrongHashRows);
-        type = static_cast<DRRecordType>(taskInfo->readByte());
+        if (type == DR_RECORD_INSERT && !skipWrongHashRows) {
+            type = applyInserts(taskInfo, rowCount, tables, pool, engine, remoteClusterId, uniqueId);
+        }
+        else {
+            rowCount += apply(taskInfo, type, tables, pool, engine, remoteClusterId,
+                    txnStart, sequenceNumber, uniqueId, skipWrongHashRows);
+            type = static_cast<DRRecordType>(taskInfo->readByte());
+        }
         if (type == DR_RECORD_HASH_DELIMITER) {
             assert(isMultiHash);
             partitionHash = taskInfo->readInt();
@@ -544,6 +569,67 @@ int64_t BinaryLogSink::applyTxn(ReferenceSerializeInputLE *taskInfo,
     return rowCount;
 }
 
+DRRecordType BinaryLogSink::applyInserts(ReferenceSerializeInputLE *taskInfo, int64_t &rowCount,
+                                         boost::unordered_map<int64_t, PersistentTable*> &tables,
+                                         Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                                         int64_t uniqueId) {
+    PersistentTable *batchTable = NULL;
+    DRRecordType type = DR_RECORD_INSERT;
+    while (type == DR_RECORD_INSERT) {
+        int64_t tableHandle = taskInfo->readLong();
+        int32_t rowLength = taskInfo->readInt();
+        const char *rowData = reinterpret_cast<const char *>(taskInfo->getRawPointer(rowLength));
+
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+        if (tableIter == tables.end()) {
+            throwSerializableEEException("Unable to find table hash %jd while applying a binary log insert record",
+                                         (intmax_t)tableHandle);
+        }
+        PersistentTable *table = tableIter->second;
+        if (table != batchTable || m_insertBatch.size() == MAX_INSERT_BATCH_SIZE) {
+            insertBatch(batchTable, pool, engine, remoteClusterId, uniqueId);
+            batchTable = table;
+        }
+
+        const TupleSchema *schema = table->schema();
+        TableTuple tuple(reinterpret_cast<char*>(pool->allocateZeroes(schema->tupleLength() + TUPLE_HEADER_SIZE)),
+                         schema);
+        ReferenceSerializeInputLE rowInput(rowData, rowLength);
+        try {
+            tuple.deserializeFromDR(rowInput, pool);
+        } catch (SerializableEEException &e) {
+            e.appendContextToMessage(" DR binary log insert on table " + table->name());
+            throw;
+        }
+        m_insertBatch.push_back(tuple);
+        rowCount += static_cast<int64_t>(rowCostForDRRecord(DR_RECORD_INSERT));
+
+        type = static_cast<DRRecordType>(taskInfo->readByte());
+    }
+    insertBatch(batchTable, pool, engine, remoteClusterId, uniqueId);
+    return type;
+}
+
+void BinaryLogSink::insertBatch(PersistentTable *table, Pool *pool, VoltDBEngine *engine,
+                                int32_t remoteClusterId, int64_t uniqueId) {
+    if (m_insertBatch.empty()) {
+        return;
+    }
+    if (m_insertBatch.size() > 1 && table->insertPersistentTupleBatch(m_insertBatch)) {
+        m_insertBatch.clear();
+        return;
+    }
+    // One row, or a batch with a conflict in it, goes in a row at a time so
+    // each conflict is found and handled as it would be on its own.
+    std::vector<TableTuple> batch;
+    batch.swap(m_insertBatch);
+    BOOST_FOREACH (TableTuple &tuple, batch) {
+        insertRow(table, tuple, pool, engine, remoteClusterId, uniqueId);
+    }
+    batch.clear();
+    batch.swap(m_insertBatch);
+}
+
 int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecordType type,
                              boost::unordered_map<int64_t, PersistentTable*> &tables,
                              Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
@@ -573,18 +659,7 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
             e.appendContextToMessage(" DR binary log insert on table " + table->name());
             throw;
         }
-        try {
-            table->insertPersistentTuple(tempTuple, true, true);
-        } catch (ConstraintFailureException &e) {
-            if (engine->getIsActiveActiveDREnabled()) {
-                if (handleConflict(engine, table, pool, NULL, NULL, const_cast<TableTuple *>(e.getConflictTuple()),
-                                   uniqueId, remoteClusterId, DR_RECORD_INSERT, NO_CONFLICT,
-                                   CONFLICT_CONSTRAINT_VIOLATION)) {
-                    break;
-                }
-            }
-            throw;
-        }
+        insertRow(table, tempTuple, pool, engine, remoteClusterId, uniqueId);
         break;
     }
     case DR_RECORD_DELETE: {
@@ -726,6 +801,73 @@ int64_t BinaryLogSink::apply(ReferenceSerializeInputLE *taskInfo, const DRRecord
         }
         break;
     }
+    case DR_RECORD_UPDATE_CHANGED_COLUMNS: {
+        int64_t tableHandle = taskInfo->readLong();
+        uint32_t indexCrc = taskInfo->readInt();
+        int32_t keyRowLength = taskInfo->readInt();
+        const char *keyRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(keyRowLength));
+        int32_t changedRowLength = taskInfo->readInt();
+        const char *changedRowData = reinterpret_cast<const char*>(taskInfo->getRawPointer(changedRowLength));
+        if (skipRow) {
+            break;
+        }
+
+        boost::unordered_map<int64_t, PersistentTable*>::iterator tableIter = tables.find(tableHandle);
+        if (tableIter == tables.end()) {
+            throwSerializableEEException("Unable to find table hash %jd while applying a binary log update record",
+                                         (intmax_t)tableHandle);
+        }
+        PersistentTable *table = tableIter->second;
+
+        std::pair<const TableIndex*, uint32_t> uniqueIndex = table->getUniqueIndexForDR();
+        if (!uniqueIndex.first || indexCrc != uniqueIndex.second) {
+            throwSerializableEEException("Unable to find unique index %u while applying a binary log update record on table %s",
+                                         indexCrc, table->name().c_str());
+        }
+        const TableIndex *index = uniqueIndex.first;
+
+        const TupleSchema *keySchema = index->getKeySchema();
+        TableTuple keyTuple(reinterpret_cast<char*>(pool->allocateZeroes(keySchema->tupleLength() + TUPLE_HEADER_SIZE)),
+                            keySchema);
+        ReferenceSerializeInputLE keyRowInput(keyRowData, keyRowLength);
+        try {
+            keyTuple.deserializeFromDR(keyRowInput, pool);
+        } catch (SerializableEEException &e) {
+            e.appendContextToMessage(" DR binary log update by changed columns (key) on table " + table->name());
+            throw;
+        }
+
+        IndexCursor indexCursor(index->getTupleSchema());
+        index->moveToKey(&keyTuple, indexCursor);
+        TableTuple oldTuple = index->nextValueAtKey(indexCursor);
+        if (oldTuple.isNullTuple()) {
+            throwSerializableEEException("Unable to find tuple for update: binary log type (%d), DR ID (%jd), unique ID (%jd), key %s\n",
+                                         type, (intmax_t)sequenceNumber, (intmax_t)uniqueId, keyTuple.debugNoHeader().c_str());
+        }
+
+        // Start from the existing row and overwrite just the columns that changed
+        TableTuple tempTuple = table->tempTuple();
+        tempTuple.copy(oldTuple);
+        const int columnCount = table->schema()->columnCount();
+        const int columnMaskLength = ((columnCount + 7) & -8) >> 3;
+        ReferenceSerializeInputLE changedRowInput(changedRowData, changedRowLength);
+        std::vector<int> changedColumns;
+        try {
+            const uint8_t *columnMask = reinterpret_cast<const uint8_t*>(changedRowInput.getRawPointer(columnMaskLength));
+            for (int i = 0; i < columnCount; i++) {
+                if (columnMask[i >> 3] & (0x80u >> (i % 8))) {
+                    changedColumns.push_back(i);
+                }
+            }
+            tempTuple.deserializeColumnsFromDR(changedRowInput, pool, changedColumns, true);
+        } catch (SerializableEEException &e) {
+            e.appendContextToMessage(" DR binary log update by changed columns (new values) on table " + table->name());
+            throw;
+        }
+
+        table->updateTupleWithSpecificIndexes(oldTuple, tempTuple, table->allIndexes(), true, false);
+        break;
+    }
     case DR_RECORD_DELETE_BY_INDEX: {
         throwSerializableEEException("Delete by index is not supported for DR");
     }
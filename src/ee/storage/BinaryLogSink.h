@@ -19,10 +19,13 @@
 #define BINARYLOGSINK_H
 
 #include "common/serializeio.h"
+#include "common/tabletuple.h"
 
 #include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <vector>
+
 namespace voltdb {
 
 class PersistentTable;
@@ -45,6 +48,22 @@ private:
                   boost::unordered_map<int64_t, PersistentTable*> &tables,
                   Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
                   const char *txnStart, int64_t sequenceNumber, int64_t uniqueId, bool skipRow);
+
+    /*
+     * Applies a run of insert records, the first of whose type was just
+     * read, decoding each table's consecutive rows before inserting them
+     * together. Returns the type of the record after the run.
+     */
+    DRRecordType applyInserts(ReferenceSerializeInputLE *taskInfo, int64_t &rowCount,
+                              boost::unordered_map<int64_t, PersistentTable*> &tables,
+                              Pool *pool, VoltDBEngine *engine, int32_t remoteClusterId,
+                              int64_t uniqueId);
+
+    void insertBatch(PersistentTable *table, Pool *pool, VoltDBEngine *engine,
+                     int32_t remoteClusterId, int64_t uniqueId);
+
+    // Decoded rows of the insert run being applied, all for one table
+    std::vector<TableTuple> m_insertBatch;
 };
 
 
@@ -37,7 +37,8 @@ int64_t BinaryLogSinkWrapper::apply(const char* taskParams, boost::unordered_map
         pool->purge();
         const char* recordStart = taskInfo.getRawPointer();
         const uint8_t drVersion = taskInfo.readByte();
-        if (drVersion == DRTupleStream::PROTOCOL_VERSION) {
+        if (drVersion >= DRTupleStream::COORDINATED_MP_PROTOCOL_VERSION &&
+            drVersion <= DRTupleStream::PROTOCOL_VERSION) {
             rowCount += m_sink.applyTxn(&taskInfo, tables, pool, engine, remoteClusterId,
                                         recordStart);
         } else if (drVersion == CompatibleDRTupleStream::COMPATIBLE_PROTOCOL_VERSION) {
@@ -0,0 +1,167 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/ColdStorage.h"
+
+#include "common/ThreadLocalPool.h"
+#include "logging/LogManager.h"
+#include "storage/persistenttable.h"
+#include "storage/TupleBlock.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <errno.h>
+#include <unistd.h>
+
+namespace voltdb {
+
+namespace {
+
+struct EvictionCandidate {
+    EvictionCandidate(PersistentTable *table, TBPtr block) : m_table(table), m_block(block) { }
+
+    PersistentTable *m_table;
+    TBPtr m_block;
+};
+
+// Blocks that have gone the most passes without a scan go first.
+bool idlerThan(const EvictionCandidate &lhs, const EvictionCandidate &rhs) {
+    return lhs.m_block->idlePasses() > rhs.m_block->idlePasses();
+}
+
+}
+
+ColdStorage::ColdStorage(const std::string &directory, int64_t maxResidentBytes)
+  : m_fd(-1)
+  , m_fileSize(0)
+  , m_pageSize(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)))
+  , m_maxResidentBytes(maxResidentBytes)
+  , m_coldBytes(0)
+{
+    if (directory.empty()) {
+        return;
+    }
+    std::string path = directory + "/voltdb-cold-blocks-XXXXXX";
+    std::vector<char> pathBuffer(path.begin(), path.end());
+    pathBuffer.push_back('\0');
+    m_fd = ::mkstemp(&pathBuffer[0]);
+    if (m_fd < 0) {
+        char msg[1024];
+        snprintf(msg, sizeof(msg), "Could not create a cold storage file in %s: %s. "
+                 "Tuple blocks will be paged out instead.", directory.c_str(), strerror(errno));
+        LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN, msg);
+        return;
+    }
+    // Nothing outlives the site, so the file only needs to exist through
+    // its descriptor.
+    ::unlink(&pathBuffer[0]);
+}
+
+ColdStorage::~ColdStorage() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+int ColdStorage::evictIdleBlocks(const std::vector<PersistentTable*> &tables, int maxEvictions) {
+    std::vector<EvictionCandidate> candidates;
+    int64_t residentBytes = 0;
+    for (std::vector<PersistentTable*>::const_iterator table = tables.begin(); table != tables.end(); ++table) {
+        std::vector<TBPtr> evictable;
+        residentBytes += (*table)->ageTupleBlocks(evictable);
+        for (std::vector<TBPtr>::const_iterator block = evictable.begin(); block != evictable.end(); ++block) {
+            candidates.push_back(EvictionCandidate(*table, *block));
+        }
+    }
+    if (residentBytes <= m_maxResidentBytes) {
+        return 0;
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), idlerThan);
+    int evicted = 0;
+    for (std::vector<EvictionCandidate>::iterator candidate = candidates.begin();
+         candidate != candidates.end() && evicted < maxEvictions && residentBytes > m_maxResidentBytes;
+         ++candidate) {
+        if (!evict(*candidate->m_block)) {
+            break;
+        }
+        candidate->m_table->noteBlockEviction(candidate->m_block);
+        residentBytes -= candidate->m_block->allocationSize();
+        ++evicted;
+    }
+    return evicted;
+}
+
+bool ColdStorage::evict(TupleBlock &block) {
+    assert(!block.isCold());
+    if (m_fd < 0) {
+        if (!ThreadLocalPool::pageOutLargeBlock(block.address(), block.allocationSize())) {
+            return false;
+        }
+        block.setCold(this, PAGED_OUT);
+        m_coldBytes += block.allocationSize();
+        return true;
+    }
+    std::size_t size = slotSize(block.allocationSize());
+    off_t offset;
+    std::map<std::size_t, std::vector<off_t> >::iterator freeSlots = m_freeSlots.find(size);
+    if (freeSlots != m_freeSlots.end() && !freeSlots->second.empty()) {
+        offset = freeSlots->second.back();
+        freeSlots->second.pop_back();
+    }
+    else {
+        offset = m_fileSize;
+        if (::ftruncate(m_fd, offset + size) != 0) {
+            return false;
+        }
+        m_fileSize += size;
+    }
+    if (!ThreadLocalPool::moveLargeBlockToFile(block.address(), block.allocationSize(), m_fd, offset)) {
+        m_freeSlots[size].push_back(offset);
+        return false;
+    }
+    block.setCold(this, offset);
+    m_coldBytes += block.allocationSize();
+    return true;
+}
+
+void ColdStorage::restore(TupleBlock &block) {
+    assert(block.isCold());
+    if (block.coldOffset() != PAGED_OUT) {
+        ThreadLocalPool::moveLargeBlockToMemory(block.address(), block.allocationSize());
+    }
+    release(block.coldOffset(), block.allocationSize());
+    block.setCold(NULL, 0);
+}
+
+void ColdStorage::release(off_t offset, std::size_t size) {
+    if (offset != PAGED_OUT) {
+        m_freeSlots[slotSize(size)].push_back(offset);
+    }
+    m_coldBytes -= size;
+}
+
+std::size_t ColdStorage::slotSize(std::size_t size) const {
+    // File offsets of mappings have to be page aligned.
+    return (size + m_pageSize - 1) / m_pageSize * m_pageSize;
+}
+
+}
@@ -0,0 +1,101 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLDSTORAGE_H_
+#define COLDSTORAGE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace voltdb {
+
+class PersistentTable;
+class TupleBlock;
+
+/**
+ * A site's cold tier for tuple blocks. When the tuple blocks of the site's
+ * persistent tables take more memory than the budget, the full blocks
+ * that have gone longest without being scanned are written to a local
+ * file, which is then mapped over them. A cold block keeps its address --
+ * indexes, iterators and snapshot streams reach its tuples as before --
+ * and its pages are read back from the file as they are touched, so the
+ * kernel decides what actually stays in memory. A cold block is brought
+ * back into memory as a whole when it takes inserts again.
+ *
+ * Without a directory, cold blocks are instead paged out to swap, where
+ * zswap or zram compress them -- rows that are mostly zeros or repeated
+ * bytes compress well -- and are brought back page by page on access.
+ * Tuples cannot be compressed in place by the engine itself, because the
+ * indexes hold their addresses.
+ */
+class ColdStorage {
+public:
+    /**
+     * Keep the file in directory, or page blocks out if it is empty, and
+     * at most maxResidentBytes of tuple blocks in memory.
+     */
+    ColdStorage(const std::string &directory, int64_t maxResidentBytes);
+    ~ColdStorage();
+
+    /**
+     * Age the blocks of the tables, then evict the idlest full blocks
+     * until the resident blocks fit in the budget or maxEvictions blocks
+     * have been evicted. Returns the number of blocks evicted.
+     */
+    int evictIdleBlocks(const std::vector<PersistentTable*> &tables, int maxEvictions);
+
+    /**
+     * Write a block out and map the file over it, or page it out. Returns
+     * false, leaving the block in memory, if it cannot be moved.
+     */
+    bool evict(TupleBlock &block);
+
+    /** Bring a cold block back into memory. */
+    void restore(TupleBlock &block);
+
+    /** Give back the file space of a cold block that is being freed. */
+    void release(off_t offset, std::size_t size);
+
+    /** Bytes of blocks currently cold. */
+    int64_t coldBytes() const { return m_coldBytes; }
+
+    // Blocks written out per tick, each one a synchronous write.
+    static const int TICK_MAX_EVICTIONS = 32;
+
+    // The cold offset of a block that was paged out rather than written
+    // to the file.
+    static const off_t PAGED_OUT = -1;
+
+private:
+    std::size_t slotSize(std::size_t size) const;
+
+    int m_fd;
+    off_t m_fileSize;
+    std::size_t m_pageSize;
+    int64_t m_maxResidentBytes;
+    int64_t m_coldBytes;
+    // File space given back by freed or restored blocks, by slot size.
+    std::map<std::size_t, std::vector<off_t> > m_freeSlots;
+};
+
+}
+
+#endif /* COLDSTORAGE_H_ */
@@ -22,13 +22,61 @@
 #include "common/TupleOutputStream.h"
 #include "common/FatalException.hpp"
 #include "common/StreamPredicateList.h"
+#include "common/ThreadLocalPool.h"
 #include "logging/LogManager.h"
+#include <boost/foreach.hpp>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 namespace voltdb {
 
+CopyOnWriteContext::FrozenBlock::FrozenBlock(const char *address, uint32_t tupleCount, int tupleLength) :
+    m_size(static_cast<size_t>(tupleCount) * tupleLength),
+    m_data(ThreadLocalPool::allocateLargeBlock(m_size)),
+    m_tupleCount(tupleCount)
+{
+    ::memcpy(m_data, address, m_size);
+}
+
+CopyOnWriteContext::FrozenBlock::~FrozenBlock()
+{
+    ThreadLocalPool::freeLargeBlock(m_data, m_size);
+}
+
+/**
+ * Iterates over the frozen blocks' copies, returning the tuples the
+ * table scan left to them.
+ */
+class CopyOnWriteContext::FrozenBlockIterator : public TupleIterator {
+public:
+    FrozenBlockIterator(const boost::ptr_vector<FrozenBlock> &blocks, int tupleLength) :
+        m_blocks(blocks), m_tupleLength(tupleLength), m_blockIndex(0), m_tupleIndex(0)
+    {}
+
+    bool next(TableTuple &out) {
+        while (m_blockIndex < m_blocks.size()) {
+            const FrozenBlock &block = m_blocks[m_blockIndex];
+            while (m_tupleIndex < block.m_tupleCount) {
+                out.move(block.m_data + m_tupleIndex++ * m_tupleLength);
+                if (out.isActive() && !out.isDirty() && !out.isPendingDelete()) {
+                    return true;
+                }
+            }
+            m_blockIndex++;
+            m_tupleIndex = 0;
+        }
+        return false;
+    }
+
+private:
+    const boost::ptr_vector<FrozenBlock> &m_blocks;
+    const int m_tupleLength;
+    size_t m_blockIndex;
+    uint32_t m_tupleIndex;
+};
+
 /**
  * Constructor.
  */
@@ -50,7 +98,10 @@ CopyOnWriteContext::CopyOnWriteContext(
              m_serializationBatches(0),
              m_inserts(0),
              m_deletes(0),
-             m_updates(0)
+             m_updates(0),
+             m_freezesBlocks(false),
+             m_frozenBlocks(),
+             m_finishedFrozenBlocks(false)
 {
 }
 
@@ -58,7 +109,13 @@ CopyOnWriteContext::CopyOnWriteContext(
  * Destructor.
  */
 CopyOnWriteContext::~CopyOnWriteContext()
-{}
+{
+    int64_t frozenBytes = 0;
+    BOOST_FOREACH(const FrozenBlock &block, m_frozenBlocks) {
+        frozenBytes += block.m_size;
+    }
+    m_surgeon.addSnapshotCopyMemory(-frozenBytes);
+}
 
 
 /**
@@ -82,6 +139,10 @@ CopyOnWriteContext::handleActivation(TableStreamType streamType)
 
     m_iterator.reset(new CopyOnWriteIterator(&getTable(), &m_surgeon));
 
+    const std::vector<bool> &deleteFlags = getPredicateDeleteFlags();
+    m_freezesBlocks = getTable().schema()->getUninlinedObjectColumnCount() == 0 &&
+        std::find(deleteFlags.begin(), deleteFlags.end(), true) == deleteFlags.end();
+
     return ACTIVATION_SUCCEEDED;
 }
 
@@ -106,7 +167,8 @@ int64_t CopyOnWriteContext::handleStreamMore(TupleOutputStreamProcessor &outputS
                        getMaxTupleLength(),
                        getPartitionId(),
                        getPredicates(),
-                       getPredicateDeleteFlags());
+                       getPredicateDeleteFlags(),
+                       getPredicateRowFormats());
 
     //=== Tuple processing loop
 
@@ -161,11 +223,18 @@ int64_t CopyOnWriteContext::handleStreamMore(TupleOutputStreamProcessor &outputS
 
         } else if (!m_finishedTableScan) {
             /*
-             * After scanning the persistent table switch to scanning the temp
-             * table with the tuples that were backed up.
+             * After scanning the persistent table switch to scanning the copies
+             * of the blocks that were frozen.
              */
             m_finishedTableScan = true;
             // Note that m_iterator no longer points to (or should reference) the CopyOnWriteIterator
+            m_iterator.reset(new FrozenBlockIterator(m_frozenBlocks, table.getTupleLength()));
+        } else if (!m_finishedFrozenBlocks) {
+            /*
+             * Then switch to scanning the temp table with the tuples that
+             * were backed up.
+             */
+            m_finishedFrozenBlocks = true;
             m_iterator.reset(m_backedUpTuples->makeIterator());
         } else {
             /*
@@ -193,6 +262,7 @@ int64_t CopyOnWriteContext::handleStreamMore(TupleOutputStreamProcessor &outputS
                          "Pending block count: %jd\n"
                          "Pending load block count: %jd\n"
                          "Compacted block count: %jd\n"
+                         "Frozen block count: %jd\n"
                          "Dirty insert count: %jd\n"
                          "Dirty delete count: %jd\n"
                          "Dirty update count: %jd\n"
@@ -207,6 +277,7 @@ int64_t CopyOnWriteContext::handleStreamMore(TupleOutputStreamProcessor &outputS
                          (intmax_t)allPendingCnt,
                          (intmax_t)pendingLoadCnt,
                          (intmax_t)m_blocksCompacted,
+                         (intmax_t)m_frozenBlocks.size(),
                          (intmax_t)m_inserts,
                          (intmax_t)m_deletes,
                          (intmax_t)m_updates,
@@ -302,7 +373,12 @@ bool CopyOnWriteContext::notifyTupleDelete(TableTuple &tuple) {
      * Now check where this is relative to the COWIterator.
      */
     CopyOnWriteIterator *iter = reinterpret_cast<CopyOnWriteIterator*>(m_iterator.get());
-    return !iter->needToDirtyTuple(tuple.address());
+    TBPtr block;
+    if (!iter->needToDirtyTuple(tuple.address(), &block)) {
+        return true;
+    }
+    // The copy of a frozen block keeps the tuple for the snapshot.
+    return block.get() != NULL && iter->isFrozen(block);
 }
 
 void CopyOnWriteContext::markTupleDirty(TableTuple tuple, bool newTuple) {
@@ -329,9 +405,8 @@ void CopyOnWriteContext::markTupleDirty(TableTuple tuple, bool newTuple) {
      * Now check where this is relative to the COWIterator.
      */
     CopyOnWriteIterator *iter = reinterpret_cast<CopyOnWriteIterator*>(m_iterator.get());
-    if (iter->needToDirtyTuple(tuple.address())) {
-        tuple.setDirtyTrue();
-
+    TBPtr block;
+    if (iter->needToDirtyTuple(tuple.address(), &block)) {
         if (newTuple) {
             /**
              * Don't back up a newly introduced tuple, just mark it as dirty.
@@ -340,8 +415,18 @@ void CopyOnWriteContext::markTupleDirty(TableTuple tuple, bool newTuple) {
         }
         else {
             m_updates++;
-            m_backedUpTuples->insertTempTupleDeepCopy(tuple, &m_pool);
+            /**
+             * The tuple's own block is copied, or the tuple alone when the
+             * scan is already in its block and did not freeze it before.
+             * Tuples of a frozen block are marked dirty too, so that they
+             * stay skipped if compaction moves them to a block that is not
+             * frozen.
+             */
+            if (block.get() == NULL || !freezeBlock(block)) {
+                m_backedUpTuples->insertTempTupleDeepCopy(tuple, &m_pool);
+            }
         }
+        tuple.setDirtyTrue();
     } else {
         tuple.setDirtyFalse();
         return;
@@ -363,6 +448,44 @@ void CopyOnWriteContext::notifyBlockWasCompactedAway(TBPtr block) {
     iter->notifyBlockWasCompactedAway(block);
 }
 
+bool CopyOnWriteContext::freezeBlock(const TBPtr &block) {
+    if (!m_freezesBlocks) {
+        return false;
+    }
+    CopyOnWriteIterator *iter = static_cast<CopyOnWriteIterator*>(m_iterator.get());
+    if (iter->m_frozenBlocks.insert(block->address()).second) {
+        m_frozenBlocks.push_back(new FrozenBlock(block->address(),
+                                                 block->unusedTupleBoundry(),
+                                                 getTable().getTupleLength()));
+        m_surgeon.addSnapshotCopyMemory(m_frozenBlocks.back().m_size);
+    }
+    return true;
+}
+
+void CopyOnWriteContext::notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
+                                             TableTuple &sourceTuple, TableTuple &targetTuple) {
+    if (m_finishedTableScan || m_frozenBlocks.empty()) {
+        return;
+    }
+    // Compaction only moves tuples between blocks the scan has not reached.
+    CopyOnWriteIterator *iter = static_cast<CopyOnWriteIterator*>(m_iterator.get());
+    const bool sourceFrozen = iter->isFrozen(sourceBlock);
+    const bool targetFrozen = iter->isFrozen(targetBlock);
+    if (sourceFrozen == targetFrozen || targetTuple.isPendingDelete()) {
+        // Pending deletes are returned by the scan from whichever block they are in.
+        return;
+    }
+    if (sourceFrozen) {
+        // The source's copy already has the tuple, if the snapshot wants it.
+        targetTuple.setDirtyTrue();
+    }
+    else if (!targetTuple.isDirty()) {
+        // The scan won't return it from a frozen block, so back it up.
+        m_backedUpTuples->insertTempTupleDeepCopy(targetTuple, &m_pool);
+        targetTuple.setDirtyTrue();
+    }
+}
+
 bool CopyOnWriteContext::notifyTupleInsert(TableTuple &tuple) {
     markTupleDirty(tuple, true);
     return true;
@@ -388,6 +511,10 @@ void CopyOnWriteContext::checkRemainingTuples(const std::string &label) {
     while (iter->next(tuple)) {
         count2++;
     }
+    FrozenBlockIterator frozenIter(m_frozenBlocks, getTable().getTupleLength());
+    while (frozenIter.next(tuple)) {
+        count2++;
+    }
     if (m_tuplesRemaining != count1 + count2) {
         char errMsg[1024 * 16];
         snprintf(errMsg, 1024 * 16,
@@ -85,8 +85,38 @@ public:
      */
     virtual bool notifyTupleDelete(TableTuple &tuple);
 
+    /**
+     * Optional tuple compaction handler.
+     */
+    virtual void notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
+                                     TableTuple &sourceTuple, TableTuple &targetTuple);
+
 private:
 
+    /**
+     * Copy of a block's tuples, taken on the first update of a tuple in a
+     * block the scan has not reached yet.  The copy's tuples that were
+     * neither dirty nor pending delete are streamed after the table scan;
+     * later writes to the block need no backup copies.  The copy is
+     * allocated like the table's own blocks and counted in the table's
+     * snapshotCopyMemory() while the snapshot runs.
+     */
+    struct FrozenBlock {
+        FrozenBlock(const char *address, uint32_t tupleCount, int tupleLength);
+        ~FrozenBlock();
+
+        const size_t m_size;
+        char * const m_data;
+        const uint32_t m_tupleCount;
+
+    private:
+        // No implicit copies
+        FrozenBlock(const FrozenBlock&);
+        FrozenBlock& operator=(const FrozenBlock&);
+    };
+
+    class FrozenBlockIterator;
+
     /**
      * Construct a copy on write context for the specified table that will
      * serialize tuples using the provided serializer.
@@ -128,6 +158,23 @@ private:
 
     void checkRemainingTuples(const std::string &label);
 
+    /**
+     * Copy the block for the snapshot, unless it is already copied.
+     * Returns false when this snapshot does not freeze blocks.
+     */
+    bool freezeBlock(const TBPtr &block);
+
+    /**
+     * Blocks are only frozen when the tuples hold no pointers to
+     * uninlined data, which updates and deletes free, and when the
+     * stream deletes no tuples, which it can only do in the table.
+     */
+    bool m_freezesBlocks;
+
+    boost::ptr_vector<FrozenBlock> m_frozenBlocks;
+
+    bool m_finishedFrozenBlocks;
+
 };
 
 }
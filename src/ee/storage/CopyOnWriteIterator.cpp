@@ -28,6 +28,7 @@ CopyOnWriteIterator::CopyOnWriteIterator(
         m_location(NULL),
         m_blockOffset(0),
         m_currentBlock(NULL),
+        m_currentBlockFrozen(false),
         m_tableEmpty(false),
         m_skippedDirtyRows(0),
         m_skippedInactiveRows(0) {
@@ -58,7 +59,10 @@ CopyOnWriteIterator::CopyOnWriteIterator(
  * in the used portion of the table blocks and doesn't overrun to the uninitialized block memory because
  * it skiped a dirty tuple and didn't end up with the right found tuple count upon reaching the end.
  */
-bool CopyOnWriteIterator::needToDirtyTuple(char *tupleAddress) {
+bool CopyOnWriteIterator::needToDirtyTuple(char *tupleAddress, TBPtr *blockAhead) {
+    if (blockAhead != NULL) {
+        *blockAhead = TBPtr();
+    }
     if (m_tableEmpty) {
         // snapshot was activated when the table was empty.
         // Tuple is not in  snapshot region, don't care about this tuple
@@ -84,11 +88,18 @@ bool CopyOnWriteIterator::needToDirtyTuple(char *tupleAddress) {
      */
     const char *blockAddress = block->address();
     if (blockAddress > m_currentBlock->address()) {
+        if (blockAhead != NULL) {
+            *blockAhead = block;
+        }
         return true;
     }
 
     assert(blockAddress == m_currentBlock->address());
     if (tupleAddress >= m_location) {
+        // The rest of a frozen block comes from its copy too.
+        if (blockAhead != NULL && m_currentBlockFrozen) {
+            *blockAhead = m_currentBlock;
+        }
         return true;
     } else {
         return false;
@@ -117,6 +128,7 @@ bool CopyOnWriteIterator::next(TableTuple &out) {
             m_currentBlock = m_blockIterator.data();
             assert(m_currentBlock->address() == m_location);
             m_blockOffset = 0;
+            m_currentBlockFrozen = isFrozen(m_currentBlock);
 
             // Remove the finished block from the map so that it can be released
             // back to the OS if all tuples in the block is deleted.
@@ -125,6 +137,7 @@ bool CopyOnWriteIterator::next(TableTuple &out) {
             // using the current block's start address. m_blockIterator has to
             // point to the next block, hence the upper_bound() call.
             m_blocks.erase(finishedBlock);
+            m_frozenBlocks.erase(finishedBlock);
             m_blockIterator = m_blocks.upper_bound(m_currentBlock->address());
             m_end = m_blocks.end();
         }
@@ -139,8 +152,9 @@ bool CopyOnWriteIterator::next(TableTuple &out) {
         if (dirty) m_skippedDirtyRows++;
         if (!active) m_skippedInactiveRows++;
 
-        // Return this tuple only when this tuple is not marked as deleted and isn't dirty
-        if (active && !dirty) {
+        // Return this tuple only when this tuple is not marked as deleted and isn't dirty.
+        // The other tuples of a frozen block are returned from its copy.
+        if (active && !dirty && (!m_currentBlockFrozen || out.isPendingDelete())) {
             out.setDirtyFalse();
             m_location += m_tupleLength;
             return true;
@@ -162,6 +176,7 @@ int64_t CopyOnWriteIterator::countRemaining() const {
     TupleBlock *pcurrentBlock = m_currentBlock.get();
     TBPtr currentBlock(pcurrentBlock);
     TBMapI blockIterator = m_blockIterator;
+    bool frozen = m_currentBlockFrozen;
     int64_t count = 0;
     while (true) {
         if (blockOffset >= currentBlock->unusedTupleBoundry()) {
@@ -173,11 +188,12 @@ int64_t CopyOnWriteIterator::countRemaining() const {
             assert(currentBlock->address() == location);
             blockOffset = 0;
             blockIterator++;
+            frozen = isFrozen(currentBlock);
         }
         blockOffset++;
         out.move(location);
         location += m_tupleLength;
-        if (out.isActive() && !out.isDirty()) {
+        if (out.isActive() && !out.isDirty() && (!frozen || out.isPendingDelete())) {
             count++;
         }
     }
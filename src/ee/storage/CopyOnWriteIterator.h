@@ -21,6 +21,7 @@
 #include "storage/TupleIterator.h"
 #include "stx/btree_map.h"
 #include "storage/TupleBlock.h"
+#include <boost/unordered_set.hpp>
 
 namespace voltdb {
 class PersistentTable;
@@ -35,7 +36,20 @@ public:
         PersistentTable *table,
         PersistentTableSurgeon *surgeon);
 
-    bool needToDirtyTuple(char *tupleAddress);
+    /**
+     * When blockAhead is given, it is set to the tuple's block if the
+     * scan has not reached that block yet, or is in it and it is frozen,
+     * and to NULL otherwise.
+     */
+    bool needToDirtyTuple(char *tupleAddress, TBPtr *blockAhead = NULL);
+
+    /**
+     * Whether the snapshot took a copy of the block, so the scan only
+     * returns the block's tuples that are pending delete.
+     */
+    bool isFrozen(const TBPtr &block) const {
+        return m_frozenBlocks.find(block->address()) != m_frozenBlocks.end();
+    }
 
     bool next(TableTuple &out);
 
@@ -51,6 +65,7 @@ public:
                 if (m_blockIterator != m_end) {
                     TBPtr newNextBlock = m_blockIterator.data();
                     m_blocks.erase(block->address());
+                    m_frozenBlocks.erase(block->address());
                     m_blockIterator = m_blocks.find(newNextBlock->address());
                     m_end = m_blocks.end();
                     assert(m_blockIterator != m_end);
@@ -58,11 +73,13 @@ public:
                     //No block after the one compacted away
                     //set everything to end
                     m_blocks.erase(block->address());
+                    m_frozenBlocks.erase(block->address());
                     m_blockIterator = m_blocks.end();
                     m_end = m_blocks.end();
                 }
             } else {
                 //Some random block was compacted away. Remove it and regenerate the iterator
+                m_frozenBlocks.erase(block->address());
                 m_blocks.erase(block->address());
                 m_blockIterator = m_blocks.find(nextBlock->address());
                 m_end = m_blocks.end();
@@ -108,6 +125,13 @@ private:
 
     uint32_t m_blockOffset;
     TBPtr m_currentBlock;
+    bool m_currentBlockFrozen;
+
+    /**
+     * Addresses of the blocks ahead of the scan that the snapshot has copied
+     */
+    boost::unordered_set<char*> m_frozenBlocks;
+
     // flag to track if the snapshot was activated when the table was empty
     bool m_tableEmpty;
 public:
@@ -50,7 +50,8 @@ DRTupleStream::DRTupleStream(int partitionId, int defaultBufferSize)
       m_lastParHash(LONG_MAX),
       m_beginTxnUso(0),
       m_lastCommittedSpUniqueId(0),
-      m_lastCommittedMpUniqueId(0)
+      m_lastCommittedMpUniqueId(0),
+      m_protocolVersion(PROTOCOL_VERSION)
 {}
 
 size_t DRTupleStream::truncateTable(int64_t lastCommittedSpHandle,
@@ -324,6 +325,101 @@ size_t DRTupleStream::appendUpdateRecord(int64_t lastCommittedSpHandle,
     return startingUso;
 }
 
+size_t DRTupleStream::appendChangedColumnsUpdateRecord(int64_t lastCommittedSpHandle,
+                                                       char *tableHandle,
+                                                       int partitionColumn,
+                                                       int64_t spHandle,
+                                                       int64_t uniqueId,
+                                                       const TableIndex &uniqueIndex,
+                                                       uint32_t uniqueIndexCrc,
+                                                       TableTuple &oldTuple,
+                                                       TableTuple &newTuple)
+{
+    const std::vector<int> &keyColumns = uniqueIndex.getColumnIndices();
+    bool keyFromColumns = uniqueIndex.getIndexedExpressions().empty();
+    for (size_t i = 0; keyFromColumns && i < keyColumns.size(); i++) {
+        keyFromColumns = !oldTuple.isNull(keyColumns[i]);
+    }
+    if (!writesChangedColumnsUpdates() || !keyFromColumns) {
+        return appendUpdateRecord(lastCommittedSpHandle, tableHandle, partitionColumn,
+                                  spHandle, uniqueId, oldTuple, newTuple);
+    }
+
+    if (m_guarded) return INVALID_DR_MARK;
+
+    size_t startingUso = m_uso;
+
+    transactionChecks(lastCommittedSpHandle, spHandle, uniqueId);
+
+    //Drop the row, don't move the USO
+    if (!m_enabled) return INVALID_DR_MARK;
+
+    bool requireHashDelimiter = updateParHash(partitionColumn == -1, getParHashForTuple(oldTuple, partitionColumn));
+
+    const int columnCount = newTuple.sizeInValues();
+    m_changedColumns.clear();
+    for (int i = 0; i < columnCount; i++) {
+        if (oldTuple.getNValue(i).compare(newTuple.getNValue(i)) != 0) {
+            m_changedColumns.push_back(i);
+        }
+    }
+
+    const size_t columnMaskLength = ((columnCount + 7) & -8) >> 3;
+    size_t maxLength = TXN_RECORD_HEADER_SIZE + sizeof(int32_t);
+    maxLength += sizeof(int32_t) + (((keyColumns.size() + 7) & -8) >> 3) +
+                 oldTuple.maxDRSerializationSize(keyColumns, false);
+    maxLength += sizeof(int32_t) + columnMaskLength + (((m_changedColumns.size() + 7) & -8) >> 3) +
+                 newTuple.maxDRSerializationSize(m_changedColumns, true);
+    if (requireHashDelimiter) {
+        maxLength += HASH_DELIMITER_SIZE;
+    }
+
+    if (!m_currBlock) {
+        try {
+            extendBufferChain(m_defaultCapacity);
+        } catch (TupleStreamException &e) {
+            e.appendContextToMessage(" DR update tuple");
+            throw;
+        }
+    }
+
+    if (m_currBlock->remaining() < maxLength) {
+        try {
+            extendBufferChain(maxLength);
+        } catch (TupleStreamException &e) {
+            e.appendContextToMessage(" DR update tuple");
+            throw;
+        }
+    }
+
+    ExportSerializeOutput io(m_currBlock->mutableDataPtr(),
+                                 m_currBlock->remaining());
+
+    if (requireHashDelimiter) {
+        io.writeByte(static_cast<int8_t>(DR_RECORD_HASH_DELIMITER));
+        io.writeInt(static_cast<int32_t>(m_lastParHash));
+    }
+
+    DRRecordType type = DR_RECORD_UPDATE_CHANGED_COLUMNS;
+    io.writeByte(static_cast<int8_t>(type));
+    io.writeLong(*reinterpret_cast<int64_t*>(tableHandle));
+    io.writeInt(static_cast<int32_t>(uniqueIndexCrc));
+
+    writeColumns(oldTuple, keyColumns, false, 0, io);
+    writeColumns(newTuple, m_changedColumns, true, columnMaskLength, io);
+
+    // update m_offset
+    m_currBlock->consumed(io.position());
+
+    // update uso.
+    m_uso += io.position();
+
+    // update row count
+    m_txnRowCount += rowCostForDRRecord(type);
+
+    return startingUso;
+}
+
 bool DRTupleStream::transactionChecks(int64_t lastCommittedSpHandle, int64_t spHandle, int64_t uniqueId)
 {
     // Transaction IDs for transactions applied to this tuple stream
@@ -375,6 +471,33 @@ void DRTupleStream::writeRowTuple(TableTuple& tuple,
     hdr.writeInt((int32_t)(io.position() - startPos - sizeof(int32_t)));
 }
 
+void DRTupleStream::writeColumns(TableTuple& tuple,
+        const std::vector<int> &columns,
+        bool includeHiddenColumns,
+        size_t columnMaskLength,
+        ExportSerializeOutput &io)
+{
+    size_t startPos = io.position();
+    size_t rowHeaderSz = sizeof(int32_t) + columnMaskLength + (((columns.size() + 7) & -8) >> 3);
+    char *rowHeader = m_currBlock->mutableDataPtr() + io.position();
+    ::memset(rowHeader, 0, rowHeaderSz);
+    // the column mask marks which of the row's columns follow
+    if (columnMaskLength > 0) {
+        uint8_t *columnMask = reinterpret_cast<uint8_t*>(rowHeader + sizeof(int32_t));
+        for (size_t i = 0; i < columns.size(); i++) {
+            columnMask[columns[i] >> 3] = static_cast<uint8_t>(columnMask[columns[i] >> 3] | (0x80 >> (columns[i] % 8)));
+        }
+    }
+    uint8_t *nullArray = reinterpret_cast<uint8_t*>(rowHeader + sizeof(int32_t) + columnMaskLength);
+
+    const size_t lengthPrefixPosition = io.reserveBytes(rowHeaderSz);
+
+    tuple.serializeColumnsToDR(io, columns, includeHiddenColumns, nullArray);
+
+    ExportSerializeOutput hdr(m_currBlock->mutableDataPtr() + lengthPrefixPosition, sizeof(int32_t));
+    hdr.writeInt((int32_t)(io.position() - startPos - sizeof(int32_t)));
+}
+
 size_t DRTupleStream::computeOffsets(DRRecordType &type,
         TableTuple &tuple,
         size_t &rowHeaderSz,
@@ -424,10 +547,11 @@ void DRTupleStream::beginTransaction(int64_t sequenceNumber, int64_t spHandle, i
      }
 
      m_currBlock->startDRSequenceNumber(sequenceNumber);
+     m_currBlock->startDRTimestamp(UniqueId::timestampSinceUnixEpoch(uniqueId) / 1000);
 
      ExportSerializeOutput io(m_currBlock->mutableDataPtr(),
                               m_currBlock->remaining());
-     io.writeByte(static_cast<uint8_t>(PROTOCOL_VERSION));
+     io.writeByte(m_protocolVersion);
      io.writeByte(static_cast<int8_t>(DR_RECORD_BEGIN_TXN));
      io.writeLong(uniqueId);
      io.writeLong(sequenceNumber);
@@ -606,6 +730,7 @@ void DRTupleStream::generateDREvent(DREventType type, int64_t lastCommittedSpHan
         m_uso += io.position();
 
         m_currBlock->startDRSequenceNumber(m_openSequenceNumber);
+        m_currBlock->startDRTimestamp(UniqueId::timestampSinceUnixEpoch(uniqueId) / 1000);
         m_currBlock->recordCompletedSequenceNumForDR(m_openSequenceNumber);
         if (UniqueId::isMpUniqueId(uniqueId)) {
             m_lastCommittedMpUniqueId = uniqueId;
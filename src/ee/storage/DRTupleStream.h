@@ -38,7 +38,11 @@ public:
     static const size_t HASH_DELIMITER_SIZE = 1 + 4;
 
     // Also update DRProducerProtocol.java if version changes
-    static const uint8_t PROTOCOL_VERSION = 6;
+    static const uint8_t PROTOCOL_VERSION = 7;
+    // Oldest version this stream writes, older ones go to CompatibleDRTupleStream
+    static const uint8_t COORDINATED_MP_PROTOCOL_VERSION = 6;
+    // First version with DR_RECORD_UPDATE_CHANGED_COLUMNS records
+    static const uint8_t CHANGED_COLUMNS_PROTOCOL_VERSION = 7;
 
     DRTupleStream(int partitionId, int defaultBufferSize);
 
@@ -68,6 +72,27 @@ public:
                        TableTuple &oldTuple,
                        TableTuple &newTuple);
 
+    virtual bool writesChangedColumnsUpdates() const {
+        return m_protocolVersion >= CHANGED_COLUMNS_PROTOCOL_VERSION;
+    }
+
+    /**
+     * write a DR_RECORD_UPDATE_CHANGED_COLUMNS record: the index crc(4), the old
+     * row's key in the unique index as a DR row, then a DR row of the columns
+     * whose values changed, led by a bitmap of those columns, and the hidden
+     * columns. A full update record is written instead when the key can not be
+     * taken straight from the row's columns or has a NULL in it.
+     * */
+    virtual size_t appendChangedColumnsUpdateRecord(int64_t lastCommittedSpHandle,
+                       char *tableHandle,
+                       int partitionColumn,
+                       int64_t spHandle,
+                       int64_t uniqueId,
+                       const TableIndex &uniqueIndex,
+                       uint32_t uniqueIndexCrc,
+                       TableTuple &oldTuple,
+                       TableTuple &newTuple);
+
     virtual size_t truncateTable(int64_t lastCommittedSpHandle,
                        char *tableHandle,
                        std::string tableName,
@@ -90,6 +115,11 @@ public:
     virtual void generateDREvent(DREventType type, int64_t lastCommittedSpHandle, int64_t spHandle,
                                  int64_t uniqueId, ByteArray catalogCommands);
 
+    /** The version written at the beginning of each transaction, between
+     *  COORDINATED_MP_PROTOCOL_VERSION and PROTOCOL_VERSION */
+    void setProtocolVersion(uint8_t version) { m_protocolVersion = version; }
+    uint8_t getProtocolVersion() const { return m_protocolVersion; }
+
     static int32_t getTestDRBuffer(int32_t partitionId,
                                    std::vector<int32_t> partitionKeyValueList,
                                    std::vector<int32_t> flagList,
@@ -104,6 +134,13 @@ private:
             size_t rowMetadataSz,
             ExportSerializeOutput &io);
 
+    /** write a DR row of the given columns, led by a column mask if columnMaskLength is non-zero */
+    void writeColumns(TableTuple& tuple,
+            const std::vector<int> &columns,
+            bool includeHiddenColumns,
+            size_t columnMaskLength,
+            ExportSerializeOutput &io);
+
     size_t computeOffsets(DRRecordType &type,
             TableTuple &tuple,
             size_t &rowHeaderSz,
@@ -132,6 +169,10 @@ private:
 
     int64_t m_lastCommittedSpUniqueId;
     int64_t m_lastCommittedMpUniqueId;
+
+    uint8_t m_protocolVersion;
+    // Scratch for the columns an update changed
+    std::vector<int> m_changedColumns;
 };
 
 class MockDRTupleStream : public DRTupleStream {
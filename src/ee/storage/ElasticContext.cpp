@@ -22,6 +22,7 @@
 #include "common/FixUnusedAssertHack.h"
 #include "expressions/hashrangeexpression.h"
 #include "logging/LogManager.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <cassert>
 #include <sstream>
 #include <limits>
@@ -36,6 +37,7 @@ ElasticContext::ElasticContext(PersistentTable &table,
     TableStreamerContext(table, surgeon, partitionId, predicateStrings),
     m_predicateStrings(predicateStrings), // retained for cloning here, not in TableStreamerContext.
     m_nTuplesPerCall(nTuplesPerCall),
+    m_maxMicrosPerCall(DEFAULT_MAX_MICROS_PER_CALL),
     m_indexActive(false)
 {
     if (predicateStrings.size() != 1) {
@@ -184,16 +186,24 @@ int64_t ElasticContext::handleStreamMore(TupleOutputStreamProcessor &outputStrea
 
     // Populate index with current tuples.
     // Table changes are tracked through notifications.
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
     size_t i = 0;
     TableTuple tuple(getTable().schema());
     while (m_scanner->next(tuple)) {
         if (getPredicates()[0].eval(&tuple).isTrue()) {
             m_surgeon.indexAdd(tuple);
         }
-        // Take a breather after every chunk of m_nTuplesPerCall tuples.
+        // Take a breather after every chunk of m_nTuplesPerCall tuples,
+        // or sooner once the call has used up its time.
         if (++i == m_nTuplesPerCall) {
             break;
         }
+        if (i % CLOCK_CHECK_TUPLES == 0) {
+            boost::posix_time::ptime now(boost::posix_time::microsec_clock::universal_time());
+            if ((now - startTime).total_microseconds() >= m_maxMicrosPerCall) {
+                break;
+            }
+        }
     }
 
     // Done with indexing?
@@ -117,6 +117,13 @@ private:
         m_nTuplesPerCall = nTuplesPerCall;
     }
 
+    /**
+     * Allow overriding how long each index creation call may run.
+     */
+    void setMaxMicrosPerCall(int64_t maxMicrosPerCall) {
+        m_maxMicrosPerCall = maxMicrosPerCall;
+    }
+
     /**
      * Scanner for retrieving rows.
      */
@@ -133,12 +140,23 @@ private:
      */
     size_t m_nTuplesPerCall;
 
+    /**
+     * The longest a handleStreamMore() call may spend indexing, in
+     * microseconds. The calls run on the site thread between transactions,
+     * so a chunk ends at this budget or at m_nTuplesPerCall tuples,
+     * whichever comes first; slow rows make for smaller chunks.
+     */
+    int64_t m_maxMicrosPerCall;
+
     /**
      * True when there's a valid index that hasn't been cleared yet.
      */
     bool m_indexActive;
 
     static const size_t DEFAULT_TUPLES_PER_CALL = 10000;
+    static const int64_t DEFAULT_MAX_MICROS_PER_CALL = 2000;
+    // Tuples indexed between looks at the clock.
+    static const size_t CLOCK_CHECK_TUPLES = 256;
 };
 
 } // namespace voltdb
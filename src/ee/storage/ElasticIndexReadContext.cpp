@@ -129,7 +129,8 @@ int64_t ElasticIndexReadContext::handleStreamMore(
                                getMaxTupleLength(),
                                getPartitionId(),
                                getPredicates(),
-                               getPredicateDeleteFlags());
+                               getPredicateDeleteFlags(),
+                               getPredicateRowFormats());
 
             // Set to true to break out of the loop after the tuples dry up
             // or the byte count threshold is hit.
@@ -227,17 +228,19 @@ bool ElasticIndexReadContext::parseHashRange(
  */
 void ElasticIndexReadContext::deleteStreamedTuples()
 {
-    // Delete the indexed tuples that were streamed.
-    // Undo token release will cause the index to delete the corresponding items
-    // via notifications.
+    // Delete the indexed tuples that were streamed, all in one batch.
+    // Deleting them removes the corresponding items from the elastic index
+    // via notifications, so they are gathered before any is deleted.
     DRTupleStreamDisableGuard guard(ExecutorContext::getExecutorContext());
+    std::vector<TableTuple> tuples;
     m_iter->reset();
     TableTuple tuple;
     while (m_iter->next(tuple)) {
         if (!tuple.isPendingDelete()) {
-            m_surgeon.deleteTuple(tuple);
+            tuples.push_back(tuple);
         }
     }
+    m_surgeon.deleteTupleBatch(tuples);
 }
 
 } // namespace voltdb
@@ -78,6 +78,12 @@ void ExportTupleStream::setSignatureAndGeneration(std::string signature, int64_t
     m_generation = generation;
 }
 
+void ExportTupleStream::setFilter(const std::vector<int> &columns, StreamPredicateList &predicates) {
+    m_columns = columns;
+    m_predicates.clear();
+    m_predicates.transfer(m_predicates.end(), predicates);
+}
+
 /*
  * If SpHandle represents a new transaction, commit previous data.
  * Always serialize the supplied tuple in to the stream.
@@ -146,7 +152,12 @@ size_t ExportTupleStream::appendTuple(int64_t lastCommittedSpHandle,
     io.writeByte(static_cast<int8_t>((type == INSERT) ? 1L : 0L));
 
     // write the tuple's data
-    tuple.serializeToExport(io, METADATA_COL_CNT, nullArray);
+    if (m_columns.empty()) {
+        tuple.serializeToExport(io, METADATA_COL_CNT, nullArray);
+    }
+    else {
+        tuple.serializeColumnsToExport(io, METADATA_COL_CNT, m_columns, nullArray);
+    }
 
     // write the row size in to the row header
     // rowlength does not include the 4 byte row header
@@ -169,7 +180,8 @@ ExportTupleStream::computeOffsets(TableTuple &tuple,
                                    size_t *rowHeaderSz)
 {
     // round-up columncount to next multiple of 8 and divide by 8
-    int columnCount = tuple.sizeInValues() + METADATA_COL_CNT;
+    int columnCount = (m_columns.empty() ? tuple.sizeInValues() : static_cast<int>(m_columns.size())) +
+            METADATA_COL_CNT;
     int nullMaskLength = ((columnCount + 7) & -8) >> 3;
 
     // row header is 32-bit length of row plus null mask
@@ -179,7 +191,8 @@ ExportTupleStream::computeOffsets(TableTuple &tuple,
     size_t metadataSz = (sizeof (int64_t) * 5) + 1;
 
     // returns 0 if corrupt tuple detected
-    size_t dataSz = tuple.maxExportSerializationSize();
+    size_t dataSz = m_columns.empty() ? tuple.maxExportSerializationSize() :
+            tuple.maxExportSerializationSize(m_columns);
     if (dataSz == 0) {
         throwFatalException("Invalid tuple passed to computeTupleMaxLength. Crashing System.");
     }
@@ -20,8 +20,10 @@
 #include "common/ids.h"
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
+#include "common/StreamPredicateList.h"
 #include "storage/TupleStreamBase.h"
 #include <deque>
+#include <vector>
 #include <cassert>
 namespace voltdb {
 
@@ -63,6 +65,30 @@ public:
 
     void pushExportBuffer(StreamBlock *block, bool sync, bool endOfStream);
 
+    /**
+     * Limit the stream to the given columns, written in that order, and
+     * to the tuples at least one of the predicates accepts; callers check
+     * acceptsTuple before appending. An empty column list writes every
+     * column and an empty predicate list accepts every tuple, as does a
+     * NULL predicate. The stream takes the predicates, leaving the list
+     * empty.
+     */
+    void setFilter(const std::vector<int> &columns, StreamPredicateList &predicates);
+
+    /** Whether the tuple is wanted by any consumer of the stream. */
+    bool acceptsTuple(const TableTuple &tuple) const {
+        if (m_predicates.empty()) {
+            return true;
+        }
+        for (StreamPredicateList::const_iterator iter = m_predicates.begin();
+             iter != m_predicates.end(); ++iter) {
+            if (boost::is_null(iter) || iter->eval(&tuple, NULL).isTrue()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /** write a tuple to the stream */
     virtual size_t appendTuple(int64_t lastCommittedSpHandle,
                        int64_t spHandle,
@@ -82,6 +108,11 @@ public:
 
     std::string m_signature;
     int64_t m_generation;
+
+private:
+    // The columns written, or empty for all of them.
+    std::vector<int> m_columns;
+    StreamPredicateList m_predicates;
 };
 
 }
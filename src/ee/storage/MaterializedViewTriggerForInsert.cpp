@@ -23,8 +23,11 @@
 #include "catalog/columnref.h"
 #include "catalog/table.h"
 #include "expressions/expressionutil.h"
+#include "hyperloglog/hyperloglog.hpp"
 #include "indexes/tableindex.h"
 
+#include <algorithm>
+
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Statement);
 typedef std::pair<std::string, catalog::Statement*> LabeledStatement;
 
@@ -106,6 +109,86 @@ void MaterializedViewTriggerForInsert::processTupleInsert(const TableTuple &newT
         return;
     }
     bool exists = findExistingTuple(newTuple);
+    beginGroupRow(exists);
+    addToGroupRow(newTuple, exists);
+    writeGroupRow(exists, fallible);
+}
+
+namespace {
+// Orders the rows of a batch by their group-by values, which are kept
+// back to back, columnCount values per row.
+struct GroupByLess {
+    GroupByLess(const std::vector<NValue> &keys, size_t columnCount)
+        : m_keys(keys), m_columnCount(columnCount)
+    { }
+
+    bool operator()(size_t lhs, size_t rhs) const {
+        return compare(lhs, rhs) < 0;
+    }
+
+    int compare(size_t lhs, size_t rhs) const {
+        for (size_t colindex = 0; colindex < m_columnCount; colindex++) {
+            int comparison = m_keys[lhs * m_columnCount + colindex].compare(
+                    m_keys[rhs * m_columnCount + colindex]);
+            if (comparison != 0) {
+                return comparison;
+            }
+        }
+        return 0;
+    }
+
+    const std::vector<NValue> &m_keys;
+    size_t m_columnCount;
+};
+}
+
+void MaterializedViewTriggerForInsert::processTupleInsertBatch(const std::vector<TableTuple> &newTuples,
+                                                               bool fallible) {
+    if (newTuples.size() == 1) {
+        processTupleInsert(newTuples[0], fallible);
+        return;
+    }
+
+    std::vector<size_t> rows;
+    rows.reserve(newTuples.size());
+    for (size_t ii = 0; ii < newTuples.size(); ii++) {
+        if ( ! failsPredicate(newTuples[ii])) {
+            rows.push_back(ii);
+        }
+    }
+    if (rows.empty()) {
+        return;
+    }
+
+    // Bring the rows of each group together. The sort is stable so each
+    // group's rows are folded in in the order they were inserted, and the
+    // view ends up exactly as it would have one row at a time.
+    std::vector<NValue> keys(newTuples.size() * m_groupByColumnCount);
+    BOOST_FOREACH(size_t row, rows) {
+        for (int colindex = 0; colindex < m_groupByColumnCount; colindex++) {
+            keys[row * m_groupByColumnCount + colindex] =
+                getGroupByValueFromSrcTuple(colindex, newTuples[row]);
+        }
+    }
+    GroupByLess groupByLess(keys, m_groupByColumnCount);
+    std::stable_sort(rows.begin(), rows.end(), groupByLess);
+
+    // Each group's view row is looked up and written once for the batch.
+    size_t first = 0;
+    while (first < rows.size()) {
+        bool exists = findExistingTuple(newTuples[rows[first]]);
+        beginGroupRow(exists);
+        size_t next = first;
+        do {
+            addToGroupRow(newTuples[rows[next]], exists || next != first);
+            ++next;
+        } while (next < rows.size() && groupByLess.compare(rows[first], rows[next]) == 0);
+        writeGroupRow(exists, fallible);
+        first = next;
+    }
+}
+
+void MaterializedViewTriggerForInsert::beginGroupRow(bool exists) {
     if (!exists) {
         // create a blank tuple
         VOLT_TRACE("newTuple does not exist,create a blank tuple");
@@ -125,16 +208,24 @@ void MaterializedViewTriggerForInsert::processTupleInsert(const TableTuple &newT
         m_updatedTuple.setNValue(colindex, value);
     }
 
-    int aggOffset = (int)m_groupByColumnCount + 1;
-    // set values for the other columns
-    // update or insert the row
     if (exists) {
+        // start from the existing count(*) and aggregates
+        int aggOffset = (int)m_groupByColumnCount + 1;
+        for (int colindex = (int)m_groupByColumnCount; colindex < aggOffset + m_aggColumnCount; colindex++) {
+            m_updatedTuple.setNValue(colindex, m_existingTuple.getNValue(colindex));
+        }
+    }
+}
+
+void MaterializedViewTriggerForInsert::addToGroupRow(const TableTuple &newTuple, bool hasValues) {
+    int aggOffset = (int)m_groupByColumnCount + 1;
+    if (hasValues) {
         // increment the next column, which is a count(*)
         m_updatedTuple.setNValue((int)m_groupByColumnCount,
-                                 m_existingTuple.getNValue((int)m_groupByColumnCount).op_increment());
+                                 m_updatedTuple.getNValue((int)m_groupByColumnCount).op_increment());
 
         for (int aggIndex = 0; aggIndex < m_aggColumnCount; aggIndex++) {
-            NValue existingValue = m_existingTuple.getNValue(aggOffset+aggIndex);
+            NValue existingValue = m_updatedTuple.getNValue(aggOffset+aggIndex);
             NValue newValue = getAggInputFromSrcTuple(aggIndex, newTuple);
             if (newValue.isNull()) {
                 newValue = existingValue;
@@ -161,6 +252,16 @@ void MaterializedViewTriggerForInsert::processTupleInsert(const TableTuple &newT
                         newValue = existingValue;
                     }
                     break;
+                case EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT: {
+                    // A sketch that is not the view row's is a copy made for
+                    // this batch, which further rows can raise in place.
+                    NValue rowValue = m_existingTuple.getNValue(aggOffset+aggIndex);
+                    bool ownsSketch = !existingValue.isNull() &&
+                        (rowValue.isNull() ||
+                         ValuePeeker::peekObjectValue(rowValue) != ValuePeeker::peekObjectValue(existingValue));
+                    newValue = addToSketch(existingValue, newValue, ownsSketch);
+                    break;
+                }
                 default:
                     assert(false); // Should have been caught when the matview was loaded.
                     // no break
@@ -168,11 +269,6 @@ void MaterializedViewTriggerForInsert::processTupleInsert(const TableTuple &newT
             }
             m_updatedTuple.setNValue(aggOffset+aggIndex, newValue);
         }
-
-        // Shouldn't need to update group-key-only indexes such as the primary key
-        // since their keys shouldn't ever change, but do update other indexes.
-        m_target->updateTupleWithSpecificIndexes(m_existingTuple, m_updatedTuple,
-                                                 m_updatableIndexList, fallible);
     }
     else {
         // set the next column, which is a count(*), to 1
@@ -191,8 +287,81 @@ void MaterializedViewTriggerForInsert::processTupleInsert(const TableTuple &newT
                     newValue = ValueFactory::getBigIntValue(1);
                 }
             }
+            else if (m_aggTypes[aggIndex] == EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT &&
+                     ! newValue.isNull()) {
+                newValue = addToSketch(NValue::getNullValue(VALUE_TYPE_VARBINARY), newValue, false);
+            }
             m_updatedTuple.setNValue(aggOffset+aggIndex, newValue);
         }
+    }
+}
+
+static void findSketchRegister(const NValue &value, uint32_t &index, uint8_t &rank) {
+    // Hashed as APPROX_COUNT_DISTINCT hashes them, so stored sketches
+    // merge with the ones queries build.
+    int32_t valueLength = 0;
+    const char* data = ValuePeeker::peekPointerToDataBytes(value, &valueLength);
+    hll::HyperLogLog::registerAndRank(MaterializedViewTriggerForInsert::SKETCH_BIT_WIDTH,
+                                      data, static_cast<uint32_t>(valueLength), index, rank);
+}
+
+static const char* sketchRegisters(const NValue &sketch) {
+    int32_t length = 0;
+    const char* bytes = ValuePeeker::peekObject_withoutNull(sketch, &length);
+    if (length != MaterializedViewTriggerForInsert::SKETCH_LENGTH ||
+            bytes[0] != MaterializedViewTriggerForInsert::SKETCH_BIT_WIDTH) {
+        throwFatalException("Materialized view APPROX_COUNT_DISTINCT sketch of %d bytes is not"
+                            " a HyperLogLog of bit width %d", (int)length,
+                            (int)MaterializedViewTriggerForInsert::SKETCH_BIT_WIDTH);
+    }
+    return bytes + 1;
+}
+
+NValue MaterializedViewTriggerForInsert::addToSketch(const NValue &sketch, const NValue &value,
+                                                     bool ownsSketch) {
+    uint32_t index;
+    uint8_t rank;
+    findSketchRegister(value, index, rank);
+    const char* registers = NULL;
+    if ( ! sketch.isNull()) {
+        registers = sketchRegisters(sketch);
+        if (rank <= static_cast<uint8_t>(registers[index])) {
+            // The same sketch, so the view row keeps its copy.
+            return sketch;
+        }
+        if (ownsSketch) {
+            const_cast<char*>(registers)[index] = static_cast<char>(rank);
+            return sketch;
+        }
+    }
+    NValue result = ValueFactory::getUninitializedTempBinaryValue(SKETCH_LENGTH);
+    char* bytes = const_cast<char*>(ValuePeeker::peekObjectValue(result));
+    if (registers) {
+        ::memcpy(bytes, registers - 1, SKETCH_LENGTH);
+    }
+    else {
+        ::memset(bytes, 0, SKETCH_LENGTH);
+        bytes[0] = SKETCH_BIT_WIDTH;
+    }
+    bytes[1 + index] = static_cast<char>(rank);
+    return result;
+}
+
+bool MaterializedViewTriggerForInsert::sketchDependsOn(const NValue &sketch, const NValue &value) {
+    uint32_t index;
+    uint8_t rank;
+    findSketchRegister(value, index, rank);
+    return rank >= static_cast<uint8_t>(sketchRegisters(sketch)[index]);
+}
+
+void MaterializedViewTriggerForInsert::writeGroupRow(bool exists, bool fallible) {
+    if (exists) {
+        // Shouldn't need to update group-key-only indexes such as the primary key
+        // since their keys shouldn't ever change, but do update other indexes.
+        m_target->updateTupleWithSpecificIndexes(m_existingTuple, m_updatedTuple,
+                                                 m_updatableIndexList, fallible);
+    }
+    else {
         m_target->insertPersistentTuple(m_updatedTuple, fallible);
     }
 }
@@ -306,6 +475,15 @@ std::size_t MaterializedViewTriggerForInsert::parseAggregation(catalog::Material
         case EXPRESSION_TYPE_AGGREGATE_MIN:
         case EXPRESSION_TYPE_AGGREGATE_MAX:
             break; // legal value
+        case EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT:
+            if (destCol->type() != VALUE_TYPE_VARBINARY || destCol->size() < SKETCH_LENGTH) {
+                char message[128];
+                snprintf(message, 128, "Materialized view aggregation %d must be a VARBINARY(%d)"
+                         " to hold an APPROX_COUNT_DISTINCT sketch", (int)aggIndex, SKETCH_LENGTH);
+                throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                              message);
+            }
+            break;
         default: {
             char message[128];
             snprintf(message, 128, "Error in materialized view aggregation %d expression type %s",
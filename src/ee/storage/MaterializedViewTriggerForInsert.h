@@ -51,6 +51,11 @@ class TableIndex;
  */
 class MaterializedViewTriggerForInsert {
 public:
+    // The width and dumped length of the APPROX_COUNT_DISTINCT sketches in
+    // view rows, as queries use for HYPERLOGLOGS_TO_CARD.
+    static const uint8_t SKETCH_BIT_WIDTH = 16;
+    static const int32_t SKETCH_LENGTH = 1 + (1 << SKETCH_BIT_WIDTH);
+
     virtual ~MaterializedViewTriggerForInsert();
     /**
      * Called when the source table is inserting a tuple. This will update the materialized view
@@ -58,6 +63,12 @@ public:
      */
     void processTupleInsert(const TableTuple &newTuple, bool fallible);
 
+    /**
+     * Called when the source table has inserted a batch of tuples. The view row of
+     * each group is found and written once for the whole batch.
+     */
+    void processTupleInsertBatch(const std::vector<TableTuple> &newTuples, bool fallible);
+
     PersistentTable * targetTable() const { return m_target; }
 
     catalog::MaterializedViewInfo* getMaterializedViewInfo() const {
@@ -126,6 +137,26 @@ protected:
      */
     bool findExistingTuple(const TableTuple &oldTuple);
 
+    /**
+     * Build the view row of a group in m_updatedTuple: start it from the row
+     * found by findExistingTuple, or from the group-by values of a new group,
+     * fold in source rows, then update or insert it.
+     */
+    void beginGroupRow(bool exists);
+    void addToGroupRow(const TableTuple &newTuple, bool hasValues);
+    void writeGroupRow(bool exists, bool fallible);
+
+    /**
+     * An APPROX_COUNT_DISTINCT column holds a dumped hll::HyperLogLog, or
+     * NULL before the group has any non-NULL value. addToSketch returns the
+     * sketch with value added, the same NValue if no register went up or
+     * if the caller owns the sketch, so it can be raised in place.
+     * sketchDependsOn says whether value may be all that holds up its
+     * register, so taking it away needs the sketch rebuilt.
+     */
+    static NValue addToSketch(const NValue &sketch, const NValue &value, bool ownsSketch);
+    static bool sketchDependsOn(const NValue &sketch, const NValue &value);
+
     // the materialized view table
     PersistentTable *m_target;
 
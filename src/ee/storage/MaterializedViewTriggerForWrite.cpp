@@ -23,9 +23,12 @@
 #include "catalog/statement.h"
 #include "execution/ExecutorVector.h"
 #include "executors/abstractexecutor.h"
+#include "hyperloglog/hyperloglog.hpp"
 #include "indexes/tableindex.h"
 #include "plannodes/indexscannode.h"
 
+#include <sstream>
+
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Statement);
 typedef std::pair<std::string, catalog::Statement*> LabeledStatement;
 
@@ -38,6 +41,7 @@ MaterializedViewTriggerForWrite::MaterializedViewTriggerForWrite(PersistentTable
     : MaterializedViewTriggerForInsert(destTable, mvInfo)
     , m_srcPersistentTable(srcTable)
     , m_minMaxSearchKeyBackingStoreSize(0)
+    , m_hasMinMaxTrackers(false)
 {
     // set up mechanisms for min/max recalculation
     setupMinMaxRecalculation(mvInfo->indexForMinMax(), mvInfo->fallbackQueryStmts());
@@ -60,8 +64,9 @@ MaterializedViewTriggerForWrite::MaterializedViewTriggerForWrite(PersistentTable
         if ( ! srcTable->isPersistentTableEmpty()) {
             TableTuple scannedTuple(srcTable->schema());
             TableIterator &iterator = srcTable->iterator();
+            // The trackers were filled from the source table already.
             while (iterator.next(scannedTuple)) {
-                processTupleInsert(scannedTuple, false);
+                MaterializedViewTriggerForInsert::processTupleInsert(scannedTuple, false);
             }
         }
     }
@@ -79,6 +84,11 @@ void MaterializedViewTriggerForWrite::build(PersistentTable *srcTable,
 
 MaterializedViewTriggerForWrite::~MaterializedViewTriggerForWrite() { }
 
+// See if the index is just built on group by columns or it also includes min/max agg (ENG-6511)
+static bool minMaxIndexIncludesAggCol(TableIndex * index, size_t groupByColumnCount) {
+    return index && index->getColumnIndices().size() > groupByColumnCount;
+}
+
 void MaterializedViewTriggerForWrite::setupMinMaxRecalculation(const catalog::CatalogMap<catalog::IndexRef> &indexForMinOrMax,
                                                                const catalog::CatalogMap<catalog::Statement> &fallbackQueryStmts) {
     std::vector<TableIndex*> candidates = m_srcPersistentTable->allIndexes();
@@ -161,11 +171,156 @@ void MaterializedViewTriggerForWrite::setupMinMaxRecalculation(const catalog::Ca
 #endif
         ++ idx;
     }
+    setupMinMaxTrackers();
 }
 
-// See if the index is just built on group by columns or it also includes min/max agg (ENG-6511)
-static bool minMaxIndexIncludesAggCol(TableIndex * index, size_t groupByColumnCount) {
-    return index && index->getColumnIndices().size() > groupByColumnCount;
+/*
+ * Track the values of each MIN or MAX column that would otherwise need a
+ * scan to find its next value, which is any without an index that
+ * includes it, as long as all of its key is fixed width.
+ */
+void MaterializedViewTriggerForWrite::setupMinMaxTrackers() {
+    m_minMaxTrackers.clear();
+    m_hasMinMaxTrackers = false;
+    const TupleSchema *viewSchema = m_target->schema();
+    bool fixedWidthGroupBy = true;
+    for (int colindex = 0; colindex < m_groupByColumnCount; colindex++) {
+        if (isVariableLengthType(viewSchema->columnType(colindex))) {
+            fixedWidthGroupBy = false;
+        }
+    }
+    int aggOffset = (int)m_groupByColumnCount + 1;
+    for (int aggIndex = 0; aggIndex < m_aggColumnCount; aggIndex++) {
+        if (m_aggTypes[aggIndex] != EXPRESSION_TYPE_AGGREGATE_MIN &&
+            m_aggTypes[aggIndex] != EXPRESSION_TYPE_AGGREGATE_MAX) {
+            continue;
+        }
+        size_t minMaxAggIdx = m_minMaxTrackers.size();
+        TableIndex *index = minMaxAggIdx < m_indexForMinMax.size() ? m_indexForMinMax[minMaxAggIdx] : NULL;
+        boost::shared_ptr<ViewMinMaxTracker> tracker;
+        if (fixedWidthGroupBy &&
+            ! isVariableLengthType(viewSchema->columnType(aggOffset + aggIndex)) &&
+            ! minMaxIndexIncludesAggCol(index, m_groupByColumnCount)) {
+            tracker.reset(new ViewMinMaxTracker(m_groupByColumnCount,
+                                                m_aggTypes[aggIndex] == EXPRESSION_TYPE_AGGREGATE_MAX));
+            m_hasMinMaxTrackers = true;
+        }
+        m_minMaxTrackers.push_back(tracker);
+    }
+    if ( ! m_hasMinMaxTrackers || m_srcPersistentTable->isPersistentTableEmpty()) {
+        return;
+    }
+    TableTuple scannedTuple(m_srcPersistentTable->schema());
+    TableIterator &iterator = m_srcPersistentTable->iterator();
+    while (iterator.next(scannedTuple)) {
+        if ( ! failsPredicate(scannedTuple)) {
+            trackMinMaxChange(scannedTuple, true, false);
+        }
+    }
+}
+
+void MaterializedViewTriggerForWrite::getGroupByKey(const TableTuple &tuple, ViewMinMaxTracker::Key &key) {
+    key.clear();
+    for (int colindex = 0; colindex < m_groupByColumnCount; colindex++) {
+        key.push_back(getGroupByValueFromSrcTuple(colindex, tuple));
+    }
+}
+
+void MaterializedViewTriggerForWrite::trackMinMaxChange(const TableTuple &tuple, bool added, bool fallible) {
+    ViewMinMaxTracker::Key key;
+    getGroupByKey(tuple, key);
+    UndoQuantum *uq = fallible ? ExecutorContext::currentUndoQuantum() : NULL;
+    int minMaxAggIdx = 0;
+    for (int aggIndex = 0; aggIndex < m_aggColumnCount; aggIndex++) {
+        if (m_aggTypes[aggIndex] != EXPRESSION_TYPE_AGGREGATE_MIN &&
+            m_aggTypes[aggIndex] != EXPRESSION_TYPE_AGGREGATE_MAX) {
+            continue;
+        }
+        boost::shared_ptr<ViewMinMaxTracker> &tracker = m_minMaxTrackers[minMaxAggIdx++];
+        if ( ! tracker) {
+            continue;
+        }
+        NValue value = getAggInputFromSrcTuple(aggIndex, tuple);
+        if (value.isNull()) {
+            continue;
+        }
+        key.push_back(value);
+        if (added) {
+            tracker->add(key);
+        }
+        else {
+            tracker->remove(key);
+        }
+        if (uq) {
+            uq->registerUndoAction(new (*uq) ViewMinMaxTrackerUndoAction(tracker, key, added));
+        }
+        key.pop_back();
+    }
+}
+
+NValue MaterializedViewTriggerForWrite::rebuildSketchSequential(int aggIndex) {
+    AbstractExpression *aggExpr = NULL;
+    int srcColIdx = -1;
+    if (m_aggExprs.size() != 0) {
+        aggExpr = m_aggExprs[aggIndex];
+    } else {
+        srcColIdx = m_aggColIndexes[aggIndex];
+    }
+    hll::HyperLogLog sketch(SKETCH_BIT_WIDTH);
+    bool empty = true;
+    // loop through the group's tuples, which no longer include the one being deleted
+    TableTuple tuple(m_srcPersistentTable->schema());
+    TableIterator &iterator = m_srcPersistentTable->iterator();
+    while (iterator.next(tuple)) {
+        if (failsPredicate(tuple)) {
+            continue;
+        }
+        int comparison = 0;
+        for (int idx = 0; idx < m_groupByColumnCount; idx++) {
+            NValue foundKey = getGroupByValueFromSrcTuple(idx, tuple);
+            comparison = m_searchKeyValue[idx].compare(foundKey);
+            if (comparison != 0) {
+                break;
+            }
+        }
+        if (comparison != 0) {
+            continue;
+        }
+        NValue current = (aggExpr) ? aggExpr->eval(&tuple, NULL) : tuple.getNValue(srcColIdx);
+        if (current.isNull()) {
+            continue;
+        }
+        int32_t valueLength = 0;
+        const char* data = ValuePeeker::peekPointerToDataBytes(current, &valueLength);
+        sketch.add(data, static_cast<uint32_t>(valueLength));
+        empty = false;
+    }
+    if (empty) {
+        return NValue::getNullValue(VALUE_TYPE_VARBINARY);
+    }
+    std::ostringstream oss;
+    sketch.dump(oss);
+    return ValueFactory::getTempBinaryValue(oss.str().c_str(),
+                                            static_cast<int32_t>(oss.str().length()));
+}
+
+void MaterializedViewTriggerForWrite::processTupleInsert(const TableTuple &newTuple, bool fallible) {
+    MaterializedViewTriggerForInsert::processTupleInsert(newTuple, fallible);
+    if (m_hasMinMaxTrackers && ! failsPredicate(newTuple)) {
+        trackMinMaxChange(newTuple, true, fallible);
+    }
+}
+
+void MaterializedViewTriggerForWrite::processTupleInsertBatch(const std::vector<TableTuple> &newTuples,
+                                                              bool fallible) {
+    MaterializedViewTriggerForInsert::processTupleInsertBatch(newTuples, fallible);
+    if (m_hasMinMaxTrackers) {
+        BOOST_FOREACH(const TableTuple &newTuple, newTuples) {
+            if ( ! failsPredicate(newTuple)) {
+                trackMinMaxChange(newTuple, true, fallible);
+            }
+        }
+    }
 }
 
 void MaterializedViewTriggerForWrite::allocateMinMaxSearchKeyTuple() {
@@ -397,6 +552,10 @@ void MaterializedViewTriggerForWrite::processTupleDelete(const TableTuple &oldTu
                             " expected to find it but didn't", name.c_str());
     }
 
+    if (m_hasMinMaxTrackers) {
+        trackMinMaxChange(oldTuple, false, fallible);
+    }
+
     // clear the tuple that will be built to insert or overwrite
     memset(m_updatedTuple.address(), 0, m_target->getTupleLength());
 
@@ -459,7 +618,12 @@ void MaterializedViewTriggerForWrite::processTupleDelete(const TableTuple &oldTu
                 if (oldValue.compare(existingValue) == 0) {
                     // re-calculate MIN / MAX
                     newValue = NValue::getNullValue(m_target->schema()->columnType(aggOffset+aggIndex));
-                    if (m_usePlanForAgg[minMaxAggIdx] && allowUsingPlanForMinMax) {
+                    if (m_minMaxTrackers[minMaxAggIdx]) {
+                        ViewMinMaxTracker::Key groupKey;
+                        getGroupByKey(oldTuple, groupKey);
+                        m_minMaxTrackers[minMaxAggIdx]->best(groupKey, newValue);
+                    }
+                    else if (m_usePlanForAgg[minMaxAggIdx] && allowUsingPlanForMinMax) {
                         newValue = findFallbackValueUsingPlan(oldTuple, newValue, aggIndex, minMaxAggIdx);
                     }
                     // indexscan if an index is available, otherwise tablescan
@@ -475,6 +639,13 @@ void MaterializedViewTriggerForWrite::processTupleDelete(const TableTuple &oldTu
                     }
                 }
                 break;
+            case EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT:
+                // Registers only go up, so a sketch is rebuilt from the group's
+                // other rows only when the old value may have set a register.
+                if (sketchDependsOn(existingValue, oldValue)) {
+                    newValue = rebuildSketchSequential(aggIndex);
+                }
+                break;
             default:
                 assert(false); // Should have been caught when the matview was loaded.
                 // no break
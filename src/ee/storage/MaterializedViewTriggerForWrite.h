@@ -19,6 +19,7 @@
 #define MATERIALIZEDVIEWTRIGGERFORWRITE_H_
 
 #include "MaterializedViewTriggerForInsert.h"
+#include "ViewMinMaxTracker.h"
 
 namespace voltdb {
 
@@ -45,6 +46,13 @@ public:
      */
     void processTupleDelete(const TableTuple &oldTuple, bool fallible);
 
+    /**
+     * Hide the base class versions to also add the tuples to the MIN/MAX
+     * trackers.
+     */
+    void processTupleInsert(const TableTuple &newTuple, bool fallible);
+    void processTupleInsertBatch(const std::vector<TableTuple> &newTuples, bool fallible);
+
     void updateDefinition(PersistentTable *destTable,
                           catalog::MaterializedViewInfo *mvInfo) {
         MaterializedViewTriggerForInsert::updateDefinition(destTable, mvInfo);
@@ -63,6 +71,12 @@ private:
 
     void allocateMinMaxSearchKeyTuple();
 
+    void setupMinMaxTrackers();
+
+    void getGroupByKey(const TableTuple &tuple, ViewMinMaxTracker::Key &key);
+
+    void trackMinMaxChange(const TableTuple &tuple, bool added, bool fallible);
+
     NValue findMinMaxFallbackValueIndexed(const TableTuple& oldTuple,
                                           const NValue &existingValue,
                                           const NValue &initialNull,
@@ -76,6 +90,8 @@ private:
                                              int negate_for_min,
                                              int aggIndex);
 
+    NValue rebuildSketchSequential(int aggIndex);
+
     NValue findFallbackValueUsingPlan(const TableTuple& oldTuple,
                                       const NValue &initialNull,
                                       int aggIndex,
@@ -91,6 +107,10 @@ private:
     // Executor vectors to be executed when fallback on min/max value is needed (ENG-8641).
     std::vector<boost::shared_ptr<ExecutorVector> > m_fallbackExecutorVectors;
     std::vector<bool> m_usePlanForAgg;
+    // For each min or max column, a tracker of its values by group to use
+    // instead of searching for a fallback value, or NULL.
+    std::vector<boost::shared_ptr<ViewMinMaxTracker> > m_minMaxTrackers;
+    bool m_hasMinMaxTrackers;
 
 };
 
@@ -0,0 +1,65 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERSISTENTTABLEUNDODELETEBATCHACTION_H_
+#define PERSISTENTTABLEUNDODELETEBATCHACTION_H_
+
+#include "common/UndoAction.h"
+#include "common/types.h"
+#include "storage/persistenttable.h"
+
+namespace voltdb {
+
+/*
+ * Undoes the delete of a whole batch of tuples with one undo action.
+ * The tuples stay in place, pending delete on undo release, until then.
+ */
+class PersistentTableUndoDeleteBatchAction: public voltdb::UndoAction {
+public:
+    inline PersistentTableUndoDeleteBatchAction(char** deletedTuples,
+                                                int tupleCount,
+                                                voltdb::PersistentTableSurgeon *table)
+        : m_tuples(deletedTuples), m_tupleCount(tupleCount), m_table(table)
+    { }
+
+    virtual ~PersistentTableUndoDeleteBatchAction() { }
+
+    /*
+     * Undo whatever this undo action was created to undo,
+     * latest delete first as if each tuple had its own undo action.
+     */
+    virtual void undo() {
+        for (int ii = m_tupleCount - 1; ii >= 0; ii--) {
+            m_table->insertTupleForUndo(m_tuples[ii]);
+        }
+    }
+
+    /*
+     * Release any resources held by the undo action. It will not need
+     * to be undone in the future. In this case free the tuples' storage.
+     */
+    virtual void release() { m_table->deleteTupleBatchRelease(m_tuples, m_tupleCount); }
+
+private:
+    char** m_tuples;
+    const int m_tupleCount;
+    PersistentTableSurgeon *m_table;
+};
+
+}
+
+#endif /* PERSISTENTTABLEUNDODELETEBATCHACTION_H_ */
@@ -0,0 +1,56 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERSISTENTTABLEUNDOINPLACEUPDATEACTION_H_
+#define PERSISTENTTABLEUNDOINPLACEUPDATEACTION_H_
+
+#include "common/UndoAction.h"
+
+#include <cstring>
+#include <stdint.h>
+
+namespace voltdb {
+
+/*
+ * Undoes an update made in place by PersistentTable::updateTupleInPlace,
+ * which changed only fixed-width columns in no index, by copying back the
+ * old bytes that span them. Nothing else about the tuple changed.
+ */
+class PersistentTableUndoInPlaceUpdateAction: public UndoAction {
+public:
+    inline PersistentTableUndoInPlaceUpdateAction(char* target, char* oldBytes, uint32_t length)
+        : m_target(target), m_oldBytes(oldBytes), m_length(length)
+    { }
+
+    virtual ~PersistentTableUndoInPlaceUpdateAction() { }
+
+    virtual void undo() {
+        ::memcpy(m_target, m_oldBytes, m_length);
+    }
+
+    // The old bytes are in the undo quantum's pool.
+    virtual void release() { }
+
+private:
+    char* const m_target;
+    char* const m_oldBytes;
+    uint32_t const m_length;
+};
+
+}
+
+#endif /* PERSISTENTTABLEUNDOINPLACEUPDATEACTION_H_ */
@@ -0,0 +1,66 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERSISTENTTABLEUNDOINSERTBATCHACTION_H_
+#define PERSISTENTTABLEUNDOINSERTBATCHACTION_H_
+
+#include "common/UndoAction.h"
+#include "common/types.h"
+#include "storage/persistenttable.h"
+
+namespace voltdb {
+
+/*
+ * Undoes the insert of a whole batch of tuples with one undo action.
+ * The pooled copies of the tuples are laid out back to back.
+ */
+class PersistentTableUndoInsertBatchAction: public voltdb::UndoAction {
+public:
+    inline PersistentTableUndoInsertBatchAction(char* insertedTuples,
+                                                int tupleCount,
+                                                int tupleLength,
+                                                voltdb::PersistentTableSurgeon *table)
+        : m_tuples(insertedTuples), m_tupleCount(tupleCount), m_tupleLength(tupleLength), m_table(table)
+    { }
+
+    virtual ~PersistentTableUndoInsertBatchAction() { }
+
+    /*
+     * Undo whatever this undo action was created to undo,
+     * latest insert first as if each tuple had its own undo action.
+     */
+    virtual void undo() {
+        for (int ii = m_tupleCount - 1; ii >= 0; ii--) {
+            m_table->deleteTupleForUndo(m_tuples + ii * m_tupleLength);
+        }
+    }
+
+    /*
+     * Release any resources held by the undo action. It will not need
+     * to be undone in the future.
+     */
+    void release() { }
+private:
+    char* m_tuples;
+    const int m_tupleCount;
+    const int m_tupleLength;
+    PersistentTableSurgeon *m_table;
+};
+
+}
+
+#endif /* PERSISTENTTABLEUNDOINSERTBATCHACTION_H_ */
@@ -63,12 +63,15 @@ bool RecoveryContext::nextMessage(ReferenceSerializeOutput *out) {
         out->writeByte(static_cast<int8_t>(RECOVERY_MSG_TYPE_COMPLETE));
         out->writeInt(m_tableId);
 //        out->writeTextString(m_table->m_Tuple);
+        // The recovering table builds its indexes on this message, so it
+        // is laid out as RecoveryProtoMsg reads it, with no tuples.
+        out->writeInt(0);
         // last message gets the export stream counter
 //        long seqNo = 0; size_t offset = 0;
 //        m_table->getExportStreamSequenceNo(seqNo, offset);
 //        out->writeLong(seqNo);
 //        out->writeLong((long) offset);
-        //No tuple count added to message because completion message is only used in Java
+        out->writeLong(0);
         return false;
     }
     //Use allocated tuple count to size stuff at the other end
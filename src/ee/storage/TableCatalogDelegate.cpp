@@ -447,9 +447,24 @@ Table *TableCatalogDelegate::constructTableFromCatalog(catalog::Database const &
         persistentTable->addIndex(index);
     }
 
+    persistentTable->setAppendOnly(catalogTable.isAppendOnly());
+    persistentTable->setClustered(catalogTable.isClustered());
+    configureTimeToLive(catalogTable, persistentTable);
+
     return table;
 }
 
+void TableCatalogDelegate::configureTimeToLive(catalog::Table const &catalogTable,
+                                               PersistentTable *table)
+{
+    const catalog::Column *ttlColumn = catalogTable.ttlColumn();
+    if (ttlColumn == NULL) {
+        table->setTimeToLive(-1, 0, 0);
+        return;
+    }
+    table->setTimeToLive(ttlColumn->index(), catalogTable.ttlSeconds(), catalogTable.ttlBatchSize());
+}
+
 void TableCatalogDelegate::init(catalog::Database const &catalogDatabase,
         catalog::Table const &catalogTable)
 {
@@ -472,7 +487,7 @@ void TableCatalogDelegate::init(catalog::Database const &catalogDatabase,
 PersistentTable* TableCatalogDelegate::createDeltaTable(catalog::Database const &catalogDatabase,
         catalog::Table const &catalogTable)
 {
-    // Delta table will only have one row (currently).
+    // Delta table will only hold the rows of one insert batch at a time.
     // Set the table block size to 64KB to achieve better space efficiency.
     // FYI: maximum column count = 1024, largest fixed length data type is short varchars (64 bytes)
     Table *deltaTable = constructTableFromCatalog(catalogDatabase, catalogTable, 1024 * 64);
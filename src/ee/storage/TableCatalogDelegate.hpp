@@ -78,6 +78,10 @@ class TableCatalogDelegate {
     static TupleSchema *createTupleSchema(catalog::Database const &catalogDatabase,
                                           catalog::Table const &catalogTable);
 
+    /** Set the table's TTL from the catalog, or turn it off if the catalog has none. */
+    static void configureTimeToLive(catalog::Table const &catalogTable,
+                                    PersistentTable *table);
+
     static bool getIndexScheme(catalog::Table const &catalogTable,
                                catalog::Index const &catalogIndex,
                                const TupleSchema *schema,
@@ -30,6 +30,24 @@
 using namespace voltdb;
 using namespace std;
 
+namespace {
+    // The table stats columns, in order, after the base stats columns.
+    enum TableStatsColumn {
+        COLUMN_TABLE_NAME,
+        COLUMN_TABLE_TYPE,
+        COLUMN_TUPLE_COUNT,
+        COLUMN_TUPLE_ALLOCATED_MEMORY,
+        COLUMN_TUPLE_DATA_MEMORY,
+        COLUMN_STRING_DATA_MEMORY,
+        COLUMN_TUPLE_LIMIT,
+        COLUMN_PERCENT_FULL,
+        COLUMN_COMPACTED_TUPLE_COUNT,
+        COLUMN_COLD_TUPLE_MEMORY,
+        COLUMN_BLOCK_EVICTION_COUNT,
+        COLUMN_CHANGED_BLOCK_COUNT
+    };
+}
+
 vector<string> TableStats::generateTableStatsColumnNames() {
     vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
     columnNames.push_back("TABLE_NAME");
@@ -40,6 +58,10 @@ vector<string> TableStats::generateTableStatsColumnNames() {
     columnNames.push_back("STRING_DATA_MEMORY");
     columnNames.push_back("TUPLE_LIMIT");
     columnNames.push_back("PERCENT_FULL");
+    columnNames.push_back("COMPACTED_TUPLE_COUNT");
+    columnNames.push_back("COLD_TUPLE_MEMORY");
+    columnNames.push_back("BLOCK_EVICTION_COUNT");
+    columnNames.push_back("CHANGED_BLOCK_COUNT");
     return columnNames;
 }
 
@@ -59,6 +81,10 @@ void TableStats::populateTableStatsSchema(
     types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
     types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
     types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
 }
 
 TempTable* TableStats::generateEmptyTableStatsTable() {
@@ -86,7 +112,8 @@ TempTable* TableStats::generateEmptyTableStatsTable() {
 TableStats::TableStats(Table* table)
     : StatsSource(), m_table(table), m_lastTupleCount(0),
       m_lastAllocatedTupleMemory(0), m_lastOccupiedTupleMemory(0),
-      m_lastStringDataMemory(0)
+      m_lastStringDataMemory(0), m_lastCompactedTupleCount(0),
+      m_lastColdTupleMemory(0), m_lastBlockEvictionCount(0), m_firstColumn(0)
 {
 }
 
@@ -102,6 +129,8 @@ TableStats::TableStats(Table* table)
  */
 void TableStats::configure(string name) {
     StatsSource::configure(name);
+    // Looked up once, rather than by name for each column of each poll.
+    m_firstColumn = StatsSource::m_columnName2Index["TABLE_NAME"];
     m_tableName = ValueFactory::getStringValue(m_table->name());
     m_tableType = ValueFactory::getStringValue(m_table->tableType());
 }
@@ -119,17 +148,26 @@ vector<string> TableStats::generateStatsColumnNames() {
  * Update the stats tuple with the latest statistics available to this StatsSource.
  */
 void TableStats::updateStatsTuple(TableTuple *tuple) {
-    tuple->setNValue( StatsSource::m_columnName2Index["TABLE_NAME"], m_tableName);
-    tuple->setNValue( StatsSource::m_columnName2Index["TABLE_TYPE"], m_tableType);
+    tuple->setNValue(m_firstColumn + COLUMN_TABLE_NAME, m_tableName);
+    tuple->setNValue(m_firstColumn + COLUMN_TABLE_TYPE, m_tableType);
     int64_t tupleCount = m_table->activeTupleCount();
     int tupleLimit = m_table->tupleLimit();
     // This overflow is unlikely (requires 2 terabytes of allocated string memory)
     int64_t allocated_tuple_mem_kb = m_table->allocatedTupleMemory() / 1024;
     int64_t occupied_tuple_mem_kb = 0;
+    int64_t compactedTupleCount = 0;
+    int64_t coldTupleMemory = 0;
+    int64_t blockEvictionCount = 0;
+    int64_t changedBlockCount = 0;
     PersistentTable* persistentTable = dynamic_cast<PersistentTable*>(m_table);
     if (persistentTable) {
         occupied_tuple_mem_kb = persistentTable->occupiedTupleMemory() / 1024;
+        compactedTupleCount = persistentTable->compactedTupleCount();
+        coldTupleMemory = persistentTable->coldTupleMemory();
+        blockEvictionCount = persistentTable->blockEvictionCount();
+        changedBlockCount = persistentTable->changedBlockCount();
     }
+    int64_t cold_tuple_mem_kb = coldTupleMemory / 1024;
     int64_t string_data_mem_kb = m_table->nonInlinedMemorySize() / 1024;
 
     if (interval()) {
@@ -146,26 +184,43 @@ void TableStats::updateStatsTuple(TableTuple *tuple) {
         string_data_mem_kb =
             string_data_mem_kb - (m_lastStringDataMemory / 1024);
         m_lastStringDataMemory = m_table->nonInlinedMemorySize();
+        int64_t totalCompactedTupleCount = compactedTupleCount;
+        compactedTupleCount = compactedTupleCount - m_lastCompactedTupleCount;
+        m_lastCompactedTupleCount = totalCompactedTupleCount;
+        cold_tuple_mem_kb = cold_tuple_mem_kb - (m_lastColdTupleMemory / 1024);
+        m_lastColdTupleMemory = coldTupleMemory;
+        int64_t totalBlockEvictionCount = blockEvictionCount;
+        blockEvictionCount = blockEvictionCount - m_lastBlockEvictionCount;
+        m_lastBlockEvictionCount = totalBlockEvictionCount;
     }
 
     tuple->setNValue(
-            StatsSource::m_columnName2Index["TUPLE_COUNT"],
+            m_firstColumn + COLUMN_TUPLE_COUNT,
             ValueFactory::getBigIntValue(tupleCount));
-    tuple->setNValue(StatsSource::m_columnName2Index["TUPLE_ALLOCATED_MEMORY"],
+    tuple->setNValue(m_firstColumn + COLUMN_TUPLE_ALLOCATED_MEMORY,
             ValueFactory::getBigIntValue(allocated_tuple_mem_kb));
-    tuple->setNValue(StatsSource::m_columnName2Index["TUPLE_DATA_MEMORY"],
+    tuple->setNValue(m_firstColumn + COLUMN_TUPLE_DATA_MEMORY,
             ValueFactory::getBigIntValue(occupied_tuple_mem_kb));
-    tuple->setNValue(StatsSource::m_columnName2Index["STRING_DATA_MEMORY"],
+    tuple->setNValue(m_firstColumn + COLUMN_STRING_DATA_MEMORY,
             ValueFactory::getBigIntValue(string_data_mem_kb));
 
     bool hasTupleLimit = tupleLimit == INT_MAX ? false : true;
-    tuple->setNValue(StatsSource::m_columnName2Index["TUPLE_LIMIT"],
+    tuple->setNValue(m_firstColumn + COLUMN_TUPLE_LIMIT,
             hasTupleLimit ? ValueFactory::getIntegerValue(tupleLimit): ValueFactory::getNullValue());
     int32_t percentage = 0;
     if (hasTupleLimit && tupleLimit > 0) {
         percentage = static_cast<int32_t> (ceil(static_cast<double>(tupleCount) * 100.0 / tupleLimit));
     }
-    tuple->setNValue(StatsSource::m_columnName2Index["PERCENT_FULL"],ValueFactory::getIntegerValue(percentage));
+    tuple->setNValue(m_firstColumn + COLUMN_PERCENT_FULL,ValueFactory::getIntegerValue(percentage));
+    tuple->setNValue(m_firstColumn + COLUMN_COMPACTED_TUPLE_COUNT,
+            ValueFactory::getBigIntValue(compactedTupleCount));
+    tuple->setNValue(m_firstColumn + COLUMN_COLD_TUPLE_MEMORY,
+            ValueFactory::getBigIntValue(cold_tuple_mem_kb));
+    tuple->setNValue(m_firstColumn + COLUMN_BLOCK_EVICTION_COUNT,
+            ValueFactory::getBigIntValue(blockEvictionCount));
+    // Counted since the last snapshot, not since the last interval.
+    tuple->setNValue(m_firstColumn + COLUMN_CHANGED_BLOCK_COUNT,
+            ValueFactory::getBigIntValue(changedBlockCount));
 }
 
 /**
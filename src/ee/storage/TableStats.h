@@ -99,6 +99,12 @@ private:
     int64_t m_lastAllocatedTupleMemory;
     int64_t m_lastOccupiedTupleMemory;
     int64_t m_lastStringDataMemory;
+    int64_t m_lastCompactedTupleCount;
+    int64_t m_lastColdTupleMemory;
+    int64_t m_lastBlockEvictionCount;
+
+    // The index of the TABLE_NAME column; the others follow it.
+    int m_firstColumn;
 };
 
 }
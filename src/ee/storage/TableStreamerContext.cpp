@@ -62,7 +62,8 @@ void TableStreamerContext::updatePredicates(const std::vector<std::string> &pred
     // Throws an exception to be handled by caller on errors.
     std::ostringstream errmsg;
     m_predicates.clear();
-    if (!m_predicates.parseStrings(predicateStrings, errmsg, m_predicateDeleteFlags)) {
+    m_predicateRowFormats.clear();
+    if (!m_predicates.parseStrings(predicateStrings, errmsg, m_predicateDeleteFlags, m_predicateRowFormats)) {
         const char* details = errmsg.str().c_str();
         throwFatalException("TableStreamerContext() failed to parse predicate strings: %s", details);
     }
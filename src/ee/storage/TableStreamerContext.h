@@ -184,6 +184,14 @@ protected:
         return m_predicateDeleteFlags;
     }
 
+    /**
+     * Predicate row formats accessor.
+     */
+    std::vector<TupleOutputStream::RowFormat> &getPredicateRowFormats()
+    {
+        return m_predicateRowFormats;
+    }
+
     PersistentTableSurgeon &m_surgeon;
 
     /**
@@ -203,6 +211,11 @@ private:
      */
     std::vector<bool> m_predicateDeleteFlags;
 
+    /**
+     * Per-predicate row formats of the output streams.
+     */
+    std::vector<TupleOutputStream::RowFormat> m_predicateRowFormats;
+
     /**
      * Maximum serialized length of a tuple
      */
@@ -0,0 +1,58 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/TempBlockCache.h"
+
+#include "common/ThreadLocalPool.h"
+
+namespace voltdb {
+
+TempBlockCache::TempBlockCache(std::size_t maxCachedBytes)
+  : m_maxCachedBytes(maxCachedBytes)
+  , m_cachedBytes(0)
+{ }
+
+TempBlockCache::~TempBlockCache() {
+    std::map<std::size_t, std::vector<char*> >::iterator freeBlocks;
+    for (freeBlocks = m_freeBlocks.begin(); freeBlocks != m_freeBlocks.end(); ++freeBlocks) {
+        for (std::size_t ii = 0; ii < freeBlocks->second.size(); ii++) {
+            ThreadLocalPool::freeLargeBlock(freeBlocks->second[ii], freeBlocks->first);
+        }
+    }
+}
+
+char* TempBlockCache::allocateBlock(std::size_t size) {
+    std::map<std::size_t, std::vector<char*> >::iterator freeBlocks = m_freeBlocks.find(size);
+    if (freeBlocks != m_freeBlocks.end() && !freeBlocks->second.empty()) {
+        char* block = freeBlocks->second.back();
+        freeBlocks->second.pop_back();
+        m_cachedBytes -= size;
+        return block;
+    }
+    return ThreadLocalPool::allocateLargeBlock(size);
+}
+
+void TempBlockCache::freeBlock(char *block, std::size_t size) {
+    if (m_cachedBytes + size > m_maxCachedBytes) {
+        ThreadLocalPool::freeLargeBlock(block, size);
+        return;
+    }
+    m_freeBlocks[size].push_back(block);
+    m_cachedBytes += size;
+}
+
+}
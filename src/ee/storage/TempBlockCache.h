@@ -0,0 +1,63 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEMPBLOCKCACHE_H_
+#define TEMPBLOCKCACHE_H_
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * A site's free temp table block storage. The temp tables of a fragment
+ * give their blocks back when the fragment is done with them, and the
+ * next fragment's temp tables take them again, so a site running the
+ * same procedures over and over keeps reusing the same memory instead of
+ * mapping, faulting in and unmapping it on every execution.
+ *
+ * At most maxCachedBytes of storage is kept; blocks given back beyond
+ * that are freed. The cached storage is not charged to any fragment's
+ * TempTableLimits, only the blocks temp tables hold are.
+ */
+class TempBlockCache {
+public:
+    static const std::size_t DEFAULT_MAX_CACHED_BYTES = 64 * 1024 * 1024;
+
+    TempBlockCache(std::size_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES);
+    ~TempBlockCache();
+
+    /** Storage for a block of size bytes, cached if there is any. */
+    char* allocateBlock(std::size_t size);
+
+    /** Give back storage from allocateBlock, to keep or to free. */
+    void freeBlock(char *block, std::size_t size);
+
+    /** Bytes of storage currently kept for reuse. */
+    std::size_t cachedBytes() const { return m_cachedBytes; }
+
+private:
+    const std::size_t m_maxCachedBytes;
+    std::size_t m_cachedBytes;
+    // Free storage, by block size.
+    std::map<std::size_t, std::vector<char*> > m_freeBlocks;
+};
+
+}
+
+#endif // TEMPBLOCKCACHE_H_
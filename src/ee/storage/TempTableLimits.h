@@ -18,10 +18,14 @@
 #ifndef _EE_STORAGE_TEMPTABLELIMITS_H_
 #define _EE_STORAGE_TEMPTABLELIMITS_H_
 
+#include <cstddef>
 #include <stdint.h>
 
 namespace voltdb {
 
+class TempBlockCache;
+class TempTableSpill;
+
 /**
  * Track the amount of memory used by temp tables in a plan fragment's executors.
  * Log or throw exceptions based on thresholds.
@@ -34,6 +38,8 @@ public:
         , m_logThreshold(logThreshold)
         , m_memoryLimit(memoryLimit)
         , m_logLatch(false)
+        , m_spill(NULL)
+        , m_blockCache(NULL)
     { }
 
     /**
@@ -47,6 +53,37 @@ public:
     int64_t getAllocated() const { return m_currMemoryInBytes; }
     int64_t getPeakMemoryInBytes() const { return m_peakMemoryInBytes; }
     void resetPeakMemory() { m_peakMemoryInBytes = m_currMemoryInBytes; }
+    int64_t getMemoryLimit() const { return m_memoryLimit; }
+
+    /**
+     * Let temp tables put the blocks that would take them over the memory
+     * limit in the site's spill file, rather than fail the query.
+     */
+    void setSpill(TempTableSpill* spill) { m_spill = spill; }
+
+    /** Whether going over the memory limit spills rather than throws. */
+    bool canSpill() const { return m_spill != NULL && m_memoryLimit > 0; }
+
+    /**
+     * The spill file to put a new block of the given size in, or NULL if
+     * the block still fits in memory.
+     */
+    TempTableSpill* spillFor(int bytes) const {
+        if (!canSpill() || m_currMemoryInBytes + bytes <= m_memoryLimit) {
+            return NULL;
+        }
+        return m_spill;
+    }
+
+    /**
+     * Let temp tables take their block storage from, and give it back to,
+     * the site's cache of free blocks. Blocks are still counted here only
+     * while a temp table holds them.
+     */
+    void setBlockCache(TempBlockCache* blockCache) { m_blockCache = blockCache; }
+
+    /** The site's free temp table block storage, or NULL. */
+    TempBlockCache* blockCache() const { return m_blockCache; }
 
 private:
     /// The current amount of memory used by temp tables for this plan fragment.
@@ -63,6 +100,10 @@ private:
     /// True if we have already generated a log message for
     /// exceeding the log threshold and not yet dropped below it.
     bool m_logLatch;
+    /// Where temp table blocks over the memory limit go, or NULL.
+    TempTableSpill* m_spill;
+    /// Where temp table block storage is recycled, or NULL.
+    TempBlockCache* m_blockCache;
 };
 
 } // namespace voltdb
@@ -0,0 +1,115 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/TempTableSpill.h"
+
+#include "common/FatalException.hpp"
+#include "logging/LogManager.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace voltdb {
+
+TempTableSpill::TempTableSpill(const std::string &directory)
+  : m_fd(-1)
+  , m_fileSize(0)
+  , m_pageSize(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)))
+  , m_spilledBytes(0)
+{
+    std::string path = directory + "/voltdb-temp-spill-XXXXXX";
+    std::vector<char> pathBuffer(path.begin(), path.end());
+    pathBuffer.push_back('\0');
+    m_fd = ::mkstemp(&pathBuffer[0]);
+    if (m_fd < 0) {
+        char msg[1024];
+        snprintf(msg, sizeof(msg), "Could not create a temp table spill file in %s: %s. "
+                 "Queries over the temp table memory limit will fail.", directory.c_str(), strerror(errno));
+        LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN, msg);
+        return;
+    }
+    // Spilled blocks never outlive the fragment that made them.
+    ::unlink(&pathBuffer[0]);
+}
+
+TempTableSpill::~TempTableSpill() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+char* TempTableSpill::allocateBlock(std::size_t size, off_t &offset) {
+    if (m_fd < 0) {
+        return NULL;
+    }
+    std::size_t slot = slotSize(size);
+    std::map<std::size_t, std::vector<off_t> >::iterator freeSlots = m_freeSlots.find(slot);
+    if (freeSlots != m_freeSlots.end() && !freeSlots->second.empty()) {
+        offset = freeSlots->second.back();
+        freeSlots->second.pop_back();
+    }
+    else {
+        offset = m_fileSize;
+        if (::ftruncate(m_fd, offset + slot) != 0) {
+            return NULL;
+        }
+        m_fileSize += slot;
+    }
+    void* mapped = ::mmap(NULL, slot, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, offset);
+    if (mapped == MAP_FAILED) {
+        m_freeSlots[slot].push_back(offset);
+        return NULL;
+    }
+    // Temp tables are read back front to back.
+    ::madvise(mapped, slot, MADV_SEQUENTIAL);
+    m_spilledBytes += slot;
+    return static_cast<char*>(mapped);
+}
+
+void TempTableSpill::writeBack(char *block, std::size_t size, off_t offset) {
+#ifdef LINUX
+    // Clean pages can be dropped without waiting on a later write.
+    ::sync_file_range(m_fd, offset, slotSize(size), SYNC_FILE_RANGE_WRITE);
+#else
+    ::msync(block, slotSize(size), MS_ASYNC);
+#endif
+}
+
+void TempTableSpill::freeBlock(char *block, std::size_t size, off_t offset) {
+    std::size_t slot = slotSize(size);
+    if (::munmap(block, slot) != 0) {
+        throwFatalException("Failed to unmap a spilled temp table block: %s", strerror(errno));
+    }
+#ifdef LINUX
+    // There is no need for its contents to ever reach the disk.
+    ::fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, slot);
+#endif
+    m_freeSlots[slot].push_back(offset);
+    m_spilledBytes -= slot;
+}
+
+std::size_t TempTableSpill::slotSize(std::size_t size) const {
+    // File offsets of mappings have to be page aligned.
+    return (size + m_pageSize - 1) / m_pageSize * m_pageSize;
+}
+
+}
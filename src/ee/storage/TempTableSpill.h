@@ -0,0 +1,76 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEMPTABLESPILL_H_
+#define TEMPTABLESPILL_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace voltdb {
+
+/**
+ * A site's scratch file for temp table blocks that do not fit under the
+ * fragment's TempTableLimits. A spilled block is a shared mapping of a
+ * slot of the file, so its tuples have addresses like any other and are
+ * written and read back through the page cache; once a block fills, its
+ * pages are written out so that the kernel can drop them. Temp tables,
+ * their iterators and the executors holding tuple addresses work the
+ * same whether a block spilled or not.
+ */
+class TempTableSpill {
+public:
+    /** Keep the scratch file in directory. */
+    TempTableSpill(const std::string &directory);
+    ~TempTableSpill();
+
+    /** Whether the scratch file could be created. */
+    bool isUsable() const { return m_fd >= 0; }
+
+    /**
+     * Map a slot of the file of at least size bytes, setting offset to
+     * where it starts. Returns NULL if the file cannot grow.
+     */
+    char* allocateBlock(std::size_t size, off_t &offset);
+
+    /** Start writing out a block that will take no more inserts. */
+    void writeBack(char *block, std::size_t size, off_t offset);
+
+    /** Unmap a block and give its slot back. */
+    void freeBlock(char *block, std::size_t size, off_t offset);
+
+    /** Bytes of temp table blocks currently in the file. */
+    int64_t spilledBytes() const { return m_spilledBytes; }
+
+private:
+    std::size_t slotSize(std::size_t size) const;
+
+    int m_fd;
+    off_t m_fileSize;
+    std::size_t m_pageSize;
+    int64_t m_spilledBytes;
+    // Slots given back by freed blocks, by slot size.
+    std::map<std::size_t, std::vector<off_t> > m_freeSlots;
+};
+
+}
+
+#endif // TEMPTABLESPILL_H_
@@ -19,6 +19,9 @@
 #include <sys/mman.h>
 #include <errno.h>
 #include "common/ThreadLocalPool.h"
+#include "storage/ColdStorage.h"
+#include "storage/TempBlockCache.h"
+#include "storage/TempTableSpill.h"
 
 namespace voltdb {
 
@@ -29,12 +32,23 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_references(0),
         m_tupleLength(table->m_tupleLength),
         m_tuplesPerBlock(table->m_tuplesPerBlock),
+        m_allocationSize(table->m_tableAllocationSize),
         m_activeTuples(0),
         m_nextFreeTuple(0),
         m_lastCompactionOffset(0),
         m_bucket(bucket),
-        m_bucketIndex(0)
+        m_bucketIndex(0),
+        m_coldStorage(NULL),
+        m_coldOffset(0),
+        m_scansThisPass(0),
+        m_idlePasses(0),
+        m_spill(NULL),
+        m_spillOffset(0),
+        m_blockCache(NULL),
+        m_changeGeneration(0),
+        m_partitioningEpoch(0)
 {
+    clearZones();
 #ifdef USE_MMAP
     size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
     m_storage = static_cast<char*>(::mmap( 0, tableAllocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
@@ -43,12 +57,74 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         throwFatalException("Failed mmap");
     }
 #else
-    m_storage = new char[table->m_tableAllocationSize];
+    m_storage = ThreadLocalPool::allocateLargeBlock(m_allocationSize);
 #endif
     tupleBlocksAllocated++;
 }
 
+TupleBlock::TupleBlock(Table *table, TempTableSpill *spill, char *storage, off_t offset) :
+        m_storage(storage),
+        m_references(0),
+        m_tupleLength(table->m_tupleLength),
+        m_tuplesPerBlock(table->m_tuplesPerBlock),
+        m_allocationSize(table->m_tableAllocationSize),
+        m_activeTuples(0),
+        m_nextFreeTuple(0),
+        m_lastCompactionOffset(0),
+        m_bucket(),
+        m_bucketIndex(0),
+        m_coldStorage(NULL),
+        m_coldOffset(0),
+        m_scansThisPass(0),
+        m_idlePasses(0),
+        m_spill(spill),
+        m_spillOffset(offset),
+        m_blockCache(NULL),
+        m_changeGeneration(0),
+        m_partitioningEpoch(0)
+{
+    clearZones();
+    tupleBlocksAllocated++;
+}
+
+TupleBlock::TupleBlock(Table *table, TempBlockCache *blockCache) :
+        m_storage(NULL),
+        m_references(0),
+        m_tupleLength(table->m_tupleLength),
+        m_tuplesPerBlock(table->m_tuplesPerBlock),
+        m_allocationSize(table->m_tableAllocationSize),
+        m_activeTuples(0),
+        m_nextFreeTuple(0),
+        m_lastCompactionOffset(0),
+        m_bucket(),
+        m_bucketIndex(0),
+        m_coldStorage(NULL),
+        m_coldOffset(0),
+        m_scansThisPass(0),
+        m_idlePasses(0),
+        m_spill(NULL),
+        m_spillOffset(0),
+        m_blockCache(blockCache),
+        m_changeGeneration(0),
+        m_partitioningEpoch(0)
+{
+    clearZones();
+    m_storage = m_blockCache->allocateBlock(m_allocationSize);
+    tupleBlocksAllocated++;
+}
+
 TupleBlock::~TupleBlock() {
+    if (m_spill != NULL) {
+        m_spill->freeBlock(m_storage, m_allocationSize, m_spillOffset);
+        return;
+    }
+    if (m_blockCache != NULL) {
+        m_blockCache->freeBlock(m_storage, m_allocationSize);
+        return;
+    }
+    if (m_coldStorage != NULL) {
+        m_coldStorage->release(m_coldOffset, m_allocationSize);
+    }
 #ifdef USE_MMAP
     size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
     if (::munmap( m_storage, tableAllocationSize) != 0) {
@@ -56,11 +132,24 @@ TupleBlock::~TupleBlock() {
         throwFatalException("Failed munmap");
     }
 #else
-    delete []m_storage;
+    ThreadLocalPool::freeLargeBlock(m_storage, m_allocationSize);
 #endif
 }
 
-std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener) {
+void TupleBlock::writeBackSpilled() {
+    if (m_spill != NULL) {
+        m_spill->writeBack(m_storage, m_allocationSize, m_spillOffset);
+    }
+}
+
+void TupleBlock::restoreFromColdStorage() {
+    if (m_coldStorage != NULL) {
+        m_coldStorage->restore(*this);
+    }
+}
+
+std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener,
+                                      int64_t maxTuplesToMove) {
     assert(source != this);
     /*
       std::cout << "Attempting to merge " << static_cast<void*> (this)
@@ -72,7 +161,8 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
 
     uint32_t m_nextTupleInSourceOffset = source->lastCompactionOffset();
     int sourceTuplesPendingDeleteOnUndoRelease = 0;
-    while (hasFreeTuples() && !source->isEmpty()) {
+    int64_t tuplesMoved = 0;
+    while (hasFreeTuples() && !source->isEmpty() && tuplesMoved < maxTuplesToMove) {
         TableTuple sourceTupleWithNewValues(table->schema());
         TableTuple destinationTuple(table->schema());
 
@@ -116,6 +206,7 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
         }
 
         source->freeTuple(sourceTupleWithNewValues.address());
+        tuplesMoved++;
     }
     source->lastCompactionOffset(m_nextTupleInSourceOffset);
 
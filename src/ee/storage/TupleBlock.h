@@ -17,6 +17,7 @@
 
 #ifndef VOLTDB_TUPLEBLOCK_H_
 #define VOLTDB_TUPLEBLOCK_H_
+#include <algorithm>
 #include <vector>
 #include <stdint.h>
 #include <string.h>
@@ -36,6 +37,9 @@
 
 namespace voltdb {
 const int NO_NEW_BUCKET_INDEX = -1;
+class ColdStorage;
+class TempBlockCache;
+class TempTableSpill;
 class TupleBlock;
 }
 
@@ -85,12 +89,36 @@ typedef boost::shared_ptr<TBBucket> TBBucketPtr;
 typedef std::vector<TBBucketPtr> TBBucketPtrVector;
 const int TUPLE_BLOCK_NUM_BUCKETS = 20;
 
+/**
+ * The range of values of one of a table's zone map columns that a row must
+ * fall in to match a scan's predicate. See PersistentTable::zoneOfColumn().
+ */
+struct ZoneBound {
+    int zone;
+    int64_t low;
+    int64_t high;
+};
+
 class TupleBlock {
     friend void ::intrusive_ptr_add_ref(voltdb::TupleBlock * p);
     friend void ::intrusive_ptr_release(voltdb::TupleBlock * p);
 public:
+    static const int MAX_ZONE_COLUMNS = 4;
+
     TupleBlock(Table *table, TBBucketPtr bucket);
 
+    /**
+     * A temp table block kept in the spill file, at the given offset of it,
+     * rather than in memory.
+     */
+    TupleBlock(Table *table, TempTableSpill *spill, char *storage, off_t offset);
+
+    /**
+     * A temp table block whose storage comes from, and goes back to, the
+     * site's cache of free blocks.
+     */
+    TupleBlock(Table *table, TempBlockCache *blockCache);
+
     void* operator new(std::size_t sz)
     {
         assert(sz == sizeof(TupleBlock));
@@ -149,7 +177,15 @@ public:
         return m_bucketIndex;
     }
 
-    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL);
+    /**
+     * Move active tuples from the source block into this one until this
+     * block is full, the source is empty, or maxTuplesToMove tuples have
+     * been moved. A merge stopped short resumes where it left off in the
+     * source block. Returns the new bucket indexes of this block and the
+     * source block.
+     */
+    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL,
+                              int64_t maxTuplesToMove = INT64_MAX);
 
     /**
      * Find next free tuple storage address and its tupleblock's bucket index,
@@ -168,6 +204,9 @@ public:
             m_nextFreeTuple++;
         }
         m_activeTuples++;
+        // The new row's values aren't in the slot yet.
+        m_zonesValid = false;
+        m_partitioningEpoch = 0;
         int newBucketIndex = calculateBucketIndex();
         if (newBucketIndex == m_bucketIndex) {
             // tuple block is not too full for its current bucket
@@ -195,6 +234,9 @@ public:
         //Find the offset
         uint32_t offset = static_cast<uint32_t>(tupleStorage - m_storage);
         m_freeList.push_back(offset);
+        if (m_activeTuples == 0) {
+            clearZones();
+        }
         int newBucketIndex = calculateBucketIndex();
         if (newBucketIndex == m_bucketIndex) {
             return NO_NEW_BUCKET_INDEX;
@@ -212,6 +254,7 @@ public:
         m_activeTuples = 0;
         m_nextFreeTuple = 0;
         m_freeList.clear();
+        clearZones();
     }
 
     inline uint32_t unusedTupleBoundry() {
@@ -235,11 +278,145 @@ public:
     inline TBBucketPtr currentBucket() {
         return m_bucket;
     }
+
+    inline uint32_t allocationSize() {
+        return m_allocationSize;
+    }
+
+    /**
+     * Whether the block has been written out to cold storage.
+     */
+    inline bool isCold() {
+        return m_coldStorage != NULL;
+    }
+
+    inline off_t coldOffset() {
+        return m_coldOffset;
+    }
+
+    /**
+     * Called by ColdStorage as it moves the block out or back in.
+     */
+    inline void setCold(ColdStorage *storage, off_t offset) {
+        m_coldStorage = storage;
+        m_coldOffset = offset;
+    }
+
+    /**
+     * Bring the block back from cold storage if it was written out.
+     */
+    void restoreFromColdStorage();
+
+    /**
+     * Note that a table scan has reached this block.
+     */
+    inline void noteScan() {
+        ++m_scansThisPass;
+    }
+
+    /**
+     * Start a new eviction pass, returning how many passes in a row have
+     * gone by without a scan reaching the block.
+     */
+    inline uint32_t age() {
+        if (m_scansThisPass == 0) {
+            ++m_idlePasses;
+        }
+        else {
+            m_idlePasses = 0;
+        }
+        m_scansThisPass = 0;
+        return m_idlePasses;
+    }
+
+    inline uint32_t idlePasses() {
+        return m_idlePasses;
+    }
+
+    /**
+     * Whether the block lives in a temp table spill file.
+     */
+    inline bool isSpilled() {
+        return m_spill != NULL;
+    }
+
+    /**
+     * Start writing out a spilled block that will take no more inserts.
+     */
+    void writeBackSpilled();
+
+    /**
+     * The table's snapshot generation when a row of this block last
+     * changed, or 0 if none has since the table's first snapshot.
+     */
+    inline int64_t changeGeneration() const {
+        return m_changeGeneration;
+    }
+
+    inline void setChangeGeneration(int64_t generation) {
+        m_changeGeneration = generation;
+    }
+
+    /**
+     * Whether the zone maps, the least and greatest non-null value of each
+     * of the table's zone map columns, cover every row of the block. A new
+     * row makes them stale until the table summarizes the block again.
+     * Deletes leave them as they are, so they may be wider than the rows.
+     */
+    inline bool zonesValid() const {
+        return m_zonesValid;
+    }
+
+    /** Start summarizing the block, as if it had no rows. */
+    inline void clearZones() {
+        for (int ii = 0; ii < MAX_ZONE_COLUMNS; ++ii) {
+            m_zoneMin[ii] = INT64_MAX;
+            m_zoneMax[ii] = INT64_MIN;
+        }
+        m_zonesValid = true;
+    }
+
+    inline void widenZone(int zone, int64_t value) {
+        m_zoneMin[zone] = std::min(m_zoneMin[zone], value);
+        m_zoneMax[zone] = std::max(m_zoneMax[zone], value);
+    }
+
+    /**
+     * The hashinator epoch (see VoltDBEngine::dispatchValidatePartitioningTask)
+     * under which @ValidatePartitioning last found every row of the block in
+     * the right partition, or 0. Inserts, which includes rows moved here, and
+     * changes to a row's partitioning value reset it. Deletes leave it be.
+     */
+    inline int64_t partitioningEpoch() const {
+        return m_partitioningEpoch;
+    }
+
+    inline void setPartitioningEpoch(int64_t epoch) {
+        m_partitioningEpoch = epoch;
+    }
+
+    /**
+     * False only if the zone maps rule out a row of the block falling in
+     * every one of the bounds.
+     */
+    inline bool mayMatch(const std::vector<ZoneBound> &bounds) const {
+        if (!m_zonesValid) {
+            return true;
+        }
+        for (size_t ii = 0; ii < bounds.size(); ++ii) {
+            const ZoneBound &bound = bounds[ii];
+            if (m_zoneMax[bound.zone] < bound.low || m_zoneMin[bound.zone] > bound.high) {
+                return false;
+            }
+        }
+        return true;
+    }
 private:
     char*   m_storage;
     uint32_t m_references;
     uint32_t m_tupleLength;
     uint32_t m_tuplesPerBlock;
+    uint32_t m_allocationSize;
     uint32_t m_activeTuples;
     uint32_t m_nextFreeTuple;
     uint32_t m_lastCompactionOffset;
@@ -255,6 +432,21 @@ private:
 
     TBBucketPtr m_bucket;
     int m_bucketIndex;
+
+    ColdStorage *m_coldStorage;
+    off_t m_coldOffset;
+    uint32_t m_scansThisPass;
+    uint32_t m_idlePasses;
+
+    TempTableSpill *m_spill;
+    off_t m_spillOffset;
+    TempBlockCache *m_blockCache;
+    int64_t m_changeGeneration;
+
+    bool m_zonesValid;
+    int64_t m_zoneMin[MAX_ZONE_COLUMNS];
+    int64_t m_zoneMax[MAX_ZONE_COLUMNS];
+    int64_t m_partitioningEpoch;
 };
 
 /**
@@ -24,6 +24,7 @@
 #include "common/tabletuple.h"
 #include "common/ExportSerializeIo.h"
 #include "common/executorcontext.hpp"
+#include "common/Tracepoints.h"
 #include "storage/TupleStreamException.h"
 
 #include <cstdio>
@@ -73,6 +74,16 @@ TupleStreamBase::setDefaultCapacity(size_t capacity)
 
 
 
+size_t TupleStreamBase::pendingByteCount() const
+{
+    size_t bytes = m_currBlock ? m_currBlock->headerSize() + m_currBlock->capacity() : 0;
+    for (std::deque<StreamBlock*>::const_iterator iter = m_pendingBlocks.begin();
+         iter != m_pendingBlocks.end(); ++iter) {
+        bytes += (*iter)->headerSize() + (*iter)->capacity();
+    }
+    return bytes;
+}
+
 /*
  * Essentially, shutdown.
  */
@@ -193,6 +204,7 @@ void TupleStreamBase::pushPendingBlocks()
         {
             //The block is handed off to the topend which is responsible for releasing the
             //memory associated with the block data. The metadata is deleted here.
+            VOLT_PROBE2(stream__push, static_cast<int64_t>(block->uso()), static_cast<int64_t>(block->offset()));
             pushExportBuffer(
                     block,
                     false,
@@ -75,6 +75,9 @@ public:
     void pushPendingBlocks();
     void discardBlock(StreamBlock *sb);
 
+    /** Bytes of the current and pending blocks, which the top end has not taken yet */
+    size_t pendingByteCount() const;
+
     virtual bool checkOpenTransaction(StreamBlock *sb, size_t minLength, size_t& blockSize, size_t& uso) { return false; }
 
     virtual void handleOpenTransaction(StreamBlock *oldBlock) {}
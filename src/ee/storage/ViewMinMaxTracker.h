@@ -0,0 +1,148 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIEWMINMAXTRACKER_H_
+#define VIEWMINMAXTRACKER_H_
+
+#include "common/NValue.hpp"
+#include "common/UndoAction.h"
+
+#include "boost/shared_ptr.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * The values of one MIN or MAX column of a materialized view, for each of
+ * the view's groups, with how many source rows hold each value. The best
+ * value left in a group after a delete is then a lookup rather than a scan
+ * of the source table.
+ *
+ * Keys are the group-by values followed by the aggregated value, so only
+ * views whose group-by and aggregated columns are all fixed width are
+ * tracked: their NValues do not refer to any tuple's storage. NULL
+ * aggregated values are not tracked, as MIN and MAX skip them.
+ */
+class ViewMinMaxTracker {
+public:
+    typedef std::vector<NValue> Key;
+
+    ViewMinMaxTracker(size_t groupByColumnCount, bool forMax)
+        : m_counts(KeyLess(groupByColumnCount, forMax ? -1 : 1))
+    { }
+
+    void add(const Key &key) {
+        ++m_counts[key];
+    }
+
+    void remove(const Key &key) {
+        CountMap::iterator iter = m_counts.find(key);
+        if (iter == m_counts.end()) {
+            return;
+        }
+        if (--iter->second == 0) {
+            m_counts.erase(iter);
+        }
+    }
+
+    /**
+     * Find the MIN or MAX of the group from its group-by values, returning
+     * false when no row of the group has a non-NULL value.
+     */
+    bool best(const Key &groupKey, NValue &value) const {
+        // A group's key sorts before all of its entries, best first.
+        CountMap::const_iterator iter = m_counts.lower_bound(groupKey);
+        if (iter == m_counts.end()) {
+            return false;
+        }
+        for (size_t ii = 0; ii < groupKey.size(); ii++) {
+            if (iter->first[ii].compare(groupKey[ii]) != 0) {
+                return false;
+            }
+        }
+        value = iter->first[groupKey.size()];
+        return true;
+    }
+
+    size_t size() const { return m_counts.size(); }
+
+    void clear() { m_counts.clear(); }
+
+private:
+    // Orders by the group-by values and then by the aggregated value, best
+    // first; a key that is a prefix of another sorts before it.
+    struct KeyLess {
+        KeyLess(size_t groupByColumnCount, int direction)
+            : m_groupByColumnCount(groupByColumnCount), m_direction(direction)
+        { }
+
+        bool operator()(const Key &lhs, const Key &rhs) const {
+            size_t length = std::min(lhs.size(), rhs.size());
+            for (size_t ii = 0; ii < length; ii++) {
+                int comparison = lhs[ii].compare(rhs[ii]);
+                if (comparison != 0) {
+                    return (ii == m_groupByColumnCount ? m_direction * comparison : comparison) < 0;
+                }
+            }
+            return lhs.size() < rhs.size();
+        }
+
+        size_t m_groupByColumnCount;
+        int m_direction;
+    };
+
+    typedef std::map<Key, int64_t, KeyLess> CountMap;
+
+    CountMap m_counts;
+};
+
+/**
+ * Takes back a tracker's add or remove when the source table change that
+ * made it is undone; the view and source tables undo their own parts.
+ */
+class ViewMinMaxTrackerUndoAction : public UndoAction {
+public:
+    ViewMinMaxTrackerUndoAction(boost::shared_ptr<ViewMinMaxTracker> tracker,
+                                const ViewMinMaxTracker::Key &key, bool added)
+        : m_tracker(tracker), m_key(key), m_added(added)
+    { }
+
+    void undo() {
+        if (m_added) {
+            m_tracker->remove(m_key);
+        }
+        else {
+            m_tracker->add(m_key);
+        }
+    }
+
+    void release() { }
+
+private:
+    boost::shared_ptr<ViewMinMaxTracker> m_tracker;
+    ViewMinMaxTracker::Key m_key;
+    bool m_added;
+};
+
+} // namespace voltdb
+
+#endif // VIEWMINMAXTRACKER_H_
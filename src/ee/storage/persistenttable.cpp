@@ -53,8 +53,11 @@
 #include "MaterializedViewTriggerForWrite.h"
 #include "PersistentTableStats.h"
 #include "PersistentTableUndoInsertAction.h"
+#include "PersistentTableUndoInsertBatchAction.h"
 #include "PersistentTableUndoDeleteAction.h"
+#include "PersistentTableUndoDeleteBatchAction.h"
 #include "PersistentTableUndoTruncateTableAction.h"
+#include "PersistentTableUndoInPlaceUpdateAction.h"
 #include "PersistentTableUndoUpdateAction.h"
 #include "TableCatalogDelegate.hpp"
 #include "tablefactory.h"
@@ -72,6 +75,7 @@
 #include "common/RecoveryProtoMessage.h"
 #include "common/StreamPredicateList.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "catalog/catalog.h"
 #include "catalog/database.h"
 #include "catalog/table.h"
@@ -80,6 +84,7 @@
 #include "indexes/tableindex.h"
 #include "indexes/tableindexfactory.h"
 #include "logging/LogManager.h"
+#include "stats/LatencySample.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/foreach.hpp>
@@ -96,6 +101,10 @@ TableTuple keyTuple;
 
 #define TABLE_BLOCKSIZE 2097152
 
+// The number of tuples doIncrementalCompaction moves between checks of its
+// time budget.
+static const int64_t INCREMENTAL_COMPACTION_STEP_TUPLES = 256;
+
 class SetAndRestorePendingDeleteFlag
 {
 public:
@@ -119,9 +128,29 @@ PersistentTable::PersistentTable(int partitionColumn, const char * signature, bo
     m_allowNulls(),
     m_partitionColumn(partitionColumn),
     m_tupleLimit(tupleLimit),
+    m_ttlColumn(-1),
+    m_ttlMicros(0),
+    m_ttlBatchSize(0),
+    m_appendOnly(false),
+    m_clustered(false),
+    m_unclusteredTupleCount(0),
+    m_clusterPassActive(false),
+    m_clusterResumeKey(),
+    m_clusterBlock(),
+    m_zoneColumns(),
+    m_zoneOfColumn(),
+    m_zonesStale(false),
+    m_zoneResumeAddress(NULL),
     m_purgeExecutorVector(),
     m_stats(this),
+    m_scanUsageStats(NULL),
     m_failedCompactionCount(0),
+    m_compactedTupleCount(0),
+    m_blockEvictionCount(0),
+    m_coldTupleMemory(0),
+    m_snapshotGeneration(0),
+    m_changedBlockCount(0),
+    m_snapshotCopyMemory(0),
     m_invisibleTuplesPendingDeleteCount(0),
     m_surgeon(*this),
     m_isMaterialized(isMaterialized),
@@ -131,6 +160,7 @@ PersistentTable::PersistentTable(int partitionColumn, const char * signature, bo
     m_smallestUniqueIndexCrc(0),
     m_drTimestampColumnIndex(-1),
     m_pkeyIndex(NULL),
+    m_indexesDeferredForRecovery(false),
     m_mvHandler(NULL),
     m_deltaTable(NULL),
     m_deltaTableActive(false)
@@ -171,6 +201,27 @@ void PersistentTable::initializeWithColumns(TupleSchema *schema,
         m_allowNulls[i] = columnInfo->allowNull;
     }
 
+    // Timestamps first, as rows most often arrive about in time order.
+    m_zoneColumns.clear();
+    m_zoneOfColumn.assign(m_columnCount, -1);
+    for (int pass = 0; pass < 2 && !m_isMaterialized; ++pass) {
+        for (int i = 0; i < m_columnCount && m_zoneColumns.size() < TupleBlock::MAX_ZONE_COLUMNS; ++i) {
+            const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(i);
+            const ValueType type = columnInfo->getVoltType();
+            if (pass == 0 ? type != VALUE_TYPE_TIMESTAMP : !isIntegralType(type)) {
+                continue;
+            }
+            ZoneColumn zoneColumn;
+            zoneColumn.offset = columnInfo->offset;
+            zoneColumn.width = static_cast<uint32_t>(NValue::getTupleStorageSize(type));
+            m_zoneOfColumn[i] = static_cast<int>(m_zoneColumns.size());
+            m_zoneColumns.push_back(zoneColumn);
+        }
+    }
+
+    // The string dictionaries are created once the table has grown.
+    assert(m_stringDictionaries.empty());
+
     // Also clear some used block state. this structure doesn't have
     // an block ownership semantics - it's just a cache. I think.
     m_blocksWithSpace.clear();
@@ -181,6 +232,8 @@ void PersistentTable::initializeWithColumns(TupleSchema *schema,
 }
 
 PersistentTable::~PersistentTable() {
+    m_appendedBlocks.clear();
+    m_clusterBlock.reset();
     for (int ii = 0; ii < TUPLE_BLOCK_NUM_BUCKETS; ii++) {
         m_blocksNotPendingSnapshotLoad[ii]->clear();
         m_blocksPendingSnapshotLoad[ii]->clear();
@@ -214,18 +267,29 @@ PersistentTable::~PersistentTable() {
     if (m_deltaTable) {
         m_deltaTable->decrementRefcount();
     }
+
+    // The tuples referencing the shared strings are all gone.
+    BOOST_FOREACH(StringDictionary *dictionary, m_stringDictionaries) {
+        delete dictionary;
+    }
 }
 
 // ------------------------------------------------------------------
 // OPERATIONS
 // ------------------------------------------------------------------
 void PersistentTable::nextFreeTuple(TableTuple *tuple) {
+    ++m_unclusteredTupleCount;
+    m_zonesStale = true;
     // First check whether we have any in our list
     // In the memcheck it uses the heap instead of a free list to help Valgrind.
     if (!m_blocksWithSpace.empty()) {
         VOLT_TRACE("GRABBED FREE TUPLE!\n");
         stx::btree_set<TBPtr >::iterator begin = m_blocksWithSpace.begin();
         TBPtr block = (*begin);
+        // A block taking inserts is hot again.
+        noteBlockLeavingCold(block);
+        block->restoreFromColdStorage();
+        noteBlockChanged(block);
         std::pair<char*, int> retval = block->nextFreeTuple();
 
         /**
@@ -262,6 +326,7 @@ void PersistentTable::nextFreeTuple(TableTuple *tuple) {
     // get free tuple
     assert (m_columnCount == tuple->sizeInValues());
 
+    noteBlockChanged(block);
     std::pair<char*, int> retval = block->nextFreeTuple();
 
     /**
@@ -337,13 +402,14 @@ void PersistentTable::truncateTableForUndo(VoltDBEngine * engine, TableCatalogDe
         targetTcd->deleteCommand();
         // update the view table pointer with the original view
         targetTcd->setTable(targetTable);
+        engine->rebuildTableCollections(targetTcd);
     }
     decrementRefcount();
 
     // reset base table pointer
     tcd->setTable(originalTable);
 
-    engine->rebuildTableCollections();
+    engine->rebuildTableCollections(tcd);
 }
 
 void PersistentTable::truncateTableRelease(PersistentTable *originalTable) {
@@ -376,7 +442,52 @@ void PersistentTable::truncateTableRelease(PersistentTable *originalTable) {
         PersistentTable *destTable = viewHandler->destTable();
         destTable->decrementRefcount();
     }
-    originalTable->decrementRefcount();
+    // Freeing a big table would hold up the next transaction, so the
+    // engine frees it a bounded amount at a time on its tick instead.
+    VoltDBEngine *engine = ExecutorContext::getEngine();
+    if (engine != NULL && originalTable->refcount() == 1 &&
+            originalTable->allocatedTupleMemory() > TICK_RECLAIM_MAX_BYTES) {
+        engine->reclaimTableIncrementally(originalTable);
+    }
+    else {
+        originalTable->decrementRefcount();
+    }
+}
+
+bool PersistentTable::freeBlocksIncrementally(int64_t maxBytes) {
+    // Nothing inserts into, compacts or scans the table any more, so the
+    // bookkeeping can go at once, leaving m_data to empty a block at a time.
+    for (int ii = 0; ii < TUPLE_BLOCK_NUM_BUCKETS; ii++) {
+        m_blocksNotPendingSnapshotLoad[ii]->clear();
+        m_blocksPendingSnapshotLoad[ii]->clear();
+    }
+    m_blocksWithSpace.clear();
+    m_blocksNotPendingSnapshot.clear();
+    m_blocksPendingSnapshot.clear();
+    m_appendedBlocks.clear();
+    m_clusterBlock.reset();
+
+    const bool hasObjects = m_schema->getUninlinedObjectColumnCount() != 0;
+    TableTuple tuple(m_schema);
+    int64_t freedBytes = 0;
+    while (!m_data.empty() && freedBytes < maxBytes) {
+        TBMapI blockIter = m_data.begin();
+        TBPtr block = blockIter.data();
+        if (hasObjects) {
+            const uint32_t boundary = block->unusedTupleBoundry();
+            for (uint32_t ii = 0; ii < boundary; ++ii) {
+                tuple.move(block->address() + ii * m_tupleLength);
+                if (tuple.isActive()) {
+                    tuple.freeObjectColumns();
+                    tuple.setActiveFalse();
+                }
+            }
+        }
+        freedBytes += block->allocationSize();
+        m_data.erase(blockIter);
+        m_tupleCount -= block->activeTuples();
+    }
+    return m_data.empty();
 }
 
 
@@ -478,6 +589,7 @@ void PersistentTable::truncateTable(VoltDBEngine* engine, bool fallible) {
         PersistentTable * targetEmptyTable = targetTcd->getPersistentTable();
         assert(targetEmptyTable);
         MaterializedViewTriggerForWrite::build(emptyTable, targetEmptyTable, originalView->getMaterializedViewInfo());
+        engine->rebuildTableCollections(targetTcd);
     }
 
     BOOST_FOREACH (MaterializedViewHandler *viewHandler, m_viewHandlers) {
@@ -495,16 +607,25 @@ void PersistentTable::truncateTable(VoltDBEngine* engine, bool fallible) {
         if (populateInitialTuple) {
             newHandler->catchUpWithExistingData(engine, fallible);
         }
+        engine->rebuildTableCollections(destTcd);
+    }
+
+    // The new table carries on this one's snapshot generation, and all of
+    // this one's blocks count as changed.
+    if (m_snapshotGeneration != 0) {
+        emptyTable->m_snapshotGeneration = m_snapshotGeneration;
+        emptyTable->m_changedBlockCount = m_data.size();
     }
 
     // If there is a purge fragment on the old table, pass it on to the new one
     if (hasPurgeFragment()) {
         assert(! emptyTable->hasPurgeFragment());
+        emptyTable->setPurgePlan(m_purgePlan);
         boost::shared_ptr<ExecutorVector> evPtr = getPurgeExecutorVector();
         emptyTable->swapPurgeExecutorVector(evPtr);
     }
 
-    engine->rebuildTableCollections();
+    engine->rebuildTableCollections(tcd);
 
     ExecutorContext *ec = ExecutorContext::getExecutorContext();
     AbstractDRTupleStream *drStream = getDRTupleStream(ec);
@@ -566,12 +687,7 @@ void PersistentTable::insertTupleIntoDeltaTable(TableTuple &source, bool fallibl
     }
 
     // If the delta table has data in it, delete the data first.
-    if (! m_deltaTable->isPersistentTableEmpty()) {
-        TableIterator ti(m_deltaTable, m_deltaTable->m_data.begin());
-        TableTuple tuple(m_deltaTable->m_schema);
-        ti.next(tuple);
-        m_deltaTable->deleteTuple(tuple, fallible);
-    }
+    clearDeltaTable(fallible);
 
     TableTuple targetForDelta(m_deltaTable->m_schema);
     m_deltaTable->nextFreeTuple(&targetForDelta);
@@ -590,6 +706,39 @@ void PersistentTable::insertTupleIntoDeltaTable(TableTuple &source, bool fallibl
     }
 }
 
+void PersistentTable::insertTuplesIntoDeltaTable(std::vector<TableTuple> &sources, bool fallible) {
+    if (! m_deltaTable) {
+        return;
+    }
+    clearDeltaTable(fallible);
+    BOOST_FOREACH (TableTuple &source, sources) {
+        TableTuple targetForDelta(m_deltaTable->m_schema);
+        m_deltaTable->nextFreeTuple(&targetForDelta);
+        targetForDelta.copyForPersistentInsert(source);
+        try {
+            m_deltaTable->insertTupleCommon(source, targetForDelta, fallible);
+        }
+        catch (ConstraintFailureException &e) {
+            m_deltaTable->deleteTupleStorage(targetForDelta);
+            throw;
+        }
+        catch (TupleStreamException &e) {
+            m_deltaTable->deleteTupleStorage(targetForDelta);
+            throw;
+        }
+    }
+}
+
+void PersistentTable::clearDeltaTable(bool fallible) {
+    // A batch may have left more than one row behind.
+    TableTuple tuple(m_deltaTable->m_schema);
+    while (! m_deltaTable->isPersistentTableEmpty()) {
+        TableIterator ti(m_deltaTable, m_deltaTable->m_data.begin());
+        ti.next(tuple);
+        m_deltaTable->deleteTuple(tuple, fallible);
+    }
+}
+
 /*
  * Regular tuple insertion that does an allocation and copy for
  * uninlined strings and creates and registers an UndoAction.
@@ -617,7 +766,7 @@ void PersistentTable::insertPersistentTuple(TableTuple &source, bool fallible, b
     //
     // Then copy the source into the target
     //
-    target.copyForPersistentInsert(source); // tuple in freelist must be already cleared
+    target.copyForPersistentInsert(source, NULL, stringDictionaries()); // tuple in freelist must be already cleared
 
     try {
         // Insert the tuple into the delta table first.
@@ -639,8 +788,125 @@ void PersistentTable::insertPersistentTuple(TableTuple &source, bool fallible, b
     }
 }
 
+bool PersistentTable::insertPersistentTupleBatch(std::vector<TableTuple> &sources) {
+    std::vector<TableTuple> targets;
+    targets.reserve(sources.size());
+    TableTuple target(m_schema);
+    BOOST_FOREACH (TableTuple &source, sources) {
+        nextFreeTuple(&target);
+        // insertTupleBatchCommon shares the object columns itself
+        target.copyForPersistentInsert(source);
+        // The copy took the source's flags, which need not be a live tuple's.
+        target.setActiveTrue();
+        target.setDirtyFalse();
+        target.setPendingDeleteFalse();
+        target.setPendingDeleteOnUndoReleaseFalse();
+        targets.push_back(target);
+    }
+
+    bool inserted = false;
+    try {
+        inserted = insertTupleBatchCommon(targets, true);
+    }
+    catch (TupleStreamException &e) {
+        // Inserted one at a time, the row that overflows the stream throws
+        // again, after the ones before it went in.
+    }
+    if (inserted) {
+        return true;
+    }
+    freeUnprocessedTuples(targets);
+    return false;
+}
+
+bool PersistentTable::upsertTuple(TableTuple &source, std::vector<int> const &setColumns,
+                                  std::vector<TableIndex*> const &indexesToUpdate) {
+    assert(m_pkeyIndex);
+    TableTuple existing(m_schema);
+    if (m_pkeyIndex->keyUsesNonInlinedMemory()) {
+        // The index would keep pointers into the probe's copy of the key.
+        existing = lookupTupleByValues(source);
+    }
+    else {
+        // Probe by entering source itself; a new row's entry is moved to
+        // its slot below, so no slot is taken for rows that exist.
+        m_pkeyIndex->addEntry(&source, &existing);
+    }
+
+    if (!existing.isNullTuple()) {
+        // Only the set columns change; any object allocations they need
+        // were made when they were copied into source.
+        TableTuple &tempTuple = copyIntoTempTuple(existing);
+        BOOST_FOREACH (int col, setColumns) {
+            tempTuple.setNValue(col, source.getNValue(col));
+        }
+        if (m_pkeyIndex->keyUsesNonInlinedMemory()) {
+            // Its entry points at the key's objects, which the update replaces.
+            std::vector<TableIndex*> withPkey(indexesToUpdate);
+            withPkey.push_back(m_pkeyIndex);
+            updateTupleWithSpecificIndexes(existing, tempTuple, withPkey);
+        }
+        else {
+            updateTupleWithSpecificIndexes(existing, tempTuple, indexesToUpdate);
+        }
+        return false;
+    }
+
+    if (m_pkeyIndex->keyUsesNonInlinedMemory()) {
+        insertPersistentTuple(source, true);
+        return true;
+    }
+
+    TableTuple target(m_schema);
+    try {
+        if (visibleTupleCount() >= m_tupleLimit) {
+            char buffer [256];
+            snprintf (buffer, 256, "Table %s exceeds table maximum row count %d",
+                    m_name.c_str(), m_tupleLimit);
+            throw ConstraintFailureException(this, source, buffer);
+        }
+        nextFreeTuple(&target);
+    }
+    catch (...) {
+        m_pkeyIndex->deleteEntry(&source);
+        throw;
+    }
+    try {
+        target.copyForPersistentInsert(source, NULL, stringDictionaries());
+    }
+    catch (...) {
+        m_pkeyIndex->deleteEntry(&source);
+        // Columns the copy had not reached still share source's objects,
+        // so the slot is cleared of them before it is freed.
+        for (uint16_t ii = 0; ii < m_schema->getUninlinedObjectColumnCount(); ii++) {
+            int col = m_schema->getUninlinedObjectColumnInfoIndex(ii);
+            target.setNValue(col, NValue::getNullValue(m_schema->columnType(col)));
+        }
+        deleteTupleStorage(target);
+        throw;
+    }
+    m_pkeyIndex->replaceEntryNoKeyChange(target, source);
+
+    try {
+        insertTupleIntoDeltaTable(source, true);
+        insertTupleCommon(source, target, true, true, m_pkeyIndex);
+    }
+    catch (ConstraintFailureException &e) {
+        m_pkeyIndex->deleteEntry(&target);
+        deleteTupleStorage(target); // also frees object columns
+        throw;
+    }
+    catch (TupleStreamException &e) {
+        m_pkeyIndex->deleteEntry(&target);
+        deleteTupleStorage(target); // also frees object columns
+        throw;
+    }
+    return true;
+}
+
 void PersistentTable::insertTupleCommon(TableTuple &source, TableTuple &target,
-                                        bool fallible, bool shouldDRStream) {
+                                        bool fallible, bool shouldDRStream,
+                                        TableIndex *alreadyIndexed) {
     if (fallible) {
         // not null checks at first
         FAIL_IF(!checkNulls(target)) {
@@ -658,6 +924,18 @@ void PersistentTable::insertTupleCommon(TableTuple &source, TableTuple &target,
 
     AbstractDRTupleStream *drStream = getDRTupleStream(ec);
     if (drStream && !m_isMaterialized && m_drEnabled && shouldDRStream) {
+        UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
+        // Without an undo quantum, as for writes the frontend runs without
+        // undo, the DR record could not be taken back if the insert failed
+        // on a unique index, so look for the conflict before writing it.
+        if (fallible && uq == NULL) {
+            TableTuple conflict(m_schema);
+            findUniqueConflict(&target, &conflict);
+            if (!conflict.isNullTuple()) {
+                throw ConstraintFailureException(this, source, conflict, CONSTRAINT_TYPE_UNIQUE);
+            }
+        }
+
         ExecutorContext *ec = ExecutorContext::getExecutorContext();
         const int64_t lastCommittedSpHandle = ec->lastCommittedSpHandle();
         const int64_t currentSpHandle = ec->currentSpHandle();
@@ -665,7 +943,6 @@ void PersistentTable::insertTupleCommon(TableTuple &source, TableTuple &target,
         size_t drMark = drStream->appendTuple(lastCommittedSpHandle, m_signature, m_partitionColumn, currentSpHandle,
                                               currentUniqueId, target, DR_RECORD_INSERT);
 
-        UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
         if (uq && fallible) {
             uq->registerUndoAction(new (*uq) DRTupleStreamUndoAction(drStream, drMark, rowCostForDRRecord(DR_RECORD_INSERT)));
         }
@@ -691,7 +968,7 @@ void PersistentTable::insertTupleCommon(TableTuple &source, TableTuple &target,
     }
 
     TableTuple conflict(m_schema);
-    tryInsertOnAllIndexes(&target, &conflict);
+    tryInsertOnAllIndexes(&target, &conflict, alreadyIndexed);
     if (!conflict.isNullTuple()) {
         throw ConstraintFailureException(this, source, conflict, CONSTRAINT_TYPE_UNIQUE);
     }
@@ -810,8 +1087,23 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
         const int64_t lastCommittedSpHandle = ec->lastCommittedSpHandle();
         const int64_t currentSpHandle = ec->currentSpHandle();
         const int64_t currentUniqueId = ec->currentUniqueId();
-        size_t drMark = drStream->appendUpdateRecord(lastCommittedSpHandle, m_signature, m_partitionColumn, currentSpHandle,
-                                                     currentUniqueId, targetTupleToUpdate, sourceTupleWithNewValues);
+        // Without active-active the replica can find the row by its unique key,
+        // so only the columns that changed need to be sent.
+        std::pair<const TableIndex*, uint32_t> uniqueIndex(NULL, 0);
+        if (drStream->writesChangedColumnsUpdates()) {
+            uniqueIndex = getUniqueIndexForDR();
+        }
+        size_t drMark;
+        if (uniqueIndex.first) {
+            drMark = drStream->appendChangedColumnsUpdateRecord(lastCommittedSpHandle, m_signature, m_partitionColumn,
+                                                                currentSpHandle, currentUniqueId,
+                                                                *uniqueIndex.first, uniqueIndex.second,
+                                                                targetTupleToUpdate, sourceTupleWithNewValues);
+        }
+        else {
+            drMark = drStream->appendUpdateRecord(lastCommittedSpHandle, m_signature, m_partitionColumn, currentSpHandle,
+                                                  currentUniqueId, targetTupleToUpdate, sourceTupleWithNewValues);
+        }
 
         UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
         if (uq && fallible) {
@@ -822,6 +1114,9 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
     if (m_tableStreamer != NULL) {
         m_tableStreamer->notifyTupleUpdate(targetTupleToUpdate);
     }
+    noteTupleChanged(targetTupleToUpdate.address());
+    noteZoneUpdate(targetTupleToUpdate, sourceTupleWithNewValues);
+    notePartitioningUpdate(targetTupleToUpdate, sourceTupleWithNewValues);
 
     /**
      * Remove the current tuple from any indexes.
@@ -866,7 +1161,6 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
 
     if (m_schema->getUninlinedObjectColumnCount() != 0) {
         decreaseStringMemCount(targetTupleToUpdate.getNonInlinedMemorySize());
-        increaseStringMemCount(sourceTupleWithNewValues.getNonInlinedMemorySize());
     }
 
     // TODO: This is a little messed up.
@@ -893,7 +1187,14 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
     std::vector<char*> newObjects;
 
     // this is the actual write of the new values
-    targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects);
+    targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects,
+                                                stringDictionaries());
+
+    // Count the strings actually stored, which may be shared rather than
+    // copies of the source tuple's.
+    if (m_schema->getUninlinedObjectColumnCount() != 0) {
+        increaseStringMemCount(targetTupleToUpdate.getNonInlinedMemorySize());
+    }
 
     if (uq) {
         /*
@@ -942,6 +1243,76 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple &targetTupleToUp
     }
 }
 
+bool PersistentTable::canUpdateInPlace(std::vector<int> const &columns) const {
+    if (m_drEnabled || hasDRTimestampColumn() || !m_views.empty() ||
+            !m_viewHandlers.empty() || m_deltaTable != NULL) {
+        return false;
+    }
+    BOOST_FOREACH (int col, columns) {
+        if (col == m_partitionColumn ||
+                isVariableLengthType(m_schema->columnType(col))) {
+            return false;
+        }
+        BOOST_FOREACH (TableIndex *index, m_indexes) {
+            const std::vector<int> &indexed = index->getAllColumnIndices();
+            if (std::find(indexed.begin(), indexed.end(), col) != indexed.end()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void PersistentTable::updateTupleInPlace(TableTuple &targetTupleToUpdate,
+                                         TableTuple const &sourceTupleWithNewValues,
+                                         std::vector<int> const &columns) {
+    uint32_t spanStart = m_schema->tupleLength();
+    uint32_t spanEnd = 0;
+    BOOST_FOREACH (int col, columns) {
+        // The rest of the source may be stale, so only the target is reported.
+        FAIL_IF(!m_allowNulls[col] && sourceTupleWithNewValues.isNull(col)) {
+            throw ConstraintFailureException(this, targetTupleToUpdate, TableTuple(),
+                                             CONSTRAINT_TYPE_NOT_NULL);
+        }
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(col);
+        spanStart = std::min(spanStart, columnInfo->offset);
+        spanEnd = std::max(spanEnd, columnInfo->offset +
+                           NValue::getTupleStorageSize(columnInfo->getVoltType()));
+    }
+    if (spanEnd <= spanStart) {
+        return;
+    }
+
+    if (m_tableStreamer != NULL) {
+        m_tableStreamer->notifyTupleUpdate(targetTupleToUpdate);
+    }
+    noteTupleChanged(targetTupleToUpdate.address());
+
+    char *target = targetTupleToUpdate.address() + TUPLE_HEADER_SIZE;
+    UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
+    if (uq) {
+        char *oldBytes = uq->allocatePooledCopy(target + spanStart, spanEnd - spanStart);
+        uq->registerUndoAction(new (*uq) PersistentTableUndoInPlaceUpdateAction(target + spanStart, oldBytes,
+                                                                                spanEnd - spanStart));
+    }
+
+    const char *source = sourceTupleWithNewValues.address() + TUPLE_HEADER_SIZE;
+    bool zoneChanged = false;
+    BOOST_FOREACH (int col, columns) {
+        const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(col);
+        ::memcpy(target + columnInfo->offset, source + columnInfo->offset,
+                 NValue::getTupleStorageSize(columnInfo->getVoltType()));
+        zoneChanged |= m_zoneOfColumn[col] >= 0;
+    }
+    if (zoneChanged) {
+        // The rest of the source may be stale, so widen by the updated row.
+        TBPtr block = findBlock(targetTupleToUpdate.address(), m_data, m_tableAllocationSize);
+        if (block.get() != NULL) {
+            widenZones(block.get(), targetTupleToUpdate);
+        }
+    }
+}
+
 /*
  * sourceTupleWithNewValues contains a copy of the tuple data before the update
  * and tupleWithUnwantedValues contains a copy of the updated tuple data.
@@ -1028,6 +1399,8 @@ void PersistentTable::deleteTuple(TableTuple &target, bool fallible) {
         }
     }
 
+    noteTupleChanged(target.address());
+
     // Just like insert, we want to remove this tuple from all of our indexes
     deleteFromAllIndexes(&target);
 
@@ -1115,6 +1488,432 @@ void PersistentTable::deleteTupleFinalize(TableTuple &target) {
     deleteTupleStorage(target); // also frees object columns
 }
 
+/**
+ * Delete a batch of tuples with one undo action rather than one per tuple,
+ * as when a DELETE removes many rows or a hash range that moved to another
+ * partition is dropped. Each index drops the whole batch in turn. Tables with views to maintain or
+ * DR to write take the tuples one at a time, as those work a row at a time.
+ */
+void PersistentTable::deleteTupleBatch(std::vector<TableTuple> &tuples) {
+    ExecutorContext *ec = ExecutorContext::getExecutorContext();
+    AbstractDRTupleStream *drStream = getDRTupleStream(ec);
+    if ((drStream && !drStream->m_guarded && !m_isMaterialized && m_drEnabled)
+            || m_deltaTable || !m_views.empty() || !m_viewHandlers.empty()) {
+        BOOST_FOREACH (TableTuple &tuple, tuples) {
+            deleteTuple(tuple);
+        }
+        return;
+    }
+    if (tuples.empty()) {
+        return;
+    }
+
+    BOOST_FOREACH (TableTuple &tuple, tuples) {
+        // May not delete an already deleted tuple.
+        assert(tuple.isActive());
+        noteTupleChanged(tuple.address());
+    }
+    BOOST_FOREACH (TableIndex *index, m_indexes) {
+        if (!index->deleteEntries(tuples)) {
+            throwFatalException(
+                    "Failed to delete tuple in Table: %s Index %s", m_name.c_str(), index->getName().c_str());
+        }
+    }
+
+    const int tupleCount = static_cast<int>(tuples.size());
+    UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
+    if (uq) {
+        char** undoData = reinterpret_cast<char**>(uq->allocateAction(tupleCount * sizeof(char*)));
+        for (int ii = 0; ii < tupleCount; ii++) {
+            tuples[ii].setPendingDeleteOnUndoReleaseTrue();
+            undoData[ii] = tuples[ii].address();
+        }
+        m_tuplesPinnedByUndo += tupleCount;
+        m_invisibleTuplesPendingDeleteCount += tupleCount;
+        uq->registerUndoAction(new (*uq) PersistentTableUndoDeleteBatchAction(undoData, tupleCount, &m_surgeon), this);
+        return;
+    }
+
+    std::vector<char*> tupleData(tupleCount);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        tupleData[ii] = tuples[ii].address();
+    }
+    deleteTupleBatchFinalize(&tupleData[0], tupleCount);
+}
+
+/**
+ * This entry point is triggered by the successful release of an UndoDeleteBatchAction.
+ */
+void PersistentTable::deleteTupleBatchRelease(char** tuples, int tupleCount) {
+    TableTuple target(m_schema);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        target.move(tuples[ii]);
+        target.setPendingDeleteOnUndoReleaseFalse();
+    }
+    m_tuplesPinnedByUndo -= tupleCount;
+    m_invisibleTuplesPendingDeleteCount -= tupleCount;
+    deleteTupleBatchFinalize(tuples, tupleCount);
+}
+
+/**
+ * deleteTupleFinalize for a batch. The tuples are taken in address order a
+ * block at a time, and a block that the batch empties is let go whole
+ * instead of returning each of its tuples to its free list first.
+ * Reorders the tuple addresses, and clears those a snapshot still holds.
+ */
+void PersistentTable::deleteTupleBatchFinalize(char** tuples, int tupleCount) {
+    std::sort(tuples, tuples + tupleCount);
+    TableTuple target(m_schema);
+    int first = 0;
+    while (first < tupleCount) {
+        TBPtr block = findBlock(tuples[first], m_data, m_tableAllocationSize);
+        if (block.get() == NULL) {
+            throwFatalException("Tried to find a tuple block for a tuple but couldn't find one");
+        }
+        const char* blockEnd = block->address() + m_tableAllocationSize;
+        int last = first;
+        while (last < tupleCount && tuples[last] < blockEnd) {
+            ++last;
+        }
+
+        // As in deleteTupleFinalize, a snapshot in progress may keep some
+        // of the tuples pending delete.
+        bool allReleased = true;
+        for (int ii = first; ii < last; ii++) {
+            target.move(tuples[ii]);
+            if (m_tableStreamer != NULL && !m_tableStreamer->notifyTupleDelete(target)) {
+                if (!target.isPendingDelete()) {
+                    ++m_invisibleTuplesPendingDeleteCount;
+                    target.setPendingDeleteTrue();
+                }
+                tuples[ii] = NULL;
+                allReleased = false;
+            }
+        }
+
+        // Only blocks no snapshot is scanning or yet to scan may go whole,
+        // and, as in deleteTupleStorage, never the last one.
+        if (allReleased
+                && last - first == static_cast<int>(block->activeTuples())
+                && m_data.size() > 1
+                && m_blocksNotPendingSnapshot.find(block) != m_blocksNotPendingSnapshot.end()) {
+            for (int ii = first; ii < last; ii++) {
+                target.move(tuples[ii]);
+                if (m_schema->getUninlinedObjectColumnCount() != 0) {
+                    decreaseStringMemCount(target.getNonInlinedMemorySize());
+                    target.freeObjectColumns();
+                }
+                if (target.isPendingDelete()) {
+                    --m_invisibleTuplesPendingDeleteCount;
+                }
+            }
+            m_tupleCount -= last - first;
+            noteBlockLeavingCold(block);
+            noteBlockReleased(block);
+            m_data.erase(block->address());
+            m_blocksWithSpace.erase(block);
+            m_blocksNotPendingSnapshot.erase(block);
+            //Eliminates circular reference
+            block->swapToBucket(TBBucketPtr());
+        }
+        else {
+            for (int ii = first; ii < last; ii++) {
+                if (tuples[ii] != NULL) {
+                    target.move(tuples[ii]);
+                    deleteTupleStorage(target, block); // also frees object columns
+                }
+            }
+        }
+        first = last;
+    }
+}
+
+int32_t PersistentTable::expireRows(int64_t nowMicros) {
+    if (m_ttlColumn < 0 || m_tupleCount == 0) {
+        return 0;
+    }
+    if (m_appendOnly) {
+        return expireAppendedRows(nowMicros - m_ttlMicros);
+    }
+
+    // The compiler makes sure there is such an index.
+    TableIndex *ttlIndex = NULL;
+    BOOST_FOREACH (TableIndex *index, m_indexes) {
+        if (index->getIndexType() == BALANCED_TREE_INDEX
+                && index->getIndexedExpressions().empty()
+                && ! index->isPartialIndex()
+                && index->getColumnIndices()[0] == m_ttlColumn) {
+            ttlIndex = index;
+            break;
+        }
+    }
+    if (ttlIndex == NULL) {
+        return 0;
+    }
+
+    // Start just past the NULLs, which sort first and never expire.
+    StandAloneTupleStorage searchKeyStorage(ttlIndex->getKeySchema());
+    TableTuple searchKey = searchKeyStorage.tuple();
+    searchKey.setNValue(0, ValueFactory::getTimestampValue(INT64_MIN + 1));
+    IndexCursor cursor(ttlIndex->getTupleSchema());
+    ttlIndex->moveToKeyOrGreater(&searchKey, cursor);
+
+    const int64_t expiry = nowMicros - m_ttlMicros;
+    std::vector<TableTuple> expired;
+    TableTuple tuple;
+    while (expired.size() < m_ttlBatchSize && ! (tuple = ttlIndex->nextValue(cursor)).isNullTuple()) {
+        if (ValuePeeker::peekTimestamp(tuple.getNValue(m_ttlColumn)) >= expiry) {
+            break;
+        }
+        expired.push_back(tuple);
+    }
+    deleteTupleBatch(expired);
+    return static_cast<int32_t>(expired.size());
+}
+
+/**
+ * Walk the blocks from the oldest, stopping in the first block with a row
+ * that has not expired yet, since the rows after it came later. Rows put in
+ * with an older time than the rows before them wait for those to expire.
+ * deleteTupleBatch lets go of each block whose rows have all expired whole.
+ */
+int32_t PersistentTable::expireAppendedRows(int64_t expiry) {
+    std::vector<TableTuple> expired;
+    TableTuple tuple(m_schema);
+    bool reachedUnexpired = false;
+    BOOST_FOREACH (TBPtr &block, m_appendedBlocks) {
+        block->noteScan();
+        for (uint32_t ii = 0; ii < block->unusedTupleBoundry(); ii++) {
+            tuple.move(block->address() + ii * m_tupleLength);
+            if ( ! tuple.isActive() || tuple.isPendingDelete()) {
+                continue;
+            }
+            NValue time = tuple.getNValue(m_ttlColumn);
+            // NULL never expires.
+            if (time.isNull()) {
+                continue;
+            }
+            if (ValuePeeker::peekTimestamp(time) >= expiry) {
+                reachedUnexpired = true;
+                break;
+            }
+            expired.push_back(tuple);
+            if (expired.size() >= m_ttlBatchSize) {
+                break;
+            }
+        }
+        if (reachedUnexpired || expired.size() >= m_ttlBatchSize) {
+            break;
+        }
+    }
+    deleteTupleBatch(expired);
+    return static_cast<int32_t>(expired.size());
+}
+
+void PersistentTable::setAppendOnly(bool appendOnly) {
+    if (appendOnly == m_appendOnly) {
+        return;
+    }
+    assert(m_tupleCount == 0);
+    m_appendOnly = appendOnly;
+    m_appendedBlocks.clear();
+    if (appendOnly) {
+        // At most the block allocated ahead of the first insert
+        for (TBMapI iter = m_data.begin(); iter != m_data.end(); ++iter) {
+            m_appendedBlocks.push_back(iter.data());
+        }
+    }
+}
+
+void PersistentTable::setClustered(bool clustered) {
+    if (clustered == m_clustered) {
+        return;
+    }
+    m_clustered = clustered;
+    // Count every row as out of order, so that the first pass starts soon.
+    m_unclusteredTupleCount = m_tupleCount;
+    endClusterPass();
+}
+
+void PersistentTable::endClusterPass() {
+    m_clusterPassActive = false;
+    // The block the pass was filling takes inserts like any other again.
+    if (m_clusterBlock.get() != NULL) {
+        TBMapI iter = m_data.find(m_clusterBlock->address());
+        if (iter != m_data.end() && iter.data() == m_clusterBlock && m_clusterBlock->hasFreeTuples()) {
+            m_blocksWithSpace.insert(m_clusterBlock);
+        }
+        m_clusterBlock.reset();
+    }
+}
+
+int64_t PersistentTable::clusterIncrementally(int64_t maxTuplesToMove) {
+    if ( ! m_clustered || m_appendOnly || m_pkeyIndex == NULL
+            || m_pkeyIndex->getIndexType() != BALANCED_TREE_INDEX
+            || m_pkeyIndex->keyUsesNonInlinedMemory()) {
+        return 0;
+    }
+    // A snapshot or a recovery scans the blocks in their own order.
+    if (m_tableStreamer.get() != NULL
+            && (m_tableStreamer->hasStreamType(TABLE_STREAM_SNAPSHOT)
+                || m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY))) {
+        return 0;
+    }
+
+    IndexCursor cursor(m_pkeyIndex->getTupleSchema());
+    TableTuple resumeKey = m_clusterResumeKey.tuple();
+    if (m_clusterPassActive) {
+        m_pkeyIndex->moveToGreaterThanKey(&resumeKey, cursor);
+    }
+    else {
+        if (m_tupleCount < m_tuplesPerBlock || m_unclusteredTupleCount * 4 < m_tupleCount) {
+            return 0;
+        }
+        m_clusterPassActive = true;
+        m_unclusteredTupleCount = 0;
+        m_clusterResumeKey.init(m_pkeyIndex->getKeySchema());
+        resumeKey = m_clusterResumeKey.tuple();
+        m_pkeyIndex->moveToEnd(true, cursor);
+    }
+
+    // Take the batch before moving any of it, as the moves change the index.
+    std::vector<char*> batch;
+    TableTuple tuple(m_schema);
+    while (static_cast<int64_t>(batch.size()) < maxTuplesToMove
+            && ! (tuple = m_pkeyIndex->nextValue(cursor)).isNullTuple()) {
+        batch.push_back(tuple.address());
+    }
+    if (batch.empty()) {
+        endClusterPass();
+        return 0;
+    }
+    const std::vector<int> &keyColumns = m_pkeyIndex->getColumnIndices();
+    tuple.move(batch.back());
+    for (size_t ii = 0; ii < keyColumns.size(); ii++) {
+        resumeKey.setNValue(ii, tuple.getNValue(keyColumns[ii]));
+    }
+
+    TableTuple target(m_schema);
+    BOOST_FOREACH (char *address, batch) {
+        if (m_clusterBlock.get() == NULL || ! m_clusterBlock->hasFreeTuples()) {
+            // Kept out of m_blocksWithSpace, so that inserts go elsewhere
+            m_clusterBlock = allocateNextBlock();
+        }
+        noteBlockChanged(m_clusterBlock);
+        std::pair<char*, int> slot = m_clusterBlock->nextFreeTuple();
+        if (slot.second != NO_NEW_BUCKET_INDEX) {
+            m_clusterBlock->swapToBucket(m_blocksNotPendingSnapshotLoad[slot.second]);
+        }
+
+        tuple.move(address);
+        TBPtr source = findBlock(address, m_data, m_tableAllocationSize);
+        noteBlockLeavingCold(source);
+        source->restoreFromColdStorage();
+        noteBlockChanged(source);
+        target.move(slot.first);
+        swapTuples(tuple, target);
+        notifyTupleMovement(source, m_clusterBlock, tuple, target);
+        releaseTupleSlot(address, source, false);
+    }
+    return static_cast<int64_t>(batch.size());
+}
+
+// Read a zone map column's value out of tuple storage, false if it is null.
+static inline bool readZoneValue(const char *data, uint32_t width, int64_t &value) {
+    switch (width) {
+    case 1:
+        value = *reinterpret_cast<const int8_t*>(data);
+        return value != INT8_NULL;
+    case 2:
+        value = *reinterpret_cast<const int16_t*>(data);
+        return value != INT16_NULL;
+    case 4:
+        value = *reinterpret_cast<const int32_t*>(data);
+        return value != INT32_NULL;
+    default:
+        value = *reinterpret_cast<const int64_t*>(data);
+        return value != INT64_NULL;
+    }
+}
+
+void PersistentTable::widenZones(TupleBlock *block, const TableTuple &tuple) {
+    const char *data = tuple.address() + TUPLE_HEADER_SIZE;
+    int64_t value;
+    for (size_t zone = 0; zone < m_zoneColumns.size(); ++zone) {
+        const ZoneColumn &column = m_zoneColumns[zone];
+        if (readZoneValue(data + column.offset, column.width, value)) {
+            block->widenZone(static_cast<int>(zone), value);
+        }
+    }
+}
+
+void PersistentTable::noteZoneUpdate(const TableTuple &tuple, const TableTuple &newValues) {
+    const char *oldData = tuple.address() + TUPLE_HEADER_SIZE;
+    const char *newData = newValues.address() + TUPLE_HEADER_SIZE;
+    BOOST_FOREACH (const ZoneColumn &column, m_zoneColumns) {
+        if (::memcmp(oldData + column.offset, newData + column.offset, column.width) != 0) {
+            TBPtr block = findBlock(tuple.address(), m_data, m_tableAllocationSize);
+            if (block.get() != NULL) {
+                widenZones(block.get(), newValues);
+            }
+            return;
+        }
+    }
+}
+
+void PersistentTable::notePartitioningUpdate(const TableTuple &tuple, const TableTuple &newValues) {
+    if (m_partitionColumn == -1 ||
+            tuple.getNValue(m_partitionColumn).compare(newValues.getNValue(m_partitionColumn)) == 0) {
+        return;
+    }
+    TBPtr block = findBlock(tuple.address(), m_data, m_tableAllocationSize);
+    if (block.get() != NULL) {
+        block->setPartitioningEpoch(0);
+    }
+}
+
+void PersistentTable::summarizeZones(TupleBlock *block) {
+    block->clearZones();
+    TableTuple tuple(m_schema);
+    char *address = block->address();
+    const uint32_t boundary = block->unusedTupleBoundry();
+    for (uint32_t ii = 0; ii < boundary; ++ii, address += m_tupleLength) {
+        tuple.move(address);
+        // Rows pending delete may yet be restored, so they count.
+        if (tuple.isActive()) {
+            widenZones(block, tuple);
+        }
+    }
+}
+
+int64_t PersistentTable::summarizeZonesIncrementally(int64_t maxTuples) {
+    if (!m_zonesStale || m_zoneColumns.empty()) {
+        return 0;
+    }
+    int64_t tuplesRead = 0;
+    TBMapI it = m_data.lower_bound(m_zoneResumeAddress);
+    for (size_t blocksLeft = m_data.size(); blocksLeft > 0; --blocksLeft, ++it) {
+        if (it == m_data.end()) {
+            it = m_data.begin();
+        }
+        TupleBlock *block = it.data().get();
+        if (block->zonesValid() || block->isCold()) {
+            continue;
+        }
+        const int64_t slots = block->unusedTupleBoundry();
+        // A whole block at a time, and at least one block a call.
+        if (tuplesRead != 0 && tuplesRead + slots > maxTuples) {
+            m_zoneResumeAddress = it.key();
+            return tuplesRead;
+        }
+        summarizeZones(block);
+        tuplesRead += slots;
+    }
+    m_zonesStale = false;
+    m_zoneResumeAddress = NULL;
+    return tuplesRead;
+}
+
 /**
  * Assumptions:
  *  All tuples will be deleted in storage order.
@@ -1162,6 +1961,7 @@ void PersistentTable::deleteTupleForUndo(char* tupleData, bool skipLookup) {
     // Make sure that they are not trying to delete the same tuple twice
     assert(target.isActive());
 
+    noteTupleChanged(target.address());
     deleteFromAllIndexes(&target);
     deleteTupleFinalize(target); // also frees object columns
 }
@@ -1187,6 +1987,9 @@ TableTuple PersistentTable::lookupTuple(TableTuple tuple, LookupType lookupType)
     }
     else {
         size_t tuple_length;
+        // Bytes of hidden columns at the end of the tuple that are compared
+        // first, as for equalsNoSchemaCheck.
+        size_t hidden_length = 0;
         if (lookupType == LOOKUP_BY_VALUES && m_schema->hiddenColumnCount() > 0) {
             // Looking up a tuple by values should not include any internal
             // hidden column values, which are appended to the end of the
@@ -1195,6 +1998,10 @@ TableTuple PersistentTable::lookupTuple(TableTuple tuple, LookupType lookupType)
         }
         else {
             tuple_length = m_schema->tupleLength();
+            if (lookupType == LOOKUP_FOR_DR && m_schema->hiddenColumnCount() > 0) {
+                hidden_length = tuple_length - m_schema->offsetOfHiddenColumns();
+                tuple_length = m_schema->offsetOfHiddenColumns();
+            }
         }
         // Do an inline tuple byte comparison
         // to avoid matching duplicate tuples with different pointers to Object storage
@@ -1203,7 +2010,8 @@ TableTuple PersistentTable::lookupTuple(TableTuple tuple, LookupType lookupType)
             ti.next(tableTuple);
             char* tableTupleData = tableTuple.address() + TUPLE_HEADER_SIZE;
             char* tupleData = tuple.address() + TUPLE_HEADER_SIZE;
-            if (::memcmp(tableTupleData, tupleData, tuple_length) == 0) {
+            if (::memcmp(tableTupleData + tuple_length, tupleData + tuple_length, hidden_length) == 0 &&
+                ::memcmp(tableTupleData, tupleData, tuple_length) == 0) {
                 return tableTuple;
             }
         }
@@ -1232,21 +2040,41 @@ void PersistentTable::deleteFromAllIndexes(TableTuple *tuple) {
     }
 }
 
-void PersistentTable::tryInsertOnAllIndexes(TableTuple *tuple, TableTuple *conflict) {
+void PersistentTable::tryInsertOnAllIndexes(TableTuple *tuple, TableTuple *conflict,
+                                            TableIndex *alreadyIndexed) {
     for (int i = 0; i < static_cast<int>(m_indexes.size()); ++i) {
+        if (m_indexes[i] == alreadyIndexed) {
+            continue;
+        }
         m_indexes[i]->addEntry(tuple, conflict);
         FAIL_IF(!conflict->isNullTuple()) {
             VOLT_DEBUG("Failed to insert into index %s,%s",
                        m_indexes[i]->getTypeName().c_str(),
                        m_indexes[i]->getName().c_str());
             for (int j = 0; j < i; ++j) {
-                m_indexes[j]->deleteEntry(tuple);
+                if (m_indexes[j] != alreadyIndexed) {
+                    m_indexes[j]->deleteEntry(tuple);
+                }
             }
             return;
         }
     }
 }
 
+void PersistentTable::findUniqueConflict(TableTuple *tuple, TableTuple *conflict) const {
+    BOOST_FOREACH (TableIndex* index, m_indexes) {
+        if (!index->isUniqueIndex()) {
+            continue;
+        }
+        // An upsert has already put the tuple in the primary key index.
+        TableTuple match = index->uniqueMatchingTuple(*tuple);
+        if (!match.isNullTuple() && match.address() != tuple->address()) {
+            conflict->move(match.address());
+            return;
+        }
+    }
+}
+
 bool PersistentTable::checkUpdateOnUniqueIndexes(TableTuple &targetTupleToUpdate,
                                                  const TableTuple &sourceTupleWithNewValues,
                                                  std::vector<TableIndex*> const &indexesToUpdate) {
@@ -1353,6 +2181,31 @@ std::string PersistentTable::debug() {
     return buffer.str();
 }
 
+StringDictionary* const* PersistentTable::stringDictionaries() {
+    if (m_stringDictionaries.empty()) {
+        if (activeTupleCount() < STRING_DICTIONARY_MIN_TUPLES) {
+            return NULL;
+        }
+        // Share the values of non-inlined VARCHAR columns between rows.
+        // Each column's dictionary gives up on its own if the column turns
+        // out to have too many distinct values.
+        const uint16_t uninlinedColumnCount = m_schema->getUninlinedObjectColumnCount();
+        for (uint16_t ii = 0; ii < uninlinedColumnCount; ii++) {
+            int idx = m_schema->getUninlinedObjectColumnInfoIndex(ii);
+            if (m_schema->columnType(idx) == VALUE_TYPE_VARCHAR) {
+                m_stringDictionaries.push_back(new StringDictionary());
+            }
+            else {
+                m_stringDictionaries.push_back(NULL);
+            }
+        }
+        if (m_stringDictionaries.empty()) {
+            return NULL;
+        }
+    }
+    return &m_stringDictionaries[0];
+}
+
 /*
  * Implemented by persistent table and called by Table::loadTuplesFrom
  * to do additional processing for views and Export and non-inline
@@ -1363,11 +2216,17 @@ void PersistentTable::processLoadedTuple(TableTuple &tuple,
                                          int32_t &serializedTupleCount,
                                          size_t &tupleCountPosition,
                                          bool shouldDRStreamRows) {
+    StringDictionary* const* dictionaries = stringDictionaries();
+    if (dictionaries) {
+        tuple.shareObjectColumns(dictionaries);
+    }
     try {
         insertTupleCommon(tuple, tuple, true, shouldDRStreamRows);
     }
     catch (ConstraintFailureException &e) {
         if ( ! uniqueViolationOutput) {
+            // Like a reported violation, the rejected row is not left behind.
+            deleteTupleStorage(tuple);
             throw;
         }
         if (serializedTupleCount == 0) {
@@ -1380,6 +2239,228 @@ void PersistentTable::processLoadedTuple(TableTuple &tuple,
     }
 }
 
+void PersistentTable::prepareToLoadTuples(int tupleCount) {
+    // Snapshot restore and rejoin load a table in large chunks, so growing
+    // each hash index to its final size here saves it the resizes on the way.
+    // A partial index holds only the rows its predicate accepts, which may
+    // be a small fraction, so it is left to grow as it goes.
+    size_t expected = static_cast<size_t>(activeTupleCount()) + tupleCount;
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        if (!index->isPartialIndex()) {
+            index->ensureCapacity(expected);
+        }
+    }
+
+    // A non-unique index can never reject a row, so when the load fills an
+    // empty table each one is left out of the per-batch inserts and built
+    // once at the end, in one sorted pass. The unique indexes stay in to
+    // catch violations. Views may plan scans over this table's indexes as
+    // rows arrive, so tables with views keep all of theirs.
+    if (tupleCount == 0 || activeTupleCount() != 0 || !m_views.empty() || !m_viewHandlers.empty()
+            || m_indexesDeferredForRecovery) {
+        return;
+    }
+    assert(m_indexesBeforeLoad.empty());
+    std::vector<TableIndex*> kept;
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        if (index->isUniqueIndex()) {
+            kept.push_back(index);
+        }
+    }
+    if (kept.size() != m_indexes.size()) {
+        m_indexesBeforeLoad.swap(m_indexes);
+        m_indexes.swap(kept);
+    }
+}
+
+void PersistentTable::finishLoadingTuples() {
+    // A recovery's indexes wait for its last message, not the end of each.
+    if (m_indexesBeforeLoad.empty() || m_indexesDeferredForRecovery) {
+        return;
+    }
+    std::vector<TableIndex*> kept;
+    kept.swap(m_indexes);
+    m_indexes.swap(m_indexesBeforeLoad);
+
+    // A failed load leaves earlier batches in the table for undo to remove,
+    // so the set-aside indexes are built from the table, not from the load.
+    // The rows it took but never inserted are freed before this runs (see
+    // freeUnprocessedTuples), or undo would leave their entries behind.
+    std::vector<TableTuple> tuples;
+    tuples.reserve(activeTupleCount());
+    TableTuple tuple(m_schema);
+    TableIterator iter = iterator();
+    while (iter.next(tuple)) {
+        tuples.push_back(tuple);
+    }
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        if (std::find(kept.begin(), kept.end(), index) != kept.end()) {
+            continue;
+        }
+        index->addEntriesToEmptyIndex(tuples);
+        // Only recovery sets a unique index aside, and its source table
+        // held no duplicates, so none may have been dropped here.
+        if (index->isUniqueIndex() && !index->isPartialIndex() && index->getSize() != tuples.size()) {
+            throwFatalException("Recovered table %s has duplicate keys in index %s",
+                                m_name.c_str(), index->getName().c_str());
+        }
+    }
+}
+
+void PersistentTable::freeUnprocessedTuples(std::vector<TableTuple> &tuples) {
+    BOOST_FOREACH (TableTuple &tuple, tuples) {
+        // deleteTupleStorage takes the string memory back off the count.
+        if (m_schema->getUninlinedObjectColumnCount() != 0) {
+            increaseStringMemCount(tuple.getNonInlinedMemorySize());
+        }
+        deleteTupleStorage(tuple);
+    }
+}
+
+void PersistentTable::processLoadedTupleBatch(std::vector<TableTuple> &tuples,
+                                              ReferenceSerializeOutput *uniqueViolationOutput,
+                                              int32_t &serializedTupleCount,
+                                              size_t &tupleCountPosition,
+                                              bool shouldDRStreamRows) {
+    try {
+        if (insertTupleBatchCommon(tuples, shouldDRStreamRows)) {
+            return;
+        }
+    }
+    catch (TupleStreamException &e) {
+        freeUnprocessedTuples(tuples);
+        throw;
+    }
+    // Find the offending tuples the slow way.
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        try {
+            processLoadedTuple(tuples[ii], uniqueViolationOutput, serializedTupleCount,
+                               tupleCountPosition, shouldDRStreamRows);
+        }
+        catch (...) {
+            // The rest of the batch was never inserted, so none of its
+            // string memory was counted.
+            for (int jj = ii + 1; jj < tuples.size(); jj++) {
+                if (m_schema->getUninlinedObjectColumnCount() != 0) {
+                    increaseStringMemCount(tuples[jj].getNonInlinedMemorySize());
+                }
+                deleteTupleStorage(tuples[jj]);
+            }
+            throw;
+        }
+    }
+}
+
+bool PersistentTable::insertTupleBatchCommon(std::vector<TableTuple> &tuples, bool shouldDRStream) {
+    ExecutorContext *ec = ExecutorContext::getExecutorContext();
+    StringDictionary* const* dictionaries = stringDictionaries();
+    BOOST_FOREACH (TableTuple &tuple, tuples) {
+        if (dictionaries) {
+            tuple.shareObjectColumns(dictionaries);
+        }
+        if (!checkNulls(tuple)) {
+            return false;
+        }
+        if (hasDRTimestampColumn()) {
+            setDRTimestampForTuple(ec, tuple, false);
+        }
+    }
+
+    // Write to DR stream before everything else to ensure nothing gets left in
+    // the index if the append fails.
+    AbstractDRTupleStream *drStream = getDRTupleStream(ec);
+    if (!drStream || m_isMaterialized || !m_drEnabled || !shouldDRStream) {
+        drStream = NULL;
+    }
+    size_t drMark = INVALID_DR_MARK;
+    size_t drRowCost = 0;
+    if (drStream) {
+        const int64_t lastCommittedSpHandle = ec->lastCommittedSpHandle();
+        const int64_t currentSpHandle = ec->currentSpHandle();
+        const int64_t currentUniqueId = ec->currentUniqueId();
+        try {
+            for (int ii = 0; ii < tuples.size(); ii++) {
+                size_t mark = drStream->appendTuple(lastCommittedSpHandle, m_signature, m_partitionColumn, currentSpHandle,
+                                                    currentUniqueId, tuples[ii], DR_RECORD_INSERT);
+                if (ii == 0) {
+                    drMark = mark;
+                }
+                drRowCost += rowCostForDRRecord(DR_RECORD_INSERT);
+            }
+        }
+        catch (TupleStreamException &e) {
+            if (drRowCost != 0) {
+                drStream->rollbackTo(drMark, drRowCost);
+            }
+            throw;
+        }
+    }
+
+    // Fill one index at a time, so each can take the batch in its own
+    // preferred order.
+    std::vector<TableTuple> conflicts(tuples.size(), TableTuple(m_schema));
+    for (int ii = 0; ii < m_indexes.size(); ii++) {
+        if (m_indexes[ii]->addEntries(tuples, conflicts)) {
+            continue;
+        }
+        // Back out of the indexes filled so far, skipping the tuples that
+        // did not make it into the last one.
+        for (int jj = 0; jj <= ii; jj++) {
+            for (int kk = 0; kk < tuples.size(); kk++) {
+                if (jj < ii || conflicts[kk].isNullTuple()) {
+                    m_indexes[jj]->deleteEntry(&tuples[kk]);
+                }
+            }
+        }
+        if (drStream) {
+            drStream->rollbackTo(drMark, drRowCost);
+        }
+        return false;
+    }
+
+    UndoQuantum *uq = ExecutorContext::currentUndoQuantum();
+    if (drStream && uq) {
+        uq->registerUndoAction(new (*uq) DRTupleStreamUndoAction(drStream, drMark, drRowCost));
+    }
+
+    const int tupleLength = m_schema->tupleLength() + TUPLE_HEADER_SIZE;
+    char* undoData = NULL;
+    if (uq) {
+        undoData = reinterpret_cast<char*>(uq->allocateAction(tuples.size() * tupleLength));
+    }
+    for (int ii = 0; ii < tuples.size(); ii++) {
+        TableTuple &target = tuples[ii];
+        if (m_schema->getUninlinedObjectColumnCount() != 0) {
+            increaseStringMemCount(target.getNonInlinedMemorySize());
+        }
+        // See insertTupleCommon.
+        if (m_tableStreamer == NULL || !m_tableStreamer->notifyTupleInsert(target)) {
+            target.setDirtyFalse();
+        }
+        if (undoData) {
+            ::memcpy(undoData + ii * tupleLength, target.address(), tupleLength);
+        }
+    }
+    if (uq) {
+        uq->registerUndoAction(new (*uq) PersistentTableUndoInsertBatchAction(
+                    undoData, static_cast<int>(tuples.size()), tupleLength, &m_surgeon));
+    }
+
+    // The multi-table views join the whole batch with their other source
+    // tables in one run of their delta plans.
+    if (!m_viewHandlers.empty()) {
+        insertTuplesIntoDeltaTable(tuples, true);
+        BOOST_FOREACH (auto viewHandler, m_viewHandlers) {
+            viewHandler->handleTupleInsert(this, true);
+        }
+    }
+    // Each view folds the whole batch into its rows, one write per group.
+    for (int i = 0; i < m_views.size(); i++) {
+        m_views[i]->processTupleInsertBatch(tuples, true);
+    }
+    return true;
+}
+
 /** Prepare table for streaming from serialized data. */
 bool PersistentTable::activateStream(
     TableStreamType streamType,
@@ -1449,6 +2530,7 @@ int64_t PersistentTable::streamMore(TupleOutputStreamProcessor &outputStreams,
 
         return TABLE_STREAM_SERIALIZATION_ERROR;
     }
+    ScopedLatencySample latencySample(LATENCY_COW_STREAM);
     return m_tableStreamer->streamMore(outputStreams, streamType, retPositions);
 }
 
@@ -1463,10 +2545,26 @@ void PersistentTable::processRecoveryMessage(RecoveryProtoMsg* message, Pool *po
             BOOST_FOREACH(TableIndex *index, m_indexes) {
                 index->ensureCapacity(tupleCount);
             }
+            // The tuples come from a consistent copy of the table, and
+            // nothing else runs here until recovery completes, so every
+            // index is left to be built once from the whole table.
+            // Views want the indexes as rows arrive, as in prepareToLoadTuples.
+            if (!m_indexesDeferredForRecovery && m_indexesBeforeLoad.empty()
+                    && m_views.empty() && m_viewHandlers.empty()) {
+                m_indexesBeforeLoad.swap(m_indexes);
+                m_indexesDeferredForRecovery = true;
+            }
         }
         loadTuplesFromNoHeader(*message->stream(), pool);
         break;
     }
+    case RECOVERY_MSG_TYPE_COMPLETE: {
+        if (m_indexesDeferredForRecovery) {
+            m_indexesDeferredForRecovery = false;
+            finishLoadingTuples();
+        }
+        break;
+    }
     default:
         throwFatalException("Attempted to process a recovery message of unknown type %d", message->msgType());
     }
@@ -1513,6 +2611,8 @@ void PersistentTable::notifyBlockWasCompactedAway(TBPtr block) {
 // Call-back from TupleBlock::merge() for each tuple moved.
 void PersistentTable::notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
                                           TableTuple &sourceTuple, TableTuple &targetTuple) {
+    // The target block took a new row.
+    m_zonesStale = true;
     if (m_tableStreamer != NULL) {
         m_tableStreamer->notifyTupleMovement(sourceBlock, targetBlock, sourceTuple, targetTuple);
     }
@@ -1550,7 +2650,7 @@ void PersistentTable::swapTuples(TableTuple &originalTuple,
     }
 }
 
-bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector) {
+bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector, int64_t maxTuplesToMove) {
     /**
      * First find the two best candidate blocks
      */
@@ -1571,7 +2671,8 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector)
     }
 
     int fullestBucketChange = NO_NEW_BUCKET_INDEX;
-    while (fullest->hasFreeTuples()) {
+    int64_t tuplesMoved = 0;
+    while (fullest->hasFreeTuples() && tuplesMoved < maxTuplesToMove) {
         TBPtr lightest;
         TBBucketI lightestIterator;
         bool foundLightest = false;
@@ -1598,7 +2699,13 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector)
             return false;
         }
 
-        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this);
+        uint32_t fullestActiveTuples = fullest->activeTuples();
+        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this,
+                                                           maxTuplesToMove - tuplesMoved);
+        noteBlockChanged(fullest);
+        noteBlockChanged(lightest);
+        tuplesMoved += fullest->activeTuples() - fullestActiveTuples;
+        m_compactedTupleCount += fullest->activeTuples() - fullestActiveTuples;
         int tempFullestBucketChange = bucketChanges.first;
         if (tempFullestBucketChange != NO_NEW_BUCKET_INDEX) {
             fullestBucketChange = tempFullestBucketChange;
@@ -1606,6 +2713,7 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector)
 
         if (lightest->isEmpty()) {
             notifyBlockWasCompactedAway(lightest);
+            noteBlockLeavingCold(lightest);
             m_data.erase(lightest->address());
             m_blocksWithSpace.erase(lightest);
             m_blocksNotPendingSnapshot.erase(lightest);
@@ -1630,6 +2738,7 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector *bucketVector)
 }
 
 void PersistentTable::doIdleCompaction() {
+    ScopedLatencySample latencySample(LATENCY_COMPACTION);
     if (!m_blocksNotPendingSnapshot.empty()) {
         doCompactionWithinSubset(&m_blocksNotPendingSnapshotLoad);
     }
@@ -1638,12 +2747,71 @@ void PersistentTable::doIdleCompaction() {
     }
 }
 
+bool PersistentTable::doIncrementalCompaction(int64_t maxTuplesToMove, int64_t maxMicros) {
+    if (m_appendOnly) {
+        return false;
+    }
+    if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
+        return false;
+    }
+    ScopedLatencySample latencySample(LATENCY_COMPACTION);
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+    const int64_t compactedTupleCountBefore = m_compactedTupleCount;
+    while (compactionPredicate()) {
+        int64_t tuplesMoved = m_compactedTupleCount - compactedTupleCountBefore;
+        if (tuplesMoved >= maxTuplesToMove) {
+            break;
+        }
+        // Check the clock between steps of a bounded size.
+        const int64_t step = std::min(maxTuplesToMove - tuplesMoved, INCREMENTAL_COMPACTION_STEP_TUPLES);
+        const int64_t compactedTupleCountBeforeStep = m_compactedTupleCount;
+        bool hadWork = false;
+        if (!m_blocksNotPendingSnapshot.empty()) {
+            hadWork = doCompactionWithinSubset(&m_blocksNotPendingSnapshotLoad, step);
+        }
+        const int64_t leftInStep = step - (m_compactedTupleCount - compactedTupleCountBeforeStep);
+        if (!m_blocksPendingSnapshot.empty() && leftInStep > 0) {
+            hadWork = doCompactionWithinSubset(&m_blocksPendingSnapshotLoad, leftInStep) || hadWork;
+        }
+        if (!hadWork) {
+            // No blocks are eligible right now -- see doForcedCompaction.
+            // Try again next time rather than spinning here.
+            break;
+        }
+        boost::posix_time::ptime now(boost::posix_time::microsec_clock::universal_time());
+        if ((now - startTime).total_microseconds() >= maxMicros) {
+            break;
+        }
+    }
+    return compactionPredicate();
+}
+
+int64_t PersistentTable::ageTupleBlocks(std::vector<TBPtr> &evictable) {
+    int64_t residentBytes = 0;
+    for (TBMapI iter = m_data.begin(); iter != m_data.end(); ++iter) {
+        TBPtr block = iter.data();
+        block->age();
+        if (block->isCold()) {
+            continue;
+        }
+        residentBytes += block->allocationSize();
+        if (!block->hasFreeTuples()) {
+            evictable.push_back(block);
+        }
+    }
+    return residentBytes;
+}
+
 bool PersistentTable::doForcedCompaction() {
+    if (m_appendOnly) {
+        return false;
+    }
     if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
         LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO,
             "Deferring compaction until recovery is complete.");
         return false;
     }
+    ScopedLatencySample latencySample(LATENCY_COMPACTION);
     bool hadWork1 = true;
     bool hadWork2 = true;
     int64_t notPendingCompactions = 0;
@@ -1707,6 +2875,9 @@ bool PersistentTable::doForcedCompaction() {
     }
 
     assert(!compactionPredicate());
+    BOOST_FOREACH(TableIndex *index, m_indexes) {
+        index->rebuildKeyFilter();
+    }
     boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
     boost::posix_time::time_duration duration = endTime - startTime;
     snprintf(msg, sizeof(msg), "Finished forced compaction of %zd non-snapshot blocks and %zd snapshot blocks with allocated tuple count %zd in %zd ms",
@@ -1767,26 +2938,64 @@ void PersistentTable::printBucketInfo() {
     std::cout << std::endl;
 }
 
-int64_t PersistentTable::validatePartitioning(TheHashinator *hashinator, int32_t partitionId) {
-    TableIterator iter = iterator();
-
+int64_t PersistentTable::validatePartitioning(TheHashinator *hashinator, int32_t partitionId,
+                                              int64_t hashinatorEpoch) {
     int64_t mispartitionedRows = 0;
 
-    while (iter.hasNext()) {
-        TableTuple tuple(schema());
-        iter.next(tuple);
-        int32_t newPartitionId = hashinator->hashinate(tuple.getNValue(m_partitionColumn));
-        if (newPartitionId != partitionId) {
-            std::ostringstream buffer;
-            buffer << "@ValidPartitioning found a mispartitioned row (hash: "
-                    << m_surgeon.generateTupleHash(tuple)
-                    << " should in "<< partitionId
-                    << ", but in " << newPartitionId << "):\n"
-                    << tuple.debug(name())
-                    << std::endl;
-            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
-                    buffer.str().c_str());
-            mispartitionedRows++;
+    // Only the rows of blocks changed since they were last found correct
+    // under the same hashinator are checked, a batch of rows at a time.
+    const int32_t batchSize = 256;
+    std::vector<TableTuple> tuples;
+    std::vector<NValue> values;
+    std::vector<int32_t> partitions(batchSize);
+    tuples.reserve(batchSize);
+    values.reserve(batchSize);
+    TableTuple tuple(schema());
+    for (TBMapI blockIter = m_data.begin(); blockIter != m_data.end(); ++blockIter) {
+        TBPtr block = blockIter.data();
+        if (block->activeTuples() == 0 ||
+                (hashinatorEpoch != 0 && block->partitioningEpoch() == hashinatorEpoch)) {
+            continue;
+        }
+        block->noteScan();
+        const int64_t mispartitionedBefore = mispartitionedRows;
+        const uint32_t boundary = block->unusedTupleBoundry();
+        for (uint32_t slot = 0; slot <= boundary; slot++) {
+            if (slot < boundary) {
+                tuple.move(block->address() + slot * m_tupleLength);
+                if (!tuple.isActive() || tuple.isPendingDelete() || tuple.isPendingDeleteOnUndoRelease()) {
+                    continue;
+                }
+                tuples.push_back(tuple);
+                values.push_back(tuple.getNValue(m_partitionColumn));
+                if (tuples.size() < batchSize) {
+                    continue;
+                }
+            }
+            if (tuples.empty()) {
+                continue;
+            }
+            hashinator->hashinate(&values[0], static_cast<int32_t>(values.size()), &partitions[0]);
+            for (int ii = 0; ii < tuples.size(); ii++) {
+                int32_t newPartitionId = partitions[ii];
+                if (newPartitionId != partitionId) {
+                    std::ostringstream buffer;
+                    buffer << "@ValidPartitioning found a mispartitioned row (hash: "
+                            << m_surgeon.generateTupleHash(tuples[ii])
+                            << " should in "<< partitionId
+                            << ", but in " << newPartitionId << "):\n"
+                            << tuples[ii].debug(name())
+                            << std::endl;
+                    LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
+                            buffer.str().c_str());
+                    mispartitionedRows++;
+                }
+            }
+            tuples.clear();
+            values.clear();
+        }
+        if (mispartitionedRows == mispartitionedBefore) {
+            block->setPartitioningEpoch(hashinatorEpoch);
         }
     }
     if (mispartitionedRows > 0) {
@@ -1804,6 +3013,10 @@ int64_t PersistentTable::validatePartitioning(TheHashinator *hashinator, int32_t
 }
 
 void PersistentTableSurgeon::activateSnapshot() {
+    // Writes from here on are to blocks changed since this snapshot.
+    ++m_table.m_snapshotGeneration;
+    m_table.m_changedBlockCount = 0;
+
     TBMapI blockIterator = m_table.m_data.begin();
 
     // Persistent table should have minimum of one block in it's block map.
@@ -1911,8 +3124,20 @@ void PersistentTable::addIndex(TableIndex *index) {
     // fill the index with tuples... potentially the slow bit
     TableTuple tuple(m_schema);
     TableIterator iter = iterator();
-    while (iter.next(tuple)) {
-        index->addEntry(&tuple, NULL);
+    if (index->getSize() == 0) {
+        // Hand the index all of the tuples at once so that it can build
+        // itself in bulk rather than one entry at a time.
+        std::vector<TableTuple> tuples;
+        tuples.reserve(activeTupleCount());
+        while (iter.next(tuple)) {
+            tuples.push_back(tuple);
+        }
+        index->addEntriesToEmptyIndex(tuples);
+    }
+    else {
+        while (iter.next(tuple)) {
+            index->addEntry(&tuple, NULL);
+        }
     }
 
     // add the index to the table
@@ -1968,7 +3193,10 @@ void PersistentTable::configureIndexStats() {
     BOOST_FOREACH(TableIndex *index, m_indexes) {
         index->getIndexStats()->configure(index->getName() + " stats",
                                           name());
+        index->getIndexUsageStats()->configure(index->getName() + " usage stats",
+                                               name());
     }
+    m_scanUsageStats.configure(name() + " scan usage stats", name());
 }
 
 void PersistentTable::addViewHandler(MaterializedViewHandler *viewHandler) {
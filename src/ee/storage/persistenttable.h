@@ -46,6 +46,8 @@
 #ifndef HSTOREPERSISTENTTABLE_H
 #define HSTOREPERSISTENTTABLE_H
 
+#include <algorithm>
+#include <deque>
 #include <string>
 #include <vector>
 #include <cassert>
@@ -63,6 +65,7 @@
 #include "storage/ExportTupleStream.h"
 #include "storage/TableStats.h"
 #include "storage/PersistentTableStats.h"
+#include "indexes/IndexUsageStats.h"
 #include "storage/TableStreamerInterface.h"
 #include "storage/RecoveryContext.h"
 #include "storage/ElasticIndex.h"
@@ -72,6 +75,7 @@
 
 class CompactionTest_BasicCompaction;
 class CompactionTest_CompactionWithCopyOnWrite;
+class CompactionTest_IncrementalCompaction;
 class CopyOnWriteTest;
 
 namespace catalog {
@@ -111,6 +115,10 @@ public:
     void deleteTupleForUndo(char* tupleData, bool skipLookup = false);
     void deleteTupleRelease(char* tuple);
     void deleteTupleStorage(TableTuple &tuple, TBPtr block = TBPtr(NULL));
+    // Delete many tuples at once, with one undo action for the batch.
+    // Used to drop a hash range that has moved to another partition.
+    void deleteTupleBatch(std::vector<TableTuple> &tuples);
+    void deleteTupleBatchRelease(char** tuples, int tupleCount);
 
     size_t getSnapshotPendingBlockCount() const;
     size_t getSnapshotPendingLoadBlockCount() const;
@@ -143,6 +151,7 @@ public:
     boost::shared_ptr<ElasticIndexTupleRangeIterator>
             getIndexTupleRangeIterator(const ElasticIndexHashRange &range);
     void activateSnapshot();
+    void addSnapshotCopyMemory(int64_t bytes);
     void printIndex(std::ostream &os, int32_t limit) const;
     ElasticHash generateTupleHash(TableTuple &tuple) const;
 
@@ -205,6 +214,7 @@ class PersistentTable : public Table, public UndoQuantumReleaseInterest,
     friend class ::CopyOnWriteTest;
     friend class ::CompactionTest_BasicCompaction;
     friend class ::CompactionTest_CompactionWithCopyOnWrite;
+    friend class ::CompactionTest_IncrementalCompaction;
     friend class CoveringCellIndexTest_TableCompaction;
     friend class MaterializedViewHandler;
     friend class ScopedDeltaTableContext;
@@ -228,8 +238,9 @@ public:
     }
 
     void notifyQuantumRelease() {
-        if (compactionPredicate()) {
-            doForcedCompaction();
+        if ( ! m_appendOnly && compactionPredicate()) {
+            doIncrementalCompaction(QUANTUM_RELEASE_COMPACTION_MAX_TUPLES,
+                                    QUANTUM_RELEASE_COMPACTION_MAX_MICROS);
         }
     }
 
@@ -263,6 +274,8 @@ public:
     // and/or adds a materialized view.
     // Constraint checks are bypassed and the change does not make use of "undo" support.
     void deleteTuple(TableTuple &tuple, bool fallible=true);
+    // Delete many tuples at once, with one undo action for the batch.
+    void deleteTupleBatch(std::vector<TableTuple> &tuples);
     // TODO: change meaningless bool return type to void (starting in class Table) and migrate callers.
     virtual bool insertTuple(TableTuple &tuple);
     // Optimized version of update that only updates specific indexes.
@@ -284,6 +297,23 @@ public:
                                         bool fallible=true,
                                         bool updateDRTimestamp=true);
 
+    /*
+     * Whether an update that sets only these columns can be made by
+     * updateTupleInPlace. The columns must be fixed-width, in no index and
+     * not the partition column, and the table must have no views and no
+     * DR, which need the whole row as it was and as it will be.
+     */
+    bool canUpdateInPlace(std::vector<int> const &columns) const;
+
+    /*
+     * Copies the columns from source into target in place. The undo image
+     * is just the old bytes spanning the columns. Only for updates that
+     * canUpdateInPlace allows.
+     */
+    void updateTupleInPlace(TableTuple &targetTupleToUpdate,
+                            TableTuple const &sourceTupleWithNewValues,
+                            std::vector<int> const &columns);
+
     // ------------------------------------------------------------------
     // INDEXES
     // ------------------------------------------------------------------
@@ -316,6 +346,26 @@ public:
 
     void insertPersistentTuple(TableTuple &source, bool fallible, bool ignoreTupleLimit=false);
 
+    /*
+     * Inserts copies of the sources, ignoring the tuple limit, as one batch
+     * through insertTupleBatchCommon. Returns false, leaving the table as
+     * it was, if any of them violates a constraint, so the caller can insert
+     * them one at a time instead.
+     */
+    bool insertPersistentTupleBatch(std::vector<TableTuple> &sources);
+
+    /*
+     * Inserts a copy of source or, if a row with the same primary key
+     * exists, sets that row's setColumns to the values in source, updating
+     * only indexesToUpdate (the primary key index need not be among them).
+     * The primary key index is searched once, by entering source itself
+     * and taking the row it conflicts with. A table slot is only taken for
+     * a new row, whose entry is then pointed at it.
+     * Returns true if source was inserted.
+     */
+    bool upsertTuple(TableTuple &source, std::vector<int> const &setColumns,
+                     std::vector<TableIndex*> const &indexesToUpdate);
+
     /// This is not used in any production code path -- it is a convenient wrapper used by tests.
     bool updateTuple(TableTuple &targetTupleToUpdate, TableTuple &sourceTupleWithNewValues) {
         updateTupleWithSpecificIndexes(targetTupleToUpdate, sourceTupleWithNewValues, m_indexes, true);
@@ -394,7 +444,9 @@ public:
                        std::vector<int> &retPositions);
 
     /**
-     * Process the updates from a recovery message
+     * Process the updates from a recovery message. Tuples recovered into
+     * an empty table are not indexed until the RECOVERY_MSG_TYPE_COMPLETE
+     * message, which builds every index in bulk.
      */
     void processRecoveryMessage(RecoveryProtoMsg* message, Pool *pool);
 
@@ -410,6 +462,91 @@ public:
 
     void doIdleCompaction();
 
+    /**
+     * Compact blocks until the compaction predicate is satisfied, or until
+     * at most maxTuplesToMove tuples have been moved or maxMicros
+     * microseconds have been spent, whichever comes first. Each step moves
+     * tuples the same way doForcedCompaction does, notifying the table
+     * streamers of the moves, so a compaction spread over many calls is
+     * safe with COW and elastic contexts active.
+     * Returns true if there is compaction work left for a later call.
+     */
+    bool doIncrementalCompaction(int64_t maxTuplesToMove, int64_t maxMicros);
+
+    // The budgets for the compaction done each time an undo quantum is
+    // released, which is on the latency path of the next transaction, and
+    // for the compaction done on the once-per-second engine tick.
+    static const int64_t QUANTUM_RELEASE_COMPACTION_MAX_TUPLES = 4096;
+    static const int64_t QUANTUM_RELEASE_COMPACTION_MAX_MICROS = 500;
+    static const int64_t TICK_COMPACTION_MAX_TUPLES = 131072;
+    static const int64_t TICK_COMPACTION_MAX_MICROS = 10000;
+
+    /**
+     * Free the strings and tuple blocks of a table that is about to be
+     * deleted, at most maxBytes of blocks at a time, so that a big table
+     * dropped by a truncate goes back to the allocator over several ticks
+     * instead of stalling the site. The table must not be used again except
+     * to call this and then delete it. Returns true once every block is gone.
+     */
+    bool freeBlocksIncrementally(int64_t maxBytes);
+
+    // The blocks of truncated tables freed each engine tick. Tables with
+    // fewer are freed at once, when the truncate is released.
+    static const int64_t TICK_RECLAIM_MAX_BYTES = 256 * 1024 * 1024;
+
+    // The number of tuples moved by compaction over the life of the table.
+    int64_t compactedTupleCount() const {
+        return m_compactedTupleCount;
+    }
+
+    /**
+     * Start a new cold storage eviction pass over the table's blocks.
+     * Adds the resident blocks that could be evicted -- the full ones, so
+     * never a block that is taking inserts -- to evictable, and returns
+     * the bytes of the table's blocks that are still in memory.
+     */
+    int64_t ageTupleBlocks(std::vector<TBPtr> &evictable);
+
+    void noteBlockEviction(const TBPtr &block) {
+        ++m_blockEvictionCount;
+        m_coldTupleMemory += block->allocationSize();
+    }
+
+    // The number of blocks written out to cold storage over the life of the table.
+    int64_t blockEvictionCount() const {
+        return m_blockEvictionCount;
+    }
+
+    // The bytes of the table's blocks that are in cold storage, kept as
+    // blocks go out and come back so the table stats need not walk them.
+    int64_t coldTupleMemory() const {
+        return m_coldTupleMemory;
+    }
+
+    /**
+     * The number of snapshots started on the table. A block whose change
+     * generation is at least g was written to after snapshot g began, so
+     * those are the blocks a later snapshot would have to add to it.
+     */
+    int64_t snapshotGeneration() const {
+        return m_snapshotGeneration;
+    }
+
+    /**
+     * The blocks inserted into, updated, deleted from or compacted since the
+     * last snapshot began, including those since freed. Before the first
+     * snapshot, every block.
+     */
+    int64_t changedBlockCount() const {
+        return m_snapshotGeneration == 0 ? static_cast<int64_t>(m_data.size()) : m_changedBlockCount;
+    }
+
+    // The bytes of block copies the running snapshot holds so that it can
+    // stream the blocks as they were when it began.
+    int64_t snapshotCopyMemory() const {
+        return m_snapshotCopyMemory;
+    }
+
     void printBucketInfo();
 
     void increaseStringMemCount(size_t bytes) {
@@ -420,6 +557,17 @@ public:
         m_nonInlinedMemorySize -= bytes;
     }
 
+    // Includes the strings shared through the columns' dictionaries.
+    int64_t nonInlinedMemorySize() const {
+        int64_t bytes = m_nonInlinedMemorySize;
+        for (int ii = 0; ii < m_stringDictionaries.size(); ii++) {
+            if (m_stringDictionaries[ii]) {
+                bytes += m_stringDictionaries[ii]->getAllocatedMemory();
+            }
+        }
+        return bytes;
+    }
+
     size_t allocatedBlockCount() const {
         return m_data.size();
     }
@@ -452,6 +600,86 @@ public:
 
     void setTupleLimit(int32_t newLimit) { m_tupleLimit = newLimit; }
 
+    /**
+     * Rows expire ttlSeconds after the TIMESTAMP in ttlColumn, and are
+     * deleted by expireRows(), at most batchSize at a time. A ttlColumn
+     * of -1 turns expiration off.
+     */
+    void setTimeToLive(int ttlColumn, int32_t ttlSeconds, int32_t batchSize) {
+        m_ttlColumn = ttlColumn;
+        m_ttlMicros = static_cast<int64_t>(ttlSeconds) * 1000000;
+        m_ttlBatchSize = batchSize;
+    }
+
+    bool hasTimeToLive() const { return m_ttlColumn >= 0; }
+
+    /**
+     * Delete up to the TTL batch size of the rows that have expired by
+     * nowMicros, oldest first, found through an ordered index led by the
+     * TTL column. Meant for the engine tick, between transactions: the
+     * deletes have no undo and free whole blocks when they empty them.
+     * Returns the number of rows deleted.
+     */
+    int32_t expireRows(int64_t nowMicros);
+
+    /**
+     * An append-only table inserts only into the block it allocated last,
+     * so its blocks hold rows in the order they came, and the space deletes
+     * leave in older blocks is never reused: a block goes when it empties,
+     * and the table is never compacted. Its rows expire a block at a time,
+     * in insertion order, with no index. May only change while empty.
+     */
+    void setAppendOnly(bool appendOnly);
+
+    bool isAppendOnly() const { return m_appendOnly; }
+
+    /**
+     * A clustered table keeps its rows in about primary key order, so that
+     * range scans of the primary key read its blocks in order rather than
+     * all over the table. See clusterIncrementally().
+     */
+    void setClustered(bool clustered);
+
+    bool isClustered() const { return m_clustered; }
+
+    /**
+     * Move up to maxTuplesToMove rows of a clustered table, in primary key
+     * order, into blocks that take no other inserts. A pass over the table
+     * starts once the rows inserted since the last one reach a quarter of
+     * it, and each call resumes after the last key it moved. Rows inserted
+     * below that key wait for the next pass. Blocks the pass empties are
+     * let go. Moves tuples, so is meant for the engine tick with no undo
+     * pending. Needs an ordered primary key with inlined keys. Returns the
+     * number of rows moved.
+     */
+    int64_t clusterIncrementally(int64_t maxTuplesToMove);
+
+    // The rows moved into primary key order each engine tick, over all tables
+    static const int64_t TICK_CLUSTER_MAX_TUPLES = 65536;
+
+    /**
+     * The zone map each block keeps of the column, or -1 if there is none.
+     * The zone maps are the least and greatest value of up to
+     * TupleBlock::MAX_ZONE_COLUMNS integer columns, timestamps first, so
+     * that scans with ranges on them can pass over blocks with no row in
+     * range. Materialized views have none.
+     */
+    int zoneOfColumn(int column) const {
+        return m_zoneOfColumn[column];
+    }
+
+    /**
+     * Summarize the blocks whose zone maps went stale with new rows until
+     * maxTuples slots have been read, resuming where the last call stopped.
+     * Blocks in cold storage are left stale. An update's undo writes back
+     * values the summary may no longer cover, so this is meant for the
+     * engine tick with no undo pending. Returns the number of slots read.
+     */
+    int64_t summarizeZonesIncrementally(int64_t maxTuples);
+
+    // The slots read for zone maps each engine tick, over all tables
+    static const int64_t TICK_ZONE_MAX_TUPLES = 262144;
+
     bool isPersistentTableEmpty() const {
         // The narrow usage of this function (while updating the catalog)
         // suggests that it could also mean "table is new and never had tuples".
@@ -462,7 +690,8 @@ public:
         return m_tupleCount == 0;
     }
 
-    virtual int64_t validatePartitioning(TheHashinator *hashinator, int32_t partitionId);
+    virtual int64_t validatePartitioning(TheHashinator *hashinator, int32_t partitionId,
+                                         int64_t hashinatorEpoch = 0);
 
     void truncateTableForUndo(VoltDBEngine * engine, TableCatalogDelegate * tcd, PersistentTable *originalTable);
     void truncateTableRelease(PersistentTable *originalTable);
@@ -501,7 +730,25 @@ public:
      * when the table's row limit will be exceeded.
      */
     bool hasPurgeFragment() const {
-        return m_purgeExecutorVector.get() != NULL;
+        return m_purgeExecutorVector.get() != NULL || ! m_purgePlan.empty();
+    }
+
+    /**
+     * Sets the compressed, base64 encoded plan of the purge fragment,
+     * or removes the fragment when the plan is empty.  The plan is only
+     * parsed when the fragment first runs, so a table that never reaches
+     * its row limit never pays for it.  Any executor vector built from
+     * an earlier plan is dropped, as the tables it refers to may have
+     * changed.
+     */
+    void setPurgePlan(const std::string& plan) {
+        boost::shared_ptr<ExecutorVector> nullPtr;
+        m_purgeExecutorVector.swap(nullPtr);
+        m_purgePlan = plan;
+    }
+
+    const std::string& getPurgePlan() const {
+        return m_purgePlan;
     }
 
     /**
@@ -514,7 +761,8 @@ public:
     }
 
     /**
-     * Returns the purge executor vector for this table
+     * Returns the purge executor vector for this table, which is NULL
+     * until the purge plan has been parsed.
      */
     boost::shared_ptr<ExecutorVector> getPurgeExecutorVector() {
         assert(hasPurgeFragment());
@@ -530,6 +778,9 @@ public:
     // STATS
     TableStats* getTableStats() {  return &m_stats; };
 
+    /** The table's sequential scans, next to the usage of its indexes. */
+    IndexUsageStats* getScanUsageStats() { return &m_scanUsageStats; }
+
     std::vector<uint64_t> getBlockAddresses() const;
 
 private:
@@ -579,12 +830,13 @@ private:
     }
 
     void nextFreeTuple(TableTuple *tuple);
-    bool doCompactionWithinSubset(TBBucketPtrVector *bucketVector);
+    bool doCompactionWithinSubset(TBBucketPtrVector *bucketVector, int64_t maxTuplesToMove = INT64_MAX);
     bool doForcedCompaction();  // Returns true if a compaction was performed
 
     void insertIntoAllIndexes(TableTuple *tuple);
     void deleteFromAllIndexes(TableTuple *tuple);
-    void tryInsertOnAllIndexes(TableTuple *tuple, TableTuple *conflict);
+    void tryInsertOnAllIndexes(TableTuple *tuple, TableTuple *conflict, TableIndex *alreadyIndexed = NULL);
+    void findUniqueConflict(TableTuple *tuple, TableTuple *conflict) const;
     bool checkUpdateOnUniqueIndexes(TableTuple &targetTupleToUpdate,
                                     const TableTuple &sourceTupleWithNewValues,
                                     std::vector<TableIndex*> const &indexesToUpdate);
@@ -599,11 +851,55 @@ private:
 
     void swapTuples(TableTuple &sourceTupleWithNewValues, TableTuple &destinationTuple);
 
+    // Stamp a block that is being written to with the current snapshot
+    // generation. Nothing is tracked before the table's first snapshot.
+    void noteBlockChanged(const TBPtr &block) {
+        if (m_snapshotGeneration != 0 && block->changeGeneration() != m_snapshotGeneration) {
+            block->setChangeGeneration(m_snapshotGeneration);
+            ++m_changedBlockCount;
+        }
+    }
+
+    // Take a block that is coming back from cold storage, or being
+    // released, out of the cold bytes.
+    void noteBlockLeavingCold(const TBPtr &block) {
+        if (block->isCold()) {
+            m_coldTupleMemory -= block->allocationSize();
+        }
+    }
+
+    // Take a block being released out of an append-only table's insertion order.
+    void noteBlockReleased(const TBPtr &block) {
+        if (m_appendOnly) {
+            m_appendedBlocks.erase(std::find(m_appendedBlocks.begin(), m_appendedBlocks.end(), block));
+        }
+    }
+
+    int32_t expireAppendedRows(int64_t expiry);
+
+    void endClusterPass();
+
+    // Widen the zone maps of the block holding the tuple to the values of
+    // newValues, if any of its zone map columns are about to change.
+    void noteZoneUpdate(const TableTuple &tuple, const TableTuple &newValues);
+    void widenZones(TupleBlock *block, const TableTuple &tuple);
+    // Forget that the block was found correctly partitioned if the update
+    // changes the tuple's partitioning value.
+    void notePartitioningUpdate(const TableTuple &tuple, const TableTuple &newValues);
+    void summarizeZones(TupleBlock *block);
+
+    void noteTupleChanged(char *tuple) {
+        if (m_snapshotGeneration != 0) {
+            noteBlockChanged(findBlock(tuple, m_data, m_tableAllocationSize));
+        }
+    }
+
     // The source tuple is used to create the ConstraintFailureException if one
     // occurs. In case of exception, target tuple should be released, but the
     // source tuple's memory should still be retained until the exception is
     // handled.
-    void insertTupleCommon(TableTuple &source, TableTuple &target, bool fallible, bool shouldDRStream = true);
+    void insertTupleCommon(TableTuple &source, TableTuple &target, bool fallible, bool shouldDRStream = true,
+                           TableIndex *alreadyIndexed = NULL);
     void insertTupleForUndo(char *tuple);
     void updateTupleForUndo(char* targetTupleToUpdate,
                             char* sourceTupleWithNewValues,
@@ -611,11 +907,15 @@ private:
     void deleteTupleForUndo(char* tupleData, bool skipLookup = false);
     void deleteTupleRelease(char* tuple);
     void deleteTupleFinalize(TableTuple &tuple);
+    void deleteTupleBatchRelease(char** tuples, int tupleCount);
+    void deleteTupleBatchFinalize(char** tuples, int tupleCount);
     /**
      * Normally this will return the tuple storage to the free list.
      * In the memcheck build it will return the storage to the heap.
      */
     void deleteTupleStorage(TableTuple &tuple, TBPtr block = TBPtr(NULL), bool deleteLastEmptyBlock = false);
+    // The block half of deleteTupleStorage, for a tuple already moved or freed.
+    void releaseTupleSlot(char *address, TBPtr block, bool deleteLastEmptyBlock);
 
     /*
      * Implemented by persistent table and called by Table::loadTuplesFrom
@@ -627,6 +927,44 @@ private:
                                     size_t &tupleCountPosition,
                                     bool shouldDRStreamRows);
 
+    /*
+     * Pre-sizes the indexes for the rows being loaded. When the table starts
+     * out empty, its non-unique indexes are also set aside for the load.
+     */
+    virtual void prepareToLoadTuples(int tupleCount);
+
+    /*
+     * Puts back any indexes set aside by prepareToLoadTuples and builds each
+     * of them in bulk from the loaded tuples.
+     */
+    virtual void finishLoadingTuples();
+
+    /*
+     * Frees tuples taken from nextFreeTuple that were never inserted, so
+     * none of their string memory was counted.
+     */
+    virtual void freeUnprocessedTuples(std::vector<TableTuple> &tuples);
+
+    /*
+     * Inserts a batch of loaded tuples together when none of them violates
+     * a constraint, otherwise falls back to processLoadedTuple for each.
+     * If it throws, each tuple of the batch has been inserted or freed.
+     */
+    virtual void processLoadedTupleBatch(std::vector<TableTuple> &tuples,
+                                         ReferenceSerializeOutput *uniqueViolationOutput,
+                                         int32_t &serializedTupleCount,
+                                         size_t &tupleCountPosition,
+                                         bool shouldDRStreamRows);
+
+    /*
+     * Bulk version of insertTupleCommon for tuples already in the table's
+     * storage. Each index is filled for the whole batch in turn, and the
+     * batch gets one undo action and one DR undo action.
+     * Returns false, leaving the table as it was, if any of the tuples
+     * violates a constraint.
+     */
+    bool insertTupleBatchCommon(std::vector<TableTuple> &tuples, bool shouldDRStream);
+
     enum LookupType {
         LOOKUP_BY_VALUES,
         LOOKUP_FOR_DR,
@@ -657,6 +995,10 @@ private:
     // Insert the source tuple into this table's delta table.
     // If there is no delta table affiliated with this table, then take no action.
     void insertTupleIntoDeltaTable(TableTuple &source, bool fallible);
+    // Fill this table's delta table with a whole batch of inserted tuples, so
+    // that each view handler runs its delta plan once for the batch.
+    void insertTuplesIntoDeltaTable(std::vector<TableTuple> &sources, bool fallible);
+    void clearDeltaTable(bool fallible);
 
     // CONSTRAINTS
     std::vector<bool> m_allowNulls;
@@ -667,15 +1009,48 @@ private:
     // table row count limit
     int m_tupleLimit;
 
+    // time to live: the TIMESTAMP column rows expire by, or -1 for none
+    int m_ttlColumn;
+    int64_t m_ttlMicros;
+    int32_t m_ttlBatchSize;
+
+    // See setAppendOnly(). The blocks of an append-only table, oldest first.
+    bool m_appendOnly;
+    std::deque<TBPtr> m_appendedBlocks;
+
+    // See clusterIncrementally(): the rows inserted since the last pass
+    // started, and, while a pass is under way, the key of the last row it
+    // moved and the block it is filling.
+    bool m_clustered;
+    int64_t m_unclusteredTupleCount;
+    bool m_clusterPassActive;
+    StandAloneTupleStorage m_clusterResumeKey;
+    TBPtr m_clusterBlock;
+
+    // See zoneOfColumn(): the offset and width of each zone map column,
+    // whether new rows may have left any block's zone maps stale, and the
+    // block summarizeZonesIncrementally() resumes from.
+    struct ZoneColumn {
+        uint32_t offset;
+        uint32_t width;
+    };
+    std::vector<ZoneColumn> m_zoneColumns;
+    std::vector<int> m_zoneOfColumn;
+    bool m_zonesStale;
+    char *m_zoneResumeAddress;
+
     // Executor vector to be executed when imminent insert will exceed
     // tuple limit
     boost::shared_ptr<ExecutorVector> m_purgeExecutorVector;
+    // The plan m_purgeExecutorVector is built from, on first use
+    std::string m_purgePlan;
 
     // list of materialized views that are sourced from this table
     std::vector<MaterializedViewTriggerForWrite*> m_views;
 
     // STATS
     PersistentTableStats m_stats;
+    IndexUsageStats m_scanUsageStats;
 
     // STORAGE TRACKING
 
@@ -699,6 +1074,14 @@ private:
     // pointers to chunks of data. Specific to table impl. Don't leak this type.
     TBMap m_data;
     int m_failedCompactionCount;
+    int64_t m_compactedTupleCount;
+    int64_t m_blockEvictionCount;
+    int64_t m_coldTupleMemory;
+
+    // See snapshotGeneration() and changedBlockCount().
+    int64_t m_snapshotGeneration;
+    int64_t m_changedBlockCount;
+    int64_t m_snapshotCopyMemory;
 
     // This is a testability feature not intended for use in product logic.
     int m_invisibleTuplesPendingDeleteCount;
@@ -728,6 +1111,15 @@ private:
     std::vector<TableIndex*> m_uniqueIndexes;
     TableIndex *m_pkeyIndex;
 
+    // All of the indexes, in order, while a load into an empty table leaves
+    // the non-unique ones out of m_indexes, or recovery leaves them all
+    // out. Empty otherwise.
+    std::vector<TableIndex*> m_indexesBeforeLoad;
+
+    // Set while recovery messages fill this table from empty, until
+    // RECOVERY_MSG_TYPE_COMPLETE builds its indexes.
+    bool m_indexesDeferredForRecovery;
+
     // If I myself am a view table, I need to maintain a handler to handle the view update work.
     MaterializedViewHandler *m_mvHandler;
     // If I am a source table of a view, I will notify all the relevant view handlers
@@ -742,6 +1134,17 @@ private:
     // (currently defined in MaterializedViewHandler.h) instead.
     PersistentTable *m_deltaTable;
     bool m_deltaTableActive;
+
+    // Shared string values, indexed by uninlined object column.
+    // NULL for the columns whose values are not shared.
+    std::vector<StringDictionary*> m_stringDictionaries;
+
+    // Small tables would spend more on the dictionaries' pools than they
+    // could save, so values are only shared once a table has this many rows.
+    static const int64_t STRING_DICTIONARY_MIN_TUPLES = 1024;
+
+    // Returns NULL while the table's string values are not being shared.
+    StringDictionary* const* stringDictionaries();
 };
 
 inline PersistentTableSurgeon::PersistentTableSurgeon(PersistentTable &table) :
@@ -783,6 +1186,18 @@ inline void PersistentTableSurgeon::deleteTupleStorage(TableTuple &tuple, TBPtr
     m_table.deleteTupleStorage(tuple, block);
 }
 
+inline void PersistentTableSurgeon::deleteTupleBatch(std::vector<TableTuple> &tuples) {
+    m_table.deleteTupleBatch(tuples);
+}
+
+inline void PersistentTableSurgeon::deleteTupleBatchRelease(char** tuples, int tupleCount) {
+    m_table.deleteTupleBatchRelease(tuples, tupleCount);
+}
+
+inline void PersistentTableSurgeon::addSnapshotCopyMemory(int64_t bytes) {
+    m_table.m_snapshotCopyMemory += bytes;
+}
+
 inline size_t PersistentTableSurgeon::getSnapshotPendingBlockCount() const {
     return m_table.getSnapshotPendingBlockCount();
 }
@@ -950,8 +1365,12 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
         --m_invisibleTuplesPendingDeleteCount;
     }
 
+    releaseTupleSlot(tuple.address(), block, deleteLastEmptyBlock);
+}
+
+inline void PersistentTable::releaseTupleSlot(char *address, TBPtr block, bool deleteLastEmptyBlock) {
     if (block.get() == NULL) {
-        block = findBlock(tuple.address(), m_data, m_tableAllocationSize);
+        block = findBlock(address, m_data, m_tableAllocationSize);
         if (block.get() == NULL) {
             throwFatalException("Tried to find a tuple block for a tuple but couldn't find one");
         }
@@ -959,7 +1378,7 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
 
     bool transitioningToBlockWithSpace = !block->hasFreeTuples();
 
-    int retval = block->freeTuple(tuple.address());
+    int retval = block->freeTuple(address);
     if (retval != NO_NEW_BUCKET_INDEX) {
         //Check if if the block is currently pending snapshot
         if (m_blocksNotPendingSnapshot.find(block) != m_blocksNotPendingSnapshot.end()) {
@@ -979,6 +1398,8 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
     if (block->isEmpty() && (m_data.size() > 1 || deleteLastEmptyBlock)) {
         // Release the empty block unless it's the only remaining block and caller has requested not to do so.
         // The intent of doing so is to avoid block allocation cost at time tuple insertion into the table
+        noteBlockLeavingCold(block);
+        noteBlockReleased(block);
         m_data.erase(block->address());
         m_blocksWithSpace.erase(block);
         m_blocksNotPendingSnapshot.erase(block);
@@ -986,7 +1407,8 @@ inline void PersistentTable::deleteTupleStorage(TableTuple &tuple, TBPtr block,
         //Eliminates circular reference
         block->swapToBucket(TBBucketPtr());
     }
-    else if (transitioningToBlockWithSpace) {
+    else if (transitioningToBlockWithSpace && ( ! m_appendOnly || block == m_appendedBlocks.back())) {
+        // An append-only table only ever fills its newest block.
         m_blocksWithSpace.insert(block);
     }
 }
@@ -1017,6 +1439,9 @@ inline TBPtr PersistentTable::allocateNextBlock() {
     TBPtr block(new TupleBlock(this, m_blocksNotPendingSnapshotLoad[0]));
     m_data.insert(block->address(), block);
     m_blocksNotPendingSnapshot.insert(block);
+    if (m_appendOnly) {
+        m_appendedBlocks.push_back(block);
+    }
     return block;
 }
 
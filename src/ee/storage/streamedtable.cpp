@@ -142,6 +142,11 @@ bool StreamedTable::insertTuple(TableTuple &source)
         for (int i = 0; i < m_views.size(); i++) {
             m_views[i]->processTupleInsert(source, true);
         }
+        // Rows no export consumer wants take no sequence number and no
+        // space in the stream.
+        if (!m_wrapper->acceptsTuple(source)) {
+            return true;
+        }
         mark = m_wrapper->appendTuple(m_executorContext->m_lastCommittedSpHandle,
                                       m_executorContext->currentSpHandle(),
                                       m_sequenceNo++,
@@ -208,6 +213,13 @@ int64_t StreamedTable::allocatedTupleMemory() const {
     return 0;
 }
 
+size_t StreamedTable::pendingExportBytes() const {
+    if (m_wrapper) {
+        return m_wrapper->pendingByteCount();
+    }
+    return 0;
+}
+
 /**
  * Get the current offset in bytes of the export stream for this Table
  * since startup.
@@ -96,6 +96,9 @@ public:
     //Override and say how many bytes are in Java and C++
     int64_t allocatedTupleMemory() const;
 
+    /** Bytes of export stream blocks still held in C++ */
+    size_t pendingExportBytes() const;
+
 
     /**
      * Get the current offset in bytes of the export stream for this Table
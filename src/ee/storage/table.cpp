@@ -43,9 +43,12 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <thread>
 #include <boost/foreach.hpp>
 #include <boost/scoped_array.hpp>
 
@@ -56,6 +59,7 @@
 #include "common/tabletuple.h"
 #include "common/Pool.hpp"
 #include "common/FatalException.hpp"
+#include "common/SerializableEEException.h"
 #include "indexes/tableindex.h"
 #include "storage/tableiterator.h"
 #include "storage/persistenttable.h"
@@ -439,12 +443,173 @@ bool Table::equals(voltdb::Table *other) {
     return true;
 }
 
+// Loaded tuples are handed on for processing in batches of this many.
+static const int LOAD_TUPLE_BATCH_SIZE = 1024;
+
+void Table::processLoadedTupleBatch(std::vector<TableTuple> &tuples,
+                                    ReferenceSerializeOutput *uniqueViolationOutput,
+                                    int32_t &serializedTupleCount,
+                                    size_t &tupleCountPosition,
+                                    bool shouldDRStreamRow) {
+    BOOST_FOREACH (TableTuple &tuple, tuples) {
+        processLoadedTuple(tuple, uniqueViolationOutput, serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
+    }
+}
+
+// Loads of at least this many rows decode them on the helper threads, if
+// there are any, this many rows at a time.
+static const int STAGED_LOAD_MIN_TUPLES = 16384;
+static const int STAGED_LOAD_BATCH_SIZE = 8192;
+
+int32_t Table::s_loadHelperThreads = 0;
+
+void Table::setLoadHelperThreads(int32_t threads) {
+    if (threads < 0) {
+        threads = 0;
+    }
+    else if (threads > MAX_LOAD_HELPER_THREADS) {
+        threads = MAX_LOAD_HELPER_THREADS;
+    }
+    s_loadHelperThreads = threads;
+}
+
+namespace {
+
+/*
+ * A batch of serialized fixed width rows, decoded into tuple images by
+ * helper threads. Decoding touches neither the table nor the thread local
+ * pools, so it can run while the loading thread inserts the batch before.
+ */
+class StagedTupleBatch {
+public:
+    StagedTupleBatch(const TupleSchema *schema, int tupleLength)
+      : m_schema(schema),
+        m_tupleLength(tupleLength),
+        m_rowLength(static_cast<int>(sizeof(int32_t)) + schema->lengthOfAllVisibleColumns()),
+        m_count(0)
+    { }
+
+    ~StagedTupleBatch() { join(); }
+
+    int rowLength() const { return m_rowLength; }
+    int count() const { return m_count; }
+    const char* tupleAt(int ii) const { return &m_storage[static_cast<size_t>(ii) * m_tupleLength]; }
+
+    void start(const char *rows, int count, int threads) {
+        assert(m_threads.empty());
+        m_count = count;
+        m_storage.resize(static_cast<size_t>(count) * m_tupleLength);
+        const int chunks = std::min(threads, count);
+        m_malformedRows.assign(chunks, -1);
+        int begin = 0;
+        for (int ii = 0; ii < chunks; ++ii) {
+            int end = begin + (count - begin) / (chunks - ii);
+            m_threads.push_back(std::thread(&StagedTupleBatch::decode, this,
+                                            rows, begin, end, &m_malformedRows[ii]));
+            begin = end;
+        }
+    }
+
+    // Wait for the helpers, then reject the batch if any row was malformed.
+    void finish() {
+        join();
+        BOOST_FOREACH(int row, m_malformedRows) {
+            if (row >= 0) {
+                throwSerializableEEException("Loaded row %d of a batch of %d is not %d bytes long",
+                                             row, m_count, m_rowLength - static_cast<int>(sizeof(int32_t)));
+            }
+        }
+    }
+
+private:
+    void decode(const char *rows, int begin, int end, int *malformedRow) {
+        const uint32_t columnsLength = static_cast<uint32_t>(m_rowLength - sizeof(int32_t));
+        TableTuple staged(m_schema);
+        for (int ii = begin; ii < end; ++ii) {
+            const char *row = rows + static_cast<size_t>(ii) * m_rowLength;
+            uint32_t length;
+            ::memcpy(&length, row, sizeof(length));
+            if (ntohl(length) != columnsLength) {
+                *malformedRow = ii;
+                return;
+            }
+            staged.move(&m_storage[static_cast<size_t>(ii) * m_tupleLength]);
+            staged.deserializeFixedWidthFrom(row + sizeof(int32_t));
+        }
+    }
+
+    void join() {
+        BOOST_FOREACH(std::thread &thread, m_threads) {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+    const TupleSchema *m_schema;
+    const int m_tupleLength;
+    const int m_rowLength;
+    int m_count;
+    std::vector<char> m_storage;
+    std::vector<int> m_malformedRows;
+    std::vector<std::thread> m_threads;
+};
+
+}
+
+void Table::loadStagedTuples(SerializeInputBE &serialize_io,
+                             int tupleCount,
+                             ReferenceSerializeOutput *uniqueViolationOutput,
+                             int32_t &serializedTupleCount,
+                             size_t &tupleCountPosition,
+                             bool shouldDRStreamRow) {
+    StagedTupleBatch first(m_schema, m_tupleLength);
+    StagedTupleBatch second(m_schema, m_tupleLength);
+    const size_t rowLength = first.rowLength();
+    int staged = std::min(tupleCount, STAGED_LOAD_BATCH_SIZE);
+    first.start(serialize_io.getRawPointer(staged * rowLength), staged, s_loadHelperThreads);
+
+    TableTuple target(m_schema);
+    std::vector<TableTuple> batch;
+    batch.reserve(LOAD_TUPLE_BATCH_SIZE);
+    StagedTupleBatch *ready = &first;
+    StagedTupleBatch *spare = &second;
+    while (ready != NULL) {
+        ready->finish();
+        // Decode the next batch while this one goes into the table.
+        StagedTupleBatch *following = NULL;
+        if (staged < tupleCount) {
+            int count = std::min(tupleCount - staged, STAGED_LOAD_BATCH_SIZE);
+            spare->start(serialize_io.getRawPointer(count * rowLength), count, s_loadHelperThreads);
+            staged += count;
+            following = spare;
+        }
+        for (int ii = 0; ii < ready->count(); ++ii) {
+            nextFreeTuple(&target);
+            target.setActiveTrue();
+            target.setDirtyFalse();
+            target.setPendingDeleteFalse();
+            target.setPendingDeleteOnUndoReleaseFalse();
+            ::memcpy(target.address() + TUPLE_HEADER_SIZE, ready->tupleAt(ii) + TUPLE_HEADER_SIZE,
+                     m_tupleLength - TUPLE_HEADER_SIZE);
+
+            batch.push_back(target);
+            if (batch.size() == LOAD_TUPLE_BATCH_SIZE || ii == ready->count() - 1) {
+                processLoadedTupleBatch(batch, uniqueViolationOutput, serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
+                batch.clear();
+            }
+        }
+        spare = ready;
+        ready = following;
+    }
+}
+
 void Table::loadTuplesFromNoHeader(SerializeInputBE &serialize_io,
                                    Pool *stringPool,
                                    ReferenceSerializeOutput *uniqueViolationOutput,
                                    bool shouldDRStreamRow) {
     int tupleCount = serialize_io.readInt();
     assert(tupleCount >= 0);
+    prepareToLoadTuples(tupleCount);
 
     TableTuple target(m_schema);
 
@@ -456,17 +621,53 @@ void Table::loadTuplesFromNoHeader(SerializeInputBE &serialize_io,
     if (uniqueViolationOutput != NULL) {
         lengthPosition = uniqueViolationOutput->reserveBytes(4);
     }
-    for (int i = 0; i < tupleCount; ++i) {
-        nextFreeTuple(&target);
-        target.setActiveTrue();
-        target.setDirtyFalse();
-        target.setPendingDeleteFalse();
-        target.setPendingDeleteOnUndoReleaseFalse();
-
-        target.deserializeFrom(serialize_io, stringPool);
-
-        processLoadedTuple(target, uniqueViolationOutput, serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
+    // Rows of a fixed width, with no hidden columns to read past them, can
+    // be found and decoded without the pools, so off the loading thread.
+    const bool staged = s_loadHelperThreads > 0 && tupleCount >= STAGED_LOAD_MIN_TUPLES &&
+                        m_schema->hasFixedWidthSerialization() && m_schema->hiddenColumnCount() == 0;
+    try {
+        if (staged) {
+            loadStagedTuples(serialize_io, tupleCount, uniqueViolationOutput,
+                             serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
+        }
+        else {
+            std::vector<TableTuple> batch;
+            batch.reserve(std::min(tupleCount, LOAD_TUPLE_BATCH_SIZE));
+            const uint16_t uninlinedCount = m_schema->getUninlinedObjectColumnCount();
+            for (int i = 0; i < tupleCount; ++i) {
+                try {
+                    nextFreeTuple(&target);
+                    target.setActiveTrue();
+                    target.setDirtyFalse();
+                    target.setPendingDeleteFalse();
+                    target.setPendingDeleteOnUndoReleaseFalse();
+                    // A slot may hold a freed row's object pointers. Clear
+                    // them so a row that fails to deserialize can be freed.
+                    for (int j = 0; j < uninlinedCount; ++j) {
+                        int col = m_schema->getUninlinedObjectColumnInfoIndex(j);
+                        target.setNValue(col, NValue::getNullValue(m_schema->columnType(col)));
+                    }
+                    batch.push_back(target);
+
+                    target.deserializeFrom(serialize_io, stringPool);
+                }
+                catch (...) {
+                    freeUnprocessedTuples(batch);
+                    throw;
+                }
+
+                if (batch.size() == LOAD_TUPLE_BATCH_SIZE || i == tupleCount - 1) {
+                    processLoadedTupleBatch(batch, uniqueViolationOutput, serializedTupleCount, tupleCountPosition, shouldDRStreamRow);
+                    batch.clear();
+                }
+            }
+        }
+    }
+    catch (...) {
+        finishLoadingTuples();
+        throw;
     }
+    finishLoadingTuples();
 
     //If unique constraints are being handled, write the length/size of constraints that occured
     if (uniqueViolationOutput != NULL) {
@@ -113,6 +113,10 @@ class Table {
         }
     }
 
+    int32_t refcount() const {
+        return m_refcount;
+    }
+
     // ------------------------------------------------------------------
     // ACCESS METHODS
     // ------------------------------------------------------------------
@@ -154,7 +158,7 @@ class Table {
     }
 
     // Only counts persistent table usage, currently
-    int64_t nonInlinedMemorySize() const {
+    virtual int64_t nonInlinedMemorySize() const {
         return m_nonInlinedMemorySize;
     }
 
@@ -229,6 +233,15 @@ class Table {
                         ReferenceSerializeOutput *uniqueViolationOutput = NULL,
                         bool shouldDRStreamRows = false);
 
+    /**
+     * Large loads into a table whose rows serialize at a fixed width decode
+     * their rows on up to this many helper threads, a batch ahead of the
+     * loading thread inserting them. 0, the default, decodes on the loading
+     * thread as it inserts.
+     */
+    static void setLoadHelperThreads(int32_t threads);
+    static const int32_t MAX_LOAD_HELPER_THREADS = 8;
+
 
     // ------------------------------------------------------------------
     // EXPORT
@@ -288,7 +301,8 @@ class Table {
         return m_tuplesPerBlock;
     }
 
-    virtual int64_t validatePartitioning(TheHashinator *hashinator, int32_t partitionId) {
+    virtual int64_t validatePartitioning(TheHashinator *hashinator, int32_t partitionId,
+                                         int64_t hashinatorEpoch = 0) {
         throwFatalException("Validate partitioning unsupported on this table type");
         return 0;
     }
@@ -305,6 +319,34 @@ protected:
                                     bool shouldDRStreamRow) {
     };
 
+    /*
+     * Called by Table::loadTuplesFrom with the number of tuples about to be
+     * loaded, before any of them is inserted.
+     */
+    virtual void prepareToLoadTuples(int tupleCount) {}
+
+    /*
+     * Called by Table::loadTuplesFrom once the last tuple is loaded, or once
+     * loading has failed, to undo whatever prepareToLoadTuples set up.
+     */
+    virtual void finishLoadingTuples() {}
+
+    /*
+     * Called by Table::loadTuplesFrom when a load fails, with the tuples it
+     * took from nextFreeTuple but had not yet handed on for processing.
+     */
+    virtual void freeUnprocessedTuples(std::vector<TableTuple> &tuples) {}
+
+    /*
+     * Called by Table::loadTuplesFrom with each batch of loaded tuples.
+     * Processes them one at a time unless overridden.
+     */
+    virtual void processLoadedTupleBatch(std::vector<TableTuple> &tuples,
+                                         ReferenceSerializeOutput *uniqueViolationOutput,
+                                         int32_t &serializedTupleCount,
+                                         size_t &tupleCountPosition,
+                                         bool shouldDRStreamRow);
+
     virtual void swapTuples(TableTuple &sourceTupleWithNewValues, TableTuple &destinationTuple) {
         throwFatalException("Unsupported operation");
     }
@@ -340,6 +382,14 @@ protected:
 
     virtual void initializeWithColumns(TupleSchema *schema, const std::vector<std::string> &columnNames, bool ownsTupleSchema, int32_t compactionThreshold = 95);
 
+    // The body of loadTuplesFromNoHeader when helper threads decode the rows
+    void loadStagedTuples(SerializeInputBE &serialize_in,
+                          int tupleCount,
+                          ReferenceSerializeOutput *uniqueViolationOutput,
+                          int32_t &serializedTupleCount,
+                          size_t &tupleCountPosition,
+                          bool shouldDRStreamRows);
+
     // ------------------------------------------------------------------
     // DATA
     // ------------------------------------------------------------------
@@ -377,6 +427,8 @@ protected:
     int32_t m_refcount;
     ThreadLocalPool m_tlPool;
     int m_compactionThreshold;
+
+    static int32_t s_loadHelperThreads;
 };
 
 }
@@ -88,6 +88,24 @@ public:
         m_tempTableDeleteAsGo = flag;
     }
 
+    /**
+     * Prefetch the tuple this many tuples ahead of the one returned, and
+     * the string data it points to, while scanning a persistent table. The
+     * hardware prefetcher stops at page boundaries and can't follow the
+     * pointers out of the tuple. 0, the default, turns it off.
+     */
+    void setPrefetchDistance(uint32_t tuples) {
+        m_prefetchDistance = tuples;
+    }
+
+    /**
+     * Pass over the blocks of a persistent table whose zone maps rule out
+     * a row falling in all of the bounds, which must outlive the scan.
+     */
+    void setZoneBounds(const std::vector<ZoneBound> *bounds) {
+        m_zoneBounds = bounds;
+    }
+
 protected:
     // Get an iterator via table->iterator()
     TableIterator(Table *, TBMapI);
@@ -102,6 +120,7 @@ protected:
     void reset(TBMapI);
     void reset(std::vector<TBPtr>::iterator);
     bool continuationPredicate();
+    void prefetchObjectsAhead();
 
     /*
      * Configuration parameter that controls whether the table iterator
@@ -123,6 +142,12 @@ protected:
     uint32_t m_foundTuples;
     uint32_t m_tupleLength;
     uint32_t m_tuplesPerBlock;
+    // Active tuples in the current block when the scan entered it, and how
+    // many of them it has passed, so it can leave the block after the last.
+    uint32_t m_blockActiveTuples;
+    uint32_t m_blockFoundTuples;
+    uint32_t m_prefetchDistance;
+    const std::vector<ZoneBound> *m_zoneBounds;
     TBPtr m_currentBlock;
     std::vector<TBPtr>::iterator m_tempBlockIterator;
     bool m_tempTableIterator;
@@ -136,7 +161,9 @@ inline TableIterator::TableIterator(Table *parent, std::vector<TBPtr>::iterator
       m_blockOffset(0),
       m_activeTuples((int) m_table->m_tupleCount),
       m_foundTuples(0), m_tupleLength(parent->m_tupleLength),
-      m_tuplesPerBlock(parent->m_tuplesPerBlock), m_currentBlock(NULL),
+      m_tuplesPerBlock(parent->m_tuplesPerBlock),
+      m_blockActiveTuples(0), m_blockFoundTuples(0), m_prefetchDistance(0),
+      m_zoneBounds(NULL), m_currentBlock(NULL),
       m_tempBlockIterator(start),
       m_tempTableIterator(true),
       m_tempTableDeleteAsGo(false)
@@ -154,6 +181,10 @@ inline TableIterator::TableIterator(Table *parent, TBMapI start)
       m_foundTuples(0),
       m_tupleLength(parent->m_tupleLength),
       m_tuplesPerBlock(parent->m_tuplesPerBlock),
+      m_blockActiveTuples(0),
+      m_blockFoundTuples(0),
+      m_prefetchDistance(0),
+      m_zoneBounds(NULL),
       m_currentBlock(NULL),
       m_tempTableIterator(false),
       m_tempTableDeleteAsGo(false)
@@ -169,6 +200,10 @@ inline TableIterator::TableIterator(Table *parent)
       m_foundTuples(0),
       m_tupleLength(0),
       m_tuplesPerBlock(1),
+      m_blockActiveTuples(0),
+      m_blockFoundTuples(0),
+      m_prefetchDistance(0),
+      m_zoneBounds(NULL),
       m_currentBlock(NULL),
       m_tempTableIterator(true),
       m_tempTableDeleteAsGo(false)
@@ -185,9 +220,13 @@ inline void TableIterator::reset(std::vector<TBPtr>::iterator start) {
     m_foundTuples = 0;
     m_tupleLength = m_table->m_tupleLength;
     m_tuplesPerBlock = m_table->m_tuplesPerBlock;
+    m_blockActiveTuples = 0;
+    m_blockFoundTuples = 0;
     m_currentBlock = NULL;
     m_tempTableIterator = true;
     m_tempTableDeleteAsGo = false;
+    m_prefetchDistance = 0;
+    m_zoneBounds = NULL;
 }
 
 inline void TableIterator::reset(TBMapI start) {
@@ -199,9 +238,13 @@ inline void TableIterator::reset(TBMapI start) {
     m_foundTuples = 0;
     m_tupleLength = m_table->m_tupleLength;
     m_tuplesPerBlock = m_table->m_tuplesPerBlock;
+    m_blockActiveTuples = 0;
+    m_blockFoundTuples = 0;
     m_currentBlock = NULL;
     m_tempTableIterator = false;
     m_tempTableDeleteAsGo = false;
+    m_prefetchDistance = 0;
+    m_zoneBounds = NULL;
 }
 
 inline bool TableIterator::hasNext() {
@@ -219,8 +262,12 @@ inline bool TableIterator::next(TableTuple &out) {
 
 inline bool TableIterator::persistentNext(TableTuple &out) {
     while (m_foundTuples < m_activeTuples) {
+        // Once the scan has passed as many active tuples as the block held
+        // when it entered, the rest of the block is empty. Tuples deleted
+        // since then are not passed, so they can only delay leaving it.
         if (m_currentBlock == NULL ||
-            m_blockOffset >= m_currentBlock->unusedTupleBoundry()) {
+            m_blockOffset >= m_currentBlock->unusedTupleBoundry() ||
+            m_blockFoundTuples >= m_blockActiveTuples) {
 //            assert(m_blockIterator != m_table->m_data.end());
 //            if (m_blockIterator == m_table->m_data.end()) {
 //                throwFatalException("Could not find the expected number of tuples during a table scan");
@@ -228,7 +275,16 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
             m_dataPtr = m_blockIterator.key();
             m_currentBlock = m_blockIterator.data();
             m_blockOffset = 0;
+            m_blockActiveTuples = m_currentBlock->activeTuples();
+            m_blockFoundTuples = 0;
             m_blockIterator++;
+            if (m_zoneBounds != NULL && !m_currentBlock->mayMatch(*m_zoneBounds)) {
+                // Count the block's tuples as found without reading them.
+                m_foundTuples += m_blockActiveTuples;
+                m_blockFoundTuples = m_blockActiveTuples;
+                continue;
+            }
+            m_currentBlock->noteScan();
         } else {
             m_dataPtr += m_tupleLength;
         }
@@ -240,6 +296,14 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
         ++m_location;
         ++m_blockOffset;
 
+        if (m_prefetchDistance != 0) {
+            // A prefetch never faults, so running past the block is harmless.
+            __builtin_prefetch(m_dataPtr + m_prefetchDistance * m_tupleLength);
+            if (m_table->m_schema->getUninlinedObjectColumnCount() != 0) {
+                prefetchObjectsAhead();
+            }
+        }
+
         //assert(out.isActive());
 
         const bool active = out.isActive();
@@ -248,6 +312,7 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
         // Return this tuple only when this tuple is not marked as deleted.
         if (active) {
             ++m_foundTuples;
+            ++m_blockFoundTuples;
             if (!(pendingDelete || isPendingDeleteOnUndoRelease)) {
                 //assert(m_foundTuples == m_location);
                 return true;
@@ -257,6 +322,46 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
     return false;
 }
 
+// The string data is two loads away from the tuple, so it is fetched in two
+// stages: the StringRefs of the tuple the whole distance ahead, whose memory
+// was prefetched on an earlier call, then the data of the tuple half as far
+// ahead, whose StringRefs are in cache by now. Only the pointers of active
+// tuples inside the block's used region are followed.
+inline void TableIterator::prefetchObjectsAhead() {
+    const TupleSchema *schema = m_table->m_schema;
+    const uint16_t objectColumns = schema->getUninlinedObjectColumnCount();
+    const uint32_t boundary = m_currentBlock->unusedTupleBoundry();
+    const uint32_t near = (m_prefetchDistance + 1) / 2;
+    if (m_blockOffset + m_prefetchDistance <= boundary) {
+        const char *far = m_dataPtr + m_prefetchDistance * m_tupleLength;
+        if (TableTuple(const_cast<char*>(far), schema).isActive()) {
+            for (uint16_t ii = 0; ii < objectColumns; ++ii) {
+                const TupleSchema::ColumnInfo *columnInfo =
+                    schema->getColumnInfo(schema->getUninlinedObjectColumnInfoIndex(ii));
+                const StringRef *sref = *reinterpret_cast<StringRef* const*>(
+                    far + TUPLE_HEADER_SIZE + columnInfo->offset);
+                if (sref != NULL) {
+                    __builtin_prefetch(sref);
+                }
+            }
+        }
+    }
+    if (m_blockOffset + near <= boundary) {
+        const char *mid = m_dataPtr + near * m_tupleLength;
+        if (TableTuple(const_cast<char*>(mid), schema).isActive()) {
+            for (uint16_t ii = 0; ii < objectColumns; ++ii) {
+                const TupleSchema::ColumnInfo *columnInfo =
+                    schema->getColumnInfo(schema->getUninlinedObjectColumnInfoIndex(ii));
+                const StringRef *sref = *reinterpret_cast<StringRef* const*>(
+                    mid + TUPLE_HEADER_SIZE + columnInfo->offset);
+                if (sref != NULL) {
+                    __builtin_prefetch(sref->storageAddress());
+                }
+            }
+        }
+    }
+}
+
 inline bool TableIterator::tempNext(TableTuple &out) {
     if (m_foundTuples < m_activeTuples) {
         if (m_currentBlock == NULL ||
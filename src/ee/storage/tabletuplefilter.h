@@ -51,6 +51,7 @@
 #include <boost/unordered_map.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
+#include <cstring>
 #include <vector>
 #include <limits>
 
@@ -204,6 +205,35 @@ class TableTupleFilter {
         return m_lastActiveTupleIndex;
     }
 
+    /**
+     * Return the index of the first tuple after tupleIdx with the marker,
+     * or one past the last active tuple if there is none. Unmarked runs,
+     * such as the matched tuples of a full outer join's inner table, are
+     * passed over a word of eight tuples at a time.
+     */
+    uint64_t findNextTuple(char marker, uint64_t tupleIdx) const
+    {
+        const uint64_t endIdx = m_lastActiveTupleIndex + 1;
+        const uint64_t lowBits = 0x0101010101010101ULL;
+        const uint64_t highBits = 0x8080808080808080ULL;
+        const uint64_t pattern = lowBits * static_cast<uint8_t>(marker);
+        ++tupleIdx;
+        while (tupleIdx + sizeof(uint64_t) <= endIdx) {
+            uint64_t word;
+            ::memcpy(&word, &m_tuples[tupleIdx], sizeof(word));
+            // A byte of the word is zero where the tuple has the marker
+            word ^= pattern;
+            if (((word - lowBits) & ~word & highBits) != 0) {
+                break;
+            }
+            tupleIdx += sizeof(uint64_t);
+        }
+        while (tupleIdx < endIdx && m_tuples[tupleIdx] != marker) {
+            ++tupleIdx;
+        }
+        return tupleIdx;
+    }
+
     uint64_t findBlockIndex(uint64_t tupleAddress);
 
     // Tuples (active and not active)
@@ -298,11 +328,7 @@ class TableTupleFilter_iter
     // Forward Iteration Support
     void increment()
     {
-        uint64_t lastActiveTupleIndex = m_tableFilter->getLastActiveTupleIndex();
-        do
-        {
-            ++m_tupleIdx;
-        } while(m_tupleIdx <= lastActiveTupleIndex && m_tableFilter->getTupleValue(m_tupleIdx) != MARKER);
+        m_tupleIdx = m_tableFilter->findNextTuple(MARKER, m_tupleIdx);
     }
 
     const TableTupleFilter* m_tableFilter;
@@ -385,11 +411,7 @@ class TableTupleFilter_const_iter
     // Forward Iteration Support
     void increment()
     {
-        uint64_t lastActiveTupleIndex = m_tableFilter->getLastActiveTupleIndex();
-        do
-        {
-            ++m_tupleIdx;
-        } while(m_tupleIdx <= lastActiveTupleIndex && m_tableFilter->getTupleValue(m_tupleIdx) != MARKER);
+        m_tupleIdx = m_tableFilter->findNextTuple(MARKER, m_tupleIdx);
     }
 
     const TableTupleFilter* m_tableFilter;
@@ -53,7 +53,8 @@ namespace voltdb {
 TempTable::TempTable()
   : Table(TABLE_BLOCKSIZE),
     m_iter(this),
-    m_limits(NULL)
+    m_limits(NULL),
+    m_spilledBlockCount(0)
 {
     // this happens here because m_data might not be initialized above
     m_iter.reset(m_data.begin());
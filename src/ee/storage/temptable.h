@@ -51,6 +51,8 @@
 #include "common/ThreadLocalPool.h"
 #include "storage/tableiterator.h"
 #include "storage/TempTableLimits.h"
+#include "storage/TempBlockCache.h"
+#include "storage/TempTableSpill.h"
 #include "storage/TupleBlock.h"
 
 namespace voltdb {
@@ -122,6 +124,13 @@ class TempTable : public Table {
      * Does a shallow copy that copies the pointer to uninlined columns.
      */
     void insertTempTuple(TableTuple &source);
+
+    /**
+     * Adds a tuple and points target at it, for the caller to set every
+     * column in place. Projections fill their output this way rather
+     * than copying it out of the temp tuple.
+     */
+    void insertEmptyTempTuple(TableTuple &target);
     // Deprecating this ugly name, and bogus return value. For now it's a wrapper.
     bool isTempTableEmpty() { return m_tupleCount == 0; }
 
@@ -142,6 +151,11 @@ class TempTable : public Table {
         return m_limits;
     }
 
+    /** Whether any of the table's blocks went to the spill file. */
+    bool hasSpilledBlocks() const {
+        return m_spilledBlockCount != 0;
+    }
+
   protected:
     // can not use this constructor to coerce a cast
     explicit TempTable();
@@ -168,6 +182,9 @@ class TempTable : public Table {
 
     // ptr to global integer tracking temp table memory allocated per frag
     TempTableLimits* m_limits;
+
+    // blocks currently in the spill file, which are not charged to m_limits
+    int m_spilledBlockCount;
 };
 
 inline void TempTable::insertTempTupleDeepCopy(const TableTuple &source, Pool *pool) {
@@ -206,6 +223,14 @@ inline void TempTable::insertTempTuple(TableTuple &source) {
     target.setPendingDeleteOnUndoReleaseFalse();
 }
 
+inline void TempTable::insertEmptyTempTuple(TableTuple &target) {
+    assert(target.getSchema() == m_schema);
+    TempTable::nextFreeTuple(&target);
+    target.setActiveTrue();
+    target.setPendingDeleteFalse();
+    target.setPendingDeleteOnUndoReleaseFalse();
+}
+
 inline void TempTable::deleteAllTempTuples() {
     if (m_tupleCount == 0) {
         return;
@@ -218,7 +243,10 @@ inline void TempTable::deleteAllTempTuples() {
         m_data.pop_back();
         // These temp table blocks may have been cleaned up
         // and set null already by the delete as we go feature.
-        if (m_limits && blockPtr) {
+        if (blockPtr && blockPtr->isSpilled()) {
+            --m_spilledBlockCount;
+        }
+        else if (m_limits && blockPtr) {
             m_limits->reduceAllocated(m_tableAllocationSize);
         }
     }
@@ -230,7 +258,27 @@ inline void TempTable::deleteAllTempTuples() {
 }
 
 inline TBPtr TempTable::allocateNextBlock() {
-    TBPtr block(new TupleBlock(this, TBBucketPtr()));
+    // Past the memory limit, blocks go to the spill file if there is one.
+    // The block that just filled up will not change again, so it can be
+    // written out.
+    TempTableSpill* spill = m_limits ? m_limits->spillFor(m_tableAllocationSize) : NULL;
+    if (spill) {
+        off_t offset = 0;
+        char* storage = spill->allocateBlock(m_tableAllocationSize, offset);
+        if (storage) {
+            if (!m_data.empty()) {
+                m_data.back()->writeBackSpilled();
+            }
+            TBPtr block(new TupleBlock(this, spill, storage, offset));
+            m_data.push_back(block);
+            ++m_spilledBlockCount;
+            return block;
+        }
+    }
+
+    // Otherwise storage given back by earlier fragments is reused.
+    TempBlockCache* blockCache = m_limits ? m_limits->blockCache() : NULL;
+    TBPtr block(blockCache ? new TupleBlock(this, blockCache) : new TupleBlock(this, TBBucketPtr()));
     m_data.push_back(block);
 
     if (m_limits) {
@@ -262,8 +310,12 @@ inline void TempTable::freeLastScanedBlock(std::vector<TBPtr>::iterator nextBloc
         nextBlockIterator--;
         // somehow we preserve the first block
         if (m_data.begin() != nextBlockIterator) {
+            bool spilled = (*nextBlockIterator)->isSpilled();
             *nextBlockIterator = NULL;
-            if (m_limits) {
+            if (spilled) {
+                --m_spilledBlockCount;
+            }
+            else if (m_limits) {
                 m_limits->reduceAllocated(m_tableAllocationSize);
             }
         }
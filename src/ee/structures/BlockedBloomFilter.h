@@ -0,0 +1,138 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKEDBLOOMFILTER_H_
+#define BLOCKEDBLOOMFILTER_H_
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * A Bloom filter whose bits for any one hash all fall in the same 64-byte
+ * block, so a probe touches a single cache line. It answers "definitely
+ * not added" or "maybe added"; there are no false negatives.
+ *
+ * Bits cannot be taken back out, so a filter over a set that loses members
+ * only gets less selective. Owners track how many were removed and reset
+ * and refill the filter when that matters.
+ */
+class BlockedBloomFilter {
+public:
+    // Bits per expected entry, and bits set per entry within its block.
+    // Together these give a false positive rate of about 1%.
+    static const int BITS_PER_ENTRY = 10;
+    static const int BITS_PER_HASH = 6;
+
+    BlockedBloomFilter() : m_blocks(NULL), m_blockMask(0), m_capacity(0) {}
+
+    ~BlockedBloomFilter() {
+        ::free(m_blocks);
+    }
+
+    /**
+     * Empties the filter and sizes it for expectedEntries. A capacity of
+     * zero releases its memory; every probe then says "maybe".
+     */
+    void reset(size_t expectedEntries) {
+        ::free(m_blocks);
+        m_blocks = NULL;
+        m_blockMask = 0;
+        m_capacity = 0;
+        if (expectedEntries == 0) {
+            return;
+        }
+        size_t blockCount = 1;
+        while (blockCount * BLOCK_BITS < expectedEntries * BITS_PER_ENTRY) {
+            blockCount <<= 1;
+        }
+        void *memory = NULL;
+        if (::posix_memalign(&memory, sizeof(Block), blockCount * sizeof(Block)) != 0) {
+            throw std::bad_alloc();
+        }
+        ::memset(memory, 0, blockCount * sizeof(Block));
+        m_blocks = static_cast<Block*>(memory);
+        m_blockMask = blockCount - 1;
+        m_capacity = blockCount * BLOCK_BITS / BITS_PER_ENTRY;
+    }
+
+    /** How many entries the filter was sized for; zero when it is off. */
+    size_t capacity() const { return m_capacity; }
+
+    void add(uint64_t hash) {
+        hash = mix(hash);
+        Block &block = m_blocks[hash & m_blockMask];
+        const uint64_t bits = mix(hash ^ BIT_SEED);
+        for (int ii = 0; ii < BITS_PER_HASH; ii++) {
+            const uint32_t bit = static_cast<uint32_t>(bits >> (ii * 9)) & (BLOCK_BITS - 1);
+            block.words[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+    }
+
+    bool mayContain(uint64_t hash) const {
+        if (m_capacity == 0) {
+            return true;
+        }
+        hash = mix(hash);
+        const Block &block = m_blocks[hash & m_blockMask];
+        const uint64_t bits = mix(hash ^ BIT_SEED);
+        bool found = true;
+        for (int ii = 0; ii < BITS_PER_HASH; ii++) {
+            const uint32_t bit = static_cast<uint32_t>(bits >> (ii * 9)) & (BLOCK_BITS - 1);
+            found &= (block.words[bit >> 6] >> (bit & 63)) & 1;
+        }
+        return found;
+    }
+
+    int64_t bytesAllocated() const {
+        return m_capacity == 0 ? 0 : static_cast<int64_t>((m_blockMask + 1) * sizeof(Block));
+    }
+
+private:
+    static const uint32_t BLOCK_BITS = 512;
+    // Sets apart the bits within a block from the hash that picked the block.
+    static const uint64_t BIT_SEED = 0x9e3779b97f4a7c15ULL;
+
+    struct Block {
+        uint64_t words[BLOCK_BITS / 64];
+    };
+
+    // Key hashers make no promise about how well their bits are spread, so
+    // they are stirred first (MurmurHash3's finalizer).
+    static uint64_t mix(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    BlockedBloomFilter(const BlockedBloomFilter&);
+    BlockedBloomFilter& operator=(const BlockedBloomFilter&);
+
+    Block *m_blocks;
+    size_t m_blockMask;
+    size_t m_capacity;
+};
+
+} // namespace voltdb
+
+#endif // BLOCKEDBLOOMFILTER_H_
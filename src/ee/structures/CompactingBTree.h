@@ -0,0 +1,1189 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTINGBTREE_H_
+#define COMPACTINGBTREE_H_
+
+#include "ContiguousAllocator.h"
+#include "CompactingMap.h"
+
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+
+namespace voltdb {
+
+/**
+ * Searches the sorted keys of a node: the separators of an inner node, or
+ * the keys of the entries of a leaf, stride bytes apart. The default is a
+ * binary search. Key types that a few word compares order can specialize
+ * this with a branch-free count over the whole node (see IntsKey<1>).
+ */
+template<typename Key, typename Compare>
+struct BTreeKeySearch {
+    // The number of keys less than key or, if upper, not greater than it.
+    static inline int countBefore(const Key *first, std::size_t stride, int count, const Key &key, bool upper,
+                                  const Compare &comper)
+    {
+        const char *base = reinterpret_cast<const char*>(first);
+        int low = 0;
+        int high = count;
+        while (low < high) {
+            int middle = (low + high) / 2;
+            int cmp = comper(*reinterpret_cast<const Key*>(base + middle * stride), key);
+            if (cmp < 0 || (upper && cmp == 0)) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+};
+
+/**
+ * B+tree with the same interface as CompactingMap, for keys that are
+ * compared often enough that walking a red-black tree node by node is the
+ * cost that matters.
+ *
+ * Entries are kept in sorted arrays in leaves a few cache lines wide, which
+ * are chained in key order, so a search touches a handful of nodes and a
+ * range scan walks memory sequentially. Inner nodes keep copies of the
+ * separating keys next to their child pointers and, for ranked trees, the
+ * number of entries under each child.
+ *
+ * As in CompactingMap, leaves and inner nodes are tightly packed into
+ * buffer chains (ContiguousAllocator). When a node is freed by a merge,
+ * the last allocated node is moved into the hole.
+ *
+ * Issues to be aware of:
+ * 1. Keys and values are copied as plain values, and inner nodes hold
+ *    copies of keys. Keys that own storage (GenericPersistentKey) or
+ *    reference their tuple (TupleKey) must stay in CompactingMap.
+ * 2. Entries move within and between nodes on every insert or delete,
+ *    so any mutation invalidates all iterators.
+ * 3. Iterators have no overloaded operators. Compare them with equals().
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank=false>
+class CompactingBTree {
+    typedef typename KeyValuePair::first_type Key;
+    typedef typename KeyValuePair::second_type Data;
+protected:
+    // Nodes take this many bytes, unless fewer than four keys would fit.
+    static const int NODE_SIZE = 512;
+    static const int LEAF_FIT = static_cast<int>((NODE_SIZE - 4 * sizeof(void*)) / sizeof(KeyValuePair));
+    static const int LEAF_CAPACITY = LEAF_FIT > 4 ? LEAF_FIT : 4;
+    static const int INNER_FIT = static_cast<int>((NODE_SIZE - 2 * sizeof(void*)) /
+            (sizeof(Key) + sizeof(void*) + (hasRank ? sizeof(int64_t) : 0)));
+    static const int INNER_CAPACITY = INNER_FIT > 4 ? INNER_FIT : 4;
+    // Nodes other than the root are kept at least half full.
+    static const int LEAF_MINIMUM = LEAF_CAPACITY / 2;
+    static const int INNER_MINIMUM = INNER_CAPACITY / 2;
+    // Size the allocator blocks about as CompactingMap's are.
+    static const int BLOCK_SIZE = 512 * 1024;
+    // Batched searches descend this many keys at a time, about as many
+    // as a core has cache misses in flight.
+    static const int PROBE_BATCH = 16;
+    static const int CACHE_LINE_SIZE = 64;
+
+    struct InnerNode;
+
+    struct Node {
+        InnerNode *parent;
+    };
+
+    struct LeafNode : public Node {
+        LeafNode *prev;
+        LeafNode *next;
+        int count;
+        KeyValuePair entries[LEAF_CAPACITY];
+
+        LeafNode() : prev(NULL), next(NULL), count(0) { this->parent = NULL; }
+
+        void* operator new(std::size_t unused_sz, ContiguousAllocator& ca)
+        {
+            void *memory = ca.alloc();
+            assert(memory);
+            return memory;
+        }
+        // As in CompactingMap, deallocation is left to allocator.trim().
+        void operator delete(void* unused) { }
+    };
+
+    struct InnerNode : public Node {
+        int count;
+        // keys[i] separates children[i - 1] from children[i]: no entry
+        // under the first is greater, none under the second is less.
+        // keys[0] is unused.
+        Key keys[INNER_CAPACITY];
+        Node *children[INNER_CAPACITY];
+        // The number of entries under each child, for ranked trees only.
+        int64_t counts[hasRank ? INNER_CAPACITY : 1];
+
+        InnerNode() : count(0) { this->parent = NULL; }
+
+        void* operator new(std::size_t unused_sz, ContiguousAllocator& ca)
+        {
+            void *memory = ca.alloc();
+            assert(memory);
+            return memory;
+        }
+        void operator delete(void* unused) { }
+    };
+
+    int64_t m_count;
+    Node *m_root;
+    // the number of levels of inner nodes above the leaves
+    int m_innerLevels;
+    ContiguousAllocator m_leafAllocator;
+    ContiguousAllocator m_innerAllocator;
+    bool m_unique;
+
+    // templated comparison function object
+    // follows STL conventions
+    Compare m_comper;
+
+public:
+    class iterator {
+        friend class CompactingBTree<KeyValuePair, Compare, hasRank>;
+    protected:
+        // A leaf and a slot, so an iterator fits an IndexCursor.
+        LeafNode *m_leaf;
+        int m_slot;
+        iterator(LeafNode *leaf, int slot) : m_leaf(leaf), m_slot(slot) {}
+    public:
+        iterator() : m_leaf(NULL), m_slot(0) {}
+        iterator(const iterator &iter) : m_leaf(iter.m_leaf), m_slot(iter.m_slot) {}
+        const Key &key() const { return m_leaf->entries[m_slot].getKey(); }
+        const Data &value() const { return m_leaf->entries[m_slot].getValue(); }
+        void setValue(const Data &value) { m_leaf->entries[m_slot].setValue(value); }
+        void moveNext()
+        {
+            if (m_leaf == NULL) {
+                return;
+            }
+            if (++m_slot == m_leaf->count) {
+                m_leaf = m_leaf->next;
+                m_slot = 0;
+            }
+        }
+        void movePrev()
+        {
+            if (m_leaf == NULL) {
+                return;
+            }
+            if (m_slot == 0) {
+                m_leaf = m_leaf->prev;
+                m_slot = m_leaf ? m_leaf->count - 1 : 0;
+            }
+            else {
+                --m_slot;
+            }
+        }
+        /**
+         * The value distance entries ahead of (or, if negative, behind)
+         * this one, or NULL when that entry is not in the same leaf.
+         * Cheap enough to call on every step of a scan.
+         */
+        const Data *peekValue(int distance) const
+        {
+            if (m_leaf == NULL) {
+                return NULL;
+            }
+            int slot = m_slot + distance;
+            if (slot < 0 || slot >= m_leaf->count) {
+                return NULL;
+            }
+            return &m_leaf->entries[slot].getValue();
+        }
+        bool isEnd() const { return m_leaf == NULL; }
+        bool equals(const iterator &iter) const {
+            if (isEnd()) {
+                return iter.isEnd();
+            }
+            return m_leaf == iter.m_leaf && m_slot == iter.m_slot;
+        }
+    };
+
+    CompactingBTree(bool unique, Compare comper);
+    ~CompactingBTree();
+
+    // A syntactically convenient analog to CompactingHashTable's insert function
+    const Data *insert(const Key &key, const Data &data);
+    bool erase(const Key &key);
+    bool erase(iterator &iter);
+
+    /**
+     * Fill an empty tree with count entries already in ascending key
+     * order, packing them into leaves directly rather than inserting and
+     * splitting one entry at a time. The entries of a unique tree must
+     * have distinct keys. SortedEntries provides key(i) and value(i).
+     */
+    template<typename SortedEntries>
+    void buildFromSorted(const SortedEntries &entries, int64_t count);
+
+    iterator find(const Key &key) const;
+    iterator findRank(int64_t ith) const;
+    int64_t size() const { return m_count; }
+    iterator begin() const;
+    iterator rbegin() const;
+
+    iterator lowerBound(const Key &key) const;
+    iterator upperBound(const Key &key) const;
+
+    std::pair<iterator, iterator> equalRange(const Key &key) const;
+
+    /**
+     * lowerBound for each of count keys, into results. The searches run
+     * side by side, a level at a time, so their cache misses overlap.
+     * Keys already in ascending order, as from a join whose outer input
+     * is ordered on the join key, are instead found in one forward walk
+     * from each bound to the next, like the inner side of a merge join.
+     */
+    void lowerBounds(const Key *keys, int count, iterator *results) const;
+
+    size_t bytesAllocated() const
+    {
+        return m_leafAllocator.bytesAllocated() + m_innerAllocator.bytesAllocated();
+    }
+
+    // Must pass a key that already in map, or else return -1
+    int64_t rankAsc(const Key& key) const;
+    int64_t rankUpper(const Key& key) const;
+    // The rank of the iterator's own entry, or -1 at the end
+    int64_t rankOf(const iterator &iter) const
+    {
+        if ((!hasRank) || iter.isEnd()) {
+            return -1;
+        }
+        return position(iter.m_leaf, iter.m_slot);
+    }
+
+    /**
+     * For debugging: verify the ordering, linkage, occupancy and counts
+     * of every node. SLOW.
+     */
+    bool verify() const;
+
+protected:
+    LeafNode *findLeaf(const Key &key, bool upper) const;
+    int findChild(const InnerNode *node, const Key &key, bool upper) const;
+    int findSlot(const LeafNode *leaf, const Key &key, bool upper) const;
+    iterator lowerBoundAfter(const iterator &from, const Key &key) const;
+    int childIndex(const InnerNode *parent, const Node *child) const;
+    int64_t position(const LeafNode *leaf, int slot) const;
+    int64_t entryCount(const InnerNode *node) const;
+    void addToCounts(LeafNode *leaf, int64_t delta);
+
+    void insertAt(LeafNode *leaf, int slot, const Key &key, const Data &value);
+    void insertChild(Node *left, int64_t leftCount, Node *right, int64_t rightCount, const Key &separator);
+    LeafNode *splitLeaf(LeafNode *leaf);
+    void splitInner(InnerNode *node);
+
+    void eraseAt(LeafNode *leaf, int slot);
+    void rebalanceLeaf(LeafNode *leaf);
+    void rebalanceInner(InnerNode *node);
+    void removeChild(InnerNode *parent, int index);
+
+    void freeLeaf(LeafNode *leaf);
+    void freeInner(InnerNode *node, InnerNode *&tracked);
+
+    int64_t verify(const Node *node, int level, const Key *lower, const Key *upper) const;
+};
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+CompactingBTree<KeyValuePair, Compare, hasRank>::CompactingBTree(bool unique, Compare comper)
+    : m_count(0),
+      m_root(NULL),
+      m_innerLevels(0),
+      m_leafAllocator(static_cast<int>(sizeof(LeafNode)),
+                      static_cast<int>(BLOCK_SIZE / sizeof(LeafNode) + 1)),
+      m_innerAllocator(static_cast<int>(sizeof(InnerNode)),
+                       static_cast<int>(BLOCK_SIZE / 16 / sizeof(InnerNode) + 1)),
+      m_unique(unique),
+      m_comper(comper)
+{ }
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+CompactingBTree<KeyValuePair, Compare, hasRank>::~CompactingBTree()
+{
+    while (m_leafAllocator.count() > 0) {
+        delete static_cast<LeafNode*>(m_leafAllocator.last());
+        m_leafAllocator.trim();
+    }
+    while (m_innerAllocator.count() > 0) {
+        delete static_cast<InnerNode*>(m_innerAllocator.last());
+        m_innerAllocator.trim();
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+const typename CompactingBTree<KeyValuePair, Compare, hasRank>::Data *
+CompactingBTree<KeyValuePair, Compare, hasRank>::insert(const Key &key, const Data &value)
+{
+    if (m_root == NULL) {
+        m_root = new (m_leafAllocator) LeafNode();
+        m_innerLevels = 0;
+    }
+    LeafNode *leaf;
+    int slot;
+    if (m_unique) {
+        // Inserting exact matches fails for unique trees. An equal key,
+        // if there is one, is the first entry not less than the new one.
+        leaf = findLeaf(key, false);
+        slot = findSlot(leaf, key, false);
+        if (slot < leaf->count) {
+            if (m_comper(leaf->entries[slot].getKey(), key) == 0) {
+                return &leaf->entries[slot].getValue();
+            }
+        }
+        else if (leaf->next != NULL && m_comper(leaf->next->entries[0].getKey(), key) == 0) {
+            return &leaf->next->entries[0].getValue();
+        }
+    }
+    else {
+        // Duplicates go after the existing ones, as in CompactingMap.
+        leaf = findLeaf(key, true);
+        slot = findSlot(leaf, key, true);
+    }
+    insertAt(leaf, slot, key, value);
+    m_count++;
+    assert(m_leafAllocator.count() > 0);
+    return NULL;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(const Key &key)
+{
+    iterator iter = find(key);
+    if (iter.isEnd()) {
+        return false;
+    }
+    eraseAt(iter.m_leaf, iter.m_slot);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::erase(iterator &iter)
+{
+    assert(!iter.isEnd());
+    eraseAt(iter.m_leaf, iter.m_slot);
+    return true;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<typename SortedEntries>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::buildFromSorted(const SortedEntries &entries, int64_t count)
+{
+    assert(m_count == 0);
+    assert(m_root == NULL);
+    if (count == 0) {
+        return;
+    }
+    // Build the tree a level at a time, spreading the nodes of each level
+    // evenly over as few nodes as hold them, so every node but a lone root
+    // is at least half full.
+    std::vector<Node*> level;
+    std::vector<int64_t> levelCounts;
+    // the smallest key under each node of the level
+    std::vector<const Key*> levelKeys;
+
+    int64_t leaves = (count + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+    int64_t next = 0;
+    LeafNode *prev = NULL;
+    for (int64_t ii = 0; ii < leaves; ++ii) {
+        int filled = static_cast<int>((count - next) / (leaves - ii));
+        LeafNode *leaf = new (m_leafAllocator) LeafNode();
+        for (int jj = 0; jj < filled; ++jj) {
+            leaf->entries[jj].setKeyValuePair(entries.key(next + jj), entries.value(next + jj));
+        }
+        leaf->count = filled;
+        next += filled;
+        leaf->prev = prev;
+        if (prev != NULL) {
+            prev->next = leaf;
+        }
+        prev = leaf;
+        level.push_back(leaf);
+        levelCounts.push_back(filled);
+        levelKeys.push_back(&leaf->entries[0].getKey());
+    }
+    assert(next == count);
+
+    m_innerLevels = 0;
+    while (level.size() > 1) {
+        std::vector<Node*> parents;
+        std::vector<int64_t> parentCounts;
+        std::vector<const Key*> parentKeys;
+        int64_t parentCount = (static_cast<int64_t>(level.size()) + INNER_CAPACITY - 1) / INNER_CAPACITY;
+        size_t child = 0;
+        for (int64_t ii = 0; ii < parentCount; ++ii) {
+            int filled = static_cast<int>((level.size() - child) / (parentCount - ii));
+            InnerNode *node = new (m_innerAllocator) InnerNode();
+            int64_t entriesUnder = 0;
+            for (int jj = 0; jj < filled; ++jj, ++child) {
+                node->children[jj] = level[child];
+                level[child]->parent = node;
+                if (jj > 0) {
+                    node->keys[jj] = *levelKeys[child];
+                }
+                if (hasRank) {
+                    node->counts[jj] = levelCounts[child];
+                }
+                entriesUnder += levelCounts[child];
+            }
+            node->count = filled;
+            parents.push_back(node);
+            parentCounts.push_back(entriesUnder);
+            parentKeys.push_back(levelKeys[child - filled]);
+        }
+        level.swap(parents);
+        levelCounts.swap(parentCounts);
+        levelKeys.swap(parentKeys);
+        ++m_innerLevels;
+    }
+    m_root = level[0];
+    m_count = count;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::find(const Key &key) const
+{
+    // the first of any equal entries, as in CompactingMap
+    iterator iter = lowerBound(key);
+    if (iter.isEnd() || m_comper(iter.key(), key) != 0) {
+        return iterator();
+    }
+    return iter;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::findRank(int64_t ith) const
+{
+    if ((!hasRank) || ith < 1 || ith > m_count) {
+        return iterator();
+    }
+    Node *node = m_root;
+    int64_t rank = ith;
+    for (int level = 0; level < m_innerLevels; ++level) {
+        const InnerNode *inner = static_cast<const InnerNode*>(node);
+        int child = 0;
+        while (rank > inner->counts[child]) {
+            rank -= inner->counts[child];
+            ++child;
+        }
+        node = inner->children[child];
+    }
+    return iterator(static_cast<LeafNode*>(node), static_cast<int>(rank - 1));
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::begin() const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    Node *node = m_root;
+    for (int level = 0; level < m_innerLevels; ++level) {
+        node = static_cast<const InnerNode*>(node)->children[0];
+    }
+    return iterator(static_cast<LeafNode*>(node), 0);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::rbegin() const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    Node *node = m_root;
+    for (int level = 0; level < m_innerLevels; ++level) {
+        const InnerNode *inner = static_cast<const InnerNode*>(node);
+        node = inner->children[inner->count - 1];
+    }
+    LeafNode *leaf = static_cast<LeafNode*>(node);
+    return iterator(leaf, leaf->count - 1);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::lowerBound(const Key &key) const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    LeafNode *leaf = findLeaf(key, false);
+    int slot = findSlot(leaf, key, false);
+    if (slot == leaf->count) {
+        // No separator above the next leaf is less than key.
+        return iterator(leaf->next, 0);
+    }
+    return iterator(leaf, slot);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::upperBound(const Key &key) const
+{
+    if (m_count == 0) {
+        return iterator();
+    }
+    Key tmpKey(key);
+    setPointerValue(tmpKey, MAXPOINTER);
+    LeafNode *leaf = findLeaf(tmpKey, true);
+    int slot = findSlot(leaf, tmpKey, true);
+    if (slot == leaf->count) {
+        return iterator(leaf->next, 0);
+    }
+    return iterator(leaf, slot);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename std::pair<typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator,
+                   typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator>
+CompactingBTree<KeyValuePair, Compare, hasRank>::equalRange(const Key &key) const
+{
+    return std::pair<iterator, iterator>(lowerBound(key), upperBound(key));
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::lowerBounds(const Key *keys, int count,
+                                                                  iterator *results) const
+{
+    if (m_count == 0) {
+        for (int ii = 0; ii < count; ++ii) {
+            results[ii] = iterator();
+        }
+        return;
+    }
+    bool ascending = true;
+    for (int ii = 1; ascending && ii < count; ++ii) {
+        ascending = m_comper(keys[ii - 1], keys[ii]) <= 0;
+    }
+    if (ascending) {
+        results[0] = lowerBound(keys[0]);
+        for (int ii = 1; ii < count; ++ii) {
+            results[ii] = lowerBoundAfter(results[ii - 1], keys[ii]);
+        }
+        return;
+    }
+    const Node *nodes[PROBE_BATCH];
+    for (int first = 0; first < count; first += PROBE_BATCH) {
+        const int batch = count - first < PROBE_BATCH ? count - first : PROBE_BATCH;
+        for (int ii = 0; ii < batch; ++ii) {
+            nodes[ii] = m_root;
+        }
+        for (int level = 0; level < m_innerLevels; ++level) {
+            for (int ii = 0; ii < batch; ++ii) {
+                const InnerNode *inner = static_cast<const InnerNode*>(nodes[ii]);
+                nodes[ii] = inner->children[findChild(inner, keys[first + ii], false)];
+                // Start loading the whole node while the other keys of the
+                // batch take their step.
+                const char *bytes = reinterpret_cast<const char*>(nodes[ii]);
+                for (int offset = 0; offset < NODE_SIZE; offset += CACHE_LINE_SIZE) {
+                    __builtin_prefetch(bytes + offset);
+                }
+            }
+        }
+        for (int ii = 0; ii < batch; ++ii) {
+            LeafNode *leaf = static_cast<LeafNode*>(const_cast<Node*>(nodes[ii]));
+            int slot = findSlot(leaf, keys[first + ii], false);
+            if (slot == leaf->count) {
+                results[first + ii] = iterator(leaf->next, 0);
+            }
+            else {
+                results[first + ii] = iterator(leaf, slot);
+            }
+        }
+    }
+}
+
+/**
+ * lowerBound of key, given from, the lowerBound of a key not greater than
+ * key. Nothing before from can be the answer, so the answer is looked for
+ * in from's leaf and the next one before a descent from the root.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::iterator
+CompactingBTree<KeyValuePair, Compare, hasRank>::lowerBoundAfter(const iterator &from, const Key &key) const
+{
+    LeafNode *leaf = from.m_leaf;
+    for (int step = 0; leaf != NULL && step < 2; ++step, leaf = leaf->next) {
+        if (m_comper(leaf->entries[leaf->count - 1].getKey(), key) >= 0) {
+            return iterator(leaf, findSlot(leaf, key, false));
+        }
+    }
+    if (leaf == NULL) {
+        // Every entry from from on is less than key.
+        return iterator();
+    }
+    return lowerBound(key);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankAsc(const Key& key) const
+{
+    if (!hasRank) {
+        return -1;
+    }
+    iterator iter = find(key);
+    // return -1 if the key passed in is not in the map
+    if (iter.isEnd()) {
+        return -1;
+    }
+    return position(iter.m_leaf, iter.m_slot);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::rankUpper(const Key& key) const
+{
+    if (!hasRank) {
+        return -1;
+    }
+    if (m_unique) {
+        return rankAsc(key);
+    }
+    if (find(key).isEnd()) {
+        return -1;
+    }
+    iterator iter = upperBound(key);
+    if (iter.isEnd()) {
+        return m_count;
+    }
+    return position(iter.m_leaf, iter.m_slot) - 1;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+bool CompactingBTree<KeyValuePair, Compare, hasRank>::verify() const
+{
+    if (m_root == NULL) {
+        return m_count == 0 && m_leafAllocator.count() == 0 && m_innerAllocator.count() == 0;
+    }
+    if (m_root->parent != NULL || verify(m_root, 0, NULL, NULL) != m_count) {
+        return false;
+    }
+    // The leaf chain visits every entry in order.
+    int64_t chained = 0;
+    const LeafNode *prev = NULL;
+    const Key *prevKey = NULL;
+    for (const LeafNode *leaf = begin().m_leaf; leaf != NULL; prev = leaf, leaf = leaf->next) {
+        if (leaf->prev != prev) {
+            return false;
+        }
+        for (int ii = 0; ii < leaf->count; ++ii) {
+            const Key &key = leaf->entries[ii].getKey();
+            if (prevKey != NULL) {
+                int cmp = m_comper(*prevKey, key);
+                if (cmp > 0 || (m_unique && cmp == 0)) {
+                    return false;
+                }
+            }
+            prevKey = &key;
+        }
+        chained += leaf->count;
+    }
+    return chained == m_count;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::verify(const Node *node, int level,
+                                                                const Key *lower, const Key *upper) const
+{
+    if (level == m_innerLevels) {
+        const LeafNode *leaf = static_cast<const LeafNode*>(node);
+        if (leaf->count < (node == m_root ? 1 : LEAF_MINIMUM) || leaf->count > LEAF_CAPACITY) {
+            return -1;
+        }
+        for (int ii = 0; ii < leaf->count; ++ii) {
+            if ((lower && m_comper(leaf->entries[ii].getKey(), *lower) < 0) ||
+                (upper && m_comper(leaf->entries[ii].getKey(), *upper) > 0)) {
+                return -1;
+            }
+        }
+        return leaf->count;
+    }
+    const InnerNode *inner = static_cast<const InnerNode*>(node);
+    if (inner->count < (node == m_root ? 2 : INNER_MINIMUM) || inner->count > INNER_CAPACITY) {
+        return -1;
+    }
+    int64_t total = 0;
+    for (int ii = 0; ii < inner->count; ++ii) {
+        if (inner->children[ii]->parent != inner) {
+            return -1;
+        }
+        const Key *childLower = ii > 0 ? &inner->keys[ii] : lower;
+        const Key *childUpper = ii + 1 < inner->count ? &inner->keys[ii + 1] : upper;
+        int64_t under = verify(inner->children[ii], level + 1, childLower, childUpper);
+        if (under < 0 || (hasRank && inner->counts[ii] != under)) {
+            return -1;
+        }
+        total += under;
+    }
+    return total;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::LeafNode *
+CompactingBTree<KeyValuePair, Compare, hasRank>::findLeaf(const Key &key, bool upper) const
+{
+    Node *node = m_root;
+    for (int level = 0; level < m_innerLevels; ++level) {
+        const InnerNode *inner = static_cast<const InnerNode*>(node);
+        node = inner->children[findChild(inner, key, upper)];
+    }
+    return static_cast<LeafNode*>(node);
+}
+
+/**
+ * The child under which the first entry not less than key (or, if upper,
+ * greater than key) is, unless it is the first entry of the next leaf.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::findChild(const InnerNode *node, const Key &key,
+                                                               bool upper) const
+{
+    return BTreeKeySearch<Key, Compare>::countBefore(&node->keys[1], sizeof(Key), node->count - 1, key, upper,
+                                                     m_comper);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::findSlot(const LeafNode *leaf, const Key &key,
+                                                              bool upper) const
+{
+    return BTreeKeySearch<Key, Compare>::countBefore(&leaf->entries[0].getKey(), sizeof(KeyValuePair),
+                                                     leaf->count, key, upper, m_comper);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int CompactingBTree<KeyValuePair, Compare, hasRank>::childIndex(const InnerNode *parent, const Node *child) const
+{
+    int index = 0;
+    while (parent->children[index] != child) {
+        ++index;
+        assert(index < parent->count);
+    }
+    return index;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::position(const LeafNode *leaf, int slot) const
+{
+    int64_t rank = slot + 1;
+    const Node *child = leaf;
+    for (const InnerNode *parent = leaf->parent; parent != NULL; child = parent, parent = parent->parent) {
+        int index = childIndex(parent, child);
+        for (int ii = 0; ii < index; ++ii) {
+            rank += parent->counts[ii];
+        }
+    }
+    return rank;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingBTree<KeyValuePair, Compare, hasRank>::entryCount(const InnerNode *node) const
+{
+    int64_t total = 0;
+    if (hasRank) {
+        for (int ii = 0; ii < node->count; ++ii) {
+            total += node->counts[ii];
+        }
+    }
+    return total;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::addToCounts(LeafNode *leaf, int64_t delta)
+{
+    if (!hasRank) {
+        return;
+    }
+    Node *child = leaf;
+    for (InnerNode *parent = leaf->parent; parent != NULL; child = parent, parent = parent->parent) {
+        parent->counts[childIndex(parent, child)] += delta;
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertAt(LeafNode *leaf, int slot,
+                                                               const Key &key, const Data &value)
+{
+    if (leaf->count == LEAF_CAPACITY) {
+        LeafNode *right = splitLeaf(leaf);
+        if (slot > leaf->count) {
+            slot -= leaf->count;
+            leaf = right;
+        }
+    }
+    for (int ii = leaf->count; ii > slot; --ii) {
+        leaf->entries[ii] = leaf->entries[ii - 1];
+    }
+    leaf->entries[slot].setKeyValuePair(key, value);
+    leaf->count++;
+    addToCounts(leaf, 1);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+typename CompactingBTree<KeyValuePair, Compare, hasRank>::LeafNode *
+CompactingBTree<KeyValuePair, Compare, hasRank>::splitLeaf(LeafNode *leaf)
+{
+    LeafNode *right = new (m_leafAllocator) LeafNode();
+    int moved = leaf->count / 2;
+    int kept = leaf->count - moved;
+    for (int ii = 0; ii < moved; ++ii) {
+        right->entries[ii] = leaf->entries[kept + ii];
+    }
+    right->count = moved;
+    leaf->count = kept;
+
+    right->next = leaf->next;
+    if (right->next != NULL) {
+        right->next->prev = right;
+    }
+    right->prev = leaf;
+    leaf->next = right;
+
+    insertChild(leaf, kept, right, moved, right->entries[0].getKey());
+    return right;
+}
+
+/**
+ * Add right to the parent of left, just after it, now that right has
+ * taken the upper part of left's entries. separator is the smallest key
+ * under right.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::insertChild(Node *left, int64_t leftCount,
+                                                                  Node *right, int64_t rightCount,
+                                                                  const Key &separator)
+{
+    InnerNode *parent = left->parent;
+    if (parent == NULL) {
+        assert(left == m_root);
+        parent = new (m_innerAllocator) InnerNode();
+        parent->children[0] = left;
+        parent->count = 1;
+        if (hasRank) {
+            parent->counts[0] = leftCount + rightCount;
+        }
+        left->parent = parent;
+        m_root = parent;
+        ++m_innerLevels;
+    }
+    else if (parent->count == INNER_CAPACITY) {
+        // Splitting first keeps the counts above consistent: the entries
+        // under left have only been divided between left and right.
+        splitInner(parent);
+        parent = left->parent;
+    }
+    int index = childIndex(parent, left);
+    for (int ii = parent->count; ii > index + 1; --ii) {
+        parent->keys[ii] = parent->keys[ii - 1];
+        parent->children[ii] = parent->children[ii - 1];
+        if (hasRank) {
+            parent->counts[ii] = parent->counts[ii - 1];
+        }
+    }
+    parent->keys[index + 1] = separator;
+    parent->children[index + 1] = right;
+    if (hasRank) {
+        parent->counts[index] = leftCount;
+        parent->counts[index + 1] = rightCount;
+    }
+    parent->count++;
+    right->parent = parent;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::splitInner(InnerNode *node)
+{
+    InnerNode *right = new (m_innerAllocator) InnerNode();
+    int moved = node->count / 2;
+    int kept = node->count - moved;
+    // right->keys[0] takes the key that separates the two halves.
+    for (int ii = 0; ii < moved; ++ii) {
+        right->keys[ii] = node->keys[kept + ii];
+        right->children[ii] = node->children[kept + ii];
+        if (hasRank) {
+            right->counts[ii] = node->counts[kept + ii];
+        }
+        right->children[ii]->parent = right;
+    }
+    right->count = moved;
+    node->count = kept;
+    insertChild(node, entryCount(node), right, entryCount(right), right->keys[0]);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::eraseAt(LeafNode *leaf, int slot)
+{
+    for (int ii = slot; ii < leaf->count - 1; ++ii) {
+        leaf->entries[ii] = leaf->entries[ii + 1];
+    }
+    leaf->count--;
+    addToCounts(leaf, -1);
+    m_count--;
+
+    if (leaf->parent == NULL) {
+        if (leaf->count == 0) {
+            freeLeaf(leaf);
+            m_root = NULL;
+        }
+        return;
+    }
+    if (leaf->count < LEAF_MINIMUM) {
+        rebalanceLeaf(leaf);
+    }
+}
+
+/**
+ * Refill a leaf that has fallen below half full from its sibling, or
+ * merge the two if they fit in one leaf.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::rebalanceLeaf(LeafNode *leaf)
+{
+    InnerNode *parent = leaf->parent;
+    int index = childIndex(parent, leaf);
+    int leftIndex = index > 0 ? index - 1 : index;
+    LeafNode *left = static_cast<LeafNode*>(parent->children[leftIndex]);
+    LeafNode *right = static_cast<LeafNode*>(parent->children[leftIndex + 1]);
+
+    if (left->count + right->count <= LEAF_CAPACITY) {
+        for (int ii = 0; ii < right->count; ++ii) {
+            left->entries[left->count + ii] = right->entries[ii];
+        }
+        left->count += right->count;
+        right->count = 0;
+        left->next = right->next;
+        if (left->next != NULL) {
+            left->next->prev = left;
+        }
+        removeChild(parent, leftIndex + 1);
+        freeLeaf(right);
+        rebalanceInner(parent);
+    }
+    else if (left == leaf) {
+        leaf->entries[leaf->count++] = right->entries[0];
+        for (int ii = 0; ii < right->count - 1; ++ii) {
+            right->entries[ii] = right->entries[ii + 1];
+        }
+        right->count--;
+        parent->keys[leftIndex + 1] = right->entries[0].getKey();
+        if (hasRank) {
+            parent->counts[leftIndex]++;
+            parent->counts[leftIndex + 1]--;
+        }
+    }
+    else {
+        for (int ii = leaf->count; ii > 0; --ii) {
+            leaf->entries[ii] = leaf->entries[ii - 1];
+        }
+        leaf->entries[0] = left->entries[--left->count];
+        leaf->count++;
+        parent->keys[index] = leaf->entries[0].getKey();
+        if (hasRank) {
+            parent->counts[leftIndex]--;
+            parent->counts[index]++;
+        }
+    }
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::rebalanceInner(InnerNode *node)
+{
+    if (node->parent == NULL) {
+        if (node->count == 1) {
+            // The root is down to one child, which takes its place.
+            m_root = node->children[0];
+            m_root->parent = NULL;
+            --m_innerLevels;
+            InnerNode *none = NULL;
+            freeInner(node, none);
+        }
+        return;
+    }
+    if (node->count >= INNER_MINIMUM) {
+        return;
+    }
+
+    InnerNode *parent = node->parent;
+    int index = childIndex(parent, node);
+    int leftIndex = index > 0 ? index - 1 : index;
+    InnerNode *left = static_cast<InnerNode*>(parent->children[leftIndex]);
+    InnerNode *right = static_cast<InnerNode*>(parent->children[leftIndex + 1]);
+
+    if (left->count + right->count <= INNER_CAPACITY) {
+        // The separator between the two comes down ahead of right's children.
+        for (int ii = 0; ii < right->count; ++ii) {
+            int jj = left->count + ii;
+            left->keys[jj] = ii == 0 ? parent->keys[leftIndex + 1] : right->keys[ii];
+            left->children[jj] = right->children[ii];
+            if (hasRank) {
+                left->counts[jj] = right->counts[ii];
+            }
+            left->children[jj]->parent = left;
+        }
+        left->count += right->count;
+        right->count = 0;
+        removeChild(parent, leftIndex + 1);
+        // Freeing right may move the parent into its place.
+        freeInner(right, parent);
+        rebalanceInner(parent);
+    }
+    else if (left == node) {
+        int last = node->count;
+        node->keys[last] = parent->keys[leftIndex + 1];
+        node->children[last] = right->children[0];
+        node->children[last]->parent = node;
+        int64_t moved = hasRank ? right->counts[0] : 0;
+        if (hasRank) {
+            node->counts[last] = moved;
+        }
+        node->count++;
+        parent->keys[leftIndex + 1] = right->keys[1];
+        for (int ii = 0; ii < right->count - 1; ++ii) {
+            right->keys[ii] = right->keys[ii + 1];
+            right->children[ii] = right->children[ii + 1];
+            if (hasRank) {
+                right->counts[ii] = right->counts[ii + 1];
+            }
+        }
+        right->count--;
+        if (hasRank) {
+            parent->counts[leftIndex] += moved;
+            parent->counts[leftIndex + 1] -= moved;
+        }
+    }
+    else {
+        for (int ii = node->count; ii > 0; --ii) {
+            node->keys[ii] = node->keys[ii - 1];
+            node->children[ii] = node->children[ii - 1];
+            if (hasRank) {
+                node->counts[ii] = node->counts[ii - 1];
+            }
+        }
+        int last = left->count - 1;
+        node->keys[1] = parent->keys[index];
+        node->children[0] = left->children[last];
+        node->children[0]->parent = node;
+        int64_t moved = hasRank ? left->counts[last] : 0;
+        if (hasRank) {
+            node->counts[0] = moved;
+        }
+        node->count++;
+        parent->keys[index] = left->keys[last];
+        left->count--;
+        if (hasRank) {
+            parent->counts[leftIndex] -= moved;
+            parent->counts[index] += moved;
+        }
+    }
+}
+
+/** Drop a child that has been merged into the one before it. */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::removeChild(InnerNode *parent, int index)
+{
+    assert(index > 0);
+    if (hasRank) {
+        parent->counts[index - 1] += parent->counts[index];
+    }
+    for (int ii = index; ii < parent->count - 1; ++ii) {
+        parent->keys[ii] = parent->keys[ii + 1];
+        parent->children[ii] = parent->children[ii + 1];
+        if (hasRank) {
+            parent->counts[ii] = parent->counts[ii + 1];
+        }
+    }
+    parent->count--;
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeLeaf(LeafNode *leaf)
+{
+    // Fix up the contiguous allocation --
+    // move the last leaf to fill the hole.
+    LeafNode *last = static_cast<LeafNode*>(m_leafAllocator.last());
+    if (last != leaf) {
+        for (int ii = 0; ii < last->count; ++ii) {
+            leaf->entries[ii] = last->entries[ii];
+        }
+        leaf->count = last->count;
+        leaf->parent = last->parent;
+        leaf->prev = last->prev;
+        leaf->next = last->next;
+        if (leaf->prev != NULL) {
+            leaf->prev->next = leaf;
+        }
+        if (leaf->next != NULL) {
+            leaf->next->prev = leaf;
+        }
+        if (leaf->parent != NULL) {
+            leaf->parent->children[childIndex(leaf->parent, last)] = leaf;
+        }
+        else {
+            assert(last == m_root);
+            m_root = leaf;
+        }
+    }
+    delete last;
+    m_leafAllocator.trim();
+}
+
+/**
+ * Free an inner node, moving the last inner node into its place. If that
+ * is tracked, tracked is pointed at its new place.
+ */
+template<typename KeyValuePair, typename Compare, bool hasRank>
+void CompactingBTree<KeyValuePair, Compare, hasRank>::freeInner(InnerNode *node, InnerNode *&tracked)
+{
+    InnerNode *last = static_cast<InnerNode*>(m_innerAllocator.last());
+    if (last != node) {
+        node->count = last->count;
+        node->parent = last->parent;
+        for (int ii = 0; ii < last->count; ++ii) {
+            node->keys[ii] = last->keys[ii];
+            node->children[ii] = last->children[ii];
+            if (hasRank) {
+                node->counts[ii] = last->counts[ii];
+            }
+            node->children[ii]->parent = node;
+        }
+        if (node->parent != NULL) {
+            node->parent->children[childIndex(node->parent, last)] = node;
+        }
+        else {
+            assert(last == m_root);
+            m_root = node;
+        }
+        if (tracked == last) {
+            tracked = node;
+        }
+    }
+    delete last;
+    m_innerAllocator.trim();
+}
+
+} // namespace voltdb
+
+#endif // COMPACTINGBTREE_H_
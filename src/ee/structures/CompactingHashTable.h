@@ -63,6 +63,10 @@ namespace voltdb {
         // shrink when the hash table is 15% full
         // (new hash will be 30% full)
         static const uint64_t MIN_LOAD_FACTOR = 15; // %
+        // while resizing, each insert or erase moves this many buckets
+        // from the old table to the new one (enough to finish well before
+        // the next grow or shrink could be due)
+        static const uint64_t RESIZE_BUCKETS_PER_OP = 32;
 
         static const uint64_t TABLE_SIZES[];
 
@@ -113,10 +117,14 @@ namespace voltdb {
         };
 
         HashNode **m_buckets;             // the array holding the buckets
+        HashNode **m_oldBuckets;          // the table being resized away from, or NULL
         bool m_unique;                    // support unique
         uint64_t m_count;                 // number of items in the hash
         uint64_t m_uniqueCount;           // number of unique keys
         int m_sizeIndex;                  // current bucket count (from array)
+        int m_oldSizeIndex;               // bucket count of m_oldBuckets
+        uint64_t m_migratedBuckets;       // old buckets below this have been moved
+        int m_minSizeIndex;               // never shrink below this (see reserve)
         ContiguousAllocator m_allocator;  // allocator supporting compaction
         Hasher m_hasher;                  // instance of the hashing function
         KeyEqChecker m_keyEq;             // instance of the key eq checker
@@ -162,6 +170,8 @@ namespace voltdb {
         iterator find(const Key &key) const;
         /** find an exact key/value match (optionaly searching by value first) */
         iterator find(const Key &key, const Data &value) const;
+        /** simple find for each of count keys, overlapping their bucket loads */
+        void findBatch(const Key *keys, int count, iterator *results) const;
         /** simple insert */
         const Data *insert(const Key &key, const Data &value);
         /** delete by key (unique only) */
@@ -172,9 +182,17 @@ namespace voltdb {
         bool erase(iterator &iter);
         /** STL-ish size() method */
         size_t size() const { return m_count; }
+        /** size the table for count unique keys up front and never shrink below that */
+        void reserve(size_t count);
 
         /** Return bytes used for this index */
-        size_t bytesAllocated() const { return m_allocator.bytesAllocated() + TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*); }
+        size_t bytesAllocated() const {
+            size_t bucketBytes = TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*);
+            if (m_oldBuckets) {
+                bucketBytes += TABLE_SIZES[m_oldSizeIndex] * sizeof(HashNode*);
+            }
+            return m_allocator.bytesAllocated() + bucketBytes;
+        }
 
         /** verification for debugging and testing */
         bool verify();
@@ -182,6 +200,20 @@ namespace voltdb {
         bool hasCachedLastBuffer() const { return (m_allocator.hasCachedLastBuffer()); }
 
     protected:
+        /**
+         * The bucket holding a hash. While a resize is in progress, old buckets
+         * that have not been moved yet still own their keys.
+         */
+        HashNode **bucketFor(uint64_t hash) const {
+            if (m_oldBuckets) {
+                uint64_t oldOffset = hash % TABLE_SIZES[m_oldSizeIndex];
+                if (oldOffset >= m_migratedBuckets) {
+                    return &m_oldBuckets[oldOffset];
+                }
+            }
+            return &m_buckets[hash % TABLE_SIZES[m_sizeIndex]];
+        }
+
         /** find, given a bucket/key */
         HashNode *find(const HashNode *bucket, const Key &key) const;
         /** find and exact match, given a bucket */
@@ -197,8 +229,12 @@ namespace voltdb {
 
         /** see if the hash needs to grow or shrink */
         void checkLoadFactor();
-        /** grow/shrink the hash table */
+        /** start growing/shrinking the hash table; buckets move over incrementally */
         void resize(int newSizeIndex);
+        /** move up to count old buckets into the new table */
+        void migrateBuckets(uint64_t count);
+        /** walk one bucket array for verify() */
+        bool verifyBuckets(HashNode **buckets, uint64_t bucketCount, size_t &manualCount);
     };
 
     template<class K, class T, class H, class EK, class ET>
@@ -246,10 +282,14 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     CompactingHashTable<K, T, H, EK, ET>::CompactingHashTable(bool unique, Hasher hasher, KeyEqChecker keyEq, DataEqChecker dataEq)
-    : m_unique(unique),
+    : m_oldBuckets(NULL),
+    m_unique(unique),
     m_count(0),
     m_uniqueCount(0),
     m_sizeIndex(BUCKET_INITIAL_INDEX),
+    m_oldSizeIndex(BUCKET_INITIAL_INDEX),
+    m_migratedBuckets(0),
+    m_minSizeIndex(BUCKET_INITIAL_INDEX),
     m_allocator((int32_t)(unique ? sizeof(HashNodeSmall) : sizeof(HashNode)), ALLOCATOR_CHUNK_SIZE),
     m_hasher(hasher),
     m_keyEq(keyEq),
@@ -264,6 +304,11 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     CompactingHashTable<K, T, H, EK, ET>::~CompactingHashTable() {
+        // finish any resize so that every node hangs off m_buckets
+        if (m_oldBuckets) {
+            migrateBuckets(TABLE_SIZES[m_oldSizeIndex]);
+        }
+
         // unlink all of the nodes, which will call destructors correctly
         for (size_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
             while (m_buckets[i]) {
@@ -287,38 +332,52 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key) const {
-        uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key);
+        const HashNode *foundNode = find(*bucketFor(m_hasher(key)), key);
         return iterator(foundNode);
     }
 
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::findBatch(const Key *keys, int count, iterator *results) const {
+        // Hash a handful of keys and prefetch their buckets, then their
+        // first nodes, before walking any chain, so the misses overlap.
+        static const int PROBE_BATCH = 16;
+        HashNode **buckets[PROBE_BATCH];
+        for (int first = 0; first < count; first += PROBE_BATCH) {
+            const int batch = count - first < PROBE_BATCH ? count - first : PROBE_BATCH;
+            for (int i = 0; i < batch; i++) {
+                buckets[i] = bucketFor(m_hasher(keys[first + i]));
+                __builtin_prefetch(buckets[i]);
+            }
+            for (int i = 0; i < batch; i++) {
+                __builtin_prefetch(*buckets[i]);
+            }
+            for (int i = 0; i < batch; i++) {
+                results[first + i] = iterator(find(*buckets[i], keys[first + i]));
+            }
+        }
+    }
+
     template<class K, class T, class H, class EK, class ET>
     typename CompactingHashTable<K, T, H, EK, ET>::iterator CompactingHashTable<K, T, H, EK, ET>::find(const Key &key, const Data &value) const {
-        uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        const HashNode *foundNode = find(m_buckets[bucketOffset], key, value);
+        const HashNode *foundNode = find(*bucketFor(m_hasher(key)), key, value);
         return iterator(foundNode);
     }
 
     template<class K, class T, class H, class EK, class ET>
     const typename CompactingHashTable<K, T, H, EK, ET>::Data *CompactingHashTable<K, T, H, EK, ET>::insert(const Key &key, const Data &value) {
         uint64_t hash = m_hasher(key);
-
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
-        return insert(&(m_buckets[bucketOffset]), hash, key, value);
+        return insert(bucketFor(hash), hash, key, value);
     }
 
     template<class K, class T, class H, class EK, class ET>
     bool CompactingHashTable<K, T, H, EK, ET>::erase(const Key &key) {
         assert(m_unique);
         HashNode *prevBucketNode = NULL;
-        uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(m_hasher(key));
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
-                removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                removeUnique(bucket, prevBucketNode, node);
                 deleteAndFixup(node);
                 checkLoadFactor();
                 return true;
@@ -332,14 +391,13 @@ namespace voltdb {
     template<class K, class T, class H, class EK, class ET>
     bool CompactingHashTable<K, T, H, EK, ET>::erase(const Key &key, const Data &value) {
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
-        uint64_t hash = m_hasher(key);
-        uint64_t bucketOffset = hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(m_hasher(key));
 
-        for (HashNode *node = m_buckets[bucketOffset]; node; node = node->nextInBucket) {
+        for (HashNode *node = *bucket; node; node = node->nextInBucket) {
             if (m_keyEq(node->key, key)) {
                 if (m_unique) {
                     if (!m_dataEq(node->value, value)) return false;
-                    removeUnique(&(m_buckets[bucketOffset]), prevBucketNode, node);
+                    removeUnique(bucket, prevBucketNode, node);
                     deleteAndFixup(node);
                     checkLoadFactor();
                     return true;
@@ -347,7 +405,7 @@ namespace voltdb {
                 keyHeadNode = node;
                 for (node = keyHeadNode; node; node = node->nextWithKey) {
                     if (m_dataEq(node->value, value)) {
-                        remove(&(m_buckets[bucketOffset]), prevBucketNode, keyHeadNode, prevKeyNode, node);
+                        remove(bucket, prevBucketNode, keyHeadNode, prevKeyNode, node);
                         deleteAndFixup(node);
                         checkLoadFactor();
                         return true;
@@ -514,11 +572,11 @@ namespace voltdb {
         }
 
         // find the bucket for the last node
-        uint64_t bucketOffset = last->hash % TABLE_SIZES[m_sizeIndex];
+        HashNode **bucket = bucketFor(last->hash);
 
         // find the last node and what points to it
         HashNode *prevBucketNode = NULL, *keyHeadNode = NULL, *prevKeyNode = NULL;
-        for (HashNode *n = m_buckets[bucketOffset]; n; n = n->nextInBucket) {
+        for (HashNode *n = *bucket; n; n = n->nextInBucket) {
             prevKeyNode = NULL;
             keyHeadNode = n;
             if (m_unique) {
@@ -532,7 +590,7 @@ namespace voltdb {
                     prevBucketNode->nextInBucket = node;
                 }
                 else {
-                    m_buckets[bucketOffset] = node;
+                    *bucket = node;
                 }
 
                 // copy the last node over the deleted node
@@ -566,7 +624,7 @@ namespace voltdb {
                             prevBucketNode->nextInBucket = node;
                         }
                         else {
-                            m_buckets[bucketOffset] = node;
+                            *bucket = node;
                         }
                     }
 
@@ -595,6 +653,11 @@ namespace voltdb {
 
     template<class K, class T, class H, class EK, class ET>
     void CompactingHashTable<K, T, H, EK, ET>::checkLoadFactor() {
+        // pay off a little of any resize in progress
+        if (m_oldBuckets) {
+            migrateBuckets(RESIZE_BUCKETS_PER_OP);
+        }
+
         uint64_t lf = (m_uniqueCount * 100) / TABLE_SIZES[m_sizeIndex];
         int newSizeIndex = m_sizeIndex;
         if (lf > MAX_LOAD_FACTOR) {
@@ -602,7 +665,7 @@ namespace voltdb {
         }
         else if(lf < MIN_LOAD_FACTOR) {
             // make sure the hash doesn't over-shrink
-            if (newSizeIndex != BUCKET_INITIAL_INDEX) {
+            if (newSizeIndex > BUCKET_INITIAL_INDEX && newSizeIndex > m_minSizeIndex) {
                 newSizeIndex--;
             }
         }
@@ -611,77 +674,102 @@ namespace voltdb {
         }
     }
 
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::reserve(size_t count) {
+        int newSizeIndex = m_sizeIndex;
+        const int maxSizeIndex = static_cast<int>(sizeof(TABLE_SIZES) / sizeof(TABLE_SIZES[0])) - 1;
+        while (newSizeIndex < maxSizeIndex && (count * 100) / TABLE_SIZES[newSizeIndex] > MAX_LOAD_FACTOR) {
+            newSizeIndex++;
+        }
+        if (newSizeIndex > m_minSizeIndex) {
+            m_minSizeIndex = newSizeIndex;
+        }
+        if (newSizeIndex != m_sizeIndex) {
+            resize(newSizeIndex);
+        }
+    }
+
     template<class K, class T, class H, class EK, class ET>
     void CompactingHashTable<K, T, H, EK, ET>::resize(int newSizeIndex) {
-        //std::cout << "DEBUG SIZING BUFFER" << newSizeIndex << std::endl;
-        //std::cout.flush();
+        // Rehashing everything at once stalls whichever transaction tips the
+        // load factor, so the old table stays live and each insert or erase
+        // moves RESIZE_BUCKETS_PER_OP of its buckets over. Should the load
+        // factor run ahead of that, the previous resize is finished first.
+        if (m_oldBuckets) {
+            migrateBuckets(TABLE_SIZES[m_oldSizeIndex]);
+        }
 
-        // create new double size buffer
+        // anonymous mappings come back zero-filled, so there is no
+        // table-sized memset to pay for here either
         void *memory = mmap(NULL, sizeof(HashNode*) * TABLE_SIZES[newSizeIndex], PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
         assert(memory);
-        HashNode **newBuckets = reinterpret_cast<HashNode**>(memory);
-        memset(newBuckets, 0, TABLE_SIZES[newSizeIndex] * sizeof(HashNode*));
-
-        // move all of the existing values
-        for (uint32_t i = 0; i < TABLE_SIZES[m_sizeIndex]; ++i) {
-            while (m_buckets[i]) {
-                HashNode *node = m_buckets[i];
-                m_buckets[i] = node->nextInBucket;
+        m_oldBuckets = m_buckets;
+        m_oldSizeIndex = m_sizeIndex;
+        m_migratedBuckets = 0;
+        m_buckets = reinterpret_cast<HashNode**>(memory);
+        m_sizeIndex = newSizeIndex;
+    }
 
-                uint64_t bucketOffset = node->hash % TABLE_SIZES[newSizeIndex];
-                node->nextInBucket = newBuckets[bucketOffset];
-                newBuckets[bucketOffset] = node;
+    template<class K, class T, class H, class EK, class ET>
+    void CompactingHashTable<K, T, H, EK, ET>::migrateBuckets(uint64_t count) {
+        assert(m_oldBuckets);
+        const uint64_t oldSize = TABLE_SIZES[m_oldSizeIndex];
+        for (; count > 0 && m_migratedBuckets < oldSize; --count) {
+            HashNode **oldBucket = &m_oldBuckets[m_migratedBuckets++];
+            while (*oldBucket) {
+                HashNode *node = *oldBucket;
+                *oldBucket = node->nextInBucket;
+
+                uint64_t bucketOffset = node->hash % TABLE_SIZES[m_sizeIndex];
+                node->nextInBucket = m_buckets[bucketOffset];
+                m_buckets[bucketOffset] = node;
             }
         }
-
-        // swap the table buffers
-        munmap(m_buckets, TABLE_SIZES[m_sizeIndex] * sizeof(HashNode*));
-        m_buckets = newBuckets;
-        m_sizeIndex = newSizeIndex;
+        if (m_migratedBuckets == oldSize) {
+            munmap(m_oldBuckets, oldSize * sizeof(HashNode*));
+            m_oldBuckets = NULL;
+            m_migratedBuckets = 0;
+        }
     }
 
     template<class K, class T, class H, class EK, class ET>
     bool CompactingHashTable<K, T, H, EK, ET> ::verify() {
         size_t manualCount = 0;
 
-        for (uint64_t bucketi = 0; bucketi < TABLE_SIZES[m_sizeIndex]; ++bucketi) {
-            for (HashNode *node = m_buckets[bucketi]; node; node = node->nextInBucket) {
-                if (m_unique) {
-                    uint64_t hash = m_hasher(node->key);
-                    if (hash != node->hash) {
+        if (!verifyBuckets(m_buckets, TABLE_SIZES[m_sizeIndex], manualCount)) {
+            return false;
+        }
+        if (m_oldBuckets && !verifyBuckets(m_oldBuckets, TABLE_SIZES[m_oldSizeIndex], manualCount)) {
+            return false;
+        }
+
+        if (manualCount != m_count) {
+            printf("Found %d nodes by walking all buffers, but expected %d nodes.\n",
+                   (int) manualCount, (int) m_count);
+            return false;
+        }
+        return true;
+    }
+
+    template<class K, class T, class H, class EK, class ET>
+    bool CompactingHashTable<K, T, H, EK, ET>::verifyBuckets(HashNode **buckets, uint64_t bucketCount, size_t &manualCount) {
+        for (uint64_t bucketi = 0; bucketi < bucketCount; ++bucketi) {
+            for (HashNode *node = buckets[bucketi]; node; node = node->nextInBucket) {
+                for (HashNode *node2 = node; node2; node2 = (m_unique ? NULL : node2->nextWithKey)) {
+                    uint64_t hash = m_hasher(node2->key);
+                    if (hash != node2->hash) {
                         printf("Node hash doesn't match expected value.\n");
                         return false;
                     }
-                    if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
+                    if (bucketFor(hash) != &buckets[bucketi]) {
                         printf("Node hash doesn't match expected bucket index.\n");
                         return false;
                     }
 
                     ++manualCount;
                 }
-                else {
-                    for (HashNode *node2 = node; node2; node2 = node2->nextWithKey) {
-                        uint64_t hash = m_hasher(node2->key);
-                        if (hash != node2->hash) {
-                            printf("Node hash doesn't match expected value.\n");
-                            return false;
-                        }
-                        if ((hash % TABLE_SIZES[m_sizeIndex]) != bucketi) {
-                            printf("Node hash doesn't match expected bucket index.\n");
-                            return false;
-                        }
-
-                        ++manualCount;
-                    }
-                }
             }
         }
-
-        if (manualCount != m_count) {
-            printf("Found %d nodes by walking all buffers, but expected %d nodes.\n",
-                   (int) manualCount, (int) m_count);
-            return false;
-        }
         return true;
     }
 }
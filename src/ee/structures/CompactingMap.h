@@ -184,6 +184,9 @@ public:
         void moveNext() { m_node = m_map->successor(m_node); }
         void movePrev() { m_node = m_map->predecessor(m_node); }
         bool isEnd() const { return ((!m_map) || (m_node == &(m_map->NIL))); }
+        // Looking ahead in a red-black tree costs as much as walking to it,
+        // so unlike CompactingBTree's iterator this never offers a value.
+        const Data *peekValue(int distance) const { return NULL; }
         bool equals(const iterator &iter) const {
             if (isEnd()) {
                 return iter.isEnd();
@@ -202,6 +205,15 @@ public:
     bool erase(const Key &key);
     bool erase(iterator &iter);
 
+    /**
+     * Fill an empty map with count entries already in ascending key order,
+     * building a balanced tree directly rather than inserting and
+     * rebalancing one entry at a time. The entries of a unique map must
+     * have distinct keys. SortedEntries provides key(i) and value(i).
+     */
+    template<typename SortedEntries>
+    void buildFromSorted(const SortedEntries &entries, int64_t count);
+
     iterator find(const Key &key) const { return iterator(this, lookup(key)); }
     iterator findRank(int64_t ith) const { return iterator(this, lookupRank(ith)); }
     int64_t size() const { return m_count; }
@@ -224,12 +236,22 @@ public:
 
     std::pair<iterator, iterator> equalRange(const Key &key) const;
 
+    // lowerBound for each of count keys, into results.
+    void lowerBounds(const Key *keys, int count, iterator *results) const
+    {
+        for (int ii = 0; ii < count; ++ii) {
+            results[ii] = lowerBound(keys[ii]);
+        }
+    }
+
     size_t bytesAllocated() const { return m_allocator.bytesAllocated(); }
 
     // TODO(xin): later rename it to rankLower
     // Must pass a key that already in map, or else return -1
     int64_t rankAsc(const Key& key) const;
     int64_t rankUpper(const Key& key) const;
+    // The rank of the iterator's own entry, or -1 at the end
+    int64_t rankOf(const iterator &iter) const;
 
     /**
      * For debugging: verify the RB-tree constraints are met. SLOW.
@@ -255,6 +277,10 @@ protected:
     TreeNode *successor(const TreeNode *x) const;
     TreeNode *predecessor(const TreeNode *x) const;
 
+    template<typename SortedEntries>
+    TreeNode *buildSubtree(const SortedEntries &entries, int64_t first, int64_t last,
+                           TreeNode *parent, int depth, int redDepth);
+
     // sub functions to make the magic happen
     void leftRotate(TreeNode *x);
     void rightRotate(TreeNode *x);
@@ -381,6 +407,49 @@ CompactingMap<KeyValuePair, Compare, hasRank>::insert(const Key &key, const Data
     return NULL;
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<typename SortedEntries>
+void CompactingMap<KeyValuePair, Compare, hasRank>::buildFromSorted(const SortedEntries &entries, int64_t count)
+{
+    assert(m_count == 0);
+    if (count == 0) {
+        return;
+    }
+    // Splitting each range at its middle puts every leaf at one of the two
+    // deepest levels. Coloring the nodes of the deepest level red when it
+    // is not full gives every path to a leaf the same number of black nodes.
+    int height = 0;
+    while ((static_cast<int64_t>(2) << height) - 1 < count) {
+        ++height;
+    }
+    bool perfect = (static_cast<int64_t>(2) << height) - 1 == count;
+    m_root = buildSubtree(entries, 0, count - 1, &NIL, 0, perfect ? -1 : height);
+    m_count = count;
+    assert(m_allocator.count() == m_count);
+}
+
+template<typename KeyValuePair, typename Compare, bool hasRank>
+template<typename SortedEntries>
+typename CompactingMap<KeyValuePair, Compare, hasRank>::TreeNode *
+CompactingMap<KeyValuePair, Compare, hasRank>::buildSubtree(const SortedEntries &entries,
+                                                            int64_t first, int64_t last,
+                                                            TreeNode *parent, int depth, int redDepth)
+{
+    if (first > last) {
+        return &NIL;
+    }
+    int64_t middle = first + (last - first) / 2;
+    TreeNode *z = new (m_allocator) TreeNode(&NIL, parent);
+    z->kv.setKeyValuePair(entries.key(middle), entries.value(middle));
+    z->color = (depth == redDepth) ? RED : BLACK;
+    z->left = buildSubtree(entries, first, middle - 1, z, depth + 1, redDepth);
+    z->right = buildSubtree(entries, middle + 1, last, z, depth + 1, redDepth);
+    if (hasRank) {
+        updateSubct(z);
+    }
+    return z;
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 typename CompactingMap<KeyValuePair, Compare, hasRank>::iterator
 CompactingMap<KeyValuePair, Compare, hasRank>::lowerBound(const Key &key) const
@@ -950,6 +1019,24 @@ int64_t CompactingMap<KeyValuePair, Compare, hasRank>::rankUpper(const Key& key)
     return rankAsc(it.key()) - 1;
 }
 
+template<typename KeyValuePair, typename Compare, bool hasRank>
+int64_t CompactingMap<KeyValuePair, Compare, hasRank>::rankOf(const iterator &iter) const
+{
+    if ((!hasRank) || iter.isEnd()) {
+        return -1;
+    }
+    // Unlike rankAsc, this tells apart entries with equal keys.
+    const TreeNode *x = iter.m_node;
+    int64_t ct = getSubct(x->left) + 1;
+    while (x->parent != &NIL) {
+        if (x->parent->right == x) {
+            ct += getSubct(x->parent->left) + 1;
+        }
+        x = x->parent;
+    }
+    return ct;
+}
+
 template<typename KeyValuePair, typename Compare, bool hasRank>
 typename CompactingMap<KeyValuePair, Compare, hasRank>::TreeNode*
 CompactingMap<KeyValuePair, Compare, hasRank>::lookupRank(int64_t ith) const
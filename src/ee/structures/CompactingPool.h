@@ -47,9 +47,10 @@ namespace voltdb
     {
     public:
         // Create a compacting pool.  As memory is required, it will
-        // allocate buffers of size elementSize * elementsPerBuffer bytes.
-    CompactingPool(int32_t elementSize, int32_t elementsPerBuffer)
-      : m_allocator(elementSize + FIXED_OVERHEAD_PER_ENTRY(), elementsPerBuffer)
+        // allocate buffers of up to elementSize * elementsPerBuffer bytes,
+        // starting from elementsInFirstBuffer elements when that is given.
+    CompactingPool(int32_t elementSize, int32_t elementsPerBuffer, int32_t elementsInFirstBuffer = 0)
+      : m_allocator(elementSize + FIXED_OVERHEAD_PER_ENTRY(), elementsPerBuffer, elementsInFirstBuffer)
     { }
 
     void* malloc(char** referrer)
@@ -97,6 +98,9 @@ namespace voltdb
     std::size_t getBytesAllocated() const
     { return m_allocator.bytesAllocated(); }
 
+    int64_t getCount() const
+    { return m_allocator.count(); }
+
     static int32_t FIXED_OVERHEAD_PER_ENTRY()
     { return static_cast<int32_t>(sizeof(Relocatable)); }
 
@@ -17,57 +17,68 @@
 
 #include "ContiguousAllocator.h"
 
+#include "common/ThreadLocalPool.h"
+
+#include <algorithm>
 #include <cassert>
 
 using namespace voltdb;
 
-ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize)
+ContiguousAllocator::ContiguousAllocator(int32_t allocSize, int32_t chunkSize, int32_t firstChunkSize)
     : m_count(0),
       m_allocationSize(allocSize),
       m_numberAllocationsPerBlock(chunkSize),
+      m_numberAllocationsInFirstBlock((firstChunkSize > 0 && firstChunkSize < chunkSize) ?
+                                      firstChunkSize : chunkSize),
       m_tail(NULL),
+      m_tailCount(0),
       m_blockCount(0),
+      m_bytesAllocated(0),
       m_cachedBuffer(0) {}
 
 ContiguousAllocator::~ContiguousAllocator() {
     while (m_tail) {
         Buffer *buf = m_tail->prev;
-        free(m_tail);
+        freeBuffer(m_tail);
         m_tail = buf;
     }
     if (m_cachedBuffer != NULL) {
-        free(m_cachedBuffer);
+        freeBuffer(m_cachedBuffer);
     }
 }
 
 void *ContiguousAllocator::alloc() {
     m_count++;
 
-    // determine where in the current block the new alloc will go
-    int64_t blockOffset = (m_count - 1) % m_numberAllocationsPerBlock;
-
     // if a new block is needed...
-    if (blockOffset == 0) {
-        void *memory;
-        if (m_cachedBuffer != NULL) {
-            memory = static_cast<void *>(m_cachedBuffer);
+    if (m_tail == NULL || m_tailCount == m_tail->capacity) {
+        Buffer *buf;
+        if (m_tail == NULL && m_cachedBuffer != NULL) {
+            buf = m_cachedBuffer;
             m_cachedBuffer = NULL;
         } else {
-            memory = static_cast<void *>(malloc(sizeof(Buffer) + m_allocationSize * m_numberAllocationsPerBlock));
+            int64_t capacity = m_numberAllocationsInFirstBlock;
+            if (m_tail != NULL) {
+                capacity = std::min(m_tail->capacity * 2,
+                                    static_cast<int64_t>(m_numberAllocationsPerBlock));
+            }
+            buf = reinterpret_cast<Buffer*>(ThreadLocalPool::allocateLargeBlock(bufferSize(capacity)));
+            buf->capacity = capacity;
         }
 
-        Buffer *buf = reinterpret_cast<Buffer*>(memory);
-
         // for debugging
-        //memset(buf, 0, sizeof(sizeof(Buffer) + m_allocSize * m_chunkSize));
+        //memset(buf->data, 0, m_allocationSize * buf->capacity);
 
         buf->prev = m_tail;
         m_tail = buf;
+        m_tailCount = 0;
         m_blockCount++;
+        m_bytesAllocated += static_cast<size_t>(m_allocationSize) * buf->capacity;
     }
 
     // get a pointer to where the new alloc will live
-    void *retval = m_tail->data + (m_allocationSize * blockOffset);
+    void *retval = m_tail->data + (m_allocationSize * m_tailCount);
+    m_tailCount++;
     assert(retval == last());
     return retval;
 }
@@ -76,9 +87,7 @@ void *ContiguousAllocator::last() const {
     assert(m_count > 0);
     assert(m_tail != NULL);
 
-    // determine where in the current block the last alloc is
-    int64_t blockOffset = (m_count - 1) % m_numberAllocationsPerBlock;
-    return m_tail->data + (m_allocationSize * blockOffset);
+    return m_tail->data + (m_allocationSize * (m_tailCount - 1));
 }
 
 void ContiguousAllocator::trim() {
@@ -89,26 +98,28 @@ void ContiguousAllocator::trim() {
     assert(m_tail != NULL);
 
     m_count--;
-
-    // determine where in the current block the last alloc is
-    int64_t blockOffset = m_count % m_numberAllocationsPerBlock;
+    m_tailCount--;
 
     // yay! kill a block
-    if (blockOffset == 0) {
+    if (m_tailCount == 0) {
         Buffer *buf = m_tail->prev;
         m_blockCount--;
+        m_bytesAllocated -= static_cast<size_t>(m_allocationSize) * m_tail->capacity;
         if (m_blockCount == 0) {
             m_cachedBuffer = m_tail;
         } else {
-            free(m_tail);
+            freeBuffer(m_tail);
         }
         m_tail = buf;
+        // blocks before the tail are full
+        m_tailCount = (m_tail != NULL) ? m_tail->capacity : 0;
     }
 }
 
+void ContiguousAllocator::freeBuffer(Buffer *buf) const {
+    ThreadLocalPool::freeLargeBlock(reinterpret_cast<char*>(buf), bufferSize(buf->capacity));
+}
+
 size_t ContiguousAllocator::bytesAllocated() const {
-    size_t total = static_cast<size_t>(m_blockCount) *
-        static_cast<size_t>(m_allocationSize) *
-        static_cast<size_t>(m_numberAllocationsPerBlock);
-    return total;
+    return m_bytesAllocated;
 }
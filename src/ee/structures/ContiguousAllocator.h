@@ -32,8 +32,12 @@ namespace voltdb {
  * allocation's data may be recovered.  The clients all do this.
  *
  * A *block* is a fixed size allocation, which has been obtained from
- * malloc(3). These are chained together.  They are all the same size
- * in bytes.  This size is set when the allocator is constructed.
+ * ThreadLocalPool::allocateLargeBlock, so blocks of 2MB or more may be
+ * backed by huge pages. These are chained together.  Blocks after the first
+ * hold twice as many allocations as the one before, up to the number set
+ * when the allocator is constructed, so an allocator that stays small does
+ * not hold on to a block sized for a large one.  By default every block is
+ * the full size.
  *
  * The head of the chain of blocks is the *tail block*.  Blocks which
  * are not the tail block are completely full.
@@ -50,36 +54,53 @@ class ContiguousAllocator {
      */
     struct Buffer {
         Buffer *prev;
+        /** The number of allocations this block holds. */
+        int64_t capacity;
         char data[0];
     };
     /** This is the total number of allocations in use in all blocks. */
     int64_t m_count;
     /** This is the size of a allocation for this allocator in bytes. */
     const int32_t m_allocationSize;
-    /** This is the number of allocations in each block in this allocator. */
+    /** This is the most allocations any block in this allocator holds. */
     const int32_t m_numberAllocationsPerBlock;
+    /** This is the number of allocations the first block holds. */
+    const int32_t m_numberAllocationsInFirstBlock;
     /**
-     * This points to the tail buffer.  When m_count % m_chunkSize reaches
-     * zero and we want a new node we must allocate a new block.  The address
-     * of the last node is then m_tail->data + (m_count - 1) * m_allocSize.
+     * This points to the tail buffer.  When m_tailCount reaches the tail's
+     * capacity and we want a new node we must allocate a new block.  The
+     * address of the last node is then m_tail->data + (m_tailCount - 1) * m_allocSize.
      */
     Buffer *m_tail;
+    /** This is the number of allocations in use in the tail block. */
+    int64_t m_tailCount;
     /** This is the number of blocks in this allocation. */
     int32_t m_blockCount;
+    /** This is the number of bytes of allocations the blocks hold. */
+    size_t m_bytesAllocated;
     /**
      * This is the last deleted block.  If all the allocations are
      * returned, then we cached the last block here, to avoid thrashing
-     * the allocator.
+     * the allocator.  It is always a first block.
      */
     Buffer *m_cachedBuffer;
 
+    /** The size in bytes of a block of capacity allocations, including its header. */
+    size_t bufferSize(int64_t capacity) const {
+        return sizeof(Buffer) + static_cast<size_t>(m_allocationSize) * capacity;
+    }
+
+    void freeBuffer(Buffer *buf) const;
+
 public:
 
     /**
      * @param allocSize is the size in bytes of individual allocations.
      * @param chunkSize is the number of allocations per block (not bytes).
+     * @param firstChunkSize is the number of allocations in the first block,
+     *        which later blocks double up to chunkSize.  Zero means chunkSize.
      */
-    ContiguousAllocator(int32_t allocSize, int32_t chunkSize);
+    ContiguousAllocator(int32_t allocSize, int32_t chunkSize, int32_t firstChunkSize = 0);
     ~ContiguousAllocator();
 
     /**
@@ -0,0 +1,230 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDIGEST_H_
+#define TDIGEST_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <stdint.h>
+
+namespace voltdb {
+
+/**
+ * A merging t-digest: a summary of a stream of numbers that answers
+ * quantile queries to within a small relative rank error, most accurately
+ * near the tails. Values are kept as weighted centroids whose sizes are
+ * bounded by the arcsine scale function, so there are never more than
+ * about compression of them however many values were added.
+ *
+ * Digests merge, so each partition can build one over its own rows and
+ * the coordinator can combine the serialized digests.
+ */
+class TDigest {
+public:
+    static const int DEFAULT_COMPRESSION = 100;
+
+    explicit TDigest(int compression = DEFAULT_COMPRESSION)
+        : m_compression(compression)
+        , m_totalWeight(0)
+        , m_min(std::numeric_limits<double>::infinity())
+        , m_max(-std::numeric_limits<double>::infinity())
+    { }
+
+    void add(double value, double weight = 1) {
+        m_buffer.push_back(Centroid(value, weight));
+        m_totalWeight += weight;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        if (m_buffer.size() >= BUFFER_FACTOR * static_cast<size_t>(m_compression)) {
+            compress();
+        }
+    }
+
+    void merge(const TDigest &other) {
+        m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+        m_buffer.insert(m_buffer.end(), other.m_buffer.begin(), other.m_buffer.end());
+        m_totalWeight += other.m_totalWeight;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+        compress();
+    }
+
+    bool empty() const { return m_totalWeight == 0; }
+
+    double totalWeight() const { return m_totalWeight; }
+
+    void clear() {
+        m_centroids.clear();
+        m_buffer.clear();
+        m_totalWeight = 0;
+        m_min = std::numeric_limits<double>::infinity();
+        m_max = -std::numeric_limits<double>::infinity();
+    }
+
+    /** The number of centroids once any buffered values are merged in. */
+    size_t centroidCount() {
+        compress();
+        return m_centroids.size();
+    }
+
+    /**
+     * The estimated value at the given fraction (0 to 1) of the way
+     * through the sorted values. The digest must not be empty.
+     */
+    double quantile(double fraction) {
+        compress();
+        if (m_centroids.size() == 1 || fraction <= 0) {
+            return fraction <= 0 ? m_min : m_centroids[0].m_mean;
+        }
+        if (fraction >= 1) {
+            return m_max;
+        }
+
+        // Each centroid's mean is taken to sit at the middle of its
+        // weight; interpolate between neighbouring middles, and between
+        // the extremes and the middles of the end centroids.
+        const double index = fraction * m_totalWeight;
+        const Centroid &first = m_centroids.front();
+        if (index < first.m_weight / 2) {
+            return m_min + (index / (first.m_weight / 2)) * (first.m_mean - m_min);
+        }
+        double weightSoFar = first.m_weight / 2;
+        for (size_t ii = 0; ii + 1 < m_centroids.size(); ii++) {
+            const Centroid &left = m_centroids[ii];
+            const Centroid &right = m_centroids[ii + 1];
+            double gap = (left.m_weight + right.m_weight) / 2;
+            if (index < weightSoFar + gap) {
+                return left.m_mean + ((index - weightSoFar) / gap) * (right.m_mean - left.m_mean);
+            }
+            weightSoFar += gap;
+        }
+        const Centroid &last = m_centroids.back();
+        double tail = (index - weightSoFar) / (last.m_weight / 2);
+        return last.m_mean + std::min(tail, 1.0) * (m_max - last.m_mean);
+    }
+
+    /** Write the digest with writeInt and writeDouble calls. */
+    template<class Output>
+    void serializeTo(Output &out) {
+        compress();
+        out.writeInt(static_cast<int32_t>(m_centroids.size()));
+        out.writeDouble(m_min);
+        out.writeDouble(m_max);
+        for (size_t ii = 0; ii < m_centroids.size(); ii++) {
+            out.writeDouble(m_centroids[ii].m_mean);
+            out.writeDouble(m_centroids[ii].m_weight);
+        }
+    }
+
+    /** Merge in a digest written by serializeTo. */
+    template<class Input>
+    void mergeFrom(Input &in) {
+        int32_t count = in.readInt();
+        double min = in.readDouble();
+        double max = in.readDouble();
+        for (int32_t ii = 0; ii < count; ii++) {
+            double mean = in.readDouble();
+            double weight = in.readDouble();
+            m_buffer.push_back(Centroid(mean, weight));
+            m_totalWeight += weight;
+        }
+        if (count > 0) {
+            m_min = std::min(m_min, min);
+            m_max = std::max(m_max, max);
+        }
+        compress();
+    }
+
+private:
+    // Values are buffered and merged this many times compression at once.
+    static const size_t BUFFER_FACTOR = 5;
+
+    struct Centroid {
+        Centroid(double mean, double weight) : m_mean(mean), m_weight(weight) { }
+
+        bool operator<(const Centroid &other) const { return m_mean < other.m_mean; }
+
+        double m_mean;
+        double m_weight;
+    };
+
+    // The arcsine scale function and its inverse: a centroid may only
+    // span one unit of k, which keeps those near either end small.
+    double scale(double fraction) const {
+        return m_compression / (2 * M_PI) * std::asin(2 * fraction - 1);
+    }
+
+    double inverseScale(double k) const {
+        return (std::sin(k * 2 * M_PI / m_compression) + 1) / 2;
+    }
+
+    // How much weight may come before the end of a centroid that starts
+    // after weightSoFar.
+    double nextWeightLimit(double weightSoFar) const {
+        double k = scale(weightSoFar / m_totalWeight) + 1;
+        if (k >= m_compression / 4.0) {
+            return m_totalWeight;
+        }
+        return m_totalWeight * inverseScale(k);
+    }
+
+    void compress() {
+        if (m_buffer.empty()) {
+            return;
+        }
+        m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+        std::sort(m_buffer.begin(), m_buffer.end());
+        m_centroids.clear();
+
+        Centroid current = m_buffer[0];
+        double weightSoFar = 0;
+        double weightLimit = nextWeightLimit(weightSoFar);
+        for (size_t ii = 1; ii < m_buffer.size(); ii++) {
+            const Centroid &next = m_buffer[ii];
+            if (weightSoFar + current.m_weight + next.m_weight <= weightLimit) {
+                double weight = current.m_weight + next.m_weight;
+                current.m_mean += (next.m_mean - current.m_mean) * next.m_weight / weight;
+                current.m_weight = weight;
+            }
+            else {
+                weightSoFar += current.m_weight;
+                m_centroids.push_back(current);
+                weightLimit = nextWeightLimit(weightSoFar);
+                current = next;
+            }
+        }
+        m_centroids.push_back(current);
+        m_buffer.clear();
+    }
+
+    int m_compression;
+    // Merged centroids, in order of their means.
+    std::vector<Centroid> m_centroids;
+    // Values and centroids not yet merged, in no order.
+    std::vector<Centroid> m_buffer;
+    double m_totalWeight;
+    double m_min;
+    double m_max;
+};
+
+} // namespace voltdb
+
+#endif // TDIGEST_H_
@@ -35,8 +35,10 @@
 #include "common/SegvException.hpp"
 #include "common/types.h"
 
+#include <algorithm>
 #include <signal.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/tcp.h> // for TCP_NODELAY
 
 // Please don't make this different from the JNI result buffer size.
@@ -50,6 +52,60 @@ class StreamBlock;
 class Table;
 }
 
+/*
+ * Reads from the socket to Java through a buffer. Java often sends a
+ * command's header and body, or a response code and the bytes after it,
+ * back to back, so these arrive with one read rather than one per field.
+ * Large bodies are read straight into the destination.
+ */
+class SocketReader {
+public:
+    SocketReader(int fd) : m_fd(fd), m_start(0), m_end(0) { }
+
+    /*
+     * Read sz bytes into data. Returns sz, fewer if Java closed the socket
+     * first, or -1 on an error.
+     */
+    ssize_t readFully(char *data, size_t sz) {
+        size_t done = 0;
+        while (done < sz) {
+            if (m_start < m_end) {
+                size_t count = std::min(m_end - m_start, sz - done);
+                ::memcpy(data + done, m_buffer + m_start, count);
+                m_start += count;
+                done += count;
+                continue;
+            }
+            ssize_t got;
+            if (sz - done >= BUFFER_SIZE) {
+                got = ::read(m_fd, data + done, sz - done);
+                if (got > 0) {
+                    done += got;
+                }
+            } else {
+                got = ::read(m_fd, m_buffer, BUFFER_SIZE);
+                m_start = 0;
+                m_end = got > 0 ? static_cast<size_t>(got) : 0;
+            }
+            if (got == 0) {
+                break;
+            }
+            if (got < 0) {
+                return -1;
+            }
+        }
+        return static_cast<ssize_t>(done);
+    }
+
+private:
+    static const size_t BUFFER_SIZE = 64 * 1024;
+
+    int m_fd;
+    size_t m_start;
+    size_t m_end;
+    char m_buffer[BUFFER_SIZE];
+};
+
 class VoltDBIPC : public voltdb::Topend {
 public:
 
@@ -110,6 +166,8 @@ public:
 
     bool execute(struct ipc_command *cmd);
 
+    SocketReader& reader() { return m_reader; }
+
     int64_t pushDRBuffer(int32_t partitionId, voltdb::StreamBlock *block);
 
     /**
@@ -178,6 +236,12 @@ private:
 
     void threadLocalPoolAllocations();
 
+    void hugePageAllocations();
+
+    void localNodeAllocations();
+
+    void memoryDetail();
+
     void applyBinaryLog(struct ipc_command*);
 
     void executeTask(struct ipc_command*);
@@ -194,6 +258,7 @@ private:
     void setupSigHandler(void) const;
 
     int m_fd;
+    SocketReader m_reader;
     char *m_reusedResultBuffer;
     char *m_exceptionBuffer;
     bool m_terminate;
@@ -381,6 +446,28 @@ static void writeOrDie(int fd, const unsigned char *data, ssize_t sz) {
     }
 }
 
+// As above, but for a header and a body, which go out together in as few
+// segments as the socket allows rather than as two.
+static void writeOrDie(int fd, const unsigned char *header, ssize_t headerSz,
+                       const unsigned char *body, ssize_t bodySz) {
+    struct iovec parts[2];
+    parts[0].iov_base = const_cast<unsigned char*>(header);
+    parts[0].iov_len = headerSz;
+    parts[1].iov_base = const_cast<unsigned char*>(body);
+    parts[1].iov_len = bodySz;
+    ssize_t last = writev(fd, parts, 2);
+    if (last < 0) {
+        printf("\n\nIPC write to JNI returned -1. Exiting\n\n");
+        fflush(stdout);
+        exit(-1);
+    }
+    if (last < headerSz) {
+        writeOrDie(fd, header + last, headerSz - last);
+        last = headerSz;
+    }
+    writeOrDie(fd, body + (last - headerSz), bodySz - (last - headerSz));
+}
+
 
 /**
  * Utility used for deserializing ParameterSet passed from Java.
@@ -392,7 +479,7 @@ void deserializeParameterSetCommon(int cnt, ReferenceSerializeInputBE &serialize
     }
 }
 
-VoltDBIPC::VoltDBIPC(int fd) : m_fd(fd) {
+VoltDBIPC::VoltDBIPC(int fd) : m_fd(fd), m_reader(fd) {
     currentVolt = this;
     m_engine = NULL;
     m_counter = 0;
@@ -508,6 +595,18 @@ bool VoltDBIPC::execute(struct ipc_command *cmd) {
           applyBinaryLog(cmd);
           result = kErrorCode_None;
           break;
+      case 30:
+          hugePageAllocations();
+          result = kErrorCode_None;
+          break;
+      case 31:
+          localNodeAllocations();
+          result = kErrorCode_None;
+          break;
+      case 32:
+          memoryDetail();
+          result = kErrorCode_None;
+          break;
       default:
         result = stub(cmd);
     }
@@ -811,8 +910,6 @@ void VoltDBIPC::executePlanFragments(struct ipc_command *cmd) {
 }
 
 void VoltDBIPC::sendException(int8_t errorCode) {
-    writeOrDie(m_fd, (unsigned char*)&errorCode, sizeof(int8_t));
-
     const void* exceptionData =
       m_engine->getExceptionOutputSerializer()->data();
     int32_t exceptionLength =
@@ -823,7 +920,8 @@ void VoltDBIPC::sendException(int8_t errorCode) {
     fflush(stdout);
 
     const std::size_t expectedSize = exceptionLength + sizeof(int32_t);
-    writeOrDie(m_fd, (const unsigned char*)exceptionData, expectedSize);
+    writeOrDie(m_fd, (const unsigned char*)&errorCode, sizeof(int8_t),
+               (const unsigned char*)exceptionData, expectedSize);
 }
 
 int8_t VoltDBIPC::loadTable(struct ipc_command *cmd) {
@@ -921,7 +1019,7 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
 
     // read java's response code
     int8_t responseCode;
-    ssize_t bytes = read(m_fd, &responseCode, sizeof(int8_t));
+    ssize_t bytes = m_reader.readFully(reinterpret_cast<char*>(&responseCode), sizeof(int8_t));
     if (bytes != sizeof(int8_t)) {
         printf("Error - blocking read failed. %jd read %jd attempted",
                 (intmax_t)bytes, (intmax_t)sizeof(int8_t));
@@ -943,7 +1041,7 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
 
     // start reading the dependency. its length is first
     int32_t dependencyLength;
-    bytes = read(m_fd, &dependencyLength, sizeof(int32_t));
+    bytes = m_reader.readFully(reinterpret_cast<char*>(&dependencyLength), sizeof(int32_t));
     if (bytes != sizeof(int32_t)) {
         printf("Error - blocking read failed. %jd read %jd attempted",
                 (intmax_t)bytes, (intmax_t)sizeof(int32_t));
@@ -952,21 +1050,10 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
         exit(-1);
     }
 
-    bytes = 0;
     dependencyLength = ntohl(dependencyLength);
     *dependencySz = (size_t)dependencyLength;
     char *dependencyData = new char[dependencyLength];
-    while (bytes != dependencyLength) {
-        ssize_t oldBytes = bytes;
-        bytes += read(m_fd, dependencyData + bytes, dependencyLength - bytes);
-        if (oldBytes == bytes) {
-            break;
-        }
-        if (oldBytes > bytes) {
-            bytes++;
-            break;
-        }
-    }
+    bytes = m_reader.readFully(dependencyData, dependencyLength);
 
     if (bytes != dependencyLength) {
         printf("Error - blocking read failed. %jd read %jd attempted",
@@ -982,9 +1069,9 @@ char *VoltDBIPC::retrieveDependency(int32_t dependencyId, size_t *dependencySz)
 //   Reads a 4-byte integer from fd that is the length of the following string
 //   Reads the bytes for the string
 //   Returns those bytes as an std::string
-static std::string readLengthPrefixedBytesToStdString(int fd) {
+static std::string readLengthPrefixedBytesToStdString(SocketReader &reader) {
     int32_t length;
-    ssize_t numBytesRead = read(fd, &length, sizeof(int32_t));
+    ssize_t numBytesRead = reader.readFully(reinterpret_cast<char*>(&length), sizeof(int32_t));
     if (numBytesRead != sizeof(int32_t)) {
         printf("Error - blocking read of plan bytes length failed. %jd read %jd attempted",
                (intmax_t)numBytesRead, (intmax_t)sizeof(int32_t));
@@ -996,18 +1083,7 @@ static std::string readLengthPrefixedBytesToStdString(int fd) {
     assert(length > 0);
 
     boost::scoped_array<char> bytes(new char[length + 1]);
-    numBytesRead = 0;
-    while (numBytesRead != length) {
-        ssize_t oldBytes = numBytesRead;
-        numBytesRead += read(fd, bytes.get() + numBytesRead, length - numBytesRead);
-        if (oldBytes == numBytesRead) {
-            break;
-        }
-        if (oldBytes > numBytesRead) {
-            numBytesRead++;
-            break;
-        }
-    }
+    numBytesRead = reader.readFully(bytes.get(), length);
 
     if (numBytesRead != length) {
         printf("Error - blocking read of plan bytes failed. %jd read %jd attempted",
@@ -1040,7 +1116,7 @@ std::string VoltDBIPC::decodeBase64AndDecompress(const std::string& base64Data)
 
     writeOrDie(m_fd, message, messageSize);
 
-    return readLengthPrefixedBytesToStdString(m_fd);
+    return readLengthPrefixedBytesToStdString(m_reader);
 }
 
 std::string VoltDBIPC::planForFragmentId(int64_t fragmentId) {
@@ -1048,7 +1124,7 @@ std::string VoltDBIPC::planForFragmentId(int64_t fragmentId) {
     message[0] = static_cast<int8_t>(kErrorCode_needPlan);
     *reinterpret_cast<int64_t*>(&message[1]) = htonll(fragmentId);
     writeOrDie(m_fd, (unsigned char*)message, sizeof(int8_t) + sizeof(int64_t));
-    return readLengthPrefixedBytesToStdString(m_fd);
+    return readLengthPrefixedBytesToStdString(m_reader);
 }
 
 static bool progressUpdateDisabled = true;
@@ -1098,7 +1174,7 @@ int64_t VoltDBIPC::fragmentProgressUpdate(
     }
 
     int64_t nextStep;
-    ssize_t bytes = read(m_fd, &nextStep, sizeof(nextStep));
+    ssize_t bytes = m_reader.readFully(reinterpret_cast<char*>(&nextStep), sizeof(nextStep));
     if (bytes != sizeof(nextStep)) {
         printf("Error - blocking read after progress update failed. %jd read %jd attempted",
                 (intmax_t)bytes, (intmax_t)sizeof(nextStep));
@@ -1204,17 +1280,17 @@ void VoltDBIPC::getStats(struct ipc_command *cmd) {
         // write the results array back across the wire
         const int8_t successResult = kErrorCode_Success;
         if (result == 0 || result == 1) {
-            writeOrDie(m_fd, (const unsigned char*)&successResult, sizeof(int8_t));
-
             if (result == 1) {
                 const int32_t size = m_engine->getResultsSize();
                 // write the dependency tables back across the wire
                 // the result set includes the total serialization size
-                writeOrDie(m_fd, (unsigned char*)(m_engine->getReusedResultBuffer()), size);
+                writeOrDie(m_fd, (const unsigned char*)&successResult, sizeof(int8_t),
+                           (unsigned char*)(m_engine->getReusedResultBuffer()), size);
             }
             else {
                 int32_t zero = 0;
-                writeOrDie(m_fd, (const unsigned char*)&zero, sizeof(int32_t));
+                writeOrDie(m_fd, (const unsigned char*)&successResult, sizeof(int8_t),
+                           (const unsigned char*)&zero, sizeof(int32_t));
             }
         } else {
             sendException(kErrorCode_Error);
@@ -1487,6 +1563,33 @@ void VoltDBIPC::threadLocalPoolAllocations() {
     writeOrDie(m_fd, (unsigned char*)response, 9);
 }
 
+void VoltDBIPC::memoryDetail() {
+    int64_t counters[MEMORY_DETAIL_COUNT];
+    m_engine->getMemoryDetail(counters);
+    char response[1 + sizeof(counters)];
+    response[0] = kErrorCode_Success;
+    for (int i = 0; i < MEMORY_DETAIL_COUNT; ++i) {
+        *reinterpret_cast<int64_t*>(&response[1 + i * sizeof(int64_t)]) = htonll(counters[i]);
+    }
+    writeOrDie(m_fd, (unsigned char*)response, sizeof(response));
+}
+
+void VoltDBIPC::hugePageAllocations() {
+    std::size_t hugePageAllocations = ThreadLocalPool::getHugePageAllocationSize();
+    char response[9];
+    response[0] = kErrorCode_Success;
+    *reinterpret_cast<std::size_t*>(&response[1]) = htonll(hugePageAllocations);
+    writeOrDie(m_fd, (unsigned char*)response, 9);
+}
+
+void VoltDBIPC::localNodeAllocations() {
+    std::size_t localNodeAllocations = ThreadLocalPool::getLocalNodeAllocationSize();
+    char response[9];
+    response[0] = kErrorCode_Success;
+    *reinterpret_cast<std::size_t*>(&response[1]) = htonll(localNodeAllocations);
+    writeOrDie(m_fd, (unsigned char*)response, 9);
+}
+
 int64_t VoltDBIPC::getQueuedExportBytes(int32_t partitionId, std::string signature) {
     m_reusedResultBuffer[0] = kErrorCode_getQueuedExportBytes;
     *reinterpret_cast<int32_t*>(&m_reusedResultBuffer[1]) = htonl(partitionId);
@@ -1495,7 +1598,7 @@ int64_t VoltDBIPC::getQueuedExportBytes(int32_t partitionId, std::string signatu
     writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, 9 + signature.size());
 
     int64_t netval;
-    ssize_t bytes = read(m_fd, &netval, sizeof(int64_t));
+    ssize_t bytes = m_reader.readFully(reinterpret_cast<char*>(&netval), sizeof(int64_t));
     if (bytes != sizeof(int64_t)) {
         printf("Error - blocking read of queued export byte count failed. %jd read %jd attempted",
                 (intmax_t)bytes, (intmax_t)sizeof(int64_t));
@@ -1538,10 +1641,10 @@ void VoltDBIPC::pushExportBuffer(
             static_cast<int8_t>(1) : static_cast<int8_t>(0);
     if (block != NULL) {
         *reinterpret_cast<int32_t*>(&m_reusedResultBuffer[index]) = htonl(block->rawLength());
-        writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, index + 4);
         // Memset the first 8 bytes to initialize the MAGIC_HEADER_SPACE_FOR_JAVA
         ::memset(block->rawPtr(), 0, 8);
-        writeOrDie(m_fd, (unsigned char*)block->rawPtr(), block->rawLength());
+        writeOrDie(m_fd, (unsigned char*)m_reusedResultBuffer, index + 4,
+                   (unsigned char*)block->rawPtr(), block->rawLength());
         // Need the delete in the if statement for valgrind
         delete [] block->rawPtr();
     } else {
@@ -1621,23 +1724,22 @@ void *eethread(void *ptr) {
 
     // loop until the terminate/shutdown command is seen
     bool terminated = false;
+    SocketReader &reader = voltipc->reader();
     while ( ! terminated) {
         size_t bytesread = 0;
 
         // read the header
-        while (bytesread < 4) {
-            std::size_t b = read(fd, data.get() + bytesread, 4 - bytesread);
-            if (b == 0) {
-                printf("client eof\n");
-                close(fd);
-                return NULL;
-            } else if (b == -1) {
-                printf("client error\n");
-                close(fd);
-                return NULL;
-            }
-            bytesread += b;
+        ssize_t b = reader.readFully(data.get(), 4);
+        if (b == -1) {
+            printf("client error\n");
+            close(fd);
+            return NULL;
+        } else if (b != 4) {
+            printf("client eof\n");
+            close(fd);
+            return NULL;
         }
+        bytesread += b;
 
         // read the message body in to the same data buffer
         int msg_size = ntohl(((struct ipc_command*) data.get())->msgsize);
@@ -1652,14 +1754,14 @@ void *eethread(void *ptr) {
             data.reset(newdata);
         }
 
-        while (bytesread < msg_size) {
-            std::size_t b = read(fd, data.get() + bytesread, msg_size - bytesread);
-            if (b == 0) {
-                printf("client eof\n");
+        if (bytesread < msg_size) {
+            b = reader.readFully(data.get() + bytesread, msg_size - bytesread);
+            if (b == -1) {
+                printf("client error\n");
                 close(fd);
                 return NULL;
-            } else if (b == -1) {
-                printf("client error\n");
+            } else if (b != static_cast<ssize_t>(msg_size - bytesread)) {
+                printf("client eof\n");
                 close(fd);
                 return NULL;
             }
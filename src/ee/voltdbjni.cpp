@@ -269,7 +269,15 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
     jint defaultDrBufferSize,
     jlong tempTableMemory,
     jboolean createDrReplicatedStream,
-    jint compactionThreshold)
+    jint compactionThreshold,
+    jbyteArray coldStorageDirectory,
+    jlong maxResidentTupleBlockMemory,
+    jbyteArray tempTableSpillDirectory,
+    jint slowFragmentMillis,
+    jboolean redactSlowFragmentParameters,
+    jint stackSampleHz,
+    jint packedStringMaxLength,
+    jint loadHelperThreads)
 {
     VOLT_DEBUG("nativeInitialize() start");
     VoltDBEngine *engine = castToEngine(enginePtr);
@@ -284,6 +292,14 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
         jbyte *hostChars = env->GetByteArrayElements( hostname, NULL);
         std::string hostString(reinterpret_cast<char*>(hostChars), env->GetArrayLength(hostname));
         env->ReleaseByteArrayElements( hostname, hostChars, JNI_ABORT);
+        jbyte *coldStorageChars = env->GetByteArrayElements( coldStorageDirectory, NULL);
+        std::string coldStorageString(reinterpret_cast<char*>(coldStorageChars),
+                                      env->GetArrayLength(coldStorageDirectory));
+        env->ReleaseByteArrayElements( coldStorageDirectory, coldStorageChars, JNI_ABORT);
+        jbyte *spillChars = env->GetByteArrayElements( tempTableSpillDirectory, NULL);
+        std::string spillString(reinterpret_cast<char*>(spillChars),
+                                env->GetArrayLength(tempTableSpillDirectory));
+        env->ReleaseByteArrayElements( tempTableSpillDirectory, spillChars, JNI_ABORT);
         // initialization is separated from constructor so that constructor
         // never fails.
         VOLT_DEBUG("calling initialize...");
@@ -297,7 +313,15 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeIniti
                                    defaultDrBufferSize,
                                    tempTableMemory,
                                    createDrReplicatedStream,
-                                   static_cast<int32_t>(compactionThreshold));
+                                   static_cast<int32_t>(compactionThreshold),
+                                   coldStorageString,
+                                   maxResidentTupleBlockMemory,
+                                   spillString,
+                                   static_cast<int32_t>(slowFragmentMillis),
+                                   redactSlowFragmentParameters,
+                                   static_cast<int32_t>(stackSampleHz),
+                                   static_cast<int32_t>(packedStringMaxLength),
+                                   static_cast<int32_t>(loadHelperThreads));
         if (success) {
             VOLT_DEBUG("initialize succeeded");
             return org_voltdb_jni_ExecutionEngine_ERRORCODE_SUCCESS;
@@ -609,6 +633,56 @@ SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecu
     return org_voltdb_jni_ExecutionEngine_ERRORCODE_ERROR;
 }
 
+/**
+ * Executes the fragment batches of several single-partition transactions
+ * with one call, each under its own undo token.
+ * @param engine_ptr the VoltDBEngine pointer
+ * @param num_transactions number of transactions in the batch
+ * @param transaction_info fragment count, txnId, spHandle,
+ *        lastCommittedSpHandle, uniqueId and undoToken of each transaction
+ * @param plan_fragment_ids the transactions' fragment ids, back to back
+ * @return the number of transactions that completed. Any after the first
+ *         failure are not run.
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecuteTransactionBatch
+(JNIEnv *env,
+        jobject obj,
+        jlong engine_ptr,
+        jint num_transactions,
+        jlongArray transaction_info,
+        jlongArray plan_fragment_ids)
+{
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    assert(engine);
+    Topend *topend = static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    try {
+        updateJNILogProxy(engine); //JNIEnv pointer can change between calls, must be updated
+        engine->resetReusedResultOutputBuffer();
+
+        std::vector<jlong> transactionInfo(num_transactions * TXN_BATCH_INFO_FIELDS);
+        env->GetLongArrayRegion(transaction_info, 0, num_transactions * TXN_BATCH_INFO_FIELDS,
+                                &transactionInfo[0]);
+
+        // fragment info for all the transactions
+        jsize num_fragments = env->GetArrayLength(plan_fragment_ids);
+        assert (num_fragments <= MAX_BATCH_COUNT);
+        jlong* fragmentIdsBuffer = engine->getBatchFragmentIdsContainer();
+        env->GetLongArrayRegion(plan_fragment_ids, 0, num_fragments, fragmentIdsBuffer);
+
+        // all transactions' parameters are in this buffer
+        ReferenceSerializeInputBE serialize_in(engine->getParameterBuffer(), engine->getParameterBufferCapacity());
+
+        return engine->executeTransactionBatch(num_transactions,
+                                               &transactionInfo[0],
+                                               fragmentIdsBuffer,
+                                               serialize_in);
+    }
+    catch (const FatalException &e) {
+        topend->crashVoltDB(e);
+    }
+    return 0;
+}
+
 /**
  * Serialize the result temporary table.
  * @param engine_ptr the VoltDBEngine pointer
@@ -1143,6 +1217,70 @@ SHAREDLIB_JNIEXPORT jlongArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativ
     return NULL;
 }
 
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetMemoryDetail
+ * Signature: (J)[J
+ */
+SHAREDLIB_JNIEXPORT jlongArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetMemoryDetail
+  (JNIEnv *env, jobject obj, jlong engine_ptr) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    int64_t counters[MEMORY_DETAIL_COUNT];
+    engine->getMemoryDetail(counters);
+    jlong data[MEMORY_DETAIL_COUNT];
+    for (int i = 0; i < MEMORY_DETAIL_COUNT; ++i) {
+        data[i] = counters[i];
+    }
+    jlongArray retval = env->NewLongArray(MEMORY_DETAIL_COUNT);
+    env->SetLongArrayRegion(retval, 0, MEMORY_DETAIL_COUNT, data);
+    return retval;
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetUpcallStats
+ * Signature: (J)[J
+ */
+SHAREDLIB_JNIEXPORT jlongArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetUpcallStats
+  (JNIEnv *env, jobject obj, jlong engine_ptr) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    const int count = 2 * JNITopend::UPCALL_COUNT;
+    int64_t counters[count];
+    static_cast<JNITopend*>(engine->getTopend())->getUpcallStats(counters);
+    jlong data[count];
+    for (int i = 0; i < count; ++i) {
+        data[i] = counters[i];
+    }
+    jlongArray retval = env->NewLongArray(count);
+    env->SetLongArrayRegion(retval, 0, count, data);
+    return retval;
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetNativeStacks
+ * Signature: (J)[B
+ */
+SHAREDLIB_JNIEXPORT jbyteArray JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetNativeStacks
+  (JNIEnv *env, jobject obj, jlong engine_ptr) {
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    const std::string stacks = engine->getNativeStacks();
+    jbyteArray retval = env->NewByteArray(static_cast<jsize>(stacks.size()));
+    env->SetByteArrayRegion(retval, 0, static_cast<jsize>(stacks.size()),
+                            reinterpret_cast<const jbyte*>(stacks.data()));
+    return retval;
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeSetStackSampleRate
+ * Signature: (I)V
+ */
+SHAREDLIB_JNIEXPORT void JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeSetStackSampleRate
+  (JNIEnv *, jclass, jint hz) {
+    StackSampler::setRate(static_cast<int32_t>(hz));
+}
+
 /*
  * Class:     org_voltdb_jni_ExecutionEngine
  * Method:    nativeProcessRecoveryMessage
@@ -1247,6 +1385,26 @@ SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetT
     return ThreadLocalPool::getPoolAllocationSize();
 }
 
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetHugePageAllocations
+ * Signature: ()J
+ */
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetHugePageAllocations
+  (JNIEnv *, jclass) {
+    return ThreadLocalPool::getHugePageAllocationSize();
+}
+
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeGetLocalNodeAllocations
+ * Signature: ()J
+ */
+SHAREDLIB_JNIEXPORT jlong JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeGetLocalNodeAllocations
+  (JNIEnv *, jclass) {
+    return ThreadLocalPool::getLocalNodeAllocationSize();
+}
+
 /*
  * Class:     org_voltdb_jni_ExecutionEngine
  * Method:    nativeGetRSS
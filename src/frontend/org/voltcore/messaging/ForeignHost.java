@@ -396,6 +396,11 @@ public class ForeignHost {
 
     }
 
+    /** Messages not yet written to the remote host, for monitoring */
+    public int getPendingWriteCount() {
+        return m_network.getPendingWriteCount();
+    }
+
     public void sendPoisonPill(String err, int cause) {
         // if this link is "gone silent" for partition tests, just drop the message on the floor
         if (m_linkCutForTest.get()) {
@@ -1110,6 +1110,17 @@ public class HostMessenger implements SocketJoiner.JoinHandler, InterfaceToMesse
         return m_localHostId;
     }
 
+    /** Messages queued to all other hosts and not yet written, for monitoring */
+    public long getPendingForeignHostWrites() {
+        long pending = 0;
+        for (ForeignHost fh : m_foreignHosts.values()) {
+            if (fh != null) {
+                pending += fh.getPendingWriteCount();
+            }
+        }
+        return pending;
+    }
+
     public long getHSIdForLocalSite(int site) {
         return CoreUtils.getHSIdFromHostAndSite(getHostId(), site);
     }
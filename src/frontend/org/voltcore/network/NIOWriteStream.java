@@ -22,8 +22,10 @@ import java.nio.ByteBuffer;
 import java.nio.channels.GatheringByteChannel;
 import java.nio.channels.SelectionKey;
 import java.util.ArrayDeque;
+import java.util.Arrays;
 
 import org.voltcore.logging.VoltLogger;
+import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltcore.utils.DeferredSerialization;
 import org.voltcore.utils.EstTime;
 
@@ -65,6 +67,12 @@ public class NIOWriteStream extends NIOWriteStreamBase implements WriteStream {
 
     private final int m_maxQueuedWritesBeforeBackpressure = 100;
 
+    /**
+     * Most buffers handed to one gathering write, well under the IOV_MAX of 1024
+     */
+    private static final int MAX_GATHERED_BUFFERS = 64;
+    private final ByteBuffer m_gatherBuffers[] = new ByteBuffer[MAX_GATHERED_BUFFERS];
+
     private final Runnable m_offBackPressureCallback;
     private final Runnable m_onBackPressureCallback;
 
@@ -313,9 +321,11 @@ public class NIOWriteStream extends NIOWriteStreamBase implements WriteStream {
 
     /**
      * Does the work of queueing addititional buffers that have been serialized
-     * and choosing between gathering and regular writes to the channel. Also splits up very large
-     * writes of HeapByteBuffers into many smaller writes so Java doesn't allocate a monster DirectByteBuffer
-     * that will never be freed
+     * and draining them to the channel. The buffers behind the one being written
+     * go out in the same gathering write, up to MAX_GATHERED_BUFFERS at a time,
+     * so a backlog of small messages costs one system call rather than one per
+     * buffer. Buffers that are still queued are written through flipped duplicates,
+     * since the last of them may yet have more serialized into it.
      * @param channel
      * @return
      * @throws IOException
@@ -333,26 +343,52 @@ public class NIOWriteStream extends NIOWriteStreamBase implements WriteStream {
                     return bytesWritten;
                 }
 
-                ByteBuffer buffer = null;
                 if (m_currentWriteBuffer == null) {
                     m_currentWriteBuffer = m_queuedBuffers.poll();
-                    buffer = m_currentWriteBuffer.b();
-                    buffer.flip();
-                } else {
-                    buffer = m_currentWriteBuffer.b();
+                    m_currentWriteBuffer.b().flip();
                 }
 
-                rc = channel.write(buffer);
-
-                //Discard the buffer back to a pool if no data remains
-                if (buffer.hasRemaining()) {
-                    if (!m_hadBackPressure) {
-                        backpressureStarted();
+                int gathered = 0;
+                m_gatherBuffers[gathered++] = m_currentWriteBuffer.b();
+                for (BBContainer queued : m_queuedBuffers) {
+                    if (gathered == MAX_GATHERED_BUFFERS) {
+                        break;
                     }
-                } else {
+                    ByteBuffer duplicate = queued.b().duplicate();
+                    duplicate.flip();
+                    m_gatherBuffers[gathered++] = duplicate;
+                }
+
+                rc = channel.write(m_gatherBuffers, 0, gathered);
+
+                //Discard the buffers back to a pool if no data remains
+                if (!m_currentWriteBuffer.b().hasRemaining()) {
                     m_currentWriteBuffer.discard();
                     m_currentWriteBuffer = null;
                     m_messagesWritten++;
+                    for (int ii = 1; ii < gathered; ii++) {
+                        final ByteBuffer duplicate = m_gatherBuffers[ii];
+                        if (duplicate.position() == 0) {
+                            break;
+                        }
+                        final BBContainer queued = m_queuedBuffers.poll();
+                        if (duplicate.hasRemaining()) {
+                            // Partially written, carry on from where the write stopped
+                            queued.b().flip();
+                            queued.b().position(duplicate.position());
+                            m_currentWriteBuffer = queued;
+                            break;
+                        }
+                        queued.discard();
+                        m_messagesWritten++;
+                    }
+                }
+                Arrays.fill(m_gatherBuffers, 0, gathered, null);
+
+                if (m_currentWriteBuffer != null && m_currentWriteBuffer.b().hasRemaining()) {
+                    if (!m_hadBackPressure) {
+                        backpressureStarted();
+                    }
                 }
                 bytesWritten += rc;
 
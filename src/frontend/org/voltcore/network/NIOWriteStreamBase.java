@@ -108,7 +108,13 @@ public abstract class NIOWriteStreamBase {
             if (serializedSize == DeferredSerialization.EMPTY_MESSAGE_LENGTH) continue;
             BBContainer outCont = m_queuedBuffers.peekLast();
             ByteBuffer outbuf = null;
-            if (outCont == null || !outCont.b().hasRemaining()) {
+            /*
+             * Start a fresh pooled buffer when the last one is full, or when the message would
+             * fit in a buffer of its own but not in what is left of the last one. Leaving the
+             * tail of a buffer unused is cheaper than serializing to the heap and copying.
+             */
+            if (outCont == null || !outCont.b().hasRemaining() ||
+                    (outCont.b().remaining() < serializedSize && serializedSize <= outCont.b().capacity())) {
                 outCont = pool.acquire();
                 outCont.b().clear();
                 m_queuedBuffers.offer(outCont);
@@ -169,6 +169,8 @@ public class PicoNetwork implements Runnable, Connection, IOStatsIntf
     //Track how busy the thread is and spin once
     //if there is always work
     private boolean m_hadWork = false;
+    //When work was last found, for the busy poll window
+    private long m_lastWorkNanos = 0;
 
     @Override
     public void run() {
@@ -179,8 +181,13 @@ public class PicoNetwork implements Runnable, Connection, IOStatsIntf
             while (m_shouldStop == false) {
                 LatencyWatchdog.pet();
 
-                //Choose a non-blocking select if things are busy
+                //Choose a non-blocking select if things are busy, or were
+                //recently enough to still be inside the busy poll window
+                final long nowNanos = (VoltNetwork.BUSY_POLL_NANOS > 0) ? System.nanoTime() : 0;
                 if (m_hadWork) {
+                    m_lastWorkNanos = nowNanos;
+                    m_selector.selectNow();
+                } else if (nowNanos - m_lastWorkNanos < VoltNetwork.BUSY_POLL_NANOS) {
                     m_selector.selectNow();
                 } else {
                     m_selector.select();
@@ -416,6 +423,14 @@ public class PicoNetwork implements Runnable, Connection, IOStatsIntf
         return ft;
     }
 
+    /**
+     * Writes queued for the network thread, read without synchronization
+     * by monitoring while the network thread may be changing them.
+     */
+    public int getPendingWriteCount() {
+        return m_tasks.size() + m_writeStream.getOutstandingMessageCount();
+    }
+
     @Override
     public WriteStream writeStream() {
         throw new UnsupportedOperationException();
@@ -82,6 +82,7 @@ import java.util.concurrent.Callable;
 import java.util.concurrent.ConcurrentLinkedQueue;
 import java.util.concurrent.Future;
 import java.util.concurrent.FutureTask;
+import java.util.concurrent.TimeUnit;
 import java.util.concurrent.atomic.AtomicInteger;
 
 import jsr166y.ThreadLocalRandom;
@@ -95,6 +96,14 @@ import org.voltcore.utils.Pair;
 class VoltNetwork implements Runnable, IOStatsIntf
 {
     private final Selector m_selector;
+    /**
+     * How long the network thread polls for readiness without blocking before
+     * it blocks in select. Spends CPU to avoid selector wakeup latency; off by default.
+     */
+    static final long BUSY_POLL_NANOS =
+            TimeUnit.MICROSECONDS.toNanos(Integer.getInteger("NETWORK_BUSY_POLL_MICROS", 0));
+    // true while the network thread is busy polling and will see new tasks without a wakeup
+    private volatile boolean m_spinning = false;
     private static final VoltLogger m_logger = new VoltLogger(VoltNetwork.class.getName());
     private static final VoltLogger networkLog = new VoltLogger("NETWORK");
     private final ConcurrentLinkedQueue<Runnable> m_tasks = new ConcurrentLinkedQueue<Runnable>();
@@ -255,7 +264,7 @@ class VoltNetwork implements Runnable, IOStatsIntf
     Future<?> unregisterChannel (Connection c) {
         FutureTask<Object> ft = new FutureTask<Object>(getUnregisterRunnable(c), null);
         m_tasks.offer(ft);
-        m_selector.wakeup();
+        wakeupSelector();
         return ft;
     }
 
@@ -280,7 +289,47 @@ class VoltNetwork implements Runnable, IOStatsIntf
                 }
             });
         }
-        m_selector.wakeup();
+        wakeupSelector();
+    }
+
+    /**
+     * Wake the selector so it runs newly queued tasks. The network thread
+     * polls the task queue after every selection and after invoking the
+     * callbacks, so tasks it queues itself need no wakeup, and interest
+     * changes made while handling a port don't cost a wakeup syscall. Likewise
+     * a thread that is busy polling will find the task without one.
+     */
+    private void wakeupSelector() {
+        if (Thread.currentThread() != m_thread && !m_spinning) {
+            m_selector.wakeup();
+        }
+    }
+
+    /**
+     * Select ready keys. With busy polling enabled, poll the selector without
+     * blocking for up to BUSY_POLL_NANOS before falling back to a blocking select,
+     * so that traffic arriving within that window is picked up without a wakeup.
+     */
+    private int select() throws IOException {
+        if (BUSY_POLL_NANOS > 0) {
+            final long deadline = System.nanoTime() + BUSY_POLL_NANOS;
+            m_spinning = true;
+            try {
+                do {
+                    final int readyKeys = m_selector.selectNow();
+                    if (readyKeys > 0 || !m_tasks.isEmpty()) {
+                        return readyKeys;
+                    }
+                } while (System.nanoTime() - deadline < 0 && !m_shouldStop);
+            } finally {
+                m_spinning = false;
+            }
+            // A task queued while spinning skipped the wakeup, don't block on it
+            if (!m_tasks.isEmpty()) {
+                return m_selector.selectNow();
+            }
+        }
+        return m_selector.select();
     }
 
     @Override
@@ -297,7 +346,7 @@ class VoltNetwork implements Runnable, IOStatsIntf
                     while (m_shouldStop == false) {
                         LatencyWatchdog.pet();
 
-                        final int readyKeys = m_selector.select();
+                        final int readyKeys = select();
 
                         /*
                          * Run the task queue immediately after selection to catch
@@ -531,7 +580,7 @@ class VoltNetwork implements Runnable, IOStatsIntf
         FutureTask<Map<Long, Pair<String, long[]>>> ft = new FutureTask<Map<Long, Pair<String, long[]>>>(task);
 
         m_tasks.offer(ft);
-        m_selector.wakeup();
+        wakeupSelector();
 
         return ft;
     }
@@ -542,7 +591,7 @@ class VoltNetwork implements Runnable, IOStatsIntf
 
     void queueTask(Runnable r) {
         m_tasks.offer(r);
-        m_selector.wakeup();
+        wakeupSelector();
     }
 
     int numPorts() {
@@ -0,0 +1,174 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package org.voltcore.utils;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+/**
+ * The NUMA nodes of the host, each with its physical cores and their
+ * hardware threads, as Linux describes them under /sys/devices/system.
+ * Used to pick a core for each site so that the site, and the tuple
+ * storage the EE allocates on the node of the cpu it runs on, stay on
+ * one node.
+ */
+public class CpuTopology
+{
+    private static final Pattern NODE_DIRECTORY = Pattern.compile("node(\\d+)");
+
+    // Per node, in node order: its physical cores, each the cpu numbers of
+    // its hardware threads in ascending order.
+    private final List<List<List<Integer>>> m_nodes;
+
+    CpuTopology(List<List<List<Integer>>> nodes)
+    {
+        m_nodes = nodes;
+    }
+
+    /** The topology of this host, or null when it cannot be read. */
+    public static CpuTopology load()
+    {
+        return load(new File("/sys/devices/system"));
+    }
+
+    static CpuTopology load(File systemDirectory)
+    {
+        try {
+            // Nodes by number, each with its cpus.
+            Map<Integer, List<Integer>> nodeCpus = new TreeMap<Integer, List<Integer>>();
+            File[] nodeDirectories = new File(systemDirectory, "node").listFiles();
+            if (nodeDirectories != null) {
+                for (File nodeDirectory : nodeDirectories) {
+                    Matcher matcher = NODE_DIRECTORY.matcher(nodeDirectory.getName());
+                    if (matcher.matches()) {
+                        nodeCpus.put(Integer.valueOf(matcher.group(1)),
+                                     parseCpuList(read(new File(nodeDirectory, "cpulist"))));
+                    }
+                }
+            }
+            if (nodeCpus.isEmpty()) {
+                // No NUMA support: one node of every online cpu.
+                nodeCpus.put(0, parseCpuList(read(new File(systemDirectory, "cpu/online"))));
+            }
+
+            List<List<List<Integer>>> nodes = new ArrayList<List<List<Integer>>>();
+            for (List<Integer> cpus : nodeCpus.values()) {
+                if (cpus.isEmpty()) {
+                    continue;
+                }
+                // Cores by their first hardware thread.
+                Map<Integer, List<Integer>> cores = new LinkedHashMap<Integer, List<Integer>>();
+                for (int cpu : cpus) {
+                    File siblings = new File(systemDirectory, "cpu/cpu" + cpu + "/topology/thread_siblings_list");
+                    List<Integer> threads = siblings.exists() ? parseCpuList(read(siblings)) : null;
+                    if (threads == null || threads.isEmpty()) {
+                        threads = new ArrayList<Integer>();
+                        threads.add(cpu);
+                    }
+                    if (!cores.containsKey(threads.get(0))) {
+                        cores.put(threads.get(0), threads);
+                    }
+                }
+                nodes.add(new ArrayList<List<Integer>>(cores.values()));
+            }
+            return nodes.isEmpty() ? null : new CpuTopology(nodes);
+        }
+        catch (IOException e) {
+            return null;
+        }
+        catch (NumberFormatException e) {
+            return null;
+        }
+    }
+
+    public int getNodeCount()
+    {
+        return m_nodes.size();
+    }
+
+    public int getCoreCount()
+    {
+        int cores = 0;
+        for (List<List<Integer>> node : m_nodes) {
+            cores += node.size();
+        }
+        return cores;
+    }
+
+    /**
+     * A cpu for each of up to siteCount sites, each the first hardware
+     * thread of a physical core of its own. Sites go round robin over the
+     * nodes, so each node holds a share of the partitions. When there are
+     * more sites than cores the list is shorter than siteCount, and the
+     * remaining sites are left to the OS scheduler.
+     */
+    public List<String> getSiteBindings(int siteCount)
+    {
+        List<String> bindings = new ArrayList<String>();
+        int[] nextCore = new int[m_nodes.size()];
+        int node = 0;
+        int fullNodes = 0;
+        while (bindings.size() < siteCount && fullNodes < m_nodes.size()) {
+            List<List<Integer>> cores = m_nodes.get(node);
+            if (nextCore[node] < cores.size()) {
+                bindings.add(Integer.toString(cores.get(nextCore[node]).get(0)));
+                if (++nextCore[node] == cores.size()) {
+                    ++fullNodes;
+                }
+            }
+            node = (node + 1) % m_nodes.size();
+        }
+        return bindings;
+    }
+
+    /** Parse a Linux cpu list such as "0-3,8,10-11". */
+    static List<Integer> parseCpuList(String list)
+    {
+        List<Integer> cpus = new ArrayList<Integer>();
+        for (String range : list.trim().split(",")) {
+            if (range.isEmpty()) {
+                continue;
+            }
+            int dash = range.indexOf('-');
+            if (dash < 0) {
+                cpus.add(Integer.valueOf(range));
+            }
+            else {
+                int last = Integer.parseInt(range.substring(dash + 1));
+                for (int cpu = Integer.parseInt(range.substring(0, dash)); cpu <= last; cpu++) {
+                    cpus.add(cpu);
+                }
+            }
+        }
+        return cpus;
+    }
+
+    private static String read(File file) throws IOException
+    {
+        return new String(Files.readAllBytes(file.toPath()), StandardCharsets.UTF_8);
+    }
+}
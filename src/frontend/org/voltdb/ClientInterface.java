@@ -1804,6 +1804,35 @@ public class ClientInterface implements SnapshotDaemon.DaemonInitiator {
         return client_stats;
     }
 
+    /**
+     * Responses queued to all client connections and not yet written
+     */
+    public long getClientWriteBacklog()
+    {
+        long pending = 0;
+        for (Map.Entry<Long, ClientInterfaceHandleManager> e : m_cihm.entrySet()) {
+            if (e.getKey() > 0) {
+                pending += e.getValue().connection.writeStream().getOutstandingMessageCount();
+            }
+        }
+        return pending;
+    }
+
+    /**
+     * How long the longest waiting client connection has had writes pending, in milliseconds
+     */
+    public long getOldestClientWriteMillis()
+    {
+        final long now = EstTime.currentTimeMillis();
+        long oldest = 0;
+        for (Map.Entry<Long, ClientInterfaceHandleManager> e : m_cihm.entrySet()) {
+            if (e.getKey() > 0) {
+                oldest = Math.max(oldest, e.getValue().connection.writeStream().calculatePendingWriteDelta(now));
+            }
+        }
+        return oldest;
+    }
+
     public SnapshotDaemon getSnapshotDaemon() {
         return m_snapshotDaemon;
     }
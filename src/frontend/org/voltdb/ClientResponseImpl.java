@@ -24,6 +24,7 @@ import java.util.concurrent.TimeUnit;
 import org.json_voltpatches.JSONException;
 import org.json_voltpatches.JSONString;
 import org.json_voltpatches.JSONStringer;
+import org.json_voltpatches.JSONWriter;
 import org.voltdb.client.ClientResponse;
 import org.voltdb.client.ClientUtils;
 import org.voltdb.common.Constants;
@@ -295,20 +296,7 @@ public class ClientResponseImpl implements ClientResponse, JSONString {
     public String toJSONString() {
         JSONStringer js = new JSONStringer();
         try {
-            js.object();
-
-            js.keySymbolValuePair(JSON_STATUS_KEY, status);
-            js.keySymbolValuePair(JSON_APPSTATUS_KEY, appStatus);
-            js.keySymbolValuePair(JSON_STATUSSTRING_KEY, statusString);
-            js.keySymbolValuePair(JSON_APPSTATUSSTRING_KEY, appStatusString);
-            js.key(JSON_RESULTS_KEY);
-            js.array();
-            for (VoltTable o : results) {
-                js.value(o);
-            }
-            js.endArray();
-
-            js.endObject();
+            toJSONWriter(js);
         }
         catch (JSONException e) {
             e.printStackTrace();
@@ -317,6 +305,32 @@ public class ClientResponseImpl implements ClientResponse, JSONString {
         return js.toString();
     }
 
+    /**
+     * Write the JSON representation of this response, result tables included,
+     * directly to the given writer.
+     */
+    public void toJSONWriter(JSONWriter js) throws JSONException {
+        js.object();
+
+        js.keySymbolValuePair(JSON_STATUS_KEY, status);
+        js.keySymbolValuePair(JSON_APPSTATUS_KEY, appStatus);
+        js.keySymbolValuePair(JSON_STATUSSTRING_KEY, statusString);
+        js.keySymbolValuePair(JSON_APPSTATUSSTRING_KEY, appStatusString);
+        js.key(JSON_RESULTS_KEY);
+        js.array();
+        for (VoltTable o : results) {
+            if (o == null) {
+                js.valueNull();
+            }
+            else {
+                o.toJSONWriter(js);
+            }
+        }
+        js.endArray();
+
+        js.endObject();
+    }
+
     /**
      * @return MD5 hash as int of the tables in the result. Only hashes first bits of big results.
      */
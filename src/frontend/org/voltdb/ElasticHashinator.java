@@ -76,6 +76,14 @@ public class ElasticHashinator extends TheHashinator {
     private final long m_tokens;
     private final int m_tokenCount;
 
+    /*
+     * Index of the first token in each bucket of the ring, the tokens sharing the high bits of their
+     * offset from Integer.MIN_VALUE, followed by the token count. Lookups only search their hash's bucket.
+     */
+    private static final int MAX_BUCKET_BITS = 16;
+    private final int[] m_bucketStarts;
+    private final int m_bucketShift;
+
     // Provide a hook for the GC
     @SuppressWarnings("unused")
     private final Cleaner m_cleaner;
@@ -126,6 +134,8 @@ public class ElasticHashinator extends TheHashinator {
                 : updateRaw(configBytes));
         m_tokens = p.getFirst();
         m_tokenCount = p.getSecond();
+        m_bucketShift = bucketShift(m_tokenCount);
+        m_bucketStarts = bucketStarts(m_tokens, m_tokenCount, m_bucketShift);
         m_cleaner = Cleaner.create(this, new Deallocator(m_tokens, m_tokenCount * 8));
         m_configBytes = !cooked ? Suppliers.ofInstance(configBytes) : m_configBytesSupplier;
         m_cookedBytes = cooked ? Suppliers.ofInstance(configBytes) : m_cookedBytesSupplier;
@@ -165,6 +175,8 @@ public class ElasticHashinator extends TheHashinator {
             ii++;
         }
         m_tokenCount = tokens.size();
+        m_bucketShift = bucketShift(m_tokenCount);
+        m_bucketStarts = bucketStarts(m_tokens, m_tokenCount, m_bucketShift);
         m_configBytes = m_configBytesSupplier;
         m_cookedBytes = m_cookedBytesSupplier;
     }
@@ -580,9 +592,35 @@ public class ElasticHashinator extends TheHashinator {
         return Pair.of(tokens, numEntries);
     }
 
+    /** About one token per bucket, in up to 2^16 buckets */
+    static int bucketShift(int tokenCount) {
+        int bucketBits = 1;
+        while (bucketBits < MAX_BUCKET_BITS && (1 << bucketBits) < tokenCount) {
+            bucketBits++;
+        }
+        return 32 - bucketBits;
+    }
+
+    static int[] bucketStarts(long tokens, int tokenCount, int bucketShift) {
+        final int bucketCount = 1 << (32 - bucketShift);
+        int[] starts = new int[bucketCount + 1];
+        int ii = 0;
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            final long bucketLow = ((long) bucket) << bucketShift;
+            while (ii < tokenCount &&
+                    ((Bits.unsafe.getInt(tokens + (ii * 8)) ^ Integer.MIN_VALUE) & 0xFFFFFFFFL) < bucketLow) {
+                ii++;
+            }
+            starts[bucket] = ii;
+        }
+        starts[bucketCount] = tokenCount;
+        return starts;
+    }
+
     private long getTokenPtr(int hash) {
-        int min = 0;
-        int max = m_tokenCount - 1;
+        final int bucket = (hash ^ Integer.MIN_VALUE) >>> m_bucketShift;
+        int min = m_bucketStarts[bucket];
+        int max = m_bucketStarts[bucket + 1] - 1;
 
         while (min <= max) {
             int mid = (min + max) >>> 1;
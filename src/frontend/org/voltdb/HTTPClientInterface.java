@@ -18,6 +18,7 @@
 package org.voltdb;
 
 import java.io.IOException;
+import java.io.PrintWriter;
 import java.nio.charset.StandardCharsets;
 import java.security.MessageDigest;
 import java.util.concurrent.atomic.AtomicBoolean;
@@ -35,6 +36,8 @@ import org.ietf.jgss.GSSException;
 import org.ietf.jgss.GSSManager;
 import org.ietf.jgss.GSSName;
 import org.ietf.jgss.Oid;
+import org.json_voltpatches.JSONException;
+import org.json_voltpatches.JSONWriter;
 import org.voltcore.logging.Level;
 import org.voltcore.logging.VoltLogger;
 import org.voltcore.utils.EstTime;
@@ -119,14 +122,9 @@ public class HTTPClientInterface {
                 }
                 return;
             }
-            ClientResponseImpl rimpl = (ClientResponseImpl) clientResponse;
-            String msg = rimpl.toJSONString();
-
-            // handle jsonp pattern
-            // http://en.wikipedia.org/wiki/JSON#The_Basic_Idea:_Retrieving_JSON_via_Script_Tags
-            msg = asJsonp(m_jsonp, msg);
-
-            m_continuation.setAttribute("result", msg);
+            // the response is rendered to JSON by the resumed request, straight
+            // into the HTTP response writer
+            m_continuation.setAttribute("result", clientResponse);
             try {
                 m_continuation.resume();
             } catch (IllegalStateException e) {
@@ -169,6 +167,24 @@ public class HTTPClientInterface {
         return sb.append(jsonp).append("( ").append(msg).append(" )").toString();
     }
 
+    /**
+     * Stream the JSON form of a procedure response, wrapped for JSONP if requested,
+     * without materializing it as a string first.
+     */
+    private final static void writeJsonResponse(String jsonp, ClientResponseImpl rimpl, PrintWriter out)
+            throws JSONException {
+        // handle jsonp pattern
+        // http://en.wikipedia.org/wiki/JSON#The_Basic_Idea:_Retrieving_JSON_via_Script_Tags
+        if (jsonp != null) {
+            out.append(jsonp).append("( ");
+        }
+        rimpl.toJSONWriter(new JSONWriter(out));
+        if (jsonp != null) {
+            out.append(" )");
+        }
+        out.flush();
+    }
+
     private final static void simpleJsonResponse(String jsonp, String message, HttpServletResponse rsp, int code) {
         ClientResponseImpl rimpl = new ClientResponseImpl(
                 ClientResponse.UNEXPECTED_FAILURE, new VoltTable[0], message);
@@ -212,13 +228,18 @@ public class HTTPClientInterface {
         }
 
         final Continuation continuation = ContinuationSupport.getContinuation(request);
-        String result = (String)continuation.getAttribute("result");
+        Object result = continuation.getAttribute("result");
         if (result != null) {
             try {
                 response.setStatus(HttpServletResponse.SC_OK);
-                response.getWriter().print(result);
+                if (result instanceof ClientResponseImpl) {
+                    writeJsonResponse(jsonp, (ClientResponseImpl) result, response.getWriter());
+                }
+                else {
+                    response.getWriter().print(result);
+                }
                 request.setHandled(true);
-            } catch (IllegalStateException | IOException e){
+            } catch (IllegalStateException | IOException | JSONException e){
                // Thrown when we shut down the server via the JSON/HTTP (web studio) API
                // Essentially we're closing everything down from underneath the HTTP request.
                 m_log.warn("JSON failed to send response: ", e);
@@ -17,6 +17,8 @@
 
 package org.voltdb;
 
+import java.util.List;
+
 import org.voltdb.client.ProcedureCallback;
 import org.voltdb.importer.AbstractImporter;
 import org.voltdb.importer.ImporterServerAdapter;
@@ -51,6 +53,12 @@ public class ImporterServerAdapterImpl implements ImporterServerAdapter {
                 .callProcedure(importer, m_statsCollector, procCallback, proc, fieldList);
     }
 
+    @Override
+    public int callProcedures(AbstractImporter importer, List<ProcedureCallback> procCallbacks, String proc, List<Object[]> rows) {
+        return getInternalConnectionHandler()
+                .callProcedures(importer, m_statsCollector, procCallbacks, proc, rows);
+    }
+
     private InternalConnectionHandler getInternalConnectionHandler() {
         return VoltDB.instance().getClientInterface().getInternalConnectionHandler();
     }
@@ -17,6 +17,10 @@
 
 package org.voltdb;
 
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
 import java.util.concurrent.atomic.AtomicInteger;
 import java.util.concurrent.atomic.AtomicLong;
 
@@ -28,6 +32,7 @@ import org.voltdb.catalog.Table;
 import org.voltdb.client.BatchTimeoutOverrideType;
 import org.voltdb.client.ClientResponse;
 import org.voltdb.client.ProcedureCallback;
+import org.voltdb.utils.CatalogUtil;
 import org.voltdb.utils.MiscUtils;
 
 /**
@@ -36,6 +41,7 @@ import org.voltdb.utils.MiscUtils;
  */
 public class InternalConnectionHandler {
     final static String DEFAULT_INTERNAL_ADAPTER_NAME = "+!_InternalAdapter_!+";
+    private final static String LOAD_PROCEDURE = "@LoadSinglepartitionTable";
 
     public final static long SUPPRESS_INTERVAL = 60;
     private static final VoltLogger m_logger = new VoltLogger("InternalConnectionHandler");
@@ -158,6 +164,11 @@ public class InternalConnectionHandler {
             applyBackPressure();
         }
 
+        return submitProcedure(caller, statsCollector, procCallback, catProc, proc, fieldList);
+    }
+
+    private boolean submitProcedure(InternalConnectionContext caller, InternalConnectionStatsCollector statsCollector,
+            ProcedureCallback procCallback, Procedure catProc, String proc, Object... fieldList) {
         StoredProcedureInvocation task = new StoredProcedureInvocation();
 
         task.setProcName(proc);
@@ -193,6 +204,236 @@ public class InternalConnectionHandler {
         return true;
     }
 
+    /**
+     * Executes the procedure once for each row of parameters. When the procedure is
+     * the default insert or upsert procedure of a partitioned table, the rows bound for
+     * the same partition are loaded in one @LoadSinglepartitionTable transaction rather
+     * than one transaction each. Either way every row's callback gets a response, a
+     * failure if the row could not be submitted, so callers can keep tracking their
+     * progress row by row; a row loaded with others gets the response for its batch.
+     *
+     * @return the number of rows submitted.
+     */
+    public int callProcedures(InternalConnectionContext caller, InternalConnectionStatsCollector statsCollector,
+            List<ProcedureCallback> procCallbacks, String proc, List<Object[]> rows) {
+        assert(procCallbacks.size() == rows.size());
+        Procedure catProc = InvocationDispatcher.getProcedureFromName(proc, getCatalogContext());
+        Table catTable = (rows.size() > 1) ? getBatchLoadTable(catProc) : null;
+        if (catTable == null) {
+            return callProceduresOneByOne(caller, statsCollector, procCallbacks, proc, rows);
+        }
+
+        //Indicate backpressure or not, once for the whole batch.
+        boolean b = hasBackPressure();
+        caller.setBackPressure(b);
+        if (b) {
+            applyBackPressure();
+        }
+
+        // Group the rows by partition. Rows that can't be hashed are left to
+        // fail as calls of their own.
+        final CatalogContext.ProcedurePartitionInfo ppi =
+                (CatalogContext.ProcedurePartitionInfo) catProc.getAttachment();
+        final int columnCount = catTable.getColumns().size();
+        Map<Integer, RowBatch> byPartition = new HashMap<>();
+        RowBatch unbatched = new RowBatch();
+        for (int i = 0; i < rows.size(); i++) {
+            final Object[] row = rows.get(i);
+            RowBatch batch = unbatched;
+            if (row != null && row.length == columnCount && row[ppi.index] != null) {
+                try {
+                    int partition = TheHashinator.getPartitionForParameter(ppi.type, row[ppi.index]);
+                    batch = byPartition.get(partition);
+                    if (batch == null) {
+                        batch = new RowBatch();
+                        byPartition.put(partition, batch);
+                    }
+                } catch (Exception e) {
+                    batch = unbatched;
+                }
+            }
+            batch.add(row, procCallbacks.get(i));
+        }
+
+        int submitted = 0;
+        for (Map.Entry<Integer, RowBatch> entry : byPartition.entrySet()) {
+            submitted += loadPartitionBatch(caller, statsCollector, catProc, catTable, proc,
+                                            entry.getKey(), entry.getValue());
+        }
+        submitted += resubmitOneByOne(caller, statsCollector, catProc, proc, unbatched, false);
+        return submitted;
+    }
+
+    /**
+     * Rows of parameters and the callbacks for them.
+     */
+    private static class RowBatch {
+        final List<Object[]> m_rows = new ArrayList<>();
+        final List<ProcedureCallback> m_callbacks = new ArrayList<>();
+
+        void add(Object[] row, ProcedureCallback callback) {
+            m_rows.add(row);
+            m_callbacks.add(callback);
+        }
+
+        int size() {
+            return m_rows.size();
+        }
+    }
+
+    /**
+     * Returns the partitioned table if the procedure is its default insert
+     * or upsert procedure, or null if its calls can't be batched.
+     */
+    private static Table getBatchLoadTable(Procedure catProc) {
+        if (catProc == null || !catProc.getDefaultproc() || !catProc.getSinglepartition()) {
+            return null;
+        }
+        final String name = catProc.getTypeName();
+        if (!name.endsWith(".insert") && !name.endsWith(".upsert")) {
+            return null;
+        }
+        final Table catTable = catProc.getPartitiontable();
+        if (catTable == null || catTable.getIsreplicated()) {
+            return null;
+        }
+        return catTable;
+    }
+
+    private int loadPartitionBatch(final InternalConnectionContext caller,
+            final InternalConnectionStatsCollector statsCollector,
+            final Procedure catProc, Table catTable, final String proc,
+            int partition, RowBatch rows) {
+        // Rows whose values don't convert to the column types are left to
+        // fail as calls of their own.
+        VoltTable table = CatalogUtil.getVoltTable(catTable);
+        final RowBatch loaded = new RowBatch();
+        int submitted = 0;
+        for (int i = 0; i < rows.size(); i++) {
+            final Object[] row = rows.m_rows.get(i);
+            try {
+                Object[] converted = new Object[row.length];
+                for (int col = 0; col < row.length; col++) {
+                    converted[col] = ParameterConverter.tryToMakeCompatible(
+                            table.getColumnType(col).classFromType(), row[col]);
+                }
+                table.addRow(converted);
+                loaded.add(row, rows.m_callbacks.get(i));
+            } catch (Exception e) {
+                if (submitProcedure(caller, statsCollector, rows.m_callbacks.get(i), catProc, proc, row)) {
+                    submitted++;
+                } else {
+                    respondNotSubmitted(rows.m_callbacks.get(i), proc);
+                }
+            }
+        }
+        if (loaded.size() == 0) {
+            return submitted;
+        }
+
+        final CatalogContext.ProcedurePartitionInfo ppi =
+                (CatalogContext.ProcedurePartitionInfo) catProc.getAttachment();
+        final byte[] partitionParam = VoltType.valueToBytes(table.fetchRow(0).get(ppi.index, ppi.type));
+        final byte upsertMode = (byte) (catProc.getTypeName().endsWith(".upsert") ? 1 : 0);
+
+        StoredProcedureInvocation task = new StoredProcedureInvocation();
+        task.setProcName(LOAD_PROCEDURE);
+        task.setParams(partitionParam, catTable.getTypeName(), upsertMode, table);
+        try {
+            task = MiscUtils.roundTripForCL(task);
+            task.setClientHandle(m_adapter.connectionId());
+        } catch (Exception e) {
+            String fmt = "Cannot load a batch of %s from streaming interface %s. failed to create task.";
+            m_logger.rateLimitedLog(SUPPRESS_INTERVAL, Level.ERROR, e, fmt, proc, caller);
+            return submitted + resubmitOneByOne(caller, statsCollector, catProc, proc, loaded, false);
+        }
+
+        // The batch only inserts rows the importer could insert one at a time
+        // through the table's default procedure, which the importer user may
+        // call, but loading a table is an admin action.
+        final AuthUser user = getCatalogContext().authSystem.getInternalAdminUser();
+        final Procedure loadProc = InvocationDispatcher.getProcedureFromName(LOAD_PROCEDURE, getCatalogContext());
+        InternalAdapterTaskAttributes kattrs = new InternalAdapterTaskAttributes(caller,  m_adapter.connectionId());
+        ProcedureCallback batchCallback = new ProcedureCallback() {
+            @Override
+            public void clientCallback(ClientResponse response) throws Exception {
+                if (response.getStatus() == ClientResponse.RESPONSE_UNKNOWN) {
+                    // The adapter submits the batch again.
+                    return;
+                }
+                if (response.getStatus() != ClientResponse.SUCCESS) {
+                    // One bad row fails the whole batch, so load the rows one at a
+                    // time to fail only the bad ones.
+                    resubmitOneByOne(caller, statsCollector, catProc, proc, loaded, true);
+                    return;
+                }
+                for (int i = 0; i < loaded.size(); i++) {
+                    respond(loaded.m_callbacks.get(i), response);
+                    if (statsCollector != null) {
+                        statsCollector.reportCompletion(caller.getName(), proc, response);
+                    }
+                }
+            }
+        };
+        if (!m_adapter.createTransaction(kattrs, LOAD_PROCEDURE, loadProc, batchCallback, null, task, user, partition, System.nanoTime())) {
+            return submitted + resubmitOneByOne(caller, statsCollector, catProc, proc, loaded, false);
+        }
+        m_submitSuccessCount.incrementAndGet();
+        return submitted + loaded.size();
+    }
+
+    /**
+     * Submits rows that can't be loaded with others one at a time. The rows of a batch
+     * that was already submitted were reported queued, so failing to submit one of
+     * them again completes it.
+     */
+    private int resubmitOneByOne(InternalConnectionContext caller, InternalConnectionStatsCollector statsCollector,
+            Procedure catProc, String proc, RowBatch rows, boolean wasQueued) {
+        int submitted = 0;
+        for (int i = 0; i < rows.size(); i++) {
+            if (submitProcedure(caller, statsCollector, rows.m_callbacks.get(i), catProc, proc, rows.m_rows.get(i))) {
+                submitted++;
+                continue;
+            }
+            ClientResponse response = respondNotSubmitted(rows.m_callbacks.get(i), proc);
+            if (wasQueued && statsCollector != null) {
+                statsCollector.reportCompletion(caller.getName(), proc, response);
+            }
+        }
+        return submitted;
+    }
+
+    private int callProceduresOneByOne(InternalConnectionContext caller, InternalConnectionStatsCollector statsCollector,
+            List<ProcedureCallback> procCallbacks, String proc, List<Object[]> rows) {
+        int submitted = 0;
+        for (int i = 0; i < rows.size(); i++) {
+            if (callProcedure(caller, statsCollector, procCallbacks.get(i), proc, rows.get(i))) {
+                submitted++;
+            } else {
+                respondNotSubmitted(procCallbacks.get(i), proc);
+            }
+        }
+        return submitted;
+    }
+
+    private ClientResponse respondNotSubmitted(ProcedureCallback procCallback, String proc) {
+        ClientResponse response = new ClientResponseImpl(ClientResponse.UNEXPECTED_FAILURE,
+                new VoltTable[0], "Failed to submit an invocation of " + proc);
+        respond(procCallback, response);
+        return response;
+    }
+
+    private void respond(ProcedureCallback procCallback, ClientResponse response) {
+        if (procCallback == null) {
+            return;
+        }
+        try {
+            procCallback.clientCallback(response);
+        } catch (Exception e) {
+            m_logger.rateLimitedLog(SUPPRESS_INTERVAL, Level.ERROR, e, "Failed to process a procedure response");
+        }
+    }
+
     private boolean hasBackPressure() {
         final boolean b = m_adapter.hasBackPressure();
         int prev = m_backpressureIndication.get();
@@ -0,0 +1,164 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * Invocation counts and time of the calls a site makes into its execution
+ * engine (DOWN) and of the calls the engine makes back into Java (UP), one row
+ * per call. A downcall's time includes the EE work it does and the upcalls it
+ * makes, so crossing cost is best read from calls that do little, or from the
+ * JNI crossing microbenchmark.
+ *
+ * The site thread records downcalls as it makes them. Upcalls are counted in
+ * the EE and copied here on the site's stats tick, so they may lag by a tick.
+ */
+public class JNICallStats extends SiteStatsSource {
+
+    public enum Direction {
+        DOWN,
+        UP
+    }
+
+    public enum Downcall {
+        EXECUTE_PLAN_FRAGMENTS,
+        EXECUTE_TRANSACTION_BATCH,
+        LOAD_TABLE,
+        SERIALIZE_TABLE,
+        TICK,
+        QUIESCE,
+        GET_STATS,
+        RELEASE_UNDO_TOKEN,
+        UNDO_UNDO_TOKEN,
+        TABLE_STREAM_SERIALIZE_MORE,
+        EXPORT_ACTION,
+        APPLY_BINARY_LOG,
+        EXECUTE_TASK
+    }
+
+    /** In the order of JNITopend::UpcallType in the EE */
+    public enum Upcall {
+        LOAD_NEXT_DEPENDENCY,
+        FRAGMENT_PROGRESS_UPDATE,
+        PLAN_FOR_FRAGMENT_ID,
+        GET_QUEUED_EXPORT_BYTES,
+        PUSH_EXPORT_BUFFER,
+        PUSH_DR_BUFFER,
+        REPORT_DR_CONFLICT,
+        FALLBACK_TO_EE_ALLOCATED_BUFFER,
+        DECODE_BASE64_AND_DECOMPRESS
+    }
+
+    private static final Downcall[] DOWNCALLS = Downcall.values();
+    private static final Upcall[] UPCALLS = Upcall.values();
+    private static final int ROWS = DOWNCALLS.length + UPCALLS.length;
+
+    // Counts then nanoseconds, downcalls then upcalls, indexed by row
+    private final long[] m_counts = new long[ROWS];
+    private final long[] m_nanos = new long[ROWS];
+    private final long[] m_lastCounts = new long[ROWS];
+    private final long[] m_lastNanos = new long[ROWS];
+
+    private boolean m_interval = false;
+
+    public JNICallStats(long siteId) {
+        super(siteId, false);
+    }
+
+    public void recordDowncall(Downcall call, long nanos) {
+        m_counts[call.ordinal()]++;
+        m_nanos[call.ordinal()] += nanos;
+    }
+
+    /**
+     * @param upcalls As returned by ExecutionEngine.getUpcallStats(), the EE's
+     *        cumulative counts then nanoseconds per Upcall
+     */
+    public void updateUpcalls(long[] upcalls) {
+        for (int i = 0; i < UPCALLS.length; i++) {
+            m_counts[DOWNCALLS.length + i] = upcalls[i];
+            m_nanos[DOWNCALLS.length + i] = upcalls[UPCALLS.length + i];
+        }
+    }
+
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("DIRECTION", VoltType.STRING));
+        columns.add(new ColumnInfo("CALL", VoltType.STRING));
+        columns.add(new ColumnInfo("INVOCATIONS", VoltType.BIGINT));
+        columns.add(new ColumnInfo("TOTAL_TIME", VoltType.BIGINT));
+        columns.add(new ColumnInfo("AVG_TIME", VoltType.BIGINT));
+    }
+
+    @Override
+    protected void updateStatsRow(Object rowKey, Object rowValues[]) {
+        final int row = (Integer)rowKey;
+        long count = m_counts[row];
+        long nanos = m_nanos[row];
+        if (m_interval) {
+            final long totalCount = count;
+            final long totalNanos = nanos;
+            count -= m_lastCounts[row];
+            nanos -= m_lastNanos[row];
+            m_lastCounts[row] = totalCount;
+            m_lastNanos[row] = totalNanos;
+        }
+        if (row < DOWNCALLS.length) {
+            rowValues[columnNameToIndex.get("DIRECTION")] = Direction.DOWN.name();
+            rowValues[columnNameToIndex.get("CALL")] = DOWNCALLS[row].name();
+        } else {
+            rowValues[columnNameToIndex.get("DIRECTION")] = Direction.UP.name();
+            rowValues[columnNameToIndex.get("CALL")] = UPCALLS[row - DOWNCALLS.length].name();
+        }
+        rowValues[columnNameToIndex.get("INVOCATIONS")] = count;
+        // Total in microseconds, the average in nanoseconds
+        rowValues[columnNameToIndex.get("TOTAL_TIME")] = nanos / 1000;
+        rowValues[columnNameToIndex.get("AVG_TIME")] = count > 0 ? nanos / count : 0;
+        super.updateStatsRow(rowKey, rowValues);
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(final boolean interval) {
+        m_interval = interval;
+        return new Iterator<Object>() {
+            int m_next = 0;
+            @Override
+            public boolean hasNext() {
+                return m_next < ROWS;
+            }
+
+            @Override
+            public Object next() {
+                if (m_next < ROWS) {
+                    return m_next++;
+                } else {
+                    return null;
+                }
+            }
+
+            @Override
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
+    }
+}
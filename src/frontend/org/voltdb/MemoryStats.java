@@ -34,6 +34,8 @@ public class MemoryStats extends StatsSource {
         long indexMem = 0;
         long stringMem = 0;
         long pooledMem = 0;
+        long hugePageMem = 0;
+        long localNodeMem = 0;
     }
     Map<Long, PartitionMemRow> m_memoryStats = new TreeMap<Long, PartitionMemRow>();
 
@@ -82,6 +84,8 @@ public class MemoryStats extends StatsSource {
         columns.add(new VoltTable.ColumnInfo("POOLEDMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT));
         columns.add(new VoltTable.ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER));
+        columns.add(new VoltTable.ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT));
+        columns.add(new VoltTable.ColumnInfo("LOCALNODEMEMORY", VoltType.BIGINT));
     }
 
     @Override
@@ -95,6 +99,8 @@ public class MemoryStats extends StatsSource {
             totals.indexMem += pmr.indexMem;
             totals.stringMem += pmr.stringMem;
             totals.pooledMem += pmr.pooledMem;
+            totals.hugePageMem += pmr.hugePageMem;
+            totals.localNodeMem += pmr.localNodeMem;
         }
 
         // get system statistics
@@ -119,6 +125,8 @@ public class MemoryStats extends StatsSource {
         //in kb to make math simpler with other mem values.
         rowValues[columnNameToIndex.get("PHYSICALMEMORY")] = PlatformProperties.getPlatformProperties().ramInMegabytes * 1024;
         rowValues[columnNameToIndex.get("JAVAMAXHEAP")] = Runtime.getRuntime().maxMemory() / 1024;
+        rowValues[columnNameToIndex.get("HUGEPAGEMEMORY")] = totals.hugePageMem / 1024;
+        rowValues[columnNameToIndex.get("LOCALNODEMEMORY")] = totals.localNodeMem / 1024;
         super.updateStatsRow(rowKey, rowValues);
     }
 
@@ -128,7 +136,9 @@ public class MemoryStats extends StatsSource {
                                               long tupleAllocatedMem,
                                               long indexMem,
                                               long stringMem,
-                                              long pooledMemory) {
+                                              long pooledMemory,
+                                              long hugePageMemory,
+                                              long localNodeMemory) {
         PartitionMemRow pmr = new PartitionMemRow();
         pmr.tupleCount = tupleCount;
         pmr.tupleDataMem = tupleDataMem;
@@ -136,6 +146,8 @@ public class MemoryStats extends StatsSource {
         pmr.indexMem = indexMem;
         pmr.stringMem = stringMem;
         pmr.pooledMem = pooledMemory;
+        pmr.hugePageMem = hugePageMemory;
+        pmr.localNodeMem = localNodeMemory;
         m_memoryStats.put(siteId, pmr);
     }
 }
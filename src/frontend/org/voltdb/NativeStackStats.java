@@ -0,0 +1,121 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.Map;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * Native stacks sampled by the site's EE, one row per distinct stack with the
+ * number of times it was seen. STACK is in the folded "outer;...;inner" form,
+ * so the rows of one site, or of all of them, can be fed straight to flame
+ * graph tools.
+ *
+ * The site copies the EE's new samples here on its stats tick. Once
+ * MAX_STACKS distinct stacks are held, samples of new stacks are counted
+ * under "[truncated]".
+ */
+public class NativeStackStats extends SiteStatsSource {
+
+    private static final int MAX_STACKS = Integer.getInteger("NATIVE_STACK_STATS_MAX_STACKS", 10000);
+    private static final String TRUNCATED = "[truncated]";
+
+    private final Map<String, Long> m_total = new HashMap<String, Long>();
+    private Map<String, Long> m_interval = new HashMap<String, Long>();
+    private Map<String, Long> m_rows = null;
+
+    public NativeStackStats(long siteId) {
+        super(siteId, false);
+    }
+
+    /**
+     * @param folded As returned by ExecutionEngine.getNativeStacks(), the
+     *        stacks sampled since the last update, one "stack count" per line
+     */
+    public void update(String folded) {
+        if (folded.isEmpty()) {
+            return;
+        }
+        synchronized (this) {
+            for (String line : folded.split("\n")) {
+                final int space = line.lastIndexOf(' ');
+                if (space <= 0) {
+                    continue;
+                }
+                final long count = Long.parseLong(line.substring(space + 1));
+                final String stack = line.substring(0, space);
+                add(m_total, stack, count);
+                add(m_interval, stack, count);
+            }
+        }
+    }
+
+    private static void add(Map<String, Long> counts, String stack, long count) {
+        Long current = counts.get(stack);
+        if (current == null && counts.size() >= MAX_STACKS) {
+            stack = TRUNCATED;
+            current = counts.get(stack);
+        }
+        counts.put(stack, current == null ? count : current + count);
+    }
+
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("STACK", VoltType.STRING));
+        columns.add(new ColumnInfo("SAMPLES", VoltType.BIGINT));
+    }
+
+    @Override
+    protected void updateStatsRow(Object rowKey, Object rowValues[]) {
+        final String stack = (String)rowKey;
+        rowValues[columnNameToIndex.get("STACK")] = stack;
+        rowValues[columnNameToIndex.get("SAMPLES")] = m_rows.get(stack);
+        super.updateStatsRow(rowKey, rowValues);
+    }
+
+    @Override
+    protected synchronized Iterator<Object> getStatsRowKeyIterator(final boolean interval) {
+        if (interval) {
+            m_rows = m_interval;
+            m_interval = new HashMap<String, Long>();
+        } else {
+            m_rows = new HashMap<String, Long>(m_total);
+        }
+        final Iterator<String> stacks = m_rows.keySet().iterator();
+        return new Iterator<Object>() {
+            @Override
+            public boolean hasNext() {
+                return stacks.hasNext();
+            }
+
+            @Override
+            public Object next() {
+                return stacks.next();
+            }
+
+            @Override
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
+    }
+}
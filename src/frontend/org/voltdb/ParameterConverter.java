@@ -233,6 +233,23 @@ public class ParameterConverter {
         }
     }
 
+    /**
+     * The one class of value that tryToMakeCompatible always hands back unchanged
+     * for the type given, or null if every value has to go through it. Callers
+     * resolve this once per parameter and skip the conversion for such values.
+     */
+    public static Class<?> getUnconvertedClass(final Class<?> expectedClz) {
+        if (expectedClz == long.class) return Long.class;
+        if (expectedClz == int.class) return Integer.class;
+        if (expectedClz == short.class) return Short.class;
+        if (expectedClz == byte.class) return Byte.class;
+        if (expectedClz == double.class) return Double.class;
+        if (expectedClz == byte[].class) return byte[].class;
+        // Strings and the other object types can carry null sigils, so they
+        // always need a look.
+        return null;
+    }
+
     /**
      * Convert the given value to the type given, if possible.
      *
@@ -37,7 +37,8 @@ import com.google_voltpatches.common.collect.ImmutableMap;
 public class PartitionDRGateway implements DurableUniqueIdListener {
 
     public enum DRRecordType {
-        INSERT, DELETE, UPDATE, BEGIN_TXN, END_TXN, TRUNCATE_TABLE, DELETE_BY_INDEX, UPDATE_BY_INDEX, HASH_DELIMITER;
+        INSERT, DELETE, UPDATE, BEGIN_TXN, END_TXN, TRUNCATE_TABLE, DELETE_BY_INDEX, UPDATE_BY_INDEX, HASH_DELIMITER,
+        UPDATE_CHANGED_COLUMNS;
     }
 
     // Keep sync with EE DRTxnPartitionHashFlag at types.h
@@ -76,6 +77,8 @@ public class PartitionDRGateway implements DurableUniqueIdListener {
     public static final byte DR_UNCOORDINATED_MP_START_PROTOCOL_VERSION = 4;
     // partial MP txns of the same MP txn coordinated and combined before going to MP stream
     public static final byte DR_COORDINATED_MP_START_PROTOCOL_VERSION = 6;
+    // updates on tables with a unique index and without active-active carry only the key and changed columns
+    public static final byte DR_CHANGED_COLUMNS_UPDATE_PROTOCOL_VERSION = 7;
 
     /**
      * Load the full subclass if it should, otherwise load the
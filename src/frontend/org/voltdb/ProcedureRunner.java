@@ -21,9 +21,13 @@ import java.io.IOException;
 import java.io.PrintWriter;
 import java.io.StringWriter;
 import java.io.Writer;
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
 import java.lang.reflect.InvocationTargetException;
 import java.lang.reflect.Method;
 import java.lang.reflect.Modifier;
+import java.nio.BufferUnderflowException;
 import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.Date;
@@ -103,6 +107,11 @@ public class ProcedureRunner {
     protected final VoltProcedure m_procedure;
     protected Method m_procMethod;
     protected Class<?>[] m_paramTypes;
+    // m_procMethod bound to m_procedure and taking the parameter array,
+    // or null if it can only be invoked reflectively
+    protected MethodHandle m_procHandle;
+    // per parameter, the argument class that needs no conversion (or null)
+    protected Class<?>[] m_unconvertedParamClasses;
 
     // per txn state (are reset after call)
     //
@@ -297,6 +306,10 @@ public class ProcedureRunner {
             }
 
             for (int i = 0; i < m_paramTypes.length; i++) {
+                // most arguments already arrive as the type run() takes
+                if (paramList[i] != null && paramList[i].getClass() == m_unconvertedParamClasses[i]) {
+                    continue;
+                }
                 try {
                     paramList[i] = ParameterConverter.tryToMakeCompatible(m_paramTypes[i], paramList[i]);
                     // check the result type in an assert
@@ -320,7 +333,19 @@ public class ProcedureRunner {
                             log.trace("invoking... procMethod=" + m_procMethod.getName() + ", class=" + m_procMethod.getDeclaringClass().getName());
                         }
                         try {
-                            Object rawResult = m_procMethod.invoke(m_procedure, paramList);
+                            Object rawResult;
+                            if (m_procHandle != null) {
+                                try {
+                                    rawResult = (Object) m_procHandle.invokeExact(paramList);
+                                }
+                                catch (Throwable t) {
+                                    // handle the procedure's throwables like reflection would
+                                    throw new InvocationTargetException(t);
+                                }
+                            }
+                            else {
+                                rawResult = m_procMethod.invoke(m_procedure, paramList);
+                            }
                             results = getResultsFromRawResults(rawResult);
                         }
                         catch (IllegalAccessException e) {
@@ -368,6 +393,9 @@ public class ProcedureRunner {
                 assert(m_catProc.getStatements().size() == 1);
                 try {
                     m_cachedSingleStmt.params = getCleanParams(m_cachedSingleStmt.stmt, false, paramList);
+                    if (m_isSinglePartition) {
+                        m_cachedSingleStmt.serialization = getWireCompatibleParams(m_cachedSingleStmt.stmt);
+                    }
                     if (getNonVoltDBBackendIfExists() != null) {
                         // Backend handling, such as HSQL or PostgreSQL
                         VoltTable table =
@@ -434,6 +462,7 @@ public class ProcedureRunner {
             m_appStatusString = null;
             m_cachedRNG = null;
             m_cachedSingleStmt.params = null;
+            m_cachedSingleStmt.serialization = null;
             m_cachedSingleStmt.expectation = null;
             m_seenFinalBatch = false;
 
@@ -897,6 +926,72 @@ public class ProcedureRunner {
                 " Try explicitly using a " + preferredType + " parameter.");
     }
 
+    /**
+     * If the invocation's parameters arrived from the wire already in exactly the
+     * form the EE expects for this statement, return a view of those bytes so they
+     * can be handed to the EE without re-serializing the ParameterSet. Returns null
+     * if any parameter would need conversion, is null, or is of a variable-width type
+     * other than a non-null string.
+     */
+    private ByteBuffer getWireCompatibleParams(SQLStmt stmt) {
+        if (m_txnState == null) {
+            return null;
+        }
+        StoredProcedureInvocation invocation = m_txnState.getInvocation();
+        if (invocation == null) {
+            return null;
+        }
+        ByteBuffer buf = invocation.getSerializedParams();
+        if (buf == null || buf.position() != 0) {
+            return null;
+        }
+
+        final byte stmtParamTypes[] = stmt.statementParamTypes;
+        try {
+            if (buf.getShort() != stmtParamTypes.length) {
+                return null;
+            }
+            for (byte stmtParamType : stmtParamTypes) {
+                byte wireType = buf.get();
+                if (wireType != stmtParamType) {
+                    return null;
+                }
+                switch (VoltType.get(wireType)) {
+                case TINYINT:
+                    buf.position(buf.position() + 1);
+                    break;
+                case SMALLINT:
+                    buf.position(buf.position() + 2);
+                    break;
+                case INTEGER:
+                    buf.position(buf.position() + 4);
+                    break;
+                case BIGINT:
+                case FLOAT:
+                case TIMESTAMP:
+                    buf.position(buf.position() + 8);
+                    break;
+                case STRING:
+                    int length = buf.getInt();
+                    if (length < 0) {
+                        return null;
+                    }
+                    buf.position(buf.position() + length);
+                    break;
+                default:
+                    return null;
+                }
+            }
+        }
+        catch (BufferUnderflowException | IllegalArgumentException e) {
+            return null;
+        }
+
+        buf.limit(buf.position());
+        buf.position(0);
+        return buf;
+    }
+
     private final ParameterSet getCleanParams(SQLStmt stmt, boolean verifyTypeConv, Object... inArgs) {
         final byte stmtParamTypes[] = stmt.statementParamTypes;
         final int numParamTypes = stmtParamTypes.length;
@@ -1020,6 +1115,10 @@ public class ProcedureRunner {
             if (m_procMethod == null && m_language == Language.JAVA) {
                 throw new RuntimeException("No \"run\" method found in: " + m_procedure.getClass().getName());
             }
+            if (m_procMethod != null) {
+                m_procHandle = getProcedureHandle(m_procedure, m_procMethod);
+            }
+            resolveParamConversions();
             // iterate through the fields and deal with sql statements
             stmtMap = m_language.accept(sqlStatementsRetriever, this);
         }
@@ -1061,6 +1160,7 @@ public class ProcedureRunner {
 
                     m_paramTypes[param.getIndex()] = type.classFromType();
                 }
+                resolveParamConversions();
             }
             catch (Exception e) {
                 // shouldn't throw anything outside of the compiler
@@ -1096,6 +1196,32 @@ public class ProcedureRunner {
         }
     }
 
+    private void resolveParamConversions() {
+        m_unconvertedParamClasses = new Class<?>[m_paramTypes.length];
+        for (int i = 0; i < m_paramTypes.length; i++) {
+            m_unconvertedParamClasses[i] = ParameterConverter.getUnconvertedClass(m_paramTypes[i]);
+        }
+    }
+
+    /**
+     * Resolve the procedure's run method once into a handle that takes the
+     * converted parameter array and returns the boxed result, so each call
+     * skips the access and argument checks of Method.invoke.
+     * Returns null for a method the handle lookup can't reach.
+     */
+    private static MethodHandle getProcedureHandle(VoltProcedure procedure, Method procMethod) {
+        try {
+            return MethodHandles.publicLookup().unreflect(procMethod)
+                    .bindTo(procedure)
+                    .asSpreader(Object[].class, procMethod.getParameterTypes().length)
+                    .asType(MethodType.methodType(Object.class, Object[].class));
+        }
+        catch (IllegalAccessException e) {
+            log.debug("Invoking " + procMethod.getDeclaringClass().getName() + ".run reflectively: " + e.getMessage());
+            return null;
+        }
+    }
+
     private final static Language.Visitor<Class<?>[], ProcedureRunner> parametersTypeRetriever =
             new Language.Visitor<Class<?>[], ProcedureRunner>() {
                 @Override
@@ -0,0 +1,237 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+import java.util.List;
+import java.util.concurrent.CopyOnWriteArrayList;
+import java.util.concurrent.ScheduledFuture;
+import java.util.concurrent.TimeUnit;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * Depth and wait time of the queues and locks where work is handed from one
+ * thread to another, one row per probe. Polled with the interval flag it is
+ * a time series, which shows the queue that backs up when throughput stalls.
+ *
+ * Depths are sampled every QUEUE_STATS_SAMPLE_MS milliseconds by a scheduled
+ * task, without synchronizing with the queue's users. Waits are recorded by
+ * the probe's owner for one handoff in WAIT_SAMPLE_RATE, or, for queues whose
+ * items can't be tagged, are the age of the oldest pending item at each sample.
+ */
+public class QueueStats extends SiteStatsSource {
+
+    private static final long SAMPLE_MS = Long.getLong("QUEUE_STATS_SAMPLE_MS", 100);
+
+    /**
+     * A queue or lock being watched. Owners override depth() when the depth
+     * can be read from another thread, and report waits through
+     * startWaitSample()/endWaitSample() or recordWait().
+     */
+    public static class Probe {
+        private static final int WAIT_SAMPLE_MASK = Integer.highestOneBit(
+                Math.max(1, Integer.getInteger("QUEUE_STATS_WAIT_SAMPLE_RATE", 64))) - 1;
+
+        private final String m_name;
+        // Incremented racily by every thread that hands off, it only picks the samples
+        private int m_handoffs = 0;
+        private final Totals m_total = new Totals();
+        private final Totals m_interval = new Totals();
+
+        public Probe(String name) {
+            m_name = name;
+        }
+
+        public String getName() {
+            return m_name;
+        }
+
+        /** The current depth, or -1 if the probe only records waits */
+        protected long depth() {
+            return -1;
+        }
+
+        /** Age of the oldest pending item in nanoseconds, or -1 if unknown */
+        protected long oldestPendingNanos() {
+            return -1;
+        }
+
+        /** @return the start time of a sampled handoff, or 0 if this one is not sampled */
+        public final long startWaitSample() {
+            return ((++m_handoffs) & WAIT_SAMPLE_MASK) == 0 ? System.nanoTime() : 0;
+        }
+
+        public final void endWaitSample(long startNanos) {
+            if (startNanos != 0) {
+                recordWait(System.nanoTime() - startNanos);
+            }
+        }
+
+        public final synchronized void recordWait(long nanos) {
+            m_total.addWait(nanos);
+            m_interval.addWait(nanos);
+        }
+
+        final void sample() {
+            final long depth = depth();
+            final long oldest = oldestPendingNanos();
+            synchronized (this) {
+                if (depth >= 0) {
+                    m_total.addDepth(depth);
+                    m_interval.addDepth(depth);
+                }
+                if (oldest >= 0) {
+                    m_total.addWait(oldest);
+                    m_interval.addWait(oldest);
+                }
+            }
+        }
+
+        synchronized Totals read(boolean interval) {
+            if (interval) {
+                Totals copy = m_interval.copy();
+                m_interval.reset();
+                return copy;
+            }
+            return m_total.copy();
+        }
+    }
+
+    static class Totals {
+        long m_depthSamples;
+        long m_depthSum;
+        long m_maxDepth;
+        long m_waitSamples;
+        long m_waitNanosSum;
+        long m_maxWaitNanos;
+
+        void addDepth(long depth) {
+            m_depthSamples++;
+            m_depthSum += depth;
+            m_maxDepth = Math.max(m_maxDepth, depth);
+        }
+
+        void addWait(long nanos) {
+            m_waitSamples++;
+            m_waitNanosSum += nanos;
+            m_maxWaitNanos = Math.max(m_maxWaitNanos, nanos);
+        }
+
+        void reset() {
+            m_depthSamples = m_depthSum = m_maxDepth = 0;
+            m_waitSamples = m_waitNanosSum = m_maxWaitNanos = 0;
+        }
+
+        Totals copy() {
+            Totals copy = new Totals();
+            copy.m_depthSamples = m_depthSamples;
+            copy.m_depthSum = m_depthSum;
+            copy.m_maxDepth = m_maxDepth;
+            copy.m_waitSamples = m_waitSamples;
+            copy.m_waitNanosSum = m_waitNanosSum;
+            copy.m_maxWaitNanos = m_maxWaitNanos;
+            return copy;
+        }
+    }
+
+    private final List<Probe> m_probes = new CopyOnWriteArrayList<Probe>();
+    private ScheduledFuture<?> m_sampler = null;
+    private boolean m_interval = false;
+
+    /**
+     * @param siteId The site whose queues these are, or the host id for host-wide queues
+     */
+    public QueueStats(long siteId) {
+        super(siteId, false);
+    }
+
+    public void addProbe(Probe probe) {
+        m_probes.add(probe);
+    }
+
+    /** Start sampling depths, if there is a VoltDB to schedule the work on */
+    public synchronized void start() {
+        if (m_sampler == null && VoltDB.instance() != null) {
+            m_sampler = VoltDB.instance().scheduleWork(new Runnable() {
+                @Override
+                public void run() {
+                    for (Probe probe : m_probes) {
+                        probe.sample();
+                    }
+                }
+            }, SAMPLE_MS, SAMPLE_MS, TimeUnit.MILLISECONDS);
+        }
+    }
+
+    public synchronized void shutdown() {
+        if (m_sampler != null) {
+            m_sampler.cancel(false);
+            m_sampler = null;
+        }
+    }
+
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("QUEUE", VoltType.STRING));
+        columns.add(new ColumnInfo("AVG_DEPTH", VoltType.FLOAT));
+        columns.add(new ColumnInfo("MAX_DEPTH", VoltType.BIGINT));
+        columns.add(new ColumnInfo("WAIT_SAMPLES", VoltType.BIGINT));
+        columns.add(new ColumnInfo("AVG_WAIT", VoltType.FLOAT));
+        columns.add(new ColumnInfo("MAX_WAIT", VoltType.BIGINT));
+    }
+
+    @Override
+    protected void updateStatsRow(Object rowKey, Object rowValues[]) {
+        final Probe probe = (Probe)rowKey;
+        final Totals totals = probe.read(m_interval);
+        rowValues[columnNameToIndex.get("QUEUE")] = probe.getName();
+        rowValues[columnNameToIndex.get("AVG_DEPTH")] =
+            totals.m_depthSamples > 0 ? totals.m_depthSum / (double)totals.m_depthSamples : 0.0;
+        rowValues[columnNameToIndex.get("MAX_DEPTH")] = totals.m_maxDepth;
+        rowValues[columnNameToIndex.get("WAIT_SAMPLES")] = totals.m_waitSamples;
+        // Waits are reported in microseconds
+        rowValues[columnNameToIndex.get("AVG_WAIT")] =
+            totals.m_waitSamples > 0 ? totals.m_waitNanosSum / (totals.m_waitSamples * 1000.0) : 0.0;
+        rowValues[columnNameToIndex.get("MAX_WAIT")] = totals.m_maxWaitNanos / 1000;
+        super.updateStatsRow(rowKey, rowValues);
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(final boolean interval) {
+        m_interval = interval;
+        final Iterator<Probe> probes = m_probes.iterator();
+        return new Iterator<Object>() {
+            @Override
+            public boolean hasNext() {
+                return probes.hasNext();
+            }
+
+            @Override
+            public Object next() {
+                return probes.next();
+            }
+
+            @Override
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
+    }
+}
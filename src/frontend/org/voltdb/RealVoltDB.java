@@ -86,6 +86,7 @@ import org.voltcore.logging.VoltLogger;
 import org.voltcore.messaging.HostMessenger;
 import org.voltcore.messaging.SiteMailbox;
 import org.voltcore.utils.CoreUtils;
+import org.voltcore.utils.CpuTopology;
 import org.voltcore.utils.OnDemandBinaryLogger;
 import org.voltcore.utils.Pair;
 import org.voltcore.utils.ShutdownHooks;
@@ -155,6 +156,7 @@ import org.voltdb.utils.Encoder;
 import org.voltdb.utils.HTTPAdminListener;
 import org.voltdb.utils.LogKeys;
 import org.voltdb.utils.MiscUtils;
+import org.voltdb.utils.PersistentBinaryDeque;
 import org.voltdb.utils.PlatformProperties;
 import org.voltdb.utils.SystemStatsCollector;
 import org.voltdb.utils.VoltFile;
@@ -1047,6 +1049,7 @@ public class RealVoltDB implements VoltDBInterface, RestoreAgent.Callback, HostM
             m_cpuStats = new CpuStats();
             getStatsAgent().registerStatsSource(StatsSelector.CPU,
                     0, m_cpuStats);
+            registerHostQueueStats();
 
             // ENG-6321
             m_commandLogStats = new CommandLogStats(m_commandLog);
@@ -1142,6 +1145,9 @@ public class RealVoltDB implements VoltDBInterface, RestoreAgent.Callback, HostM
             try {
                 final String serializedCatalog = m_catalogContext.catalog.serialize();
                 boolean createMpDRGateway = true;
+                if (m_config.m_autoCoreBindings && m_config.m_executionCoreBindings.isEmpty()) {
+                    bindSitesByTopology(m_iv2Initiators.size());
+                }
                 for (Initiator iv2init : m_iv2Initiators.values()) {
                     iv2init.configure(
                             getBackendTargetType(),
@@ -1432,6 +1438,25 @@ public class RealVoltDB implements VoltDBInterface, RestoreAgent.Callback, HostM
         }
     }
 
+    /**
+     * Queue an execution binding for each site from the host's NUMA
+     * topology: sites are spread over the nodes, each on a physical core
+     * of its own, so a site's tuple storage is allocated on its node.
+     * Sites beyond the number of cores are left unbound.
+     */
+    private void bindSitesByTopology(int siteCount) {
+        CpuTopology topology = CpuTopology.load();
+        if (topology == null) {
+            hostLog.warn("Unable to read the CPU topology of this host, sites will not be bound to cores.");
+            return;
+        }
+        List<String> bindings = topology.getSiteBindings(siteCount);
+        m_config.m_executionCoreBindings.addAll(bindings);
+        m_config.m_siteCoreBindingSummary = bindings.toString();
+        hostLog.info("Binding " + bindings.size() + " of " + siteCount + " sites to cores " + bindings +
+                " across " + topology.getNodeCount() + " NUMA node(s) with " + topology.getCoreCount() + " cores");
+    }
+
     class StartActionWatcher implements Watcher {
         @Override
         public void process(WatchedEvent event) {
@@ -2250,6 +2275,36 @@ public class RealVoltDB implements VoltDBInterface, RestoreAgent.Callback, HostM
         }
     }
 
+    /**
+     * The handoff queues that belong to the host rather than to a site: writes to the
+     * other hosts and to clients, and the persistent deques behind export and DR.
+     */
+    private void registerHostQueueStats() {
+        QueueStats queueStats = new QueueStats(m_myHostId);
+        queueStats.addProbe(new QueueStats.Probe("FOREIGN_HOST_WRITES") {
+            @Override
+            protected long depth() {
+                return m_messenger.getPendingForeignHostWrites();
+            }
+        });
+        queueStats.addProbe(new QueueStats.Probe("CLIENT_WRITES") {
+            @Override
+            protected long depth() {
+                final ClientInterface ci = m_clientInterface;
+                return ci == null ? 0 : ci.getClientWriteBacklog();
+            }
+
+            @Override
+            protected long oldestPendingNanos() {
+                final ClientInterface ci = m_clientInterface;
+                return ci == null ? 0 : TimeUnit.MILLISECONDS.toNanos(ci.getOldestClientWriteMillis());
+            }
+        });
+        queueStats.addProbe(PersistentBinaryDeque.MONITOR_PROBE);
+        getStatsAgent().registerStatsSource(StatsSelector.QUEUE, 0, queueStats);
+        queueStats.start();
+    }
+
     void collectLocalNetworkMetadata() {
         boolean threw = false;
         JSONStringer stringer = new JSONStringer();
@@ -0,0 +1,123 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+
+import org.voltdb.VoltTable.ColumnInfo;
+import org.voltdb.jni.ExecutionEngine;
+
+/**
+ * The memory a site's execution engine holds, broken down by subsystem.
+ * The site refreshes the numbers on its stats tick, from the table and
+ * index stats it already rolls up and from ExecutionEngine.getMemoryDetail().
+ * Reported in KB, like the MEMORY selector.
+ */
+public class SiteMemoryStats extends SiteStatsSource {
+
+    public enum Subsystem {
+        TUPLE_DATA(-1),
+        TUPLE_ALLOCATED(-1),
+        STRING(-1),
+        INDEX(-1),
+        // The rest come from the EE, at these indexes of MemoryDetailType
+        POOL_EXACT_SIZED(0),
+        POOL_RELOCATABLE(1),
+        TEMP_TABLE(2),
+        TEMP_TABLE_PEAK(3),
+        UNDO(4),
+        EXPORT_PENDING(5),
+        DR_PENDING(6),
+        PLAN_CACHE(7),
+        SNAPSHOT_COPIES(8);
+
+        final int m_eeIndex;
+
+        Subsystem(int eeIndex) {
+            assert(eeIndex < ExecutionEngine.MEMORY_DETAIL_COUNT);
+            m_eeIndex = eeIndex;
+        }
+    }
+
+    private static final Subsystem[] SUBSYSTEMS = Subsystem.values();
+
+    // Replaced as a whole by the site thread, read by the stats thread
+    private volatile long[] m_memoryKB = new long[SUBSYSTEMS.length];
+
+    public SiteMemoryStats(long siteId) {
+        super(siteId, false);
+    }
+
+    /**
+     * The KB arguments are the site's sums of the table and index stats.
+     * @param eeDetail Bytes per subsystem, as returned by ExecutionEngine.getMemoryDetail()
+     */
+    public void update(long tupleDataKB, long tupleAllocatedKB, long stringKB, long indexKB, long[] eeDetail) {
+        long[] memoryKB = new long[SUBSYSTEMS.length];
+        for (Subsystem subsystem : SUBSYSTEMS) {
+            if (subsystem.m_eeIndex >= 0) {
+                memoryKB[subsystem.ordinal()] = eeDetail[subsystem.m_eeIndex] / 1024;
+            }
+        }
+        memoryKB[Subsystem.TUPLE_DATA.ordinal()] = tupleDataKB;
+        memoryKB[Subsystem.TUPLE_ALLOCATED.ordinal()] = tupleAllocatedKB;
+        memoryKB[Subsystem.STRING.ordinal()] = stringKB;
+        memoryKB[Subsystem.INDEX.ordinal()] = indexKB;
+        m_memoryKB = memoryKB;
+    }
+
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("SUBSYSTEM", VoltType.STRING));
+        columns.add(new ColumnInfo("MEMORY", VoltType.BIGINT));
+    }
+
+    @Override
+    protected void updateStatsRow(Object rowKey, Object rowValues[]) {
+        final Subsystem subsystem = (Subsystem)rowKey;
+        rowValues[columnNameToIndex.get("SUBSYSTEM")] = subsystem.name();
+        rowValues[columnNameToIndex.get("MEMORY")] = m_memoryKB[subsystem.ordinal()];
+        super.updateStatsRow(rowKey, rowValues);
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(final boolean interval) {
+        return new Iterator<Object>() {
+            int m_next = 0;
+            @Override
+            public boolean hasNext() {
+                return m_next < SUBSYSTEMS.length;
+            }
+
+            @Override
+            public Object next() {
+                if (m_next < SUBSYSTEMS.length) {
+                    return SUBSYSTEMS[m_next++];
+                } else {
+                    return null;
+                }
+            }
+
+            @Override
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
+    }
+}
@@ -0,0 +1,147 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * Breaks the wall clock time of a site thread down by what the thread was doing.
+ *
+ * The site thread brackets each piece of work with beginActivity()/endActivity().
+ * Activities nest and the accounting is exclusive: time spent in a nested activity
+ * is charged only to it, so the time left to PROCEDURE is the procedure's own Java
+ * code and JNI is the cost of the crossing (parameter and result serialization)
+ * around the native calls. Time outside of any bracket is charged to OTHER.
+ *
+ * Only the site thread updates the tracker. The stats thread reads the totals
+ * without synchronization, so a row may lag the site by the activity in progress.
+ */
+public class SiteTimeTracker extends SiteStatsSource {
+
+    public enum Activity {
+        IDLE,               // blocked waiting for a task
+        PROCEDURE,          // procedure and transaction Java code
+        JNI,                // Java side of EE calls: serialization and crossing
+        EE_EXECUTE,         // plan fragment execution inside the EE
+        EE_UNDO_RELEASE,    // undo and release of undo quanta, including compaction at release
+        SNAPSHOT,           // snapshot streaming
+        TICK,               // export and DR flush and idle compaction on the EE tick
+        STATS,              // statistics collection
+        OTHER
+    }
+
+    private static final Activity[] ACTIVITIES = Activity.values();
+    private static final int MAX_DEPTH = 16;
+
+    private final long[] m_totalNanos = new long[ACTIVITIES.length];
+    private final long[] m_lastTotalNanos = new long[ACTIVITIES.length];
+    private final Activity[] m_stack = new Activity[MAX_DEPTH];
+    private int m_depth = 0;
+    private Activity m_current = Activity.OTHER;
+    private long m_lastTransitionNanos;
+    private long m_startTime;
+    private long m_lastStartTime;
+
+    private boolean m_interval;
+
+    public SiteTimeTracker(long siteId) {
+        super(siteId, false);
+        m_lastTransitionNanos = m_lastStartTime = m_startTime = System.nanoTime();
+    }
+
+    public void beginActivity(Activity activity) {
+        final long now = System.nanoTime();
+        m_totalNanos[m_current.ordinal()] += now - m_lastTransitionNanos;
+        m_lastTransitionNanos = now;
+        if (m_depth < MAX_DEPTH) {
+            m_stack[m_depth] = m_current;
+        }
+        m_depth++;
+        m_current = activity;
+    }
+
+    public void endActivity() {
+        final long now = System.nanoTime();
+        m_totalNanos[m_current.ordinal()] += now - m_lastTransitionNanos;
+        m_lastTransitionNanos = now;
+        assert(m_depth > 0);
+        m_depth--;
+        m_current = m_depth < MAX_DEPTH ? m_stack[m_depth] : m_current;
+    }
+
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("ACTIVITY", VoltType.STRING));
+        columns.add(new ColumnInfo("TIME", VoltType.BIGINT));
+        columns.add(new ColumnInfo("PERCENT", VoltType.FLOAT));
+    }
+
+    @Override
+    protected void updateStatsRow(Object rowKey, Object rowValues[]) {
+        final Activity activity = (Activity)rowKey;
+        final int idx = activity.ordinal();
+        final long now = System.nanoTime();
+        final long nanos;
+        final long elapsed;
+        if (m_interval) {
+            final long total = m_totalNanos[idx];
+            nanos = total - m_lastTotalNanos[idx];
+            m_lastTotalNanos[idx] = total;
+            elapsed = now - m_lastStartTime;
+        } else {
+            nanos = m_totalNanos[idx];
+            elapsed = now - m_startTime;
+        }
+        rowValues[columnNameToIndex.get("ACTIVITY")] = activity.name();
+        rowValues[columnNameToIndex.get("TIME")] = nanos / 1000;
+        rowValues[columnNameToIndex.get("PERCENT")] = elapsed > 0 ? nanos / (elapsed / 100.0) : 0.0;
+        super.updateStatsRow(rowKey, rowValues);
+        if (m_interval && idx == ACTIVITIES.length - 1) {
+            m_lastStartTime = now;
+        }
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(final boolean interval) {
+        m_interval = interval;
+        return new Iterator<Object>() {
+            int m_next = 0;
+            @Override
+            public boolean hasNext() {
+                return m_next < ACTIVITIES.length;
+            }
+
+            @Override
+            public Object next() {
+                if (m_next < ACTIVITIES.length) {
+                    return ACTIVITIES[m_next++];
+                } else {
+                    return null;
+                }
+            }
+
+            @Override
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
+    }
+}
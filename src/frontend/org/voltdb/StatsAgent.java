@@ -38,6 +38,13 @@ public class StatsAgent extends OpsAgent
     private final NonBlockingHashMap<StatsSelector, NonBlockingHashMap<Long, NonBlockingHashSet<StatsSource>>> registeredStatsSources =
             new NonBlockingHashMap<StatsSelector, NonBlockingHashMap<Long, NonBlockingHashSet<StatsSource>>>();
 
+    // @Statistics interval argument asking only for rows that changed since
+    // the same connection's last such poll of the selector
+    public static final long CHANGES_SINCE_LAST_POLL = 2;
+
+    // What each host last sent to the connections polling for changes
+    private final StatsDeltaTracker m_deltaTracker = new StatsDeltaTracker();
+
     public StatsAgent()
     {
         super("StatsAgent");
@@ -239,6 +246,9 @@ public class StatsAgent extends OpsAgent
             return;
         }
 
+        if (obj.getBoolean("changes")) {
+            obj.put("connectionId", c.connectionId());
+        }
         PendingOpsRequest psr =
                 new PendingOpsRequest(
                         selector,
@@ -275,11 +285,25 @@ public class StatsAgent extends OpsAgent
         }
 
         boolean interval = false;
+        boolean changes = false;
         if (params.toArray().length == 2) {
-            interval = ((Number)(params.toArray()[1])).longValue() == 1L;
+            long intervalArg = ((Number)(params.toArray()[1])).longValue();
+            interval = intervalArg == 1L;
+            changes = intervalArg == CHANGES_SINCE_LAST_POLL;
+        }
+        if (changes) {
+            // These are aggregated after every host's rows are in, which
+            // only some of the rows wouldn't add up to.
+            StatsSelector s = StatsSelector.valueOf(subselector);
+            if (s == StatsSelector.PROCEDUREPROFILE ||
+                    s == StatsSelector.PROCEDUREINPUT ||
+                    s == StatsSelector.PROCEDUREOUTPUT) {
+                return "@Statistics selector " + subselector + " can't be polled for changes";
+            }
         }
         obj.put("subselector", subselector);
         obj.put("interval", interval);
+        obj.put("changes", changes);
 
         return null;
     }
@@ -292,6 +316,12 @@ public class StatsAgent extends OpsAgent
             OpsSelector selector = OpsSelector.valueOf(obj.getString("selector").toUpperCase());
             if (selector == OpsSelector.STATISTICS) {
                 results = collectDistributedStats(obj);
+                if (results != null && obj.optBoolean("changes")) {
+                    // a connection is identified by the agent it polls through
+                    String subscriber = obj.getLong("returnAddress") + ":" +
+                            obj.getLong("connectionId") + ":" + obj.getString("subselector");
+                    results = m_deltaTracker.getChangedRows(subscriber, results, System.currentTimeMillis());
+                }
             }
             else {
                 hostLog.warn("StatsAgent received a non-STATISTICS OPS selector: " + selector);
@@ -400,6 +430,21 @@ public class StatsAgent extends OpsAgent
         case STARVATION:
             stats = collectStats(StatsSelector.STARVATION, interval);
             break;
+        case SITETIME:
+            stats = collectStats(StatsSelector.SITETIME, interval);
+            break;
+        case QUEUE:
+            stats = collectStats(StatsSelector.QUEUE, interval);
+            break;
+        case JNICALLS:
+            stats = collectStats(StatsSelector.JNICALLS, interval);
+            break;
+        case NATIVESTACKS:
+            stats = collectStats(StatsSelector.NATIVESTACKS, interval);
+            break;
+        case MEMORYDETAIL:
+            stats = collectStats(StatsSelector.MEMORYDETAIL, interval);
+            break;
         case PLANNER:
             stats = collectStats(StatsSelector.PLANNER, interval);
             break;
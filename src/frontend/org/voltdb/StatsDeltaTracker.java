@@ -0,0 +1,115 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package org.voltdb;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
+/**
+ * Remembers the stats rows this host last sent to each subscriber polling
+ * @Statistics for changes, and cuts later results down to the rows that
+ * changed since. A row is unchanged if a row with the same values in every
+ * column but TIMESTAMP was sent last time. Rows that went away are not
+ * reported. Subscribers that stop polling are forgotten after
+ * SUBSCRIBER_TIMEOUT_MS.
+ *
+ * Not thread safe, the StatsAgent only uses it from its own thread.
+ */
+class StatsDeltaTracker {
+    static final long SUBSCRIBER_TIMEOUT_MS = 5 * 60 * 1000;
+
+    private static class Subscriber {
+        long lastPollTime;
+        // per result table, the rows sent last time
+        List<Set<List<Object>>> sentRows = new ArrayList<Set<List<Object>>>();
+    }
+
+    private final Map<String, Subscriber> m_subscribers = new HashMap<String, Subscriber>();
+
+    /**
+     * Filter the tables collected for a subscriber's poll down to the rows
+     * that changed since its previous poll, and remember all of them for the
+     * next one. The first poll of a subscriber gets every row.
+     */
+    VoltTable[] getChangedRows(String subscriberKey, VoltTable[] tables, long now) {
+        forgetIdleSubscribers(now);
+
+        Subscriber subscriber = m_subscribers.get(subscriberKey);
+        if (subscriber == null || subscriber.sentRows.size() != tables.length) {
+            subscriber = new Subscriber();
+            for (int ii = 0; ii < tables.length; ii++) {
+                subscriber.sentRows.add(new HashSet<List<Object>>());
+            }
+            m_subscribers.put(subscriberKey, subscriber);
+        }
+        subscriber.lastPollTime = now;
+
+        VoltTable[] changed = new VoltTable[tables.length];
+        for (int ii = 0; ii < tables.length; ii++) {
+            VoltTable table = tables[ii];
+            if (table == null) {
+                continue;
+            }
+            VoltTable.ColumnInfo[] columns = new VoltTable.ColumnInfo[table.getColumnCount()];
+            int timestampColumn = -1;
+            for (int col = 0; col < columns.length; col++) {
+                columns[col] = new VoltTable.ColumnInfo(table.getColumnName(col), table.getColumnType(col));
+                if (table.getColumnName(col).equalsIgnoreCase("TIMESTAMP")) {
+                    timestampColumn = col;
+                }
+            }
+
+            Set<List<Object>> lastSent = subscriber.sentRows.get(ii);
+            Set<List<Object>> sent = new HashSet<List<Object>>();
+            changed[ii] = new VoltTable(columns);
+            table.resetRowPosition();
+            while (table.advanceRow()) {
+                List<Object> row = new ArrayList<Object>(columns.length);
+                for (int col = 0; col < columns.length; col++) {
+                    if (col == timestampColumn) {
+                        continue;
+                    }
+                    Object value = table.get(col, table.getColumnType(col));
+                    // compare varbinary by content
+                    row.add(value instanceof byte[] ? ByteBuffer.wrap((byte[]) value) : value);
+                }
+                if (!lastSent.contains(row)) {
+                    changed[ii].add(table);
+                }
+                sent.add(row);
+            }
+            table.resetRowPosition();
+            subscriber.sentRows.set(ii, sent);
+        }
+        return changed;
+    }
+
+    private void forgetIdleSubscribers(long now) {
+        Iterator<Subscriber> iter = m_subscribers.values().iterator();
+        while (iter.hasNext()) {
+            if (now - iter.next().lastPollTime > SUBSCRIBER_TIMEOUT_MS) {
+                iter.remove();
+            }
+        }
+    }
+}
@@ -21,12 +21,17 @@ public enum StatsSelector {
     INDEX,            // invoked as @stat index
     PROCEDURE,        // invoked as @stat procedure
     STARVATION,
+    SITETIME,         // site thread time broken down by activity
+    QUEUE,            // depth and wait time of the queues and locks between threads
+    JNICALLS,         // count and time of the calls between a site and its EE
+    NATIVESTACKS,     // sampled native stacks of each site's EE, in folded form
     INITIATOR,        // invoked as @stat initiator
     LATENCY,          // invoked as @stat latency
     LATENCY_HISTOGRAM,
     PARTITIONCOUNT,
     IOSTATS,
     MEMORY,           // info about node's memory usage
+    MEMORYDETAIL,     // memory of each site broken down by subsystem
     LIVECLIENTS,      // info about the currently connected clients
     PLANNER,          // info about planner and EE performance and cache usage
     MANAGEMENT,       // Returns pretty much everything
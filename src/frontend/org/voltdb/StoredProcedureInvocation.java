@@ -96,6 +96,25 @@ public class StoredProcedureInvocation implements JSONString {
         return copy;
     }
 
+    /**
+     * A shallow copy that shares the serialized parameters but not a
+     * parameter set already deserialized from them; it deserializes its
+     * own on demand. Only valid when the parameters are serialized.
+     */
+    public StoredProcedureInvocation getShallowCopyWithSerializedParams()
+    {
+        assert(serializedParams != null);
+        StoredProcedureInvocation copy = getShallowCopy();
+        final ByteBuffer duplicate = copy.serializedParams.duplicate();
+        copy.params = new FutureTask<ParameterSet>(new Callable<ParameterSet>() {
+            @Override
+            public ParameterSet call() throws Exception {
+                return ParameterSet.fromByteBuffer(duplicate);
+            }
+        });
+        return copy;
+    }
+
     public void setProcName(String name) {
         if (name == null) {
             throw new IllegalArgumentException("SPI setProcName(String name) doesn't accept NULL.");
@@ -48,5 +48,9 @@ public class TableStats extends SiteStatsSource {
         columns.add(new ColumnInfo("STRING_DATA_MEMORY", VoltType.BIGINT));
         columns.add(new ColumnInfo("TUPLE_LIMIT", VoltType.INTEGER));
         columns.add(new ColumnInfo("PERCENT_FULL", VoltType.INTEGER));
+        columns.add(new ColumnInfo("COMPACTED_TUPLE_COUNT", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COLD_TUPLE_MEMORY", VoltType.BIGINT));
+        columns.add(new ColumnInfo("BLOCK_EVICTION_COUNT", VoltType.BIGINT));
+        columns.add(new ColumnInfo("CHANGED_BLOCK_COUNT", VoltType.BIGINT));
     }
 }
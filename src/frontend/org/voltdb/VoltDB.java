@@ -240,6 +240,10 @@ public class VoltDB {
         public final Queue<String> m_computationCoreBindings = new ArrayDeque<String>();
         public final Queue<String> m_executionCoreBindings = new ArrayDeque<String>();
         public String m_commandLogBinding = null;
+        /** Bind sites to cores chosen from the host's NUMA topology when no execution bindings are given */
+        public boolean m_autoCoreBindings = false;
+        /** The cores sites were bound to from the topology, for the system information overview */
+        public String m_siteCoreBindingSummary = null;
 
         /**
          * Allow a secret CLI config option to test multiple versions of VoltDB running together.
@@ -480,6 +484,8 @@ public class VoltDB {
                         m_executionCoreBindings.offer(core);
                     }
                     System.out.println("Execution bindings are " + m_executionCoreBindings);
+                } else if (arg.equals("autobindings")) {
+                    m_autoCoreBindings = true;
                 } else if (arg.startsWith("commandlogbinding")) {
                     String binding = args[++i];
                     if (binding.split(",").length > 1) {
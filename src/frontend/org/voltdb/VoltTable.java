@@ -30,6 +30,7 @@ import org.json_voltpatches.JSONException;
 import org.json_voltpatches.JSONObject;
 import org.json_voltpatches.JSONString;
 import org.json_voltpatches.JSONStringer;
+import org.json_voltpatches.JSONWriter;
 import org.voltdb.client.ClientUtils;
 import org.voltdb.common.Constants;
 import org.voltdb.types.GeographyPointValue;
@@ -1236,6 +1237,141 @@ public final class VoltTable extends VoltTableRow implements JSONString {
         }
     }
 
+    /**
+     * Read every row's value of an integer or timestamp column in one pass,
+     * without advancing through the rows or changing the active row.
+     * A <tt>null</tt> value is returned as {@link VoltType#NULL_BIGINT},
+     * whatever the width of the column.
+     * @param columnIndex Index of a TINYINT, SMALLINT, INTEGER, BIGINT or TIMESTAMP column
+     * @return The column's values, in row order.
+     */
+    public final long[] getLongColumn(int columnIndex) {
+        final VoltType type = getBulkColumnType(columnIndex);
+        switch (type) {
+        case TINYINT:
+        case SMALLINT:
+        case INTEGER:
+        case BIGINT:
+        case TIMESTAMP:
+            break;
+        default:
+            throw new IllegalArgumentException("getLongColumn() called on non-integral column.");
+        }
+
+        final long[] values = new long[m_rowCount];
+        final BulkColumnReader reader = new BulkColumnReader(columnIndex);
+        for (int row = 0; row < m_rowCount; row++) {
+            final int position = reader.nextPosition();
+            long value;
+            switch (type) {
+            case TINYINT:
+                final byte value1 = m_buffer.get(position);
+                value = (value1 == VoltType.NULL_TINYINT) ? VoltType.NULL_BIGINT : value1;
+                break;
+            case SMALLINT:
+                final short value2 = m_buffer.getShort(position);
+                value = (value2 == VoltType.NULL_SMALLINT) ? VoltType.NULL_BIGINT : value2;
+                break;
+            case INTEGER:
+                final int value3 = m_buffer.getInt(position);
+                value = (value3 == VoltType.NULL_INTEGER) ? VoltType.NULL_BIGINT : value3;
+                break;
+            default:
+                value = m_buffer.getLong(position);
+            }
+            values[row] = value;
+        }
+        return values;
+    }
+
+    /**
+     * Read every row's value of a FLOAT column in one pass, without
+     * advancing through the rows or changing the active row.
+     * A <tt>null</tt> value is returned as {@link VoltType#NULL_FLOAT}.
+     * @param columnIndex Index of a FLOAT column
+     * @return The column's values, in row order.
+     */
+    public final double[] getDoubleColumn(int columnIndex) {
+        if (getBulkColumnType(columnIndex) != VoltType.FLOAT) {
+            throw new IllegalArgumentException("getDoubleColumn() called on non-float column.");
+        }
+
+        final double[] values = new double[m_rowCount];
+        final BulkColumnReader reader = new BulkColumnReader(columnIndex);
+        for (int row = 0; row < m_rowCount; row++) {
+            final double value = m_buffer.getDouble(reader.nextPosition());
+            values[row] = (value <= VoltType.NULL_FLOAT) ? VoltType.NULL_FLOAT : value;
+        }
+        return values;
+    }
+
+    private VoltType getBulkColumnType(int columnIndex) {
+        assert(verifyTableInvariants());
+        if ((columnIndex < 0) || (columnIndex >= m_colCount)) {
+            throw new IndexOutOfBoundsException("Column index " + columnIndex +
+                    " is not between 0 and " + (m_colCount - 1));
+        }
+        return getColumnType(columnIndex);
+    }
+
+    /**
+     * Walks the rows for the bulk column reads, yielding where one column's
+     * value is in each row. The widths of the columns before it are looked
+     * up once. When they are all fixed width the value is at the same
+     * offset in every row, and finding it costs only the read of the row's
+     * length needed to get to the next row.
+     */
+    private final class BulkColumnReader {
+        // Offset of the value in the row data, or -1 if it varies.
+        private final int m_fixedOffset;
+        // Widths of the columns before it when it varies, -1 where variable.
+        private final int[] m_widths;
+        private int m_rowPosition;
+
+        BulkColumnReader(int columnIndex) {
+            int fixedOffset = 0;
+            final int[] widths = new int[columnIndex];
+            for (int i = 0; i < columnIndex; i++) {
+                final VoltType type = getColumnType(i);
+                if (type.isVariableLength()) {
+                    widths[i] = -1;
+                    fixedOffset = -1;
+                }
+                else {
+                    widths[i] = type.getLengthInBytesForFixedTypes();
+                    if (fixedOffset >= 0) {
+                        fixedOffset += widths[i];
+                    }
+                }
+            }
+            m_fixedOffset = fixedOffset;
+            m_widths = (fixedOffset >= 0) ? null : widths;
+            m_rowPosition = m_rowStart + ROW_COUNT_SIZE;
+        }
+
+        int nextPosition() {
+            final int dataStart = m_rowPosition + ROW_HEADER_SIZE;
+            // add 4 bytes as the row size is non-inclusive
+            m_rowPosition = dataStart + m_buffer.getInt(m_rowPosition);
+            if (m_fixedOffset >= 0) {
+                return dataStart + m_fixedOffset;
+            }
+            int position = dataStart;
+            for (int i = 0; i < m_widths.length; i++) {
+                if (m_widths[i] >= 0) {
+                    position += m_widths[i];
+                    continue;
+                }
+                final int len = m_buffer.getInt(position);
+                position += STRING_LEN_SIZE;
+                if (len != NULL_STRING_INDICATOR) {
+                    position += len;
+                }
+            }
+            return position;
+        }
+    }
+
     /**
      * Returns a {@link java.lang.String String} representation of this table.
      * Resulting string will contain schema and all data and will be formatted.
@@ -1557,42 +1693,51 @@ public final class VoltTable extends VoltTableRow implements JSONString {
     public String toJSONString() {
         JSONStringer js = new JSONStringer();
         try {
+            toJSONWriter(js);
+        }
+        catch (JSONException e) {
+            e.printStackTrace();
+            throw new RuntimeException("Failed to serialized a table to JSON.", e);
+        }
+        return js.toString();
+    }
 
-            js.object();
+    /**
+     * Write a JSON representation of this table to the given writer, without
+     * building it as an intermediate string.
+     * @param js Writer positioned where a JSON value may be written.
+     * @throws JSONException on JSON-related error.
+     */
+    public void toJSONWriter(JSONWriter js) throws JSONException {
+        js.object();
 
-            // status code (1 byte)
-            js.keySymbolValuePair(JSON_STATUS_KEY, getStatusCode());
+        // status code (1 byte)
+        js.keySymbolValuePair(JSON_STATUS_KEY, getStatusCode());
 
-            // column schema
-            js.key(JSON_SCHEMA_KEY).array();
-            for (int i = 0; i < getColumnCount(); i++) {
-                js.object();
-                js.keySymbolValuePair(JSON_NAME_KEY, getColumnName(i));
-                js.keySymbolValuePair(JSON_TYPE_KEY, getColumnType(i).getValue());
-                js.endObject();
-            }
-            js.endArray();
+        // column schema
+        js.key(JSON_SCHEMA_KEY).array();
+        for (int i = 0; i < getColumnCount(); i++) {
+            js.object();
+            js.keySymbolValuePair(JSON_NAME_KEY, getColumnName(i));
+            js.keySymbolValuePair(JSON_TYPE_KEY, getColumnType(i).getValue());
+            js.endObject();
+        }
+        js.endArray();
 
-            // row data
-            js.key(JSON_DATA_KEY).array();
-            VoltTableRow row = cloneRow();
-            row.resetRowPosition();
-            while (row.advanceRow()) {
-                js.array();
-                for (int i = 0; i < getColumnCount(); i++) {
-                    row.putJSONRep(i, js);
-                }
-                js.endArray();
+        // row data
+        js.key(JSON_DATA_KEY).array();
+        VoltTableRow row = cloneRow();
+        row.resetRowPosition();
+        while (row.advanceRow()) {
+            js.array();
+            for (int i = 0; i < getColumnCount(); i++) {
+                row.putJSONRep(i, js);
             }
             js.endArray();
-
-            js.endObject();
         }
-        catch (JSONException e) {
-            e.printStackTrace();
-            throw new RuntimeException("Failed to serialized a table to JSON.", e);
-        }
-        return js.toString();
+        js.endArray();
+
+        js.endObject();
     }
 
     /**
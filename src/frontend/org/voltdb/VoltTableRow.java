@@ -22,7 +22,7 @@ import java.nio.ByteBuffer;
 import java.nio.charset.Charset;
 
 import org.json_voltpatches.JSONException;
-import org.json_voltpatches.JSONStringer;
+import org.json_voltpatches.JSONWriter;
 import org.voltdb.types.GeographyPointValue;
 import org.voltdb.types.GeographyValue;
 import org.voltdb.types.TimestampType;
@@ -842,7 +842,7 @@ public abstract class VoltTableRow {
      * @param js
      * @throws JSONException
      */
-    void putJSONRep(int columnIndex, JSONStringer js) throws JSONException {
+    void putJSONRep(int columnIndex, JSONWriter js) throws JSONException {
         long value; double dvalue;
 
         VoltType columnType = getColumnType(columnIndex);
@@ -86,6 +86,8 @@ class Distributer {
     static final long PING_HANDLE = Long.MAX_VALUE;
     public static final Long ASYNC_TOPO_HANDLE = PING_HANDLE - 1;
     static final long USE_DEFAULT_CLIENT_TIMEOUT = 0;
+    // weight of each new sample in a connection's round trip average is 1/8
+    static final int ROUND_TRIP_EWMA_DIVISOR = 8;
     static long PARTITION_KEYS_INFO_REFRESH_FREQUENCY = Long.getLong("PARTITION_KEYS_INFO_REFRESH_FREQUENCY", 1000);
 
     // handles used internally are negative and decrement for each call
@@ -401,6 +403,9 @@ class Distributer {
         private volatile boolean m_isConnected = true;
 
         volatile long m_lastResponseTimeNanos = System.nanoTime();
+        // exponentially weighted moving average of client round trip times,
+        // used to pick among replicas for affinity reads
+        volatile long m_avgRoundTripNanos = 0;
         boolean m_outstandingPing = false;
         ClientStatusListenerExt.DisconnectCause m_closeCause = DisconnectCause.CONNECTION_CLOSED;
 
@@ -691,6 +696,7 @@ class Distributer {
                 int clusterRoundTrip = response.getClusterRoundtrip();
                 m_rateLimiter.transactionResponseReceived(nowNanos, clusterRoundTrip, stuff.ignoreBackpressure);
                 updateStats(stuff.name, deltaNanos, clusterRoundTrip, abort, error, false);
+                updateAverageRoundTrip(deltaNanos);
                 response.setClientRoundtrip(deltaNanos);
                 assert(response.getHash() == null); // make sure it didn't sneak into wire protocol
                 try {
@@ -714,6 +720,23 @@ class Distributer {
             return m_connection.writeStream().hadBackPressure();
         }
 
+        /**
+         * Only the network thread updates the average, so a plain read-modify-write is safe.
+         */
+        private void updateAverageRoundTrip(long roundTripNanos) {
+            final long avg = m_avgRoundTripNanos;
+            m_avgRoundTripNanos = (avg == 0) ? roundTripNanos :
+                avg + (roundTripNanos - avg) / ROUND_TRIP_EWMA_DIVISOR;
+        }
+
+        /**
+         * Expected wait for a new request: the average round trip scaled by the
+         * number of requests already outstanding on this connection.
+         */
+        long loadScore() {
+            return Math.max(1, m_avgRoundTripNanos) * (m_callbacksToInvoke.get() + 1);
+        }
+
 
         @Override
         public void stopping(Connection c) {
@@ -1114,16 +1137,7 @@ class Distributer {
                     if (!procedureInfo.multiPart && procedureInfo.readOnly && m_sendReadsToReplicasBytDefaultIfCAEnabled) {
                         NodeConnection partitionReplicas[] = m_partitionReplicas.get(hashedPartition);
                         if (partitionReplicas != null && partitionReplicas.length > 0) {
-                            cxn = partitionReplicas[ThreadLocalRandom.current().nextInt(partitionReplicas.length)];
-                            if (cxn.hadBackPressure()) {
-                                //See if there is one without backpressure, make sure it's still connected
-                                for (NodeConnection nc : partitionReplicas) {
-                                    if (!nc.hadBackPressure() && nc.m_isConnected) {
-                                        cxn = nc;
-                                        break;
-                                    }
-                                }
-                            }
+                            cxn = pickLeastLoadedReplica(partitionReplicas);
                             if (!cxn.hadBackPressure() || ignoreBackpressure) {
                                 backpressure = false;
                             }
@@ -1295,6 +1309,29 @@ class Distributer {
         return retval;
     }
 
+    /**
+     * Pick the connected replica without backpressure that has the lowest expected
+     * wait, starting from a random replica so that ties are spread evenly. If every
+     * replica has backpressure, a random one is returned.
+     */
+    private static NodeConnection pickLeastLoadedReplica(NodeConnection[] replicas) {
+        final int start = ThreadLocalRandom.current().nextInt(replicas.length);
+        NodeConnection best = null;
+        long bestScore = Long.MAX_VALUE;
+        for (int i = 0; i < replicas.length; i++) {
+            final NodeConnection nc = replicas[(start + i) % replicas.length];
+            if (!nc.m_isConnected || nc.hadBackPressure()) {
+                continue;
+            }
+            final long score = nc.loadScore();
+            if (score < bestScore) {
+                best = nc;
+                bestScore = score;
+            }
+        }
+        return (best != null) ? best : replicas[start];
+    }
+
     Map<Integer, ClientAffinityStats> getAffinityStatsSnapshot()
     {
         Map<Integer, ClientAffinityStats> retval = new HashMap<>();
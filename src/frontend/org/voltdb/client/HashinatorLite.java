@@ -67,6 +67,13 @@ public class HashinatorLite {
      */
     private long m_etokens = 0;
     private int m_etokenCount;
+    /*
+     * Index of the first token in each bucket of the ring, the tokens sharing the high bits of their
+     * offset from Integer.MIN_VALUE, followed by the token count. Built as ElasticHashinator builds it.
+     */
+    private static final int MAX_BUCKET_BITS = 16;
+    private int[] m_ebucketStarts;
+    private int m_ebucketShift;
 
     private final HashinatorLiteType m_type;
 
@@ -85,6 +92,7 @@ public class HashinatorLite {
             Pair<Long, Integer> p = (cooked ? updateCooked(configBytes) : updateRaw(configBytes));
             m_etokens = p.getFirst();
             m_etokenCount = p.getSecond();
+            buildBuckets();
         }
         else {
             catalogPartitionCount = ByteBuffer.wrap(configBytes).getInt();
@@ -244,9 +252,30 @@ public class HashinatorLite {
         }
     }
 
+    private void buildBuckets() {
+        int bucketBits = 1;
+        while (bucketBits < MAX_BUCKET_BITS && (1 << bucketBits) < m_etokenCount) {
+            bucketBits++;
+        }
+        m_ebucketShift = 32 - bucketBits;
+        final int bucketCount = 1 << bucketBits;
+        m_ebucketStarts = new int[bucketCount + 1];
+        int ii = 0;
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            final long bucketLow = ((long) bucket) << m_ebucketShift;
+            while (ii < m_etokenCount &&
+                    ((Bits.unsafe.getInt(m_etokens + (ii * 8)) ^ Integer.MIN_VALUE) & 0xFFFFFFFFL) < bucketLow) {
+                ii++;
+            }
+            m_ebucketStarts[bucket] = ii;
+        }
+        m_ebucketStarts[bucketCount] = m_etokenCount;
+    }
+
     private long getTokenPtr(int hash) {
-        int min = 0;
-        int max = m_etokenCount - 1;
+        final int bucket = (hash ^ Integer.MIN_VALUE) >>> m_ebucketShift;
+        int min = m_ebucketStarts[bucket];
+        int max = m_ebucketStarts[bucket + 1] - 1;
 
         while (min <= max) {
             int mid = (min + max) >>> 1;
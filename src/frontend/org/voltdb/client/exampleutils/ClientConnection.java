@@ -277,6 +277,18 @@ public class ClientConnection implements Closeable
         return result;
     }
 
+    /**
+     * Creates a statistics context on the native {@link Client} wrapped by this connection, for the
+     * latency percentiles the {@link PerfCounter} histograms are too coarse to give.
+     *
+     * @return a new context whose baseline is the client's current state.
+     * @see Client#createStatsContext()
+     */
+    public ClientStatsContext createStatsContext()
+    {
+        return Client.createStatsContext();
+    }
+
     /**
      * Save statistics to a CSV file.
      *
@@ -101,6 +101,12 @@ public class DDLCompiler {
     private static final String EXPORT = "EXPORT";
     private static final String ROLE = "ROLE";
     private static final String DR = "DR";
+    private static final String TTL = "TTL";
+    private static final String APPEND = "APPEND";
+    private static final String CLUSTER = "CLUSTER";
+
+    // Expired rows each partition deletes per tick when TTL TABLE gives no BATCH_SIZE
+    private static final int DEFAULT_TTL_BATCH_SIZE = 1000;
 
     private final HSQLInterface m_hsql;
     private final VoltCompiler m_compiler;
@@ -373,6 +379,7 @@ public class DDLCompiler {
         // For now, this is:
         // - ensuring that the partition columns on tables are correct.  The hard
         // case is when the partition column is dropped from the table
+        // - dropping the TTL of a table whose TTL column is dropped
 
         // Each statement can change at most one table. Check to see if the table is listed in
         // the changed nodes
@@ -410,6 +417,13 @@ public class DDLCompiler {
             m_compiler.addWarn(String.format("Partition column %s was dropped from table %s.  Attempting to change table to replicated.", partitionCol, tableElement.attributes.get("name")));
             tableElement.attributes.remove("partitioncolumn");
         }
+        String ttlCol = tableElement.attributes.get("ttlColumn");
+        if (ttlCol != null && removedColumns.contains(ttlCol)) {
+            m_compiler.addWarn(String.format("TTL column %s was dropped from table %s.  Rows will no longer expire.", ttlCol, tableElement.attributes.get("name")));
+            tableElement.attributes.remove("ttlColumn");
+            tableElement.attributes.remove("ttlSeconds");
+            tableElement.attributes.remove("ttlBatchSize");
+        }
     }
 
     /**
@@ -954,6 +968,103 @@ public class DDLCompiler {
             return true;
         }
 
+        // matches if it is TTL TABLE <table-name> ON COLUMN <column-name> <value> [<unit>] [BATCH_SIZE <rows>]
+        // or TTL TABLE <table-name> DISABLE
+        statementMatcher = SQLParser.matchTTLTable(statement);
+        if (statementMatcher.matches()) {
+            String tableName = checkIdentifierStart(statementMatcher.group(1), statement);
+            VoltXMLElement tableXML = m_schema.findChild("table", tableName.toUpperCase());
+            if (tableXML == null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "While configuring TTL, table %s was not present in the catalog.", tableName));
+            }
+            if (statementMatcher.group(2) != null) {
+                tableXML.attributes.remove("ttlColumn");
+                tableXML.attributes.remove("ttlSeconds");
+                tableXML.attributes.remove("ttlBatchSize");
+                return true;
+            }
+
+            // Column validity check done in addTableToCatalog
+            String columnName = checkIdentifierStart(statementMatcher.group(3), statement).toUpperCase();
+            long seconds;
+            long batchSize = DEFAULT_TTL_BATCH_SIZE;
+            try {
+                seconds = Long.parseLong(statementMatcher.group(4));
+                if (statementMatcher.group(6) != null) {
+                    batchSize = Long.parseLong(statementMatcher.group(6));
+                }
+            }
+            catch (NumberFormatException e) {
+                seconds = batchSize = -1;
+            }
+            String unit = statementMatcher.group(5);
+            // Any value this large is out of range whatever the unit; checking first keeps it from overflowing
+            if (seconds > Integer.MAX_VALUE) {
+                seconds = -1;
+            }
+            if (unit != null && seconds > 0) {
+                unit = unit.toUpperCase();
+                if (unit.equals("MINUTES")) {
+                    seconds *= 60;
+                }
+                else if (unit.equals("HOURS")) {
+                    seconds *= 60 * 60;
+                }
+                else if (unit.equals("DAYS")) {
+                    seconds *= 24 * 60 * 60;
+                }
+            }
+            if (seconds <= 0 || seconds > Integer.MAX_VALUE) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "Invalid TTL statement: the time to live must be between 1 and %d seconds.", Integer.MAX_VALUE));
+            }
+            if (batchSize <= 0 || batchSize > Integer.MAX_VALUE) {
+                throw m_compiler.new VoltCompilerException(
+                        "Invalid TTL statement: BATCH_SIZE must be a positive number of rows.");
+            }
+            tableXML.attributes.put("ttlColumn", columnName);
+            tableXML.attributes.put("ttlSeconds", Long.toString(seconds));
+            tableXML.attributes.put("ttlBatchSize", Long.toString(batchSize));
+            return true;
+        }
+
+        // matches if it is APPEND ONLY TABLE <table-name> [DISABLE]
+        statementMatcher = SQLParser.matchAppendOnlyTable(statement);
+        if (statementMatcher.matches()) {
+            String tableName = checkIdentifierStart(statementMatcher.group(1), statement);
+            VoltXMLElement tableXML = m_schema.findChild("table", tableName.toUpperCase());
+            if (tableXML == null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "While configuring APPEND ONLY, table %s was not present in the catalog.", tableName));
+            }
+            if (statementMatcher.group(2) != null) {
+                tableXML.attributes.remove("appendOnly");
+            }
+            else {
+                tableXML.attributes.put("appendOnly", "true");
+            }
+            return true;
+        }
+
+        // matches if it is CLUSTER TABLE <table-name> [DISABLE]
+        statementMatcher = SQLParser.matchClusterTable(statement);
+        if (statementMatcher.matches()) {
+            String tableName = checkIdentifierStart(statementMatcher.group(1), statement);
+            VoltXMLElement tableXML = m_schema.findChild("table", tableName.toUpperCase());
+            if (tableXML == null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "While configuring CLUSTER, table %s was not present in the catalog.", tableName));
+            }
+            if (statementMatcher.group(2) != null) {
+                tableXML.attributes.remove("clustered");
+            }
+            else {
+                tableXML.attributes.put("clustered", "true");
+            }
+            return true;
+        }
+
         statementMatcher = SQLParser.matchSetGlobalParam(statement);
         if (statementMatcher.matches()) {
             String name = statementMatcher.group(1).toUpperCase();
@@ -1035,6 +1146,28 @@ public class DDLCompiler {
                     statement.substring(0,statement.length()-1))); // remove trailing semicolon
         }
 
+        if (TTL.equals(commandPrefix)) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid TTL TABLE statement: \"%s\", " +
+                    "expected syntax: TTL TABLE <table> ON COLUMN <column> <value> " +
+                    "[SECONDS|MINUTES|HOURS|DAYS] [BATCH_SIZE <rows>] or TTL TABLE <table> DISABLE",
+                    statement.substring(0,statement.length()-1))); // remove trailing semicolon
+        }
+
+        if (APPEND.equals(commandPrefix)) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid APPEND ONLY TABLE statement: \"%s\", " +
+                    "expected syntax: APPEND ONLY TABLE <table> [DISABLE]",
+                    statement.substring(0,statement.length()-1))); // remove trailing semicolon
+        }
+
+        if (CLUSTER.equals(commandPrefix)) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid CLUSTER TABLE statement: \"%s\", " +
+                    "expected syntax: CLUSTER TABLE <table> [DISABLE]",
+                    statement.substring(0,statement.length()-1))); // remove trailing semicolon
+        }
+
         // Not a VoltDB-specific DDL statement.
         return false;
     }
@@ -1751,6 +1884,23 @@ public class DDLCompiler {
             }
         }
 
+        if (node.attributes.get("appendOnly") != null) {
+            if (node.attributes.get("query") != null || node.attributes.get("export") != null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "Invalid APPEND ONLY statement: %s is a view or a stream, and only tables can be append only.",
+                        table.getTypeName()));
+            }
+            table.setIsappendonly(true);
+        }
+
+        if (node.attributes.get("clustered") != null) {
+            addClusteringToCatalog(table, node);
+        }
+
+        if (node.attributes.get("ttlColumn") != null) {
+            addTimeToLiveToCatalog(table, node, columnMap);
+        }
+
         // Warn user if DR table don't have any unique index.
         if (db.getIsactiveactivedred() &&
                 node.attributes.get("drTable") != null &&
@@ -1821,6 +1971,87 @@ public class DDLCompiler {
         }
     }
 
+    /**
+     * Cluster the table from its CLUSTER TABLE statement. The EE keeps the
+     * rows in order by walking the primary key, so the table needs one that
+     * is ordered, and it can't also keep them in insertion order.
+     */
+    private void addClusteringToCatalog(Table table, VoltXMLElement node) throws VoltCompilerException
+    {
+        String tableName = table.getTypeName();
+        if (node.attributes.get("query") != null || node.attributes.get("export") != null) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid CLUSTER statement: %s is a view or a stream, and only tables can be clustered.",
+                    tableName));
+        }
+        if (table.getIsappendonly()) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid CLUSTER statement: table %s is APPEND ONLY, so its rows are kept in insertion order.",
+                    tableName));
+        }
+        Index primaryKey = null;
+        for (Constraint constraint : table.getConstraints()) {
+            if (constraint.getType() == ConstraintType.PRIMARY_KEY.getValue()) {
+                primaryKey = constraint.getIndex();
+            }
+        }
+        if (primaryKey == null || primaryKey.getType() != IndexType.BALANCED_TREE.getValue()) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid CLUSTER statement: table %s needs an ordered primary key to be clustered by.",
+                    tableName));
+        }
+        table.setIsclustered(true);
+    }
+
+    /**
+     * Set the table's TTL from its TTL TABLE statement. The EE expires rows
+     * between transactions on each partition's own clock, so views, streams
+     * and DR tables can't have one, and it finds the oldest rows through an
+     * ordered index led by the TTL column, or, in an append-only table, in
+     * the order they were inserted.
+     */
+    private void addTimeToLiveToCatalog(Table table, VoltXMLElement node, Map<String, Column> columnMap)
+            throws VoltCompilerException
+    {
+        String tableName = table.getTypeName();
+        String columnName = node.attributes.get("ttlColumn");
+        if (node.attributes.get("query") != null || node.attributes.get("export") != null) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid TTL statement: %s is a view or a stream, and only tables can have a TTL.", tableName));
+        }
+        Column column = columnMap.get(columnName);
+        if (column == null) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid TTL statement: column %s was not found in table %s.", columnName, tableName));
+        }
+        if (column.getType() != VoltType.TIMESTAMP.getValue()) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid TTL statement: column %s of table %s is not a TIMESTAMP column.", columnName, tableName));
+        }
+        boolean hasIndex = false;
+        for (Index index : table.getIndexes()) {
+            if (index.getType() != IndexType.BALANCED_TREE.getValue() ||
+                    ! index.getExpressionsjson().isEmpty() ||
+                    ! index.getPredicatejson().isEmpty()) {
+                continue;
+            }
+            for (ColumnRef ref : index.getColumns()) {
+                if (ref.getIndex() == 0 && ref.getColumn() == column) {
+                    hasIndex = true;
+                }
+            }
+        }
+        if ( ! hasIndex && ! table.getIsappendonly()) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid TTL statement: table %s needs an index whose first key is column %s, " +
+                    "or to be APPEND ONLY.",
+                    tableName, columnName));
+        }
+        table.setTtlcolumn(column);
+        table.setTtlseconds(Integer.parseInt(node.attributes.get("ttlSeconds")));
+        table.setTtlbatchsize(Integer.parseInt(node.attributes.get("ttlBatchSize")));
+    }
+
     private static void addColumnToCatalog(Table table,
                             VoltXMLElement node,
                             SortedMap<Integer, VoltType> columnTypes,
@@ -1592,6 +1592,10 @@ public class VoltCompiler {
         if (action.equalsIgnoreCase("DISABLE")) {
             tableref.setIsdred(false);
         } else {
+            if (tableref.getTtlcolumn() != null) {
+                throw new VoltCompilerException("While configuring dr, table " + tableName + " has a TTL." +
+                                                " Rows expired by a TTL are not sent to DR.");
+            }
             tableref.setIsdred(true);
         }
     }
@@ -46,6 +46,13 @@ public class StreamBlockQueue {
 
     private static final VoltLogger exportLog = new VoltLogger("EXPORT");
 
+    /**
+     * Number of stream blocks a stream keeps in memory before further blocks
+     * overflow to the persistent deque. Raising it lets a stream ride out a
+     * briefly slow target without writing to disk.
+     */
+    static final int MAX_MEMORY_BLOCKS = Math.max(1, Integer.getInteger("EXPORT_MAX_MEMORY_BLOCKS", 2));
+
     /**
      * Deque containing reference to stream blocks that are in memory. Some of these
      * stream blocks may still be persisted to disk others are stored completely in memory
@@ -192,21 +199,17 @@ public class StreamBlockQueue {
     }
 
     /*
-     * Only allow two blocks in memory, put the rest in the persistent deque
+     * Only allow MAX_MEMORY_BLOCKS blocks in memory, put the rest in the persistent deque
      */
     public void offer(StreamBlock streamBlock) throws IOException {
-        //Already have two blocks, put it in the deque
-        if (m_memoryDeque.size() > 1) {
+        //Already at the in memory limit, or there is something waiting to be
+        //polled out of the persistent deque, put it in the deque to preserve order.
+        //Checking for emptiness avoids reading a block back from disk on the offer path.
+        if (m_memoryDeque.size() >= MAX_MEMORY_BLOCKS || !m_reader.isEmpty()) {
             m_persistentDeque.offer(streamBlock.asBBContainer());
         } else {
-            //Don't offer into the memory deque if there is anything waiting to be
-            //polled out of the persistent deque. Check the persistent deque
-            if (pollPersistentDeque(false) != null) {
-               m_persistentDeque.offer( streamBlock.asBBContainer());
-            } else {
             //Persistent deque is empty put this in memory
-               m_memoryDeque.offer(streamBlock);
-            }
+            m_memoryDeque.offer(streamBlock);
         }
     }
 
@@ -23,6 +23,7 @@ import java.io.IOException;
 import java.net.URI;
 import java.nio.ByteBuffer;
 import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.List;
 import java.util.concurrent.atomic.AtomicBoolean;
 import java.util.concurrent.atomic.AtomicLong;
@@ -442,6 +443,8 @@ public class KafkaTopicPartitionImporter extends AbstractImporter
                     continue;
                 }
                 sleepCounter = 1;
+                List<Object[]> batchRows = new ArrayList<>();
+                List<ProcedureCallback> batchCallbacks = new ArrayList<>();
                 for (MessageAndOffset messageAndOffset : fetchResponse.messageSet(m_topicAndPartition.topic(), m_topicAndPartition.partition())) {
                     //You may be catchin up so dont sleep.
                     currentFetchCount++;
@@ -465,12 +468,10 @@ public class KafkaTopicPartitionImporter extends AbstractImporter
                         TopicPartitionInvocationCallback cb = new TopicPartitionInvocationCallback(
                                 messageAndOffset.nextOffset(), cbcnt, m_gapTracker, m_dead,
                                 invocation);
-                         if (!noTransaction && !callProcedure(invocation, cb)) {
-                              if (isDebugEnabled()) {
-                                 debug(null, "Failed to process Invocation possibly bad data: " + line);
-                              }
-                              m_gapTracker.commit(messageAndOffset.nextOffset());
-                         }
+                        if (!noTransaction) {
+                            batchRows.add(invocation.getParams());
+                            batchCallbacks.add(cb);
+                        }
                      } catch (FormatException e) {
                         rateLimitedLog(Level.WARN, e, "Failed to tranform data: %s" ,line);
                         m_gapTracker.commit(messageAndOffset.nextOffset());
@@ -481,6 +482,15 @@ public class KafkaTopicPartitionImporter extends AbstractImporter
                         break;
                     }
                 }
+                // The fetch's messages are sent together so the ones for the same
+                // partition can be loaded in one transaction. The callbacks of the
+                // ones that could not be sent commit them.
+                if (!batchRows.isEmpty()) {
+                    int queued = callProcedures(m_config.getProcedure(), batchRows, batchCallbacks);
+                    if (queued < batchRows.size() && isDebugEnabled()) {
+                        debug(null, "Failed to process %d invocations, possibly bad data", batchRows.size() - queued);
+                    }
+                }
                 if (!shouldRun()) {
                     break;
                 }
@@ -20,7 +20,9 @@ package org.voltdb.importclient.kinesis;
 import java.math.BigInteger;
 import java.net.URI;
 import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.List;
 import java.util.UUID;
 import java.util.concurrent.atomic.AtomicLong;
 
@@ -168,6 +170,8 @@ public class KinesisStreamImporter extends AbstractImporter {
             BigInteger seq = BigInteger.ZERO;
             m_gapTracker.resetTo();
             int offset = 0;
+            List<Object[]> batchRows = new ArrayList<>();
+            List<ProcedureCallback> batchCallbacks = new ArrayList<>();
             for (Record record : records.getRecords()) {
                 m_submitCount.incrementAndGet();
                 BigInteger seqNum = new BigInteger(record.getSequenceNumber());
@@ -191,10 +195,8 @@ public class KinesisStreamImporter extends AbstractImporter {
                     Invocation invocation = new Invocation(m_config.getProcedure(), m_formatter.transform(data));
 
                     StreamProcedureCallback cb = new StreamProcedureCallback(m_gapTracker, offset, seqNum, m_cbcnt);
-                    if (!callProcedure(invocation, cb)) {
-                        rateLimitedLog(Level.ERROR, null, "Call procedure error on shard %s", m_shardId);
-                        m_gapTracker.commit(offset, seqNum);
-                    }
+                    batchRows.add(invocation.getParams());
+                    batchCallbacks.add(cb);
                 } catch (FormatException e) {
                     rateLimitedLog(Level.ERROR, e, "Data error on shard %s, data: %s", m_shardId, data);
                     m_gapTracker.commit(offset, seqNum);
@@ -205,6 +207,14 @@ public class KinesisStreamImporter extends AbstractImporter {
                 offset++;
             }
 
+            // The records are sent together so the ones for the same partition can be
+            // loaded in one transaction. The callbacks of the ones that could not be
+            // sent commit them.
+            if (!batchRows.isEmpty()
+                    && callProcedures(m_config.getProcedure(), batchRows, batchCallbacks) < batchRows.size()) {
+                rateLimitedLog(Level.ERROR, null, "Call procedure error on shard %s", m_shardId);
+            }
+
             commitCheckPoint(records.getCheckpointer());
         }
 
@@ -18,6 +18,7 @@
 package org.voltdb.importer;
 
 import java.net.URI;
+import java.util.List;
 import java.util.concurrent.atomic.AtomicInteger;
 
 import org.voltcore.logging.Level;
@@ -113,6 +114,34 @@ public abstract class AbstractImporter
         }
     }
 
+    /**
+     * This should be used by importer implementations to execute the same stored procedure
+     * for many rows at once, such as all the messages of one fetch. Rows bound for the same
+     * partition may be executed together in one transaction, which costs the server far less
+     * than a transaction per row. Each row's callback is called exactly once, with a failure
+     * response if the row could not be queued, so importers can track what was processed
+     * row by row as they do with {@link #callProcedure(Invocation, ProcedureCallback)}.
+     *
+     * @param procName the name of the procedure to execute
+     * @param rows the parameters for each execution
+     * @param callbacks the callback for each row, which may be null
+     * @return returns the number of rows that were queued successfully
+     */
+    protected final int callProcedures(String procName, List<Object[]> rows, List<ProcedureCallback> callbacks)
+    {
+        int queued = 0;
+        try {
+            queued = m_importServerAdapter.callProcedures(this, callbacks, procName, rows);
+        } catch (Exception ex) {
+            rateLimitedLog(Level.ERROR, ex, "%s: Error trying to import", getName());
+        }
+        for (int i = 0; i < rows.size(); i++) {
+            reportStat(i < queued, procName);
+        }
+        applyBackPressureAsNeeded();
+        return queued;
+    }
+
     private void applyBackPressureAsNeeded()
     {
         int count = m_backPressureCount.get();
@@ -17,6 +17,8 @@
 
 package org.voltdb.importer;
 
+import java.util.List;
+
 import org.voltdb.client.ProcedureCallback;
 
 
@@ -52,6 +54,21 @@ public interface ImporterServerAdapter {
      */
     public boolean callProcedure(AbstractImporter importer, ProcedureCallback callback, String proc, Object... fieldList);
 
+    /**
+     * This is used by importers to execute a procedure once for each of many rows of parameters.
+     * The server may execute the rows bound for the same partition together, in one transaction.
+     * Each row's callback is called with the response for that row, or with a failure response
+     * if the row could not be queued.
+     *
+     * @param importer the calling importer instance. This may be used by the importer framework
+     * to report back pressure.
+     * @param callbacks the callback for each row, which may be null
+     * @param proc the name of the procedure that is to be executed
+     * @param rows the parameters to be passed in to the procedure, one array for each execution
+     * @return returns the number of rows that were queued successfully.
+     */
+    public int callProcedures(AbstractImporter importer, List<ProcedureCallback> callbacks, String proc, List<Object[]> rows);
+
     /**
      * This should be used by importers to report failure while trying to execute a procedure.
      *
@@ -31,6 +31,7 @@ import org.voltdb.LoadedProcedureSet;
 import org.voltdb.MemoryStats;
 import org.voltdb.PartitionDRGateway;
 import org.voltdb.ProcedureRunnerFactory;
+import org.voltdb.QueueStats;
 import org.voltdb.StartAction;
 import org.voltdb.StarvationTracker;
 import org.voltdb.StatsAgent;
@@ -62,6 +63,7 @@ public abstract class BaseInitiator implements Initiator
     protected Site m_executionSite = null;
     protected Thread m_siteThread = null;
     protected final RepairLog m_repairLog = new RepairLog();
+    protected final QueueStats m_queueStats;
 
     public BaseInitiator(String zkMailboxNode, HostMessenger messenger, Integer partition,
             Scheduler scheduler, String whoamiPrefix, StatsAgent agent,
@@ -110,6 +112,15 @@ public abstract class BaseInitiator implements Initiator
         agent.registerStatsSource(StatsSelector.STARVATION,
                                   getInitiatorHSId(),
                                   st);
+        m_queueStats = new QueueStats(getInitiatorHSId());
+        m_queueStats.addProbe(m_scheduler.getQueue().getProbe());
+        if (!(m_initiatorMailbox instanceof MpInitiatorMailbox)) {
+            m_queueStats.addProbe(m_initiatorMailbox.getLockProbe());
+        }
+        agent.registerStatsSource(StatsSelector.QUEUE,
+                                  getInitiatorHSId(),
+                                  m_queueStats);
+        m_queueStats.start();
 
         String partitionString = " ";
         if (m_partitionId != -1) {
@@ -172,8 +183,7 @@ public abstract class BaseInitiator implements Initiator
                     prf,
                     m_initiatorMailbox.getHSId(),
                     0); // this has no meaning
-            procSet.loadProcedures(catalogContext, backend, csp);
-            m_executionSite.setLoadedProcedures(procSet);
+            m_executionSite.setLoadedProceduresAtStartup(procSet, csp);
             m_scheduler.setCommandLog(cl);
 
             m_siteThread = new Thread(m_executionSite);
@@ -188,6 +198,7 @@ public abstract class BaseInitiator implements Initiator
         if (m_executionSite != null) {
             m_executionSite.startShutdown();
         }
+        m_queueStats.shutdown();
         try {
             if (m_term != null) {
                 m_term.shutdown();
@@ -29,6 +29,7 @@ import org.voltcore.messaging.Mailbox;
 import org.voltcore.messaging.Subject;
 import org.voltcore.messaging.VoltMessage;
 import org.voltcore.utils.CoreUtils;
+import org.voltdb.QueueStats;
 import org.voltdb.VoltDB;
 import org.voltdb.VoltZK;
 import org.voltdb.messaging.CompleteTransactionMessage;
@@ -70,6 +71,8 @@ public class InitiatorMailbox implements Mailbox
     private final LeaderCacheReader m_masterLeaderCache;
     private long m_hsId;
     private RepairAlgo m_algo;
+    // Time to acquire the mailbox lock when handing a message to the scheduler
+    private final QueueStats.Probe m_lockProbe = new QueueStats.Probe("INITIATOR_MAILBOX_LOCK");
 
     /*
      * Hacky global map of initiator mailboxes to support assertions
@@ -267,18 +270,26 @@ public class InitiatorMailbox implements Mailbox
             this.m_scheduler.getQueue().offer(new SiteTasker.SiteTaskerRunnable() {
                 @Override
                 void run() {
+                    final long start = m_lockProbe.startWaitSample();
                     synchronized (InitiatorMailbox.this) {
+                        m_lockProbe.endWaitSample(start);
                         deliverInternal(message);
                     }
                 }
             });
         } else {
+            final long start = m_lockProbe.startWaitSample();
             synchronized (this) {
+                m_lockProbe.endWaitSample(start);
                 deliverInternal(message);
             }
         }
     }
 
+    public QueueStats.Probe getLockProbe() {
+        return m_lockProbe;
+    }
+
     protected void deliverInternal(VoltMessage message) {
         assert(lockingVows());
         logRxMessage(message);
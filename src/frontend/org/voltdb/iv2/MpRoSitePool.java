@@ -43,6 +43,8 @@ class MpRoSitePool {
 
     static int DEFAULT_MAX_POOL_SIZE = 20;
     static int INITIAL_POOL_SIZE = 1;
+    // How long a site beyond the initial pool may sit idle before it is retired
+    static long DEFAULT_IDLE_TIMEOUT_MS = 60 * 1000;
 
     class MpRoSiteContext {
         final private BackendTarget m_backend;
@@ -52,6 +54,8 @@ class MpRoSitePool {
         final private ProcedureRunnerFactory m_prf;
         final private LoadedProcedureSet m_loadedProcedures;
         final private Thread m_siteThread;
+        // When the site last went back on the idle stack
+        private long m_idleSince = System.currentTimeMillis();
 
         MpRoSiteContext(long siteId, BackendTarget backend,
                 CatalogContext context, int partitionId,
@@ -86,6 +90,14 @@ class MpRoSitePool {
             return m_catalogContext.catalogVersion;
         }
 
+        void markIdle(long now) {
+            m_idleSince = now;
+        }
+
+        long getIdleSince() {
+            return m_idleSince;
+        }
+
         void shutdown() {
             m_site.startShutdown();
             // Need to unblock the site's run() loop on the take() call on the queue
@@ -114,6 +126,7 @@ class MpRoSitePool {
     private CatalogSpecificPlanner m_csp;
     private ThreadFactory m_poolThreadFactory;
     private final int m_poolSize;
+    private final long m_idleTimeoutMs;
 
     MpRoSitePool(
             long siteId,
@@ -139,6 +152,7 @@ class MpRoSitePool {
         }
         m_poolSize = poolSize;
         tmLog.info("Setting maximum size of MPI read pool to: " + m_poolSize);
+        m_idleTimeoutMs = Long.getLong("mpiReadPoolIdleTimeoutMs", DEFAULT_IDLE_TIMEOUT_MS);
 
         // Construct the initial pool
         for (int i = 0; i < INITIAL_POOL_SIZE; i++) {
@@ -255,13 +269,34 @@ class MpRoSitePool {
         // pool with the updated catalog.
         if (site.getCatalogCRC() == m_catalogContext.getCatalogCRC()
                 && site.getCatalogVersion() == m_catalogContext.catalogVersion) {
+            long now = System.currentTimeMillis();
+            site.markIdle(now);
             m_idleSites.push(site);
+            retireIdleSites(now);
         }
         else {
             site.shutdown();
         }
     }
 
+    /**
+     * Shrink the pool after a burst of MP reads. Sites are taken from the top
+     * of the idle stack, so the one at the bottom has been idle the longest.
+     * Retire sites from the bottom while they have been idle past the timeout,
+     * keeping at least the initial pool size of sites alive.
+     */
+    private void retireIdleSites(long now)
+    {
+        while (m_idleSites.size() + m_busySites.size() > INITIAL_POOL_SIZE) {
+            MpRoSiteContext site = m_idleSites.peekLast();
+            if (site == null || now - site.getIdleSince() < m_idleTimeoutMs) {
+                break;
+            }
+            m_idleSites.pollLast();
+            site.shutdown();
+        }
+    }
+
     void shutdown()
     {
         // Shutdown all, then join all, hopefully save some shutdown time for tests.
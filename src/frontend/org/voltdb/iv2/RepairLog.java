@@ -29,6 +29,7 @@ import java.util.List;
 import org.voltcore.logging.VoltLogger;
 import org.voltcore.messaging.VoltMessage;
 import org.voltcore.utils.CoreUtils;
+import org.voltdb.StoredProcedureInvocation;
 import org.voltdb.TheHashinator;
 import org.voltdb.messaging.CompleteTransactionMessage;
 import org.voltdb.messaging.DumpMessage;
@@ -161,7 +162,7 @@ public class RepairLog
 
             m_lastSpHandle = m.getSpHandle();
             truncate(m.getTruncationHandle(), IS_SP);
-            m_logSP.add(new Item(IS_SP, m, m.getSpHandle(), m.getTxnId()));
+            m_logSP.add(new Item(IS_SP, messageToLog(m), m.getSpHandle(), m.getTxnId()));
         } else if (msg instanceof FragmentTaskMessage) {
             final FragmentTaskMessage m = (FragmentTaskMessage) msg;
 
@@ -210,6 +211,18 @@ public class RepairLog
         }
     }
 
+    // Log a copy of an initiation that does not keep its parameters alive
+    // after they are deserialized for execution. Invocations made locally
+    // have no serialized parameters to fall back on and are logged as is.
+    private static VoltMessage messageToLog(Iv2InitiateTaskMessage m)
+    {
+        StoredProcedureInvocation invocation = m.getStoredProcedureInvocation();
+        if (invocation == null || invocation.getSerializedParams() == null) {
+            return m;
+        }
+        return m.getRepairLogCopy();
+    }
+
     // trim unnecessary log messages.
     private void truncate(long handle, boolean isSP)
     {
@@ -48,16 +48,21 @@ import org.voltdb.DependencyPair;
 import org.voltdb.ExtensibleSnapshotDigestData;
 import org.voltdb.HsqlBackend;
 import org.voltdb.IndexStats;
+import org.voltdb.JNICallStats;
 import org.voltdb.LoadedProcedureSet;
 import org.voltdb.MemoryStats;
+import org.voltdb.NativeStackStats;
 import org.voltdb.NonVoltDBBackend;
 import org.voltdb.ParameterSet;
 import org.voltdb.PartitionDRGateway;
 import org.voltdb.PostGISBackend;
 import org.voltdb.PostgreSQLBackend;
 import org.voltdb.ProcedureRunner;
+import org.voltdb.SiteMemoryStats;
 import org.voltdb.SiteProcedureConnection;
 import org.voltdb.SiteSnapshotConnection;
+import org.voltdb.SiteTimeTracker;
+import org.voltdb.SiteTimeTracker.Activity;
 import org.voltdb.SnapshotDataTarget;
 import org.voltdb.SnapshotFormat;
 import org.voltdb.SnapshotSiteProcessor;
@@ -160,6 +165,10 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     // Stats
     final TableStats m_tableStats;
     final IndexStats m_indexStats;
+    final SiteMemoryStats m_memoryDetailStats;
+    final SiteTimeTracker m_timeTracker;
+    final JNICallStats m_jniCallStats;
+    final NativeStackStats m_nativeStackStats;
     final MemoryStats m_memStats;
 
     // Each execution site manages snapshot using a SnapshotSiteProcessor
@@ -171,6 +180,10 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     // Currently available procedure
     volatile LoadedProcedureSet m_loadedProcedures;
 
+    // The planner to load the procedures with when the site thread starts,
+    // or null once they are loaded
+    private CatalogSpecificPlanner m_startupPlanner;
+
     // Cache the DR gateway here so that we can pass it to tasks as they are reconstructed from
     // the task log
     private final PartitionDRGateway m_drGateway;
@@ -425,7 +438,12 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         public Pair<Long, int[]> tableStreamSerializeMore(int tableId, TableStreamType type,
                                                           List<DBBPool.BBContainer> outputBuffers)
         {
-            return m_ee.tableStreamSerializeMore(tableId, type, outputBuffers);
+            m_timeTracker.beginActivity(Activity.SNAPSHOT);
+            try {
+                return m_ee.tableStreamSerializeMore(tableId, type, outputBuffers);
+            } finally {
+                m_timeTracker.endActivity();
+            }
         }
 
         @Override
@@ -605,6 +623,7 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         m_drGateway = drGateway;
         m_mpDrGateway = mpDrGateway;
         m_hashinator = TheHashinator.getCurrentHashinator();
+        m_timeTracker = new SiteTimeTracker(m_siteId);
 
         if (agent != null) {
             m_tableStats = new TableStats(m_siteId);
@@ -615,11 +634,29 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             agent.registerStatsSource(StatsSelector.INDEX,
                                       m_siteId,
                                       m_indexStats);
+            agent.registerStatsSource(StatsSelector.SITETIME,
+                                      m_siteId,
+                                      m_timeTracker);
+            m_memoryDetailStats = new SiteMemoryStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.MEMORYDETAIL,
+                                      m_siteId,
+                                      m_memoryDetailStats);
+            m_jniCallStats = new JNICallStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.JNICALLS,
+                                      m_siteId,
+                                      m_jniCallStats);
+            m_nativeStackStats = new NativeStackStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.NATIVESTACKS,
+                                      m_siteId,
+                                      m_nativeStackStats);
             m_memStats = memStats;
         } else {
             // MPI doesn't need to track these stats
             m_tableStats = null;
             m_indexStats = null;
+            m_memoryDetailStats = null;
+            m_jniCallStats = null;
+            m_nativeStackStats = null;
             m_memStats = null;
         }
     }
@@ -630,6 +667,18 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         m_loadedProcedures = loadedProcedure;
     }
 
+    /**
+     * Set the procedures to load when the site thread starts, after its EE
+     * is initialized. Every site loads its own procedures, so starting many
+     * sites loads them on as many threads instead of one after another on
+     * the thread configuring the initiators.
+     */
+    void setLoadedProceduresAtStartup(LoadedProcedureSet loadedProcedure, CatalogSpecificPlanner csp)
+    {
+        m_loadedProcedures = loadedProcedure;
+        m_startupPlanner = csp;
+    }
+
     /** Thread specific initialization */
     void initialize()
     {
@@ -653,6 +702,8 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             m_non_voltdb_backend = null;
             m_ee = initializeEE();
         }
+        m_ee.setTimeTracker(m_timeTracker);
+        m_ee.setCallStats(m_jniCallStats);
 
         m_snapshotter = new SnapshotSiteProcessor(m_scheduler,
         m_snapshotPriority,
@@ -752,15 +803,38 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         //Maintain a minimum ratio of task log (unrestricted) to live (restricted) transactions
         final MinimumRatioMaintainer mrm = new MinimumRatioMaintainer(m_taskLogReplayRatio);
         try {
+            if (m_startupPlanner != null) {
+                // Catalog updates load the procedures on the site thread too.
+                // A failure here takes the node down like any other site error.
+                m_loadedProcedures.loadProcedures(m_context, m_backend, m_startupPlanner);
+                m_startupPlanner = null;
+            }
             while (m_shouldContinue) {
                 if (m_rejoinState == kStateRunning) {
-                    // Normal operation blocks the site thread on the sitetasker queue.
-                    SiteTasker task = m_scheduler.take();
-                    if (task instanceof TransactionTask) {
-                        m_currentTxnId = ((TransactionTask)task).getTxnId();
-                        m_lastTxnTime = EstTime.currentTimeMillis();
+                    // Normal operation blocks the site thread on the sitetasker queue,
+                    // then runs every task that is ready before blocking again.
+                    m_timeTracker.beginActivity(Activity.IDLE);
+                    SiteTasker task;
+                    try {
+                        task = m_scheduler.take();
+                    } finally {
+                        m_timeTracker.endActivity();
                     }
-                    task.run(getSiteProcedureConnection());
+                    do {
+                        if (task instanceof TransactionTask) {
+                            m_currentTxnId = ((TransactionTask)task).getTxnId();
+                            m_lastTxnTime = EstTime.currentTimeMillis();
+                            m_timeTracker.beginActivity(Activity.PROCEDURE);
+                        } else {
+                            m_timeTracker.beginActivity(Activity.OTHER);
+                        }
+                        try {
+                            task.run(getSiteProcedureConnection());
+                        } finally {
+                            m_timeTracker.endActivity();
+                        }
+                    } while (m_shouldContinue && m_rejoinState == kStateRunning &&
+                             (task = m_scheduler.poll()) != null);
                 } else if (m_rejoinState == kStateReplayingRejoin) {
                     // Rejoin operation poll and try to do some catchup work. Tasks
                     // are responsible for logging any rejoin work they might have.
@@ -1094,15 +1168,20 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         m_latestUndoTxnId = Long.MIN_VALUE;
         //If the begin undo token is not set the txn never did any work so there is nothing to undo/release
         if (beginUndoToken == Site.kInvalidUndoToken) return;
-        if (rollback) {
-            m_ee.undoUndoToken(beginUndoToken);
-        }
-        else {
-            assert(m_latestUndoToken != Site.kInvalidUndoToken);
-            assert(m_latestUndoToken >= beginUndoToken);
-            if (m_latestUndoToken > beginUndoToken) {
-                m_ee.releaseUndoToken(m_latestUndoToken);
+        m_timeTracker.beginActivity(Activity.EE_UNDO_RELEASE);
+        try {
+            if (rollback) {
+                m_ee.undoUndoToken(beginUndoToken);
+            }
+            else {
+                assert(m_latestUndoToken != Site.kInvalidUndoToken);
+                assert(m_latestUndoToken >= beginUndoToken);
+                if (m_latestUndoToken > beginUndoToken) {
+                    m_ee.releaseUndoToken(m_latestUndoToken);
+                }
             }
+        } finally {
+            m_timeTracker.endActivity();
         }
 
         // java level roll back
@@ -1180,8 +1259,18 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     {
         long time = System.currentTimeMillis();
 
-        m_ee.tick(time, m_lastCommittedSpHandle);
-        statsTick(time);
+        m_timeTracker.beginActivity(Activity.TICK);
+        try {
+            m_ee.tick(time, m_lastCommittedSpHandle);
+        } finally {
+            m_timeTracker.endActivity();
+        }
+        m_timeTracker.beginActivity(Activity.STATS);
+        try {
+            statsTick(time);
+        } finally {
+            m_timeTracker.endActivity();
+        }
     }
 
     /**
@@ -1270,15 +1359,29 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                                             tupleAllocatedMem,
                                             indexMem,
                                             stringMem,
-                                            m_ee.getThreadLocalPoolAllocations());
+                                            m_ee.getThreadLocalPoolAllocations(),
+                                            m_ee.getHugePageAllocations(),
+                                            m_ee.getLocalNodeAllocations());
             }
+            m_memoryDetailStats.update(tupleDataMem,
+                                       tupleAllocatedMem,
+                                       stringMem,
+                                       indexMem,
+                                       m_ee.getMemoryDetail());
+            m_jniCallStats.updateUpcalls(m_ee.getUpcallStats());
+            m_nativeStackStats.update(m_ee.getNativeStacks());
         }
     }
 
     @Override
     public void quiesce()
     {
-        m_ee.quiesce(m_lastCommittedSpHandle);
+        m_timeTracker.beginActivity(Activity.TICK);
+        try {
+            m_ee.quiesce(m_lastCommittedSpHandle);
+        } finally {
+            m_timeTracker.endActivity();
+        }
     }
 
     @Override
@@ -1295,13 +1398,23 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     public VoltTable[] getStats(StatsSelector selector, int[] locators,
                                 boolean interval, Long now)
     {
-        return m_ee.getStats(selector, locators, interval, now);
+        m_timeTracker.beginActivity(Activity.STATS);
+        try {
+            return m_ee.getStats(selector, locators, interval, now);
+        } finally {
+            m_timeTracker.endActivity();
+        }
     }
 
     @Override
     public Future<?> doSnapshotWork()
     {
-        return m_snapshotter.doSnapshotWork(m_sysprocContext, false);
+        m_timeTracker.beginActivity(Activity.SNAPSHOT);
+        try {
+            return m_snapshotter.doSnapshotWork(m_sysprocContext, false);
+        } finally {
+            m_timeTracker.endActivity();
+        }
     }
 
     @Override
@@ -1399,17 +1512,22 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                                             boolean readOnly)
             throws EEException
     {
-        return m_ee.executePlanFragments(
-                numFragmentIds,
-                planFragmentIds,
-                inputDepIds,
-                parameterSets,
-                sqlTexts,
-                txnId,
-                spHandle,
-                m_lastCommittedSpHandle,
-                uniqueId,
-                readOnly ? Long.MAX_VALUE : getNextUndoTokenBroken());
+        m_timeTracker.beginActivity(Activity.JNI);
+        try {
+            return m_ee.executePlanFragments(
+                    numFragmentIds,
+                    planFragmentIds,
+                    inputDepIds,
+                    parameterSets,
+                    sqlTexts,
+                    txnId,
+                    spHandle,
+                    m_lastCommittedSpHandle,
+                    uniqueId,
+                    readOnly ? Long.MAX_VALUE : getNextUndoTokenBroken());
+        } finally {
+            m_timeTracker.endActivity();
+        }
     }
 
     @Override
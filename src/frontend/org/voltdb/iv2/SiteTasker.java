@@ -25,6 +25,9 @@ import org.voltdb.SiteProcedureConnection;
 
 public abstract class SiteTasker {
 
+    // When the queue picked this task to measure its wait, the time it was offered
+    long m_offerNanos = 0;
+
     public static abstract class SiteTaskerRunnable extends SiteTasker {
         abstract void run();
 
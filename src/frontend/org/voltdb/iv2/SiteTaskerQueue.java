@@ -17,20 +17,50 @@
 
 package org.voltdb.iv2;
 
-import java.util.concurrent.LinkedTransferQueue;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.locks.LockSupport;
 
-import org.voltcore.utils.CoreUtils;
+import org.voltdb.QueueStats;
 import org.voltdb.StarvationTracker;
 
-/** SiteTaskerScheduler orders SiteTaskers for execution. */
+/**
+ * SiteTaskerScheduler orders SiteTaskers for execution.
+ *
+ * Any thread may offer tasks, but only the site thread takes them. An idle
+ * site spins on the queue for a while, then yields, and only then parks,
+ * so a burst of tasks rarely pays for a wakeup. Offers only unpark the
+ * site when it is actually parked.
+ */
 public class SiteTaskerQueue
 {
-    private final LinkedTransferQueue<SiteTasker> m_tasks = new LinkedTransferQueue<SiteTasker>();
+    // Polls of an empty queue before yielding, then yields before parking.
+    private static final int SPIN_POLLS = Integer.getInteger("SITE_QUEUE_SPIN_POLLS", 2000);
+    private static final int YIELD_POLLS = Integer.getInteger("SITE_QUEUE_YIELD_POLLS", 20);
+
+    private final ConcurrentLinkedQueue<SiteTasker> m_tasks = new ConcurrentLinkedQueue<SiteTasker>();
+    // ConcurrentLinkedQueue.size() walks the whole queue, so count the tasks.
+    private final AtomicInteger m_depth = new AtomicInteger();
+    // The site thread while it is parked, or about to park, in take().
+    private volatile Thread m_parkedSite = null;
     private StarvationTracker m_starvationTracker;
+    private final QueueStats.Probe m_probe = new QueueStats.Probe("SITE_TASKER_QUEUE") {
+        @Override
+        protected long depth() {
+            return m_depth.get();
+        }
+    };
 
     public boolean offer(SiteTasker task)
     {
-        return m_tasks.offer(task);
+        task.m_offerNanos = m_probe.startWaitSample();
+        m_depth.incrementAndGet();
+        m_tasks.offer(task);
+        Thread site = m_parkedSite;
+        if (site != null) {
+            LockSupport.unpark(site);
+        }
+        return true;
     }
 
     // Block on the site tasker queue.
@@ -40,19 +70,63 @@ public class SiteTaskerQueue
         if (task == null) {
             m_starvationTracker.beginStarvation();
         } else {
-            return task;
+            return taken(task);
         }
         try {
-            return CoreUtils.queueSpinTake(m_tasks);
+            return taken(awaitTask());
         } finally {
             m_starvationTracker.endStarvation();
         }
     }
 
+    private SiteTasker taken(SiteTasker task)
+    {
+        m_depth.decrementAndGet();
+        if (task.m_offerNanos != 0) {
+            m_probe.endWaitSample(task.m_offerNanos);
+            task.m_offerNanos = 0;
+        }
+        return task;
+    }
+
+    private SiteTasker awaitTask() throws InterruptedException
+    {
+        SiteTasker task;
+        for (int ii = 0; ii < SPIN_POLLS; ii++) {
+            if ((task = m_tasks.poll()) != null) {
+                return task;
+            }
+        }
+        for (int ii = 0; ii < YIELD_POLLS; ii++) {
+            Thread.yield();
+            if ((task = m_tasks.poll()) != null) {
+                return task;
+            }
+        }
+        final Thread self = Thread.currentThread();
+        for (;;) {
+            // Poll again once offers can see that the site is parking, so an
+            // offer made just before is not missed.
+            m_parkedSite = self;
+            task = m_tasks.poll();
+            if (task == null) {
+                LockSupport.park(this);
+                task = m_tasks.poll();
+            }
+            m_parkedSite = null;
+            if (task != null) {
+                return task;
+            }
+            if (Thread.interrupted()) {
+                throw new InterruptedException();
+            }
+        }
+    }
     // Non-blocking poll on the site tasker queue.
     public SiteTasker poll()
     {
-        return m_tasks.poll();
+        SiteTasker task = m_tasks.poll();
+        return task == null ? null : taken(task);
     }
 
     // Non-blocking peek on the site tasker queue.
@@ -68,4 +142,8 @@ public class SiteTaskerQueue
     public void setStarvationTracker(StarvationTracker tracker) {
         m_starvationTracker = tracker;
     }
+
+    public QueueStats.Probe getProbe() {
+        return m_probe;
+    }
 }
@@ -30,9 +30,11 @@ import org.voltcore.logging.VoltLogger;
 import org.voltcore.utils.CoreUtils;
 import org.voltcore.utils.DBBPool;
 import org.voltcore.utils.Pair;
+import org.voltdb.JNICallStats;
 import org.voltdb.PlannerStatsCollector;
 import org.voltdb.PlannerStatsCollector.CacheUse;
 import org.voltdb.PrivateVoltTableFactory;
+import org.voltdb.SiteTimeTracker;
 import org.voltdb.StatsAgent;
 import org.voltdb.StatsSelector;
 import org.voltdb.TableStreamType;
@@ -119,6 +121,12 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
     /** Statistics collector (provided later) */
     private PlannerStatsCollector m_plannerStats = null;
 
+    /** Site thread time accounting, set by the owning site (may be null) */
+    protected SiteTimeTracker m_timeTracker = null;
+
+    /** Per-call counts and time of EE calls, set by the owning site (may be null) */
+    protected JNICallStats m_callStats = null;
+
     // used for tracking statistics about the plan cache in the EE
     private int m_cacheMisses = 0;
     private int m_eeCacheSize = 0;
@@ -213,6 +221,25 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
         m_plannerStats = null;
     }
 
+    public void setTimeTracker(SiteTimeTracker tracker) {
+        m_timeTracker = tracker;
+    }
+
+    public void setCallStats(JNICallStats callStats) {
+        m_callStats = callStats;
+    }
+
+    /** @return the start time to pass to endCall(), or 0 if calls aren't being counted */
+    protected final long beginCall() {
+        return m_callStats != null ? System.nanoTime() : 0;
+    }
+
+    protected final void endCall(JNICallStats.Downcall call, long startNanos) {
+        if (m_callStats != null) {
+            m_callStats.recordDowncall(call, System.nanoTime() - startNanos);
+        }
+    }
+
     /*
      * State to manage dependency tables for the current work unit.
      * The EE pulls from this state as necessary across JNI (or IPC)
@@ -650,6 +677,35 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
 
     public abstract long getThreadLocalPoolAllocations();
 
+    /** Bytes of the site's large blocks that are backed by huge pages */
+    public abstract long getHugePageAllocations();
+
+    /** Bytes of the site's large blocks bound to the site thread's NUMA node */
+    public abstract long getLocalNodeAllocations();
+
+    /** Number of counters getMemoryDetail() returns, MEMORY_DETAIL_COUNT in the EE */
+    public static final int MEMORY_DETAIL_COUNT = 9;
+
+    /**
+     * Bytes held by the engine's pools, temp tables, undo log, pending export
+     * and DR buffers and plan cache, in the order of MemoryDetailType in the EE.
+     * The pool counters are the calling thread's, so call it from the site thread.
+     */
+    public abstract long[] getMemoryDetail();
+
+    /**
+     * Cumulative counts, then nanoseconds, of each JNICallStats.Upcall the engine
+     * has made into Java. Engines that don't count upcalls return zeros.
+     */
+    public abstract long[] getUpcallStats();
+
+    /**
+     * The native stacks the engine's sampler has seen since the last call, in
+     * the folded "outer;...;inner count" format, one stack per line. Engines
+     * that aren't sampled return an empty string.
+     */
+    public abstract String getNativeStacks();
+
     public abstract byte[] loadTable(
         int tableId, VoltTable table, long txnId, long spHandle,
         long lastCommittedSpHandle, long uniqueId, boolean returnUniqueViolations, boolean shouldDRStream,
@@ -825,7 +881,15 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             int defaultDrBufferSize,
             long tempTableMemory,
             boolean createDrReplicatedStream,
-            int compactionThreshold);
+            int compactionThreshold,
+            byte coldStorageDirectory[],
+            long maxResidentTupleBlockMemory,
+            byte tempTableSpillDirectory[],
+            int slowFragmentMillis,
+            boolean redactSlowFragmentParameters,
+            int stackSampleHz,
+            int packedStringMaxLength,
+            int loadHelperThreads);
 
     /**
      * Sets (or re-sets) all the shared direct byte buffers in the EE.
@@ -895,6 +959,21 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
             long uniqueId,
             long undoToken);
 
+    /**
+     * Executes the fragment batches of several single-partition transactions.
+     * @param pointer the VoltDBEngine pointer
+     * @param numTransactions number of transactions in the batch
+     * @param transactionInfo TXN_BATCH_INFO_FIELDS values per transaction: its fragment count,
+     *        txnId, spHandle, lastCommittedSpHandle, uniqueId and undoToken
+     * @param planFragmentIds the transactions' fragment ids, back to back
+     * @return the number of transactions that completed
+     */
+    protected native int nativeExecuteTransactionBatch(
+            long pointer,
+            int numTransactions,
+            long[] transactionInfo,
+            long[] planFragmentIds);
+
     /**
      * Serialize the result temporary table.
      * @param pointer the VoltDBEngine pointer
@@ -962,6 +1041,18 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     protected static native long nativeGetThreadLocalPoolAllocations();
 
+    /**
+     * Retrieve the thread local counter of large block memory backed by huge pages
+     * @return
+     */
+    protected static native long nativeGetHugePageAllocations();
+
+    /**
+     * Retrieve the thread local counter of large block memory bound to the local NUMA node
+     * @return
+     */
+    protected static native long nativeGetLocalNodeAllocations();
+
     /**
      * @param nextUndoToken The undo token to associate with future work
      * @return true for success false for failure
@@ -1066,6 +1157,37 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
      */
     public native long[] nativeGetUSOForExportTable(long pointer, byte mTableSignature[]);
 
+    /**
+     * Get the memory held by each subsystem of the engine.
+     *
+     * @param pointer Pointer to an engine instance
+     * @return MEMORY_DETAIL_COUNT byte counts, indexed as MemoryDetailType in the EE
+     */
+    protected native long[] nativeGetMemoryDetail(long pointer);
+
+    /**
+     * Get the count and time of each upcall the engine has made.
+     *
+     * @param pointer Pointer to an engine instance
+     * @return The counts then the nanoseconds, indexed as JNITopend::UpcallType in the EE
+     */
+    protected native long[] nativeGetUpcallStats(long pointer);
+
+    /**
+     * Take the native stacks sampled since the last call.
+     *
+     * @param pointer Pointer to an engine instance
+     * @return The folded stacks as UTF-8
+     */
+    protected native byte[] nativeGetNativeStacks(long pointer);
+
+    /**
+     * Set the rate of the native stack sampler of every engine in this process.
+     *
+     * @param hz Samples per second of CPU each site uses, 0 to pause sampling
+     */
+    public static native void nativeSetStackSampleRate(int hz);
+
     /**
      * This code only does anything useful on MACOSX.
      * On LINUX, procfs is read to get RSS
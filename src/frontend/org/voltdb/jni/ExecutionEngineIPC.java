@@ -31,6 +31,7 @@ import java.util.logging.Logger;
 import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltcore.utils.Pair;
 import org.voltdb.BackendTarget;
+import org.voltdb.JNICallStats;
 import org.voltdb.ParameterSet;
 import org.voltdb.PrivateVoltTableFactory;
 import org.voltdb.StatsSelector;
@@ -125,7 +126,10 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         GetUSOs(25),
         updateHashinator(27),
         executeTask(28),
-        applyBinaryLog(29);
+        applyBinaryLog(29),
+        GetHugePageAllocations(30),
+        GetLocalNodeAllocations(31),
+        GetMemoryDetail(32);
         Commands(final int id) {
             m_id = id;
         }
@@ -1511,8 +1515,62 @@ public class ExecutionEngineIPC extends ExecutionEngine {
 
     @Override
     public long getThreadLocalPoolAllocations() {
+        return getAllocationCounter(Commands.GetPoolAllocations);
+    }
+
+    @Override
+    public long getHugePageAllocations() {
+        return getAllocationCounter(Commands.GetHugePageAllocations);
+    }
+
+    @Override
+    public long getLocalNodeAllocations() {
+        return getAllocationCounter(Commands.GetLocalNodeAllocations);
+    }
+
+    @Override
+    public long[] getMemoryDetail() {
+        m_data.clear();
+        m_data.putInt(Commands.GetMemoryDetail.m_id);
+        try {
+            m_data.flip();
+            m_connection.write();
+
+            m_connection.readStatusByte();
+            ByteBuffer counters = ByteBuffer.allocate(8 * MEMORY_DETAIL_COUNT);
+            while (counters.hasRemaining()) {
+                int read = m_connection.m_socketChannel.read(counters);
+                if (read <= 0) {
+                    throw new EOFException();
+                }
+            }
+            counters.flip();
+            long[] retval = new long[MEMORY_DETAIL_COUNT];
+            for (int i = 0; i < MEMORY_DETAIL_COUNT; i++) {
+                retval[i] = counters.getLong();
+            }
+            return retval;
+        } catch (final Exception e) {
+            System.out.println("Exception: " + e.getMessage());
+            throw new RuntimeException(e);
+        }
+    }
+
+    /** The IPC top end doesn't count its upcalls */
+    @Override
+    public long[] getUpcallStats() {
+        return new long[2 * JNICallStats.Upcall.values().length];
+    }
+
+    /** The IPC backend runs without the native stack sampler */
+    @Override
+    public String getNativeStacks() {
+        return "";
+    }
+
+    private long getAllocationCounter(Commands command) {
         m_data.clear();
-        m_data.putInt(Commands.GetPoolAllocations.m_id);
+        m_data.putInt(command.m_id);
         try {
             m_data.flip();
             m_connection.write();
@@ -19,14 +19,18 @@ package org.voltdb.jni;
 
 import java.io.IOException;
 import java.nio.ByteBuffer;
+import java.util.Arrays;
 import java.util.List;
 
 import org.voltcore.logging.VoltLogger;
 import org.voltcore.utils.DBBPool;
 import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltcore.utils.Pair;
+import org.voltdb.common.Constants;
+import org.voltdb.JNICallStats.Downcall;
 import org.voltdb.ParameterSet;
 import org.voltdb.PrivateVoltTableFactory;
+import org.voltdb.SiteTimeTracker;
 import org.voltdb.StatsSelector;
 import org.voltdb.TableStreamType;
 import org.voltdb.TheHashinator.HashinatorConfig;
@@ -62,9 +66,58 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     public static final int EE_COMPACTION_THRESHOLD;
 
+    /*
+     * Directory for the file that tuple blocks are moved to when the tuple blocks of a site's
+     * tables take more than EE_COLD_STORAGE_RESIDENT_MB of memory. The blocks that have gone
+     * longest without being scanned are moved first. With no directory but a budget, those blocks
+     * are paged out to swap instead, where zswap or zram compress them. With neither (the default)
+     * every block is kept in memory.
+     */
+    public static final String EE_COLD_STORAGE_DIRECTORY = System.getProperty("EE_COLD_STORAGE_DIRECTORY", "");
+    public static final long EE_COLD_STORAGE_RESIDENT_MB = Long.getLong("EE_COLD_STORAGE_RESIDENT_MB", 0);
+
+    /*
+     * Directory for the file that temp table blocks go to when a query's temp tables would take
+     * more than the temp table memory limit. Such queries then run slower instead of failing.
+     * Empty (the default) keeps them failing.
+     */
+    public static final String EE_TEMP_TABLE_SPILL_DIRECTORY = System.getProperty("EE_TEMP_TABLE_SPILL_DIRECTORY", "");
+
+    /*
+     * Fragments that take at least this many milliseconds in the EE are logged to the HOST log
+     * with the time and row counts of each plan node and their parameters, unless
+     * EE_SLOW_FRAGMENT_REDACT_PARAMS is set. 0 (the default) logs none.
+     */
+    public static final int EE_SLOW_FRAGMENT_MS = Integer.getInteger("EE_SLOW_FRAGMENT_MS", 0);
+    public static final boolean EE_SLOW_FRAGMENT_REDACT_PARAMS = Boolean.getBoolean("EE_SLOW_FRAGMENT_REDACT_PARAMS");
+
+    /*
+     * Native stack samples taken per second of CPU each site thread uses in the EE, reported by
+     * @Statistics NATIVESTACKS. @ProfCtl EE_SAMPLER_START and EE_SAMPLER_STOP change it at runtime.
+     * 0 disables the sampler.
+     */
+    public static final int EE_STACK_SAMPLE_HZ = Integer.getInteger("EE_STACK_SAMPLE_HZ", 10);
+
+    /*
+     * VARCHAR and VARBINARY values stored out of line of up to this many bytes (at most 256) are
+     * allocated in one piece with their reference instead of in the compacting string pools. That
+     * saves a pointer chase per read, but those values are not compacted. 0 (the default) disables it.
+     */
+    public static final int EE_PACKED_STRING_BYTES = Integer.getInteger("EE_PACKED_STRING_BYTES", 0);
+
+    /*
+     * Snapshot restores and table loads of many rows without strings decode the rows on up to this
+     * many helper threads per site (at most 8), ahead of the site inserting them. 0 (the default)
+     * decodes them on the site thread.
+     */
+    public static final int EE_LOAD_HELPER_THREADS = Integer.getInteger("EE_LOAD_HELPER_THREADS", 0);
+
     /** java.util.logging logger. */
     private static final VoltLogger LOG = new VoltLogger("HOST");
 
+    /** Values per transaction passed to nativeExecuteTransactionBatch; keep in synch with VoltDBEngine.h */
+    static final int TXN_BATCH_INFO_FIELDS = 6;
+
     private static final boolean HOST_TRACE_ENABLED;
 
     static {
@@ -148,7 +201,15 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                     defaultDrBufferSize,
                     tempTableMemory * 1024 * 1024,
                     createDrReplicatedStream,
-                    EE_COMPACTION_THRESHOLD);
+                    EE_COMPACTION_THRESHOLD,
+                    getStringBytes(EE_COLD_STORAGE_DIRECTORY),
+                    EE_COLD_STORAGE_RESIDENT_MB * 1024 * 1024,
+                    getStringBytes(EE_TEMP_TABLE_SPILL_DIRECTORY),
+                    EE_SLOW_FRAGMENT_MS,
+                    EE_SLOW_FRAGMENT_REDACT_PARAMS,
+                    EE_STACK_SAMPLE_HZ,
+                    EE_PACKED_STRING_BYTES,
+                    EE_LOAD_HELPER_THREADS);
         checkErrorCode(errorCode);
 
         setupPsetBuffer(256 * 1024); // 256k seems like a reasonable per-ee number (but is totally pulled from my a**)
@@ -272,7 +333,122 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             }
         }
 
-        // serialize the param sets
+        serializeParameterSets(batchSize, planFragmentIds, parameterSets);
+        // checkMaxFsSize();
+
+        // Execute the plan, passing a raw pointer to the byte buffers for input and output
+        //Clear is destructive, do it before the native call
+        deserializer.clear();
+        if (m_timeTracker != null) {
+            m_timeTracker.beginActivity(SiteTimeTracker.Activity.EE_EXECUTE);
+        }
+        final long callStart = beginCall();
+        final int errorCode;
+        try {
+            errorCode =
+                nativeExecutePlanFragments(
+                        pointer,
+                        numFragmentIds,
+                        planFragmentIds,
+                        inputDepIds,
+                        txnId,
+                        spHandle,
+                        lastCommittedSpHandle,
+                        uniqueId,
+                        undoToken);
+        } finally {
+            endCall(Downcall.EXECUTE_PLAN_FRAGMENTS, callStart);
+            if (m_timeTracker != null) {
+                m_timeTracker.endActivity();
+            }
+        }
+
+        try {
+            checkErrorCode(errorCode);
+            FastDeserializer fds = fallbackBuffer == null ? deserializer : new FastDeserializer(fallbackBuffer);
+            // get a copy of the result buffers and make the tables
+            // use the copy
+            try {
+                return readBatchResults(fds, batchSize);
+            } catch (final IOException ex) {
+                LOG.error("Failed to deserialze result table" + ex);
+                throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+            }
+        } finally {
+            fallbackBuffer = null;
+        }
+    }
+
+    /**
+     * Executes the fragment batches of several single-partition transactions with one
+     * call into the EE, each under its own undo token, to spread the cost of the call
+     * over small transactions. The transactions run in order and stop at the first to
+     * fail. The results of each transaction that completed are put in results, and
+     * the failure, if any, is thrown; the failed transaction is the first whose
+     * results entry is left null.
+     * @param numFragmentIds the number of fragments of each transaction
+     * @param planFragmentIds the transactions' fragment ids, back to back
+     * @param parameterSets the parameter set of each fragment, in the same order
+     * @param results an array of at least numTransactions entries to fill in
+     */
+    public void executeTransactionBatch(
+            final int numTransactions,
+            final int[] numFragmentIds,
+            final long[] planFragmentIds,
+            final Object[] parameterSets,
+            final long[] txnIds,
+            final long[] spHandles,
+            final long[] lastCommittedSpHandles,
+            final long[] uniqueIds,
+            final long[] undoTokens,
+            final VoltTable[][] results) throws EEException
+    {
+        final long[] transactionInfo = new long[numTransactions * TXN_BATCH_INFO_FIELDS];
+        int totalFragments = 0;
+        for (int i = 0; i < numTransactions; ++i) {
+            // every transaction needs at least one fragment to have a result section
+            assert(numFragmentIds[i] > 0);
+            int offset = i * TXN_BATCH_INFO_FIELDS;
+            transactionInfo[offset++] = numFragmentIds[i];
+            transactionInfo[offset++] = txnIds[i];
+            transactionInfo[offset++] = spHandles[i];
+            transactionInfo[offset++] = lastCommittedSpHandles[i];
+            transactionInfo[offset++] = uniqueIds[i];
+            transactionInfo[offset++] = undoTokens[i];
+            totalFragments += numFragmentIds[i];
+        }
+        final long[] batchFragmentIds = (planFragmentIds.length == totalFragments) ?
+                planFragmentIds : Arrays.copyOf(planFragmentIds, totalFragments);
+
+        serializeParameterSets(totalFragments, planFragmentIds, parameterSets);
+
+        //Clear is destructive, do it before the native call
+        deserializer.clear();
+        final long callStart = beginCall();
+        final int completed = nativeExecuteTransactionBatch(
+                pointer, numTransactions, transactionInfo, batchFragmentIds);
+        endCall(Downcall.EXECUTE_TRANSACTION_BATCH, callStart);
+
+        try {
+            FastDeserializer fds = fallbackBuffer == null ? deserializer : new FastDeserializer(fallbackBuffer);
+            try {
+                for (int i = 0; i < completed; ++i) {
+                    results[i] = readBatchResults(fds, numFragmentIds[i]);
+                }
+            } catch (final IOException ex) {
+                LOG.error("Failed to deserialze result table" + ex);
+                throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+            }
+            if (completed < numTransactions) {
+                checkErrorCode(ERRORCODE_ERROR);
+            }
+        } finally {
+            fallbackBuffer = null;
+        }
+    }
+
+    private void serializeParameterSets(final int batchSize, final long[] planFragmentIds,
+                                        final Object[] parameterSets) {
         int allPsetSize = 0;
         for (int i = 0; i < batchSize; ++i) {
             if (parameterSets[i] instanceof ByteBuffer) {
@@ -302,61 +478,37 @@ public class ExecutionEngineJNI extends ExecutionEngine {
                 }
             }
         }
-        // checkMaxFsSize();
-
-        // Execute the plan, passing a raw pointer to the byte buffers for input and output
-        //Clear is destructive, do it before the native call
-        deserializer.clear();
-        final int errorCode =
-            nativeExecutePlanFragments(
-                    pointer,
-                    numFragmentIds,
-                    planFragmentIds,
-                    inputDepIds,
-                    txnId,
-                    spHandle,
-                    lastCommittedSpHandle,
-                    uniqueId,
-                    undoToken);
+    }
 
-        try {
-            checkErrorCode(errorCode);
-            FastDeserializer fds = fallbackBuffer == null ? deserializer : new FastDeserializer(fallbackBuffer);
-            // get a copy of the result buffers and make the tables
-            // use the copy
-            try {
-                // read the complete size of the buffer used
-                final int totalSize = fds.readInt();
-                // check if anything was changed
-                final boolean dirty = fds.readBoolean();
-                if (dirty)
-                    m_dirty = true;
-                // get a copy of the buffer
-                final ByteBuffer fullBacking = fds.readBuffer(totalSize);
-                final VoltTable[] results = new VoltTable[batchSize];
-                for (int i = 0; i < batchSize; ++i) {
-                    final int numdeps = fullBacking.getInt(); // number of dependencies for this frag
-                    assert(numdeps == 1);
-                    @SuppressWarnings("unused")
-                    final
-                    int depid = fullBacking.getInt(); // ignore the dependency id
-                    final int tableSize = fullBacking.getInt();
-                    // reasonableness check
-                    assert(tableSize < 50000000);
-                    final ByteBuffer tableBacking = fullBacking.slice();
-                    fullBacking.position(fullBacking.position() + tableSize);
-                    tableBacking.limit(tableSize);
-
-                    results[i] = PrivateVoltTableFactory.createVoltTableFromBuffer(tableBacking, true);
-                }
-                return results;
-            } catch (final IOException ex) {
-                LOG.error("Failed to deserialze result table" + ex);
-                throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
-            }
-        } finally {
-            fallbackBuffer = null;
+    /**
+     * Read the result section that one batch of fragments left in the result buffer.
+     */
+    private VoltTable[] readBatchResults(final FastDeserializer fds, final int batchSize) throws IOException {
+        // read the complete size of the buffer used
+        final int totalSize = fds.readInt();
+        // check if anything was changed
+        final boolean dirty = fds.readBoolean();
+        if (dirty)
+            m_dirty = true;
+        // get a copy of the buffer
+        final ByteBuffer fullBacking = fds.readBuffer(totalSize);
+        final VoltTable[] results = new VoltTable[batchSize];
+        for (int i = 0; i < batchSize; ++i) {
+            final int numdeps = fullBacking.getInt(); // number of dependencies for this frag
+            assert(numdeps == 1);
+            @SuppressWarnings("unused")
+            final
+            int depid = fullBacking.getInt(); // ignore the dependency id
+            final int tableSize = fullBacking.getInt();
+            // reasonableness check
+            assert(tableSize < 50000000);
+            final ByteBuffer tableBacking = fullBacking.slice();
+            fullBacking.position(fullBacking.position() + tableSize);
+            tableBacking.limit(tableSize);
+
+            results[i] = PrivateVoltTableFactory.createVoltTableFromBuffer(tableBacking, true);
         }
+        return results;
     }
 
     @Override
@@ -366,8 +518,10 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         }
         //Clear is destructive, do it before the native call
         deserializer.clear();
+        final long callStart = beginCall();
         final int errorCode = nativeSerializeTable(pointer, tableId, deserializer.buffer(),
                 deserializer.buffer().capacity());
+        endCall(Downcall.SERIALIZE_TABLE, callStart);
         checkErrorCode(errorCode);
 
         return PrivateVoltTableFactory.createVoltTableFromSharedBuffer(deserializer.buffer());
@@ -392,9 +546,11 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
         //Clear is destructive, do it before the native call
         deserializer.clear();
+        final long callStart = beginCall();
         final int errorCode = nativeLoadTable(pointer, tableId, serialized_table,
                                               txnId, spHandle, lastCommittedSpHandle, uniqueId,
                                               returnUniqueViolations, shouldDRStream, undoToken);
+        endCall(Downcall.LOAD_TABLE, callStart);
         checkErrorCode(errorCode);
 
         try {
@@ -420,12 +576,16 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     @Override
     public void tick(final long time, final long lastCommittedTxnId) {
+        final long callStart = beginCall();
         nativeTick(pointer, time, lastCommittedTxnId);
+        endCall(Downcall.TICK, callStart);
     }
 
     @Override
     public void quiesce(long lastCommittedTxnId) {
+        final long callStart = beginCall();
         nativeQuiesce(pointer, lastCommittedTxnId);
+        endCall(Downcall.QUIESCE, callStart);
     }
 
     /**
@@ -445,7 +605,9 @@ public class ExecutionEngineJNI extends ExecutionEngine {
     {
         //Clear is destructive, do it before the native call
         deserializer.clear();
+        final long callStart = beginCall();
         final int numResults = nativeGetStats(pointer, selector.ordinal(), locators, interval, now);
+        endCall(Downcall.GET_STATS, callStart);
         if (numResults == -1) {
             throwExceptionForError(ERRORCODE_ERROR);
         }
@@ -475,12 +637,18 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
     @Override
     public boolean releaseUndoToken(final long undoToken) {
-        return nativeReleaseUndoToken(pointer, undoToken);
+        final long callStart = beginCall();
+        final boolean result = nativeReleaseUndoToken(pointer, undoToken);
+        endCall(Downcall.RELEASE_UNDO_TOKEN, callStart);
+        return result;
     }
 
     @Override
     public boolean undoUndoToken(final long undoToken) {
-        return nativeUndoUndoToken(pointer, undoToken);
+        final long callStart = beginCall();
+        final boolean result = nativeUndoUndoToken(pointer, undoToken);
+        endCall(Downcall.UNDO_UNDO_TOKEN, callStart);
+        return result;
     }
 
     /**
@@ -511,10 +679,12 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         byte[] bytes = outputBuffers != null
                             ? SnapshotUtil.OutputBuffersToBytes(outputBuffers)
                             : null;
+        final long callStart = beginCall();
         long remaining = nativeTableStreamSerializeMore(pointer,
                                                         tableId,
                                                         streamType.ordinal(),
                                                         bytes);
+        endCall(Downcall.TABLE_STREAM_SERIALIZE_MORE, callStart);
         int[] positions = null;
         assert(deserializer != null);
         int count;
@@ -545,8 +715,10 @@ public class ExecutionEngineJNI extends ExecutionEngine {
     {
         //Clear is destructive, do it before the native call
         deserializer.clear();
+        final long callStart = beginCall();
         long retval = nativeExportAction(pointer,
                                          syncAction, ackTxnId, seqNo, getStringBytes(tableSignature));
+        endCall(Downcall.EXPORT_ACTION, callStart);
         if (retval < 0) {
             LOG.info("exportAction failed.  syncAction: " + syncAction + ", ackTxnId: " +
                     ackTxnId + ", seqNo: " + seqNo + ", partitionId: " + partitionId +
@@ -609,7 +781,9 @@ public class ExecutionEngineJNI extends ExecutionEngine {
     public long applyBinaryLog(ByteBuffer log, long txnId, long spHandle, long lastCommittedSpHandle, long uniqueId,
                                int remoteClusterId, long undoToken) throws EEException
     {
+        final long callStart = beginCall();
         long rowCount = nativeApplyBinaryLog(pointer, txnId, spHandle, lastCommittedSpHandle, uniqueId, remoteClusterId, undoToken);
+        endCall(Downcall.APPLY_BINARY_LOG, callStart);
         if (rowCount < 0) {
             throwExceptionForError((int)rowCount);
         }
@@ -621,13 +795,39 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return nativeGetThreadLocalPoolAllocations();
     }
 
+    @Override
+    public long getHugePageAllocations() {
+        return nativeGetHugePageAllocations();
+    }
+
+    @Override
+    public long getLocalNodeAllocations() {
+        return nativeGetLocalNodeAllocations();
+    }
+
+    @Override
+    public long[] getMemoryDetail() {
+        return nativeGetMemoryDetail(pointer);
+    }
+
+    @Override
+    public long[] getUpcallStats() {
+        return nativeGetUpcallStats(pointer);
+    }
+
+    @Override
+    public String getNativeStacks() {
+        return new String(nativeGetNativeStacks(pointer), Constants.UTF8ENCODING);
+    }
+
     /*
      * Instead of using the reusable output buffer to get results for the next batch,
-     * use this buffer allocated by the EE. This is for one time use.
+     * use this buffer allocated by the EE. This is for one time use. The EE may
+     * outgrow a fallback buffer during the batch and pass a larger one, which
+     * replaces it.
      */
     public void fallbackToEEAllocatedBuffer(ByteBuffer buffer) {
         assert(buffer != null);
-        assert(fallbackBuffer == null);
         fallbackBuffer = buffer;
     }
 
@@ -638,7 +838,9 @@ public class ExecutionEngineJNI extends ExecutionEngine {
 
             //Clear is destructive, do it before the native call
             deserializer.clear();
+            final long callStart = beginCall();
             final int errorCode = nativeExecuteTask(pointer);
+            endCall(Downcall.EXECUTE_TASK, callStart);
             checkErrorCode(errorCode);
             return (byte[])deserializer.readArray(byte.class);
         } catch (IOException e) {
@@ -25,6 +25,7 @@ import java.util.Random;
 
 import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltcore.utils.Pair;
+import org.voltdb.JNICallStats;
 import org.voltdb.ParameterSet;
 import org.voltdb.StatsSelector;
 import org.voltdb.TableStreamType;
@@ -228,6 +229,31 @@ public class MockExecutionEngine extends ExecutionEngine {
         return 0L;
     }
 
+    @Override
+    public long getHugePageAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long getLocalNodeAllocations() {
+        return 0L;
+    }
+
+    @Override
+    public long[] getMemoryDetail() {
+        return new long[MEMORY_DETAIL_COUNT];
+    }
+
+    @Override
+    public long[] getUpcallStats() {
+        return new long[2 * JNICallStats.Upcall.values().length];
+    }
+
+    @Override
+    public String getNativeStacks() {
+        return "";
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) {
         throw new UnsupportedOperationException();
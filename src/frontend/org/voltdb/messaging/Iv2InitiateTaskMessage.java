@@ -90,6 +90,20 @@ public class Iv2InitiateTaskMessage extends TransactionInfoBaseMessage {
         m_connectionId = rhs.m_connectionId;
     }
 
+    /**
+     * A copy for the repair log, which keeps a logged transaction until it
+     * is truncated. The copy shares the invocation's serialized parameters
+     * but not the parameter set the site deserialized from them to run it,
+     * so the log does not hold every parameter twice.
+     */
+    public Iv2InitiateTaskMessage getRepairLogCopy()
+    {
+        Iv2InitiateTaskMessage copy = new Iv2InitiateTaskMessage(m_initiatorHSId, m_coordinatorHSId, this);
+        copy.m_shouldReturnResultTables = m_shouldReturnResultTables;
+        copy.m_invocation = m_invocation.getShallowCopyWithSerializedParams();
+        return copy;
+    }
+
     @Override
     public boolean isReadOnly() {
         return m_isReadOnly;
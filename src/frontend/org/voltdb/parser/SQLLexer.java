@@ -55,6 +55,9 @@ public class SQLLexer extends SQLPatternFactory
         new VerbToken("export", true),
         new VerbToken("partition", true),
         new VerbToken("dr", true),
+        new VerbToken("ttl", true),
+        new VerbToken("append", true),
+        new VerbToken("cluster", true),
         new VerbToken("set", true),
         // Unsupported verbs
         new VerbToken("import", false)
@@ -365,6 +365,9 @@ public class SQLParser extends SQLPatternFactory
             "\\AEXPORT|" +
             "\\AIMPORT|" +
             "\\ADR|" +
+            "\\ATTL|" +
+            "\\AAPPEND|" +
+            "\\ACLUSTER|" +
             "\\ASET" +
             ")" +                                  // end (group 1)
             "\\s" +                                // one required whitespace to terminate keyword
@@ -379,6 +382,66 @@ public class SQLParser extends SQLPatternFactory
             "\\s*;\\z"                              // (end statement)
             );
 
+    /**
+     * TTL TABLE <table> ON COLUMN <column> <value> [SECONDS|MINUTES|HOURS|DAYS] [BATCH_SIZE <rows>]
+     * TTL TABLE <table> DISABLE
+     *
+     * Capture groups:
+     *  (1) Table name
+     *  (2) DISABLE, or null
+     *  (3) Column name
+     *  (4) Time to live value
+     *  (5) Time unit, or null for seconds
+     *  (6) Batch size, or null
+     */
+    private static final Pattern PAT_TTL_TABLE = Pattern.compile(
+            "(?i)" +                                // (ignore case)
+            "\\A"  +                                // start statement
+            "TTL\\s+TABLE\\s+" +                    // TTL TABLE
+            "([\\w$]+)" +                           // (1) <table name>
+            "(?:" +
+            "\\s+(DISABLE)" +                       // (2) DISABLE
+            "|" +                                   // or
+            "\\s+ON\\s+COLUMN\\s+([\\w$]+)" +       // ON COLUMN (3) <column name>
+            "\\s+(\\d+)" +                          // (4) <value>
+            "(?:\\s+(SECONDS|MINUTES|HOURS|DAYS))?" + // (5) optional unit
+            "(?:\\s+BATCH_SIZE\\s+(\\d+))?" +         // (6) optional BATCH_SIZE <rows>
+            ")" +
+            "\\s*;\\z"                              // (end statement)
+            );
+
+    /**
+     * APPEND ONLY TABLE <table> [DISABLE]
+     *
+     * Capture groups:
+     *  (1) Table name
+     *  (2) DISABLE, or null
+     */
+    private static final Pattern PAT_APPEND_ONLY_TABLE = Pattern.compile(
+            "(?i)" +                                // (ignore case)
+            "\\A"  +                                // start statement
+            "APPEND\\s+ONLY\\s+TABLE\\s+" +         // APPEND ONLY TABLE
+            "([\\w$]+)" +                           // (1) <table name>
+            "(?:\\s+(DISABLE))?" +                  // (2) optional DISABLE argument
+            "\\s*;\\z"                              // (end statement)
+            );
+
+    /**
+     * CLUSTER TABLE <table> [DISABLE]
+     *
+     * Capture groups:
+     *  (1) Table name
+     *  (2) DISABLE, or null
+     */
+    private static final Pattern PAT_CLUSTER_TABLE = Pattern.compile(
+            "(?i)" +                                // (ignore case)
+            "\\A"  +                                // start statement
+            "CLUSTER\\s+TABLE\\s+" +                // CLUSTER TABLE
+            "([\\w$]+)" +                           // (1) <table name>
+            "(?:\\s+(DISABLE))?" +                  // (2) optional DISABLE argument
+            "\\s*;\\z"                              // (end statement)
+            );
+
     //========== Patterns from SQLCommand ==========
 
     private static final String EndOfLineCommentPatternString =
@@ -673,6 +736,36 @@ public class SQLParser extends SQLPatternFactory
         return PAT_DR_TABLE.matcher(statement);
     }
 
+    /**
+     * Match statement against TTL table pattern
+     * @param statement  statement to match against
+     * @return           pattern matcher object
+     */
+    public static Matcher matchTTLTable(String statement)
+    {
+        return PAT_TTL_TABLE.matcher(statement);
+    }
+
+    /**
+     * Match statement against append only table pattern
+     * @param statement  statement to match against
+     * @return           pattern matcher object
+     */
+    public static Matcher matchAppendOnlyTable(String statement)
+    {
+        return PAT_APPEND_ONLY_TABLE.matcher(statement);
+    }
+
+    /**
+     * Match statement against cluster table pattern
+     * @param statement  statement to match against
+     * @return           pattern matcher object
+     */
+    public static Matcher matchClusterTable(String statement)
+    {
+        return PAT_CLUSTER_TABLE.matcher(statement);
+    }
+
     /**
      * Match statement against import class pattern
      * @param statement  statement to match against
@@ -221,7 +221,7 @@ public class LoadMultipartitionTable extends VoltSystemProcedure
 
             // make sure at the start of the table
             table.resetRowPosition();
-            for (int i = 0; table.advanceRow(); ++i) {
+            while (table.advanceRow()) {
                 Object[] params = new Object[columnCount];
 
                 // get the parameters from the volt table
@@ -233,9 +233,9 @@ public class LoadMultipartitionTable extends VoltSystemProcedure
                 voltQueueSQL(stmt, params);
                 ++queued;
 
-                // every 100 statements, exec the batch
-                // 100 is an arbitrary number
-                if ((i % 100) == 0) {
+                // exec each full batch, the most statements the runner
+                // sends to the EE in one go
+                if ((queued % LoadSinglepartitionTable.LOAD_BATCH_SIZE) == 0) {
                     executed += executeSQL();
                 }
             }
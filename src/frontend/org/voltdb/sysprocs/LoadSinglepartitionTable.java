@@ -45,6 +45,10 @@ import org.voltdb.types.ConstraintType;
 )
 public class LoadSinglepartitionTable extends VoltSystemProcedure
 {
+    // Inserts queued per voltExecuteSQL call. ProcedureRunner splits
+    // larger batches into pieces of this size anyway.
+    static final int LOAD_BATCH_SIZE = 200;
+
     @Override
     public void init() {}
 
@@ -146,7 +150,7 @@ public class LoadSinglepartitionTable extends VoltSystemProcedure
 
         // make sure at the start of the table
         table.resetRowPosition();
-        for (int i = 0; table.advanceRow(); ++i) {
+        while (table.advanceRow()) {
             Object[] params = new Object[columnCount];
 
             // get the parameters from the volt table
@@ -158,9 +162,9 @@ public class LoadSinglepartitionTable extends VoltSystemProcedure
             voltQueueSQL(stmt, params);
             ++queued;
 
-            // every 100 statements, exec the batch
-            // 100 is an arbitrary number
-            if ((i % 100) == 0) {
+            // exec each full batch, the most statements the runner
+            // sends to the EE in one go
+            if ((queued % LOAD_BATCH_SIZE) == 0) {
                 executed += executeSQL();
             }
         }
@@ -20,6 +20,7 @@ package org.voltdb.sysprocs;
 import java.util.List;
 import java.util.Map;
 
+import org.voltdb.BackendTarget;
 import org.voltdb.DependencyPair;
 import org.voltdb.SystemProcedureExecutionContext;
 import org.voltdb.ParameterSet;
@@ -29,6 +30,8 @@ import org.voltdb.VoltSystemProcedure;
 import org.voltdb.VoltTable;
 import org.voltdb.VoltTable.ColumnInfo;
 import org.voltdb.VoltType;
+import org.voltdb.jni.ExecutionEngine;
+import org.voltdb.jni.ExecutionEngineJNI;
 
 /**
  * This procedure is not available to users. It is not added to
@@ -70,6 +73,33 @@ public class ProfCtl extends VoltSystemProcedure {
                 }
             }
         }
+        else if (command.toUpperCase().startsWith("EE_SAMPLER_START") ||
+                 command.equalsIgnoreCase("EE_SAMPLER_STOP")) {
+            // The native stack sampler behind @Statistics NATIVESTACKS, for every site
+            // on this host. "EE_SAMPLER_START [hz]" defaults to EE_STACK_SAMPLE_HZ.
+            int hz = 0;
+            if (command.toUpperCase().startsWith("EE_SAMPLER_START")) {
+                final String arg = command.substring("EE_SAMPLER_START".length()).trim();
+                try {
+                    hz = arg.isEmpty() ? Math.max(1, ExecutionEngineJNI.EE_STACK_SAMPLE_HZ) : Integer.parseInt(arg);
+                }
+                catch (NumberFormatException e) {
+                    hz = -1;
+                }
+            }
+            if (hz < 0) {
+                table.addRow("Invalid command: " + command);
+            }
+            else if (VoltDB.instance().getBackendTargetType() != BackendTarget.NATIVE_EE_JNI) {
+                table.addRow("The EE sampler requires the JNI backend");
+            }
+            else {
+                if (ctx.isLowestSiteId()) {
+                    ExecutionEngine.nativeSetStackSampleRate(hz);
+                }
+                table.addRow(command);
+            }
+        }
         else {
             table.addRow("Invalid command: " + command);
         }
@@ -442,6 +442,10 @@ public class SystemInformation extends VoltSystemProcedure
         if (hubAppender != null)
             port = hubAppender.getPort();
         vt.addRow(hostId, "LOG4JPORT", Integer.toString(port));
+        String siteBindings = VoltDB.instance().getConfig().m_siteCoreBindingSummary;
+        if (siteBindings != null) {
+            vt.addRow(hostId, "SITECOREBINDINGS", siteBindings);
+        }
         //Add license information
         if (MiscUtils.isPro()) {
             vt.addRow(hostId, "LICENSE", VoltDB.instance().getLicenseInformation());
@@ -120,6 +120,9 @@ public enum ExpressionType {
     AGGREGATE_APPROX_COUNT_DISTINCT(AggregateExpression.class, 46, "APPROX_COUNT_DISTINCT"),
     AGGREGATE_VALS_TO_HYPERLOGLOG (AggregateExpression.class, 47, "VALS_TO_HYPERLOGLOG"),
     AGGREGATE_HYPERLOGLOGS_TO_CARD(AggregateExpression.class, 48, "HYPERLOGLOGS_TO_CARD"),
+    AGGREGATE_APPROX_PERCENTILE   (AggregateExpression.class, 49, "APPROX_PERCENTILE"),
+    AGGREGATE_VALS_TO_TDIGEST     (AggregateExpression.class, 50, "VALS_TO_TDIGEST"),
+    AGGREGATE_TDIGESTS_TO_PERCENTILE(AggregateExpression.class, 51, "TDIGESTS_TO_PERCENTILE"),
     // ----------------------------
     // Windowed Aggregates.  We need to treat these
     // somewhat differently than the non-windowed
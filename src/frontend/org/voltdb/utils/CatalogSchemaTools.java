@@ -393,6 +393,20 @@ public abstract class CatalogSchemaTools {
             sb.append("DR TABLE " + catalog_tbl.getTypeName() + ";\n");
         }
 
+        if (catalog_tbl.getIsappendonly()) {
+            sb.append("APPEND ONLY TABLE " + catalog_tbl.getTypeName() + ";\n");
+        }
+
+        if (catalog_tbl.getIsclustered()) {
+            sb.append("CLUSTER TABLE " + catalog_tbl.getTypeName() + ";\n");
+        }
+
+        if (catalog_tbl.getTtlcolumn() != null) {
+            sb.append("TTL TABLE " + catalog_tbl.getTypeName() + " ON COLUMN " +
+                    catalog_tbl.getTtlcolumn().getTypeName() + " " + catalog_tbl.getTtlseconds() +
+                    " SECONDS BATCH_SIZE " + catalog_tbl.getTtlbatchsize() + ";\n");
+        }
+
         sb.append("\n");
         // Canonical DDL generation for this table is done, now just hand the CREATE TABLE
         // statement to whoever might be interested (DDLCompiler, I'm looking in your direction)
@@ -398,17 +398,18 @@ public class PBDRegularSegment extends PBDSegment {
                 return null;
             }
 
-            final long writePos = m_fc.position();
-            m_fc.position(m_readOffset);
-
+            // Use positional reads so the channel's position stays at the
+            // write offset and the writer is never disturbed by a reader
+            long readOffset = m_readOffset;
             try {
                 //Get the length and size prefix and then read the object
                 m_tmpHeaderBuf.b().clear();
                 while (m_tmpHeaderBuf.b().hasRemaining()) {
-                    int read = m_fc.read(m_tmpHeaderBuf.b());
+                    int read = m_fc.read(m_tmpHeaderBuf.b(), readOffset);
                     if (read == -1) {
                         throw new EOFException();
                     }
+                    readOffset += read;
                 }
                 m_tmpHeaderBuf.b().flip();
                 final int length = m_tmpHeaderBuf.b().getInt();
@@ -425,10 +426,11 @@ public class PBDRegularSegment extends PBDSegment {
                     final DBBPool.BBContainer compressedBuf = DBBPool.allocateDirectAndPool(length);
                     try {
                         while (compressedBuf.b().hasRemaining()) {
-                            int read = m_fc.read(compressedBuf.b());
+                            int read = m_fc.read(compressedBuf.b(), readOffset);
                             if (read == -1) {
                                 throw new EOFException();
                             }
+                            readOffset += read;
                         }
                         compressedBuf.b().flip();
 
@@ -444,10 +446,11 @@ public class PBDRegularSegment extends PBDSegment {
                     retcont = factory.getContainer(length);
                     retcont.b().limit(length);
                     while (retcont.b().hasRemaining()) {
-                        int read = m_fc.read(retcont.b());
+                        int read = m_fc.read(retcont.b(), readOffset);
                         if (read == -1) {
                             throw new EOFException();
                         }
+                        readOffset += read;
                     }
                     retcont.b().flip();
                 }
@@ -472,8 +475,7 @@ public class PBDRegularSegment extends PBDSegment {
                     }
                 };
             } finally {
-                m_readOffset = m_fc.position();
-                m_fc.position(writePos);
+                m_readOffset = readOffset;
             }
         }
 
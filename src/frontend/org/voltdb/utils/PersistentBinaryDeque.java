@@ -33,6 +33,7 @@ import org.voltcore.utils.DBBPool;
 import org.voltcore.utils.DBBPool.BBContainer;
 import org.voltcore.utils.DeferredSerialization;
 import org.voltdb.EELibraryLoader;
+import org.voltdb.QueueStats;
 import org.voltdb.utils.BinaryDeque.TruncatorResponse.Status;
 import org.voltdb.utils.PBDSegment.PBDSegmentReader;
 
@@ -52,6 +53,11 @@ import com.google_voltpatches.common.base.Throwables;
 public class PersistentBinaryDeque implements BinaryDeque {
     private static final VoltLogger LOG = new VoltLogger("HOST");
 
+    /**
+     * Time to acquire the monitor of a deque to offer or poll, across all the deques in the process
+     */
+    public static final QueueStats.Probe MONITOR_PROBE = new QueueStats.Probe("PBD_MONITOR");
+
     public static class UnsafeOutputContainerFactory implements OutputContainerFactory {
         @Override
         public BBContainer getContainer(int minimumSize) {
@@ -93,7 +99,9 @@ public class PersistentBinaryDeque implements BinaryDeque {
 
         @Override
         public BBContainer poll(OutputContainerFactory ocf) throws IOException {
+            final long start = MONITOR_PROBE.startWaitSample();
             synchronized (PersistentBinaryDeque.this) {
+                MONITOR_PROBE.endWaitSample(start);
                 if (m_closed) {
                     throw new IOException("Reader " + m_cursorId + " has been closed");
                 }
@@ -515,49 +523,57 @@ public class PersistentBinaryDeque implements BinaryDeque {
     }
 
     @Override
-    public synchronized void offer(BBContainer object) throws IOException {
+    public void offer(BBContainer object) throws IOException {
         offer(object, true);
     }
 
     @Override
-    public synchronized void offer(BBContainer object, boolean allowCompression) throws IOException {
-        assertions();
-        if (m_closed) {
-            throw new IOException("Closed");
-        }
+    public void offer(BBContainer object, boolean allowCompression) throws IOException {
+        final long start = MONITOR_PROBE.startWaitSample();
+        synchronized (this) {
+            MONITOR_PROBE.endWaitSample(start);
+            assertions();
+            if (m_closed) {
+                throw new IOException("Closed");
+            }
 
-        PBDSegment tail = peekLastSegment();
-        final boolean compress = object.b().isDirect() && allowCompression;
-        if (!tail.offer(object, compress)) {
-            tail = addSegment(tail);
-            final boolean success = tail.offer(object, compress);
-            if (!success) {
-                throw new IOException("Failed to offer object in PBD");
+            PBDSegment tail = peekLastSegment();
+            final boolean compress = object.b().isDirect() && allowCompression;
+            if (!tail.offer(object, compress)) {
+                tail = addSegment(tail);
+                final boolean success = tail.offer(object, compress);
+                if (!success) {
+                    throw new IOException("Failed to offer object in PBD");
+                }
             }
+            m_numObjects++;
+            assertions();
         }
-        m_numObjects++;
-        assertions();
     }
 
     @Override
-    public synchronized int offer(DeferredSerialization ds) throws IOException {
-        assertions();
-        if (m_closed) {
-            throw new IOException("Closed");
-        }
+    public int offer(DeferredSerialization ds) throws IOException {
+        final long start = MONITOR_PROBE.startWaitSample();
+        synchronized (this) {
+            MONITOR_PROBE.endWaitSample(start);
+            assertions();
+            if (m_closed) {
+                throw new IOException("Closed");
+            }
 
-        PBDSegment tail = peekLastSegment();
-        int written = tail.offer(ds);
-        if (written < 0) {
-            tail = addSegment(tail);
-            written = tail.offer(ds);
+            PBDSegment tail = peekLastSegment();
+            int written = tail.offer(ds);
             if (written < 0) {
-                throw new IOException("Failed to offer object in PBD");
+                tail = addSegment(tail);
+                written = tail.offer(ds);
+                if (written < 0) {
+                    throw new IOException("Failed to offer object in PBD");
+                }
             }
+            m_numObjects++;
+            assertions();
+            return written;
         }
-        m_numObjects++;
-        assertions();
-        return written;
     }
 
     private PBDSegment addSegment(PBDSegment tail) throws IOException {
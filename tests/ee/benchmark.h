@@ -0,0 +1,140 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Minimal timing support for the EE microbenchmarks in tests/ee/benchmarks.
+//
+// Each benchmark body runs a fixed number of operations per repetition.
+// After a few unmeasured warm-up repetitions, the time per operation of
+// every measured repetition is recorded, and a summary is printed as one
+// JSON object per line so that results can be collected and compared
+// across builds:
+//
+//   {"benchmark":"NValue/add/bigint","ops":100000,"reps":20,
+//    "min_ns":1.9,"median_ns":2.0,"p90_ns":2.1,"p99_ns":2.4,"max_ns":2.4}
+//
+// BENCHMARK_REPS and BENCHMARK_WARMUP in the environment override the
+// default repetition counts. If BENCHMARK_OUTPUT names a file, the JSON
+// lines are also appended to it, free of the test harness output.
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+namespace benchmark {
+
+inline int64_t nowNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+inline int envOrDefault(const char* name, int defaultValue) {
+    const char* value = getenv(name);
+    if (value == NULL || *value == '\0') {
+        return defaultValue;
+    }
+    return atoi(value);
+}
+
+// Keeps the compiler from discarding a computed value.
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    int64_t ops;
+    std::vector<double> nanosPerOp;
+
+    double percentile(double pct) const {
+        // nanosPerOp is sorted by run()
+        size_t idx = static_cast<size_t>(pct * static_cast<double>(nanosPerOp.size() - 1) + 0.5);
+        return nanosPerOp[idx];
+    }
+
+    void printJSON(FILE* out) const {
+        fprintf(out,
+                "{\"benchmark\":\"%s\",\"ops\":%lld,\"reps\":%d,"
+                "\"min_ns\":%.3f,\"median_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,\"max_ns\":%.3f}\n",
+                name.c_str(), static_cast<long long>(ops), static_cast<int>(nanosPerOp.size()),
+                nanosPerOp.front(), percentile(0.5), percentile(0.9), percentile(0.99),
+                nanosPerOp.back());
+        fflush(out);
+    }
+};
+
+/**
+ * Time body(ops) over the configured repetitions. The body must perform
+ * ops operations; setup(), when given, runs before every repetition and
+ * is not timed.
+ */
+template<typename Body, typename Setup>
+Result run(const std::string& name, int64_t ops, Body body, Setup setup) {
+    const int warmup = envOrDefault("BENCHMARK_WARMUP", 3);
+    const int reps = std::max(1, envOrDefault("BENCHMARK_REPS", 20));
+
+    Result result;
+    result.name = name;
+    result.ops = ops;
+    for (int i = 0; i < warmup + reps; ++i) {
+        setup();
+        int64_t start = nowNanos();
+        body(ops);
+        int64_t elapsed = nowNanos() - start;
+        if (i >= warmup) {
+            result.nanosPerOp.push_back(static_cast<double>(elapsed) / static_cast<double>(ops));
+        }
+    }
+    std::sort(result.nanosPerOp.begin(), result.nanosPerOp.end());
+    result.printJSON(stdout);
+    const char* outputPath = getenv("BENCHMARK_OUTPUT");
+    if (outputPath != NULL && *outputPath != '\0') {
+        FILE* out = fopen(outputPath, "a");
+        if (out != NULL) {
+            result.printJSON(out);
+            fclose(out);
+        }
+    }
+    return result;
+}
+
+struct NoSetup {
+    void operator()() const {}
+};
+
+template<typename Body>
+Result run(const std::string& name, int64_t ops, Body body) {
+    return run(name, ops, body, NoSetup());
+}
+
+} // namespace benchmark
+
+#endif // BENCHMARK_H_
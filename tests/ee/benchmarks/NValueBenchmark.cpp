@@ -0,0 +1,164 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Microbenchmarks for NValue arithmetic, comparison and serialization.
+ * Each test prints one JSON line per benchmark; see benchmark.h.
+ */
+
+#include <vector>
+
+#include "harness.h"
+#include "benchmark.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
+#include "common/serializeio.h"
+
+using namespace voltdb;
+
+static const int64_t OPS = 100000;
+
+class NValueBenchmark : public Test {
+public:
+    NValueBenchmark()
+    {
+        for (int64_t i = 0; i < OPS; ++i) {
+            m_bigints.push_back(ValueFactory::getBigIntValue(i * 7919));
+            m_doubles.push_back(ValueFactory::getDoubleValue(static_cast<double>(i) * 0.5));
+        }
+        char buffer[32];
+        for (int64_t i = 0; i < 1024; ++i) {
+            snprintf(buffer, sizeof(buffer), "benchmark-string-%06d", static_cast<int>(i));
+            m_strings.push_back(ValueFactory::getStringValue(buffer, &m_pool));
+        }
+    }
+
+    ThreadLocalPool m_threadLocalPool;
+    Pool m_pool;
+    std::vector<NValue> m_bigints;
+    std::vector<NValue> m_doubles;
+    std::vector<NValue> m_strings;
+};
+
+struct AddBody {
+    const std::vector<NValue>& values;
+    void operator()(int64_t ops) const {
+        NValue sum = ValueFactory::getBigIntValue(0);
+        for (int64_t i = 0; i < ops; ++i) {
+            sum = sum.op_add(values[i]);
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+struct MultiplyBody {
+    const std::vector<NValue>& values;
+    void operator()(int64_t ops) const {
+        NValue product = ValueFactory::getDoubleValue(1.0);
+        for (int64_t i = 0; i < ops; ++i) {
+            product = values[i].op_multiply(product);
+        }
+        benchmark::doNotOptimize(product);
+    }
+};
+
+struct CompareBody {
+    const std::vector<NValue>& values;
+    void operator()(int64_t ops) const {
+        const size_t count = values.size();
+        int result = 0;
+        for (int64_t i = 0; i < ops; ++i) {
+            result += values[i % count].compare(values[(i + 1) % count]);
+        }
+        benchmark::doNotOptimize(result);
+    }
+};
+
+struct SerializeBody {
+    const std::vector<NValue>& values;
+    CopySerializeOutput& out;
+    void operator()(int64_t ops) const {
+        const size_t count = values.size();
+        out.reset();
+        for (int64_t i = 0; i < ops; ++i) {
+            values[i % count].serializeTo(out);
+        }
+        benchmark::doNotOptimize(out.size());
+    }
+};
+
+struct DeserializeBody {
+    const CopySerializeOutput& in;
+    ValueType type;
+    Pool* pool;
+    void operator()(int64_t ops) const {
+        ReferenceSerializeInputBE input(in.data(), in.size());
+        NValue value;
+        for (int64_t i = 0; i < ops; ++i) {
+            value.deserializeFromAllocateForStorage(type, input, pool);
+        }
+        benchmark::doNotOptimize(value);
+    }
+};
+
+struct PurgePool {
+    Pool* pool;
+    void operator()() const { pool->purge(); }
+};
+
+TEST_F(NValueBenchmark, Arithmetic) {
+    AddBody add = { m_bigints };
+    benchmark::run("NValue/add/bigint", OPS, add);
+    MultiplyBody multiply = { m_doubles };
+    benchmark::run("NValue/multiply/double", OPS, multiply);
+}
+
+TEST_F(NValueBenchmark, Compare) {
+    CompareBody bigints = { m_bigints };
+    benchmark::run("NValue/compare/bigint", OPS, bigints);
+    CompareBody strings = { m_strings };
+    benchmark::run("NValue/compare/varchar", OPS, strings);
+}
+
+TEST_F(NValueBenchmark, Serialization) {
+    CopySerializeOutput bigintOut;
+    SerializeBody serializeBigints = { m_bigints, bigintOut };
+    benchmark::run("NValue/serialize/bigint", OPS, serializeBigints);
+    CopySerializeOutput stringOut;
+    SerializeBody serializeStrings = { m_strings, stringOut };
+    benchmark::run("NValue/serialize/varchar", OPS, serializeStrings);
+
+    // The buffers now hold OPS values each, left by the last repetition
+    Pool pool;
+    PurgePool purge = { &pool };
+    DeserializeBody deserializeBigints = { bigintOut, VALUE_TYPE_BIGINT, &pool };
+    benchmark::run("NValue/deserialize/bigint", OPS, deserializeBigints, purge);
+    DeserializeBody deserializeStrings = { stringOut, VALUE_TYPE_VARCHAR, &pool };
+    benchmark::run("NValue/deserialize/varchar", OPS, deserializeStrings, purge);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
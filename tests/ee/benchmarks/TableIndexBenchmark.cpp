@@ -0,0 +1,258 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Microbenchmarks for PersistentTable insert, lookup, update and delete
+ * with each kind of index TableIndexFactory builds: none, balanced tree,
+ * countable balanced tree and hash. Every table has a unique primary key
+ * on column 0 and a non-unique secondary index on column 1 of the same
+ * kind. Each test prints one JSON line per benchmark; see benchmark.h.
+ */
+
+#include <string>
+#include <vector>
+
+#include "harness.h"
+#include "benchmark.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/ThreadLocalPool.h"
+#include "common/TupleSchema.h"
+#include "common/tabletuple.h"
+#include "execution/VoltDBEngine.h"
+#include "indexes/tableindex.h"
+#include "indexes/tableindexfactory.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+
+using namespace voltdb;
+
+static const int64_t ROWS = 100000;
+static const int NUM_OF_COLUMNS = 4;
+
+class TableIndexBenchmark : public Test {
+public:
+    TableIndexBenchmark() : m_table(NULL)
+    {
+        m_engine = new VoltDBEngine();
+        m_exceptionBuffer = new char[4096];
+        m_engine->setBuffers(NULL, 0, NULL, 0, m_exceptionBuffer, 4096);
+        int partitionCount = 1;
+        m_engine->initialize(0, 0, 0, 0, "", 0, 1024, DEFAULT_TEMP_TABLE_MEMORY, false);
+        m_engine->updateHashinator(HASHINATOR_LEGACY, (char*)&partitionCount, NULL, 0);
+        memset(m_signature, 0, sizeof(m_signature));
+    }
+
+    ~TableIndexBenchmark()
+    {
+        delete m_table;
+        delete m_engine;
+        delete[] m_exceptionBuffer;
+    }
+
+    void initTable(bool indexed, TableIndexType type, bool countable)
+    {
+        delete m_table;
+        m_table = NULL;
+
+        std::vector<std::string> columnNames;
+        char buffer[32];
+        for (int ctr = 0; ctr < NUM_OF_COLUMNS; ctr++) {
+            snprintf(buffer, 32, "column%02d", ctr);
+            columnNames.push_back(buffer);
+        }
+        std::vector<ValueType> columnTypes(NUM_OF_COLUMNS, VALUE_TYPE_BIGINT);
+        std::vector<int32_t> columnLengths(NUM_OF_COLUMNS, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        std::vector<bool> columnAllowNull(NUM_OF_COLUMNS, false);
+        TupleSchema* schema = TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+
+        m_table = dynamic_cast<PersistentTable*>(
+            TableFactory::getPersistentTable(1000, "bench_table", schema, columnNames, m_signature));
+
+        if (indexed) {
+            std::vector<int> pkeyColumns(1, 0);
+            TableIndexScheme pkeyScheme("idx_pkey", type, pkeyColumns, TableIndex::simplyIndexColumns(),
+                                        true, countable, schema);
+            TableIndex* pkeyIndex = TableIndexFactory::getInstance(pkeyScheme);
+            m_table->addIndex(pkeyIndex);
+            m_table->setPrimaryKeyIndex(pkeyIndex);
+
+            std::vector<int> secondaryColumns(1, 1);
+            TableIndexScheme secondaryScheme("idx_secondary", type, secondaryColumns,
+                                             TableIndex::simplyIndexColumns(),
+                                             false, countable, schema);
+            m_table->addIndex(TableIndexFactory::getInstance(secondaryScheme));
+        }
+    }
+
+    static void setRow(TableTuple& tuple, int64_t row, int64_t version)
+    {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(row));
+        tuple.setNValue(1, ValueFactory::getBigIntValue((row % 1000) + version));
+        tuple.setNValue(2, ValueFactory::getBigIntValue(row * 11));
+        tuple.setNValue(3, ValueFactory::getBigIntValue(version));
+    }
+
+    void populate()
+    {
+        m_table->deleteAllTuples(true, false);
+        for (int64_t row = 0; row < ROWS; ++row) {
+            TableTuple& tuple = m_table->tempTuple();
+            setRow(tuple, row, 0);
+            m_table->insertTuple(tuple);
+        }
+    }
+
+    void runAll(const std::string& kind, bool indexed);
+
+    ThreadLocalPool m_pool;
+    VoltDBEngine* m_engine;
+    char* m_exceptionBuffer;
+    char m_signature[20];
+    PersistentTable* m_table;
+    std::vector<TableTuple> m_tuples;
+};
+
+struct ClearTable {
+    TableIndexBenchmark* bench;
+    void operator()() const { bench->m_table->deleteAllTuples(true, false); }
+};
+
+struct PopulateAndCollect {
+    TableIndexBenchmark* bench;
+    void operator()() const {
+        bench->populate();
+        bench->m_tuples.clear();
+        TableTuple tuple(bench->m_table->schema());
+        TableIterator& iter = bench->m_table->iterator();
+        while (iter.next(tuple)) {
+            bench->m_tuples.push_back(tuple);
+        }
+    }
+};
+
+struct InsertBody {
+    PersistentTable* table;
+    void operator()(int64_t ops) const {
+        for (int64_t row = 0; row < ops; ++row) {
+            TableTuple& tuple = table->tempTuple();
+            TableIndexBenchmark::setRow(tuple, row, 0);
+            table->insertTuple(tuple);
+        }
+    }
+};
+
+struct LookupBody {
+    PersistentTable* table;
+    void operator()(int64_t ops) const {
+        TableIndex* index = table->primaryKeyIndex();
+        TableTuple key(index->getKeySchema());
+        char keyStorage[64];
+        key.move(keyStorage);
+        int64_t found = 0;
+        for (int64_t i = 0; i < ops; ++i) {
+            // visit keys out of insertion order
+            key.setNValue(0, ValueFactory::getBigIntValue((i * 7919) % ROWS));
+            IndexCursor cursor(index->getTupleSchema());
+            if (index->moveToKey(&key, cursor)) {
+                ++found;
+            }
+        }
+        benchmark::doNotOptimize(found);
+    }
+};
+
+struct UpdateBody {
+    TableIndexBenchmark* bench;
+    void operator()(int64_t ops) const {
+        PersistentTable* table = bench->m_table;
+        std::vector<TableIndex*> indexes = table->allIndexes();
+        TableTuple& source = table->tempTuple();
+        for (int64_t i = 0; i < ops; ++i) {
+            TableTuple& target = bench->m_tuples[i];
+            // changes the secondary key and a non-key column
+            TableIndexBenchmark::setRow(source, ValuePeeker::peekAsBigInt(target.getNValue(0)), 1);
+            table->updateTupleWithSpecificIndexes(target, source, indexes, false);
+        }
+    }
+};
+
+struct DeleteBody {
+    TableIndexBenchmark* bench;
+    void operator()(int64_t ops) const {
+        for (int64_t i = 0; i < ops; ++i) {
+            bench->m_table->deleteTuple(bench->m_tuples[i], false);
+        }
+    }
+};
+
+void TableIndexBenchmark::runAll(const std::string& kind, bool indexed)
+{
+    const std::string prefix = "PersistentTable/" + kind + "/";
+
+    ClearTable clear = { this };
+    InsertBody insert = { m_table };
+    benchmark::run(prefix + "insert", ROWS, insert, clear);
+
+    if (indexed) {
+        populate();
+        LookupBody lookup = { m_table };
+        benchmark::run(prefix + "lookup", ROWS, lookup);
+    }
+
+    PopulateAndCollect collect = { this };
+    UpdateBody update = { this };
+    benchmark::run(prefix + "update", ROWS, update, collect);
+
+    DeleteBody remove = { this };
+    benchmark::run(prefix + "delete", ROWS, remove, collect);
+
+    m_tuples.clear();
+    m_table->deleteAllTuples(true, false);
+}
+
+TEST_F(TableIndexBenchmark, NoIndex) {
+    initTable(false, BALANCED_TREE_INDEX, false);
+    runAll("none", false);
+}
+
+TEST_F(TableIndexBenchmark, BalancedTree) {
+    initTable(true, BALANCED_TREE_INDEX, false);
+    runAll("tree", true);
+}
+
+TEST_F(TableIndexBenchmark, CountableBalancedTree) {
+    initTable(true, BALANCED_TREE_INDEX, true);
+    runAll("countable_tree", true);
+}
+
+TEST_F(TableIndexBenchmark, HashTable) {
+    initTable(true, HASH_TABLE_INDEX, false);
+    runAll("hash", true);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
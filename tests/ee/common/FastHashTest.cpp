@@ -0,0 +1,91 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include "harness.h"
+#include "common/FastHash.h"
+
+#include <set>
+#include <string>
+
+using namespace voltdb;
+
+class FastHashTest : public Test {
+public:
+    FastHashTest() { }
+};
+
+TEST_F(FastHashTest, EqualBytesHashEqual)
+{
+    const std::string text("the quick brown fox jumps over the lazy dog");
+    const std::string copy(text);
+    for (size_t length = 0; length <= text.size(); length++) {
+        EXPECT_EQ(FastHash::hashBytes(text.data(), length), FastHash::hashBytes(copy.data(), length));
+    }
+    EXPECT_EQ(FastHash::hashBytes(NULL, 0), FastHash::hashBytes(text.data(), 0));
+}
+
+TEST_F(FastHashTest, LengthAndSeedMatter)
+{
+    // Trailing zero bytes fill out the last word the same way a shorter
+    // key's padding does, so only the length tells these apart.
+    const char zeros[16] = { 0 };
+    std::set<uint64_t> hashes;
+    for (size_t length = 0; length <= sizeof(zeros); length++) {
+        hashes.insert(FastHash::hashBytes(zeros, length));
+    }
+    EXPECT_EQ(sizeof(zeros) + 1, hashes.size());
+    EXPECT_NE(FastHash::hashBytes("key", 3, 1), FastHash::hashBytes("key", 3, 2));
+
+    const uint64_t words[2] = { 0, 0 };
+    EXPECT_NE(FastHash::hashWords(words, 1), FastHash::hashWords(words, 2));
+}
+
+TEST_F(FastHashTest, WordOrderMatters)
+{
+    // Keys that differ only in word order must not collide.
+    const uint64_t forward[2] = { 1, 2 };
+    const uint64_t backward[2] = { 2, 1 };
+    EXPECT_NE(FastHash::hashWords(forward, 2), FastHash::hashWords(backward, 2));
+    EXPECT_NE(FastHash::hashBytes(reinterpret_cast<const char*>(forward), sizeof(forward)),
+              FastHash::hashBytes(reinterpret_cast<const char*>(backward), sizeof(backward)));
+}
+
+TEST_F(FastHashTest, SmallIntegersSpreadOverLowBits)
+{
+    // Tables pick buckets with the low bits. 1024 consecutive integers
+    // should land in about 63% of 1024 buckets, as random keys would,
+    // rather than in a few of them or in exactly one each.
+    const size_t buckets = 1024;
+    std::set<uint64_t> used;
+    for (uint64_t key = 0; key < buckets; key++) {
+        used.insert(FastHash::hashWords(&key, 1) & (buckets - 1));
+    }
+    EXPECT_TRUE(used.size() > buckets / 2);
+    EXPECT_TRUE(used.size() < buckets * 3 / 4);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,104 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "harness.h"
+#include "common/JsonDocumentCache.h"
+#include "common/SQLException.h"
+
+#include <string>
+
+using namespace voltdb;
+
+class JsonDocumentCacheTest : public Test {
+public:
+    JsonDocumentCacheTest() { }
+
+    const Json::Value& parse(const std::string& text)
+    {
+        return m_cache.parse(text.data(), static_cast<int32_t>(text.size()));
+    }
+
+protected:
+    JsonDocumentCache m_cache;
+};
+
+TEST_F(JsonDocumentCacheTest, ReusesTheParseOfTheSameText)
+{
+    const Json::Value* first = &parse("{\"a\":1}");
+    EXPECT_EQ(1, (*first)["a"].asInt());
+    // Another copy of the same text, as from another row, finds the entry.
+    std::string copy("{\"a\":1}");
+    EXPECT_EQ(first, &parse(copy));
+
+    const Json::Value* other = &parse("{\"a\":2}");
+    EXPECT_NE(first, other);
+    EXPECT_EQ(2, (*other)["a"].asInt());
+    EXPECT_EQ(first, &parse("{\"a\":1}"));
+}
+
+TEST_F(JsonDocumentCacheTest, ReusedStorageDoesNotMatch)
+{
+    char buffer[] = "[1,2,3]";
+    EXPECT_EQ(3u, m_cache.parse(buffer, 7).size());
+    buffer[4] = ']';
+    buffer[5] = ' ';
+    buffer[6] = ' ';
+    EXPECT_EQ(2u, m_cache.parse(buffer, 7).size());
+}
+
+TEST_F(JsonDocumentCacheTest, EvictsTheOldest)
+{
+    std::string texts[] = { "[0]", "[1]", "[2]", "[3]", "[4]" };
+    parse(texts[0]);
+    for (int ii = 1; ii < 5; ii++) {
+        EXPECT_EQ(ii, parse(texts[ii])[0].asInt());
+    }
+    // [0]'s entry went to [4], so [0] is parsed again, correctly.
+    EXPECT_EQ(0, parse(texts[0])[0].asInt());
+    EXPECT_EQ(4, parse(texts[4])[0].asInt());
+}
+
+TEST_F(JsonDocumentCacheTest, MalformedTextThrowsAndIsNotKept)
+{
+    bool threw = false;
+    try {
+        parse("{\"a\":");
+    }
+    catch (const SQLException&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    threw = false;
+    try {
+        parse("{\"a\":");
+    }
+    catch (const SQLException&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,177 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+#include "common/StringDictionary.h"
+#include "common/StringRef.h"
+#include "common/ThreadLocalPool.h"
+#include "common/Pool.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace voltdb;
+
+class StringDictionaryTest : public Test {
+public:
+    StringDictionaryTest() { }
+
+    // A temporary string to look up, as an insert from a plan would supply.
+    StringRef* temp(const std::string& value)
+    {
+        return StringRef::create(static_cast<int32_t>(value.size()), value.c_str(), &m_tempPool);
+    }
+
+    std::string valueOf(const StringRef* sref)
+    {
+        int32_t length;
+        const char* bytes = sref->getObject(&length);
+        return std::string(bytes, length);
+    }
+
+protected:
+    ThreadLocalPool m_threadLocalPool;
+    Pool m_tempPool;
+};
+
+TEST_F(StringDictionaryTest, SharesEqualValues)
+{
+    StringDictionary dictionary;
+    const StringRef* active = dictionary.intern(temp("ACTIVE"));
+    ASSERT_TRUE(active != NULL);
+    EXPECT_EQ(std::string("ACTIVE"), valueOf(active));
+    EXPECT_TRUE(dictionary.owns(active));
+
+    const StringRef* closed = dictionary.intern(temp("CLOSED"));
+    ASSERT_TRUE(closed != NULL);
+    EXPECT_TRUE(active != closed);
+
+    EXPECT_EQ(active, dictionary.intern(temp("ACTIVE")));
+    EXPECT_EQ(closed, dictionary.intern(temp("CLOSED")));
+    // An entry is its own shared copy.
+    EXPECT_EQ(active, dictionary.intern(active));
+    EXPECT_EQ(2, dictionary.size());
+
+    // An unshared persistent string is looked up by value.
+    StringRef* persistent = StringRef::create(6, "ACTIVE", NULL);
+    EXPECT_FALSE(dictionary.owns(persistent));
+    EXPECT_EQ(active, dictionary.intern(persistent));
+    EXPECT_TRUE(persistent->getAllocatedSize() > 0);
+    StringRef::destroy(persistent);
+
+    // Entries are owned by the dictionary, not the tuples referencing them.
+    EXPECT_EQ(0, active->getAllocatedSize());
+    StringRef::destroy(const_cast<StringRef*>(active));
+    EXPECT_EQ(std::string("ACTIVE"), valueOf(dictionary.intern(temp("ACTIVE"))));
+
+    // Entries are not shared across dictionaries.
+    StringDictionary other;
+    EXPECT_FALSE(other.owns(active));
+    const StringRef* otherActive = other.intern(active);
+    ASSERT_TRUE(otherActive != NULL);
+    EXPECT_TRUE(otherActive != active);
+    EXPECT_TRUE(other.owns(otherActive));
+}
+
+TEST_F(StringDictionaryTest, RejectsLongValues)
+{
+    StringDictionary dictionary;
+    std::string longest(StringDictionary::MAX_VALUE_LENGTH, 'x');
+    EXPECT_TRUE(dictionary.intern(temp(longest)) != NULL);
+    EXPECT_TRUE(dictionary.intern(temp(longest + "x")) == NULL);
+    EXPECT_EQ(1, dictionary.size());
+}
+
+TEST_F(StringDictionaryTest, StopsGrowingWhenFull)
+{
+    StringDictionary dictionary;
+    char buffer[32];
+    for (std::size_t ii = 0; ii < StringDictionary::MAX_ENTRIES; ii++) {
+        snprintf(buffer, sizeof(buffer), "value %d", static_cast<int>(ii));
+        ASSERT_TRUE(dictionary.intern(temp(buffer)) != NULL);
+    }
+    EXPECT_EQ(StringDictionary::MAX_ENTRIES, dictionary.size());
+    int64_t fullSize = dictionary.getAllocatedMemory();
+
+    // Values already held are still shared, new ones are not.
+    EXPECT_TRUE(dictionary.intern(temp("value 7")) != NULL);
+    EXPECT_TRUE(dictionary.intern(temp("one too many")) == NULL);
+    EXPECT_EQ(StringDictionary::MAX_ENTRIES, dictionary.size());
+    EXPECT_EQ(fullSize, dictionary.getAllocatedMemory());
+    EXPECT_FALSE(dictionary.isRetired());
+
+    // A window of lookups that mostly hit keeps the dictionary in service.
+    for (std::size_t ii = 0; ii < StringDictionary::MAX_ENTRIES; ii++) {
+        snprintf(buffer, sizeof(buffer), "value %d", static_cast<int>(ii));
+        dictionary.intern(temp(buffer));
+    }
+    EXPECT_FALSE(dictionary.isRetired());
+
+    // A window of lookups that mostly miss retires it.
+    for (std::size_t ii = 0; ii < StringDictionary::MAX_ENTRIES; ii++) {
+        snprintf(buffer, sizeof(buffer), "other value %d", static_cast<int>(ii));
+        EXPECT_TRUE(dictionary.intern(temp(buffer)) == NULL);
+    }
+    EXPECT_TRUE(dictionary.isRetired());
+    EXPECT_TRUE(dictionary.intern(temp("value 7")) == NULL);
+}
+
+// MEMCHECK builds allocate every persistent string separately.
+#ifndef MEMCHECK
+TEST_F(StringDictionaryTest, PackedStringsAreNotShared)
+{
+    StringDictionary dictionary;
+    StringRef::setPackedMaxLength(16);
+    StringRef* packed = StringRef::create(6, "ACTIVE", NULL);
+    StringRef* unpacked = StringRef::create(17, "ACTIVE AND CLOSED", NULL);
+    StringRef::setPackedMaxLength(0);
+
+    // A packed string's value follows its StringRef, past a NULL dictionary.
+    EXPECT_EQ(reinterpret_cast<char*>(packed) + sizeof(StringRef) +
+              sizeof(StringDictionary*) + sizeof(ThreadLocalPool::Sized),
+              packed->getObjectValue());
+    EXPECT_EQ(std::string("ACTIVE"), valueOf(packed));
+    EXPECT_FALSE(dictionary.owns(packed));
+    EXPECT_EQ(32, packed->getAllocatedSize());
+    EXPECT_EQ(std::string("ACTIVE AND CLOSED"), valueOf(unpacked));
+    EXPECT_TRUE(unpacked->getAllocatedSize() > static_cast<int32_t>(sizeof(StringRef)) + 17);
+
+    // Still looked up by value and freed like any persistent string.
+    const StringRef* active = dictionary.intern(packed);
+    ASSERT_TRUE(active != NULL);
+    EXPECT_TRUE(active != packed);
+    StringRef::destroy(packed);
+    StringRef::destroy(unpacked);
+    EXPECT_EQ(std::string("ACTIVE"), valueOf(active));
+
+    // The length is capped.
+    StringRef::setPackedMaxLength(100000);
+    EXPECT_EQ(StringRef::PACKED_MAX_LENGTH_LIMIT, StringRef::packedMaxLength());
+    StringRef::setPackedMaxLength(0);
+}
+#endif
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -50,7 +50,9 @@
  */
 
 #include "harness.h"
+#include "common/ThreadLocalPool.h"
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 using namespace std;
@@ -159,6 +161,37 @@ TEST_F(ThreadLocalPoolTest, AllocationSizingRandom)
     }
 }
 
+TEST_F(ThreadLocalPoolTest, LargeBlockAccounting)
+{
+    voltdb::ThreadLocalPool pool;
+    std::size_t hugeBefore = voltdb::ThreadLocalPool::getHugePageAllocationSize();
+    std::size_t localBefore = voltdb::ThreadLocalPool::getLocalNodeAllocationSize();
+
+    // Small blocks come from the heap and are never attributed.
+    char* small = voltdb::ThreadLocalPool::allocateLargeBlock(4096);
+    ::memset(small, 1, 4096);
+    EXPECT_EQ(hugeBefore, voltdb::ThreadLocalPool::getHugePageAllocationSize());
+    EXPECT_EQ(localBefore, voltdb::ThreadLocalPool::getLocalNodeAllocationSize());
+    voltdb::ThreadLocalPool::freeLargeBlock(small, 4096);
+
+    // Huge pages and NUMA binding depend on the host, so only check that
+    // whatever was attributed is bounded by the request and given back.
+    std::size_t sizes[3] = { voltdb::ThreadLocalPool::LARGE_BLOCK_SIZE,
+                             voltdb::ThreadLocalPool::LARGE_BLOCK_SIZE + 8,
+                             3 * voltdb::ThreadLocalPool::LARGE_BLOCK_SIZE };
+    for (int ii = 0; ii < 3; ++ii) {
+        char* block = voltdb::ThreadLocalPool::allocateLargeBlock(sizes[ii]);
+        ASSERT_TRUE(block != NULL);
+        ::memset(block, 0x5a, sizes[ii]);
+        EXPECT_EQ(0x5a, block[sizes[ii] - 1]);
+        EXPECT_TRUE(voltdb::ThreadLocalPool::getHugePageAllocationSize() - hugeBefore <= sizes[ii]);
+        EXPECT_TRUE(voltdb::ThreadLocalPool::getLocalNodeAllocationSize() - localBefore <= sizes[ii]);
+        voltdb::ThreadLocalPool::freeLargeBlock(block, sizes[ii]);
+        EXPECT_EQ(hugeBefore, voltdb::ThreadLocalPool::getHugePageAllocationSize());
+        EXPECT_EQ(localBefore, voltdb::ThreadLocalPool::getLocalNodeAllocationSize());
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -24,8 +24,11 @@
 #include "common/serializeio.h"
 #include "common/ElasticHashinator.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cstdlib>
 #include <limits>
+#include <vector>
 
 using namespace std;
 using namespace voltdb;
@@ -112,6 +115,65 @@ TEST_F(ElasticHashinatorTest, TestNValueHashToken)
     }
 }
 
+TEST_F(ElasticHashinatorTest, TestBucketedLookup)
+{
+    // Tokens spread unevenly over the ring, several to some buckets and
+    // none to others, with one at each end.
+    const int tokenCount = 1000;
+    std::vector<int32_t> tokens;
+    tokens.push_back(std::numeric_limits<int32_t>::min());
+    srand(7);
+    while (tokens.size() < tokenCount - 1) {
+        int32_t token = static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16) ^ rand());
+        if (tokens.size() % 3 == 0) {
+            token = token % 100000;
+        }
+        tokens.push_back(token);
+    }
+    tokens.push_back(std::numeric_limits<int32_t>::max());
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    boost::scoped_array<char> config(new char[4 + (8 * tokens.size())]);
+    ReferenceSerializeOutput output(config.get(), 4 + (8 * tokens.size()));
+    output.writeInt(static_cast<int32_t>(tokens.size()));
+    for (int ii = 0; ii < tokens.size(); ii++) {
+        output.writeInt(tokens[ii]);
+        output.writeInt(ii);
+    }
+    boost::scoped_ptr<TheHashinator> hashinator(ElasticHashinator::newInstance(config.get(), NULL, 0));
+
+    // Each token, either side of it, and points in between all map to the
+    // last token at or below them.
+    for (int ii = 0; ii < tokens.size(); ii++) {
+        EXPECT_EQ(ii, hashinator->partitionForToken(tokens[ii]));
+        if (tokens[ii] != std::numeric_limits<int32_t>::max()) {
+            EXPECT_EQ(ii, hashinator->partitionForToken(tokens[ii] + 1));
+        }
+        if (ii > 0 && tokens[ii - 1] != tokens[ii] - 1) {
+            EXPECT_EQ(ii - 1, hashinator->partitionForToken(tokens[ii] - 1));
+        }
+    }
+    for (int ii = 0; ii < 100000; ii++) {
+        int32_t hash = static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16) ^ rand());
+        int32_t expected = static_cast<int32_t>(
+                std::upper_bound(tokens.begin(), tokens.end(), hash) - tokens.begin()) - 1;
+        ASSERT_EQ(expected, hashinator->partitionForToken(hash));
+    }
+
+    // A batch of values maps as they do one at a time.
+    std::vector<NValue> values;
+    for (int ii = -500; ii < 500; ii++) {
+        values.push_back(ValueFactory::getBigIntValue(ii * 7919));
+    }
+    values.push_back(NValue::getNullValue(VALUE_TYPE_BIGINT));
+    std::vector<int32_t> partitions(values.size());
+    hashinator->hashinate(&values[0], static_cast<int32_t>(values.size()), &partitions[0]);
+    for (int ii = 0; ii < values.size(); ii++) {
+        EXPECT_EQ(hashinator->hashinate(values[ii]), partitions[ii]);
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
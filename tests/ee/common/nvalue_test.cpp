@@ -1951,6 +1951,56 @@ TEST_F(NValueTest, DecimalQuotients) {
    }
 }
 
+/*
+ * Decimals whose scaled values fit in 64 bits are added, subtracted,
+ * multiplied and divided natively; results must not depend on which side
+ * of that line the operands or the intermediate values fall.
+ */
+TEST_F(NValueTest, DecimalArithmeticAcrossInt64Range)
+{
+    // 9223372.036854775807 is the largest scaled value that fits in 64 bits.
+    NValue big = ValueFactory::getDecimalValueFromString("9000000");
+    NValue negativeBig = ValueFactory::getDecimalValueFromString("-9000000");
+    NValue largest = ValueFactory::getDecimalValueFromString("9223372.036854775807");
+
+    NValue result = big.op_add(big);
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("18000000")),
+              ValuePeeker::peekDecimal(result));
+    result = negativeBig.op_subtract(big);
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("-18000000")),
+              ValuePeeker::peekDecimal(result));
+    result = largest.op_add(ValueFactory::getDecimalValueFromString("0.000000000001"));
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("9223372.036854775808")),
+              ValuePeeker::peekDecimal(result));
+    result = result.op_subtract(ValueFactory::getDecimalValueFromString("0.000000000001"));
+    EXPECT_EQ(ValuePeeker::peekDecimal(largest), ValuePeeker::peekDecimal(result));
+
+    result = big.op_multiply(negativeBig);
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("-81000000000000")),
+              ValuePeeker::peekDecimal(result));
+    // The sub-scale digits of a product are truncated toward zero.
+    result = ValueFactory::getDecimalValueFromString("-0.000001").op_multiply(
+            ValueFactory::getDecimalValueFromString("0.0000015"));
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("-0.000000000001")),
+              ValuePeeker::peekDecimal(result));
+
+    result = ValueFactory::getDecimalValueFromString("-10").op_divide(
+            ValueFactory::getDecimalValueFromString("3"));
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("-3.333333333333")),
+              ValuePeeker::peekDecimal(result));
+    result = largest.op_divide(ValueFactory::getDecimalValueFromString("0.000000000001"));
+    EXPECT_EQ(ValuePeeker::peekDecimal(ValueFactory::getDecimalValueFromString("9223372036854775807")),
+              ValuePeeker::peekDecimal(result));
+
+    bool caughtException = false;
+    try {
+        big.op_divide(ValueFactory::getDecimalValueFromString("0"));
+    } catch (SQLException& ex) {
+        caughtException = true;
+    }
+    EXPECT_TRUE(caughtException);
+}
+
 TEST_F(NValueTest, SerializeToExport)
 {
     // test basic nvalue elt serialization. Note that
@@ -3577,6 +3627,43 @@ TEST_F(NValueTest, TestDateadd) {
 
 }
 
+TEST_F(NValueTest, DeserializeParameterReferencingInput)
+{
+    Pool pool;
+    char buffer[256];
+    ReferenceSerializeOutput out(buffer, sizeof(buffer));
+    out.writeByte(VALUE_TYPE_VARCHAR);
+    out.writeTextString("hello");
+    out.writeByte(VALUE_TYPE_VARBINARY);
+    out.writeInt(OBJECTLENGTH_NULL);
+    out.writeByte(VALUE_TYPE_BIGINT);
+    out.writeLong(42);
+    out.writeByte(VALUE_TYPE_VARBINARY);
+    out.writeBinaryString("\x01\x02\x03", 3);
+
+    ReferenceSerializeInputBE in(buffer, out.size());
+    NValue params[4];
+    for (int ii = 0; ii < 4; ii++) {
+        params[ii].deserializeParameterReferencingInput(in, &pool);
+    }
+
+    // The strings' bytes are left where they were serialized.
+    EXPECT_EQ(VALUE_TYPE_VARCHAR, ValuePeeker::peekValueType(params[0]));
+    EXPECT_EQ(std::string("hello"), peekStringCopy_withoutNull(params[0]));
+    EXPECT_EQ(buffer + 1 + sizeof(int32_t), ValuePeeker::peekObjectValue(params[0]));
+    EXPECT_EQ(0, params[0].compare(ValueFactory::getStringValue("hello", &pool)));
+
+    EXPECT_EQ(VALUE_TYPE_VARBINARY, ValuePeeker::peekValueType(params[1]));
+    EXPECT_TRUE(params[1].isNull());
+    EXPECT_EQ(42, ValuePeeker::peekBigInt(params[2]));
+
+    int32_t length;
+    const char* bytes = ValuePeeker::peekObject_withoutNull(params[3], &length);
+    EXPECT_EQ(3, length);
+    EXPECT_EQ(std::string("\x01\x02\x03"), std::string(bytes, length));
+    EXPECT_TRUE(bytes > buffer && bytes < buffer + sizeof(buffer));
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -51,7 +51,10 @@
 #include <limits>
 #include <string>
 #include "harness.h"
+#include "common/executorcontext.hpp"
+#include "common/Pool.hpp"
 #include "common/serializeio.h"
+#include "common/Topend.h"
 
 using namespace std;
 using namespace voltdb;
@@ -138,6 +141,55 @@ TEST(SerializeOutput, ReserveBytes) {
     EXPECT_EQ(0, memcmp(static_cast<const char*>(out.data()) + 1, &DATA, sizeof(DATA)));
 }
 
+namespace {
+// Remembers the last fallback buffer the output moved to.
+class FallbackTopend : public DummyTopend {
+public:
+    FallbackTopend() : m_buffer(NULL), m_length(0), m_fallbacks(0) {}
+    void fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
+        m_buffer = buffer;
+        m_length = length;
+        ++m_fallbacks;
+    }
+    char *m_buffer;
+    size_t m_length;
+    int m_fallbacks;
+};
+}
+
+TEST(SerializeOutput, FallbackGrowsAsNeeded) {
+    FallbackTopend topend;
+    Pool pool;
+    ExecutorContext context(0, 0, NULL, &topend, &pool, NULL, NULL, "localhost", 0, NULL, NULL, 0);
+
+    char regular[64];
+    FallbackSerializeOutput out;
+    out.initializeWithPosition(regular, sizeof(regular), 0);
+    for (int32_t ii = 0; ii < 1000; ++ii) {
+        out.writeInt(ii);
+    }
+    // Doubling from 64 bytes takes a buffer of 4096 for 4000 bytes, in
+    // six steps, each reported to the topend.
+    EXPECT_EQ(6, topend.m_fallbacks);
+    EXPECT_EQ(4096, topend.m_length);
+    EXPECT_EQ(out.data(), topend.m_buffer);
+    ASSERT_EQ(4000, out.size());
+    ReferenceSerializeInputBE in(out.data(), out.size());
+    for (int32_t ii = 0; ii < 1000; ++ii) {
+        EXPECT_EQ(ii, in.readInt());
+    }
+
+    // A result over the limit fails no matter how it grows.
+    bool threw = false;
+    try {
+        out.reserveBytes(50 * 1024 * 1024);
+    } catch (const SQLException&) {
+        threw = true;
+    }
+    EXPECT_TRUE(threw);
+    out.initializeWithPosition(regular, sizeof(regular), 0);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -24,8 +24,10 @@
 #include "harness.h"
 #include "common/tabletuple.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
 #include "common/ThreadLocalPool.h"
 #include "common/TupleSchemaBuilder.h"
+#include "common/TupleOutputStream.h"
 #include "test_utils/ScopedTupleSchema.hpp"
 
 using namespace voltdb;
@@ -156,6 +158,204 @@ TEST_F(TableTupleTest, ToJsonArray)
     nvalVisibleString.free();
 }
 
+TEST_F(TableTupleTest, FixedWidthSerialization)
+{
+    TupleSchemaBuilder builder(7, 1);
+    builder.setColumnAtIndex(0, VALUE_TYPE_TINYINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_SMALLINT);
+    builder.setColumnAtIndex(2, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(3, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(4, VALUE_TYPE_TIMESTAMP);
+    builder.setColumnAtIndex(5, VALUE_TYPE_DOUBLE);
+    builder.setColumnAtIndex(6, VALUE_TYPE_DECIMAL);
+    builder.setHiddenColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    ScopedTupleSchema schema(builder.build());
+    ASSERT_TRUE(schema->hasFixedWidthSerialization());
+
+    StandAloneTupleStorage autoStorage(schema.get());
+    const TableTuple& tuple = autoStorage.tuple();
+    tuple.setNValue(0, ValueFactory::getTinyIntValue(-7));
+    tuple.setNValue(1, ValueFactory::getSmallIntValue(1234));
+    tuple.setNValue(2, ValueFactory::getIntegerValue(-123456789));
+    tuple.setNValue(3, ValueFactory::getBigIntValue(1234567890123LL));
+    tuple.setNValue(4, ValueFactory::getTimestampValue(1466000000000000LL));
+    tuple.setNValue(5, ValueFactory::getNullValue().castAs(VALUE_TYPE_DOUBLE));
+    tuple.setNValue(6, ValueFactory::getDecimalValueFromString("-98765432109876.543210987654"));
+    tuple.setHiddenNValue(0, ValueFactory::getBigIntValue(1066));
+
+    // The tuple serializes exactly as its values do.
+    for (int includeHidden = 0; includeHidden < 2; includeHidden++) {
+        char expected[256];
+        ReferenceSerializeOutput expectedOutput(expected, sizeof(expected));
+        size_t start = expectedOutput.reserveBytes(4);
+        for (int i = 0; i < tuple.sizeInValues(); i++) {
+            tuple.getNValue(i).serializeTo(expectedOutput);
+        }
+        if (includeHidden) {
+            tuple.getHiddenNValue(0).serializeTo(expectedOutput);
+        }
+        expectedOutput.writeIntAt(start, static_cast<int32_t>(expectedOutput.size() - 4));
+
+        char actual[256];
+        ReferenceSerializeOutput actualOutput(actual, sizeof(actual));
+        tuple.serializeTo(actualOutput, includeHidden);
+        ASSERT_EQ(expectedOutput.size(), actualOutput.size());
+        EXPECT_EQ(0, memcmp(expected, actual, actualOutput.size()));
+    }
+
+    // And reads back into the same values.
+    char buffer[256];
+    ReferenceSerializeOutput output(buffer, sizeof(buffer));
+    tuple.serializeTo(output, true);
+    StandAloneTupleStorage copyStorage(schema.get());
+    TableTuple copy = copyStorage.tuple();
+    ReferenceSerializeInputBE input(buffer, output.size());
+    copy.deserializeFrom(input, NULL);
+    EXPECT_FALSE(input.hasRemaining());
+    for (int i = 0; i < tuple.sizeInValues(); i++) {
+        EXPECT_EQ(0, tuple.getNValue(i).compare(copy.getNValue(i)));
+    }
+    EXPECT_EQ(1066, ValuePeeker::peekAsBigInt(copy.getHiddenNValue(0)));
+
+    // Any other visible column type takes the general path.
+    TupleSchemaBuilder mixedBuilder(2);
+    mixedBuilder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    mixedBuilder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 16);
+    ScopedTupleSchema mixedSchema(mixedBuilder.build());
+    EXPECT_FALSE(mixedSchema->hasFixedWidthSerialization());
+}
+
+TEST_F(TableTupleTest, HashCodeMatchesValues)
+{
+    TupleSchemaBuilder builder(10);
+    builder.setColumnAtIndex(0, VALUE_TYPE_TINYINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_SMALLINT);
+    builder.setColumnAtIndex(2, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(3, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(4, VALUE_TYPE_TIMESTAMP);
+    builder.setColumnAtIndex(5, VALUE_TYPE_DOUBLE);
+    builder.setColumnAtIndex(6, VALUE_TYPE_DECIMAL);
+    builder.setColumnAtIndex(7, VALUE_TYPE_VARCHAR, 8);
+    builder.setColumnAtIndex(8, VALUE_TYPE_VARCHAR, 256);
+    builder.setColumnAtIndex(9, VALUE_TYPE_VARBINARY, 8);
+    ScopedTupleSchema schema(builder.build());
+    Pool pool;
+
+    StandAloneTupleStorage autoStorage(schema.get());
+    TableTuple tuple = autoStorage.tuple();
+    tuple.setNValue(0, ValueFactory::getTinyIntValue(-7));
+    tuple.setNValue(1, ValueFactory::getSmallIntValue(1234));
+    tuple.setNValue(2, ValueFactory::getIntegerValue(-123456789));
+    tuple.setNValue(3, ValueFactory::getBigIntValue(1234567890123LL));
+    tuple.setNValue(4, ValueFactory::getTimestampValue(1466000000000000LL));
+    tuple.setNValue(5, ValueFactory::getDoubleValue(-2.5));
+    tuple.setNValue(6, ValueFactory::getDecimalValueFromString("-98765432109876.543210987654"));
+    tuple.setNValue(7, ValueFactory::getStringValue("short", &pool));
+    tuple.setNValue(8, ValueFactory::getStringValue("not inlined", &pool));
+    tuple.setNValue(9, ValueFactory::getBinaryValue("CAFE", &pool));
+
+    // Every column type hashes as its value does, null or not.
+    for (int withNulls = 0; withNulls < 2; withNulls++) {
+        if (withNulls) {
+            tuple.setAllNulls();
+        }
+        std::size_t expected = 17;
+        for (int i = 0; i < tuple.sizeInValues(); i++) {
+            tuple.getNValue(i).hashCombine(expected);
+        }
+        EXPECT_EQ(expected, tuple.hashCode(17));
+    }
+
+    // Columns joined from other schemas keep their hashers.
+    TupleSchemaBuilder pairBuilder(2);
+    pairBuilder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    pairBuilder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256);
+    ScopedTupleSchema pair(pairBuilder.build());
+    ScopedTupleSchema joined(TupleSchema::createTupleSchema(pair.get(), pair.get()));
+    StandAloneTupleStorage joinedStorage(joined.get());
+    TableTuple joinedTuple = joinedStorage.tuple();
+    joinedTuple.setNValue(0, ValueFactory::getBigIntValue(42));
+    joinedTuple.setNValue(1, ValueFactory::getStringValue("not inlined", &pool));
+    joinedTuple.setNValue(2, ValueFactory::getBigIntValue(-42));
+    joinedTuple.setNValue(3, ValueFactory::getNullStringValue());
+    std::size_t expected = 0;
+    for (int i = 0; i < joinedTuple.sizeInValues(); i++) {
+        joinedTuple.getNValue(i).hashCombine(expected);
+    }
+    EXPECT_EQ(expected, joinedTuple.hashCode());
+}
+
+TEST_F(TableTupleTest, TextRowFormats)
+{
+    TupleSchemaBuilder builder(7, 1);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(2, VALUE_TYPE_DOUBLE);
+    builder.setColumnAtIndex(3, VALUE_TYPE_DECIMAL);
+    builder.setColumnAtIndex(4, VALUE_TYPE_VARCHAR, 12);
+    builder.setColumnAtIndex(5, VALUE_TYPE_VARBINARY, 8);
+    builder.setColumnAtIndex(6, VALUE_TYPE_TIMESTAMP);
+    builder.setHiddenColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    ScopedTupleSchema schema(builder.build());
+
+    StandAloneTupleStorage firstStorage(schema.get());
+    const TableTuple& first = firstStorage.tuple();
+    const unsigned char bytes[] = { 0xab, 0x01 };
+    NValue firstString = ValueFactory::getStringValue("say \"hi\"");
+    NValue firstBinary = ValueFactory::getBinaryValue(bytes, 2);
+    first.setNValue(0, ValueFactory::getIntegerValue(42));
+    first.setNValue(1, NValue::getNullValue(VALUE_TYPE_BIGINT));
+    first.setNValue(2, ValueFactory::getDoubleValue(0.1));
+    first.setNValue(3, ValueFactory::getDecimalValueFromString("3.5"));
+    first.setNValue(4, firstString);
+    first.setNValue(5, firstBinary);
+    first.setNValue(6, ValueFactory::getTimestampValue(0));
+    first.setHiddenNValue(0, ValueFactory::getBigIntValue(1066));
+
+    StandAloneTupleStorage secondStorage(schema.get());
+    const TableTuple& second = secondStorage.tuple();
+    NValue secondString = ValueFactory::getStringValue("a\\b\nc");
+    NValue secondBinary = ValueFactory::getBinaryValue(bytes, 0);
+    second.setNValue(0, ValueFactory::getIntegerValue(-7));
+    second.setNValue(1, ValueFactory::getBigIntValue(9000000000LL));
+    second.setNValue(2, ValueFactory::getDoubleValue(12345678.9));
+    second.setNValue(3, ValueFactory::getDecimalValueFromString("-0.0000001"));
+    second.setNValue(4, secondString);
+    second.setNValue(5, secondBinary);
+    second.setNValue(6, ValueFactory::getTimestampValue(-1));
+    second.setHiddenNValue(0, ValueFactory::getBigIntValue(1066));
+
+    // Only the visible columns are written, as the Java CSV writers do.
+    char buffer[1024];
+    TupleOutputStream csv(buffer, sizeof(buffer));
+    csv.setRowFormat(TupleOutputStream::ROW_FORMAT_CSV,
+                     TupleOutputStream::getMaxTextRowLength(*schema.get()));
+    std::size_t written = csv.writeRow(first);
+    EXPECT_EQ(string("\"42\",\"\\N\",\"0.1\",\"3.500000000000\",\"say \"\"hi\"\"\",\"AB01\","
+                     "\"1970-01-01 00:00:00.000000\"\n"),
+              string(buffer, csv.size()));
+    EXPECT_TRUE(written <= csv.getMaxRowLength());
+
+    TupleOutputStream tsv(buffer, sizeof(buffer));
+    tsv.setRowFormat(TupleOutputStream::ROW_FORMAT_TSV,
+                     TupleOutputStream::getMaxTextRowLength(*schema.get()));
+    tsv.writeRow(second);
+    EXPECT_EQ(string("-7\t9000000000\t1.23456789E7\t-1.00000E-7\ta\\\\b\\\nc\t\t"
+                     "1969-12-31 23:59:59.999999\n"),
+              string(buffer, tsv.size()));
+    EXPECT_EQ(1, tsv.getSerializedRowCount());
+
+    TupleOutputStream::RowFormat format;
+    EXPECT_TRUE(TupleOutputStream::parseRowFormat("TSV", format));
+    EXPECT_EQ(TupleOutputStream::ROW_FORMAT_TSV, format);
+    EXPECT_FALSE(TupleOutputStream::parseRowFormat("JSON", format));
+
+    firstString.free();
+    firstBinary.free();
+    secondString.free();
+    secondBinary.free();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
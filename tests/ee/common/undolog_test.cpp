@@ -208,6 +208,35 @@ TEST_F(UndoLogTest, TestOneQuantumThreeActionReleaseOrdering) {
     confirmReleaseActionHistoryOrder(histories, startingIndex);
 }
 
+/*
+ * Enough actions to fill several of the blocks a quantum lists them in.
+ */
+TEST_F(UndoLogTest, TestOneQuantumManyActionUndoOrdering) {
+    std::vector<int64_t> undoTokens = generateQuantumsAndActions( 1, 200);
+    ASSERT_EQ( 1, undoTokens.size());
+
+    m_undoLog->undo(undoTokens[0]);
+    std::vector<MockUndoActionHistory*> histories = m_undoActionHistoryByQuantum[0];
+    int startingIndex = 0;
+    confirmUndoneActionHistoryOrder(histories, startingIndex);
+    ASSERT_EQ(200, startingIndex);
+}
+
+TEST_F(UndoLogTest, TestOneQuantumManyActionReleaseOrdering) {
+    std::vector<int64_t> undoTokens = generateQuantumsAndActions( 1, 200);
+    ASSERT_EQ( 1, undoTokens.size());
+
+    ASSERT_EQ(0, m_undoLog->getPeakQuantumSize());
+    m_undoLog->release(undoTokens[0]);
+    std::vector<MockUndoActionHistory*> histories = m_undoActionHistoryByQuantum[0];
+    int startingIndex = 0;
+    confirmReleaseActionHistoryOrder(histories, startingIndex);
+    ASSERT_EQ(200, startingIndex);
+    ASSERT_TRUE(m_undoLog->getPeakQuantumSize() > 0);
+    m_undoLog->resetPeakQuantumSize();
+    ASSERT_EQ(0, m_undoLog->getPeakQuantumSize());
+}
+
 /*
  * Now do the same for three quantums.
  */
@@ -58,9 +58,13 @@
 #include "catalog/table.h"
 #include "common/tabletuple.h"
 #include "common/valuevector.h"
+#include "executors/ExecutorStats.h"
+#include "indexes/IndexUsageStats.h"
 #include "expressions/abstractexpression.h"
 #include "indexes/tableindex.h"
 #include "plannodes/abstractplannode.h"
+#include "stats/LatencyStats.h"
+#include "stats/StackSampler.h"
 #include "storage/persistenttable.h"
 #include "storage/tablefactory.h"
 #include "storage/tableiterator.h"
@@ -72,7 +76,11 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <map>
+#include <set>
+#include <sstream>
 #include <unistd.h>
+#include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
 
 #define NUM_OF_COLUMNS 4
@@ -586,6 +594,563 @@ TEST_F(ExecutionEngineTest, Execute_PlanFragmentInfo) {
     }
 }
 
+TEST_F(ExecutionEngineTest, Execute_TransactionBatch) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentIds[] = { 100, 100 };
+
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    voltdb::ReferenceSerializeInputBE singleParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, fragmentIds, NULL, singleParams, 1000, 1000, 1000, 1000, 1));
+    const int singleSize = m_engine->getResultsSize();
+    boost::scoped_array<char> single(new char[singleSize]);
+    memcpy(single.get(), m_result_buffer.get(), singleSize);
+
+    // Two transactions of one fragment each, under their own undo tokens,
+    // leave a result section each, the same as the one above.
+    const int64_t transactionInfo[] = { 1, 1001, 1001, 1000, 1001, 2,
+                                        1, 1002, 1002, 1001, 1002, 3 };
+    voltdb::ReferenceSerializeInputBE batchParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(2, m_engine->executeTransactionBatch(2, transactionInfo, fragmentIds, batchParams));
+    ASSERT_EQ(2 * singleSize, m_engine->getResultsSize());
+    EXPECT_EQ(0, memcmp(single.get(), m_result_buffer.get(), singleSize));
+    EXPECT_EQ(0, memcmp(single.get(), m_result_buffer.get() + singleSize, singleSize));
+}
+
+/*
+ * Load the plan node stats table that getStats left in the result
+ * buffer, after the length of the results and the table's size.
+ */
+static voltdb::TempTable* loadPlanNodeStats(const char* buffer, size_t size, voltdb::Pool* pool) {
+    voltdb::TempTable* stats = voltdb::ExecutorStats::generateEmptyExecutorStatsTable();
+    voltdb::ReferenceSerializeInputBE input(buffer + 2 * sizeof(int32_t), size - 2 * sizeof(int32_t));
+    stats->loadTuplesFrom(input, pool);
+    return stats;
+}
+
+TEST_F(ExecutionEngineTest, Execute_PlanNodeStats) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentId = 100;
+
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    for (int ii = 0; ii < 2; ii++) {
+        voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+        m_engine->resetReusedResultOutputBuffer();
+        ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+    }
+
+    // After the five base stats columns come the fragment id, plan node
+    // id and type, invocations, nanoseconds, tuples in and out, and the
+    // largest output temp table.
+    voltdb::Pool pool;
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_PLANNODE, NULL, 0, true, 0));
+    boost::scoped_ptr<voltdb::TempTable> stats(
+        loadPlanNodeStats(m_result_buffer.get(), m_engine->getResultsSize(), &pool));
+    // The index scan and the send; the projection is inlined.
+    ASSERT_EQ(2, stats->activeTupleCount());
+    voltdb::TableTuple tuple(stats->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(stats->makeIterator());
+    int64_t scanTuplesOut = -1;
+    int64_t sendTuplesIn = -1;
+    while (iter->next(tuple)) {
+        EXPECT_EQ(100, voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(5)));
+        EXPECT_EQ(2, voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(8)));
+        EXPECT_TRUE(voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(9)) >= 0);
+        int32_t length;
+        const char* type = voltdb::ValuePeeker::peekObject_withoutNull(tuple.getNValue(7), &length);
+        if (std::string(type, length) == "INDEXSCAN") {
+            scanTuplesOut = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(11));
+        }
+        else if (std::string(type, length) == "SEND") {
+            sendTuplesIn = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(10));
+        }
+    }
+    EXPECT_TRUE(scanTuplesOut >= 0);
+    EXPECT_EQ(scanTuplesOut, sendTuplesIn);
+
+    // Nothing ran since the last interval.
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_PLANNODE, NULL, 0, true, 0));
+    stats.reset(loadPlanNodeStats(m_result_buffer.get(), m_engine->getResultsSize(), &pool));
+    ASSERT_EQ(2, stats->activeTupleCount());
+    voltdb::TableTuple intervalTuple(stats->schema());
+    iter.reset(stats->makeIterator());
+    while (iter->next(intervalTuple)) {
+        EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(intervalTuple.getNValue(8)));
+    }
+}
+
+TEST_F(ExecutionEngineTest, Execute_SlowFragmentLog) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentId = 100;
+
+    // Every fragment is slow; logging it must not disturb its results.
+    m_engine->getLogManager()->setLogLevels(static_cast<int64_t>(voltdb::LOGLEVEL_INFO) << 3);
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    voltdb::ReferenceSerializeInputBE quietParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, quietParams, 1000, 1000, 1000, 1000, 1));
+    const int quietSize = m_engine->getResultsSize();
+    boost::scoped_array<char> quiet(new char[quietSize]);
+    memcpy(quiet.get(), m_result_buffer.get(), quietSize);
+
+    for (int redact = 0; redact < 2; redact++) {
+        m_engine->setSlowFragmentThreshold(1, redact == 1);
+        voltdb::ReferenceSerializeInputBE params(m_parameter_buffer.get(), 4 * 1024);
+        m_engine->resetReusedResultOutputBuffer();
+        ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, params, 1000, 1000, 1000, 1000, 2 + redact));
+        ASSERT_EQ(quietSize, m_engine->getResultsSize());
+        EXPECT_EQ(0, memcmp(quiet.get(), m_result_buffer.get(), quietSize));
+    }
+    m_engine->setSlowFragmentThreshold(0, false);
+}
+
+// Spin on the CPU in a function of its own, so the stack samples have a known
+// frame. Not static, so that -rdynamic exports its name to dladdr().
+__attribute__((noinline)) int64_t stackSamplerBurnCpu(int64_t nanos) {
+    const int64_t end = voltdb::ExecutorStats::nowNanos() + nanos;
+    int64_t sum = 0;
+    while (voltdb::ExecutorStats::nowNanos() < end) {
+        for (int i = 0; i < 1000; ++i) {
+            sum += i * i;
+        }
+    }
+    return sum;
+}
+
+TEST_F(ExecutionEngineTest, StackSampler) {
+#ifdef __linux__
+    voltdb::StackSampler sampler;
+    sampler.start(200);
+    volatile int64_t sum = stackSamplerBurnCpu(500 * 1000 * 1000);
+    (void)sum;
+    std::string folded = sampler.takeFoldedStacks();
+
+    // Each line is a stack and its count; the sampled frames are in the test binary
+    int64_t samples = 0;
+    size_t lineStart = 0;
+    while (lineStart < folded.size()) {
+        size_t lineEnd = folded.find('\n', lineStart);
+        ASSERT_NE(std::string::npos, lineEnd);
+        size_t space = folded.rfind(' ', lineEnd);
+        ASSERT_NE(std::string::npos, space);
+        ASSERT_GT(space, lineStart);
+        samples += atoll(folded.c_str() + space + 1);
+        lineStart = lineEnd + 1;
+    }
+    EXPECT_GT(samples, 0);
+    EXPECT_NE(std::string::npos, folded.find("stackSamplerBurnCpu"));
+
+    // Paused, the sampler takes nothing more
+    voltdb::StackSampler::setRate(0);
+    sampler.takeFoldedStacks();
+    sum = stackSamplerBurnCpu(100 * 1000 * 1000);
+    EXPECT_EQ(std::string::npos, sampler.takeFoldedStacks().find("stackSamplerBurnCpu"));
+#endif
+}
+
+TEST_F(ExecutionEngineTest, Execute_LatencyStats) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentId = 100;
+
+    // Time every fragment.
+    m_engine->setLatencySampleInterval(1);
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    for (int ii = 0; ii < 2; ii++) {
+        voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+        m_engine->resetReusedResultOutputBuffer();
+        ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+    }
+
+    // After the five base stats columns come the point, the samples, and
+    // the min, percentiles and max in nanoseconds.
+    voltdb::Pool pool;
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_LATENCY, NULL, 0, true, 0));
+    boost::scoped_ptr<voltdb::TempTable> stats(voltdb::LatencyStats::generateEmptyLatencyStatsTable());
+    voltdb::ReferenceSerializeInputBE input(m_result_buffer.get() + 2 * sizeof(int32_t),
+                                            m_engine->getResultsSize() - 2 * sizeof(int32_t));
+    stats->loadTuplesFrom(input, &pool);
+    ASSERT_EQ(voltdb::LATENCY_POINT_COUNT, stats->activeTupleCount());
+    voltdb::TableTuple tuple(stats->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(stats->makeIterator());
+    bool sawFragment = false;
+    while (iter->next(tuple)) {
+        int32_t length;
+        const char* point = voltdb::ValuePeeker::peekObject_withoutNull(tuple.getNValue(5), &length);
+        if (std::string(point, length) != "FRAGMENT") {
+            continue;
+        }
+        sawFragment = true;
+        EXPECT_EQ(2, voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(6)));
+        int64_t min = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(7));
+        int64_t median = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(8));
+        int64_t max = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(12));
+        EXPECT_TRUE(min > 0);
+        EXPECT_TRUE(min <= median);
+        EXPECT_TRUE(median <= max);
+    }
+    EXPECT_TRUE(sawFragment);
+
+    // With sampling off, nothing more is recorded.
+    m_engine->setLatencySampleInterval(0);
+    voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_LATENCY, NULL, 0, true, 0));
+    stats.reset(voltdb::LatencyStats::generateEmptyLatencyStatsTable());
+    voltdb::ReferenceSerializeInputBE intervalInput(m_result_buffer.get() + 2 * sizeof(int32_t),
+                                                    m_engine->getResultsSize() - 2 * sizeof(int32_t));
+    stats->loadTuplesFrom(intervalInput, &pool);
+    voltdb::TableTuple intervalTuple(stats->schema());
+    iter.reset(stats->makeIterator());
+    while (iter->next(intervalTuple)) {
+        EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(intervalTuple.getNValue(6)));
+    }
+}
+
+TEST_F(ExecutionEngineTest, Execute_IndexUsageStats) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentId = 100;
+
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    for (int ii = 0; ii < 2; ii++) {
+        voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+        m_engine->resetReusedResultOutputBuffer();
+        ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+    }
+
+    // After the five base stats columns come the table and index names,
+    // the lookups, range scans and sequential scans, the rows they
+    // returned, and the entries inserted, deleted and updated.
+    voltdb::Table* customers = m_engine->getTable("R_CUSTOMER");
+    ASSERT_NE(NULL, customers);
+    int locator = m_database->tables().get("R_CUSTOMER")->relativeIndex();
+    voltdb::Pool pool;
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_INDEXUSAGE, &locator, 1, true, 0));
+    boost::scoped_ptr<voltdb::TempTable> stats(voltdb::IndexUsageStats::generateEmptyIndexUsageStatsTable());
+    voltdb::ReferenceSerializeInputBE input(m_result_buffer.get() + 2 * sizeof(int32_t),
+                                            m_engine->getResultsSize() - 2 * sizeof(int32_t));
+    stats->loadTuplesFrom(input, &pool);
+    // The table's sequential scans, and each of its four indexes.
+    ASSERT_EQ(5, stats->activeTupleCount());
+    voltdb::TableTuple tuple(stats->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(stats->makeIterator());
+    bool sawIndex = false;
+    while (iter->next(tuple)) {
+        int64_t rangeScans = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(8));
+        if (tuple.getNValue(6).isNull()) {
+            EXPECT_EQ(0, rangeScans);
+            EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(9)));
+            continue;
+        }
+        // Every index was filled when the table was loaded.
+        EXPECT_EQ(customers->activeTupleCount(), voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(11)));
+        EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(7)));
+        int32_t length;
+        const char* name = voltdb::ValuePeeker::peekObject_withoutNull(tuple.getNValue(6), &length);
+        if (std::string(name, length) != "VOLTDB_AUTOGEN_IDX_PK_R_CUSTOMER_R_CUSTOMERID") {
+            EXPECT_EQ(0, rangeScans);
+            continue;
+        }
+        // The plan's GTE scan is a range scan.
+        sawIndex = true;
+        EXPECT_EQ(2, rangeScans);
+        EXPECT_TRUE(voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(10)) >= 0);
+    }
+    EXPECT_TRUE(sawIndex);
+}
+
+namespace {
+// SELECT SUM(R_CUSTOMERID), COUNT(*), MIN(R_CUSTOMERID), MAX(R_CUSTOMERID),
+//        COUNT(R_CUSTOMERID) FROM R_CUSTOMER;
+std::string aggregatePlan =
+        "{\n"
+        "    \"EXECUTE_LIST\": [2, 1],\n"
+        "    \"PLAN_NODES\": [\n"
+        "        {\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"},\n"
+        "        {\n"
+        "            \"ID\": 2,\n"
+        "            \"INLINE_NODES\": [{\n"
+        "                \"ID\": 3,\n"
+        "                \"PLAN_NODE_TYPE\": \"AGGREGATE\",\n"
+        "                \"AGGREGATE_COLUMNS\": [\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_SUM\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 0, \"AGGREGATE_EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT_STAR\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 1},\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_MIN\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 2, \"AGGREGATE_EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_MAX\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 3, \"AGGREGATE_EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 4, \"AGGREGATE_EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}\n"
+        "                ],\n"
+        "                \"OUTPUT_SCHEMA\": [\n"
+        "                {\"COLUMN_NAME\": \"S\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 6}},\n"
+        "                {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 6}},\n"
+        "                {\"COLUMN_NAME\": \"N\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"X\", \"EXPRESSION\": {\"COLUMN_IDX\": 3, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"CS\", \"EXPRESSION\": {\"COLUMN_IDX\": 4, \"TYPE\": 32, \"VALUE_TYPE\": 6}}\n"
+        "                ]\n"
+        "            }],\n"
+        "            \"OUTPUT_SCHEMA\": [\n"
+        "                {\"COLUMN_NAME\": \"S\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 6}},\n"
+        "                {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 6}},\n"
+        "                {\"COLUMN_NAME\": \"N\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"X\", \"EXPRESSION\": {\"COLUMN_IDX\": 3, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"CS\", \"EXPRESSION\": {\"COLUMN_IDX\": 4, \"TYPE\": 32, \"VALUE_TYPE\": 6}}\n"
+        "            ],\n"
+        "            \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "            \"TARGET_TABLE_ALIAS\": \"R_CUSTOMER\",\n"
+        "            \"TARGET_TABLE_NAME\": \"R_CUSTOMER\"\n"
+        "        }\n"
+        "    ]\n"
+        "}\n";
+}
+
+TEST_F(ExecutionEngineTest, Execute_InlineAggregatesOfFixedWidthColumn) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, aggregatePlan);
+    fragmentId_t fragmentId = 100;
+
+    int64_t sum = 0;
+    int64_t count = 0;
+    int64_t min = INT64_MAX;
+    int64_t max = INT64_MIN;
+    voltdb::TableTuple tuple(m_replicated_customer_table->schema());
+    voltdb::TableIterator rows = m_replicated_customer_table->iterator();
+    while (rows.next(tuple)) {
+        int64_t id = voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(0));
+        sum += id;
+        count++;
+        min = std::min(min, id);
+        max = std::max(max, id);
+    }
+
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+
+    boost::scoped_ptr<voltdb::TempTable> result(voltdb::loadTableFrom(m_result_buffer.get(),
+                                                                      m_engine->getResultsSize()));
+    ASSERT_TRUE(result != NULL);
+    ASSERT_EQ(1, result->activeTupleCount());
+    voltdb::TableTuple row(result->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(result->makeIterator());
+    ASSERT_TRUE(iter->next(row));
+    EXPECT_EQ(sum, voltdb::ValuePeeker::peekAsBigInt(row.getNValue(0)));
+    EXPECT_EQ(m_replicated_customer_table->activeTupleCount(),
+              voltdb::ValuePeeker::peekAsBigInt(row.getNValue(1)));
+    EXPECT_EQ(min, voltdb::ValuePeeker::peekAsBigInt(row.getNValue(2)));
+    EXPECT_EQ(max, voltdb::ValuePeeker::peekAsBigInt(row.getNValue(3)));
+    EXPECT_EQ(count, voltdb::ValuePeeker::peekAsBigInt(row.getNValue(4)));
+}
+
+namespace {
+// SELECT R_ZIPCODE, R_CUSTOMERID, COUNT(*) FROM R_CUSTOMER
+//     GROUP BY ROLLUP(R_ZIPCODE, R_CUSTOMERID);
+std::string rollupPlan =
+        "{\n"
+        "    \"EXECUTE_LIST\": [3, 2, 1],\n"
+        "    \"PLAN_NODES\": [\n"
+        "        {\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"},\n"
+        "        {\n"
+        "            \"CHILDREN_IDS\": [3],\n"
+        "            \"ID\": 2,\n"
+        "            \"PLAN_NODE_TYPE\": \"HASHAGGREGATE\",\n"
+        "            \"AGGREGATE_COLUMNS\": [\n"
+        "                {\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT_STAR\", \"AGGREGATE_DISTINCT\": 0, \"AGGREGATE_OUTPUT_COLUMN\": 2}\n"
+        "            ],\n"
+        "            \"GROUPBY_EXPRESSIONS\": [{\"COLUMN_IDX\": 3, \"TYPE\": 32, \"VALUE_TYPE\": 5}, {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}],\n"
+        "            \"GROUPING_SETS\": [\n"
+        "                {\"GROUPBY_COLUMNS\": [0, 1], \"NULL_COLUMNS\": []},\n"
+        "                {\"GROUPBY_COLUMNS\": [0], \"NULL_COLUMNS\": [1]},\n"
+        "                {\"GROUPBY_COLUMNS\": [], \"NULL_COLUMNS\": [0, 1]}\n"
+        "            ],\n"
+        "            \"OUTPUT_SCHEMA\": [\n"
+        "                {\"COLUMN_NAME\": \"R_ZIPCODE\", \"EXPRESSION\": {\"COLUMN_IDX\": 3, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"R_CUSTOMERID\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}},\n"
+        "                {\"COLUMN_NAME\": \"C\", \"EXPRESSION\": {\"COLUMN_IDX\": 2, \"TYPE\": 32, \"VALUE_TYPE\": 6}}\n"
+        "            ]\n"
+        "        },\n"
+        "        {\n"
+        "            \"ID\": 3,\n"
+        "            \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "            \"TARGET_TABLE_ALIAS\": \"R_CUSTOMER\",\n"
+        "            \"TARGET_TABLE_NAME\": \"R_CUSTOMER\"\n"
+        "        }\n"
+        "    ]\n"
+        "}\n";
+}
+
+TEST_F(ExecutionEngineTest, Execute_RollupInOnePass) {
+    initialize(catalog_string, random_seed);
+    m_topend->addPlan(100, rollupPlan);
+    fragmentId_t fragmentId = 100;
+
+    std::map<int64_t, int64_t> zipCounts;
+    int64_t total = 0;
+    voltdb::TableTuple tuple(m_replicated_customer_table->schema());
+    voltdb::TableIterator rows = m_replicated_customer_table->iterator();
+    while (rows.next(tuple)) {
+        zipCounts[voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(3))]++;
+        total++;
+    }
+
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+
+    boost::scoped_ptr<voltdb::TempTable> result(voltdb::loadTableFrom(m_result_buffer.get(),
+                                                                      m_engine->getResultsSize()));
+    ASSERT_TRUE(result != NULL);
+    // A row for each customer, each zip code, and the grand total.
+    ASSERT_EQ(total + zipCounts.size() + 1, result->activeTupleCount());
+    int64_t customerRows = 0;
+    int64_t zipRows = 0;
+    int64_t totalRows = 0;
+    voltdb::TableTuple row(result->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(result->makeIterator());
+    while (iter->next(row)) {
+        int64_t count = voltdb::ValuePeeker::peekAsBigInt(row.getNValue(2));
+        if (row.getNValue(0).isNull()) {
+            EXPECT_TRUE(row.getNValue(1).isNull());
+            EXPECT_EQ(total, count);
+            totalRows++;
+        }
+        else if (row.getNValue(1).isNull()) {
+            EXPECT_EQ(zipCounts[voltdb::ValuePeeker::peekAsBigInt(row.getNValue(0))], count);
+            zipRows++;
+        }
+        else {
+            EXPECT_EQ(1, count);
+            customerRows++;
+        }
+    }
+    EXPECT_EQ(total, customerRows);
+    EXPECT_EQ(zipCounts.size(), zipRows);
+    EXPECT_EQ(1, totalRows);
+}
+
+namespace {
+// SELECT R_CUSTOMERID FROM R_CUSTOMER
+// WHERE R_CUSTOMERID = ? OR R_CUSTOMERID = ? OR R_CUSTOMERID = ? OR R_CUSTOMERID = ?;
+std::string customerIdEquals(int32_t customerId) {
+    std::ostringstream buffer;
+    buffer << "{\"TYPE\": 10, \"VALUE_TYPE\": 23, "
+           << "\"LEFT\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}, "
+           << "\"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": " << customerId << "}}";
+    return buffer.str();
+}
+
+std::string indexUnionPlan(const std::vector<int32_t>& customerIds) {
+    std::string predicate = customerIdEquals(customerIds[0]);
+    for (size_t ii = 1; ii < customerIds.size(); ii++) {
+        predicate = "{\"TYPE\": 21, \"VALUE_TYPE\": 23, \"LEFT\": " + predicate +
+            ", \"RIGHT\": " + customerIdEquals(customerIds[ii]) + "}";
+    }
+    return
+        "{\n"
+        "    \"EXECUTE_LIST\": [2, 1],\n"
+        "    \"PLAN_NODES\": [\n"
+        "        {\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"},\n"
+        "        {\n"
+        "            \"ID\": 2,\n"
+        "            \"INLINE_NODES\": [{\n"
+        "                \"ID\": 3,\n"
+        "                \"PLAN_NODE_TYPE\": \"PROJECTION\",\n"
+        "                \"OUTPUT_SCHEMA\": [\n"
+        "                {\"COLUMN_NAME\": \"R_CUSTOMERID\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}\n"
+        "                ]\n"
+        "            }],\n"
+        "            \"OUTPUT_SCHEMA\": [\n"
+        "                {\"COLUMN_NAME\": \"R_CUSTOMERID\", \"EXPRESSION\": {\"COLUMN_IDX\": 0, \"TYPE\": 32, \"VALUE_TYPE\": 5}}\n"
+        "            ],\n"
+        "            \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "            \"PREDICATE\": " + predicate + ",\n"
+        "            \"TARGET_TABLE_ALIAS\": \"R_CUSTOMER\",\n"
+        "            \"TARGET_TABLE_NAME\": \"R_CUSTOMER\"\n"
+        "        }\n"
+        "    ]\n"
+        "}\n";
+}
+}
+
+TEST_F(ExecutionEngineTest, Execute_IndexUnionForDisjunction) {
+    initialize(catalog_string, random_seed);
+    // Enough customers that looking a few up beats scanning them all.
+    ASSERT_TRUE(voltdb::tableutil::addRandomTuples(m_replicated_customer_table, 200));
+
+    std::set<int32_t> allIds;
+    voltdb::TableTuple tuple(m_replicated_customer_table->schema());
+    voltdb::TableIterator rows = m_replicated_customer_table->iterator();
+    while (rows.next(tuple)) {
+        allIds.insert(voltdb::ValuePeeker::peekInteger(tuple.getNValue(0)));
+    }
+    ASSERT_TRUE(allIds.size() > 2);
+
+    // Two customers, one of them asked for twice, and one who isn't there.
+    std::vector<int32_t> customerIds;
+    customerIds.push_back(*allIds.begin());
+    customerIds.push_back(*allIds.rbegin());
+    customerIds.push_back(*allIds.begin());
+    std::set<int32_t> expected(customerIds.begin(), customerIds.end());
+    int32_t missing = *allIds.begin() - 1;
+    customerIds.push_back(missing);
+
+    m_topend->addPlan(100, indexUnionPlan(customerIds));
+    fragmentId_t fragmentId = 100;
+    memset(m_parameter_buffer.get(), 0, 4 * 1024);
+    voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(0, m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1));
+
+    // Each customer comes back once.
+    boost::scoped_ptr<voltdb::TempTable> result(voltdb::loadTableFrom(m_result_buffer.get(),
+                                                                      m_engine->getResultsSize()));
+    ASSERT_TRUE(result != NULL);
+    ASSERT_EQ(2, result->activeTupleCount());
+    voltdb::TableTuple row(result->schema());
+    boost::scoped_ptr<voltdb::TableIterator> iter(result->makeIterator());
+    while (iter->next(row)) {
+        EXPECT_EQ(1, expected.erase(voltdb::ValuePeeker::peekInteger(row.getNValue(0))));
+    }
+
+    // The primary key index was looked up for each equality and the table
+    // was not scanned.
+    int locator = m_database->tables().get("R_CUSTOMER")->relativeIndex();
+    voltdb::Pool pool;
+    m_engine->resetReusedResultOutputBuffer();
+    ASSERT_EQ(1, m_engine->getStats(voltdb::STATISTICS_SELECTOR_TYPE_INDEXUSAGE, &locator, 1, true, 0));
+    boost::scoped_ptr<voltdb::TempTable> stats(voltdb::IndexUsageStats::generateEmptyIndexUsageStatsTable());
+    voltdb::ReferenceSerializeInputBE input(m_result_buffer.get() + 2 * sizeof(int32_t),
+                                            m_engine->getResultsSize() - 2 * sizeof(int32_t));
+    stats->loadTuplesFrom(input, &pool);
+    voltdb::TableTuple stat(stats->schema());
+    boost::scoped_ptr<voltdb::TableIterator> statIter(stats->makeIterator());
+    bool sawIndex = false;
+    while (statIter->next(stat)) {
+        if (stat.getNValue(6).isNull()) {
+            EXPECT_EQ(0, voltdb::ValuePeeker::peekAsBigInt(stat.getNValue(9)));
+            continue;
+        }
+        int32_t length;
+        const char* name = voltdb::ValuePeeker::peekObject_withoutNull(stat.getNValue(6), &length);
+        if (std::string(name, length) == "VOLTDB_AUTOGEN_IDX_PK_R_CUSTOMER_R_CUSTOMERID") {
+            sawIndex = true;
+            EXPECT_EQ(4, voltdb::ValuePeeker::peekAsBigInt(stat.getNValue(7)));
+        }
+    }
+    EXPECT_TRUE(sawIndex);
+}
+
 int main() {
      return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,183 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "harness.h"
+
+#include "common/NValue.hpp"
+#include "common/Pool.hpp"
+#include "common/ThreadLocalPool.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "executors/aggregatehashtable.h"
+
+#include <sstream>
+#include <vector>
+
+using namespace voltdb;
+
+class AggregateHashTableTest : public Test {
+public:
+    AggregateHashTableTest() : m_schema(NULL) { }
+
+    ~AggregateHashTableTest() {
+        TupleSchema::freeTupleSchema(m_schema);
+    }
+
+protected:
+    void initSchema(const std::vector<ValueType>& types, const std::vector<int32_t>& lengths) {
+        std::vector<bool> allowNull(types.size(), true);
+        m_schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+        m_table.init(m_schema);
+    }
+
+    TableTuple newKey() {
+        char* storage = static_cast<char*>(m_pool.allocateZeroes(m_schema->tupleLength() + TUPLE_HEADER_SIZE));
+        return TableTuple(storage, m_schema);
+    }
+
+    // Stands in for a group's AggregateRow, which the table never touches.
+    static AggregateRow* row(int64_t group) {
+        return reinterpret_cast<AggregateRow*>(group + 1);
+    }
+
+    ThreadLocalPool m_threadLocalPool;
+    TupleSchema* m_schema;
+    Pool m_pool;
+    AggregateHashTable m_table;
+};
+
+TEST_F(AggregateHashTableTest, IntegerKeys) {
+    std::vector<ValueType> types;
+    types.push_back(VALUE_TYPE_BIGINT);
+    types.push_back(VALUE_TYPE_INTEGER);
+    std::vector<int32_t> lengths;
+    lengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    lengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+    initSchema(types, lengths);
+    EXPECT_FALSE(m_table.keepsKeyTuples());
+
+    // Raw keys are copied, so one key tuple serves every probe.
+    TableTuple key = newKey();
+    const int64_t groups = 5000;
+    for (int64_t ii = 0; ii < groups; ii++) {
+        key.setNValue(0, ValueFactory::getBigIntValue(ii / 10));
+        key.setNValue(1, ii % 10 == 0 ? NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                         ValueFactory::getIntegerValue(static_cast<int32_t>(ii % 10)));
+        size_t hash;
+        EXPECT_TRUE(m_table.find(key, hash) == NULL);
+        m_table.insert(key, hash, row(ii));
+    }
+    EXPECT_EQ(groups, m_table.size());
+
+    for (int64_t ii = 0; ii < groups; ii++) {
+        key.setNValue(0, ValueFactory::getBigIntValue(ii / 10));
+        key.setNValue(1, ii % 10 == 0 ? NValue::getNullValue(VALUE_TYPE_INTEGER) :
+                         ValueFactory::getIntegerValue(static_cast<int32_t>(ii % 10)));
+        size_t hash;
+        EXPECT_EQ(row(ii), m_table.find(key, hash));
+        // Groups come back in the order they were made.
+        EXPECT_EQ(row(ii), m_table.rowAt(ii));
+    }
+    key.setNValue(0, ValueFactory::getBigIntValue(groups));
+    size_t hash;
+    EXPECT_TRUE(m_table.find(key, hash) == NULL);
+
+    m_table.clear();
+    EXPECT_TRUE(m_table.empty());
+    key.setNValue(0, ValueFactory::getBigIntValue(0));
+    key.setNValue(1, ValueFactory::getIntegerValue(1));
+    EXPECT_TRUE(m_table.find(key, hash) == NULL);
+}
+
+TEST_F(AggregateHashTableTest, ReservedTable) {
+    std::vector<ValueType> types;
+    types.push_back(VALUE_TYPE_BIGINT);
+    std::vector<int32_t> lengths;
+    lengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    initSchema(types, lengths);
+
+    // Reserving for fewer groups than end up in the table is only a hint.
+    TableTuple key = newKey();
+    const int64_t groups = 3000;
+    for (int pass = 0; pass < 2; pass++) {
+        m_table.clear();
+        m_table.reserve(pass == 0 ? groups : groups / 10);
+        for (int64_t ii = 0; ii < groups; ii++) {
+            key.setNValue(0, ValueFactory::getBigIntValue(ii * 7));
+            size_t hash;
+            EXPECT_TRUE(m_table.find(key, hash) == NULL);
+            m_table.insert(key, hash, row(ii));
+        }
+        EXPECT_EQ(groups, m_table.size());
+        for (int64_t ii = 0; ii < groups; ii++) {
+            key.setNValue(0, ValueFactory::getBigIntValue(ii * 7));
+            size_t hash;
+            EXPECT_EQ(row(ii), m_table.find(key, hash));
+            EXPECT_EQ(row(ii), m_table.rowAt(ii));
+        }
+    }
+}
+
+TEST_F(AggregateHashTableTest, VarcharKeys) {
+    std::vector<ValueType> types;
+    types.push_back(VALUE_TYPE_VARCHAR);
+    std::vector<int32_t> lengths;
+    lengths.push_back(16);
+    initSchema(types, lengths);
+    EXPECT_TRUE(m_table.keepsKeyTuples());
+
+    const int groups = 1000;
+    for (int ii = 0; ii < groups; ii++) {
+        std::ostringstream name;
+        name << "group" << ii;
+        NValue value = ValueFactory::getStringValue(name.str());
+        TableTuple key = newKey();
+        key.setNValueAllocateForObjectCopies(0, value, &m_pool);
+        value.free();
+        size_t hash;
+        EXPECT_TRUE(m_table.find(key, hash) == NULL);
+        m_table.insert(key, hash, row(ii));
+    }
+
+    TableTuple probe = newKey();
+    for (int ii = groups - 1; ii >= 0; ii--) {
+        std::ostringstream name;
+        name << "group" << ii;
+        NValue value = ValueFactory::getStringValue(name.str());
+        probe.setNValueAllocateForObjectCopies(0, value, &m_pool);
+        value.free();
+        size_t hash;
+        EXPECT_EQ(row(ii), m_table.find(probe, hash));
+    }
+    NValue value = ValueFactory::getStringValue("nogroup");
+    probe.setNValueAllocateForObjectCopies(0, value, &m_pool);
+    value.free();
+    size_t hash;
+    EXPECT_TRUE(m_table.find(probe, hash) == NULL);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,356 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * The nested loop executor hashes its inner table on the columns of the
+ * equalities between the outer and inner tables when the inner table has
+ * at least 16 tuples. These tests run joins over an inner table that big,
+ * check them against the pairs a plain nested loop would produce, and
+ * check that the hash table counts against the temp table memory limit.
+ */
+
+#include "harness.h"
+
+#include "catalog/cluster.h"
+#include "catalog/database.h"
+#include "catalog/table.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include "boost/scoped_ptr.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace voltdb;
+
+namespace {
+
+// Both tables are (A integer, K integer, F float).
+const char *catalogString =
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV adminport 0\n"
+    "set $PREV adminstartup false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database tables OUTERT\n"
+    "set /clusters#cluster/databases#database/tables#OUTERT isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"OUTERT|iif\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#OUTERT columns A\n"
+    "set /clusters#cluster/databases#database/tables#OUTERT/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#OUTERT columns K\n"
+    "set /clusters#cluster/databases#database/tables#OUTERT/columns#K index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"K\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#OUTERT columns F\n"
+    "set /clusters#cluster/databases#database/tables#OUTERT/columns#F index 2\n"
+    "set $PREV type 8\n"
+    "set $PREV size 8\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"F\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables INNERT\n"
+    "set /clusters#cluster/databases#database/tables#INNERT isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"INNERT|iif\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#INNERT columns A\n"
+    "set /clusters#cluster/databases#database/tables#INNERT/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#INNERT columns K\n"
+    "set /clusters#cluster/databases#database/tables#INNERT/columns#K index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"K\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#INNERT columns F\n"
+    "set /clusters#cluster/databases#database/tables#INNERT/columns#F index 2\n"
+    "set $PREV type 8\n"
+    "set $PREV size 8\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"F\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "";
+
+// Inner keys 0 to 9 have four rows each, and five inner rows have a
+// NULL key. Outer keys 0 to 14 have a row each, and so do two NULLs.
+const int INNER_KEYS = 10;
+const int INNER_ROWS_PER_KEY = 4;
+const int INNER_NULL_ROWS = 5;
+const int OUTER_KEYS = 15;
+const int OUTER_NULL_ROWS = 2;
+const int NULL_COLUMN = -1;
+
+typedef std::vector<std::pair<int, int> > JoinedPairs;
+
+std::string columnJson(int column, int valueType, int tableIdx)
+{
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+             "{\"COLUMN_IDX\": %d, \"TABLE_IDX\": %d, \"TYPE\": 32, \"VALUE_TYPE\": %d}",
+             column, tableIdx, valueType);
+    return buffer;
+}
+
+std::string outputColumnJson(const char *name, int column, int valueType)
+{
+    return std::string("{\"COLUMN_NAME\": \"") + name + "\", \"EXPRESSION\": " +
+        columnJson(column, valueType, 0) + "}";
+}
+
+// SELECT * FROM OUTERT <joinType> JOIN INNERT
+//     ON OUTERT.<key> = INNERT.<key>
+std::string joinPlan(const char *joinType, int keyColumn, int keyType)
+{
+    return std::string(
+        "{\"EXECUTE_LIST\": [3, 4, 2, 1],\n"
+        " \"PLAN_NODES\": [\n"
+        "  {\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"},\n"
+        "  {\"CHILDREN_IDS\": [3, 4], \"ID\": 2, \"PLAN_NODE_TYPE\": \"NESTLOOP\",\n"
+        "   \"JOIN_TYPE\": \"") + joinType + "\",\n"
+        "   \"JOIN_PREDICATE\": {\"TYPE\": 10, \"VALUE_TYPE\": 23,\n"
+        "                      \"LEFT\": " + columnJson(keyColumn, keyType, 0) + ",\n"
+        "                      \"RIGHT\": " + columnJson(keyColumn, keyType, 1) + "},\n"
+        "   \"PRE_JOIN_PREDICATE\": null, \"WHERE_PREDICATE\": null,\n"
+        "   \"OUTPUT_SCHEMA\": [" +
+        outputColumnJson("A", 0, 5) + ", " + outputColumnJson("K", 1, 5) + ", " +
+        outputColumnJson("F", 2, 8) + ", " + outputColumnJson("A", 3, 5) + ", " +
+        outputColumnJson("K", 4, 5) + ", " + outputColumnJson("F", 5, 8) + "]},\n"
+        "  {\"ID\": 3, \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "   \"TARGET_TABLE_ALIAS\": \"OUTERT\", \"TARGET_TABLE_NAME\": \"OUTERT\"},\n"
+        "  {\"ID\": 4, \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "   \"TARGET_TABLE_ALIAS\": \"INNERT\", \"TARGET_TABLE_NAME\": \"INNERT\"}\n"
+        " ]\n"
+        "}";
+}
+
+}
+
+class NestLoopHashJoinTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    NestLoopHashJoinTest(int64_t tempTableMemory = DEFAULT_TEMP_TABLE_MEMORY) {
+        initialize(catalogString, 0, NULL, static_cast<uint32_t>(time(NULL)), tempTableMemory);
+        m_outer = getPersistentTableAndId("OUTERT", NULL);
+        m_inner = getPersistentTableAndId("INNERT", NULL);
+        for (int ii = 0; ii < INNER_KEYS * INNER_ROWS_PER_KEY; ii++) {
+            insertRow(m_inner, ii, ii % INNER_KEYS);
+        }
+        for (int ii = 0; ii < INNER_NULL_ROWS; ii++) {
+            insertRow(m_inner, 100 + ii, NULL_COLUMN);
+        }
+        for (int ii = 0; ii < OUTER_KEYS; ii++) {
+            insertRow(m_outer, ii, ii);
+        }
+        for (int ii = 0; ii < OUTER_NULL_ROWS; ii++) {
+            insertRow(m_outer, 100 + ii, NULL_COLUMN);
+        }
+    }
+
+    void insertRow(PersistentTable *table, int a, int key) {
+        TableTuple &tuple = table->tempTuple();
+        tuple.setNValue(0, ValueFactory::getIntegerValue(a));
+        if (key == NULL_COLUMN) {
+            tuple.setNValue(1, NValue::getNullValue(VALUE_TYPE_INTEGER));
+            tuple.setNValue(2, NValue::getNullValue(VALUE_TYPE_DOUBLE));
+        }
+        else {
+            tuple.setNValue(1, ValueFactory::getIntegerValue(key));
+            tuple.setNValue(2, ValueFactory::getDoubleValue(key));
+        }
+        ASSERT_TRUE(table->insertTuple(tuple));
+    }
+
+    // The (OUTERT.A, INNERT.A) pairs of the fragment's result, in order
+    JoinedPairs executeJoin(fragmentId_t fragmentId, const std::string &plan) {
+        executeFragment(fragmentId, plan.c_str());
+        boost::scoped_ptr<TempTable> result(loadTableFrom(m_result_buffer.get(), m_engine->getResultsSize()));
+        JoinedPairs pairs;
+        TableTuple tuple(result->schema());
+        TableIterator iter = result->iterator();
+        while (iter.next(tuple)) {
+            NValue innerA = tuple.getNValue(3);
+            pairs.push_back(std::make_pair(ValuePeeker::peekAsInteger(tuple.getNValue(0)),
+                                           innerA.isNull() ? NULL_COLUMN : ValuePeeker::peekAsInteger(innerA)));
+        }
+        return pairs;
+    }
+
+    // What a nested loop over the rows in insertion order produces
+    static JoinedPairs expectedPairs(bool leftJoin) {
+        JoinedPairs pairs;
+        for (int outer = 0; outer < OUTER_KEYS; outer++) {
+            bool matched = false;
+            for (int inner = 0; inner < INNER_KEYS * INNER_ROWS_PER_KEY; inner++) {
+                if (inner % INNER_KEYS == outer) {
+                    pairs.push_back(std::make_pair(outer, inner));
+                    matched = true;
+                }
+            }
+            if (leftJoin && ! matched) {
+                pairs.push_back(std::make_pair(outer, NULL_COLUMN));
+            }
+        }
+        for (int ii = 0; leftJoin && ii < OUTER_NULL_ROWS; ii++) {
+            pairs.push_back(std::make_pair(100 + ii, NULL_COLUMN));
+        }
+        return pairs;
+    }
+
+    int64_t memoryDetail(int counter) {
+        int64_t counters[MEMORY_DETAIL_COUNT];
+        m_engine->getMemoryDetail(counters);
+        return counters[counter];
+    }
+
+protected:
+    PersistentTable *m_outer;
+    PersistentTable *m_inner;
+};
+
+TEST_F(NestLoopHashJoinTest, InnerJoinMatchesEveryDuplicate) {
+    // Each outer row meets all the inner rows with its key, in inner
+    // table order, and the rows with NULL keys meet nothing.
+    JoinedPairs pairs = executeJoin(100, joinPlan("INNER", 1, VALUE_TYPE_INTEGER));
+    JoinedPairs expected = expectedPairs(false);
+    ASSERT_EQ(INNER_KEYS * INNER_ROWS_PER_KEY, pairs.size());
+    ASSERT_TRUE(expected == pairs);
+}
+
+TEST_F(NestLoopHashJoinTest, LeftJoinPadsOuterRowsWithNullKeys) {
+    // Outer rows whose key is NULL or absent from the inner table are
+    // still emitted, padded with NULLs.
+    JoinedPairs pairs = executeJoin(101, joinPlan("LEFT", 1, VALUE_TYPE_INTEGER));
+    JoinedPairs expected = expectedPairs(true);
+    ASSERT_EQ(expected.size(), pairs.size());
+    ASSERT_TRUE(expected == pairs);
+}
+
+TEST_F(NestLoopHashJoinTest, FloatKeysFallBackToNestedLoop) {
+    // FLOAT keys are not hashed, so this join scans the inner table for
+    // each outer row, and must agree with the hash join of the same rows.
+    JoinedPairs scanned = executeJoin(102, joinPlan("LEFT", 2, VALUE_TYPE_DOUBLE));
+    ASSERT_TRUE(expectedPairs(true) == scanned);
+    JoinedPairs hashed = executeJoin(103, joinPlan("LEFT", 1, VALUE_TYPE_INTEGER));
+    ASSERT_TRUE(scanned == hashed);
+}
+
+// Gives the fragments a quarter MB of temp table memory, which the join's
+// output fits in but not together with the hash table of a big inner table.
+class NestLoopHashJoinMemoryTest : public NestLoopHashJoinTest {
+public:
+    NestLoopHashJoinMemoryTest() : NestLoopHashJoinTest(256 * 1024) {
+        // Keys no outer row has
+        for (int ii = 0; ii < 4000; ii++) {
+            insertRow(m_inner, 1000 + ii, 1000 + ii);
+        }
+    }
+};
+
+TEST_F(NestLoopHashJoinMemoryTest, HashTableIsChargedToTempTableMemory) {
+    // The nested loop needs no more than its output.
+    JoinedPairs scanned = executeJoin(104, joinPlan("LEFT", 2, VALUE_TYPE_DOUBLE));
+    ASSERT_TRUE(expectedPairs(true) == scanned);
+    int64_t scannedMemory = memoryDetail(MEMORY_DETAIL_TEMP_TABLE);
+
+    // The hash join's table of 4000 keys takes it over the limit.
+    ASSERT_EQ(ENGINE_ERRORCODE_ERROR, executeFragment(105, joinPlan("LEFT", 1, VALUE_TYPE_INTEGER).c_str()));
+    // It gave the hash table back as it failed, so its fragment holds no
+    // more than the nested loop's does.
+    ASSERT_TRUE(memoryDetail(MEMORY_DETAIL_TEMP_TABLE) <= 2 * scannedMemory);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,244 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * With an inline LIMIT, the order by executor keeps only the first
+ * LIMIT + OFFSET tuples in sort order as it reads its input. These tests
+ * check what it writes against the same ORDER BY run without a LIMIT.
+ */
+
+#include "harness.h"
+
+#include "catalog/cluster.h"
+#include "catalog/database.h"
+#include "catalog/table.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include "boost/scoped_ptr.hpp"
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace voltdb;
+
+namespace {
+
+// T (A integer, B integer)
+const char *catalogString =
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV adminport 0\n"
+    "set $PREV adminstartup false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database tables T\n"
+    "set /clusters#cluster/databases#database/tables#T isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"T|ii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#T columns A\n"
+    "set /clusters#cluster/databases#database/tables#T/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#T columns B\n"
+    "set /clusters#cluster/databases#database/tables#T/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "";
+
+// A is 0 to 199, and B is A % 20, so ten rows share each B.
+const int ROWS = 200;
+const int B_VALUES = 20;
+const int NO_LIMIT = -1;
+
+typedef std::vector<std::pair<int, int> > Rows;
+
+std::string sortColumnJson(int column, const char *direction)
+{
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+             "{\"SORT_DIRECTION\": \"%s\", "
+             "\"SORT_EXPRESSION\": {\"COLUMN_IDX\": %d, \"TYPE\": 32, \"VALUE_TYPE\": 5}}",
+             direction, column);
+    return buffer;
+}
+
+// SELECT * FROM T ORDER BY B [DESC, A] [LIMIT limit OFFSET offset]
+std::string orderByPlan(bool byBOnly, int limit, int offset)
+{
+    std::string sortColumns = byBOnly ? sortColumnJson(1, "ASC") :
+        sortColumnJson(1, "DESC") + ", " + sortColumnJson(0, "ASC");
+    std::string inlineLimit;
+    if (limit != NO_LIMIT) {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer),
+                 "   \"INLINE_NODES\": [{\"ID\": 4, \"PLAN_NODE_TYPE\": \"LIMIT\", "
+                 "\"LIMIT\": %d, \"OFFSET\": %d}],\n", limit, offset);
+        inlineLimit = buffer;
+    }
+    return std::string(
+        "{\"EXECUTE_LIST\": [3, 2, 1],\n"
+        " \"PLAN_NODES\": [\n"
+        "  {\"CHILDREN_IDS\": [2], \"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\"},\n"
+        "  {\"CHILDREN_IDS\": [3], \"ID\": 2, \"PLAN_NODE_TYPE\": \"ORDERBY\",\n") + inlineLimit +
+        "   \"SORT_COLUMNS\": [" + sortColumns + "]},\n"
+        "  {\"ID\": 3, \"PLAN_NODE_TYPE\": \"SEQSCAN\",\n"
+        "   \"TARGET_TABLE_ALIAS\": \"T\", \"TARGET_TABLE_NAME\": \"T\"}\n"
+        " ]\n"
+        "}";
+}
+
+}
+
+class OrderByTopNTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    OrderByTopNTest() : m_nextFragmentId(100) {
+        initialize(catalogString);
+        PersistentTable *table = getPersistentTableAndId("T", NULL);
+        // Inserted in an order unrelated to B's
+        for (int ii = 0; ii < ROWS; ii++) {
+            int a = (ii * 37) % ROWS;
+            TableTuple &tuple = table->tempTuple();
+            tuple.setNValue(0, ValueFactory::getIntegerValue(a));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(a % B_VALUES));
+            EXPECT_TRUE(table->insertTuple(tuple));
+        }
+    }
+
+    // The (A, B) rows of the plan's result, in order
+    Rows executeOrderBy(bool byBOnly, int limit, int offset = 0) {
+        executeFragment(m_nextFragmentId++, orderByPlan(byBOnly, limit, offset).c_str());
+        boost::scoped_ptr<TempTable> result(loadTableFrom(m_result_buffer.get(), m_engine->getResultsSize()));
+        Rows rows;
+        TableTuple tuple(result->schema());
+        TableIterator iter = result->iterator();
+        while (iter.next(tuple)) {
+            rows.push_back(std::make_pair(ValuePeeker::peekAsInteger(tuple.getNValue(0)),
+                                          ValuePeeker::peekAsInteger(tuple.getNValue(1))));
+        }
+        return rows;
+    }
+
+    // The rows of the full sort from offset on, at most limit of them
+    static Rows slice(const Rows &sorted, int limit, int offset) {
+        Rows rows;
+        for (int ii = offset; ii < sorted.size() && ii < offset + limit; ii++) {
+            rows.push_back(sorted[ii]);
+        }
+        return rows;
+    }
+
+    // Sorted by B alone, tied rows may come out in any order, and the top
+    // rows may be any of the tied rows at the cutoff. So B must follow the
+    // full sort, and the rows must be distinct rows of T.
+    void checkSameKeys(const Rows &expected, const Rows &actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        std::set<int> seen;
+        for (int ii = 0; ii < actual.size(); ii++) {
+            ASSERT_EQ(expected[ii].second, actual[ii].second);
+            ASSERT_EQ(actual[ii].first % B_VALUES, actual[ii].second);
+            ASSERT_TRUE(seen.insert(actual[ii].first).second);
+        }
+    }
+
+private:
+    fragmentId_t m_nextFragmentId;
+};
+
+TEST_F(OrderByTopNTest, LimitWithOffset) {
+    // A total order, so the rows are exactly those of the full sort.
+    Rows sorted = executeOrderBy(false, NO_LIMIT);
+    ASSERT_EQ(ROWS, sorted.size());
+    ASSERT_TRUE(slice(sorted, 15, 7) == executeOrderBy(false, 15, 7));
+    ASSERT_TRUE(slice(sorted, 1, 0) == executeOrderBy(false, 1));
+    ASSERT_TRUE(slice(sorted, 10, ROWS - 10) == executeOrderBy(false, 10, ROWS - 10));
+    // An offset past the input leaves nothing.
+    ASSERT_EQ(0, executeOrderBy(false, 10, ROWS).size());
+}
+
+TEST_F(OrderByTopNTest, LimitLargerThanInput) {
+    Rows sorted = executeOrderBy(false, NO_LIMIT);
+    ASSERT_TRUE(sorted == executeOrderBy(false, ROWS + 1));
+    ASSERT_TRUE(sorted == executeOrderBy(false, 1000));
+    ASSERT_TRUE(slice(sorted, 1000, 150) == executeOrderBy(false, 1000, 150));
+}
+
+TEST_F(OrderByTopNTest, LimitZero) {
+    ASSERT_EQ(0, executeOrderBy(false, 0).size());
+    ASSERT_EQ(0, executeOrderBy(true, 0, 5).size());
+}
+
+TEST_F(OrderByTopNTest, TiesAtTheCutoff) {
+    // Ten rows share each B, so the offsets and limits below cut through
+    // groups of tied rows.
+    Rows sorted = executeOrderBy(true, NO_LIMIT);
+    ASSERT_EQ(ROWS, sorted.size());
+    checkSameKeys(slice(sorted, 15, 7), executeOrderBy(true, 15, 7));
+    checkSameKeys(slice(sorted, 5, 0), executeOrderBy(true, 5));
+    checkSameKeys(slice(sorted, 33, 44), executeOrderBy(true, 33, 44));
+    checkSameKeys(slice(sorted, 1000, 195), executeOrderBy(true, 1000, 195));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -54,16 +54,21 @@
 #include <stdlib.h>
 #include <time.h>
 #include <queue>
+#include <limits>
 #include <boost/scoped_array.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 #include "harness.h"
 #include "jsoncpp/jsoncpp.h"
 
 #include "expressions/abstractexpression.h"
 #include "expressions/expressions.h"
+#include "common/executorcontext.hpp"
+#include "common/Pool.hpp"
 #include "common/types.h"
 #include "common/ValuePeeker.hpp"
 #include "common/PlannerDomValue.h"
+#include "common/ThreadLocalPool.h"
 
 
 using namespace std;
@@ -309,6 +314,10 @@ class ExpressionTest : public Test {
     public:
         ExpressionTest() {
         }
+
+    protected:
+        // For the persistent strings some tests create
+        ThreadLocalPool m_threadLocalPool;
 };
 
 /*
@@ -453,6 +462,392 @@ TEST_F(ExpressionTest, Timestamp) {
 
 }
 
+/*
+ * Show that batches of tuples are filtered and evaluated as they would be
+ * one tuple at a time, including around NULLs
+ */
+TEST_F(ExpressionTest, BatchEvaluation) {
+    vector<int32_t> columnSizes(2, 8);
+    vector<bool> allowNull(2, true);
+    vector<voltdb::ValueType> types(2, voltdb::VALUE_TYPE_BIGINT);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+
+    const int tupleCount = 1000;
+    const int tupleLength = schema->tupleLength() + TUPLE_HEADER_SIZE;
+    boost::scoped_array<char> tupleStorage(new char[tupleCount * tupleLength]);
+    vector<TableTuple> tuples;
+    srand(0);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        TableTuple t(tupleStorage.get() + ii * tupleLength, schema);
+        for (int col = 0; col < 2; col++) {
+            t.setNValue(col, rand() % 10 == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_BIGINT) :
+                                                ValueFactory::getBigIntValue(rand() % 100));
+        }
+        tuples.push_back(t);
+    }
+
+    // (A < 50 OR B = 3) AND A > 10, and A IS NOT DISTINCT FROM B
+    boost::scoped_ptr<AbstractExpression> conjunction(
+        new ConjunctionExpression<ConjunctionAnd>(EXPRESSION_TYPE_CONJUNCTION_AND,
+            new ConjunctionExpression<ConjunctionOr>(EXPRESSION_TYPE_CONJUNCTION_OR,
+                new ComparisonExpression<CmpLt>(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                                                new TupleValueExpression(0, 0),
+                                                new ConstantValueExpression(ValueFactory::getBigIntValue(50))),
+                new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                                new TupleValueExpression(0, 1),
+                                                new ConstantValueExpression(ValueFactory::getBigIntValue(3)))),
+            new ComparisonExpression<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                            new TupleValueExpression(0, 0),
+                                            new ConstantValueExpression(ValueFactory::getBigIntValue(10)))));
+    boost::scoped_ptr<AbstractExpression> notDistinct(
+        new ComparisonExpression<CmpNotDistinct>(EXPRESSION_TYPE_COMPARE_NOTDISTINCT,
+                                                 new TupleValueExpression(0, 0),
+                                                 new TupleValueExpression(0, 1)));
+    AbstractExpression *predicates[] = { conjunction.get(), notDistinct.get() };
+
+    for (int pp = 0; pp < 2; pp++) {
+        // Start from every third tuple, as after an earlier filter.
+        vector<int> selection;
+        for (int ii = 0; ii < tupleCount; ii += 3) {
+            selection.push_back(ii);
+        }
+        vector<int> expected;
+        for (int ii = 0; ii < selection.size(); ii++) {
+            if (predicates[pp]->eval(&tuples[selection[ii]], NULL).isTrue()) {
+                expected.push_back(selection[ii]);
+            }
+        }
+        int count = predicates[pp]->filterBatch(&tuples[0], &selection[0], static_cast<int>(selection.size()));
+        selection.resize(count);
+        ASSERT_TRUE(expected == selection);
+    }
+
+    vector<int> selection;
+    for (int ii = 0; ii < tupleCount; ii++) {
+        selection.push_back(ii);
+    }
+    vector<NValue> results(tupleCount);
+    conjunction->getLeft()->getLeft()->getLeft()->evalBatch(&tuples[0], &selection[0], tupleCount, &results[0]);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        ASSERT_EQ(0, results[ii].compare(tuples[ii].getNValue(0)));
+    }
+    notDistinct->evalBatch(&tuples[0], &selection[0], tupleCount, &results[0]);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        ASSERT_EQ(notDistinct->eval(&tuples[ii], NULL).isTrue(), results[ii].isTrue());
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
+/*
+ * Show that comparisons of a column with a constant or parameter that read
+ * the column in place agree with the general comparison, around NULLs,
+ * NaNs and mixed types
+ */
+TEST_F(ExpressionTest, ColumnValueComparison) {
+    vector<voltdb::ValueType> types;
+    types.push_back(voltdb::VALUE_TYPE_INTEGER);
+    types.push_back(voltdb::VALUE_TYPE_DOUBLE);
+    vector<int32_t> columnSizes;
+    columnSizes.push_back(4);
+    columnSizes.push_back(8);
+    vector<bool> allowNull(2, true);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+
+    const int tupleCount = 300;
+    const int tupleLength = schema->tupleLength() + TUPLE_HEADER_SIZE;
+    boost::scoped_array<char> tupleStorage(new char[tupleCount * tupleLength]);
+    vector<TableTuple> tuples;
+    srand(0);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        TableTuple t(tupleStorage.get() + ii * tupleLength, schema);
+        t.setNValue(0, rand() % 10 == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_INTEGER) :
+                                          ValueFactory::getIntegerValue(rand() % 20 - 10));
+        int kind = rand() % 10;
+        t.setNValue(1, kind == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_DOUBLE) :
+                       (kind == 1 ? ValueFactory::getDoubleValue(std::numeric_limits<double>::quiet_NaN()) :
+                                    ValueFactory::getDoubleValue((rand() % 20 - 10) / 2.0)));
+        tuples.push_back(t);
+    }
+
+    vector<NValue> values;
+    values.push_back(ValueFactory::getIntegerValue(3));
+    values.push_back(ValueFactory::getBigIntValue(-4));
+    values.push_back(ValueFactory::getDoubleValue(1.5));
+    values.push_back(ValueFactory::getDoubleValue(std::numeric_limits<double>::quiet_NaN()));
+    values.push_back(NValue::getNullValue(voltdb::VALUE_TYPE_BIGINT));
+    values.push_back(ValueFactory::getDecimalValueFromString("2.5"));
+
+    for (int vv = 0; vv < values.size(); vv++) {
+        NValue param = values[vv];
+        for (int col = 0; col < 2; col++) {
+            for (int useParam = 0; useParam < 2; useParam++) {
+                AbstractExpression *right = useParam ?
+                    static_cast<AbstractExpression*>(new ParameterValueExpression(0, &param)) :
+                    static_cast<AbstractExpression*>(new ConstantValueExpression(values[vv]));
+                boost::scoped_ptr<AbstractExpression> specialized(
+                    new ColumnValueComparisonExpression<CmpLte>(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                                                new TupleValueExpression(0, col), right));
+                boost::scoped_ptr<AbstractExpression> general(
+                    new ComparisonExpression<CmpLte>(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                                                     new TupleValueExpression(0, col),
+                                                     new ConstantValueExpression(values[vv])));
+                vector<int> selection;
+                vector<int> expected;
+                for (int ii = 0; ii < tupleCount; ii++) {
+                    NValue want = general->eval(&tuples[ii], NULL);
+                    NValue got = specialized->eval(&tuples[ii], NULL);
+                    ASSERT_EQ(want.isNull(), got.isNull());
+                    if ( ! want.isNull()) {
+                        ASSERT_EQ(want.isTrue(), got.isTrue());
+                    }
+                    if ( ! want.isNull() && want.isTrue()) {
+                        expected.push_back(ii);
+                    }
+                    selection.push_back(ii);
+                }
+                int count = specialized->filterBatch(&tuples[0], &selection[0], tupleCount);
+                selection.resize(count);
+                ASSERT_TRUE(expected == selection);
+            }
+        }
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
+TEST_F(ExpressionTest, LikePatterns) {
+    const char *patterns[] = { "", "%", "%%", "abc", "abc%", "%abc", "%abc%", "%%abc%%",
+                               "a%c", "a_c", "_bc%", "%b_%", "贾%", "%家" };
+    const char *values[] = { "", "abc", "abcd", "xabc", "xabcx", "ab", "aXc", "abcabc",
+                             "贾家", "家贾", "bc" };
+    const int patternCount = sizeof(patterns) / sizeof(patterns[0]);
+    const int valueCount = sizeof(values) / sizeof(values[0]);
+
+    // One expression with a parameter pattern, checked as the parameter
+    // changes under it.
+    NValue param;
+    boost::scoped_ptr<AbstractExpression> parameterized;
+    for (int pp = 0; pp < patternCount; pp++) {
+        NValue pattern = ValueFactory::getStringValue(patterns[pp]);
+        param = pattern;
+        for (int vv = 0; vv < valueCount; vv++) {
+            boost::scoped_ptr<AbstractExpression> general(
+                new ComparisonExpression<CmpLike>(EXPRESSION_TYPE_COMPARE_LIKE,
+                                                  new ConstantValueExpression(ValueFactory::getStringValue(values[vv])),
+                                                  new ConstantValueExpression(ValueFactory::getStringValue(patterns[pp]))));
+            boost::scoped_ptr<AbstractExpression> constant(
+                new LikeComparisonExpression(EXPRESSION_TYPE_COMPARE_LIKE,
+                                             new ConstantValueExpression(ValueFactory::getStringValue(values[vv])),
+                                             new ConstantValueExpression(ValueFactory::getStringValue(patterns[pp]))));
+            parameterized.reset(
+                new LikeComparisonExpression(EXPRESSION_TYPE_COMPARE_LIKE,
+                                             new ConstantValueExpression(ValueFactory::getStringValue(values[vv])),
+                                             new ParameterValueExpression(0, &param)));
+            bool want = general->eval(NULL, NULL).isTrue();
+            ASSERT_EQ(want, constant->eval(NULL, NULL).isTrue());
+            ASSERT_EQ(want, parameterized->eval(NULL, NULL).isTrue());
+        }
+        pattern.free();
+    }
+
+    NValue abc = ValueFactory::getStringValue("abc");
+    param = abc;
+    boost::scoped_ptr<AbstractExpression> cached(
+        new LikeComparisonExpression(EXPRESSION_TYPE_COMPARE_LIKE,
+                                     new ConstantValueExpression(ValueFactory::getStringValue("xabcx")),
+                                     new ParameterValueExpression(0, &param)));
+    ASSERT_FALSE(cached->eval(NULL, NULL).isTrue());
+    NValue contains = ValueFactory::getStringValue("%abc%");
+    param = contains;
+    ASSERT_TRUE(cached->eval(NULL, NULL).isTrue());
+    param = NValue::getNullValue(voltdb::VALUE_TYPE_VARCHAR);
+    ASSERT_TRUE(cached->eval(NULL, NULL).isNull());
+    abc.free();
+    contains.free();
+}
+
+TEST_F(ExpressionTest, CommonSubexpressions) {
+    // (c0 + 1) * 2, (c0 + 1) * 3, and (c0 + 1) * 2 again.
+    const int64_t factors[] = { 2, 3, 2 };
+    std::vector<std::string> columnJson;
+    for (int ii = 0; ii < 3; ii++) {
+        queue<AE*> e;
+        e.push(new TV(EXPRESSION_TYPE_VALUE_TUPLE, VALUE_TYPE_BIGINT, 8, 0, "T", "C0", "C0"));
+        e.push(new AE(EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT, 8));
+        e.push(new CV(EXPRESSION_TYPE_VALUE_CONSTANT, VALUE_TYPE_BIGINT, 8, (int64_t)1));
+        e.push(new AE(EXPRESSION_TYPE_OPERATOR_MULTIPLY, VALUE_TYPE_BIGINT, 8));
+        e.push(new CV(EXPRESSION_TYPE_VALUE_CONSTANT, VALUE_TYPE_BIGINT, 8, factors[ii]));
+        AE *tree = makeTree(NULL, e);
+        Json::FastWriter writer;
+        columnJson.push_back(writer.write(tree->serializeValue()));
+        delete tree;
+    }
+
+    CommonSubexpressions shared;
+    boost::ptr_vector<PlannerDomRoot> roots;
+    for (int ii = 0; ii < 3; ii++) {
+        roots.push_back(new PlannerDomRoot(columnJson[ii].c_str()));
+        shared.count(roots[ii].rootObject());
+    }
+    ASSERT_TRUE(shared.hasRepeats());
+    boost::ptr_vector<AbstractExpression> columns;
+    for (int ii = 0; ii < 3; ii++) {
+        columns.push_back(AbstractExpression::buildExpressionTree(roots[ii].rootObject(), &shared));
+    }
+    // The first and third columns are the same whole expression; the
+    // second shares only the sum.
+    ASSERT_TRUE(dynamic_cast<CommonSubexpression*>(&columns[0]) != NULL);
+    ASSERT_TRUE(dynamic_cast<CommonSubexpression*>(&columns[2]) != NULL);
+    ASSERT_TRUE(dynamic_cast<CommonSubexpression*>(&columns[1]) == NULL);
+    ASSERT_TRUE(dynamic_cast<const CommonSubexpression*>(columns[1].getLeft()) != NULL);
+
+    vector<voltdb::ValueType> types(1, voltdb::VALUE_TYPE_BIGINT);
+    vector<int32_t> columnSizes(1, 8);
+    vector<bool> allowNull(1, true);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+    boost::scoped_array<char> tupleStorage(new char[schema->tupleLength() + TUPLE_HEADER_SIZE]);
+    TableTuple tuple(tupleStorage.get(), schema);
+
+    // The same tuple storage holds a new row each time, so a value
+    // carried over from the last row would show.
+    for (int64_t row = 0; row < 4; row++) {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(row * 10));
+        {
+            CommonSubexpressions::RowScope scope(&shared);
+            for (int ii = 0; ii < 3; ii++) {
+                ASSERT_EQ((row * 10 + 1) * factors[ii], ValuePeeker::peekAsBigInt(columns[ii].eval(&tuple, NULL)));
+            }
+        }
+        tuple.setNValue(0, ValueFactory::getBigIntValue(row * 10 + 5));
+        for (int ii = 0; ii < 3; ii++) {
+            ASSERT_EQ((row * 10 + 6) * factors[ii], ValuePeeker::peekAsBigInt(columns[ii].eval(&tuple, NULL)));
+        }
+    }
+    TupleSchema::freeTupleSchema(schema);
+}
+
+TEST_F(ExpressionTest, ExecutionConstants) {
+    NValueArray params(1);
+    params[0] = ValueFactory::getBigIntValue(10);
+    Pool pool;
+    ExecutorContext context(0, 0, NULL, NULL, &pool, &params, (VoltDBEngine*)NULL,
+                            "", 0, NULL, NULL, 0);
+
+    // c0 > ? + 1
+    AE *plan = join(new AE(EXPRESSION_TYPE_COMPARE_GREATERTHAN, VALUE_TYPE_BOOLEAN, 1),
+                    new TV(EXPRESSION_TYPE_VALUE_TUPLE, VALUE_TYPE_BIGINT, 8, 0, "T", "C0", "C0"),
+                    join(new AE(EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT, 8),
+                         new PV(EXPRESSION_TYPE_VALUE_PARAMETER, VALUE_TYPE_BIGINT, 8, 0),
+                         new CV(EXPRESSION_TYPE_VALUE_CONSTANT, VALUE_TYPE_BIGINT, 8, (int64_t)1)));
+    Json::FastWriter writer;
+    std::string jsonText = writer.write(plan->serializeValue());
+    delete plan;
+    PlannerDomRoot domRoot(jsonText.c_str());
+    boost::scoped_ptr<AbstractExpression> predicate(AbstractExpression::buildExpressionTree(domRoot.rootObject()));
+    ASSERT_TRUE(dynamic_cast<const ExecutionConstantExpression*>(predicate->getRight()) != NULL);
+    ASSERT_TRUE(dynamic_cast<const ExecutionConstantExpression*>(predicate.get()) == NULL);
+
+    vector<voltdb::ValueType> types(1, voltdb::VALUE_TYPE_BIGINT);
+    vector<int32_t> columnSizes(1, 8);
+    vector<bool> allowNull(1, true);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+    boost::scoped_array<char> tupleStorage(new char[schema->tupleLength() + TUPLE_HEADER_SIZE]);
+    TableTuple tuple(tupleStorage.get(), schema);
+
+    context.setupForPlanFragments(NULL, 0, 0, 0, 0);
+    tuple.setNValue(0, ValueFactory::getBigIntValue(12));
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isTrue());
+    tuple.setNValue(0, ValueFactory::getBigIntValue(11));
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isFalse());
+
+    // The sum holds for the rest of the execution, and is redone for the next.
+    params[0] = ValueFactory::getBigIntValue(20);
+    tuple.setNValue(0, ValueFactory::getBigIntValue(12));
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isTrue());
+    context.setupForPlanFragments(NULL, 0, 0, 0, 0);
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isFalse());
+    tuple.setNValue(0, ValueFactory::getBigIntValue(22));
+    EXPECT_TRUE(predicate->eval(&tuple, NULL).isTrue());
+
+    TupleSchema::freeTupleSchema(schema);
+}
+
+TEST_F(ExpressionTest, InLists) {
+    NValueArray params(1);
+    Pool pool;
+    ExecutorContext context(0, 0, NULL, NULL, &pool, &params, (VoltDBEngine*)NULL,
+                            "", 0, NULL, NULL, 0);
+
+    vector<voltdb::ValueType> types(1, voltdb::VALUE_TYPE_BIGINT);
+    vector<int32_t> columnSizes(1, 8);
+    vector<bool> allowNull(1, true);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+    const int tupleCount = 200;
+    const int tupleLength = schema->tupleLength() + TUPLE_HEADER_SIZE;
+    boost::scoped_array<char> tupleStorage(new char[tupleCount * tupleLength]);
+    vector<TableTuple> tuples;
+    for (int ii = 0; ii < tupleCount; ii++) {
+        TableTuple t(tupleStorage.get() + ii * tupleLength, schema);
+        t.setNValue(0, ii % 17 == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_BIGINT) :
+                                      ValueFactory::getBigIntValue(ii - 50));
+        tuples.push_back(t);
+    }
+
+    boost::scoped_ptr<AbstractExpression> sorted(
+        new InListComparisonExpression(EXPRESSION_TYPE_COMPARE_IN,
+                                       new TupleValueExpression(0, 0),
+                                       new ParameterValueExpression(0, &params[0])));
+    boost::scoped_ptr<AbstractExpression> general(
+        new ComparisonExpression<CmpIn>(EXPRESSION_TYPE_COMPARE_IN,
+                                        new TupleValueExpression(0, 0),
+                                        new ParameterValueExpression(0, &params[0])));
+
+    // A new list for each execution, with duplicates, NULLs and values
+    // of other numeric types among the elements.
+    for (int execution = 0; execution < 4; execution++) {
+        const int length = execution * 40;
+        NValue list = ValueFactory::getArrayValueFromSizeAndType(length, voltdb::VALUE_TYPE_BIGINT);
+        std::vector<NValue> elements;
+        for (int ii = 0; ii < length; ii++) {
+            int64_t value = (ii * 37 + execution * 11) % 160 - 60;
+            elements.push_back(ii % 9 == 0 ? NValue::getNullValue(voltdb::VALUE_TYPE_BIGINT) :
+                               (ii % 5 == 0 ? ValueFactory::getIntegerValue(static_cast<int32_t>(value)) :
+                                              ValueFactory::getBigIntValue(value)));
+        }
+        list.setArrayElements(elements);
+        params[0] = list;
+        context.setupForPlanFragments(NULL, 0, 0, 0, 0);
+
+        vector<int> selection;
+        vector<int> expected;
+        for (int ii = 0; ii < tupleCount; ii++) {
+            NValue want = general->eval(&tuples[ii], NULL);
+            NValue got = sorted->eval(&tuples[ii], NULL);
+            ASSERT_EQ(want.isNull(), got.isNull());
+            if ( ! want.isNull()) {
+                ASSERT_EQ(want.isTrue(), got.isTrue());
+                if (want.isTrue()) {
+                    expected.push_back(ii);
+                }
+            }
+            selection.push_back(ii);
+        }
+        ASSERT_EQ(execution > 0, ! expected.empty());
+        int count = sorted->filterBatch(&tuples[0], &selection[0], tupleCount);
+        selection.resize(count);
+        ASSERT_TRUE(expected == selection);
+        list.free();
+    }
+
+    // A NULL list matches nothing.
+    params[0] = NValue::getNullValue(voltdb::VALUE_TYPE_BIGINT);
+    context.setupForPlanFragments(NULL, 0, 0, 0, 0);
+    EXPECT_TRUE(sorted->eval(&tuples[1], NULL).isNull());
+    vector<int> selection(1, 1);
+    EXPECT_EQ(0, sorted->filterBatch(&tuples[0], &selection[0], 1));
+
+    TupleSchema::freeTupleSchema(schema);
+}
+
 int main() {
      return TestSuite::globalInstance()->runAll();
 }
@@ -66,6 +66,7 @@
 #include "expressions/expressions.h"
 #include "expressions/expressionutil.h"
 #include "expressions/functionexpression.h"
+#include "expressions/geofunctions.h"
 #include "expressions/constantvalueexpression.h"
 
 using namespace voltdb;
@@ -689,6 +690,120 @@ TEST_F(FunctionTest, RepeatTooBig) {
     ASSERT_TRUE(sawexception);
 }
 
+TEST_F(FunctionTest, StringFunctionsOverAsciiAndUtf8) {
+    // Long enough to cover the 16-byte blocks as well as the bytes after.
+    const std::string ascii("The Quick Brown Fox, 1234567890 [jumps] @ the lazy dog~");
+    const std::string mixed("Grüße aus Köln, ÄÖÜ äöü und 贾 zum Schluss!");
+    ASSERT_EQ(testUnary(FUNC_FOLD_UPPER, ascii,
+                        std::string("THE QUICK BROWN FOX, 1234567890 [JUMPS] @ THE LAZY DOG~")), 0);
+    ASSERT_EQ(testUnary(FUNC_FOLD_LOWER, ascii,
+                        std::string("the quick brown fox, 1234567890 [jumps] @ the lazy dog~")), 0);
+    // Only ASCII letters change case.
+    ASSERT_EQ(testUnary(FUNC_FOLD_UPPER, mixed,
+                        std::string("GRüßE AUS KöLN, ÄÖÜ äöü UND 贾 ZUM SCHLUSS!")), 0);
+    ASSERT_EQ(testUnary(FUNC_FOLD_LOWER, mixed,
+                        std::string("grüße aus köln, ÄÖÜ äöü und 贾 zum schluss!")), 0);
+
+    ASSERT_EQ(testBinary(FUNC_LEFT, ascii, int64_t(9), std::string("The Quick")), 0);
+    ASSERT_EQ(testBinary(FUNC_LEFT, ascii, int64_t(100), ascii), 0);
+    ASSERT_EQ(testBinary(FUNC_LEFT, mixed, int64_t(5), std::string("Grüße")), 0);
+    ASSERT_EQ(testBinary(FUNC_RIGHT, ascii, int64_t(4), std::string("dog~")), 0);
+    ASSERT_EQ(testBinary(FUNC_RIGHT, mixed, int64_t(14), std::string("贾 zum Schluss!")), 0);
+
+    ASSERT_EQ(testBinary(FUNC_VOLT_SUBSTRING_CHAR_FROM, ascii, int64_t(43), std::string("the lazy dog~")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_SUBSTRING_CHAR_FROM, mixed, int64_t(17), std::string("ÄÖÜ äöü und 贾 zum Schluss!")), 0);
+    ASSERT_EQ(testTernary(FUNC_SUBSTRING_CHAR, ascii, int64_t(5), int64_t(5), std::string("Quick")), 0);
+    ASSERT_EQ(testTernary(FUNC_SUBSTRING_CHAR, mixed, int64_t(3), int64_t(3), std::string("üße")), 0);
+    ASSERT_EQ(testTernary(FUNC_SUBSTRING_CHAR, mixed, int64_t(29), int64_t(5), std::string("贾 zum")), 0);
+    ASSERT_EQ(testTernary(FUNC_SUBSTRING_CHAR, ascii, int64_t(-2), int64_t(6), std::string("The")), 0);
+
+    ASSERT_EQ(testBinary(FUNC_TRIM_BOTH_CHAR, std::string(" "), std::string("   padded  "), std::string("padded")), 0);
+    ASSERT_EQ(testBinary(FUNC_TRIM_LEADING_CHAR, std::string("ab"), std::string("ababa"), std::string("a")), 0);
+    ASSERT_EQ(testBinary(FUNC_TRIM_TRAILING_CHAR, std::string("贾"), std::string("贾x贾贾"), std::string("贾x")), 0);
+    ASSERT_EQ(testBinary(FUNC_TRIM_BOTH_CHAR, std::string("x"), std::string("xxx"), std::string("")), 0);
+}
+
+static NValue pointFromText(double lng, double lat) {
+    std::ostringstream wkt;
+    wkt << "POINT(" << lng << " " << lat << ")";
+    return ValueFactory::getTempStringValue(wkt.str()).callUnary<FUNC_VOLT_POINTFROMTEXT>();
+}
+
+TEST_F(FunctionTest, PolygonProbesMatchFreshPolygons) {
+    // A square with a square hole.
+    NValue square = ValueFactory::getTempStringValue(
+        "POLYGON((0 0, 10 0, 10 10, 0 10, 0 0), (3 3, 3 6, 6 6, 6 3, 3 3))")
+        .callUnary<FUNC_VOLT_POLYGONFROMTEXT>();
+    NValue triangle = ValueFactory::getTempStringValue(
+        "POLYGON((20 20, 30 20, 25 30, 20 20))").callUnary<FUNC_VOLT_POLYGONFROMTEXT>();
+
+    // Enough probes of each polygon for the cached one to build its
+    // coverings, checking it against a freshly decoded polygon throughout.
+    PolygonCache cached;
+    std::vector<NValue> args(2);
+    NValue polygons[] = { square, triangle, square };
+    for (int pp = 0; pp < 3; ++pp) {
+        args[0] = polygons[pp];
+        for (double lng = -1.0; lng <= 31.0; lng += 0.5) {
+            for (double lat = -1.0; lat <= 31.0; lat += 0.5) {
+                args[1] = pointFromText(lng, lat);
+                EXPECT_EQ(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_CONTAINS>(args)),
+                          ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+                EXPECT_EQ(ValuePeeker::peekDouble(NValue::call<FUNC_VOLT_DISTANCE_POLYGON_POINT>(args)),
+                          ValuePeeker::peekDouble(
+                              NValue::callWithPolygon<FUNC_VOLT_DISTANCE_POLYGON_POINT>(args, cached)));
+            }
+        }
+    }
+
+    args[0] = square;
+    args[1] = pointFromText(1.0, 1.0);
+    EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+    EXPECT_EQ(0.0, ValuePeeker::peekDouble(
+                  NValue::callWithPolygon<FUNC_VOLT_DISTANCE_POLYGON_POINT>(args, cached)));
+    args[1] = pointFromText(4.5, 4.5);
+    EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+    args[1] = pointFromText(25.0, 25.0);
+    EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+    args[0] = triangle;
+    EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+    EXPECT_EQ(2, cached.size());
+}
+
+TEST_F(FunctionTest, PolygonCacheHoldsJoinedPolygons) {
+    // More distinct polygons than the cache holds, visited over and over as
+    // the inner side of a join would visit them.
+    const int polygonCount = 300;
+    std::vector<NValue> triangles;
+    for (int ii = 0; ii < polygonCount; ++ii) {
+        std::ostringstream wkt;
+        double lng = ii % 20;
+        double lat = ii / 20;
+        wkt << "POLYGON((" << lng << " " << lat << ", " << lng + 1 << " " << lat << ", "
+            << lng << " " << lat + 1 << ", " << lng << " " << lat << "))";
+        triangles.push_back(ValueFactory::getTempStringValue(wkt.str()).callUnary<FUNC_VOLT_POLYGONFROMTEXT>());
+    }
+
+    PolygonCache cached;
+    std::vector<NValue> args(2);
+    for (int pass = 0; pass < 3; ++pass) {
+        args[1] = pointFromText(3.25 + pass, 2.25);
+        for (int ii = 0; ii < polygonCount; ++ii) {
+            args[0] = triangles[ii];
+            EXPECT_EQ(ValuePeeker::peekBoolean(NValue::call<FUNC_VOLT_CONTAINS>(args)),
+                      ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+        }
+    }
+    // The first polygons stay, the rest take turns in one shared entry.
+    EXPECT_EQ(256, cached.size());
+
+    args[1] = pointFromText(3.25, 2.25);
+    args[0] = triangles[43];
+    EXPECT_TRUE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+    args[0] = triangles[44];
+    EXPECT_FALSE(ValuePeeker::peekBoolean(NValue::callWithPolygon<FUNC_VOLT_CONTAINS>(args, cached)));
+}
+
 TEST_F(FunctionTest, RegularExpressionMatch) {
     bool sawexception = false;
     std::string testString("TEST reGexp_poSiTion123456Test");
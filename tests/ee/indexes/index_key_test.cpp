@@ -443,6 +443,153 @@ TEST_F(IndexKeyTest, Int64Packing2Int32sWithSecondNull) {
     voltdb::TupleSchema::freeTupleSchema(keySchema);
 }
 
+TEST_F(IndexKeyTest, Int64KeySearchTest) {
+    // Key words on both sides of the sign bit, with repeats, as separators
+    // in an inner node are.
+    const uint64_t words[] = { 0, 1, 1, 7, 0x7fffffffffffffffULL, 0x8000000000000000ULL,
+                               0x8000000000000000ULL, 0x8000000000000001ULL, 0xfffffffffffffffeULL,
+                               0xffffffffffffffffULL };
+    const int wordCount = static_cast<int>(sizeof(words) / sizeof(words[0]));
+    voltdb::IntsComparator<1> comparator(NULL);
+    typedef voltdb::BTreeKeySearch<voltdb::IntsKey<1>, voltdb::IntsComparator<1> > KeySearch;
+
+    // Keys packed as in inner nodes, between values as in leaves, and at a
+    // stride no vector loop handles.
+    for (std::size_t wordsPerKey = 1; wordsPerKey <= 3; wordsPerKey++) {
+        std::vector<voltdb::IntsKey<1> > keys(wordCount * wordsPerKey);
+        for (int ii = 0; ii < wordCount; ii++) {
+            keys[ii * wordsPerKey].data[0] = words[ii];
+            for (std::size_t jj = 1; jj < wordsPerKey; jj++) {
+                keys[ii * wordsPerKey + jj].data[0] = words[wordCount - 1 - ii];
+            }
+        }
+        std::size_t stride = wordsPerKey * sizeof(uint64_t);
+
+        // Every length covers the vector loops and their scalar tails.
+        for (int count = 0; count <= wordCount; count++) {
+            for (int tt = 0; tt < wordCount; tt++) {
+                for (int delta = -1; delta <= 1; delta++) {
+                    voltdb::IntsKey<1> target;
+                    target.data[0] = words[tt] + delta;
+                    int less = 0;
+                    int notGreater = 0;
+                    for (int ii = 0; ii < count; ii++) {
+                        less += comparator(keys[ii * wordsPerKey], target) < 0;
+                        notGreater += comparator(keys[ii * wordsPerKey], target) <= 0;
+                    }
+                    EXPECT_EQ(less, KeySearch::countBefore(&keys[0], stride, count, target, false, comparator));
+                    EXPECT_EQ(notGreater, KeySearch::countBefore(&keys[0], stride, count, target, true, comparator));
+                }
+            }
+        }
+    }
+}
+
+TEST_F(IndexKeyTest, TwoWordKeySearchTest) {
+    // Keys that tie on the first word and differ on the second, and the
+    // reverse, on both sides of the sign bit.
+    const uint64_t words[] = { 0, 1, 0x7fffffffffffffffULL, 0x8000000000000000ULL, 0xffffffffffffffffULL };
+    const int wordCount = static_cast<int>(sizeof(words) / sizeof(words[0]));
+    voltdb::IntsComparator<2> comparator(NULL);
+    typedef voltdb::BTreeKeySearch<voltdb::IntsKey<2>, voltdb::IntsComparator<2> > KeySearch;
+
+    std::vector<voltdb::IntsKey<2> > keys;
+    for (int ii = 0; ii < wordCount; ii++) {
+        for (int jj = 0; jj < wordCount; jj++) {
+            voltdb::IntsKey<2> key;
+            key.data[0] = words[ii];
+            key.data[1] = words[jj];
+            keys.push_back(key);
+        }
+    }
+    const int keyCount = static_cast<int>(keys.size());
+
+    for (int count = 0; count <= keyCount; count++) {
+        for (int tt = 0; tt < keyCount; tt++) {
+            for (int delta = -1; delta <= 1; delta++) {
+                voltdb::IntsKey<2> target = keys[tt];
+                target.data[1] += delta;
+                int less = 0;
+                int notGreater = 0;
+                for (int ii = 0; ii < count; ii++) {
+                    less += comparator(keys[ii], target) < 0;
+                    notGreater += comparator(keys[ii], target) <= 0;
+                }
+                EXPECT_EQ(less, KeySearch::countBefore(&keys[0], sizeof(voltdb::IntsKey<2>), count, target,
+                                                       false, comparator));
+                EXPECT_EQ(notGreater, KeySearch::countBefore(&keys[0], sizeof(voltdb::IntsKey<2>), count, target,
+                                                             true, comparator));
+            }
+        }
+    }
+}
+
+TEST_F(IndexKeyTest, NormalizedKeyOrdersAsGenericKey) {
+    std::vector<voltdb::ValueType> columnTypes;
+    std::vector<int32_t> columnLengths;
+    std::vector<bool> columnInBytes;
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARCHAR);   columnLengths.push_back(6); columnInBytes.push_back(true);
+    columnTypes.push_back(voltdb::VALUE_TYPE_INTEGER);   columnLengths.push_back(4); columnInBytes.push_back(false);
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARBINARY); columnLengths.push_back(3); columnInBytes.push_back(false);
+    columnTypes.push_back(voltdb::VALUE_TYPE_TINYINT);   columnLengths.push_back(1); columnInBytes.push_back(false);
+    std::vector<bool> columnAllowNull(columnTypes.size(), true);
+    voltdb::TupleSchema *keySchema = voltdb::TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                                                          columnAllowNull, columnInBytes);
+    ASSERT_TRUE(voltdb::isNormalizableKeySchema(keySchema));
+    ASSERT_TRUE(keySchema->tupleLength() <= 32);
+
+    // Strings that are prefixes of each other, empty, NUL-embedded or with
+    // high bytes, and integers at and near their NULL values.
+    const char *strings[] = { "", "a", "ab", "a\0b", "a\0c", "\xff", "zzzzzz" };
+    const int stringLengths[] = { 0, 1, 2, 3, 3, 1, 6 };
+    const int stringCount = static_cast<int>(sizeof(stringLengths) / sizeof(stringLengths[0]));
+    const int32_t integers[] = { INT32_NULL, INT32_NULL + 1, -1, 0, INT32_MAX };
+    const int8_t tinyints[] = { INT8_NULL, 0, INT8_MAX };
+
+    voltdb::GenericComparator<32> genericComparator(keySchema);
+    voltdb::NormalizedComparator<32> normalizedComparator(keySchema);
+    voltdb::NormalizedEqualityChecker<32> normalizedEquality(keySchema);
+    voltdb::NormalizedHasher<32> normalizedHasher(keySchema);
+
+    std::vector<voltdb::GenericKey<32> > genericKeys;
+    std::vector<voltdb::NormalizedKey<32> > normalizedKeys;
+    voltdb::TableTuple keyTuple(keySchema);
+    keyTuple.move(new char[keyTuple.tupleLength()]);
+    srand(0);
+    for (int ii = 0; ii < 400; ii++) {
+        int pick = rand() % (stringCount + 1);
+        NValue varchar = pick == stringCount ? ValueFactory::getNullStringValue() :
+                ValueFactory::getStringValue(std::string(strings[pick], stringLengths[pick]));
+        keyTuple.setNValue(0, varchar);
+        varchar.free();
+        keyTuple.setNValue(1, ValueFactory::getIntegerValue(integers[rand() % 5]));
+        pick = rand() % (stringCount + 1);
+        NValue varbinary = pick == stringCount || stringLengths[pick] > 3 ? ValueFactory::getNullBinaryValue() :
+                ValueFactory::getBinaryValue(reinterpret_cast<const unsigned char*>(strings[pick]),
+                                             stringLengths[pick]);
+        keyTuple.setNValue(2, varbinary);
+        varbinary.free();
+        keyTuple.setNValue(3, ValueFactory::getTinyIntValue(tinyints[rand() % 3]));
+        genericKeys.push_back(voltdb::GenericKey<32>(&keyTuple));
+        normalizedKeys.push_back(voltdb::NormalizedKey<32>(&keyTuple));
+    }
+
+    for (int ii = 0; ii < genericKeys.size(); ii++) {
+        for (int jj = 0; jj < genericKeys.size(); jj++) {
+            int expected = genericComparator(genericKeys[ii], genericKeys[jj]);
+            expected = (expected > 0) - (expected < 0);
+            ASSERT_EQ(expected, normalizedComparator(normalizedKeys[ii], normalizedKeys[jj]));
+            ASSERT_EQ(expected == 0, normalizedEquality(normalizedKeys[ii], normalizedKeys[jj]));
+            if (expected == 0) {
+                ASSERT_EQ(normalizedHasher(normalizedKeys[ii]), normalizedHasher(normalizedKeys[jj]));
+            }
+        }
+    }
+
+    delete [] keyTuple.address();
+    voltdb::TupleSchema::freeTupleSchema(keySchema);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
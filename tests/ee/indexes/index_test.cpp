@@ -50,6 +50,7 @@
  */
 
 #include <boost/foreach.hpp>
+#include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 
 #include "harness.h"
@@ -59,6 +60,7 @@
 #include "common/debuglog.h"
 #include "common/SerializableEEException.h"
 #include "common/tabletuple.h"
+#include "common/TupleSchemaBuilder.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
 #include "storage/persistenttable.h"
@@ -70,6 +72,9 @@
 #include "indexes/tableindexfactory.h"
 #include "execution/VoltDBEngine.h"
 #include "common/ThreadLocalPool.h"
+#include "expressions/comparisonexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "common/FixUnusedAssertHack.h"
 
 
@@ -384,6 +389,113 @@ public:
                         .op_equals(tuple.getNValue(i)).isTrue());
     }
 
+    // Batched lookups must land every cursor exactly where a single
+    // moveToKey on the same key would, in the order the keys were given.
+    void verifyBatchedLookups(TableIndex *index, int64_t firstKey, int64_t lastKey)
+    {
+        vector<ValueType> keyColumnTypes(1, VALUE_TYPE_BIGINT);
+        vector<int32_t> keyColumnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        vector<bool> keyColumnAllowNull(1, true);
+        TupleSchema* keySchema =
+            TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                                  keyColumnLengths,
+                                                  keyColumnAllowNull);
+        const int keyCount = static_cast<int>(lastKey - firstKey + 1);
+        const int keyLength = keySchema->tupleLength() + TUPLE_HEADER_SIZE;
+        vector<char> keyStorage(keyCount * keyLength);
+        vector<TableTuple> keyTuples;
+        vector<const TableTuple*> searchKeys;
+        keyTuples.reserve(keyCount);
+        for (int ii = 0; ii < keyCount; ii++) {
+            keyTuples.push_back(TableTuple(&keyStorage[ii * keyLength], keySchema));
+            keyTuples.back().setNValue(0, ValueFactory::getBigIntValue(firstKey + ii));
+        }
+        // Probe in reverse so that the input order differs from key order.
+        for (int ii = keyCount - 1; ii >= 0; ii--) {
+            searchKeys.push_back(&keyTuples[ii]);
+        }
+
+        vector<IndexCursor> cursors(keyCount, IndexCursor(index->getTupleSchema()));
+        int matches = index->moveToKeys(searchKeys, cursors);
+
+        int expectedMatches = 0;
+        for (int ii = 0; ii < keyCount; ii++) {
+            IndexCursor single(index->getTupleSchema());
+            bool found = index->moveToKey(searchKeys[ii], single);
+            if (found) {
+                expectedMatches++;
+            }
+            TableTuple expected;
+            TableTuple actual;
+            do {
+                expected = index->nextValueAtKey(single);
+                actual = index->nextValueAtKey(cursors[ii]);
+                EXPECT_EQ(expected.address(), actual.address());
+            } while (!expected.isNullTuple() && !actual.isNullTuple());
+        }
+        EXPECT_EQ(expectedMatches, matches);
+        EXPECT_TRUE(matches > 0);
+        EXPECT_TRUE(matches < keyCount);
+
+        TupleSchema::freeTupleSchema(keySchema);
+    }
+
+    // Skipping entries must land a cursor where stepping past them would,
+    // scanning either way from the start or from an exact key.
+    void verifySkippedEntries(TableIndex *index, int64_t key)
+    {
+        vector<ValueType> keyColumnTypes(1, VALUE_TYPE_BIGINT);
+        vector<int32_t> keyColumnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        vector<bool> keyColumnAllowNull(1, true);
+        TupleSchema* keySchema =
+            TupleSchema::createTupleSchemaForTest(keyColumnTypes,
+                                                  keyColumnLengths,
+                                                  keyColumnAllowNull);
+        StandAloneTupleStorage keyStorage(keySchema);
+        TableTuple searchKey = keyStorage.tuple();
+        searchKey.setNValue(0, ValueFactory::getBigIntValue(key));
+
+        const int64_t skips[] = { 0, 1, 2, 17, 333, NUM_OF_TUPLES - 1, NUM_OF_TUPLES, NUM_OF_TUPLES + 5 };
+        for (int ii = 0; ii < static_cast<int>(sizeof(skips) / sizeof(skips[0])); ii++) {
+            for (int scan = 0; scan < 3; scan++) {
+                IndexCursor skipped(index->getTupleSchema());
+                IndexCursor stepped(index->getTupleSchema());
+                if (scan == 2) {
+                    index->moveToKey(&searchKey, skipped);
+                    index->moveToKey(&searchKey, stepped);
+                }
+                else {
+                    index->moveToEnd(scan == 0, skipped);
+                    index->moveToEnd(scan == 0, stepped);
+                }
+                ASSERT_TRUE(index->skipEntries(skipped, skips[ii]));
+                for (int64_t step = 0; step < skips[ii]; step++) {
+                    if (scan == 2) {
+                        index->nextValueAtKey(stepped);
+                    }
+                    else {
+                        index->nextValue(stepped);
+                    }
+                }
+                TableTuple expected;
+                TableTuple actual;
+                do {
+                    if (scan == 2) {
+                        expected = index->nextValueAtKey(stepped);
+                        actual = index->nextValueAtKey(skipped);
+                    }
+                    else {
+                        expected = index->nextValue(stepped);
+                        actual = index->nextValue(skipped);
+                    }
+                    ASSERT_EQ(expected.address(), actual.address());
+                } while (!expected.isNullTuple());
+            }
+        }
+
+        TupleSchema::freeTupleSchema(keySchema);
+    }
+
 protected:
     PersistentTable* table;
     char* m_exceptionBuffer;
@@ -1114,6 +1226,235 @@ TEST_F(IndexTest, ReentrantHashMultiple) {
 }
 
 
+TEST_F(IndexTest, PartialIndexMaintenance) {
+    vector<int> column_indices(1, 0);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("ixfull", BALANCED_TREE_INDEX, column_indices, column_types, true);
+
+    // Only index tuples whose second column is 1.
+    AbstractExpression *predicate =
+        new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                        new TupleValueExpression(0, 1),
+                                        new ConstantValueExpression(ValueFactory::getBigIntValue(1)));
+    TableIndexScheme scheme("ixpartial", BALANCED_TREE_INDEX, column_indices,
+                            TableIndex::simplyIndexColumns(), predicate,
+                            true, true, "", "", table->schema());
+    boost::scoped_ptr<TableIndex> index(TableIndexFactory::getInstance(scheme));
+
+    const size_t TUPLE_COUNT = 10;
+    boost::scoped_array<StandAloneTupleStorage> storage(new StandAloneTupleStorage[TUPLE_COUNT]);
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        storage[ii].init(table->schema());
+        const TableTuple &tuple = storage[ii].tuple();
+        const int64_t value = static_cast<int64_t>(ii);
+        for (int col = 0; col < NUM_OF_COLUMNS; col++) {
+            tuple.setNValue(col, ValueFactory::getBigIntValue(col == 1 ? value % 2 : value));
+        }
+        index->addEntry(&tuple, NULL);
+    }
+    EXPECT_EQ(TUPLE_COUNT / 2, index->getSize());
+    EXPECT_TRUE(index->exists(&storage[1].tuple()));
+    EXPECT_FALSE(index->exists(&storage[2].tuple()));
+
+    // Deleting a tuple the predicate rejects leaves the index alone.
+    EXPECT_TRUE(index->deleteEntry(&storage[2].tuple()));
+    EXPECT_EQ(TUPLE_COUNT / 2, index->getSize());
+
+    StandAloneTupleStorage updated(table->schema());
+    TableTuple after = updated.tuple();
+    after.copy(storage[3].tuple());
+    EXPECT_FALSE(index->checkForIndexChange(&storage[3].tuple(), &after));
+
+    // An update out of the predicate drops the entry ...
+    after.setNValue(1, ValueFactory::getBigIntValue(0));
+    EXPECT_TRUE(index->checkForIndexChange(&storage[3].tuple(), &after));
+    EXPECT_TRUE(index->replaceEntryNoKeyChange(after, storage[3].tuple()));
+    EXPECT_EQ(TUPLE_COUNT / 2 - 1, index->getSize());
+    EXPECT_FALSE(index->exists(&storage[3].tuple()));
+
+    // ... and one into it adds it back.
+    EXPECT_TRUE(index->checkForIndexChange(&after, &storage[3].tuple()));
+    EXPECT_TRUE(index->replaceEntryNoKeyChange(storage[3].tuple(), after));
+    EXPECT_EQ(TUPLE_COUNT / 2, index->getSize());
+    EXPECT_TRUE(index->exists(&storage[3].tuple()));
+
+    // Neither version passes the predicate.
+    StandAloneTupleStorage other(table->schema());
+    TableTuple otherTuple = other.tuple();
+    otherTuple.copy(storage[4].tuple());
+    otherTuple.setNValue(2, ValueFactory::getBigIntValue(-4));
+    EXPECT_FALSE(index->checkForIndexChange(&storage[4].tuple(), &otherTuple));
+    EXPECT_TRUE(index->replaceEntryNoKeyChange(otherTuple, storage[4].tuple()));
+    EXPECT_EQ(TUPLE_COUNT / 2, index->getSize());
+}
+
+TEST_F(IndexTest, KeyFilterTreeUnique) {
+    vector<int> column_indices(1, 0);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("ixfull", BALANCED_TREE_INDEX, column_indices, column_types, true);
+    TableIndexScheme scheme("ixfiltered", BALANCED_TREE_INDEX, column_indices,
+                            TableIndex::simplyIndexColumns(), true, false, table->schema());
+    boost::scoped_ptr<TableIndex> index(TableIndexFactory::getInstance(scheme));
+
+    // Enough even keys for the index to put a filter in front of its
+    // lookups, and odd keys that were never added.
+    const size_t TUPLE_COUNT = 40000;
+    boost::scoped_array<StandAloneTupleStorage> storage(new StandAloneTupleStorage[TUPLE_COUNT]);
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        storage[ii].init(table->schema());
+        const TableTuple &tuple = storage[ii].tuple();
+        for (int col = 0; col < NUM_OF_COLUMNS; col++) {
+            tuple.setNValue(col, ValueFactory::getBigIntValue(static_cast<int64_t>(ii)));
+        }
+        if (ii % 2 == 0) {
+            index->addEntry(&tuple, NULL);
+        }
+    }
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        ASSERT_EQ(ii % 2 == 0, index->exists(&storage[ii].tuple()));
+    }
+
+    // Deleted keys are missed both before and after the filter is rebuilt,
+    // including once the index is small enough to drop it.
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii += 4) {
+        EXPECT_TRUE(index->deleteEntry(&storage[ii].tuple()));
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+            ASSERT_EQ(ii % 4 == 2, index->exists(&storage[ii].tuple()));
+            ASSERT_EQ(ii % 4 == 2, ! index->uniqueMatchingTuple(storage[ii].tuple()).isNullTuple());
+        }
+        index->rebuildKeyFilter();
+    }
+    for (size_t ii = 2; ii < TUPLE_COUNT; ii += 8) {
+        EXPECT_TRUE(index->deleteEntry(&storage[ii].tuple()));
+    }
+    index->rebuildKeyFilter();
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        ASSERT_EQ(ii % 8 == 6, index->exists(&storage[ii].tuple()));
+    }
+}
+
+TEST_F(IndexTest, NonInlinedStringKeysOfDeletedRows) {
+    vector<int> column_indices(1, 0);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("ixfull", BALANCED_TREE_INDEX, column_indices, column_types, true);
+    // The keys point at the rows' own strings.
+    TupleSchemaBuilder builder(1);
+    builder.setColumnAtIndex(0, VALUE_TYPE_VARCHAR, 100);
+    TupleSchema *schema = builder.build();
+    TableIndexScheme scheme("ixstring", BALANCED_TREE_INDEX, column_indices,
+                            TableIndex::simplyIndexColumns(), true, true, schema);
+    boost::scoped_ptr<TableIndex> index(TableIndexFactory::getInstance(scheme));
+
+    // Add the keys out of order, so the tree's nodes are well over half full
+    // and keep their separators when a few of their keys are deleted.
+    const size_t TUPLE_COUNT = 4000;
+    const size_t STRIDE = 7919;
+    const size_t DELETED_EVERY = 4;
+    char value[32];
+    boost::scoped_array<StandAloneTupleStorage> storage(new StandAloneTupleStorage[TUPLE_COUNT]);
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        storage[ii].init(schema);
+        snprintf(value, sizeof(value), "key %06d", static_cast<int>(ii));
+        storage[ii].tuple().setNValueAllocateForObjectCopies(0, ValueFactory::getTempStringValue(value), NULL);
+    }
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        TableTuple tuple = storage[ii * STRIDE % TUPLE_COUNT].tuple();
+        index->addEntry(&tuple, NULL);
+    }
+
+    // Delete every fourth row, among them the first key of many leaves, and
+    // hand each freed string to a new row whose key sorts after all others.
+    boost::scoped_array<StandAloneTupleStorage> others(new StandAloneTupleStorage[TUPLE_COUNT / DELETED_EVERY]);
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii += DELETED_EVERY) {
+        EXPECT_TRUE(index->deleteEntry(&storage[ii].tuple()));
+        storage[ii].tuple().freeObjectColumns();
+        StandAloneTupleStorage &other = others[ii / DELETED_EVERY];
+        other.init(schema);
+        snprintf(value, sizeof(value), "zzz %06d", static_cast<int>(ii));
+        other.tuple().setNValueAllocateForObjectCopies(0, ValueFactory::getTempStringValue(value), NULL);
+    }
+
+    // Probes across the leaves the deleted keys led still find every key.
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        ASSERT_EQ(ii % DELETED_EVERY != 0, index->exists(&storage[ii].tuple()));
+    }
+    IndexCursor cursor(index->getTupleSchema());
+    index->moveToEnd(true, cursor);
+    size_t expected = 1;
+    for (TableTuple found = index->nextValue(cursor); ! found.isNullTuple(); found = index->nextValue(cursor)) {
+        ASSERT_EQ(storage[expected].tuple().address(), found.address());
+        expected++;
+        if (expected % DELETED_EVERY == 0) {
+            expected++;
+        }
+    }
+    EXPECT_EQ(TUPLE_COUNT + 1, expected);
+
+    for (size_t ii = 0; ii < TUPLE_COUNT; ii++) {
+        if (ii % DELETED_EVERY != 0) {
+            storage[ii].tuple().freeObjectColumns();
+        }
+    }
+    for (size_t ii = 0; ii < TUPLE_COUNT / DELETED_EVERY; ii++) {
+        others[ii].tuple().freeObjectColumns();
+    }
+    index.reset();
+    TupleSchema::freeTupleSchema(schema);
+}
+
+TEST_F(IndexTest, BatchedLookupsTreeUnique) {
+    vector<int> column_indices(1, 3);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("btu", BALANCED_TREE_INDEX, column_indices, column_types, true);
+    verifyBatchedLookups(table->index("btu"), 0, 1040);
+}
+
+TEST_F(IndexTest, BatchedLookupsTreeMulti) {
+    vector<int> column_indices(1, 2);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("btm", BALANCED_TREE_INDEX, column_indices, column_types, false);
+    verifyBatchedLookups(table->index("btm"), -2, 40);
+}
+
+TEST_F(IndexTest, BatchedLookupsHashUnique) {
+    vector<int> column_indices(1, 3);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("bhu", HASH_TABLE_INDEX, column_indices, column_types, true);
+    verifyBatchedLookups(table->index("bhu"), 0, 1040);
+}
+
+TEST_F(IndexTest, BatchedLookupsHashMulti) {
+    vector<int> column_indices(1, 2);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("bhm", HASH_TABLE_INDEX, column_indices, column_types, false);
+    verifyBatchedLookups(table->index("bhm"), -2, 40);
+}
+
+TEST_F(IndexTest, SkipEntriesTreeUnique) {
+    vector<int> column_indices(1, 3);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("stu", BALANCED_TREE_INDEX, column_indices, column_types, true);
+    verifySkippedEntries(table->index("stu"), 321);
+}
+
+TEST_F(IndexTest, SkipEntriesTreeMulti) {
+    vector<int> column_indices(1, 2);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("stm", BALANCED_TREE_INDEX, column_indices, column_types, false);
+    verifySkippedEntries(table->index("stm"), 1);
+}
+
+TEST_F(IndexTest, SkipEntriesHash) {
+    vector<int> column_indices(1, 3);
+    vector<ValueType> column_types(1, VALUE_TYPE_BIGINT);
+    init("shu", HASH_TABLE_INDEX, column_indices, column_types, true);
+    IndexCursor cursor(table->index("shu")->getTupleSchema());
+    EXPECT_FALSE(table->index("shu")->skipEntries(cursor, 1));
+}
+
+
 int main()
 {
     return TestSuite::globalInstance()->runAll();
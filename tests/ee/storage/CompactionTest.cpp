@@ -370,6 +370,70 @@ TEST_F(CompactionTest, BasicCompaction) {
     ASSERT_EQ( m_table->activeTupleCount(), 0);
 }
 
+TEST_F(CompactionTest, IncrementalCompaction) {
+    initTable();
+#ifdef MEMCHECK
+    int tupleCount = 1000;
+    const int64_t maxTuplesToMove = 10;
+#else
+    int tupleCount = 645260;
+    const int64_t maxTuplesToMove = 4096;
+#endif
+    addRandomUniqueTuples( m_table, tupleCount);
+
+    stx::btree_set<int32_t> pkeysNotDeleted;
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+
+    for (int ii = 0; ii < tupleCount; ii ++) {
+        if (ii % 2 != 0) {
+            pkeysNotDeleted.insert(ii);
+            continue;
+        }
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        m_table->deleteTuple(tuple, true);
+    }
+    size_t blockCountBefore = m_table->m_data.size();
+
+    // Each call stays within its tuple budget, and the calls together
+    // finish the compaction.
+    int calls = 0;
+    bool moreWork = true;
+    while (moreWork) {
+        int64_t compactedTupleCountBefore = m_table->compactedTupleCount();
+        moreWork = m_table->doIncrementalCompaction(maxTuplesToMove, INT64_MAX);
+        int64_t tuplesMoved = m_table->compactedTupleCount() - compactedTupleCountBefore;
+        ASSERT_TRUE(tuplesMoved <= maxTuplesToMove);
+        if (moreWork) {
+            ASSERT_TRUE(tuplesMoved > 0);
+        }
+        ASSERT_TRUE(++calls < tupleCount);
+    }
+    ASSERT_TRUE(calls > 1);
+    ASSERT_TRUE(m_table->m_data.size() < blockCountBefore);
+    ASSERT_EQ(tupleCount / 2, m_table->activeTupleCount());
+
+    stx::btree_set<int32_t> pkeysFound;
+    TableIterator& iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+        key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+        for (int ii = 0; ii < 4; ii++) {
+            ASSERT_TRUE(m_table->m_indexes[ii]->moveToKey(&key, indexCursor));
+            TableTuple indexTuple = m_table->m_indexes[ii]->nextValueAtKey(indexCursor);
+            ASSERT_EQ(indexTuple.address(), tuple.address());
+        }
+        pkeysFound.insert(pkey);
+    }
+    ASSERT_TRUE(pkeysFound == pkeysNotDeleted);
+}
+
 TEST_F(CompactionTest, CompactionWithCopyOnWrite) {
     initTable();
 #ifdef MEMCHECK
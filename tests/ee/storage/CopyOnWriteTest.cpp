@@ -917,7 +917,8 @@ public:
     void parsePredicateList(const std::vector<std::string> &predicateStrings, StreamPredicateList &predicates) {
         std::ostringstream errmsg;
         std::vector<bool> deleteFlags;
-        ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags));
+        std::vector<TupleOutputStream::RowFormat> rowFormats;
+        ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags, rowFormats));
     }
 
     boost::shared_ptr<ReferenceSerializeInputBE> getPredicateSerializeInput(const std::vector<std::string> &predicateStrings) {
@@ -959,6 +960,15 @@ public:
         return false;
     }
 
+    bool setElasticIndexMaxMicrosPerCall(int64_t maxMicrosPerCall) {
+        voltdb::ElasticContext *context = getElasticContext();
+        if (context != NULL) {
+            context->setMaxMicrosPerCall(maxMicrosPerCall);
+            return true;
+        }
+        return false;
+    }
+
     void streamElasticIndex(std::vector<std::string> &predicateStrings, bool checkCalls) {
         boost::shared_ptr<ReferenceSerializeInputBE> predicateInput = getPredicateSerializeInput(predicateStrings);
         bool ok = m_table->activateStream(TABLE_STREAM_ELASTIC_INDEX, 0, m_tableId, *predicateInput);
@@ -1223,6 +1233,45 @@ TEST_F(CopyOnWriteTest, TestTupleInsertionBetweenSnapshotActivateFinish) {
     ASSERT_EQ(tupleCount, m_table->visibleTupleCount());
 }
 
+/**
+ * The block copies a snapshot takes on the first update of a block it has
+ * not scanned yet are counted until the snapshot ends.
+ */
+TEST_F(CopyOnWriteTest, FrozenBlockCopiesAreCounted) {
+    initTable(1, 8192);
+    addRandomUniqueTuples(m_table, 1000);
+    ASSERT_TRUE(m_table->allocatedBlockCount() > 2);
+    ASSERT_EQ(0, m_table->snapshotCopyMemory());
+
+    char config[4];
+    ::memset(config, 0, 4);
+    ReferenceSerializeInputBE input(config, 4);
+    m_table->activateStream(TABLE_STREAM_SNAPSHOT, 0, m_tableId, input);
+
+    // The last tuple is in a block the scan has not reached.
+    TableTuple tuple(m_table->schema());
+    TableTuple lastTuple(m_table->schema());
+    voltdb::TableIterator& iterator = m_table->iterator();
+    while (iterator.next(tuple)) {
+        lastTuple = tuple;
+    }
+    updateSpecificTuple(m_table, lastTuple);
+    int64_t copied = m_table->snapshotCopyMemory();
+    ASSERT_TRUE(copied > 0);
+    // A second update to the block copies nothing more.
+    updateSpecificTuple(m_table, lastTuple);
+    ASSERT_EQ(copied, m_table->snapshotCopyMemory());
+
+    char serializationBuffer[BUFFER_SIZE];
+    std::vector<int> retPositions;
+    int64_t remaining;
+    do {
+        TupleOutputStreamProcessor outputStreams(serializationBuffer, sizeof(serializationBuffer));
+        remaining = m_table->streamMore(outputStreams, TABLE_STREAM_SNAPSHOT, retPositions);
+    } while (remaining > 0);
+    ASSERT_EQ(0, m_table->snapshotCopyMemory());
+}
+
 TEST_F(CopyOnWriteTest, BigTest) {
     initTable(1, 0);
     int tupleCount = TUPLE_COUNT;
@@ -1595,6 +1644,77 @@ TEST_F(CopyOnWriteTest, BufferBoundaryCondition) {
     ASSERT_EQ(origPendingCount, curPendingCount);
 }
 
+/**
+ * A stream whose predicate asks for CSV rows gets a line per tuple, while
+ * a native stream fed by the same snapshot is unchanged.
+ */
+TEST_F(CopyOnWriteTest, CSVRowFormat) {
+    const int tupleCount = 1000;
+    initTable(1, 0);
+    addRandomUniqueTuples(m_table, tupleCount);
+
+    Json::FastWriter writer;
+    Json::Value nativePredicate;
+    nativePredicate["triggersDelete"] = false;
+    Json::Value csvPredicate;
+    csvPredicate["triggersDelete"] = false;
+    csvPredicate["rowFormat"] = "CSV";
+    char config[1024];
+    ReferenceSerializeOutput output(config, sizeof(config));
+    output.writeInt(2);
+    output.writeTextString(writer.write(nativePredicate));
+    output.writeTextString(writer.write(csvPredicate));
+    ReferenceSerializeInputBE input(config, output.position());
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_SNAPSHOT, 0, m_tableId, input));
+
+    boost::scoped_array<char> nativeBuffer(new char[BUFFER_SIZE]);
+    boost::scoped_array<char> csvBuffer(new char[BUFFER_SIZE]);
+    std::set<std::string> keys;
+    int nativeRows = 0;
+    int64_t remaining = tupleCount;
+    while (remaining > 0) {
+        TupleOutputStreamProcessor outputStreams;
+        outputStreams.add(nativeBuffer.get(), BUFFER_SIZE);
+        outputStreams.add(csvBuffer.get(), BUFFER_SIZE);
+        std::vector<int> retPositions;
+        remaining = m_table->streamMore(outputStreams, TABLE_STREAM_SNAPSHOT, retPositions);
+        ASSERT_TRUE(remaining >= 0);
+        ASSERT_EQ(2, retPositions.size());
+
+        // Both streams start with the partition id and the row count.
+        ReferenceSerializeInputBE nativeInput(nativeBuffer.get(), retPositions[0]);
+        nativeInput.readInt();
+        const int32_t nativeCount = nativeInput.readInt();
+        ReferenceSerializeInputBE csvInput(csvBuffer.get(), retPositions[1]);
+        csvInput.readInt();
+        ASSERT_EQ(nativeCount, csvInput.readInt());
+        nativeRows += nativeCount;
+
+        // Each line starts with the quoted primary key.
+        const std::string text(csvBuffer.get() + 2 * sizeof(int32_t),
+                               retPositions[1] - 2 * sizeof(int32_t));
+        int lines = 0;
+        for (std::size_t start = 0; start < text.size(); lines++) {
+            const std::size_t end = text.find('\n', start);
+            ASSERT_TRUE(end != std::string::npos);
+            ASSERT_EQ('"', text[start]);
+            keys.insert(text.substr(start + 1, text.find('"', start + 1) - start - 1));
+            start = end + 1;
+        }
+        ASSERT_EQ(nativeCount, lines);
+    }
+    ASSERT_EQ(tupleCount, nativeRows);
+
+    TableTuple tuple(m_table->schema());
+    TableIterator& iterator = m_table->iterator();
+    while (iterator.next(tuple)) {
+        const std::string key = boost::lexical_cast<std::string>(
+            ValuePeeker::peekInteger(tuple.getNValue(0)));
+        ASSERT_EQ(1, keys.count(key));
+    }
+    ASSERT_EQ(tupleCount, keys.size());
+}
+
 /**
  * Dummy TableStreamer for intercepting and tracking tuple notifications.
  */
@@ -1839,9 +1959,10 @@ TEST_F(CopyOnWriteTest, ElasticIndex) {
     std::vector<std::string> predicateStrings;
     predicateStrings.push_back(generateHashRangePredicate(ranges));
     std::vector<bool> deleteFlags;
+    std::vector<TupleOutputStream::RowFormat> rowFormats;
     StreamPredicateList predicates;
     std::ostringstream errmsg;
-    ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags));
+    ASSERT_TRUE(predicates.parseStrings(predicateStrings, errmsg, deleteFlags, rowFormats));
 
     DummyElasticTableStreamer *streamerPtr = new DummyElasticTableStreamer(*this, 0, predicateStrings);
     boost::shared_ptr<TableStreamerInterface> streamer(streamerPtr);
@@ -1981,6 +2102,77 @@ TEST_F(CopyOnWriteTest, SnapshotAndIndex) {
     }
 }
 
+/**
+ * Index creation calls stop at their time budget, however many tuples they
+ * are allowed.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexTimeBudget) {
+    const int NUM_INITIAL = 3000;
+    ElasticTableScrambler tableScrambler(*this, 1, 50, NUM_INITIAL, 0, 0, 0, 0);
+    tableScrambler.initialize();
+
+    T_HashRangeVector ranges;
+    ranges.push_back(T_HashRange(0x00000000, 0x7fffffff));
+    std::vector<std::string> predicateStrings;
+    predicateStrings.push_back(generateHashRangePredicate(ranges));
+    StreamPredicateList predicates;
+    parsePredicateList(predicateStrings, predicates);
+
+    boost::shared_ptr<ReferenceSerializeInputBE> predicateInput = getPredicateSerializeInput(predicateStrings);
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_ELASTIC_INDEX, 0, m_tableId, *predicateInput));
+    ASSERT_TRUE(setElasticIndexTuplesPerCall(NUM_INITIAL));
+    ASSERT_TRUE(setElasticIndexMaxMicrosPerCall(0));
+    std::vector<int> retPositions;
+    TupleOutputStreamProcessor outputStreams(m_serializationBuffer, sizeof(m_serializationBuffer));
+    int nCalls = 1;
+    while (m_table->streamMore(outputStreams, TABLE_STREAM_ELASTIC_INDEX, retPositions) != 0) {
+        nCalls++;
+    }
+    // One call per look at the clock.
+    ASSERT_EQ((NUM_INITIAL + 255) / 256, nCalls);
+    checkIndex("ElasticIndexTimeBudget", getElasticIndex(), predicates, false);
+}
+
+/**
+ * Streaming out a hash range deletes its tuples as one batch, which undo
+ * brings back whole and release frees, emptied blocks and all.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexReadDeletesInBatch) {
+    const int NUM_INITIAL = 3000;
+    ElasticTableScrambler tableScrambler(*this, 1, 50, NUM_INITIAL, 0, 0, 0, 0);
+    tableScrambler.initialize();
+
+    const int32_t maxint = std::numeric_limits<int32_t>::max();
+    const int32_t minint = std::numeric_limits<int32_t>::min();
+    T_HashRange range(minint, maxint);
+    std::vector<std::string> predicateStrings;
+    predicateStrings.push_back(generateHashRangePredicate(range));
+    StreamPredicateList predicates;
+    parsePredicateList(predicateStrings, predicates);
+    streamElasticIndex(predicateStrings, false);
+    const size_t indexSize = getElasticIndex()->size();
+    const size_t blockCount = m_table->allocatedBlockCount();
+    ASSERT_LT(1, blockCount);
+
+    ElasticIndex undoneIndex;
+    size_t totalStreamed;
+    materializeIndex(undoneIndex, range, true, totalStreamed);
+    ASSERT_EQ(indexSize, totalStreamed);
+    ASSERT_EQ(NUM_INITIAL, m_table->activeTupleCount());
+    ASSERT_EQ(NUM_INITIAL, m_table->primaryKeyIndex()->getSize());
+    ASSERT_EQ(blockCount, m_table->allocatedBlockCount());
+    checkIndex("ElasticIndexReadDeletesInBatch", getElasticIndex(), predicates, false);
+
+    ElasticIndex streamedIndex;
+    materializeIndex(streamedIndex, range, false, totalStreamed);
+    ASSERT_EQ(indexSize, totalStreamed);
+    ASSERT_EQ(0, getElasticIndex()->size());
+    ASSERT_EQ(NUM_INITIAL - indexSize, m_table->activeTupleCount());
+    ASSERT_EQ(NUM_INITIAL - indexSize, m_table->primaryKeyIndex()->getSize());
+    ASSERT_GT(blockCount, m_table->allocatedBlockCount());
+    ASSERT_TRUE(getSurgeon().blockCountConsistent());
+}
+
 TEST_F(CopyOnWriteTest, ElasticIndexLowerUpperBounds) {
     ElasticIndex index;
     ElasticIndexKey key1(1, (char *)&index);
@@ -1197,6 +1197,55 @@ TEST_F(DRBinaryLogTest, UpdateWithUniqueIndexWhenAAEnabled) {
     simpleUpdateTest();
 }
 
+TEST_F(DRBinaryLogTest, UpdateWithUniqueIndexSendsChangedColumns) {
+    createIndexes();
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 55555, "349508345.34583", "a thing", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433));
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    beginTxn(m_engine, 100, 100, 99, 71);
+    updateTuple(m_table, first_tuple, 42, "not that");
+    endTxn(m_engine, true);
+
+    ASSERT_TRUE(flush(100));
+    {
+        boost::shared_ptr<StreamBlock> sb = m_topend.blocks.front();
+        ReferenceSerializeInputLE taskInfo(m_topend.data.front().get() + sb->headerSize(), sb->offset());
+        EXPECT_EQ(DRTupleStream::PROTOCOL_VERSION, static_cast<uint8_t>(taskInfo.readByte()));
+        ASSERT_EQ(DR_RECORD_BEGIN_TXN, static_cast<DRRecordType>(taskInfo.readByte()));
+        taskInfo.readLong(); // uniqueId
+        taskInfo.readLong(); // sequenceNumber
+        taskInfo.readByte(); // hashFlag
+        taskInfo.readInt(); // txnLength
+        taskInfo.readInt(); // partitionHash
+        ASSERT_EQ(DR_RECORD_UPDATE_CHANGED_COLUMNS, static_cast<DRRecordType>(taskInfo.readByte()));
+        EXPECT_EQ(42, taskInfo.readLong());
+        EXPECT_EQ(m_table->getUniqueIndexForDR().second, static_cast<uint32_t>(taskInfo.readInt()));
+        int32_t keyRowLength = taskInfo.readInt();
+        taskInfo.getRawPointer(keyRowLength);
+        int32_t changedRowLength = taskInfo.readInt();
+        const uint8_t *columnMask = reinterpret_cast<const uint8_t*>(taskInfo.getRawPointer(changedRowLength));
+        // Only the inline varchar, column 3, changed
+        EXPECT_EQ(0x10, columnMask[0]);
+    }
+
+    flushAndApply(100);
+
+    EXPECT_EQ(1, m_tableReplica->activeTupleCount());
+    TableTuple expected_tuple = prepareTempTuple(m_table, 42, 55555, "349508345.34583", "not that", "this is a rather long string of text that is used to cause nvalue to use outline storage for the underlying data. It should be longer than 64 bytes.", 5433);
+    TableTuple tuple = m_tableReplica->lookupTupleByValues(expected_tuple);
+    ASSERT_FALSE(tuple.isNullTuple());
+}
+
+TEST_F(DRBinaryLogTest, UpdateWithUniqueIndexAtPreviousProtocolVersion) {
+    m_drStream.setProtocolVersion(DRTupleStream::COORDINATED_MP_PROTOCOL_VERSION);
+    createIndexes();
+    simpleUpdateTest();
+}
+
 TEST_F(DRBinaryLogTest, PartialTxnRollback) {
     beginTxn(m_engine, 98, 98, 97, 69);
     TableTuple first_tuple = insertTuple(m_table, prepareTempTuple(m_table, 99, 29058, "92384598.2342", "what", "really, why am I writing anything in these?", 3455));
@@ -1292,6 +1341,66 @@ TEST_F(DRBinaryLogTest, DetectInsertUniqueConstraintViolation) {
     EXPECT_EQ(2, exportStream->receivedTuples.size());
 }
 
+TEST_F(DRBinaryLogTest, InsertRunInOneTxn) {
+    createUniqueIndexes();
+
+    beginTxn(m_engine, 99, 99, 98, 70);
+    for (int i = 0; i < 10; i++) {
+        insertTuple(m_table, prepareTempTuple(m_table, static_cast<int8_t>(i), 1000 + i, "349508345.34583", "a thing", "a totally different thing altogether", i));
+    }
+    // a row of another table ends the run
+    TableTuple otherTuple = m_otherTableWithIndex->tempTuple();
+    otherTuple.setNValue(0, ValueFactory::getTinyIntValue(0));
+    otherTuple.setNValue(1, ValueFactory::getBigIntValue(0));
+    insertTuple(m_otherTableWithIndex, otherTuple);
+    insertTuple(m_table, prepareTempTuple(m_table, 10, 1010, "349508345.34583", "a thing", "a totally different thing altogether", 10));
+    endTxn(m_engine, true);
+
+    flushAndApply(99);
+
+    EXPECT_EQ(11, m_tableReplica->activeTupleCount());
+    EXPECT_EQ(1, m_otherTableWithIndexReplica->activeTupleCount());
+    for (int i = 0; i <= 10; i++) {
+        TableTuple tuple = m_tableReplica->lookupTupleByValues(prepareTempTuple(m_table, static_cast<int8_t>(i), 1000 + i, "349508345.34583", "a thing", "a totally different thing altogether", i));
+        ASSERT_FALSE(tuple.isNullTuple());
+    }
+}
+
+/*
+ * Conflict detection test case - Insert Unique Constraint Violation within a
+ * run of inserts, which then go in one at a time
+ */
+TEST_F(DRBinaryLogTest, DetectInsertUniqueConstraintViolationInRun) {
+    enableActiveActive();
+    createUniqueIndexes();
+    ASSERT_FALSE(flush(99));
+
+    // write transactions on replica
+    beginTxn(m_engineReplica, 100, 100, 99, 71);
+    TableTuple existingTuple = insertTuple(m_tableReplica, prepareTempTuple(m_tableReplica, 42, 34523,
+                "7565464.2342", "yes", "no no no, writing more words to make it outline?", 1234));
+    endTxn(m_engineReplica, true);
+    flushButDontApply(100);
+
+    // write transactions on master
+    beginTxn(m_engine, 101, 101, 100, 72);
+    insertTuple(m_table, prepareTempTuple(m_table, 41, 34522, "1.5", "before", "the row before the conflict", 3455));
+    TableTuple newTuple = insertTuple(m_table, prepareTempTuple(m_table, 42, 34523,
+            "92384598.2342", "what", "really, why am I writing anything in these?", 3455));
+    insertTuple(m_table, prepareTempTuple(m_table, 43, 34524, "2.5", "after", "the row after the conflict", 3455));
+    endTxn(m_engine, true);
+    // trigger a insert unique constraint violation conflict
+    flushAndApply(101);
+
+    EXPECT_EQ(m_topend.actionType, DR_RECORD_INSERT);
+    EXPECT_EQ(m_topend.insertConflictType, CONFLICT_CONSTRAINT_VIOLATION);
+    EXPECT_EQ(1, m_topend.newTupleRowsForInsert->activeTupleCount());
+    verifyNewTableForInsert(newTuple);
+
+    ASSERT_FALSE(m_tableReplica->lookupTupleByValues(prepareTempTuple(m_tableReplica, 41, 34522, "1.5", "before", "the row before the conflict", 3455)).isNullTuple());
+    ASSERT_FALSE(m_tableReplica->lookupTupleByValues(prepareTempTuple(m_tableReplica, 43, 34524, "2.5", "after", "the row after the conflict", 3455)).isNullTuple());
+}
+
 /*
  * Conflict detection test case - Delete Missing Tuple
  *
@@ -1929,6 +2038,8 @@ TEST_F(DRBinaryLogTest, InsertOverBufferLimit) {
 }
 
 TEST_F(DRBinaryLogTest, UpdateOverBufferLimit) {
+    // Full update records, as only those grow the txn past the buffer limit
+    m_drStream.setProtocolVersion(DRTupleStream::COORDINATED_MP_PROTOCOL_VERSION);
     createIndexes();
     const int total = 150;
     long spHandle = 1;
@@ -32,6 +32,7 @@
 #include "common/TupleSchema.h"
 #include "common/tabletuple.h"
 #include "common/StreamBlock.h"
+#include "common/UniqueId.hpp"
 #include "storage/DRTupleStream.h"
 #include "common/Topend.h"
 #include "common/executorcontext.hpp"
@@ -733,6 +734,35 @@ TEST_F(DRTupleStreamTest, BigBufferAfterExtendOnBeginTxn) {
     EXPECT_EQ(results->offset(),MAGIC_TRANSACTION_SIZE + MAGIC_TUPLE_SIZE * (tuples_to_fill + 1));
 }
 
+/**
+ * A partially filled buffer waits until its oldest transaction has been
+ * held for the flush interval, then goes out with what has come since.
+ */
+TEST_F(DRTupleStreamTest, FlushWhenOldestTxnReachesInterval) {
+    const int64_t startTime = 1500000000000LL;
+    m_wrapper.m_flushInterval = 10;
+
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        m_tuple->setNValue(i, ValueFactory::getIntegerValue(i));
+    }
+    int64_t uniqueId = UniqueId::makeIdFromComponents(startTime, 0, 42);
+    m_wrapper.appendTuple(addPartitionId(1), tableHandle, 0, addPartitionId(2), uniqueId, *m_tuple, DR_RECORD_INSERT);
+    m_wrapper.endTransaction(uniqueId);
+
+    m_wrapper.periodicFlush(startTime + 9, addPartitionId(2));
+    EXPECT_FALSE(m_topend.receivedDRBuffer);
+
+    uniqueId = UniqueId::makeIdFromComponents(startTime + 5, 0, 42);
+    m_wrapper.appendTuple(addPartitionId(2), tableHandle, 0, addPartitionId(3), uniqueId, *m_tuple, DR_RECORD_INSERT);
+    m_wrapper.endTransaction(uniqueId);
+
+    m_wrapper.periodicFlush(startTime + 10, addPartitionId(3));
+    ASSERT_TRUE(m_topend.receivedDRBuffer);
+    boost::shared_ptr<StreamBlock> results = m_topend.blocks.front();
+    EXPECT_EQ(results->uso(), 0);
+    EXPECT_EQ(results->offset(), MAGIC_TUPLE_PLUS_TRANSACTION_SIZE * 2);
+}
+
 TEST_F(DRTupleStreamTest, BufferEnforcesRowLimit) {
     m_topend.pushDRBufferRetval = 25;
 
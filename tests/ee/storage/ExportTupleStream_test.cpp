@@ -32,9 +32,13 @@
 #include "common/TupleSchema.h"
 #include "common/tabletuple.h"
 #include "common/StreamBlock.h"
+#include "common/ExportSerializeIo.h"
 #include "storage/ExportTupleStream.h"
 #include "common/Topend.h"
 #include "common/executorcontext.hpp"
+#include "expressions/comparisonexpression.h"
+#include "expressions/constantvalueexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "boost/smart_ptr.hpp"
 
 using namespace std;
@@ -240,6 +244,26 @@ TEST_F(ExportTupleStreamTest, BasicOps)
     EXPECT_TRUE(allocatedByteCount == 0);
 }
 
+/**
+ * Verify the bytes of the blocks the stream still holds
+ */
+TEST_F(ExportTupleStreamTest, PendingByteCount)
+{
+    // only the empty current block is held
+    const size_t oneBlock = m_wrapper->pendingByteCount();
+    EXPECT_EQ(BUFFER_SIZE, oneBlock);
+
+    // an open transaction that spills into a second block keeps both
+    for (int i = 0; i < 20; i++) {
+        appendTuple(1, 2);
+    }
+    EXPECT_EQ(2 * oneBlock, m_wrapper->pendingByteCount());
+
+    // once committed and flushed, the blocks belong to the top end
+    m_wrapper->periodicFlush(-1, 2);
+    EXPECT_EQ(oneBlock, m_wrapper->pendingByteCount());
+}
+
 /**
  * Verify that a periodicFlush with distant TXN IDs works properly
  */
@@ -498,6 +522,63 @@ TEST_F(ExportTupleStreamTest, RollbackWholeBuffer)
     EXPECT_EQ(results->offset(), (MAGIC_TUPLE_SIZE * 10));
 }
 
+/**
+ * A stream limited to some of the columns writes only those, with a null
+ * mask over the metadata columns and them.
+ */
+TEST_F(ExportTupleStreamTest, ProjectedColumns)
+{
+    std::vector<int> columns;
+    columns.push_back(3);
+    columns.push_back(0);
+    StreamPredicateList predicates;
+    m_wrapper->setFilter(columns, predicates);
+
+    m_tuple->setNValue(0, ValueFactory::getIntegerValue(10));
+    m_tuple->setNValue(3, ValueFactory::getIntegerValue(13));
+    m_wrapper->appendTuple(1, 2, 1, 1, 1, *m_tuple, ExportTupleStream::INSERT);
+    m_wrapper->periodicFlush(-1, 2);
+
+    // 4 byte row header, 1 byte null mask for 8 columns,
+    // 41 bytes of metadata and 2 integers
+    const int projectedTupleSize = 4 + 1 + 41 + 2 * 4;
+    ASSERT_TRUE(m_topend.receivedExportBuffer);
+    boost::shared_ptr<StreamBlock> results = m_topend.blocks.front();
+    EXPECT_EQ(results->offset(), projectedTupleSize);
+
+    const char *data = results->rawPtr() + results->headerSize();
+    ExportSerializeInput in(data + 4 + 1 + 41, 2 * 4);
+    EXPECT_EQ(13, in.readInt());
+    EXPECT_EQ(10, in.readInt());
+}
+
+/**
+ * The stream accepts the tuples any one of its predicates accepts.
+ */
+TEST_F(ExportTupleStreamTest, PredicatesFilterTuples)
+{
+    EXPECT_TRUE(m_wrapper->acceptsTuple(*m_tuple));
+
+    StreamPredicateList predicates;
+    predicates.push_back(new ComparisonExpression<CmpGt>(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                                         new TupleValueExpression(0, 0),
+                                                         new ConstantValueExpression(ValueFactory::getIntegerValue(100))));
+    predicates.push_back(new ComparisonExpression<CmpEq>(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                                         new TupleValueExpression(0, 1),
+                                                         new ConstantValueExpression(ValueFactory::getIntegerValue(7))));
+    m_wrapper->setFilter(std::vector<int>(), predicates);
+    EXPECT_TRUE(predicates.empty());
+
+    m_tuple->setNValue(0, ValueFactory::getIntegerValue(50));
+    m_tuple->setNValue(1, ValueFactory::getIntegerValue(6));
+    EXPECT_FALSE(m_wrapper->acceptsTuple(*m_tuple));
+    m_tuple->setNValue(0, ValueFactory::getIntegerValue(150));
+    EXPECT_TRUE(m_wrapper->acceptsTuple(*m_tuple));
+    m_tuple->setNValue(0, ValueFactory::getIntegerValue(50));
+    m_tuple->setNValue(1, ValueFactory::getIntegerValue(7));
+    EXPECT_TRUE(m_wrapper->acceptsTuple(*m_tuple));
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
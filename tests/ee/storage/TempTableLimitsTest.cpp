@@ -25,9 +25,21 @@
 
 #include "harness.h"
 #include "common/SQLException.h"
+#include "common/ThreadLocalPool.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/tabletuple.h"
 #include "logging/LogManager.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+#include "storage/TempBlockCache.h"
+#include "storage/TempTableSpill.h"
 
 #include <sstream>
+#include <string>
+#include <vector>
 
 using namespace voltdb;
 
@@ -68,6 +80,7 @@ public:
     }
 
     LogManager m_logManager;
+    ThreadLocalPool m_threadLocalPool;
 };
 
 TEST_F(TempTableLimitsTest, CheckLogLatch)
@@ -125,6 +138,97 @@ TEST_F(TempTableLimitsTest, CheckLimitException)
     EXPECT_TRUE(threw);
 }
 
+TEST_F(TempTableLimitsTest, SpillPastLimit)
+{
+    TempTableSpill spill("/tmp");
+    ASSERT_TRUE(spill.isUsable());
+    const int64_t memoryLimit = 1024 * 1024;
+    TempTableLimits dut(memoryLimit);
+    dut.setSpill(&spill);
+    EXPECT_TRUE(dut.canSpill());
+
+    std::vector<ValueType> columnTypes(1, VALUE_TYPE_BIGINT);
+    std::vector<int32_t> columnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    std::vector<bool> columnAllowNull(1, false);
+    std::vector<std::string> columnNames(1, "C0");
+    TupleSchema* schema = TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+    TempTable* table = TableFactory::buildTempTable("spilling", schema, columnNames, &dut);
+
+    // Several times what fits under the limit, which would have thrown.
+    const int64_t tupleCount = 4 * memoryLimit / 9;
+    TableTuple tuple = table->tempTuple();
+    for (int64_t ii = 0; ii < tupleCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(ii));
+        table->insertTempTuple(tuple);
+    }
+    EXPECT_TRUE(table->hasSpilledBlocks());
+    EXPECT_TRUE(dut.getAllocated() <= memoryLimit);
+    EXPECT_TRUE(spill.spilledBytes() > 0);
+
+    // The spilled tuples read back in order. The iterator holds on to the
+    // last block it read, so it goes out of scope before the delete.
+    {
+        TableIterator iterator = table->iterator();
+        TableTuple scanned(table->schema());
+        int64_t expected = 0;
+        while (iterator.next(scanned)) {
+            EXPECT_EQ(expected, ValuePeeker::peekAsBigInt(scanned.getNValue(0)));
+            ++expected;
+        }
+        EXPECT_EQ(tupleCount, expected);
+    }
+
+    // Spilled blocks give their space back and were never charged.
+    int64_t allocated = dut.getAllocated();
+    table->deleteAllTempTuples();
+    EXPECT_FALSE(table->hasSpilledBlocks());
+    EXPECT_TRUE(dut.getAllocated() < allocated);
+    delete table;
+    EXPECT_EQ(0, spill.spilledBytes());
+}
+
+TEST_F(TempTableLimitsTest, ReuseBlocksAcrossTables)
+{
+    std::vector<ValueType> columnTypes(1, VALUE_TYPE_BIGINT);
+    std::vector<int32_t> columnLengths(1, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+    std::vector<bool> columnAllowNull(1, false);
+    std::vector<std::string> columnNames(1, "C0");
+
+    // Temp tables of several blocks, filled and emptied as fragments would,
+    // sharing a cache with room for two blocks.
+    const int64_t tupleCount = 200 * 1024;
+    int64_t blockBytes = 0;
+    TempBlockCache* cache = NULL;
+    for (int pass = 0; pass < 3; pass++) {
+        TempTableLimits limits;
+        TupleSchema* schema =
+            TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+        TempTable* table = TableFactory::buildTempTable("recycled", schema, columnNames, &limits);
+        if (cache == NULL) {
+            blockBytes = table->getTableAllocationSize();
+            cache = new TempBlockCache(2 * blockBytes);
+        }
+        limits.setBlockCache(cache);
+
+        TableTuple tuple = table->tempTuple();
+        for (int64_t ii = 0; ii < tupleCount; ii++) {
+            tuple.setNValue(0, ValueFactory::getBigIntValue(ii));
+            table->insertTempTuple(tuple);
+        }
+        EXPECT_TRUE(limits.getAllocated() > 2 * blockBytes);
+        // The blocks came from the cache first.
+        EXPECT_EQ(0, cache->cachedBytes());
+
+        // Only the blocks held are charged; the cache keeps what it has room for.
+        table->deleteAllTempTuples();
+        EXPECT_EQ(blockBytes, limits.getAllocated());
+        EXPECT_EQ(2 * blockBytes, cache->cachedBytes());
+        delete table;
+        EXPECT_EQ(2 * blockBytes, cache->cachedBytes());
+    }
+    delete cache;
+}
+
 int main()
 {
     return TestSuite::globalInstance()->runAll();
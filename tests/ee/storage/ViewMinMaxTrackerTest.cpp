@@ -0,0 +1,129 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "storage/ViewMinMaxTracker.h"
+
+using namespace voltdb;
+
+class ViewMinMaxTrackerTest : public Test {
+protected:
+    static ViewMinMaxTracker::Key groupKey(int group) {
+        ViewMinMaxTracker::Key key;
+        key.push_back(ValueFactory::getIntegerValue(group));
+        return key;
+    }
+
+    static ViewMinMaxTracker::Key entry(int group, int64_t value) {
+        ViewMinMaxTracker::Key key = groupKey(group);
+        key.push_back(ValueFactory::getBigIntValue(value));
+        return key;
+    }
+
+    static int64_t best(const ViewMinMaxTracker &tracker, int group) {
+        NValue value;
+        if ( ! tracker.best(groupKey(group), value)) {
+            return -1;
+        }
+        return ValuePeeker::peekAsBigInt(value);
+    }
+};
+
+TEST_F(ViewMinMaxTrackerTest, MinSurvivesDeletes) {
+    ViewMinMaxTracker tracker(1, false);
+    tracker.add(entry(1, 30));
+    tracker.add(entry(1, 10));
+    tracker.add(entry(1, 10));
+    tracker.add(entry(1, 20));
+    tracker.add(entry(2, 5));
+    tracker.add(entry(0, 1));
+
+    EXPECT_EQ(10, best(tracker, 1));
+    // A duplicate of the minimum keeps it.
+    tracker.remove(entry(1, 10));
+    EXPECT_EQ(10, best(tracker, 1));
+    tracker.remove(entry(1, 10));
+    EXPECT_EQ(20, best(tracker, 1));
+    tracker.remove(entry(1, 20));
+    tracker.remove(entry(1, 30));
+    // Neither neighbouring group is taken for an empty one.
+    EXPECT_EQ(-1, best(tracker, 1));
+    EXPECT_EQ(5, best(tracker, 2));
+    EXPECT_EQ(1, best(tracker, 0));
+    EXPECT_EQ(2, tracker.size());
+}
+
+TEST_F(ViewMinMaxTrackerTest, MaxSurvivesDeletes) {
+    ViewMinMaxTracker tracker(1, true);
+    tracker.add(entry(1, 30));
+    tracker.add(entry(1, 10));
+    tracker.add(entry(1, 40));
+    tracker.add(entry(2, 50));
+
+    EXPECT_EQ(40, best(tracker, 1));
+    tracker.remove(entry(1, 40));
+    EXPECT_EQ(30, best(tracker, 1));
+    EXPECT_EQ(50, best(tracker, 2));
+    EXPECT_EQ(-1, best(tracker, 3));
+}
+
+TEST_F(ViewMinMaxTrackerTest, NoGroupBy) {
+    ViewMinMaxTracker tracker(0, false);
+    ViewMinMaxTracker::Key key;
+    key.push_back(ValueFactory::getBigIntValue(7));
+    tracker.add(key);
+    key[0] = ValueFactory::getBigIntValue(3);
+    tracker.add(key);
+
+    NValue value;
+    ASSERT_TRUE(tracker.best(ViewMinMaxTracker::Key(), value));
+    EXPECT_EQ(3, ValuePeeker::peekAsBigInt(value));
+    tracker.remove(key);
+    ASSERT_TRUE(tracker.best(ViewMinMaxTracker::Key(), value));
+    EXPECT_EQ(7, ValuePeeker::peekAsBigInt(value));
+}
+
+TEST_F(ViewMinMaxTrackerTest, UndoTakesBackTheChange) {
+    boost::shared_ptr<ViewMinMaxTracker> tracker(new ViewMinMaxTracker(1, false));
+    tracker->add(entry(1, 10));
+    tracker->add(entry(1, 20));
+
+    tracker->remove(entry(1, 10));
+    ViewMinMaxTrackerUndoAction undoRemove(tracker, entry(1, 10), false);
+    EXPECT_EQ(20, best(*tracker, 1));
+    undoRemove.undo();
+    EXPECT_EQ(10, best(*tracker, 1));
+
+    tracker->add(entry(1, 5));
+    ViewMinMaxTrackerUndoAction undoAdd(tracker, entry(1, 5), true);
+    EXPECT_EQ(5, best(*tracker, 1));
+    undoAdd.undo();
+    EXPECT_EQ(10, best(*tracker, 1));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -33,23 +33,47 @@
 #include "common/types.h"
 #include "common/TupleSchemaBuilder.h"
 #include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/TheHashinator.h"
+#include "common/LegacyHashinator.h"
+#include "common/RecoveryProtoMessage.h"
+#include "common/serializeio.h"
+#include "common/TupleOutputStream.h"
+#include "common/TupleOutputStreamProcessor.h"
 #include "execution/VoltDBEngine.h"
+#include "indexes/tableindex.h"
+#include "indexes/tableindexfactory.h"
+#include "storage/AbstractDRTupleStream.h"
+#include "storage/ColdStorage.h"
+#include "storage/ConstraintFailureException.h"
 #include "storage/table.h"
 #include "storage/persistenttable.h"
 #include "storage/tablefactory.h"
 #include "storage/tableutil.h"
+#include "storage/temptable.h"
+#include "storage/TupleStreamException.h"
 
+using voltdb::ColdStorage;
 using voltdb::ExecutorContext;
 using voltdb::NValue;
 using voltdb::PersistentTable;
+using voltdb::StandAloneTupleStorage;
 using voltdb::Table;
 using voltdb::TableFactory;
+using voltdb::TableIndex;
+using voltdb::TableIndexFactory;
+using voltdb::TableIndexScheme;
 using voltdb::TableIterator;
+using voltdb::ZoneBound;
 using voltdb::TableTuple;
+using voltdb::TempTable;
 using voltdb::TupleSchemaBuilder;
 using voltdb::VALUE_TYPE_BIGINT;
+using voltdb::VALUE_TYPE_INTEGER;
+using voltdb::VALUE_TYPE_TIMESTAMP;
 using voltdb::VALUE_TYPE_VARCHAR;
 using voltdb::ValueFactory;
+using voltdb::ValuePeeker;
 using voltdb::VoltDBEngine;
 using voltdb::tableutil;
 
@@ -100,12 +124,58 @@ protected:
         m_engine->setUndoToken(m_undoToken);
     }
 
+    // Release the current undo quantum without starting another, as
+    // between transactions.
+    void endWork() {
+        m_engine->releaseUndoToken(m_undoToken);
+        ++m_undoToken;
+    }
+
+    // Start an undo quantum after endWork, as a transaction would.
+    void beginUndo() {
+        m_engine->setUndoToken(m_undoToken);
+    }
+
     void rollback() {
         m_engine->undoUndoToken(m_undoToken);
         ++m_undoToken;
         m_engine->setUndoToken(m_undoToken);
     }
 
+    // A table of the builder's columns, named C0, C1, and so on. A
+    // blockSize of 0 gives the table the default block size.
+    static PersistentTable* createTable(const std::string &name,
+                                        const TupleSchemaBuilder &builder,
+                                        int blockSize = 0,
+                                        int partitionColumn = -1) {
+        voltdb::TupleSchema* schema = builder.build();
+        std::vector<std::string> columnNames;
+        char columnName[16];
+        for (int ii = 0; ii < schema->columnCount(); ii++) {
+            snprintf(columnName, sizeof(columnName), "C%d", ii);
+            columnNames.push_back(columnName);
+        }
+        char signature[20];
+        return dynamic_cast<PersistentTable*>(
+            TableFactory::getPersistentTable(0, name, schema, columnNames, signature,
+                                             false, partitionColumn, false, false, blockSize));
+    }
+
+    // A table as above, with a unique tree index on pkColumns, PK_IDX, as
+    // its primary key.
+    static PersistentTable* createTableWithPk(const std::string &name,
+                                              const TupleSchemaBuilder &builder,
+                                              const std::vector<int32_t> &pkColumns,
+                                              int blockSize = 0) {
+        PersistentTable* table = createTable(name, builder, blockSize);
+        TableIndex* pkIndex = TableIndexFactory::getInstance(
+            TableIndexScheme("PK_IDX", voltdb::BALANCED_TREE_INDEX, pkColumns,
+                             TableIndex::simplyIndexColumns(), true, true, table->schema()));
+        table->addIndex(pkIndex);
+        table->setPrimaryKeyIndex(pkIndex);
+        return table;
+    }
+
     static const std::string& catalogPayload() {
         static const std::string payload(
             "add / clusters cluster\n"
@@ -312,6 +382,1433 @@ TEST_F(PersistentTableTest, TruncateTableTest) {
     ASSERT_EQ(1, table->allocatedBlockCount());
 }
 
+TEST_F(PersistentTableTest, LoadTuplesInBatches) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("LOADED", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+    const voltdb::TupleSchema* schema = table->schema();
+
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(dataIndex);
+
+    beginWork();
+    TableTuple &existing = table->tempTuple();
+    existing.setNValue(0, ValueFactory::getIntegerValue(0));
+    existing.setNValue(1, ValueFactory::getTempStringValue("existing"));
+    table->insertTuple(existing);
+    commit();
+
+    // Enough rows for several batches, including a row whose key is already
+    // in the table and a row whose key is repeated within a batch.
+    const int rowCount = 3000;
+    boost::scoped_ptr<TempTable> rows(TableFactory::buildCopiedTempTable("ROWS", table.get(), NULL));
+    TableTuple &row = rows->tempTuple();
+    char data[32];
+    for (int ii = 0; ii <= rowCount; ii++) {
+        int pk = ii < rowCount ? ii : rowCount / 2;
+        snprintf(data, sizeof(data), "value %d", pk % 10);
+        row.setNValue(0, ValueFactory::getIntegerValue(pk));
+        row.setNValue(1, ValueFactory::getTempStringValue(data));
+        rows->insertTuple(row);
+    }
+    voltdb::CopySerializeOutput serializedRows;
+    rows->serializeTo(serializedRows);
+
+    char violationBuffer[256 * 1024];
+    for (int attempt = 0; attempt < 2; attempt++) {
+        beginWork();
+        voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                             serializedRows.size() - sizeof(int32_t));
+        voltdb::ReferenceSerializeOutput violations(violationBuffer, sizeof(violationBuffer));
+        table->loadTuplesFrom(in, NULL, &violations);
+        EXPECT_TRUE(violations.position() > sizeof(int32_t));
+
+        ASSERT_EQ(rowCount, table->activeTupleCount());
+        ASSERT_EQ(rowCount, pkIndex->getSize());
+        ASSERT_EQ(rowCount, dataIndex->getSize());
+        TableTuple key(pkIndex->getKeySchema());
+        char keyStorage[64];
+        key.moveNoHeader(keyStorage);
+        voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+        key.setNValue(0, ValueFactory::getIntegerValue(0));
+        ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+        TableTuple found = pkIndex->nextValueAtKey(cursor);
+        EXPECT_EQ(0, found.getNValue(1).compare(ValueFactory::getTempStringValue("existing")));
+        for (int ii = 1; ii < rowCount; ii++) {
+            key.setNValue(0, ValueFactory::getIntegerValue(ii));
+            ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+            found = pkIndex->nextValueAtKey(cursor);
+            ASSERT_EQ(ii, ValuePeeker::peekInteger(found.getNValue(0)));
+        }
+
+        if (attempt == 0) {
+            // The whole load is undone together.
+            rollback();
+            ASSERT_EQ(1, table->activeTupleCount());
+            ASSERT_EQ(1, pkIndex->getSize());
+            ASSERT_EQ(1, dataIndex->getSize());
+        }
+        else {
+            commit();
+            ASSERT_EQ(rowCount, table->activeTupleCount());
+        }
+    }
+}
+
+TEST_F(PersistentTableTest, LoadTuplesOnHelperThreads) {
+    TupleSchemaBuilder builder(3);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(2, voltdb::VALUE_TYPE_DOUBLE);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("STAGED", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+
+    // Enough rows for a few staged batches and a short last one, with the
+    // last row repeating a key.
+    const int rowCount = 20000;
+    boost::scoped_ptr<TempTable> rows(TableFactory::buildCopiedTempTable("ROWS", table.get(), NULL));
+    TableTuple &row = rows->tempTuple();
+    for (int ii = 0; ii <= rowCount; ii++) {
+        int pk = ii < rowCount ? ii : rowCount / 2;
+        row.setNValue(0, ValueFactory::getIntegerValue(pk));
+        row.setNValue(1, ValueFactory::getBigIntValue(static_cast<int64_t>(pk) << 33));
+        row.setNValue(2, ValueFactory::getDoubleValue(pk / 4.0));
+        rows->insertTuple(row);
+    }
+    voltdb::CopySerializeOutput serializedRows;
+    rows->serializeTo(serializedRows);
+
+    Table::setLoadHelperThreads(3);
+    char violationBuffer[256 * 1024];
+    beginWork();
+    {
+        voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                             serializedRows.size() - sizeof(int32_t));
+        voltdb::ReferenceSerializeOutput violations(violationBuffer, sizeof(violationBuffer));
+        table->loadTuplesFrom(in, NULL, &violations);
+        EXPECT_TRUE(violations.position() > sizeof(int32_t));
+    }
+    ASSERT_EQ(rowCount, table->activeTupleCount());
+    ASSERT_EQ(rowCount, pkIndex->getSize());
+    TableTuple key(pkIndex->getKeySchema());
+    char keyStorage[64];
+    key.moveNoHeader(keyStorage);
+    voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+    for (int ii = 0; ii < rowCount; ii++) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+        TableTuple found = pkIndex->nextValueAtKey(cursor);
+        ASSERT_EQ(static_cast<int64_t>(ii) << 33, ValuePeeker::peekBigInt(found.getNValue(1)));
+        ASSERT_EQ(ii / 4.0, ValuePeeker::peekDouble(found.getNValue(2)));
+    }
+    rollback();
+    ASSERT_EQ(0, table->activeTupleCount());
+
+    // A row of the wrong length fails the load.
+    const int32_t badLength = htonl(7);
+    std::string corrupted(serializedRows.data(), serializedRows.size());
+    corrupted.replace(corrupted.size() - 5 * (sizeof(int32_t) + 20), sizeof(int32_t),
+                      reinterpret_cast<const char*>(&badLength), sizeof(int32_t));
+    beginWork();
+    bool rejected = false;
+    try {
+        voltdb::ReferenceSerializeInputBE in(corrupted.data() + sizeof(int32_t),
+                                             corrupted.size() - sizeof(int32_t));
+        table->loadTuplesFrom(in);
+    }
+    catch (const voltdb::SerializableEEException &) {
+        rejected = true;
+    }
+    EXPECT_TRUE(rejected);
+    rollback();
+    ASSERT_EQ(0, table->activeTupleCount());
+    ASSERT_EQ(0, pkIndex->getSize());
+    Table::setLoadHelperThreads(0);
+}
+
+TEST_F(PersistentTableTest, LoadTuplesIntoEmptyTable) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("RESTORED", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+    const voltdb::TupleSchema* schema = table->schema();
+
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(dataIndex);
+
+    // The last row repeats a key, several batches in.
+    const int rowCount = 3000;
+    boost::scoped_ptr<TempTable> rows(TableFactory::buildCopiedTempTable("ROWS", table.get(), NULL));
+    TableTuple &row = rows->tempTuple();
+    char data[32];
+    for (int ii = 0; ii <= rowCount; ii++) {
+        int pk = ii < rowCount ? ii : rowCount / 2;
+        snprintf(data, sizeof(data), "value %d", pk % 10);
+        row.setNValue(0, ValueFactory::getIntegerValue(pk));
+        row.setNValue(1, ValueFactory::getTempStringValue(data));
+        rows->insertTuple(row);
+    }
+    voltdb::CopySerializeOutput serializedRows;
+    rows->serializeTo(serializedRows);
+
+    // Without a place to report it, the violation fails the load. The
+    // non-unique index still covers the rows left behind for undo.
+    beginWork();
+    {
+        voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                             serializedRows.size() - sizeof(int32_t));
+        bool failed = false;
+        try {
+            table->loadTuplesFrom(in, NULL, NULL);
+        }
+        catch (const voltdb::ConstraintFailureException&) {
+            failed = true;
+        }
+        EXPECT_TRUE(failed);
+    }
+    ASSERT_EQ(2, table->allIndexes().size());
+    ASSERT_EQ(table->activeTupleCount(), pkIndex->getSize());
+    ASSERT_EQ(table->activeTupleCount(), dataIndex->getSize());
+    rollback();
+    ASSERT_EQ(0, table->activeTupleCount());
+    ASSERT_EQ(0, pkIndex->getSize());
+    ASSERT_EQ(0, dataIndex->getSize());
+
+    char violationBuffer[256 * 1024];
+    beginWork();
+    voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                         serializedRows.size() - sizeof(int32_t));
+    voltdb::ReferenceSerializeOutput violations(violationBuffer, sizeof(violationBuffer));
+    table->loadTuplesFrom(in, NULL, &violations);
+    EXPECT_TRUE(violations.position() > sizeof(int32_t));
+    commit();
+
+    ASSERT_EQ(2, table->allIndexes().size());
+    ASSERT_EQ(rowCount, table->activeTupleCount());
+    ASSERT_EQ(rowCount, pkIndex->getSize());
+    ASSERT_EQ(rowCount, dataIndex->getSize());
+    TableTuple key(dataIndex->getKeySchema());
+    char keyStorage[128];
+    key.moveNoHeader(keyStorage);
+    voltdb::IndexCursor cursor(dataIndex->getTupleSchema());
+    key.setNValue(0, ValueFactory::getTempStringValue("value 3"));
+    ASSERT_TRUE(dataIndex->moveToKey(&key, cursor));
+    int matches = 0;
+    for (TableTuple found = dataIndex->nextValueAtKey(cursor); !found.isNullTuple();
+         found = dataIndex->nextValueAtKey(cursor)) {
+        ASSERT_EQ(3, ValuePeeker::peekInteger(found.getNValue(0)) % 10);
+        matches++;
+    }
+    EXPECT_EQ(rowCount / 10, matches);
+}
+
+TEST_F(PersistentTableTest, FailedLoadIntoEmptyTableIndexesOnlyInsertedRows) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("RESTORED", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, table->schema()));
+    table->addIndex(dataIndex);
+
+    // Rows from a table with a wider column, one of them too wide for this
+    // table, partway through the second batch.
+    TupleSchemaBuilder wideBuilder(2);
+    wideBuilder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    wideBuilder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256);
+    boost::scoped_ptr<PersistentTable> wide(createTable("WIDE", wideBuilder));
+    const int rowCount = 3000;
+    const int wideRow = 1500;
+    boost::scoped_ptr<TempTable> rows(TableFactory::buildCopiedTempTable("ROWS", wide.get(), NULL));
+    TableTuple &row = rows->tempTuple();
+    char data[128];
+    for (int ii = 0; ii < rowCount; ii++) {
+        if (ii == wideRow) {
+            ::memset(data, 'x', 100);
+            data[100] = '\0';
+        }
+        else {
+            snprintf(data, sizeof(data), "value %d", ii % 10);
+        }
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getTempStringValue(data));
+        rows->insertTuple(row);
+    }
+    voltdb::CopySerializeOutput serializedRows;
+    rows->serializeTo(serializedRows);
+
+    beginWork();
+    voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                         serializedRows.size() - sizeof(int32_t));
+    bool failed = false;
+    try {
+        table->loadTuplesFrom(in, NULL, NULL);
+    }
+    catch (const voltdb::SQLException&) {
+        failed = true;
+    }
+    ASSERT_TRUE(failed);
+    // Only the first batch of 1024 went in, and the rebuilt index covers
+    // just it.
+    ASSERT_EQ(2, table->allIndexes().size());
+    ASSERT_EQ(1024, table->activeTupleCount());
+    ASSERT_EQ(1024, pkIndex->getSize());
+    ASSERT_EQ(1024, dataIndex->getSize());
+    rollback();
+    ASSERT_EQ(0, table->activeTupleCount());
+    ASSERT_EQ(0, pkIndex->getSize());
+    ASSERT_EQ(0, dataIndex->getSize());
+}
+
+TEST_F(PersistentTableTest, LoadFreesBatchRejectedByDRStream) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    std::vector<std::string> columnNames;
+    columnNames.push_back("C0");
+    columnNames.push_back("C1");
+    char signature[20];
+    boost::scoped_ptr<PersistentTable> table(dynamic_cast<PersistentTable*>(
+        TableFactory::getPersistentTable(0, "DRED", builder.build(), columnNames, signature,
+                                         false, 0, false, false, 0, INT_MAX, 95, true)));
+    std::vector<int32_t> pkColumns(1, 0);
+    TableIndex* pkIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("PK_IDX", voltdb::BALANCED_TREE_INDEX, pkColumns,
+                         TableIndex::simplyIndexColumns(), true, true, table->schema()));
+    table->addIndex(pkIndex);
+    table->setPrimaryKeyIndex(pkIndex);
+
+    // Fewer rows than the table starts sharing strings at, so each row has
+    // its own copy.
+    const int rowCount = 1000;
+    boost::scoped_ptr<TempTable> rows(TableFactory::buildCopiedTempTable("ROWS", table.get(), NULL));
+    TableTuple &row = rows->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getTempStringValue("a string kept out of line"));
+        rows->insertTuple(row);
+    }
+    voltdb::CopySerializeOutput serializedRows;
+    rows->serializeTo(serializedRows);
+
+    // A transaction may not grow past a few DR buffers, so the load fails
+    // to stream.
+    ExecutorContext::getExecutorContext()->drStream()->setSecondaryCapacity(4096);
+    beginWork();
+    voltdb::ReferenceSerializeInputBE in(serializedRows.data() + sizeof(int32_t),
+                                         serializedRows.size() - sizeof(int32_t));
+    bool failed = false;
+    try {
+        table->loadTuplesFrom(in, NULL, NULL, true);
+    }
+    catch (const voltdb::TupleStreamException&) {
+        failed = true;
+    }
+    ASSERT_TRUE(failed);
+    // The batch is not left in the table with no index entries or undo.
+    ASSERT_EQ(0, table->activeTupleCount());
+    ASSERT_EQ(0, pkIndex->getSize());
+    ASSERT_EQ(0, table->nonInlinedMemorySize());
+    TableIterator iter = table->iterator();
+    TableTuple tuple(table->schema());
+    ASSERT_FALSE(iter.next(tuple));
+    rollback();
+    ASSERT_EQ(0, table->activeTupleCount());
+}
+
+TEST_F(PersistentTableTest, AddIndexToPopulatedTable) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    boost::scoped_ptr<PersistentTable> table(createTable("POPULATED", builder));
+    const voltdb::TupleSchema* schema = table->schema();
+
+    const int rowCount = 2000;
+    char data[32];
+    beginWork();
+    TableTuple &row = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        snprintf(data, sizeof(data), "value %d", ii % 10);
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getTempStringValue(data));
+        table->insertTuple(row);
+    }
+    commit();
+
+    std::vector<int32_t> pkColumns(1, 0);
+    TableIndex* pkIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("PK_IDX", voltdb::BALANCED_TREE_INDEX, pkColumns,
+                         TableIndex::simplyIndexColumns(), true, true, schema));
+    table->addIndex(pkIndex);
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(dataIndex);
+    // Only one of the rows sharing each value gets into a unique index.
+    TableIndex* uniqueDataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("UNIQUE_DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), true, false, schema));
+    table->addIndex(uniqueDataIndex);
+
+    ASSERT_EQ(rowCount, pkIndex->getSize());
+    ASSERT_EQ(rowCount, dataIndex->getSize());
+    ASSERT_EQ(10, uniqueDataIndex->getSize());
+
+    TableTuple key(pkIndex->getKeySchema());
+    char keyStorage[64];
+    key.moveNoHeader(keyStorage);
+    voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+    for (int ii = 0; ii < rowCount; ii++) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+        TableTuple found = pkIndex->nextValueAtKey(cursor);
+        ASSERT_EQ(ii, ValuePeeker::peekInteger(found.getNValue(0)));
+    }
+
+    TableTuple dataKey(dataIndex->getKeySchema());
+    char dataKeyStorage[128];
+    dataKey.moveNoHeader(dataKeyStorage);
+    dataKey.setNValue(0, ValueFactory::getTempStringValue("value 3"));
+    ASSERT_TRUE(dataIndex->moveToKey(&dataKey, cursor));
+    int matches = 0;
+    for (TableTuple found = dataIndex->nextValueAtKey(cursor); !found.isNullTuple();
+         found = dataIndex->nextValueAtKey(cursor)) {
+        ASSERT_EQ(3, ValuePeeker::peekInteger(found.getNValue(0)) % 10);
+        matches++;
+    }
+    ASSERT_EQ(rowCount / 10, matches);
+    ASSERT_TRUE(uniqueDataIndex->moveToKey(&dataKey, cursor));
+    ASSERT_EQ(3, ValuePeeker::peekInteger(uniqueDataIndex->nextValueAtKey(cursor).getNValue(0)) % 10);
+
+    // The indexes keep up with later changes to the table.
+    beginWork();
+    row.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    row.setNValue(1, ValueFactory::getTempStringValue("new value"));
+    table->insertTuple(row);
+    commit();
+    ASSERT_EQ(rowCount + 1, pkIndex->getSize());
+    ASSERT_EQ(rowCount + 1, dataIndex->getSize());
+    ASSERT_EQ(11, uniqueDataIndex->getSize());
+}
+
+TEST_F(PersistentTableTest, ColdStorageKeepsTuplesReachable) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    // Declared first so that it outlives the table's cold blocks.
+    ColdStorage coldStorage(".", 0);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("COLD", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+
+    // Fill three blocks exactly, so that all of them can be evicted.
+    const int blockCount = 3;
+    const int rowCount = blockCount * table->getTuplesPerBlock();
+    beginWork();
+    TableTuple &row = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getBigIntValue(ii * 3));
+        table->insertTuple(row);
+    }
+    commit();
+    ASSERT_EQ(blockCount, table->allocatedBlockCount());
+
+    std::vector<PersistentTable*> tables(1, table.get());
+    int evicted = coldStorage.evictIdleBlocks(tables, ColdStorage::TICK_MAX_EVICTIONS);
+#if defined(LINUX) && !defined(MEMCHECK)
+    ASSERT_EQ(blockCount, evicted);
+    ASSERT_EQ(blockCount * table->getTableAllocationSize(), table->coldTupleMemory());
+    ASSERT_EQ(table->coldTupleMemory(), coldStorage.coldBytes());
+#else
+    // Blocks that are not mappings of their own stay in memory.
+    ASSERT_EQ(0, evicted);
+#endif
+    ASSERT_EQ(evicted, table->blockEvictionCount());
+
+    // Scans and index lookups read cold tuples where they were.
+    int64_t sum = 0;
+    TableTuple tuple(table->schema());
+    TableIterator iter = table->iterator();
+    while (iter.next(tuple)) {
+        sum += ValuePeeker::peekBigInt(tuple.getNValue(1));
+    }
+    ASSERT_EQ(3 * (static_cast<int64_t>(rowCount) * (rowCount - 1) / 2), sum);
+    TableTuple key(pkIndex->getKeySchema());
+    char keyStorage[64];
+    key.moveNoHeader(keyStorage);
+    voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+    key.setNValue(0, ValueFactory::getIntegerValue(rowCount / 2));
+    ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+    TableTuple found = pkIndex->nextValueAtKey(cursor);
+    ASSERT_EQ(rowCount / 2 * 3, ValuePeeker::peekBigInt(found.getNValue(1)));
+
+    // Freeing a tuple of a cold block and inserting into the hole brings
+    // the block back into memory.
+    beginWork();
+    table->deleteTuple(found, true);
+    commit();
+    beginWork();
+    row.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    row.setNValue(1, ValueFactory::getBigIntValue(-1));
+    table->insertTuple(row);
+    commit();
+    ASSERT_EQ(blockCount, table->allocatedBlockCount());
+#if defined(LINUX) && !defined(MEMCHECK)
+    ASSERT_EQ((blockCount - 1) * table->getTableAllocationSize(), table->coldTupleMemory());
+#endif
+    key.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+    ASSERT_EQ(-1, ValuePeeker::peekBigInt(pkIndex->nextValueAtKey(cursor).getNValue(1)));
+    key.setNValue(0, ValueFactory::getIntegerValue(rowCount - 1));
+    ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+    ASSERT_EQ((rowCount - 1) * 3, ValuePeeker::peekBigInt(pkIndex->nextValueAtKey(cursor).getNValue(1)));
+
+    // Once full again, the block can go back out.
+    evicted = coldStorage.evictIdleBlocks(tables, ColdStorage::TICK_MAX_EVICTIONS);
+#if defined(LINUX) && !defined(MEMCHECK)
+    ASSERT_EQ(1, evicted);
+    ASSERT_EQ(blockCount * table->getTableAllocationSize(), coldStorage.coldBytes());
+#endif
+
+    // Cold blocks emptied by deletes are released, and their bytes with
+    // them.
+    std::vector<char*> rows;
+    iter = table->iterator();
+    while (iter.next(found)) {
+        rows.push_back(found.address());
+    }
+    beginWork();
+    for (size_t ii = 0; ii < rows.size(); ii++) {
+        found.move(rows[ii]);
+        table->deleteTuple(found, true);
+    }
+    commit();
+    ASSERT_EQ(1, table->allocatedBlockCount());
+    ASSERT_EQ(coldStorage.coldBytes(), table->coldTupleMemory());
+}
+
+TEST_F(PersistentTableTest, ColdStoragePagesOutWithoutADirectory) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    ColdStorage coldStorage("", 0);
+    boost::scoped_ptr<PersistentTable> table(createTable("PAGED", builder));
+
+    // One full block, which can be paged out, and one taking inserts.
+    const int rowCount = table->getTuplesPerBlock() + 1;
+    beginWork();
+    TableTuple &row = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        // Mostly zeros, as swap compression would like.
+        row.setNValue(1, ValueFactory::getBigIntValue(ii % 2));
+        table->insertTuple(row);
+    }
+    commit();
+
+    std::vector<PersistentTable*> tables(1, table.get());
+    int evicted = coldStorage.evictIdleBlocks(tables, ColdStorage::TICK_MAX_EVICTIONS);
+    ASSERT_EQ(evicted, table->blockEvictionCount());
+#if defined(LINUX) && !defined(MEMCHECK)
+    // Kernels without MADV_PAGEOUT leave the blocks resident.
+    ASSERT_TRUE(evicted <= 1);
+    ASSERT_EQ(evicted * table->getTableAllocationSize(), table->coldTupleMemory());
+#else
+    ASSERT_EQ(0, evicted);
+#endif
+
+    int64_t sum = 0;
+    TableTuple tuple(table->schema());
+    TableIterator iter = table->iterator();
+    while (iter.next(tuple)) {
+        sum += ValuePeeker::peekBigInt(tuple.getNValue(1));
+    }
+    ASSERT_EQ(rowCount / 2, sum);
+}
+
+TEST_F(PersistentTableTest, ChangedBlocksSinceSnapshot) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    boost::scoped_ptr<PersistentTable> table(createTable("CHANGES", builder));
+
+    const int blockCount = 3;
+    const int rowCount = blockCount * table->getTuplesPerBlock();
+    beginWork();
+    TableTuple &row = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getBigIntValue(ii));
+        table->insertTuple(row);
+    }
+    commit();
+
+    // Before the first snapshot every block counts as changed.
+    ASSERT_EQ(0, table->snapshotGeneration());
+    ASSERT_EQ(blockCount, table->changedBlockCount());
+
+    char config[4];
+    ::memset(config, 0, sizeof(config));
+    char serializationBuffer[131072];
+    for (int generation = 1; generation <= 2; generation++) {
+        voltdb::ReferenceSerializeInputBE predicates(config, sizeof(config));
+        ASSERT_TRUE(table->activateStream(voltdb::TABLE_STREAM_SNAPSHOT, 0, 0, predicates));
+        ASSERT_EQ(generation, table->snapshotGeneration());
+        ASSERT_EQ(0, table->changedBlockCount());
+        int64_t remaining;
+        do {
+            voltdb::TupleOutputStreamProcessor outputStreams(serializationBuffer, sizeof(serializationBuffer));
+            std::vector<int> retPositions;
+            remaining = table->streamMore(outputStreams, voltdb::TABLE_STREAM_SNAPSHOT, retPositions);
+        } while (remaining > 0);
+        ASSERT_EQ(0, remaining);
+        ASSERT_EQ(0, table->changedBlockCount());
+
+        // A delete, an insert into the hole it leaves, and an update all
+        // land in the first row's block; another update lands elsewhere.
+        TableTuple tuple(table->schema());
+        TableIterator iter = table->iterator();
+        ASSERT_TRUE(iter.next(tuple));
+        beginWork();
+        table->deleteTuple(tuple, true);
+        commit();
+        ASSERT_EQ(1, table->changedBlockCount());
+        beginWork();
+        row.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+        row.setNValue(1, ValueFactory::getBigIntValue(0));
+        table->insertTuple(row);
+        commit();
+        ASSERT_EQ(blockCount, table->allocatedBlockCount());
+        ASSERT_EQ(1, table->changedBlockCount());
+        char *firstBlockRow = NULL;
+        char *lastBlockRow = NULL;
+        iter = table->iterator();
+        while (iter.next(tuple)) {
+            if (firstBlockRow == NULL) {
+                firstBlockRow = tuple.address();
+            }
+            lastBlockRow = tuple.address();
+        }
+        TableTuple target(firstBlockRow, table->schema());
+        TableTuple &source = table->copyIntoTempTuple(target);
+        source.setNValue(1, ValueFactory::getBigIntValue(-1));
+        beginWork();
+        ASSERT_TRUE(table->updateTuple(target, source));
+        commit();
+        ASSERT_EQ(1, table->changedBlockCount());
+        target.move(lastBlockRow);
+        TableTuple &lastSource = table->copyIntoTempTuple(target);
+        lastSource.setNValue(1, ValueFactory::getBigIntValue(-1));
+        beginWork();
+        ASSERT_TRUE(table->updateTuple(target, lastSource));
+        commit();
+        ASSERT_EQ(2, table->changedBlockCount());
+    }
+}
+
+TEST_F(PersistentTableTest, RecoveryBuildsIndexesAtCompletion) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 64);
+    boost::scoped_ptr<PersistentTable> source(createTable("SOURCE", builder));
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> recovered(createTableWithPk("RECOVERED", builder, pkColumns));
+    TableIndex* pkIndex = recovered->primaryKeyIndex();
+    const voltdb::TupleSchema* recoveredSchema = recovered->schema();
+
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, recoveredSchema));
+    recovered->addIndex(dataIndex);
+
+    const int rowCount = 3000;
+    char data[32];
+    beginWork();
+    TableTuple &row = source->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        snprintf(data, sizeof(data), "value %d", ii % 10);
+        row.setNValue(0, ValueFactory::getIntegerValue(ii));
+        row.setNValue(1, ValueFactory::getTempStringValue(data));
+        source->insertTuple(row);
+    }
+    commit();
+
+    // Small messages, so that the recovery takes several.
+    char config[4];
+    ::memset(config, 0, sizeof(config));
+    voltdb::ReferenceSerializeInputBE predicates(config, sizeof(config));
+    ASSERT_TRUE(source->activateStream(voltdb::TABLE_STREAM_RECOVERY, 0, 0, predicates));
+    char messageBuffer[8192];
+    int messageCount = 0;
+    beginWork();
+    while (true) {
+        voltdb::TupleOutputStreamProcessor outputStreams(messageBuffer, sizeof(messageBuffer));
+        std::vector<int> retPositions;
+        int64_t remaining = source->streamMore(outputStreams, voltdb::TABLE_STREAM_RECOVERY, retPositions);
+        ASSERT_EQ(1, retPositions.size());
+        voltdb::ReferenceSerializeInputBE in(messageBuffer, retPositions[0]);
+        voltdb::RecoveryProtoMsg message(&in);
+        recovered->processRecoveryMessage(&message, NULL);
+        messageCount++;
+        if (remaining == 0) {
+            ASSERT_EQ(voltdb::RECOVERY_MSG_TYPE_COMPLETE, message.msgType());
+            break;
+        }
+        // Nothing is indexed until the last message.
+        ASSERT_EQ(0, pkIndex->getSize());
+        ASSERT_EQ(0, dataIndex->getSize());
+    }
+    commit();
+    ASSERT_LT(2, messageCount);
+
+    ASSERT_EQ(2, recovered->allIndexes().size());
+    ASSERT_EQ(rowCount, recovered->activeTupleCount());
+    ASSERT_EQ(rowCount, pkIndex->getSize());
+    ASSERT_EQ(rowCount, dataIndex->getSize());
+    TableTuple key(pkIndex->getKeySchema());
+    char keyStorage[64];
+    key.moveNoHeader(keyStorage);
+    voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+    for (int ii = 0; ii < rowCount; ii++) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkIndex->moveToKey(&key, cursor));
+        TableTuple found = pkIndex->nextValueAtKey(cursor);
+        ASSERT_EQ(ii, ValuePeeker::peekInteger(found.getNValue(0)));
+    }
+
+    // Later changes are indexed as they happen.
+    beginWork();
+    TableTuple &recoveredRow = recovered->tempTuple();
+    recoveredRow.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    recoveredRow.setNValue(1, ValueFactory::getTempStringValue("new value"));
+    recovered->insertTuple(recoveredRow);
+    commit();
+    ASSERT_EQ(rowCount + 1, pkIndex->getSize());
+    ASSERT_EQ(rowCount + 1, dataIndex->getSize());
+}
+
+TEST_F(PersistentTableTest, ExpireRowsInBatches) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_TIMESTAMP);
+    // Small blocks, so that expiring the oldest rows empties whole blocks
+    boost::scoped_ptr<PersistentTable> table(createTable("EXPIRING", builder, 2048));
+    const voltdb::TupleSchema* schema = table->schema();
+    std::vector<int32_t> tsColumns(1, 1);
+    TableIndex* tsIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("TS_IDX", voltdb::BALANCED_TREE_INDEX, tsColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(tsIndex);
+    table->setTimeToLive(1, 60, 400);
+
+    // Expired rows first, then rows without a time, then current rows
+    const int64_t nowMicros = 1500000000LL * 1000000;
+    const int expiredCount = 1000;
+    const int nullCount = 50;
+    const int currentCount = 50;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < expiredCount + nullCount + currentCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        if (ii < expiredCount) {
+            tuple.setNValue(1, ValueFactory::getTimestampValue(nowMicros - 3600LL * 1000000 + ii));
+        }
+        else if (ii < expiredCount + nullCount) {
+            tuple.setNValue(1, NValue::getNullValue(VALUE_TYPE_TIMESTAMP));
+        }
+        else {
+            tuple.setNValue(1, ValueFactory::getTimestampValue(nowMicros - 1000000));
+        }
+        table->insertTuple(tuple);
+    }
+    endWork();
+    const size_t blocksBefore = table->allocatedBlockCount();
+    ASSERT_TRUE(blocksBefore > 2);
+
+    // A batch at a time, and nothing once only unexpired rows are left
+    ASSERT_EQ(400, table->expireRows(nowMicros));
+    ASSERT_EQ(400, table->expireRows(nowMicros));
+    ASSERT_EQ(200, table->expireRows(nowMicros));
+    ASSERT_EQ(0, table->expireRows(nowMicros));
+    ASSERT_EQ(nullCount + currentCount, table->activeTupleCount());
+    ASSERT_EQ(nullCount + currentCount, tsIndex->getSize());
+    ASSERT_TRUE(table->allocatedBlockCount() < blocksBefore);
+
+    TableIterator iter = table->iterator();
+    TableTuple remaining(table->schema());
+    while (iter.next(remaining)) {
+        ASSERT_TRUE(ValuePeeker::peekInteger(remaining.getNValue(0)) >= expiredCount);
+    }
+
+    // The rest expire once they are old enough, except those without a time
+    ASSERT_EQ(currentCount, table->expireRows(nowMicros + 3600LL * 1000000));
+    ASSERT_EQ(nullCount, table->activeTupleCount());
+}
+
+TEST_F(PersistentTableTest, TickCompactionWaitsForTheUndoLog) {
+    VoltDBEngine* engine = getEngine();
+    engine->loadCatalog(0, catalogPayload());
+    PersistentTable *table = dynamic_cast<PersistentTable*>(engine->getTable("T"));
+    ASSERT_NE(NULL, table);
+
+    // Enough rows for several blocks, then a hole left by every other one,
+    // more than the three blocks' worth compaction waits for
+    const int rowCount = 600000;
+    beginWork();
+    voltdb::StandAloneTupleStorage storage(table->schema());
+    TableTuple &tuple = const_cast<TableTuple&>(storage.tuple());
+    for (int ii = 0; ii < rowCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(ii));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("data"));
+        table->insertTuple(tuple);
+    }
+    endWork();
+    ASSERT_TRUE(table->allocatedBlockCount() > 6);
+    beginWork();
+    std::vector<TableTuple> toDelete;
+    TableIterator iter = table->iterator();
+    TableTuple row(table->schema());
+    for (int ii = 0; iter.next(row); ii++) {
+        if (ii % 2 == 0) {
+            toDelete.push_back(row);
+        }
+    }
+    for (size_t ii = 0; ii < toDelete.size(); ii++) {
+        table->deleteTuple(toDelete[ii], true);
+    }
+
+    // While a transaction could roll back, nothing moves.
+    beginUndo();
+    int64_t compactedBefore = table->compactedTupleCount();
+    engine->tick(0, 0);
+    ASSERT_EQ(compactedBefore, table->compactedTupleCount());
+
+    // Once it is done, the tick compacts.
+    endWork();
+    engine->tick(1000, 0);
+    ASSERT_TRUE(table->compactedTupleCount() > compactedBefore);
+    ASSERT_EQ(rowCount / 2, table->activeTupleCount());
+}
+
+TEST_F(PersistentTableTest, DeleteBatchUndoesAsOne) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT);
+    boost::scoped_ptr<PersistentTable> table(createTable("PURGED", builder, 2048));
+    const voltdb::TupleSchema* schema = table->schema();
+    std::vector<int32_t> valColumns(1, 1);
+    TableIndex* valIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("VAL_IDX", voltdb::BALANCED_TREE_INDEX, valColumns,
+                         TableIndex::simplyIndexColumns(), false, true, schema));
+    table->addIndex(valIndex);
+
+    const int rowCount = 3000;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        tuple.setNValue(1, ValueFactory::getBigIntValue((ii * 7919) % 1000));
+        table->insertTuple(tuple);
+    }
+    commit();
+    const size_t blocksBefore = table->allocatedBlockCount();
+
+    // Rows picked in scan order, as a DELETE's input would list them
+    std::vector<TableTuple> batch;
+    TableIterator iter = table->iterator();
+    TableTuple row(table->schema());
+    while (iter.next(row)) {
+        if (ValuePeeker::peekInteger(row.getNValue(0)) < 2000) {
+            batch.push_back(row);
+        }
+    }
+    ASSERT_EQ(2000, batch.size());
+
+    // Rolled back, every row is back in the table and its index
+    beginWork();
+    table->deleteTupleBatch(batch);
+    ASSERT_EQ(rowCount - 2000, table->visibleTupleCount());
+    ASSERT_EQ(rowCount - 2000, valIndex->getSize());
+    rollback();
+    ASSERT_EQ(rowCount, table->activeTupleCount());
+    ASSERT_EQ(rowCount, valIndex->getSize());
+    ASSERT_EQ(blocksBefore, table->allocatedBlockCount());
+
+    // Committed, they are gone along with the blocks they filled
+    beginWork();
+    table->deleteTupleBatch(batch);
+    commit();
+    ASSERT_EQ(rowCount - 2000, table->activeTupleCount());
+    ASSERT_EQ(rowCount - 2000, valIndex->getSize());
+    ASSERT_TRUE(table->allocatedBlockCount() < blocksBefore);
+    iter = table->iterator();
+    while (iter.next(row)) {
+        ASSERT_TRUE(ValuePeeker::peekInteger(row.getNValue(0)) >= 2000);
+    }
+}
+
+TEST_F(PersistentTableTest, AppendOnlyTableExpiresInInsertionOrder) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_TIMESTAMP);
+    boost::scoped_ptr<PersistentTable> table(createTable("EVENTS", builder, 2048));
+    table->setAppendOnly(true);
+    // No index on TS: an append-only table expires in insertion order.
+    table->setTimeToLive(1, 60, 100000);
+
+    // Fill four blocks exactly, the oldest two and a half expired
+    const int64_t nowMicros = 1500000000LL * 1000000;
+    const int perBlock = static_cast<int>(table->allocatedTupleCount() / table->allocatedBlockCount());
+    const int rowCount = perBlock * 4;
+    const int expiredCount = perBlock * 5 / 2;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        int64_t age = ii < expiredCount ? 3600LL * 1000000 : 1000000;
+        tuple.setNValue(1, ValueFactory::getTimestampValue(nowMicros - age));
+        table->insertTuple(tuple);
+    }
+    endWork();
+    ASSERT_EQ(4, table->allocatedBlockCount());
+
+    // Space freed in an older block is not filled again.
+    const int deletedCount = 50;
+    beginWork();
+    TableIterator iter = table->iterator();
+    TableTuple found(table->schema());
+    std::vector<TableTuple> toDelete;
+    while (iter.next(found)) {
+        if (ValuePeeker::peekInteger(found.getNValue(0)) < deletedCount) {
+            toDelete.push_back(found);
+        }
+    }
+    for (size_t ii = 0; ii < toDelete.size(); ii++) {
+        table->deleteTuple(toDelete[ii], true);
+    }
+    endWork();
+    beginWork();
+    tuple.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    tuple.setNValue(1, ValueFactory::getTimestampValue(nowMicros - 3600LL * 1000000));
+    table->insertTuple(tuple);
+    endWork();
+    ASSERT_EQ(5, table->allocatedBlockCount());
+
+    // Expiry stops at the first row that has not expired, so the late row
+    // with an old time waits for the rows inserted before it.
+    ASSERT_EQ(expiredCount - deletedCount, table->expireRows(nowMicros));
+    ASSERT_EQ(0, table->expireRows(nowMicros));
+    ASSERT_EQ(rowCount - expiredCount + 1, table->activeTupleCount());
+    ASSERT_EQ(3, table->allocatedBlockCount());
+    iter = table->iterator();
+    while (iter.next(found)) {
+        ASSERT_TRUE(ValuePeeker::peekInteger(found.getNValue(0)) >= expiredCount);
+    }
+
+    ASSERT_EQ(rowCount - expiredCount + 1, table->expireRows(nowMicros + 3600LL * 1000000));
+    ASSERT_EQ(0, table->activeTupleCount());
+}
+
+TEST_F(PersistentTableTest, ClusterRowsByPrimaryKey) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_INTEGER);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("CLUSTERED", builder, pkColumns, 2048));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+    const voltdb::TupleSchema* schema = table->schema();
+    std::vector<int32_t> otherColumns(1, 1);
+    TableIndex* otherIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("OTHER_IDX", voltdb::BALANCED_TREE_INDEX, otherColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(otherIndex);
+    table->setClustered(true);
+
+    // Keys inserted out of order, so that key order jumps between blocks
+    const int rowCount = 2000;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        int key = (ii * 7919) % rowCount;
+        tuple.setNValue(0, ValueFactory::getIntegerValue(key));
+        tuple.setNValue(1, ValueFactory::getIntegerValue(-key));
+        table->insertTuple(tuple);
+    }
+    endWork();
+
+    // Count the steps back in memory walking the primary key in order.
+    TableTuple found(table->schema());
+    voltdb::IndexCursor cursor(pkIndex->getTupleSchema());
+    pkIndex->moveToEnd(true, cursor);
+    char *last = NULL;
+    int backwardSteps = 0;
+    while ( ! (found = pkIndex->nextValue(cursor)).isNullTuple()) {
+        if (found.address() < last) {
+            ++backwardSteps;
+        }
+        last = found.address();
+    }
+    ASSERT_TRUE(backwardSteps > rowCount / 4);
+
+    // A pass a batch at a time, then nothing until enough rows come in
+    int64_t moved = 0;
+    int64_t batch;
+    while ((batch = table->clusterIncrementally(300)) > 0) {
+        ASSERT_TRUE(batch <= 300);
+        moved += batch;
+    }
+    ASSERT_EQ(rowCount, moved);
+    ASSERT_EQ(0, table->clusterIncrementally(300));
+    ASSERT_EQ(rowCount, table->activeTupleCount());
+
+    // Now only from one block to the next
+    pkIndex->moveToEnd(true, cursor);
+    last = NULL;
+    backwardSteps = 0;
+    int expected = 0;
+    while ( ! (found = pkIndex->nextValue(cursor)).isNullTuple()) {
+        ASSERT_EQ(expected, ValuePeeker::peekInteger(found.getNValue(0)));
+        ASSERT_EQ(-expected, ValuePeeker::peekInteger(found.getNValue(1)));
+        if (found.address() < last) {
+            ++backwardSteps;
+        }
+        last = found.address();
+        ++expected;
+    }
+    ASSERT_EQ(rowCount, expected);
+    ASSERT_TRUE(backwardSteps < static_cast<int>(table->allocatedBlockCount()));
+
+    // The other index follows the moved rows.
+    tuple.setNValue(0, ValueFactory::getIntegerValue(1234));
+    tuple.setNValue(1, ValueFactory::getIntegerValue(-1234));
+    ASSERT_TRUE(pkIndex->moveToKeyByTuple(&tuple, cursor));
+    found = pkIndex->nextValueAtKey(cursor);
+    voltdb::IndexCursor otherCursor(otherIndex->getTupleSchema());
+    ASSERT_TRUE(otherIndex->moveToKeyByTuple(&found, otherCursor));
+    ASSERT_EQ(found.address(), otherIndex->nextValueAtKey(otherCursor).address());
+}
+
+TEST_F(PersistentTableTest, UpsertInsertsOrUpdatesInOneProbe) {
+    TupleSchemaBuilder builder(3);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256);
+    builder.setColumnAtIndex(2, VALUE_TYPE_INTEGER);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("UPSERTED", builder, pkColumns));
+    TableIndex* pkIndex = table->primaryKeyIndex();
+    const voltdb::TupleSchema* schema = table->schema();
+
+    std::vector<int32_t> dataColumns(1, 1);
+    TableIndex* dataIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("DATA_IDX", voltdb::BALANCED_TREE_INDEX, dataColumns,
+                         TableIndex::simplyIndexColumns(), false, false, schema));
+    table->addIndex(dataIndex);
+    std::vector<int32_t> otherColumns(1, 2);
+    TableIndex* otherIndex = TableIndexFactory::getInstance(
+        TableIndexScheme("OTHER_IDX", voltdb::BALANCED_TREE_INDEX, otherColumns,
+                         TableIndex::simplyIndexColumns(), true, true, schema));
+    table->addIndex(otherIndex);
+
+    // As the insert executor builds its rows, with objects in the temp pool
+    StandAloneTupleStorage storage(schema);
+    TableTuple source = storage.tuple();
+    voltdb::Pool* tempPool = ExecutorContext::getTempStringPool();
+    std::vector<int> allColumns;
+    allColumns.push_back(0);
+    allColumns.push_back(1);
+    allColumns.push_back(2);
+    std::vector<TableIndex*> allSecondaries;
+    allSecondaries.push_back(dataIndex);
+    allSecondaries.push_back(otherIndex);
+
+    beginWork();
+    for (int ii = 0; ii < 10; ii++) {
+        source.setNValue(0, ValueFactory::getIntegerValue(ii));
+        source.setNValueAllocateForObjectCopies(1, ValueFactory::getTempStringValue("inserted"), tempPool);
+        source.setNValue(2, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(table->upsertTuple(source, allColumns, allSecondaries));
+    }
+    commit();
+    ASSERT_EQ(10, table->activeTupleCount());
+
+    // Rows that exist are updated in place without taking a slot.
+    // Only DATA is set, so OTHER_IDX needn't be passed.
+    std::vector<int> pkAndData(allColumns.begin(), allColumns.begin() + 2);
+    std::vector<TableIndex*> dataOnly(1, dataIndex);
+    beginWork();
+    for (int ii = 5; ii < 15; ii++) {
+        source.setNValue(0, ValueFactory::getIntegerValue(ii));
+        source.setNValueAllocateForObjectCopies(1, ValueFactory::getTempStringValue("upserted"), tempPool);
+        source.setNValue(2, ValueFactory::getIntegerValue(100 + ii));
+        ASSERT_EQ(ii >= 10, table->upsertTuple(source, pkAndData, dataOnly));
+    }
+    ASSERT_EQ(15, table->activeTupleCount());
+    ASSERT_EQ(15, pkIndex->getSize());
+    ASSERT_EQ(15, dataIndex->getSize());
+    ASSERT_EQ(15, otherIndex->getSize());
+    TableIterator iter = table->iterator();
+    TableTuple row(table->schema());
+    while (iter.next(row)) {
+        int pk = ValuePeeker::peekInteger(row.getNValue(0));
+        const char* expected = pk < 5 ? "inserted" : "upserted";
+        EXPECT_EQ(0, row.getNValue(1).compare(ValueFactory::getTempStringValue(expected)));
+        // Updated rows keep OTHER, inserted ones take it from the source
+        EXPECT_EQ(pk < 10 ? pk : 100 + pk, ValuePeeker::peekInteger(row.getNValue(2)));
+    }
+
+    // An insert that violates a secondary unique index leaves no trace
+    source.setNValue(0, ValueFactory::getIntegerValue(20));
+    source.setNValue(2, ValueFactory::getIntegerValue(0));
+    bool threw = false;
+    try {
+        table->upsertTuple(source, allColumns, allSecondaries);
+    }
+    catch (voltdb::ConstraintFailureException &e) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(15, table->activeTupleCount());
+    ASSERT_EQ(15, pkIndex->getSize());
+
+    // So does one whose value is too wide to copy into the table
+    TupleSchemaBuilder wideBuilder(3);
+    wideBuilder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    wideBuilder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 1024);
+    wideBuilder.setColumnAtIndex(2, VALUE_TYPE_INTEGER);
+    ScopedTupleSchema wideSchema(wideBuilder.build());
+    StandAloneTupleStorage wideStorage(wideSchema.get());
+    TableTuple wide = wideStorage.tuple();
+    wide.setNValue(0, ValueFactory::getIntegerValue(21));
+    wide.setNValueAllocateForObjectCopies(1, ValueFactory::getTempStringValue(std::string(300, 'x')), tempPool);
+    wide.setNValue(2, ValueFactory::getIntegerValue(21));
+    threw = false;
+    try {
+        table->upsertTuple(wide, allColumns, allSecondaries);
+    }
+    catch (voltdb::SQLException &e) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(15, table->activeTupleCount());
+    ASSERT_EQ(15, pkIndex->getSize());
+    source.setNValue(0, ValueFactory::getIntegerValue(21));
+    source.setNValue(2, ValueFactory::getIntegerValue(21));
+    ASSERT_TRUE(table->upsertTuple(source, allColumns, allSecondaries));
+    ASSERT_EQ(16, table->activeTupleCount());
+
+    // Both the inserts and the updates are undone
+    rollback();
+    ASSERT_EQ(10, table->activeTupleCount());
+    ASSERT_EQ(10, pkIndex->getSize());
+    ASSERT_EQ(10, dataIndex->getSize());
+    iter = table->iterator();
+    while (iter.next(row)) {
+        EXPECT_EQ(0, row.getNValue(1).compare(ValueFactory::getTempStringValue("inserted")));
+    }
+}
+
+TEST_F(PersistentTableTest, UpdateCountersInPlace) {
+    TupleSchemaBuilder builder(3);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER, 4, false, false);
+    builder.setColumnAtIndex(1, VALUE_TYPE_BIGINT, 8, false, false);
+    builder.setColumnAtIndex(2, VALUE_TYPE_VARCHAR, 256);
+    std::vector<int32_t> pkColumns(1, 0);
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("COUNTERS", builder, pkColumns));
+
+    std::vector<int> counter(1, 1);
+    ASSERT_TRUE(table->canUpdateInPlace(counter));
+    ASSERT_FALSE(table->canUpdateInPlace(std::vector<int>(1, 0)));
+    ASSERT_FALSE(table->canUpdateInPlace(std::vector<int>(1, 2)));
+
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < 10; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        tuple.setNValue(1, ValueFactory::getBigIntValue(0));
+        tuple.setNValue(2, ValueFactory::getTempStringValue("data"));
+        table->insertTuple(tuple);
+    }
+    commit();
+
+    // Increment every counter twice, then roll the second round back
+    for (int round = 1; round <= 2; round++) {
+        beginWork();
+        TableIterator iter = table->iterator();
+        TableTuple row(table->schema());
+        while (iter.next(row)) {
+            TableTuple &newValues = table->tempTuple();
+            newValues.setNValue(1, ValueFactory::getBigIntValue(
+                    ValuePeeker::peekBigInt(row.getNValue(1)) + 1));
+            table->updateTupleInPlace(row, newValues, counter);
+        }
+        if (round == 1) {
+            commit();
+        }
+    }
+    TableIterator iter = table->iterator();
+    TableTuple row(table->schema());
+    while (iter.next(row)) {
+        ASSERT_EQ(2, ValuePeeker::peekBigInt(row.getNValue(1)));
+    }
+    rollback();
+    iter = table->iterator();
+    while (iter.next(row)) {
+        ASSERT_EQ(1, ValuePeeker::peekBigInt(row.getNValue(1)));
+        EXPECT_EQ(0, row.getNValue(2).compare(ValueFactory::getTempStringValue("data")));
+    }
+
+    // The NOT NULL constraint still holds
+    beginWork();
+    iter = table->iterator();
+    ASSERT_TRUE(iter.next(row));
+    table->tempTuple().setNValue(1, NValue::getNullValue(VALUE_TYPE_BIGINT));
+    bool threw = false;
+    try {
+        table->updateTupleInPlace(row, table->tempTuple(), counter);
+    }
+    catch (voltdb::ConstraintFailureException &e) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(1, ValuePeeker::peekBigInt(row.getNValue(1)));
+    rollback();
+}
+
+TEST_F(PersistentTableTest, FreeBlocksIncrementally) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256);
+    std::vector<int32_t> pkColumns(1, 0);
+    // Small blocks, so that there are many to free
+    boost::scoped_ptr<PersistentTable> table(createTableWithPk("DROPPED", builder, pkColumns, 2048));
+
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < 3000; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("a string kept out of line"));
+        table->insertTuple(tuple);
+    }
+    endWork();
+    const size_t blocks = table->allocatedBlockCount();
+    ASSERT_TRUE(blocks > 8);
+    const int64_t blockBytes = table->allocatedTupleMemory() / blocks;
+
+    // Four blocks at a time, then the table goes with its index.
+    size_t calls = 0;
+    while (!table->freeBlocksIncrementally(4 * blockBytes)) {
+        ++calls;
+        ASSERT_EQ(blocks - 4 * calls, table->allocatedBlockCount());
+    }
+    ASSERT_EQ((blocks - 1) / 4, calls);
+    ASSERT_EQ(0, table->allocatedBlockCount());
+    ASSERT_EQ(0, table->activeTupleCount());
+    ASSERT_TRUE(table->freeBlocksIncrementally(4 * blockBytes));
+}
+
+TEST_F(PersistentTableTest, PrefetchingScanOverSparseBlocks) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 256);
+    boost::scoped_ptr<PersistentTable> table(createTable("SCANNED", builder, 2048));
+    const voltdb::TupleSchema* schema = table->schema();
+
+    const int rowCount = 2000;
+    char data[32];
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        snprintf(data, sizeof(data), "value %d", ii);
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        tuple.setNValue(1, ValueFactory::getTempStringValue(data));
+        table->insertTuple(tuple);
+    }
+    endWork();
+    ASSERT_TRUE(table->allocatedBlockCount() > 8);
+
+    // Delete seven rows in ten, so most blocks end in freed slots
+    std::vector<char*> doomed;
+    TableTuple found(schema);
+    TableIterator iterator = table->iteratorDeletingAsWeGo();
+    while (iterator.next(found)) {
+        if (ValuePeeker::peekInteger(found.getNValue(0)) % 10 >= 3) {
+            doomed.push_back(found.address());
+        }
+    }
+    beginWork();
+    for (size_t ii = 0; ii < doomed.size(); ii++) {
+        found.move(doomed[ii]);
+        table->deleteTuple(found, true);
+    }
+    endWork();
+
+    // Every remaining row, with its own string, and no other row
+    iterator = table->iteratorDeletingAsWeGo();
+    iterator.setPrefetchDistance(8);
+    int scanned = 0;
+    while (iterator.next(found)) {
+        int key = ValuePeeker::peekInteger(found.getNValue(0));
+        ASSERT_TRUE(key % 10 < 3);
+        snprintf(data, sizeof(data), "value %d", key);
+        ASSERT_EQ(0, found.getNValue(1).compare(ValueFactory::getTempStringValue(data)));
+        ++scanned;
+    }
+    ASSERT_EQ(rowCount * 3 / 10, scanned);
+    ASSERT_EQ(scanned, table->activeTupleCount());
+}
+
+TEST_F(PersistentTableTest, ValidatePartitioningSkipsCheckedBlocks) {
+    TupleSchemaBuilder builder(2);
+    builder.setColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 60);
+    boost::scoped_ptr<PersistentTable> table(createTable("PARTITIONED", builder, 2048, 0));
+    const voltdb::TupleSchema* schema = table->schema();
+
+    // Two legacy partitions: even keys belong to 0, odd keys to 1.
+    char config[4];
+    voltdb::ReferenceSerializeOutput configOut(config, sizeof(config));
+    configOut.writeInt(2);
+    boost::scoped_ptr<voltdb::TheHashinator> hashinator(voltdb::LegacyHashinator::newInstance(config));
+    getEngine()->updateHashinator(voltdb::HASHINATOR_LEGACY, config, NULL, 0);
+
+    const int rowCount = 1000;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getBigIntValue(ii * 2));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("row"));
+        table->insertTuple(tuple);
+    }
+    commit();
+    ASSERT_TRUE(table->allocatedBlockCount() > 4);
+    EXPECT_EQ(0, table->validatePartitioning(hashinator.get(), 0, 1));
+
+    // Checked as partition 1 under the same epoch, every block but the one
+    // taking a new row is passed over, though all but one of its rows
+    // belong to partition 0.
+    beginWork();
+    tuple.setNValue(0, ValueFactory::getBigIntValue(7));
+    table->insertTuple(tuple);
+    commit();
+    EXPECT_EQ(1, table->validatePartitioning(hashinator.get(), 0, 1));
+    EXPECT_EQ(1, table->validatePartitioning(hashinator.get(), 0, 1));
+    EXPECT_TRUE(table->validatePartitioning(hashinator.get(), 1, 1) < rowCount / 2);
+
+    // A changed partitioning value sends its block back for checking.
+    TableTuple first(schema);
+    TableIterator iter = table->iterator();
+    ASSERT_TRUE(iter.next(first));
+    TableTuple &source = table->copyIntoTempTuple(first);
+    source.setNValue(0, ValueFactory::getBigIntValue(9));
+    beginWork();
+    ASSERT_TRUE(table->updateTuple(first, source));
+    commit();
+    EXPECT_EQ(2, table->validatePartitioning(hashinator.get(), 0, 1));
+
+    // A new epoch checks every block.
+    EXPECT_EQ(2, table->validatePartitioning(hashinator.get(), 0, 2));
+}
+
+TEST_F(PersistentTableTest, ZoneMapsPassOverBlocksOutOfRange) {
+    TupleSchemaBuilder builder(3);
+    builder.setColumnAtIndex(0, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(1, VALUE_TYPE_VARCHAR, 16);
+    builder.setColumnAtIndex(2, VALUE_TYPE_TIMESTAMP);
+    boost::scoped_ptr<PersistentTable> table(createTable("ZONED", builder, 2048));
+    const voltdb::TupleSchema* schema = table->schema();
+    ASSERT_EQ(1, table->zoneOfColumn(0));
+    ASSERT_EQ(-1, table->zoneOfColumn(1));
+    ASSERT_EQ(0, table->zoneOfColumn(2));
+
+    // Rows arrive in time order, so each block holds a short span of it
+    const int rowCount = 2000;
+    beginWork();
+    TableTuple &tuple = table->tempTuple();
+    for (int ii = 0; ii < rowCount; ii++) {
+        tuple.setNValue(0, ValueFactory::getIntegerValue(ii));
+        tuple.setNValue(1, ValueFactory::getTempStringValue("row"));
+        tuple.setNValue(2, ValueFactory::getTimestampValue(ii * 1000));
+        table->insertTuple(tuple);
+    }
+    endWork();
+    ASSERT_TRUE(table->allocatedBlockCount() > 8);
+
+    std::vector<ZoneBound> bounds;
+    ZoneBound range = { 0, 500 * 1000, 599 * 1000 };
+    bounds.push_back(range);
+    TableTuple found(schema);
+    int scanned = 0;
+    int matched = 0;
+    TableIterator iterator = table->iteratorDeletingAsWeGo();
+    iterator.setZoneBounds(&bounds);
+    while (iterator.next(found)) {
+        ++scanned;
+        int id = ValuePeeker::peekInteger(found.getNValue(0));
+        matched += id >= 500 && id < 600;
+    }
+    // Stale zone maps rule nothing out.
+    ASSERT_EQ(rowCount, scanned);
+
+    ASSERT_TRUE(table->summarizeZonesIncrementally(INT64_MAX) >= rowCount);
+    ASSERT_EQ(0, table->summarizeZonesIncrementally(INT64_MAX));
+    scanned = 0;
+    matched = 0;
+    iterator = table->iteratorDeletingAsWeGo();
+    iterator.setZoneBounds(&bounds);
+    while (iterator.next(found)) {
+        ++scanned;
+        int id = ValuePeeker::peekInteger(found.getNValue(0));
+        matched += id >= 500 && id < 600;
+    }
+    ASSERT_EQ(100, matched);
+    ASSERT_TRUE(scanned < rowCount / 4);
+
+    // An update into the range widens its block's zone map.
+    iterator = table->iteratorDeletingAsWeGo();
+    iterator.next(found);
+    TableTuple &source = table->copyIntoTempTuple(found);
+    source.setNValue(2, ValueFactory::getTimestampValue(550 * 1000));
+    beginWork();
+    ASSERT_TRUE(table->updateTuple(found, source));
+    endWork();
+    // A new row leaves its block stale until it is summarized again.
+    beginWork();
+    tuple.setNValue(0, ValueFactory::getIntegerValue(rowCount));
+    tuple.setNValue(1, ValueFactory::getTempStringValue("row"));
+    tuple.setNValue(2, ValueFactory::getTimestampValue(550 * 1000));
+    table->insertTuple(tuple);
+    endWork();
+    for (int pass = 0; pass < 2; pass++) {
+        matched = 0;
+        iterator = table->iteratorDeletingAsWeGo();
+        iterator.setZoneBounds(&bounds);
+        while (iterator.next(found)) {
+            matched += ValuePeeker::peekTimestamp(found.getNValue(2)) == 550 * 1000;
+        }
+        ASSERT_EQ(3, matched);
+        table->summarizeZonesIncrementally(INT64_MAX);
+    }
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
@@ -144,6 +144,43 @@ TEST_F(TableTupleFilterTest, tableTupleFilterTest)
 }
 
 
+TEST_F(TableTupleFilterTest, sparseMarkersTest)
+{
+    static const int MARKER = 7;
+
+    TempTable* table = getTempTable();
+    TableTupleFilter tableFilter;
+    tableFilter.init(table);
+
+    TableTuple tuple = table->tempTuple();
+    TableIterator iterator = table->iterator();
+
+    // Mark the first and last tuples and a few between, at and around
+    // word boundaries, leaving long unmarked runs.
+    std::set<uint64_t> marked;
+    int counter = 0;
+    while (iterator.next(tuple)) {
+        if (counter == 0 || counter == 7 || counter == 8 || counter == 9 ||
+                counter == 1000 || counter == NUM_OF_TUPLES - 1) {
+            marked.insert(tableFilter.updateTuple(tuple, MARKER));
+        }
+        ++counter;
+    }
+    ASSERT_EQ(6, marked.size());
+
+    std::set<uint64_t>::const_iterator expected = marked.begin();
+    TableTupleFilter_iter<MARKER> endItr = tableFilter.end<MARKER>();
+    for (TableTupleFilter_iter<MARKER> itr = tableFilter.begin<MARKER>(); itr != endItr; ++itr) {
+        ASSERT_TRUE(expected != marked.end());
+        ASSERT_EQ(*expected, *itr);
+        ++expected;
+    }
+    ASSERT_TRUE(expected == marked.end());
+
+    // Nothing carries an unused marker.
+    ASSERT_TRUE(tableFilter.begin<MARKER + 1>() == tableFilter.end<MARKER + 1>());
+}
+
 } // end namespace
 
 int main()
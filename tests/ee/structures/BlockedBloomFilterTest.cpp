@@ -0,0 +1,75 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include "harness.h"
+#include "structures/BlockedBloomFilter.h"
+
+using namespace voltdb;
+
+class BlockedBloomFilterTest : public Test {
+};
+
+TEST_F(BlockedBloomFilterTest, OffFilterMayContainAnything) {
+    BlockedBloomFilter filter;
+    EXPECT_EQ(0, filter.capacity());
+    EXPECT_EQ(0, filter.bytesAllocated());
+    EXPECT_TRUE(filter.mayContain(0));
+    EXPECT_TRUE(filter.mayContain(12345));
+
+    filter.reset(100);
+    EXPECT_TRUE(filter.capacity() >= 100);
+    EXPECT_FALSE(filter.mayContain(12345));
+    filter.reset(0);
+    EXPECT_EQ(0, filter.capacity());
+    EXPECT_TRUE(filter.mayContain(12345));
+}
+
+TEST_F(BlockedBloomFilterTest, NoFalseNegatives) {
+    // Sequential hashes, as identity-like key hashers produce.
+    const uint64_t entryCount = 100000;
+    BlockedBloomFilter filter;
+    filter.reset(entryCount);
+    for (uint64_t ii = 0; ii < entryCount; ii++) {
+        filter.add(ii);
+    }
+    for (uint64_t ii = 0; ii < entryCount; ii++) {
+        ASSERT_TRUE(filter.mayContain(ii));
+    }
+
+    // Filled to capacity, about 1% of absent hashes get through.
+    int falsePositives = 0;
+    for (uint64_t ii = entryCount; ii < 2 * entryCount; ii++) {
+        falsePositives += filter.mayContain(ii);
+    }
+    EXPECT_TRUE(falsePositives < static_cast<int>(entryCount / 40));
+
+    filter.reset(entryCount);
+    for (uint64_t ii = 0; ii < entryCount; ii++) {
+        ASSERT_FALSE(filter.mayContain(ii));
+    }
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,263 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <map>
+#include <vector>
+#include <cstdlib>
+#include "harness.h"
+#include "structures/CompactingBTree.h"
+
+using namespace voltdb;
+using namespace std;
+
+class IntComparator {
+public:
+    inline int operator()(const int &lhs, const int &rhs) const {
+        if (lhs > rhs) return 1;
+        else if (lhs < rhs) return -1;
+        else return 0;
+    }
+};
+
+typedef CompactingBTree<NormalKeyValuePair<int, int>, IntComparator, true> RankedTree;
+
+class CompactingBTreeTest : public Test {
+public:
+    CompactingBTreeTest() {
+        srand(0);
+    }
+
+    // Check every entry, bound and rank of the tree against the std::multimap.
+    void verifyAgainst(const RankedTree &volt, const multimap<int, int> &stl, int maxKey) {
+        ASSERT_TRUE(volt.verify());
+        ASSERT_EQ(static_cast<int64_t>(stl.size()), volt.size());
+
+        RankedTree::iterator volti = volt.begin();
+        int64_t rank = 1;
+        for (multimap<int, int>::const_iterator stli = stl.begin(); stli != stl.end(); ++stli, ++rank) {
+            ASSERT_FALSE(volti.isEnd());
+            ASSERT_EQ(stli->first, volti.key());
+            ASSERT_EQ(stli->second, volti.value());
+            ASSERT_EQ(stli->first, volt.findRank(rank).key());
+            ASSERT_EQ(rank, volt.rankOf(volti));
+            volti.moveNext();
+        }
+        ASSERT_TRUE(volti.isEnd());
+        ASSERT_TRUE(volt.findRank(rank).isEnd());
+
+        volti = volt.rbegin();
+        for (multimap<int, int>::const_reverse_iterator stli = stl.rbegin(); stli != stl.rend(); ++stli) {
+            ASSERT_FALSE(volti.isEnd());
+            ASSERT_EQ(stli->first, volti.key());
+            volti.movePrev();
+        }
+        ASSERT_TRUE(volti.isEnd());
+
+        multimap<int, int>::const_iterator lower = stl.begin();
+        int64_t before = 0;
+        for (int key = -1; key <= maxKey + 1; key++) {
+            for (; lower != stl.end() && lower->first < key; ++lower) {
+                before++;
+            }
+            multimap<int, int>::const_iterator upper = stl.upper_bound(key);
+            RankedTree::iterator voltLower = volt.lowerBound(key);
+            RankedTree::iterator voltUpper = volt.upperBound(key);
+            ASSERT_EQ(lower == stl.end(), voltLower.isEnd());
+            ASSERT_EQ(upper == stl.end(), voltUpper.isEnd());
+            if (lower != stl.end()) {
+                ASSERT_EQ(lower->first, voltLower.key());
+            }
+            if (upper != stl.end()) {
+                ASSERT_EQ(upper->first, voltUpper.key());
+            }
+            if (lower == upper) {
+                ASSERT_TRUE(volt.find(key).isEnd());
+                ASSERT_EQ(-1, volt.rankAsc(key));
+                continue;
+            }
+            ASSERT_EQ(key, volt.find(key).key());
+            ASSERT_EQ(before + 1, volt.rankAsc(key));
+            ASSERT_EQ(before + static_cast<int64_t>(distance(lower, upper)), volt.rankUpper(key));
+        }
+
+        // The batched descent agrees with one lowerBound per key.
+        vector<int> keys;
+        for (int key = maxKey + 1; key >= -1; key -= 3) {
+            keys.push_back(key);
+        }
+        vector<RankedTree::iterator> bounds(keys.size());
+        volt.lowerBounds(&keys[0], static_cast<int>(keys.size()), &bounds[0]);
+        for (size_t ii = 0; ii < keys.size(); ii++) {
+            RankedTree::iterator single = volt.lowerBound(keys[ii]);
+            ASSERT_EQ(single.isEnd(), bounds[ii].isEnd());
+            if (!single.isEnd()) {
+                ASSERT_TRUE(single.equals(bounds[ii]));
+            }
+        }
+
+        // So does the forward walk over ascending keys, near and far apart.
+        keys.clear();
+        for (int key = -1; key <= maxKey + 1; key += 1 + rand() % 200) {
+            keys.push_back(key);
+            if (rand() % 4 == 0) {
+                keys.push_back(key);
+            }
+        }
+        bounds.resize(keys.size());
+        volt.lowerBounds(&keys[0], static_cast<int>(keys.size()), &bounds[0]);
+        for (size_t ii = 0; ii < keys.size(); ii++) {
+            RankedTree::iterator single = volt.lowerBound(keys[ii]);
+            ASSERT_EQ(single.isEnd(), bounds[ii].isEnd());
+            if (!single.isEnd()) {
+                ASSERT_TRUE(single.equals(bounds[ii]));
+            }
+        }
+    }
+};
+
+TEST_F(CompactingBTreeTest, RandomUnique) {
+    const int maxKey = 20000;
+    RankedTree volt(true, IntComparator());
+    multimap<int, int> stl;
+    for (int ii = 0; ii < 60000; ii++) {
+        int key = rand() % maxKey;
+        bool present = stl.find(key) != stl.end();
+        if (rand() % 3 != 0) {
+            const int *collision = volt.insert(key, ii);
+            ASSERT_EQ(present, collision != NULL);
+            if (!present) {
+                stl.insert(make_pair(key, ii));
+            }
+        }
+        else {
+            ASSERT_EQ(present, volt.erase(key));
+            stl.erase(key);
+        }
+        if (ii % 15000 == 0) {
+            verifyAgainst(volt, stl, maxKey);
+        }
+    }
+    verifyAgainst(volt, stl, maxKey);
+
+    // Emptying the tree hands back every node.
+    while (!stl.empty()) {
+        ASSERT_TRUE(volt.erase(stl.begin()->first));
+        stl.erase(stl.begin());
+    }
+    verifyAgainst(volt, stl, maxKey);
+    ASSERT_EQ(0, volt.bytesAllocated());
+}
+
+TEST_F(CompactingBTreeTest, RandomMulti) {
+    const int maxKey = 500;
+    RankedTree volt(false, IntComparator());
+    multimap<int, int> stl;
+    for (int ii = 0; ii < 40000; ii++) {
+        int key = rand() % maxKey;
+        if (rand() % 4 != 0) {
+            ASSERT_TRUE(volt.insert(key, ii) == NULL);
+            // Duplicates go after the existing ones, in both.
+            stl.insert(make_pair(key, ii));
+        }
+        else {
+            multimap<int, int>::iterator stli = stl.find(key);
+            ASSERT_EQ(stli != stl.end(), volt.erase(key));
+            if (stli != stl.end()) {
+                stl.erase(stli);
+            }
+        }
+        if (ii % 10000 == 0) {
+            verifyAgainst(volt, stl, maxKey);
+        }
+    }
+    verifyAgainst(volt, stl, maxKey);
+
+    // Erase through iterators, walking every other run of duplicates.
+    for (int key = 0; key < maxKey; key += 2) {
+        RankedTree::iterator volti = volt.find(key);
+        while (!volti.isEnd() && volti.key() == key) {
+            volt.erase(volti);
+            volti = volt.find(key);
+        }
+        stl.erase(key);
+    }
+    verifyAgainst(volt, stl, maxKey);
+}
+
+class SortedEvens {
+public:
+    int key(int64_t ii) const { return static_cast<int>(ii * 2); }
+    int value(int64_t ii) const { return static_cast<int>(ii); }
+};
+
+TEST_F(CompactingBTreeTest, BuildFromSorted) {
+    const int64_t sizes[] = { 0, 1, 2, 59, 60, 61, 121, 1000, 4097, 100000 };
+    for (int ss = 0; ss < sizeof(sizes) / sizeof(sizes[0]); ss++) {
+        int64_t size = sizes[ss];
+        RankedTree volt(true, IntComparator());
+        volt.buildFromSorted(SortedEvens(), size);
+        multimap<int, int> stl;
+        for (int64_t ii = 0; ii < size; ii++) {
+            stl.insert(make_pair(static_cast<int>(ii * 2), static_cast<int>(ii)));
+        }
+        verifyAgainst(volt, stl, static_cast<int>(size * 2));
+
+        // The built tree is an ordinary one to later inserts and deletes.
+        for (int64_t ii = 0; ii < size; ii++) {
+            ASSERT_TRUE(volt.insert(static_cast<int>(ii * 2 + 1), 0) == NULL);
+            stl.insert(make_pair(static_cast<int>(ii * 2 + 1), 0));
+            if (ii % 3 == 0) {
+                ASSERT_TRUE(volt.erase(static_cast<int>(ii * 2)));
+                stl.erase(static_cast<int>(ii * 2));
+            }
+        }
+        verifyAgainst(volt, stl, static_cast<int>(size * 2));
+    }
+}
+
+TEST_F(CompactingBTreeTest, PeekValue) {
+    RankedTree volt(true, IntComparator());
+    const int64_t size = 1000;
+    volt.buildFromSorted(SortedEvens(), size);
+
+    // A peek either finds the value that many steps away or nothing.
+    int found = 0;
+    int64_t ii = 0;
+    for (RankedTree::iterator volti = volt.begin(); !volti.isEnd(); volti.moveNext(), ii++) {
+        for (int distance = -3; distance <= 3; distance++) {
+            const int *peeked = volti.peekValue(distance);
+            if (peeked == NULL) {
+                continue;
+            }
+            ASSERT_EQ(ii + distance, *peeked);
+            found++;
+        }
+    }
+    ASSERT_EQ(size, ii);
+    ASSERT_TRUE(found > size * 5);
+    ASSERT_TRUE(RankedTree::iterator().peekValue(1) == NULL);
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -301,6 +301,60 @@ TEST_F(CompactingHashTest, ShrinkAndGrowMulti) {
     volt.verify();
 }
 
+TEST_F(CompactingHashTest, ResizeIncrementally) {
+    const uint64_t ITERATIONS = 200000;
+
+    voltdb::CompactingHashTable<uint64_t,uint64_t> volt(false);
+
+    // Check every key while buckets are split across the old and new tables.
+    for (uint64_t i = 0; i < ITERATIONS; i++) {
+        ASSERT_TRUE(volt.insert(i / 2, i) == NULL);
+        if (i % 7919 == 0) {
+            ASSERT_TRUE(volt.verify());
+            for (uint64_t j = 0; j <= i; j++) {
+                ASSERT_FALSE(volt.find(j / 2, j).isEnd());
+            }
+        }
+    }
+    ASSERT_TRUE(volt.verify());
+
+    for (uint64_t i = 0; i < ITERATIONS; i++) {
+        ASSERT_TRUE(volt.erase(i / 2, i));
+        if (i % 7919 == 0) {
+            ASSERT_TRUE(volt.verify());
+            ASSERT_TRUE(volt.find(i / 2, i).isEnd());
+            ASSERT_FALSE(volt.find((ITERATIONS - 1) / 2, ITERATIONS - 1).isEnd());
+        }
+    }
+    ASSERT_TRUE(volt.verify());
+    ASSERT_EQ(0U, volt.size());
+}
+
+TEST_F(CompactingHashTest, Reserve) {
+    voltdb::CompactingHashTable<uint64_t,uint64_t> volt(true);
+    size_t initialBytes = volt.bytesAllocated();
+
+    volt.reserve(1000000);
+    ASSERT_TRUE(volt.bytesAllocated() > initialBytes);
+
+    // A nearly empty table does not shrink back below the reservation,
+    // and by now the old buckets have all been moved and released.
+    for (uint64_t i = 0; i < 2500; i++) {
+        ASSERT_TRUE(volt.insert(i, i) == NULL);
+    }
+    for (uint64_t i = 0; i < 2500; i++) {
+        ASSERT_TRUE(volt.erase(i));
+    }
+    ASSERT_TRUE(volt.verify());
+    size_t reservedBytes = volt.bytesAllocated();
+    ASSERT_TRUE(reservedBytes > initialBytes);
+    for (uint64_t i = 0; i < 2500; i++) {
+        ASSERT_TRUE(volt.insert(i, i) == NULL);
+        ASSERT_TRUE(volt.erase(i));
+    }
+    ASSERT_EQ(reservedBytes, volt.bytesAllocated());
+}
+
 TEST_F(CompactingHashTest, Benchmark) {
     const int ITERATIONS = 10000;
 
@@ -304,6 +304,14 @@ TEST_F(CompactingMapTest, SimpleMultiRank) {
     rankupper = volt.rankUpper(0); ASSERT_TRUE(rankupper == -1);
     rankupper = volt.rankUpper(7); ASSERT_TRUE(rankupper == -1);
     rankupper = volt.rankUpper(12); ASSERT_TRUE(rankupper == -1);
+
+    // Entries with equal keys each have their own rank.
+    int64_t rank = 0;
+    for (volti = volt.begin(); !volti.isEnd(); volti.moveNext()) {
+        ASSERT_EQ(++rank, volt.rankOf(volti));
+        ASSERT_TRUE(volt.findRank(rank).equals(volti));
+    }
+    ASSERT_EQ(-1, volt.rankOf(volti));
 }
 
 TEST_F(CompactingMapTest, RandomMultiRank) {
@@ -770,6 +770,47 @@ TEST_F(CompactingMapTest, RandomMulti) {
     // std::cout << "UpperBounds: " << upperBounds << " ub greatest chain: " << ub_greatestChain << std::endl;
 }
 
+// Presents the first count even numbers, doubled, as sorted entries.
+class SortedEvens {
+public:
+    int key(int64_t ii) const { return static_cast<int>(ii * 2); }
+    int value(int64_t ii) const { return static_cast<int>(ii); }
+};
+
+TEST_F(CompactingMapTest, BuildFromSorted) {
+    const int64_t sizes[] = { 0, 1, 2, 3, 4, 7, 8, 15, 100, 1000, 1023, 1024, 4097 };
+    for (int ss = 0; ss < sizeof(sizes) / sizeof(sizes[0]); ss++) {
+        int64_t size = sizes[ss];
+        voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator, true> volt(true, IntComparator());
+        volt.buildFromSorted(SortedEvens(), size);
+        ASSERT_EQ(size, volt.size());
+        ASSERT_TRUE(volt.verify());
+        ASSERT_TRUE(volt.verifyRank());
+
+        int64_t ii = 0;
+        voltdb::CompactingMap<NormalKeyValuePair<int, int>, IntComparator, true>::iterator volti;
+        for (volti = volt.begin(); !volti.isEnd(); volti.moveNext(), ii++) {
+            ASSERT_EQ(ii * 2, volti.key());
+            ASSERT_EQ(ii, volti.value());
+        }
+        ASSERT_EQ(size, ii);
+        for (ii = 0; ii < size; ii++) {
+            ASSERT_FALSE(volt.find(static_cast<int>(ii * 2)).isEnd());
+            ASSERT_TRUE(volt.find(static_cast<int>(ii * 2 + 1)).isEnd());
+        }
+
+        // The built tree is an ordinary one to later inserts and deletes.
+        for (ii = 0; ii < size; ii++) {
+            ASSERT_TRUE(volt.insert(std::pair<int,int>(static_cast<int>(ii * 2 + 1), 0)));
+            if (ii % 3 == 0) {
+                ASSERT_TRUE(volt.erase(static_cast<int>(ii * 2)));
+            }
+        }
+        ASSERT_TRUE(volt.verify());
+        ASSERT_TRUE(volt.verifyRank());
+    }
+}
+
 // ENG-1057
 //
 // I have commented this out intentionally.  It demonstrates that the
@@ -82,6 +82,34 @@ TEST_F(CompactingPoolTest, basic_ops)
             dut.getBytesAllocated());
 }
 
+TEST_F(CompactingPoolTest, growing_buffers)
+{
+    int32_t size = 17;
+    int32_t entry = size + CompactingPool::FIXED_OVERHEAD_PER_ENTRY();
+    // Buffers of 2, 4 and then 5 elements.
+    CompactingPool dut(size, 5, 2);
+
+    char* elems[12];
+    int64_t expected[12] = { 2, 2, 6, 6, 6, 6, 11, 11, 11, 11, 11, 16 };
+    for (int i = 0; i < 12; i++) {
+        elems[i] = reinterpret_cast<char*>(dut.malloc(&(elems[i])));
+        memset(elems[i], i, size);
+        EXPECT_EQ(entry * expected[i], dut.getBytesAllocated());
+        EXPECT_EQ(i + 1, dut.getCount());
+    }
+
+    // Freeing from the middle moves the last element in, and each emptied
+    // buffer is given back.
+    for (int i = 11; i > 0; i--) {
+        dut.free(elems[0]);
+        EXPECT_EQ(i, *reinterpret_cast<int8_t*>(elems[0]));
+        EXPECT_EQ(entry * expected[i - 1], dut.getBytesAllocated());
+    }
+    dut.free(elems[0]);
+    EXPECT_EQ(0, dut.getBytesAllocated());
+    EXPECT_EQ(0, dut.getCount());
+}
+
 TEST_F(CompactingPoolTest, bytes_allocated_test)
 {
     int32_t size = 1024 * 512; // half a meg object
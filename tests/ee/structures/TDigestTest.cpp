@@ -0,0 +1,105 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <stdint.h>
+#include "harness.h"
+#include "common/serializeio.h"
+#include "structures/TDigest.h"
+
+using namespace voltdb;
+
+class TDigestTest : public Test {
+protected:
+    // Adds 0 .. count - 1 in a scrambled but repeatable order.
+    static void addScrambled(TDigest &digest, int count, int start = 0, int step = 1) {
+        const int64_t prime = 7919;
+        for (int64_t ii = 0; ii < count; ii++) {
+            digest.add(static_cast<double>(start + step * ((ii * prime) % count)));
+        }
+    }
+};
+
+TEST_F(TDigestTest, SmallInputsAreExact) {
+    TDigest digest;
+    EXPECT_TRUE(digest.empty());
+    digest.add(42);
+    EXPECT_FALSE(digest.empty());
+    EXPECT_EQ(42.0, digest.quantile(0.5));
+    EXPECT_EQ(42.0, digest.quantile(0.99));
+
+    digest.add(10);
+    digest.add(20);
+    EXPECT_EQ(10.0, digest.quantile(0));
+    EXPECT_EQ(20.0, digest.quantile(0.5));
+    EXPECT_EQ(42.0, digest.quantile(1));
+
+    digest.clear();
+    EXPECT_TRUE(digest.empty());
+}
+
+TEST_F(TDigestTest, QuantilesOfManyValues) {
+    const int count = 100000;
+    TDigest digest;
+    addScrambled(digest, count);
+    EXPECT_EQ(static_cast<double>(count), digest.totalWeight());
+    EXPECT_TRUE(digest.centroidCount() <= 2 * TDigest::DEFAULT_COMPRESSION);
+
+    double fractions[] = { 0.01, 0.25, 0.5, 0.75, 0.99, 0.999 };
+    for (int ii = 0; ii < sizeof(fractions) / sizeof(fractions[0]); ii++) {
+        double expected = fractions[ii] * count;
+        double estimate = digest.quantile(fractions[ii]);
+        // Within a tenth of a percent of the rank.
+        EXPECT_TRUE(std::fabs(estimate - expected) <= count * 0.001);
+    }
+    EXPECT_EQ(0.0, digest.quantile(0));
+    EXPECT_EQ(count - 1.0, digest.quantile(1));
+}
+
+TEST_F(TDigestTest, MergedDigestsMatchOne) {
+    // Even values in one digest and odd ones in another.
+    const int count = 50000;
+    TDigest evens;
+    TDigest odds;
+    addScrambled(evens, count, 0, 2);
+    addScrambled(odds, count, 1, 2);
+
+    CopySerializeOutput out;
+    odds.serializeTo(out);
+    ReferenceSerializeInputBE in(out.data(), out.size());
+    evens.mergeFrom(in);
+
+    EXPECT_EQ(2.0 * count, evens.totalWeight());
+    EXPECT_TRUE(std::fabs(evens.quantile(0.5) - count) <= 2 * count * 0.001);
+    EXPECT_TRUE(std::fabs(evens.quantile(0.99) - 0.99 * 2 * count) <= 2 * count * 0.0005);
+    EXPECT_EQ(0.0, evens.quantile(0));
+    EXPECT_EQ(2.0 * count - 1, evens.quantile(1));
+
+    TDigest copy;
+    copy.merge(evens);
+    EXPECT_EQ(evens.quantile(0.9), copy.quantile(0.9));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
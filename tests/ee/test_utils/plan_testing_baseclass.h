@@ -112,7 +112,8 @@ public:
     void initialize(const char         *catalogString,
                     int                 numTables,
                     const TableConfig **tables,
-                    uint32_t            randomSeed) {
+                    uint32_t            randomSeed,
+                    int64_t             tempTableMemory = voltdb::DEFAULT_TEMP_TABLE_MEMORY) {
         srand(randomSeed);
         m_catalog_string = catalogString;
         /*
@@ -134,7 +135,7 @@ public:
                              m_exception_buffer.get(), 4096);
         m_engine->resetReusedResultOutputBuffer();
         int partitionCount = 3;
-        ASSERT_TRUE(m_engine->initialize(this->m_cluster_id, this->m_site_id, 0, 0, "", 0, 1024, voltdb::DEFAULT_TEMP_TABLE_MEMORY, false));
+        ASSERT_TRUE(m_engine->initialize(this->m_cluster_id, this->m_site_id, 0, 0, "", 0, 1024, tempTableMemory, false));
         m_engine->updateHashinator(voltdb::HASHINATOR_LEGACY, (char*)&partitionCount, NULL, 0);
         ASSERT_TRUE(m_engine->loadCatalog( -2, m_catalog_string));
 
@@ -221,9 +222,9 @@ public:
     }
     /**
      * Given a PlanFragmentInfo data object, make the m_engine execute it,
-     * and validate the results.
+     * and validate the results.  Returns the engine's error code.
      */
-    void executeFragment(fragmentId_t fragmentId, const char *plan) {
+    int executeFragment(fragmentId_t fragmentId, const char *plan) {
         m_topend->addPlan(fragmentId, plan);
 
             // Make sure the parameter buffer is filled
@@ -231,12 +232,15 @@ public:
             // deserializer.
             memset(m_parameter_buffer.get(), 0, 4 * 1024);
             voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+            // Results go at the start of the buffer, where validateResult
+            // reads them, even when a test runs several fragments.
+            m_engine->resetReusedResultOutputBuffer();
 
             //
             // Execute the plan.  You'd think this would be more
             // impressive.
             //
-            m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1);
+            return m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1);
     }
 
     /**
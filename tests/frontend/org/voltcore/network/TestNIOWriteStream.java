@@ -120,6 +120,7 @@ public class TestNIOWriteStream extends TestCase {
         private final int closeAfter;
         private boolean didOversizeWrite = false;
         private boolean wrotePartial = false;
+        private int gatheringWrites = 0;
         public boolean m_open = true;
 
         public int m_behavior;
@@ -203,8 +204,36 @@ public class TestNIOWriteStream extends TestCase {
         @Override
         public long write(ByteBuffer[] srcs, int offset, int length)
                 throws IOException {
-            // TODO Auto-generated method stub
-            return 0;
+            if (!m_open) throw new IOException();
+            if (closeAfter > 0 && ++writeCount >= closeAfter) {
+                m_open = false;
+            }
+            gatheringWrites++;
+
+            if (m_behavior == SINK) {
+                long written = 0;
+                for (int ii = offset; ii < offset + length; ii++) {
+                    written += srcs[ii].remaining();
+                    srcs[ii].position(srcs[ii].limit());
+                }
+                return written;
+            }
+            else if (m_behavior == FULL) {
+                return 0;
+            }
+            else if (m_behavior == PARTIAL) {
+                if (wrotePartial) {
+                    return 0;
+                } else {
+                    wrotePartial = true;
+                }
+                // accept half of the first buffer
+                int half = srcs[offset].remaining() / 2;
+                srcs[offset].position(srcs[offset].position() + half);
+                return half;
+            }
+            assert(false);
+            return -1;
         }
     }
 
@@ -337,14 +366,7 @@ public class TestNIOWriteStream extends TestCase {
         AdmissionControlGroup acg = new AdmissionControlGroup(2, 1024);
         NIOWriteStream wstream = new NIOWriteStream(port, null, null, acg);
 
-        ByteBuffer tmp = ByteBuffer.allocate(6);
-        tmp.put((byte)1);
-        tmp.put((byte)2);
-        tmp.put((byte)3);
-        tmp.put((byte)4);
-        tmp.put((byte)5);
-        tmp.put((byte)6);
-        tmp.flip();
+        ByteBuffer tmp = ByteBuffer.allocate(258);
         ByteBuffer tmp2 = ByteBuffer.allocate(4);
         tmp2.put((byte)1);
         tmp2.put((byte)2);
@@ -358,7 +380,8 @@ public class TestNIOWriteStream extends TestCase {
         boolean threwException = false;
         try {
             wstream.swapAndSerializeQueuedWrites(pool);
-            //First write will succeed leaving 2 in first buffer and 4 in next
+            //First write will succeed, taking the 64 buffers of one gathering
+            //write and leaving 2 bytes of the first message and 4 of the next
             wstream.drainTo( channel);
         } catch (IOException e) {
             threwException = true;
@@ -389,6 +412,40 @@ public class TestNIOWriteStream extends TestCase {
         wstream.shutdown();
     }
 
+    public void testGatheringWrite() throws IOException {
+        MockChannel channel = new MockChannel(MockChannel.SINK, 0);
+        MockPort port = new MockPort();
+        NIOWriteStream wstream = new NIOWriteStream(port);
+
+        // Ten 4 byte messages fill ten of the pool's 4 byte buffers
+        for (int ii = 0; ii < 10; ii++) {
+            ByteBuffer tmp = ByteBuffer.allocate(4);
+            tmp.putInt(ii);
+            tmp.flip();
+            wstream.enqueue(tmp);
+        }
+        wstream.swapAndSerializeQueuedWrites(pool);
+        assertEquals(40, wstream.drainTo(channel));
+        assertEquals(1, channel.gatheringWrites);
+        assertTrue(wstream.isEmpty());
+
+        // What a partial write leaves behind goes out with the queued buffers
+        for (int ii = 0; ii < 3; ii++) {
+            ByteBuffer tmp = ByteBuffer.allocate(4);
+            tmp.putInt(ii);
+            tmp.flip();
+            wstream.enqueue(tmp);
+        }
+        channel.m_behavior = MockChannel.PARTIAL;
+        wstream.swapAndSerializeQueuedWrites(pool);
+        assertEquals(2, wstream.drainTo(channel));
+        assertFalse(wstream.isEmpty());
+        channel.m_behavior = MockChannel.SINK;
+        assertEquals(10, wstream.drainTo(channel));
+        assertTrue(wstream.isEmpty());
+        wstream.shutdown();
+    }
+
     public void testLastWriteDelta() throws Exception {
         EstTimeUpdater.pause = true;
         Thread.sleep(10);
@@ -0,0 +1,99 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+package org.voltcore.utils;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.Arrays;
+
+import junit.framework.TestCase;
+
+public class TestCpuTopology extends TestCase {
+
+    private File m_root;
+
+    @Override
+    public void setUp() throws IOException {
+        m_root = Files.createTempDirectory("cputopology").toFile();
+    }
+
+    @Override
+    public void tearDown() {
+        delete(m_root);
+    }
+
+    private static void delete(File file) {
+        File[] children = file.listFiles();
+        if (children != null) {
+            for (File child : children) {
+                delete(child);
+            }
+        }
+        file.delete();
+    }
+
+    private void write(String path, String contents) throws IOException {
+        File file = new File(m_root, path);
+        file.getParentFile().mkdirs();
+        Files.write(file.toPath(), contents.getBytes(StandardCharsets.UTF_8));
+    }
+
+    public void testParseCpuList() {
+        assertEquals(Arrays.asList(0, 1, 2, 3, 8, 10, 11), CpuTopology.parseCpuList("0-3,8,10-11\n"));
+        assertEquals(Arrays.asList(5), CpuTopology.parseCpuList("5"));
+        assertTrue(CpuTopology.parseCpuList("\n").isEmpty());
+    }
+
+    public void testSitesSpreadOverNodesOnePerCore() throws IOException {
+        // Two nodes of two cores, each core with two hardware threads:
+        // node 0 has cores {0,4} and {1,5}, node 1 has {2,6} and {3,7}.
+        write("node/node0/cpulist", "0-1,4-5\n");
+        write("node/node1/cpulist", "2-3,6-7\n");
+        for (int cpu = 0; cpu < 8; cpu++) {
+            write("cpu/cpu" + cpu + "/topology/thread_siblings_list", (cpu % 4) + "," + (cpu % 4 + 4) + "\n");
+        }
+
+        CpuTopology topology = CpuTopology.load(m_root);
+        assertNotNull(topology);
+        assertEquals(2, topology.getNodeCount());
+        assertEquals(4, topology.getCoreCount());
+        assertEquals(Arrays.asList("0", "2", "1"), topology.getSiteBindings(3));
+        // No more bindings than cores.
+        assertEquals(Arrays.asList("0", "2", "1", "3"), topology.getSiteBindings(6));
+    }
+
+    public void testWithoutNumaNodes() throws IOException {
+        write("cpu/online", "0-2\n");
+        CpuTopology topology = CpuTopology.load(m_root);
+        assertNotNull(topology);
+        assertEquals(1, topology.getNodeCount());
+        assertEquals(Arrays.asList("0", "1"), topology.getSiteBindings(2));
+    }
+
+    public void testUnreadableTopology() {
+        assertNull(CpuTopology.load(m_root));
+    }
+}
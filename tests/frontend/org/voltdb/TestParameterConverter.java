@@ -203,4 +203,27 @@ public class TestParameterConverter extends TestCase
         assertEquals(null, ParameterConverter.tryToMakeCompatible(String.class, VoltType.NULL_STRING_OR_VARBINARY));
         assertEquals(null, ParameterConverter.tryToMakeCompatible(BigDecimal.class, VoltType.NULL_DECIMAL));
     }
+
+    public void testUnconvertedClasses()
+    {
+        // values of the unconverted class come back as they are, nulls included
+        Object[][] values = {
+                { long.class, 5L, VoltType.NULL_BIGINT },
+                { int.class, 5, VoltType.NULL_INTEGER },
+                { short.class, (short) 5, VoltType.NULL_SMALLINT },
+                { byte.class, (byte) 5, VoltType.NULL_TINYINT },
+                { double.class, 5.0, VoltType.NULL_FLOAT },
+                { byte[].class, new byte[] { 5 }, new byte[0] } };
+        for (Object[] value : values) {
+            Class<?> expectedClz = (Class<?>) value[0];
+            assertEquals(value[1].getClass(), ParameterConverter.getUnconvertedClass(expectedClz));
+            assertSame(value[1], ParameterConverter.tryToMakeCompatible(expectedClz, value[1]));
+            assertSame(value[2], ParameterConverter.tryToMakeCompatible(expectedClz, value[2]));
+        }
+        // strings and objects can hold null sigils
+        assertNull(ParameterConverter.getUnconvertedClass(String.class));
+        assertNull(ParameterConverter.getUnconvertedClass(TimestampType.class));
+        assertNull(ParameterConverter.getUnconvertedClass(BigDecimal.class));
+        assertNull(ParameterConverter.getUnconvertedClass(long[].class));
+    }
 }
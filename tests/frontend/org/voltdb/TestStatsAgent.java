@@ -48,6 +48,11 @@ public class TestStatsAgent {
 
     private final Connection m_mockConnection = new MockConnection() {
 
+        @Override
+        public long connectionId() {
+            return 7;
+        }
+
         @Override
         public WriteStream writeStream() {
             return new MockWriteStream() {
@@ -174,6 +179,54 @@ public class TestStatsAgent {
         }
     }
 
+    @Test
+    public void testCollectChangedStats() throws Exception {
+        MockStatsSource.columns = Arrays.asList(new VoltTable.ColumnInfo[] {
+            new VoltTable.ColumnInfo("c1", VoltType.STRING),
+            new VoltTable.ColumnInfo("c2", VoltType.BIGINT)
+        });
+        Object[][] rows = new Object[][] {
+            {"A", 1L},
+            {"B", 2L}
+        };
+        m_mvoltdb.getStatsAgent().registerStatsSource(StatsSelector.SNAPSHOTSTATUS, 0, new MockStatsSource(rows));
+        ParameterSet changes = subselect("SNAPSHOTSTATUS", (int) StatsAgent.CHANGES_SINCE_LAST_POLL);
+
+        // the first poll gets everything
+        m_mvoltdb.getStatsAgent().performOpsAction(m_mockConnection, 32, OpsSelector.STATISTICS, changes);
+        ClientResponseImpl response = responses.take();
+        assertEquals(ClientResponse.SUCCESS, response.getStatus());
+        assertEquals(2, response.getResults()[0].getRowCount());
+
+        // nothing changed
+        m_mvoltdb.getStatsAgent().performOpsAction(m_mockConnection, 32, OpsSelector.STATISTICS, changes);
+        response = responses.take();
+        assertEquals(ClientResponse.SUCCESS, response.getStatus());
+        assertEquals(0, response.getResults()[0].getRowCount());
+
+        // only the changed row comes back
+        rows[1][1] = 3L;
+        m_mvoltdb.getStatsAgent().performOpsAction(m_mockConnection, 32, OpsSelector.STATISTICS, changes);
+        response = responses.take();
+        VoltTable changed = response.getResults()[0];
+        assertEquals(1, changed.getRowCount());
+        changed.advanceRow();
+        assertEquals("B", changed.getString("c1"));
+        assertEquals(3L, changed.getLong("c2"));
+
+        // a plain poll still gets everything
+        m_mvoltdb.getStatsAgent().performOpsAction(m_mockConnection, 32, OpsSelector.STATISTICS,
+                subselect("SNAPSHOTSTATUS", 0));
+        response = responses.take();
+        assertEquals(2, response.getResults()[0].getRowCount());
+
+        // aggregated selectors can't be polled for changes
+        m_mvoltdb.getStatsAgent().performOpsAction(m_mockConnection, 32, OpsSelector.STATISTICS,
+                subselect("PROCEDUREPROFILE", (int) StatsAgent.CHANGES_SINCE_LAST_POLL));
+        response = responses.take();
+        assertEquals(ClientResponse.GRACEFUL_FAILURE, response.getStatus());
+    }
+
     @Test
     public void testCollectUnavailableStats() throws Exception {
         for (StatsSelector selector : StatsSelector.values()) {
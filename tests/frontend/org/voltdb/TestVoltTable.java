@@ -1366,6 +1366,75 @@ public class TestVoltTable extends TestCase {
         assertTrue(fetchRowTime < (advanceRowTime * 20));
     }
 
+    public void testBulkColumnReads() {
+        VoltTable table = new VoltTable(
+                new ColumnInfo("ID", VoltType.BIGINT),
+                new ColumnInfo("SMALL", VoltType.TINYINT),
+                new ColumnInfo("NAME", VoltType.STRING),
+                new ColumnInfo("COUNT", VoltType.INTEGER),
+                new ColumnInfo("PRICE", VoltType.FLOAT),
+                new ColumnInfo("AT", VoltType.TIMESTAMP));
+        final int ROW_COUNT = 1000;
+        for (int i = 0; i < ROW_COUNT; i++) {
+            table.addRow((long) i,
+                         (i % 5 == 0) ? null : (byte) (i % 100),
+                         (i % 3 == 0) ? null : "name " + i,
+                         (i % 7 == 0) ? null : i * 2,
+                         (i % 11 == 0) ? null : i / 4.0,
+                         new TimestampType(i * 1000L));
+        }
+        for (int i = 0; i <= 7; i++) {
+            table.advanceRow();
+        }
+
+        long[] ids = table.getLongColumn(0);
+        long[] smalls = table.getLongColumn(1);
+        long[] counts = table.getLongColumn(3);
+        double[] prices = table.getDoubleColumn(4);
+        long[] times = table.getLongColumn(5);
+        assertEquals(ROW_COUNT, ids.length);
+        assertEquals(7, table.getActiveRowIndex());
+
+        // The bulk reads agree with reading row by row, nulls aside.
+        table.resetRowPosition();
+        int i = 0;
+        while (table.advanceRow()) {
+            assertEquals(table.getLong(0), ids[i]);
+            long small = table.getLong(1);
+            assertEquals(table.wasNull() ? VoltType.NULL_BIGINT : small, smalls[i]);
+            long count = table.getLong(3);
+            assertEquals(table.wasNull() ? VoltType.NULL_BIGINT : count, counts[i]);
+            double price = table.getDouble(4);
+            assertEquals(table.wasNull() ? VoltType.NULL_FLOAT : price, prices[i], 0.0);
+            assertEquals(table.getTimestampAsLong(5), times[i]);
+            i++;
+        }
+        assertEquals(ROW_COUNT, i);
+        assertEquals(VoltType.NULL_BIGINT, smalls[0]);
+        assertEquals(VoltType.NULL_BIGINT, counts[14]);
+        assertEquals(30L, counts[15]);
+        assertEquals(VoltType.NULL_FLOAT, prices[11], 0.0);
+
+        // Only numeric columns of the right kind can be read in bulk.
+        try {
+            table.getLongColumn(2);
+            fail();
+        }
+        catch (IllegalArgumentException e) {}
+        try {
+            table.getDoubleColumn(0);
+            fail();
+        }
+        catch (IllegalArgumentException e) {}
+        try {
+            table.getLongColumn(6);
+            fail();
+        }
+        catch (IndexOutOfBoundsException e) {}
+
+        assertEquals(0, new VoltTable(new ColumnInfo("ID", VoltType.BIGINT)).getLongColumn(0).length);
+    }
+
     public void testFetchRowAccuracy() {
         final int ROW_COUNT = 10000;
 
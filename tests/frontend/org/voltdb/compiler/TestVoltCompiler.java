@@ -4335,6 +4335,172 @@ public class TestVoltCompiler extends TestCase {
                 );
     }
 
+    public void testGoodTTLTable() throws Exception {
+        Database db;
+        String schema = "create table events (id integer not null, ts timestamp, f1 varchar(16));\n" +
+                        "partition table events on column id;\n" +
+                        "create index events_ts on events (ts, id);\n";
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "ttl table events on column ts 10 minutes;"
+                );
+        Table events = db.getTables().getIgnoreCase("events");
+        assertEquals("TS", events.getTtlcolumn().getTypeName());
+        assertEquals(600, events.getTtlseconds());
+        assertEquals(1000, events.getTtlbatchsize());
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "TTL TABLE EVENTS ON COLUMN TS 90 BATCH_SIZE 50;"
+                );
+        events = db.getTables().getIgnoreCase("events");
+        assertEquals(90, events.getTtlseconds());
+        assertEquals(50, events.getTtlbatchsize());
+
+        // TTL statement is order sensitive
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "ttl table events on column ts 1 days;",
+                "ttl table events disable;"
+                );
+        assertNull(db.getTables().getIgnoreCase("events").getTtlcolumn());
+
+        // Dropping the column drops the TTL
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "ttl table events on column ts 1 hours;",
+                "alter table events drop column ts cascade;"
+                );
+        assertNull(db.getTables().getIgnoreCase("events").getTtlcolumn());
+    }
+
+    public void testBadTTLTable() throws Exception {
+        String schema = "create table events (id integer not null, ts timestamp, f1 varchar(16));\n" +
+                        "partition table events on column id;\n";
+
+        badDDLAgainstSimpleSchema(".+TTL, table non_existant was not present in the catalog.*",
+                "ttl table non_existant on column ts 10;"
+                );
+
+        badDDLAgainstSimpleSchema(".+Invalid TTL TABLE statement.*",
+                "ttl table books on column cash;"
+                );
+
+        badDDLAgainstSimpleSchema(".+Invalid TTL TABLE statement.*",
+                "ttl table books on column cash 10 weeks;"
+                );
+
+        badDDLAgainstSimpleSchema(".+column CASH of table BOOKS is not a TIMESTAMP column.*",
+                "ttl table books on column cash 10;"
+                );
+
+        badDDLAgainstSimpleSchema(".+column NOPE was not found in table EVENTS.*",
+                schema,
+                "ttl table events on column nope 10;"
+                );
+
+        badDDLAgainstSimpleSchema(".+table EVENTS needs an index whose first key is column TS.*",
+                schema,
+                "create index events_id_ts on events (id, ts);",
+                "ttl table events on column ts 10;"
+                );
+
+        badDDLAgainstSimpleSchema(".+the time to live must be between 1 and.*",
+                schema,
+                "create index events_ts on events (ts);",
+                "ttl table events on column ts 0;"
+                );
+
+        badDDLAgainstSimpleSchema(".+table EVENTS has a TTL.*",
+                schema,
+                "create index events_ts on events (ts);",
+                "ttl table events on column ts 10;",
+                "dr table events;"
+                );
+    }
+
+    public void testAppendOnlyTable() throws Exception {
+        Database db;
+        String schema = "create table events (id integer not null, ts timestamp, f1 varchar(16));\n" +
+                        "partition table events on column id;\n";
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "append only table events;"
+                );
+        assertTrue(db.getTables().getIgnoreCase("events").getIsappendonly());
+        assertFalse(db.getTables().getIgnoreCase("books").getIsappendonly());
+
+        // An append-only table expires rows in insertion order, with no index
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "APPEND ONLY TABLE EVENTS;",
+                "TTL TABLE EVENTS ON COLUMN TS 10 MINUTES;"
+                );
+        assertEquals("TS", db.getTables().getIgnoreCase("events").getTtlcolumn().getTypeName());
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "append only table events;",
+                "append only table events disable;"
+                );
+        assertFalse(db.getTables().getIgnoreCase("events").getIsappendonly());
+
+        badDDLAgainstSimpleSchema(".+APPEND ONLY, table non_existant was not present in the catalog.*",
+                "append only table non_existant;"
+                );
+
+        badDDLAgainstSimpleSchema(".+Invalid APPEND ONLY TABLE statement.*",
+                "append table books;"
+                );
+
+        badDDLAgainstSimpleSchema(".+only tables can be append only.*",
+                schema,
+                "create view events_count (id, total) as select id, count(*) from events group by id;",
+                "append only table events_count;"
+                );
+    }
+
+    public void testClusterTable() throws Exception {
+        Database db;
+        String schema = "create table history (account integer not null, ts timestamp not null, " +
+                        "amount float, primary key (account, ts));\n" +
+                        "partition table history on column account;\n";
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "cluster table history;"
+                );
+        assertTrue(db.getTables().getIgnoreCase("history").getIsclustered());
+
+        db = goodDDLAgainstSimpleSchema(
+                schema,
+                "CLUSTER TABLE HISTORY;",
+                "CLUSTER TABLE HISTORY DISABLE;"
+                );
+        assertFalse(db.getTables().getIgnoreCase("history").getIsclustered());
+
+        badDDLAgainstSimpleSchema(".+CLUSTER, table non_existant was not present in the catalog.*",
+                "cluster table non_existant;"
+                );
+
+        badDDLAgainstSimpleSchema(".+Invalid CLUSTER TABLE statement.*",
+                "cluster table history on account;"
+                );
+
+        badDDLAgainstSimpleSchema(".+table EVENTS needs an ordered primary key to be clustered by.*",
+                "create table events (id integer not null, ts timestamp);",
+                "cluster table events;"
+                );
+
+        badDDLAgainstSimpleSchema(".+table HISTORY is APPEND ONLY.*",
+                schema,
+                "append only table history;",
+                "cluster table history;"
+                );
+    }
+
     public void testCompileFromDDL() throws IOException {
         String schema1 =
                 "create table table1r_el " +
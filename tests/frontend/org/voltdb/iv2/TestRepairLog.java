@@ -375,6 +375,39 @@ public class TestRepairLog
         validateRepairLog(log.contents(1l, false), endSpUniqueId, endMpUniqueId);
     }
 
+    @Test
+    public void testLoggedInitiationDropsDeserializedParams() throws IOException {
+        StoredProcedureInvocation local = new StoredProcedureInvocation();
+        local.setProcName("Insert");
+        local.setParams(1, "one");
+        ByteBuffer buf = ByteBuffer.allocate(local.getSerializedSize());
+        local.flattenToBuffer(buf);
+        buf.flip();
+        StoredProcedureInvocation spi = new StoredProcedureInvocation();
+        spi.initFromBuffer(buf);
+        // As the site does when it runs the transaction
+        ParameterSet params = spi.getParams();
+
+        Iv2InitiateTaskMessage msg =
+                new Iv2InitiateTaskMessage(1l, 2l, Long.MIN_VALUE, 3l, 4l, false, true,
+                        spi, 5l, 6l, false);
+        msg.setSpHandle(900l);
+        RepairLog log = new RepairLog();
+        log.deliver(msg);
+
+        List<Iv2RepairLogResponseMessage> contents = log.contents(1l, false);
+        assertEquals(2, contents.size());
+        Iv2InitiateTaskMessage logged = (Iv2InitiateTaskMessage) contents.get(1).getPayload();
+        assertFalse(logged == msg);
+        assertFalse(logged.getStoredProcedureInvocation() == spi);
+        assertEquals(900l, logged.getSpHandle());
+        assertEquals(3l, logged.getTxnId());
+        assertEquals(msg.getSerializedSize(), logged.getSerializedSize());
+        ParameterSet loggedParams = logged.getStoredProcedureInvocation().getParams();
+        assertFalse(loggedParams == params);
+        assertEquals(params, loggedParams);
+    }
+
     @Test
     public void testTruncationWithInterest()
     {
@@ -0,0 +1,108 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+package org.voltdb.iv2;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicReference;
+
+import junit.framework.TestCase;
+
+import org.junit.Test;
+import org.voltdb.StarvationTracker;
+
+public class TestSiteTaskerQueue extends TestCase
+{
+    private static SiteTaskerQueue getSiteTaskerQueue() {
+        SiteTaskerQueue queue = new SiteTaskerQueue();
+        queue.setStarvationTracker(new StarvationTracker(0));
+        return queue;
+    }
+
+    private static SiteTasker task() {
+        return new SiteTasker.SiteTaskerRunnable() {
+            @Override
+            void run() { }
+        };
+    }
+
+    @Test
+    public void testTasksComeOutInOrder() throws InterruptedException {
+        SiteTaskerQueue queue = getSiteTaskerQueue();
+        SiteTasker first = task();
+        SiteTasker second = task();
+        queue.offer(first);
+        queue.offer(second);
+        assertSame(first, queue.peek());
+        assertSame(first, queue.take());
+        assertSame(second, queue.poll());
+        assertTrue(queue.isEmpty());
+        assertNull(queue.poll());
+    }
+
+    @Test
+    public void testOfferWakesParkedSite() throws Exception {
+        final SiteTaskerQueue queue = getSiteTaskerQueue();
+        final AtomicReference<SiteTasker> taken = new AtomicReference<SiteTasker>();
+        final CountDownLatch done = new CountDownLatch(1);
+        Thread site = new Thread() {
+            @Override
+            public void run() {
+                try {
+                    taken.set(queue.take());
+                } catch (InterruptedException e) {
+                }
+                done.countDown();
+            }
+        };
+        site.start();
+        // Long enough for the site to get past spinning and park.
+        Thread.sleep(200);
+        SiteTasker offered = task();
+        queue.offer(offered);
+        assertTrue(done.await(10, TimeUnit.SECONDS));
+        assertSame(offered, taken.get());
+    }
+
+    @Test
+    public void testInterruptStopsTake() throws Exception {
+        final SiteTaskerQueue queue = getSiteTaskerQueue();
+        final CountDownLatch interrupted = new CountDownLatch(1);
+        Thread site = new Thread() {
+            @Override
+            public void run() {
+                try {
+                    queue.take();
+                } catch (InterruptedException e) {
+                    interrupted.countDown();
+                }
+            }
+        };
+        site.start();
+        Thread.sleep(200);
+        site.interrupt();
+        assertTrue(interrupted.await(10, TimeUnit.SECONDS));
+    }
+}
@@ -0,0 +1,198 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2016 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+package org.voltdb.jni;
+
+import java.util.Arrays;
+
+import org.voltdb.JNICallStats;
+import org.voltdb.LegacyHashinator;
+import org.voltdb.ParameterSet;
+import org.voltdb.TheHashinator.HashinatorConfig;
+import org.voltdb.TheHashinator.HashinatorType;
+import org.voltdb.VoltDB;
+import org.voltdb.VoltTable;
+import org.voltdb.VoltType;
+import org.voltdb.benchmark.tpcc.TPCCProjectBuilder;
+import org.voltdb.catalog.Catalog;
+import org.voltdb.catalog.PlanFragment;
+import org.voltdb.catalog.Procedure;
+import org.voltdb.catalog.Statement;
+import org.voltdb.planner.ActivePlanRepository;
+import org.voltdb.utils.CatalogUtil;
+import org.voltdb.utils.Encoder;
+
+/**
+ * Measures the cost of crossing JNI, without a server or network in the way.
+ *
+ * Runs a single-fragment "SELECT * FROM WAREHOUSE" against an empty table, so
+ * the round trip is almost all parameter serialization, the two crossings and
+ * result deserialization, then against a table large enough for the EE to
+ * make fragment progress upcalls, and the EE tick, which passes no buffers.
+ * Prints the nanoseconds per call of each, then the per-call counters that
+ * the @Statistics JNICALLS selector reports.
+ *
+ * Run with "ant jnimicrobench [-Diterations=N]".
+ */
+public class JNICrossingMicrobench {
+
+    private static final int REPS = 5;
+    private static final int SCAN_ROWS = 25000;
+
+    private final ExecutionEngine m_ee;
+    private final JNICallStats m_callStats = new JNICallStats(0);
+    private final int m_warehouseTableId;
+    private final long m_fragmentId;
+    private final String m_sqlText;
+    private final ParameterSet[] m_params = new ParameterSet[] { ParameterSet.emptyParameterSet() };
+
+    interface Call {
+        void run() throws Exception;
+    }
+
+    JNICrossingMicrobench() throws Exception {
+        VoltDB.instance().readBuildInfo("Test");
+        Catalog catalog = new TPCCProjectBuilder().createTPCCSchemaCatalog();
+        m_warehouseTableId = catalog.getClusters().get("cluster").getDatabases().
+                get("database").getTables().get("WAREHOUSE").getRelativeIndex();
+        Procedure proc = catalog.getClusters().get("cluster").getDatabases().get("database").
+                getProcedures().getIgnoreCase("FragmentUpdateTestProcedure");
+        Statement selectStmt = proc.getStatements().getIgnoreCase("warehouse_select");
+        PlanFragment selectBottomFrag = null;
+        int i = 0;
+        // the second fragment is the one that scans
+        for (PlanFragment f : selectStmt.getFragments()) {
+            if (i != 0) selectBottomFrag = f;
+            i++;
+        }
+        m_fragmentId = CatalogUtil.getUniqueIdForFragment(selectBottomFrag);
+        m_sqlText = selectStmt.getSqltext();
+        ActivePlanRepository.clear();
+        ActivePlanRepository.addFragmentForTest(
+                m_fragmentId,
+                Encoder.decodeBase64AndDecompressToBytes(selectBottomFrag.getPlannodetree()),
+                m_sqlText);
+
+        m_ee = new ExecutionEngineJNI(
+                2,
+                1,
+                0,
+                0,
+                "",
+                0,
+                64*1024,
+                100,
+                new HashinatorConfig(HashinatorType.LEGACY,
+                                     LegacyHashinator.getConfigureBytes(1),
+                                     0,
+                                     0), false);
+        m_ee.loadCatalog(0, catalog.serialize());
+        m_ee.setCallStats(m_callStats);
+    }
+
+    void loadWarehouses(int rows) {
+        VoltTable data = new VoltTable(
+                new VoltTable.ColumnInfo("W_ID", VoltType.SMALLINT),
+                new VoltTable.ColumnInfo("W_NAME", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_STREET_1", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_STREET_2", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_CITY", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_STATE", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_ZIP", VoltType.STRING),
+                new VoltTable.ColumnInfo("W_TAX", VoltType.FLOAT),
+                new VoltTable.ColumnInfo("W_YTD", VoltType.FLOAT)
+                );
+        for (int i = 0; i < rows; ++i) {
+            data.addRow(i, "name" + i, "st1", "st2", "city", "ST", "zip", 0, 0);
+        }
+        m_ee.loadTable(m_warehouseTableId, data, 0, 0, 0, 0, false, false, 0);
+    }
+
+    void executeSelect() {
+        m_ee.executePlanFragments(1, new long[] { m_fragmentId }, null, m_params,
+                new String[] { m_sqlText }, 3, 3, 2, 42, Long.MAX_VALUE);
+    }
+
+    /** Print the minimum and median nanoseconds per call over REPS timed runs */
+    static void measure(String name, int iterations, Call call) throws Exception {
+        for (int i = 0; i < iterations / 10; i++) {
+            call.run();
+        }
+        long[] nanosPerCall = new long[REPS];
+        for (int rep = 0; rep < REPS; rep++) {
+            final long start = System.nanoTime();
+            for (int i = 0; i < iterations; i++) {
+                call.run();
+            }
+            nanosPerCall[rep] = (System.nanoTime() - start) / iterations;
+        }
+        Arrays.sort(nanosPerCall);
+        System.out.printf("%-40s %10d calls  min %8d ns  median %8d ns%n",
+                name, iterations, nanosPerCall[0], nanosPerCall[REPS / 2]);
+    }
+
+    void printCallStats() {
+        m_callStats.updateUpcalls(m_ee.getUpcallStats());
+        System.out.printf("%n%-5s %-32s %12s %14s %10s%n",
+                "DIR", "CALL", "INVOCATIONS", "TOTAL_TIME(us)", "AVG(ns)");
+        for (Object[] row : m_callStats.getStatsRows(false, System.currentTimeMillis())) {
+            // skip the timestamp, host and site columns
+            if ((Long)row[6] > 0) {
+                System.out.printf("%-5s %-32s %12d %14d %10d%n", row[4], row[5], row[6], row[7], row[8]);
+            }
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        int iterations = 200000;
+        if (args.length >= 1 && !args[0].equals("${iterations}")) {
+            iterations = Integer.parseInt(args[0]);
+        }
+
+        final JNICrossingMicrobench bench = new JNICrossingMicrobench();
+        try {
+            measure("tick", iterations, new Call() {
+                @Override
+                public void run() {
+                    bench.m_ee.tick(System.currentTimeMillis(), 0);
+                }
+            });
+            measure("executePlanFragments, empty table", iterations, new Call() {
+                @Override
+                public void run() {
+                    bench.executeSelect();
+                }
+            });
+            bench.loadWarehouses(SCAN_ROWS);
+            measure("executePlanFragments, " + SCAN_ROWS + " rows", Math.max(1, iterations / 1000), new Call() {
+                @Override
+                public void run() {
+                    bench.executeSelect();
+                }
+            });
+            bench.printCallStats();
+        } finally {
+            bench.m_ee.release();
+        }
+    }
+}
@@ -35,6 +35,9 @@ import junit.framework.Test;
 import org.HdrHistogram_voltpatches.AbstractHistogram;
 import org.HdrHistogram_voltpatches.Histogram;
 import org.voltcore.utils.CompressionStrategySnappy;
+import org.voltdb.JNICallStats;
+import org.voltdb.SiteMemoryStats;
+import org.voltdb.SiteTimeTracker;
 import org.voltdb.VoltTable;
 import org.voltdb.VoltTable.ColumnInfo;
 import org.voltdb.VoltType;
@@ -285,7 +288,7 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         System.out.println("\n\nTESTING MEMORY STATS\n\n\n");
         Client client  = getFullyConnectedClient();
 
-        ColumnInfo[] expectedSchema = new ColumnInfo[14];
+        ColumnInfo[] expectedSchema = new ColumnInfo[16];
         expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
         expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
         expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
@@ -300,6 +303,8 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         expectedSchema[11] = new ColumnInfo("POOLEDMEMORY", VoltType.BIGINT);
         expectedSchema[12] = new ColumnInfo("PHYSICALMEMORY", VoltType.BIGINT);
         expectedSchema[13] = new ColumnInfo("JAVAMAXHEAP", VoltType.INTEGER);
+        expectedSchema[14] = new ColumnInfo("HUGEPAGEMEMORY", VoltType.BIGINT);
+        expectedSchema[15] = new ColumnInfo("LOCALNODEMEMORY", VoltType.BIGINT);
         VoltTable expectedTable = new VoltTable(expectedSchema);
 
         VoltTable[] results = null;
@@ -491,6 +496,165 @@ public class TestStatisticsSuite extends StatisticsTestSuiteBase {
         validateRowSeenAtAllHosts(results[0], columnTargets, false);
     }
 
+    public void testSiteTimeStatistics() throws Exception {
+        System.out.println("\n\nTESTING SITETIME STATS\n\n\n");
+        Client client  = getFullyConnectedClient();
+
+        ColumnInfo[] expectedSchema = new ColumnInfo[7];
+        expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
+        expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
+        expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
+        expectedSchema[3] = new ColumnInfo("SITE_ID", VoltType.INTEGER);
+        expectedSchema[4] = new ColumnInfo("ACTIVITY", VoltType.STRING);
+        expectedSchema[5] = new ColumnInfo("TIME", VoltType.BIGINT);
+        expectedSchema[6] = new ColumnInfo("PERCENT", VoltType.FLOAT);
+        VoltTable expectedTable = new VoltTable(expectedSchema);
+
+        VoltTable[] results = null;
+        //
+        // SITETIME
+        //
+        results = client.callProcedure("@Statistics", "SITETIME", 0).getResults();
+        // one aggregate table returned
+        assertEquals(1, results.length);
+        System.out.println("Test SITETIME table: " + results[0].toString());
+        validateSchema(results[0], expectedTable);
+        // One row per activity per partition site; the MPI is not tracked
+        assertEquals(HOSTS * SITES * SiteTimeTracker.Activity.values().length,
+                     results[0].getRowCount());
+        results[0].advanceRow();
+        Map<String, String> columnTargets = new HashMap<String, String>();
+        columnTargets.put("HOSTNAME", results[0].getString("HOSTNAME"));
+        validateRowSeenAtAllHosts(results[0], columnTargets, false);
+    }
+
+    public void testMemoryDetailStatistics() throws Exception {
+        System.out.println("\n\nTESTING MEMORYDETAIL STATS\n\n\n");
+        Client client  = getFullyConnectedClient();
+
+        ColumnInfo[] expectedSchema = new ColumnInfo[6];
+        expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
+        expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
+        expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
+        expectedSchema[3] = new ColumnInfo("SITE_ID", VoltType.INTEGER);
+        expectedSchema[4] = new ColumnInfo("SUBSYSTEM", VoltType.STRING);
+        expectedSchema[5] = new ColumnInfo("MEMORY", VoltType.BIGINT);
+        VoltTable expectedTable = new VoltTable(expectedSchema);
+
+        VoltTable[] results = null;
+        //
+        // MEMORYDETAIL
+        //
+        results = client.callProcedure("@Statistics", "MEMORYDETAIL", 0).getResults();
+        // one aggregate table returned
+        assertEquals(1, results.length);
+        System.out.println("Test MEMORYDETAIL table: " + results[0].toString());
+        validateSchema(results[0], expectedTable);
+        // One row per subsystem per partition site; the MPI is not tracked
+        assertEquals(HOSTS * SITES * SiteMemoryStats.Subsystem.values().length,
+                     results[0].getRowCount());
+        results[0].advanceRow();
+        Map<String, String> columnTargets = new HashMap<String, String>();
+        columnTargets.put("HOSTNAME", results[0].getString("HOSTNAME"));
+        validateRowSeenAtAllHosts(results[0], columnTargets, false);
+    }
+
+    public void testQueueStatistics() throws Exception {
+        System.out.println("\n\nTESTING QUEUE STATS\n\n\n");
+        Client client  = getFullyConnectedClient();
+
+        ColumnInfo[] expectedSchema = new ColumnInfo[10];
+        expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
+        expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
+        expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
+        expectedSchema[3] = new ColumnInfo("SITE_ID", VoltType.INTEGER);
+        expectedSchema[4] = new ColumnInfo("QUEUE", VoltType.STRING);
+        expectedSchema[5] = new ColumnInfo("AVG_DEPTH", VoltType.FLOAT);
+        expectedSchema[6] = new ColumnInfo("MAX_DEPTH", VoltType.BIGINT);
+        expectedSchema[7] = new ColumnInfo("WAIT_SAMPLES", VoltType.BIGINT);
+        expectedSchema[8] = new ColumnInfo("AVG_WAIT", VoltType.FLOAT);
+        expectedSchema[9] = new ColumnInfo("MAX_WAIT", VoltType.BIGINT);
+        VoltTable expectedTable = new VoltTable(expectedSchema);
+
+        VoltTable[] results = null;
+        //
+        // QUEUE
+        //
+        results = client.callProcedure("@Statistics", "QUEUE", 0).getResults();
+        // one aggregate table returned
+        assertEquals(1, results.length);
+        System.out.println("Test QUEUE table: " + results[0].toString());
+        validateSchema(results[0], expectedTable);
+        // Per host: the task queue and mailbox lock of each partition site, the MPI's
+        // task queue, and the foreign host writes, client writes and PBD monitor
+        assertEquals(HOSTS * (SITES * 2 + 1 + 3), results[0].getRowCount());
+        results[0].advanceRow();
+        Map<String, String> columnTargets = new HashMap<String, String>();
+        columnTargets.put("HOSTNAME", results[0].getString("HOSTNAME"));
+        validateRowSeenAtAllHosts(results[0], columnTargets, false);
+    }
+
+    public void testJNICallStatistics() throws Exception {
+        System.out.println("\n\nTESTING JNICALLS STATS\n\n\n");
+        Client client  = getFullyConnectedClient();
+
+        ColumnInfo[] expectedSchema = new ColumnInfo[9];
+        expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
+        expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
+        expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
+        expectedSchema[3] = new ColumnInfo("SITE_ID", VoltType.INTEGER);
+        expectedSchema[4] = new ColumnInfo("DIRECTION", VoltType.STRING);
+        expectedSchema[5] = new ColumnInfo("CALL", VoltType.STRING);
+        expectedSchema[6] = new ColumnInfo("INVOCATIONS", VoltType.BIGINT);
+        expectedSchema[7] = new ColumnInfo("TOTAL_TIME", VoltType.BIGINT);
+        expectedSchema[8] = new ColumnInfo("AVG_TIME", VoltType.BIGINT);
+        VoltTable expectedTable = new VoltTable(expectedSchema);
+
+        VoltTable[] results = null;
+        //
+        // JNICALLS
+        //
+        results = client.callProcedure("@Statistics", "JNICALLS", 0).getResults();
+        // one aggregate table returned
+        assertEquals(1, results.length);
+        System.out.println("Test JNICALLS table: " + results[0].toString());
+        validateSchema(results[0], expectedTable);
+        // One row per downcall and upcall at each site
+        final int calls = JNICallStats.Downcall.values().length + JNICallStats.Upcall.values().length;
+        assertEquals(HOSTS * SITES * calls, results[0].getRowCount());
+        results[0].advanceRow();
+        Map<String, String> columnTargets = new HashMap<String, String>();
+        columnTargets.put("HOSTNAME", results[0].getString("HOSTNAME"));
+        validateRowSeenAtAllHosts(results[0], columnTargets, false);
+    }
+
+    public void testNativeStackStatistics() throws Exception {
+        System.out.println("\n\nTESTING NATIVESTACKS STATS\n\n\n");
+        Client client  = getFullyConnectedClient();
+
+        ColumnInfo[] expectedSchema = new ColumnInfo[6];
+        expectedSchema[0] = new ColumnInfo("TIMESTAMP", VoltType.BIGINT);
+        expectedSchema[1] = new ColumnInfo("HOST_ID", VoltType.INTEGER);
+        expectedSchema[2] = new ColumnInfo("HOSTNAME", VoltType.STRING);
+        expectedSchema[3] = new ColumnInfo("SITE_ID", VoltType.INTEGER);
+        expectedSchema[4] = new ColumnInfo("STACK", VoltType.STRING);
+        expectedSchema[5] = new ColumnInfo("SAMPLES", VoltType.BIGINT);
+        VoltTable expectedTable = new VoltTable(expectedSchema);
+
+        VoltTable[] results = null;
+        //
+        // NATIVESTACKS
+        //
+        results = client.callProcedure("@Statistics", "NATIVESTACKS", 0).getResults();
+        // one aggregate table returned; an idle site may not have been sampled yet
+        assertEquals(1, results.length);
+        System.out.println("Test NATIVESTACKS table: " + results[0].toString());
+        validateSchema(results[0], expectedTable);
+        while (results[0].advanceRow()) {
+            assertTrue(results[0].getLong("SAMPLES") > 0);
+        }
+    }
+
     public void testManagementStats() throws Exception {
         System.out.println("\n\nTESTING MANAGEMENT STATS\n\n\n");
         Client client  = getFullyConnectedClient();
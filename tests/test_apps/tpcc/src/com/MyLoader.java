@@ -110,6 +110,7 @@ public class MyLoader
         m_helpah.add("ratelimit", "rate_limit", "Rate limit to start from (tps)", 200000);
         m_helpah.add("displayinterval", "display_interval_in_seconds", "Interval for performance feedback, in seconds.", 10);
         m_helpah.add("servers", "comma_separated_server_list", "List of VoltDB servers to connect to.", "localhost");
+        m_helpah.add("statsfile", "file_name", "File to save the per-procedure statistics to.", "");
         m_helpah.setArguments(args);
 
         initTableNames();
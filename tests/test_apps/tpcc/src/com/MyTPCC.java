@@ -30,6 +30,8 @@ import com.procedures.LoadStatus;
 import org.voltdb.client.ProcedureCallback;
 import org.voltdb.client.Client;
 import org.voltdb.client.ClientFactory;
+import org.voltdb.client.ClientStats;
+import org.voltdb.client.ClientStatsContext;
 import org.voltdb.client.NoConnectionsException;
 import org.voltdb.client.ProcCallException;
 import org.voltdb.client.exampleutils.AppHelper;
@@ -84,6 +86,7 @@ public class MyTPCC
 
         setTransactionDisplayNames();
 
+        final ClientStatsContext fullStatsContext = m_clientCon.createStatsContext();
         long startTime = System.currentTimeMillis();
         long endTime = startTime + (1000l * testDurationSecs);
         long currentTime = startTime;
@@ -190,6 +193,13 @@ public class MyTPCC
         }
         System.out.println("===============================================================================\n");
 
+        ClientStats stats = fullStatsContext.fetch().getStats();
+        System.out.printf("Average throughput:            %,9d txns/sec\n", stats.getTxnThroughput());
+        System.out.printf("Average latency:               %,9.2f ms\n", stats.getAverageLatency());
+        System.out.printf("50th percentile latency:       %,9.2f ms\n", stats.kPercentileLatencyAsDouble(.5));
+        System.out.printf("99th percentile latency:       %,9.2f ms\n", stats.kPercentileLatencyAsDouble(.99));
+        System.out.printf("99.9th percentile latency:     %,9.2f ms\n", stats.kPercentileLatencyAsDouble(.999));
+
         System.out.println("\n");
         System.out.println("*************************************************************************");
         System.out.println("System Statistics");
@@ -237,6 +247,7 @@ public class MyTPCC
         m_helpah.add("ratelimit", "rate_limit", "Rate limit to start from (tps)", 200000);
         m_helpah.add("displayinterval", "display_interval_in_seconds", "Interval for performance feedback, in seconds.", 10);
         m_helpah.add("servers", "comma_separated_server_list", "List of VoltDB servers to connect to.", "localhost");
+        m_helpah.add("statsfile", "file_name", "File to save the per-procedure statistics to.", "");
         m_helpah.setArguments(args);
 
         // default values
@@ -8,6 +8,9 @@
 //   - Murmur3 hash functions return hashes by value in our third
 //     party sources (rather than accept an output storage address),
 //     so we changed the calls to murmur3 functions in this code.
+//   - registerAndRank exposes which register a value lands in, so
+//     sketches stored in materialized view rows can be updated in
+//     place.
 
 #if !defined(HYPERLOGLOG_HPP)
 #define HYPERLOGLOG_HPP
@@ -79,15 +82,32 @@ public:
      * @param[in] len length of string
      */
     void add(const char* str, uint32_t len) {
-        uint32_t hash;
-        hash = MurmurHash3_x86_32(str, len, HLL_HASH_SEED);
-        uint32_t index = hash >> (32 - b_);
-        uint8_t rank = rho((hash << b_), 32 - b_);
+        uint32_t index;
+        uint8_t rank;
+        registerAndRank(b_, str, len, index, rank);
         if (rank > M_[index]) {
             M_[index] = rank;
         }
     }
 
+    /**
+     * Finds the register that adding an element changes, and the rank
+     * it raises that register to, for a sketch of the given bit width.
+     *
+     * @param[in] b bit width
+     * @param[in] str string to add
+     * @param[in] len length of string
+     * @param[out] index register index
+     * @param[out] rank register rank
+     */
+    static void registerAndRank(uint8_t b, const char* str, uint32_t len,
+                                uint32_t& index, uint8_t& rank) {
+        uint32_t hash;
+        hash = MurmurHash3_x86_32(str, len, HLL_HASH_SEED);
+        index = hash >> (32 - b);
+        rank = rho((hash << b), 32 - b);
+    }
+
     /**
      * Estimates cardinality value.
      *
@@ -204,7 +224,7 @@ private:
     double alphaMM_; ///< alpha * m^2
     std::vector<uint8_t> M_; ///< registers
 
-    uint8_t rho(uint32_t x, uint8_t b) {
+    static uint8_t rho(uint32_t x, uint8_t b) {
         uint8_t v = 1;
         while (v <= b && !(x & 0x80000000)) {
             v++;
@@ -0,0 +1,296 @@
+#!/usr/bin/env python
+
+# This file is part of VoltDB.
+# Copyright (C) 2008-2016 VoltDB Inc.
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# "Software"), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+# OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+# ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+# OTHER DEALINGS IN THE SOFTWARE.
+
+# End-to-end throughput and latency regression suite.
+#
+# "run" starts a fresh single node server from this tree's bin directory for
+# every workload, loads the application's schema, drives it with the
+# application's own client for a fixed duration at a fixed rate, shuts the
+# server down and appends one JSON line per workload to the output file:
+#
+#   {"workload":"voter","duration_s":60,"rate":50000,"throughput_tps":49987.0,
+#    "p50_ms":0.41,"p99_ms":1.9,"p999_ms":4.2,"commit":"...","timestamp":...}
+#
+# The workloads are the voter and voltkv examples, the TPC-C test application
+# and the YCSB core workloads A-F through the VoltDB binding in
+# tests/test_apps/ycsb. The YCSB ones need YCSB_HOME (see that README) and are
+# skipped without it. For YCSB the per-operation latencies are kept under
+# "operations" and the top level percentiles are the worst operation's.
+#
+# "compare" reads a baseline and a new results file, and fails when a
+# workload's throughput dropped or its p99 latency grew by more than the
+# tolerance.
+#
+#   tools/perfsuite.py run -o new.json --duration 60
+#   tools/perfsuite.py compare baseline.json new.json --tolerance 0.05
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+TOOLSDIR = os.path.dirname(os.path.realpath(__file__))
+TRUNKDIR = os.path.dirname(TOOLSDIR)
+VOLTBIN = os.path.join(TRUNKDIR, 'bin')
+
+class Workload(object):
+    def __init__(self, name, appdir, rate, clientclass=None, jar=None, classpath='CLIENTCLASSPATH',
+                 args=(), ycsb=None):
+        self.name = name
+        self.appdir = os.path.join(TRUNKDIR, appdir)
+        self.rate = rate
+        self.clientclass = clientclass
+        self.jar = jar
+        self.classpath = classpath
+        self.args = list(args)
+        self.ycsb = ycsb
+
+WORKLOADS = [
+    Workload('voter', 'examples/voter', 50000, 'voter.AsyncBenchmark', 'voter-client.jar',
+             args=['--latencyreport=true', '--warmup=5']),
+    Workload('voltkv', 'examples/voltkv', 50000, 'voltkv.AsyncBenchmark', 'voltkv-client.jar',
+             args=['--latencyreport=true', '--warmup=5', '--getputratio=0.90', '--preload=true']),
+    Workload('tpcc', 'tests/test_apps/tpcc', 20000, 'com.MyTPCC', 'tpcc-client.jar', 'APPCLASSPATH',
+             args=['--warehouses=256', '--scalefactor=22']),
+] + [Workload('ycsb-' + w, 'tests/test_apps/ycsb', 20000, ycsb='workload' + w) for w in 'abcdef']
+
+def log(msg):
+    print(time.strftime('%H:%M:%S ') + msg)
+    sys.stdout.flush()
+
+def environment():
+    env = dict(os.environ)
+    env['PATH'] = VOLTBIN + os.pathsep + env.get('PATH', '')
+    return env
+
+def shell(command, cwd, logfile):
+    """Run a command line in the application directory, with this tree's
+    voltenv sourced, logging its output. Returns the output."""
+    script = 'source "%s/voltenv" && %s' % (VOLTBIN, command)
+    proc = subprocess.Popen(['bash', '-c', script], cwd=cwd, env=environment(),
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = proc.communicate()[0].decode('utf-8', 'replace')
+    logfile.write('$ %s\n%s\n' % (command, output))
+    logfile.flush()
+    if proc.returncode != 0:
+        raise RuntimeError('"%s" failed with status %d, see %s' % (command, proc.returncode, logfile.name))
+    return output
+
+def wait_for_port(port, proc, timeout):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        if proc.poll() is not None:
+            raise RuntimeError('server exited with status %d during startup' % proc.returncode)
+        try:
+            socket.create_connection(('localhost', port), 1).close()
+            return
+        except socket.error:
+            time.sleep(1)
+    raise RuntimeError('server did not open port %d within %d seconds' % (port, timeout))
+
+class Server(object):
+    """A single node server in its own voltdbroot, started with the
+    application's deployment file."""
+
+    def __init__(self, workload, workdir, logfile):
+        self.workload = workload
+        self.rootdir = os.path.join(workdir, workload.name)
+        self.logfile = logfile
+        self.proc = None
+
+    def __enter__(self):
+        deployment = os.path.join(self.workload.appdir, 'deployment.xml')
+        shell('voltdb init --force --dir="%s" --config="%s"' % (self.rootdir, deployment),
+              self.workload.appdir, self.logfile)
+        self.proc = subprocess.Popen([os.path.join(VOLTBIN, 'voltdb'), 'start', '--dir=' + self.rootdir,
+                                      '--host=localhost'],
+                                     cwd=self.workload.appdir, env=environment(),
+                                     stdout=self.logfile, stderr=subprocess.STDOUT)
+        wait_for_port(21212, self.proc, 300)
+        return self
+
+    def __exit__(self, *args):
+        try:
+            shell('voltadmin shutdown', self.workload.appdir, self.logfile)
+        except RuntimeError:
+            self.proc.kill()
+        self.proc.wait()
+        shutil.rmtree(self.rootdir, True)
+
+def parse_benchmark_output(output):
+    """Parse the results block the example clients print with --latencyreport."""
+    def value(label):
+        match = re.search(r'^' + re.escape(label) + r':\s+([\d,.]+)', output, re.M)
+        if match is None:
+            raise RuntimeError('client output has no "%s"' % label)
+        return float(match.group(1).replace(',', ''))
+    return {'throughput_tps': value('Average throughput'),
+            'p50_ms': value('50th percentile latency'),
+            'p99_ms': value('99th percentile latency'),
+            'p999_ms': value('99.9th percentile latency')}
+
+YCSB_PERCENTILES = {'50': 'p50_ms', '99': 'p99_ms', '99.9': 'p999_ms'}
+
+def parse_ycsb_output(output):
+    """Parse the measurements YCSB prints with hdrhistogram.percentiles=50,99,99.9,
+    e.g. "[READ], 99.9PercentileLatency(us), 2350"."""
+    result = {'operations': {}}
+    match = re.search(r'^\[OVERALL\], Throughput\(ops/sec\), ([\d.]+)', output, re.M)
+    if match is None:
+        raise RuntimeError('YCSB output has no overall throughput')
+    result['throughput_tps'] = float(match.group(1))
+    for op, pct, unit, latency in re.findall(
+            r'^\[([A-Z-]+)\], ([\d.]+)(?:st|nd|rd|th)?PercentileLatency\((us|ms)\), ([\d.]+)', output, re.M):
+        if op.endswith('-FAILED') or op == 'CLEANUP' or pct not in YCSB_PERCENTILES:
+            continue
+        latency_ms = float(latency) / 1000.0 if unit == 'us' else float(latency)
+        key = YCSB_PERCENTILES[pct]
+        result['operations'].setdefault(op, {})[key] = latency_ms
+        result[key] = max(result.get(key, 0.0), latency_ms)
+    return result
+
+def run_workload(workload, args, workdir, logfile):
+    shell('./run.sh jars', workload.appdir, logfile)
+    with Server(workload, workdir, logfile):
+        shell('./run.sh init', workload.appdir, logfile)
+        if workload.ycsb is not None:
+            opts = ('-threads %d -target %d -p recordcount=%d -p operationcount=2000000000 '
+                    '-p maxexecutiontime=%d -p measurementtype=hdrhistogram '
+                    '-p hdrhistogram.percentiles=50,99,99.9'
+                    % (args.ycsb_threads, workload.rate, args.ycsb_records, args.duration))
+            shell('YCSB_OPTS="%s" ./run.sh load' % opts, workload.appdir, logfile)
+            output = shell('YCSB_OPTS="%s" ./run.sh workload %s' % (opts, workload.ycsb),
+                           workload.appdir, logfile)
+            return parse_ycsb_output(output)
+        command = ['java', '-classpath', '%s:$%s' % (workload.jar, workload.classpath),
+                   workload.clientclass, '--servers=localhost', '--displayinterval=5',
+                   '--duration=%d' % args.duration, '--ratelimit=%d' % workload.rate] + workload.args
+        output = shell(' '.join(command), workload.appdir, logfile)
+        return parse_benchmark_output(output)
+
+def git_commit():
+    try:
+        return subprocess.check_output(['git', 'rev-parse', 'HEAD'], cwd=TRUNKDIR).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return ''
+
+def run(args):
+    names = [w.name for w in WORKLOADS]
+    selected = args.workloads.split(',') if args.workloads else names
+    for name in selected:
+        if name not in names:
+            sys.exit('unknown workload %s, expected one of %s' % (name, ', '.join(names)))
+    if args.rate_scale <= 0:
+        sys.exit('--rate-scale must be positive')
+    workdir = tempfile.mkdtemp(prefix='perfsuite-')
+    commit = git_commit()
+    failed = False
+    with open(os.path.join(workdir, 'perfsuite.log'), 'w') as logfile:
+        log('Logging to %s' % logfile.name)
+        for workload in [w for w in WORKLOADS if w.name in selected]:
+            if workload.ycsb is not None and not os.environ.get('YCSB_HOME'):
+                log('Skipping %s, YCSB_HOME is not set' % workload.name)
+                continue
+            workload.rate = int(workload.rate * args.rate_scale)
+            log('Running %s for %d seconds at %d txns/sec' % (workload.name, args.duration, workload.rate))
+            try:
+                result = run_workload(workload, args, workdir, logfile)
+            except RuntimeError as e:
+                log('%s failed: %s' % (workload.name, e))
+                failed = True
+                continue
+            result.update({'workload': workload.name, 'duration_s': args.duration, 'rate': workload.rate,
+                           'commit': commit, 'timestamp': int(time.time())})
+            line = json.dumps(result, sort_keys=True)
+            print(line)
+            with open(args.output, 'a') as out:
+                out.write(line + '\n')
+    return 1 if failed else 0
+
+def load_results(path):
+    # later lines for the same workload replace earlier ones
+    results = {}
+    with open(path) as f:
+        for line in f:
+            if line.strip():
+                result = json.loads(line)
+                results[result['workload']] = result
+    return results
+
+def compare(args):
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    regressed = False
+    print('%-10s %14s %14s %8s %10s %10s %8s' % ('workload', 'base tps', 'new tps', 'change',
+                                                 'base p99', 'new p99', 'change'))
+    for name in sorted(set(baseline) & set(current)):
+        old, new = baseline[name], current[name]
+        tps_change = new['throughput_tps'] / old['throughput_tps'] - 1.0 if old['throughput_tps'] else 0.0
+        p99_change = new['p99_ms'] / old['p99_ms'] - 1.0 if old['p99_ms'] else 0.0
+        flag = ''
+        if tps_change < -args.tolerance or p99_change > args.tolerance:
+            flag = '  REGRESSED'
+            regressed = True
+        print('%-10s %14.1f %14.1f %+7.1f%% %10.2f %10.2f %+7.1f%%%s'
+              % (name, old['throughput_tps'], new['throughput_tps'], tps_change * 100,
+                 old['p99_ms'], new['p99_ms'], p99_change * 100, flag))
+    for name in sorted(set(baseline) ^ set(current)):
+        print('%-10s only in %s' % (name, args.baseline if name in baseline else args.current))
+    return 1 if regressed else 0
+
+def main():
+    parser = argparse.ArgumentParser(description='End-to-end throughput and latency regression suite.')
+    subparsers = parser.add_subparsers(dest='command')
+    run_parser = subparsers.add_parser('run', help='run the workloads and append JSON results')
+    run_parser.add_argument('-o', '--output', default='perfsuite.json', help='results file (appended to)')
+    run_parser.add_argument('-w', '--workloads', default='',
+                            help='comma separated subset of: ' + ', '.join(w.name for w in WORKLOADS))
+    run_parser.add_argument('-d', '--duration', type=int, default=60, help='seconds per workload')
+    run_parser.add_argument('--rate-scale', type=float, default=1.0,
+                            help='multiplies every workload\'s fixed client rate')
+    run_parser.add_argument('--ycsb-records', type=int, default=100000, help='YCSB records to load')
+    run_parser.add_argument('--ycsb-threads', type=int, default=64, help='YCSB client threads')
+    compare_parser = subparsers.add_parser('compare', help='compare two results files')
+    compare_parser.add_argument('baseline')
+    compare_parser.add_argument('current')
+    compare_parser.add_argument('-t', '--tolerance', type=float, default=0.05,
+                                help='allowed relative throughput drop or p99 growth')
+    args = parser.parse_args()
+    if args.command == 'run':
+        return run(args)
+    if args.command == 'compare':
+        return compare(args)
+    parser.print_help()
+    return 2
+
+if __name__ == '__main__':
+    sys.exit(main())